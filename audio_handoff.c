@@ -0,0 +1,106 @@
+#include "audio_handoff.h"
+#include <stdio.h>
+#include <string.h>
+
+// Ring buffer storage
+static PaUtilRingBuffer g_command_queue;
+static AudioHandoffMsg g_command_buffer[AUDIO_COMMAND_QUEUE_SIZE];
+
+static PaUtilRingBuffer g_event_queue;
+static AudioHandoffMsg g_event_buffer[AUDIO_EVENT_QUEUE_SIZE];
+
+// Audio-thread only: retirements that did not fit in the event ring
+static AudioHandoffMsg g_retire_backlog[AUDIO_RETIRE_BACKLOG];
+static int g_retire_backlog_count = 0;
+
+void audio_handoff_init(void) {
+    PaUtil_InitializeRingBuffer(&g_command_queue, sizeof(AudioHandoffMsg),
+                                AUDIO_COMMAND_QUEUE_SIZE, g_command_buffer);
+    PaUtil_InitializeRingBuffer(&g_event_queue, sizeof(AudioHandoffMsg),
+                                AUDIO_EVENT_QUEUE_SIZE, g_event_buffer);
+    memset(g_retire_backlog, 0, sizeof(g_retire_backlog));
+    g_retire_backlog_count = 0;
+}
+
+bool audio_command_push(const AudioHandoffMsg* msg) {
+    if (!msg) {
+        return false;
+    }
+    if (PaUtil_WriteRingBuffer(&g_command_queue, msg, 1) == 0) {
+        fprintf(stderr, "⚠️ Audio command queue full (type %u)\n", msg->type);
+        return false;
+    }
+    return true;
+}
+
+bool audio_command_pop(AudioHandoffMsg* msg) {
+    if (!msg) {
+        return false;
+    }
+    return PaUtil_ReadRingBuffer(&g_command_queue, msg, 1) == 1;
+}
+
+bool audio_event_push(const AudioHandoffMsg* msg) {
+    if (!msg) {
+        return false;
+    }
+    // No logging here: this runs on the audio thread
+    return PaUtil_WriteRingBuffer(&g_event_queue, msg, 1) == 1;
+}
+
+bool audio_event_pop(AudioHandoffMsg* msg) {
+    if (!msg) {
+        return false;
+    }
+    return PaUtil_ReadRingBuffer(&g_event_queue, msg, 1) == 1;
+}
+
+void audio_retire_flush(void) {
+    int kept = 0;
+    for (int i = 0; i < g_retire_backlog_count; ++i) {
+        if (!audio_event_push(&g_retire_backlog[i])) {
+            g_retire_backlog[kept++] = g_retire_backlog[i];
+        }
+    }
+    g_retire_backlog_count = kept;
+}
+
+static void retire_msg(const AudioHandoffMsg* msg) {
+    if (g_retire_backlog_count == 0 && audio_event_push(msg)) {
+        return;
+    }
+    if (g_retire_backlog_count < AUDIO_RETIRE_BACKLOG) {
+        g_retire_backlog[g_retire_backlog_count++] = *msg;
+    }
+    // Backlog full: the memory leaks rather than being freed on the RT thread
+}
+
+void audio_retire_buffer(float* buffer) {
+    if (!buffer) {
+        return;
+    }
+    AudioHandoffMsg msg = {0};
+    msg.type = AUDIO_EVENT_RETIRE;
+    msg.buffer = buffer;
+    retire_msg(&msg);
+}
+
+void audio_retire_source(struct SampleSource* source) {
+    if (!source) {
+        return;
+    }
+    AudioHandoffMsg msg = {0};
+    msg.type = AUDIO_EVENT_RETIRE_SOURCE;
+    msg.source = source;
+    retire_msg(&msg);
+}
+
+void audio_retire_patch(struct SynthPatch* patch) {
+    if (!patch) {
+        return;
+    }
+    AudioHandoffMsg msg = {0};
+    msg.type = AUDIO_EVENT_RETIRE_PATCH;
+    msg.patch = patch;
+    retire_msg(&msg);
+}
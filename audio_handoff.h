@@ -0,0 +1,98 @@
+#ifndef AUDIO_HANDOFF_H
+#define AUDIO_HANDOFF_H
+
+#include "pa_ringbuffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Lock-free state handoff between the UI and the audio callback.
+ *
+ * Two single-producer/single-consumer rings:
+ * - commands: UI thread -> audio thread (start/stop recording, play, ...)
+ * - events:   audio thread -> UI thread (take finished, buffer retired, ...)
+ *
+ * Buffers travel inside messages and ownership moves with them. The UI
+ * allocates a buffer, hands it over in a command, and gets it back as an
+ * AUDIO_EVENT_RETIRE once the audio thread no longer references it; only
+ * then is it freed (off the RT thread). Neither side ever blocks.
+ *
+ * Recordings do not travel as buffers: the audio thread streams them to
+ * disk (disk_stream.h) and the UI opens the finished file as a
+ * SampleSource and hands it over with a *_LOAD command.
+ */
+
+struct SampleSource;
+struct SynthPatch;
+
+// Ring sizes must be powers of two (PaUtilRingBuffer)
+#define AUDIO_COMMAND_QUEUE_SIZE 64
+#define AUDIO_EVENT_QUEUE_SIZE 256
+#define AUDIO_RETIRE_BACKLOG 16
+
+typedef enum {
+    // Commands (UI -> audio)
+    AUDIO_CMD_TRACK_RECORD = 0,      // index, stream = disk stream id, channels
+    AUDIO_CMD_TRACK_STOP_RECORD,     // index
+    AUDIO_CMD_TRACK_CLEAR,           // index
+    AUDIO_CMD_TRACK_TOGGLE_PLAY,     // index
+    AUDIO_CMD_TRACK_VOLUME,          // index, value
+    AUDIO_CMD_TRACK_LOAD,            // index, source (finished take)
+    AUDIO_CMD_SNIPPET_RECORD,        // index = entry, slot, stream, channels
+    AUDIO_CMD_SNIPPET_STOP_RECORD,   // index = entry, slot
+    AUDIO_CMD_SNIPPET_PLAY,          // index = entry, slot
+    AUDIO_CMD_SNIPPET_PLAY_ALL,
+    AUDIO_CMD_SNIPPET_STOP,
+    AUDIO_CMD_SNIPPET_LOAD,          // index = entry, slot, source
+    AUDIO_CMD_TRANSPORT_START,       // Sequencer from its first step
+    AUDIO_CMD_TRANSPORT_STOP,
+    AUDIO_CMD_PATCH_LOAD,            // patch (complete, built by the UI)
+    AUDIO_CMD_SET_OVERSAMPLE,        // index = SynthOversampleStage, slot = OversampleMode
+    AUDIO_CMD_SET_LIMITER_LOOKAHEAD, // value = ms
+
+    // Events (audio -> UI)
+    AUDIO_EVENT_RETIRE = 64,         // buffer is no longer referenced; free it
+    AUDIO_EVENT_RETIRE_SOURCE,       // source is no longer referenced; close and free it
+    AUDIO_EVENT_RETIRE_PATCH,        // patch has been applied; free it
+    AUDIO_EVENT_SNIPPET_STARTED      // index = entry, slot
+} AudioHandoffType;
+
+typedef struct {
+    uint32_t type;      // AudioHandoffType
+    int32_t index;      // Track or snippet entry index
+    int32_t slot;       // Snippet slot
+    int32_t stream;     // Disk stream a recording is captured into
+    uint32_t frames;    // Buffer length in frames
+    uint32_t channels;
+    float value;
+    float* buffer;      // Ownership moves with the message
+    struct SampleSource* source;  // Likewise (sample_io.h)
+    struct SynthPatch* patch;     // Likewise (synth_engine.h)
+} AudioHandoffMsg;
+
+void audio_handoff_init(void);
+
+// UI thread -> audio thread
+bool audio_command_push(const AudioHandoffMsg* msg);
+bool audio_command_pop(AudioHandoffMsg* msg);
+
+// Audio thread -> UI thread
+bool audio_event_push(const AudioHandoffMsg* msg);
+bool audio_event_pop(AudioHandoffMsg* msg);
+
+// Audio thread: hand a buffer back for freeing. If the event ring is full the
+// pointer waits in a fixed backlog and is retried by audio_retire_flush().
+void audio_retire_buffer(float* buffer);
+void audio_retire_source(struct SampleSource* source);
+void audio_retire_patch(struct SynthPatch* patch);
+void audio_retire_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_HANDOFF_H
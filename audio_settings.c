@@ -0,0 +1,165 @@
+#include "audio_settings.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AUDIO_MAX_SAMPLE_RATE 384000
+#define AUDIO_MAX_PERIOD_FRAMES 16384
+#define AUDIO_MAX_PERIODS 16
+
+static const char* const g_backend_names[AUDIO_BACKEND_COUNT] = {
+    "auto", "wasapi", "dsound", "winmm", "coreaudio", "pulseaudio", "alsa", "jack", "null"
+};
+
+void audio_settings_init(AudioSettings* settings) {
+    memset(settings, 0, sizeof(*settings));
+    settings->sample_rate = 44100;
+    settings->backend = AUDIO_BACKEND_AUTO;
+    settings->duplex = true;
+}
+
+const char* audio_backend_name(AudioBackend backend) {
+    return backend >= 0 && backend < AUDIO_BACKEND_COUNT ? g_backend_names[backend] : "auto";
+}
+
+bool audio_backend_from_name(const char* name, AudioBackend* backend) {
+    if (!name) {
+        return false;
+    }
+    for (int b = 0; b < AUDIO_BACKEND_COUNT; b++) {
+        const char* candidate = g_backend_names[b];
+        size_t i = 0;
+        while (candidate[i] && tolower((unsigned char)name[i]) == candidate[i]) {
+            i++;
+        }
+        if (candidate[i] == '\0' && name[i] == '\0') {
+            *backend = (AudioBackend)b;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whole number in [0, max]; false for anything else
+static bool parse_count(const char* text, uint32_t max, uint32_t* value) {
+    if (!text || !isdigit((unsigned char)text[0])) {
+        return false;
+    }
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*end != '\0' || parsed > max) {
+        return false;
+    }
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+int audio_settings_parse_arg(AudioSettings* settings, int argc, char** argv, int index) {
+    const char* arg = argv[index];
+    const char* value = index + 1 < argc ? argv[index + 1] : NULL;
+    if (strcmp(arg, "--exclusive") == 0) {
+        settings->exclusive = true;
+        return 1;
+    } else if (strcmp(arg, "--shared") == 0) {
+        settings->exclusive = false;
+        return 1;
+    } else if (strcmp(arg, "--playback-only") == 0) {
+        settings->duplex = false;
+        return 1;
+    } else if (strcmp(arg, "--duplex") == 0) {
+        settings->duplex = true;
+        return 1;
+    } else if (strcmp(arg, "--realtime") == 0) {
+        settings->realtime = true;
+        return 1;
+    } else if (strcmp(arg, "--rate") == 0) {
+        return parse_count(value, AUDIO_MAX_SAMPLE_RATE, &settings->sample_rate) ? 2 : -1;
+    } else if (strcmp(arg, "--period") == 0) {
+        return parse_count(value, AUDIO_MAX_PERIOD_FRAMES, &settings->period_frames) ? 2 : -1;
+    } else if (strcmp(arg, "--periods") == 0) {
+        return parse_count(value, AUDIO_MAX_PERIODS, &settings->periods) ? 2 : -1;
+    } else if (strcmp(arg, "--backend") == 0) {
+        return audio_backend_from_name(value, &settings->backend) ? 2 : -1;
+    }
+    return 0;
+}
+
+void audio_settings_print_usage(FILE* out) {
+    fprintf(out,
+            "Audio device:\n"
+            "  --rate <hz>         Sample rate (0 = the device's own; default 44100)\n"
+            "  --period <frames>   Frames per callback (0 = backend default)\n"
+            "  --periods <n>       Periods in the device buffer (0 = backend default)\n"
+            "  --backend <name>    ");
+    for (int b = 0; b < AUDIO_BACKEND_COUNT; b++) {
+        fprintf(out, "%s%s", b > 0 ? ", " : "", g_backend_names[b]);
+    }
+    fprintf(out,
+            "\n"
+            "  --exclusive         Exclusive mode / hw device, bypassing the system mixer\n"
+            "  --shared            Shared mode (default)\n"
+            "  --playback-only     Don't open the input (voice tracks can't record)\n"
+            "  --duplex            Open the input too (default)\n"
+            "  --realtime          Ask for a realtime audio thread\n");
+}
+
+cJSON* audio_settings_to_json(const AudioSettings* settings) {
+    cJSON* obj = cJSON_CreateObject();
+    if (!obj) {
+        return NULL;
+    }
+    cJSON_AddNumberToObject(obj, "sampleRate", settings->sample_rate);
+    cJSON_AddNumberToObject(obj, "periodFrames", settings->period_frames);
+    cJSON_AddNumberToObject(obj, "periods", settings->periods);
+    cJSON_AddStringToObject(obj, "backend", audio_backend_name(settings->backend));
+    cJSON_AddBoolToObject(obj, "exclusive", settings->exclusive);
+    cJSON_AddBoolToObject(obj, "duplex", settings->duplex);
+    cJSON_AddBoolToObject(obj, "realtime", settings->realtime);
+    return obj;
+}
+
+static void count_from_json(const cJSON* json, const char* key, uint32_t max, uint32_t* value) {
+    const cJSON* item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (cJSON_IsNumber(item) && item->valuedouble >= 0.0 && item->valuedouble <= (double)max) {
+        *value = (uint32_t)item->valuedouble;
+    }
+}
+
+static void flag_from_json(const cJSON* json, const char* key, bool* value) {
+    const cJSON* item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (cJSON_IsBool(item)) {
+        *value = cJSON_IsTrue(item);
+    }
+}
+
+void audio_settings_from_json(AudioSettings* settings, const cJSON* json) {
+    if (!settings || !cJSON_IsObject(json)) {
+        return;
+    }
+    count_from_json(json, "sampleRate", AUDIO_MAX_SAMPLE_RATE, &settings->sample_rate);
+    count_from_json(json, "periodFrames", AUDIO_MAX_PERIOD_FRAMES, &settings->period_frames);
+    count_from_json(json, "periods", AUDIO_MAX_PERIODS, &settings->periods);
+    const cJSON* backend = cJSON_GetObjectItemCaseSensitive(json, "backend");
+    if (cJSON_IsString(backend)) {
+        audio_backend_from_name(backend->valuestring, &settings->backend);
+    }
+    flag_from_json(json, "exclusive", &settings->exclusive);
+    flag_from_json(json, "duplex", &settings->duplex);
+    flag_from_json(json, "realtime", &settings->realtime);
+}
+
+void audio_latency_compute(AudioLatency* latency, uint32_t sample_rate, uint32_t period_frames,
+                           uint32_t periods, bool duplex, uint32_t capture_period_frames,
+                           uint32_t capture_periods) {
+    latency->sample_rate = sample_rate;
+    latency->period_frames = period_frames;
+    latency->output_frames = period_frames * (periods > 0 ? periods : 1);
+    latency->input_frames = duplex ? capture_period_frames * (capture_periods > 0 ? capture_periods : 1) : 0;
+    latency->round_trip_frames = latency->input_frames + latency->output_frames;
+    latency->midi_frames = period_frames + latency->output_frames;
+}
+
+float audio_latency_ms(const AudioLatency* latency, uint32_t frames) {
+    return latency->sample_rate > 0 ? (float)frames * 1000.0f / (float)latency->sample_rate : 0.0f;
+}
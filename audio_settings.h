@@ -0,0 +1,82 @@
+#ifndef AUDIO_SETTINGS_H
+#define AUDIO_SETTINGS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "third_party/cjson/cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Audio device configuration: what the app asks the device for.
+ *
+ * Every field is a request. The backend may round the period, pick another
+ * period count or refuse exclusive mode, so the app reports what it actually
+ * got (AudioLatency) after opening. Settings come from a project's "audio"
+ * object, then from command-line flags, which win.
+ */
+
+typedef enum {
+    AUDIO_BACKEND_AUTO = 0,       // Platform order: WASAPI, Core Audio, PulseAudio, ALSA, JACK...
+    AUDIO_BACKEND_WASAPI,
+    AUDIO_BACKEND_DSOUND,
+    AUDIO_BACKEND_WINMM,
+    AUDIO_BACKEND_COREAUDIO,
+    AUDIO_BACKEND_PULSEAUDIO,
+    AUDIO_BACKEND_ALSA,
+    AUDIO_BACKEND_JACK,
+    AUDIO_BACKEND_NULL,           // No hardware: a timer-driven device, for tests
+    AUDIO_BACKEND_COUNT
+} AudioBackend;
+
+typedef struct {
+    uint32_t sample_rate;     // Hz; 0 = the device's own rate
+    uint32_t period_frames;   // Frames per callback; 0 = the backend's default
+    uint32_t periods;         // Periods in the device buffer; 0 = the backend's default
+    AudioBackend backend;
+    bool exclusive;           // Exclusive mode (WASAPI) or the hw device (ALSA), no system mixer
+    bool duplex;              // Also open the input for voice tracks; false = playback only
+    bool realtime;            // Realtime callback thread where the OS allows it (Pro Audio on WASAPI)
+} AudioSettings;
+
+// What the opened device runs at, in frames at `sample_rate`
+typedef struct {
+    uint32_t sample_rate;
+    uint32_t period_frames;
+    uint32_t output_frames;       // Playback buffer
+    uint32_t input_frames;        // Capture buffer; 0 when playback only
+    uint32_t round_trip_frames;   // Input to output: capture plus playback buffer
+    uint32_t midi_frames;         // MIDI to output: one period of placement plus the playback buffer
+} AudioLatency;
+
+// 44.1 kHz duplex, shared, backend defaults
+void audio_settings_init(AudioSettings* settings);
+
+const char* audio_backend_name(AudioBackend backend);
+// Case-insensitive; false for an unknown name
+bool audio_backend_from_name(const char* name, AudioBackend* backend);
+
+// Applies the flag at argv[index]. Returns the arguments used (1 or 2), 0
+// if it is not an audio flag, or -1 if its value is missing or invalid.
+int audio_settings_parse_arg(AudioSettings* settings, int argc, char** argv, int index);
+void audio_settings_print_usage(FILE* out);
+
+cJSON* audio_settings_to_json(const AudioSettings* settings);
+// Missing keys keep their current values
+void audio_settings_from_json(AudioSettings* settings, const cJSON* json);
+
+// `capture_*` are ignored when `duplex` is false
+void audio_latency_compute(AudioLatency* latency, uint32_t sample_rate, uint32_t period_frames,
+                           uint32_t periods, bool duplex, uint32_t capture_period_frames,
+                           uint32_t capture_periods);
+float audio_latency_ms(const AudioLatency* latency, uint32_t frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_SETTINGS_H
@@ -190,29 +190,62 @@ case "$TARGET" in
         build_gui_target "synth_pro" \
             synth_pro.c \
             synth_engine.c \
+            voice_simd.c \
+            voice_pool.c \
+            param_smooth.c \
+            wavetable.c \
+            dsp_math.c \
+            oversample.c \
+            dynamics.c \
+            denormal.c \
             param_queue.c \
+            rt_log.c \
             pa_ringbuffer.c \
             nuklear_impl.c \
             midi_input.c \
+            midi_clock.c \
             sample_io.c \
             preset.c \
             project.c \
+            audio_settings.c \
             third_party/cjson/cJSON.c
         ;;
     synth_complete)
         build_gui_target "synth_complete" \
             synth_complete.c \
+            synth_core.c \
             synth_engine.c \
+            voice_simd.c \
+            voice_pool.c \
+            param_smooth.c \
+            wavetable.c \
+            dsp_math.c \
+            oversample.c \
+            dynamics.c \
+            denormal.c \
             param_queue.c \
+            rt_log.c \
+            audio_handoff.c \
+            disk_stream.c \
+            fx_rack.c \
+            sequencer.c \
+            rt_stats.c \
+            meter_feed.c \
             pa_ringbuffer.c \
             nuklear_impl.c \
             midi_input.c \
+            midi_clock.c \
             midi_shim.c \
+            sample_io.c \
+            sample_source.c \
             ui/style.c \
             ui/draw_helpers.c \
             ui/knob_custom.c \
+            ui/frame_pacer.c \
             preset.c \
+            preset_library.c \
             project.c \
+            audio_settings.c \
             third_party/cjson/cJSON.c
         ;;
     *)
@@ -0,0 +1,71 @@
+/**
+ * Subnormal float protection - per-thread flush-to-zero flags
+ */
+
+#include "denormal.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DENORMAL_SSE 1
+#define DENORMAL_BITS 0x8040u               // MXCSR FTZ (bit 15) and DAZ (bit 6)
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define DENORMAL_AARCH64 1
+#define DENORMAL_BITS (1ull << 24)          // FPCR.FZ
+#elif defined(__arm__) && defined(__ARM_FP) && (defined(__GNUC__) || defined(__clang__))
+#define DENORMAL_ARM32 1
+#define DENORMAL_BITS (1u << 24)            // FPSCR.FZ
+#endif
+
+static uint64_t denormal_read(void) {
+#if defined(DENORMAL_SSE)
+    return _mm_getcsr();
+#elif defined(DENORMAL_AARCH64)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+    return value;
+#elif defined(DENORMAL_ARM32)
+    uint32_t value;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+static void denormal_write(uint64_t value) {
+#if defined(DENORMAL_SSE)
+    _mm_setcsr((unsigned int)value);
+#elif defined(DENORMAL_AARCH64)
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+#elif defined(DENORMAL_ARM32)
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"((uint32_t)value));
+#else
+    (void)value;
+#endif
+}
+
+bool denormal_flags_supported(void) {
+#if defined(DENORMAL_BITS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+DenormalMode denormal_flush_begin(void) {
+    DenormalMode mode = {0, false};
+#if defined(DENORMAL_BITS)
+    mode.previous = denormal_read();
+    if ((mode.previous & DENORMAL_BITS) != DENORMAL_BITS) {
+        denormal_write(mode.previous | DENORMAL_BITS);
+        mode.changed = true;
+    }
+#endif
+    return mode;
+}
+
+void denormal_flush_end(DenormalMode mode) {
+    if (mode.changed) {
+        denormal_write(mode.previous);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef DENORMAL_H
+#define DENORMAL_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Subnormal float protection.
+ *
+ * Decaying feedback (filter state, delay and reverb lines) sinks through
+ * the subnormal range before it reaches zero, and on most CPUs every
+ * operation on a subnormal takes a slow microcode path: a release tail
+ * can cost ten times a loud passage. Two layers keep that off the audio
+ * thread:
+ *
+ * - Hardware flush-to-zero on every thread that renders: FTZ and DAZ in
+ *   MXCSR on x86 (SSE), FZ in FPCR on AArch64 and FPSCR on 32-bit ARM.
+ *   denormal_flush_begin() sets it and returns the previous mode so a
+ *   host's own settings come back with denormal_flush_end().
+ * - denormal_flush() on the recursions' state, which zeroes anything
+ *   below DENORMAL_FLOOR (-300 dB). It keeps tails clean where the flags
+ *   are missing (other CPUs, or code that runs before they are set) and
+ *   makes tails end at exactly zero on every platform.
+ */
+
+#define DENORMAL_FLOOR 1e-15f
+
+typedef struct {
+    uint64_t previous;   // Control register before denormal_flush_begin()
+    bool changed;
+} DenormalMode;
+
+static inline float denormal_flush(float x) {
+    return fabsf(x) < DENORMAL_FLOOR ? 0.0f : x;
+}
+
+// True when this build can set the hardware flags
+bool denormal_flags_supported(void);
+// Flush subnormal results and inputs to zero on the calling thread
+DenormalMode denormal_flush_begin(void);
+// Restore the mode denormal_flush_begin() replaced
+void denormal_flush_end(DenormalMode mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DENORMAL_H
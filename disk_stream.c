@@ -0,0 +1,337 @@
+#include "disk_stream.h"
+#include "pa_ringbuffer.h"
+#include "miniaudio.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define DISK_WRITER_POLL_MS 5
+#define DISK_WRITER_CHUNK_SAMPLES 4096
+#define DISK_STREAM_PATCH_INTERVAL_MS 500
+
+typedef struct {
+    atomic_int state;             // DiskStreamState
+    PaUtilRingBuffer ring;
+    float* storage;
+
+    // Writer-thread side (set up by disk_stream_open before the slot goes OPEN)
+    FILE* file;
+    ma_encoder encoder;
+    uint32_t channels;
+    long data_offset;             // First sample byte; the data size field sits 4 bytes before
+    unsigned int ms_since_patch;
+
+    atomic_ullong frames_written;
+    atomic_ullong frames_dropped;
+} DiskStream;
+
+static DiskStream g_streams[DISK_STREAM_MAX];
+static atomic_int g_writer_running = 0;
+static atomic_int g_writer_stop = 0;
+
+#if defined(_WIN32)
+static HANDLE g_writer_thread = NULL;
+#else
+static pthread_t g_writer_thread;
+#endif
+
+// ============================================================================
+// FILE CALLBACKS
+// ============================================================================
+
+static ma_result stream_on_write(ma_encoder* encoder, const void* data, size_t bytes, size_t* written) {
+    DiskStream* stream = (DiskStream*)encoder->pUserData;
+    size_t count = fwrite(data, 1, bytes, stream->file);
+    if (written) {
+        *written = count;
+    }
+    return count == bytes ? MA_SUCCESS : MA_IO_ERROR;
+}
+
+static ma_result stream_on_seek(ma_encoder* encoder, ma_int64 offset, ma_seek_origin origin) {
+    DiskStream* stream = (DiskStream*)encoder->pUserData;
+    int whence = SEEK_SET;
+    if (origin == ma_seek_origin_current) {
+        whence = SEEK_CUR;
+    } else if (origin == ma_seek_origin_end) {
+        whence = SEEK_END;
+    }
+    return fseek(stream->file, (long)offset, whence) == 0 ? MA_SUCCESS : MA_IO_ERROR;
+}
+
+static void write_u32_le(FILE* file, uint32_t value) {
+    unsigned char bytes[4] = {
+        (unsigned char)(value & 0xFF),
+        (unsigned char)((value >> 8) & 0xFF),
+        (unsigned char)((value >> 16) & 0xFF),
+        (unsigned char)((value >> 24) & 0xFF)
+    };
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+// Make the file valid as it stands: dr_wav only writes the real sizes on
+// uninit, so without this a crash leaves a header claiming zero frames
+static void stream_patch_header(DiskStream* stream) {
+    uint64_t data_bytes = atomic_load(&stream->frames_written) * stream->channels * sizeof(float);
+    if (data_bytes > 0xFFFFFFFFull - (uint64_t)stream->data_offset) {
+        return; // Past the RIFF limit; leave it to the encoder
+    }
+    long end = ftell(stream->file);
+    fseek(stream->file, 4, SEEK_SET);
+    write_u32_le(stream->file, (uint32_t)((uint64_t)stream->data_offset - 8 + data_bytes));
+    fseek(stream->file, stream->data_offset - 4, SEEK_SET);
+    write_u32_le(stream->file, (uint32_t)data_bytes);
+    fseek(stream->file, end, SEEK_SET);
+    fflush(stream->file);
+}
+
+// ============================================================================
+// WRITER THREAD
+// ============================================================================
+
+// Returns true if any frames were written
+static bool stream_drain(DiskStream* stream) {
+    float chunk[DISK_WRITER_CHUNK_SAMPLES];
+    ring_buffer_size_t chunk_samples = (ring_buffer_size_t)(DISK_WRITER_CHUNK_SAMPLES -
+                                                            DISK_WRITER_CHUNK_SAMPLES % stream->channels);
+    bool wrote = false;
+    while (1) {
+        ring_buffer_size_t available = PaUtil_GetRingBufferReadAvailable(&stream->ring);
+        available -= available % (ring_buffer_size_t)stream->channels;
+        if (available <= 0) {
+            break;
+        }
+        ring_buffer_size_t count = available < chunk_samples ? available : chunk_samples;
+        PaUtil_ReadRingBuffer(&stream->ring, chunk, count);
+
+        ma_uint64 frames = (ma_uint64)(count / (ring_buffer_size_t)stream->channels);
+        ma_uint64 written = 0;
+        if (ma_encoder_write_pcm_frames(&stream->encoder, chunk, frames, &written) != MA_SUCCESS ||
+            written != frames) {
+            atomic_store(&stream->state, DISK_STREAM_FAILED);
+            return wrote;
+        }
+        atomic_fetch_add(&stream->frames_written, (unsigned long long)written);
+        wrote = true;
+    }
+    return wrote;
+}
+
+static void stream_close_file(DiskStream* stream, int final_state) {
+    ma_encoder_uninit(&stream->encoder);
+    fclose(stream->file);
+    stream->file = NULL;
+    atomic_store(&stream->state, final_state);
+}
+
+static void writer_pass(bool stopping) {
+    for (int i = 0; i < DISK_STREAM_MAX; ++i) {
+        DiskStream* stream = &g_streams[i];
+        int state = atomic_load(&stream->state);
+        if (state != DISK_STREAM_OPEN && state != DISK_STREAM_FINISHING) {
+            continue;
+        }
+        bool wrote = stream_drain(stream);
+        if (atomic_load(&stream->state) == DISK_STREAM_FAILED) {
+            fprintf(stderr, "❌ Disk stream %d: write failed, take truncated\n", i);
+            stream_close_file(stream, DISK_STREAM_FAILED);
+            continue;
+        }
+        if (state == DISK_STREAM_FINISHING || stopping) {
+            stream_close_file(stream, DISK_STREAM_CLOSED);
+            continue;
+        }
+        stream->ms_since_patch += DISK_WRITER_POLL_MS;
+        if (wrote && stream->ms_since_patch >= DISK_STREAM_PATCH_INTERVAL_MS) {
+            stream_patch_header(stream);
+            stream->ms_since_patch = 0;
+        }
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI writer_thread_main(LPVOID arg) {
+#else
+static void* writer_thread_main(void* arg) {
+#endif
+    (void)arg;
+    while (!atomic_load(&g_writer_stop)) {
+        writer_pass(false);
+#if defined(_WIN32)
+        Sleep(DISK_WRITER_POLL_MS);
+#else
+        usleep(DISK_WRITER_POLL_MS * 1000U);
+#endif
+    }
+    writer_pass(true);
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+bool disk_writer_start(void) {
+    if (atomic_load(&g_writer_running)) {
+        return true;
+    }
+    atomic_store(&g_writer_stop, 0);
+#if defined(_WIN32)
+    g_writer_thread = CreateThread(NULL, 0, writer_thread_main, NULL, 0, NULL);
+    if (!g_writer_thread) {
+        fprintf(stderr, "❌ Failed to start disk writer thread\n");
+        return false;
+    }
+#else
+    if (pthread_create(&g_writer_thread, NULL, writer_thread_main, NULL) != 0) {
+        fprintf(stderr, "❌ Failed to start disk writer thread\n");
+        return false;
+    }
+#endif
+    atomic_store(&g_writer_running, 1);
+    return true;
+}
+
+void disk_writer_stop(void) {
+    if (!atomic_load(&g_writer_running)) {
+        return;
+    }
+    atomic_store(&g_writer_stop, 1);
+#if defined(_WIN32)
+    WaitForSingleObject(g_writer_thread, INFINITE);
+    CloseHandle(g_writer_thread);
+    g_writer_thread = NULL;
+#else
+    pthread_join(g_writer_thread, NULL);
+#endif
+    atomic_store(&g_writer_running, 0);
+}
+
+// ============================================================================
+// STREAMS
+// ============================================================================
+
+int disk_stream_open(const char* path, uint32_t channels, uint32_t sample_rate) {
+    if (!path || channels == 0 || sample_rate == 0) {
+        return -1;
+    }
+
+    int id = -1;
+    for (int i = 0; i < DISK_STREAM_MAX; ++i) {
+        if (atomic_load(&g_streams[i].state) == DISK_STREAM_FREE) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) {
+        fprintf(stderr, "❌ No free disk stream for '%s'\n", path);
+        return -1;
+    }
+
+    DiskStream* stream = &g_streams[id];
+    stream->storage = (float*)malloc(sizeof(float) * DISK_STREAM_RING_SAMPLES);
+    if (!stream->storage) {
+        return -1;
+    }
+    PaUtil_InitializeRingBuffer(&stream->ring, sizeof(float), DISK_STREAM_RING_SAMPLES, stream->storage);
+
+    stream->file = fopen(path, "wb");
+    if (!stream->file) {
+        fprintf(stderr, "❌ Failed to open take '%s'\n", path);
+        free(stream->storage);
+        stream->storage = NULL;
+        return -1;
+    }
+
+    stream->channels = channels;
+    ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32,
+                                                      channels, sample_rate);
+    ma_result result = ma_encoder_init(stream_on_write, stream_on_seek, stream, &config, &stream->encoder);
+    if (result != MA_SUCCESS) {
+        fprintf(stderr, "❌ Failed to start WAV encoder for '%s' (error %d)\n", path, result);
+        fclose(stream->file);
+        stream->file = NULL;
+        free(stream->storage);
+        stream->storage = NULL;
+        return -1;
+    }
+    fflush(stream->file);
+    stream->data_offset = ftell(stream->file);
+    stream->ms_since_patch = 0;
+    atomic_store(&stream->frames_written, 0);
+    atomic_store(&stream->frames_dropped, 0);
+
+    // Publishes everything above to the writer and audio threads
+    atomic_store(&stream->state, DISK_STREAM_OPEN);
+    return id;
+}
+
+bool disk_stream_write(int id, const float* interleaved, uint32_t frames) {
+    if (id < 0 || id >= DISK_STREAM_MAX || !interleaved || frames == 0) {
+        return false;
+    }
+    DiskStream* stream = &g_streams[id];
+    if (atomic_load(&stream->state) != DISK_STREAM_OPEN) {
+        return false;
+    }
+    ring_buffer_size_t samples = (ring_buffer_size_t)(frames * stream->channels);
+    // All-or-nothing so the ring never holds a partial frame
+    if (PaUtil_GetRingBufferWriteAvailable(&stream->ring) < samples) {
+        atomic_fetch_add(&stream->frames_dropped, frames);
+        return false;
+    }
+    PaUtil_WriteRingBuffer(&stream->ring, interleaved, samples);
+    return true;
+}
+
+void disk_stream_finish(int id) {
+    if (id < 0 || id >= DISK_STREAM_MAX) {
+        return;
+    }
+    int expected = DISK_STREAM_OPEN;
+    atomic_compare_exchange_strong(&g_streams[id].state, &expected, DISK_STREAM_FINISHING);
+}
+
+DiskStreamState disk_stream_state(int id) {
+    if (id < 0 || id >= DISK_STREAM_MAX) {
+        return DISK_STREAM_FREE;
+    }
+    return (DiskStreamState)atomic_load(&g_streams[id].state);
+}
+
+uint64_t disk_stream_frames_written(int id) {
+    if (id < 0 || id >= DISK_STREAM_MAX) {
+        return 0;
+    }
+    return atomic_load(&g_streams[id].frames_written);
+}
+
+uint64_t disk_stream_frames_dropped(int id) {
+    if (id < 0 || id >= DISK_STREAM_MAX) {
+        return 0;
+    }
+    return atomic_load(&g_streams[id].frames_dropped);
+}
+
+void disk_stream_release(int id) {
+    if (id < 0 || id >= DISK_STREAM_MAX) {
+        return;
+    }
+    DiskStream* stream = &g_streams[id];
+    int state = atomic_load(&stream->state);
+    if (state != DISK_STREAM_CLOSED && state != DISK_STREAM_FAILED) {
+        return;
+    }
+    free(stream->storage);
+    stream->storage = NULL;
+    atomic_store(&stream->state, DISK_STREAM_FREE);
+}
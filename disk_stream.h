@@ -0,0 +1,60 @@
+#ifndef DISK_STREAM_H
+#define DISK_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Streaming WAV capture.
+ *
+ * The audio thread pushes interleaved float frames into a per-stream
+ * lock-free ring; a background writer thread drains the rings and appends
+ * to 32-bit float WAV files through ma_encoder. There is no length cap and
+ * no full-take copy. The writer re-patches the RIFF/data sizes about twice
+ * a second, so a take is readable up to that point even after a crash.
+ *
+ * Threading:
+ * - disk_writer_start/stop, disk_stream_open/release/state: UI thread
+ * - disk_stream_write/finish: audio thread (never blocks, never allocates)
+ */
+
+#define DISK_STREAM_MAX 8
+#define DISK_STREAM_RING_SAMPLES (1 << 17)  // ~1.5 s of 44.1 kHz stereo per stream
+
+typedef enum {
+    DISK_STREAM_FREE = 0,
+    DISK_STREAM_OPEN,       // Accepting frames
+    DISK_STREAM_FINISHING,  // No more frames; writer is draining and closing
+    DISK_STREAM_CLOSED,     // File finalized; release to reuse the slot
+    DISK_STREAM_FAILED      // Write error; file may be incomplete
+} DiskStreamState;
+
+bool disk_writer_start(void);
+void disk_writer_stop(void);   // Finalizes any stream still open
+
+// Create the file and return a stream id, or -1
+int disk_stream_open(const char* path, uint32_t channels, uint32_t sample_rate);
+
+// Audio thread: queue frames; false (and the frames are counted as dropped)
+// when the ring is full
+bool disk_stream_write(int id, const float* interleaved, uint32_t frames);
+
+// Audio thread: mark the end of the take
+void disk_stream_finish(int id);
+
+DiskStreamState disk_stream_state(int id);
+uint64_t disk_stream_frames_written(int id);
+uint64_t disk_stream_frames_dropped(int id);
+
+// UI thread: free a CLOSED/FAILED slot for reuse
+void disk_stream_release(int id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISK_STREAM_H
@@ -0,0 +1,24 @@
+/**
+ * DSP Math Kernels - lookup tables
+ */
+
+#include "dsp_math.h"
+
+float dsp_pan_table[DSP_PAN_TABLE_SIZE + 1];
+float dsp_svf_table[DSP_SVF_TABLE_SIZE + 1];
+
+void dsp_math_init(void) {
+    static int initialized = 0;
+    if (initialized) {
+        return;
+    }
+    for (int i = 0; i <= DSP_PAN_TABLE_SIZE; i++) {
+        double angle = (double)i / (double)DSP_PAN_TABLE_SIZE * 1.57079632679489661923;
+        dsp_pan_table[i] = (float)cos(angle);
+    }
+    for (int i = 0; i <= DSP_SVF_TABLE_SIZE; i++) {
+        double normalized = 0.5 * (double)i / (double)DSP_SVF_TABLE_SIZE;
+        dsp_svf_table[i] = (float)(2.0 * sin(normalized * 3.14159265358979323846));
+    }
+    initialized = 1;
+}
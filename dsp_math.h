@@ -0,0 +1,157 @@
+/**
+ * DSP Math Kernels
+ *
+ * Approximations for the per-sample libm calls in the engine. Each kernel
+ * has a fast form (dsp_fast_*) with a stated error bound and a reference
+ * form (dsp_ref_*) that calls libm. The dsp_* names pick one at build time:
+ * fast by default, libm when SYNTH_EXACT_MATH is defined (CMake option
+ * SYNTH_FAST_MATH=OFF), so reference renders can be A/B'd against fast ones.
+ *
+ * Bounds (float32, measured by tests/audio_checklist_test.c):
+ * - dsp_fast_exp2f:     relative error < 2e-7 for x in [-126, 126]
+ * - dsp_fast_sin_turns: absolute error < 5e-7 for phase in [-4, 4]
+ * - dsp_fast_tanhf:     absolute error < 1e-5 everywhere
+ * - dsp_fast_pan:       absolute gain error < 1e-5 for pan in [-1, 1]
+ * - dsp_fast_svf_f:     absolute error < 2e-6 for cutoff/rate in [0, 0.5]
+ */
+
+#ifndef DSP_MATH_H
+#define DSP_MATH_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DSP_PAN_TABLE_SIZE 256
+#define DSP_SVF_TABLE_SIZE 1024
+
+// Quarter-cycle cosine, DSP_PAN_TABLE_SIZE + 1 entries (filled by dsp_math_init)
+extern float dsp_pan_table[DSP_PAN_TABLE_SIZE + 1];
+// SVF frequency coefficient 2 * sin(pi * x) for x = cutoff / rate in
+// [0, 0.5], DSP_SVF_TABLE_SIZE + 1 entries (filled by dsp_math_init)
+extern float dsp_svf_table[DSP_SVF_TABLE_SIZE + 1];
+
+// Fill lookup tables; idempotent, call from init paths (synth_init does).
+// Call once up front before creating engines on several threads.
+void dsp_math_init(void);
+
+// ============================================================================
+// FAST KERNELS
+// ============================================================================
+
+// 2^x: integer part goes straight into the exponent bits, fraction through
+// a degree-5 Chebyshev fit of 2^f on [0, 1)
+static inline float dsp_fast_exp2f(float x) {
+    if (x < -126.0f) x = -126.0f;
+    if (x > 126.0f) x = 126.0f;
+    float xi = floorf(x);
+    float f = x - xi;
+    float p = 1.893754058e-03f;
+    p = p * f + 8.949590423e-03f;
+    p = p * f + 5.586033708e-02f;
+    p = p * f + 2.401418182e-01f;
+    p = p * f + 6.931544897e-01f;
+    p = p * f + 9.999998984e-01f;
+
+    uint32_t bits = (uint32_t)((int32_t)xi + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// sin(2 * pi * phase): reduce to [-0.25, 0.25] turns, then an odd
+// degree-9 polynomial
+static inline float dsp_fast_sin_turns(float phase) {
+    float x = phase - floorf(phase + 0.5f); // -0.5 .. 0.5
+    if (x > 0.25f) x = 0.5f - x;
+    else if (x < -0.25f) x = -0.5f - x;
+    float u = x * x;
+    float p = 3.975982709e+01f;
+    p = p * u - 7.658117264e+01f;
+    p = p * u + 8.160247637e+01f;
+    p = p * u - 4.134168061e+01f;
+    p = p * u + 6.283185280e+00f;
+    return p * x;
+}
+
+static inline float dsp_fast_cos_turns(float phase) {
+    return dsp_fast_sin_turns(phase + 0.25f);
+}
+
+// [9/8] Pade approximant of tanh, clamped where it meets +/-1
+static inline float dsp_fast_tanhf(float x) {
+    if (x > 6.3f) return 1.0f;
+    if (x < -6.3f) return -1.0f;
+    float x2 = x * x;
+    float num = x * (34459425.0f + x2 * (4729725.0f + x2 * (135135.0f + x2 * (990.0f + x2))));
+    float den = 34459425.0f + x2 * (16216200.0f + x2 * (945945.0f + x2 * (13860.0f + x2 * 45.0f)));
+    return num / den;
+}
+
+// Constant-power pan law (pan -1..1) from the quarter-cosine table
+static inline void dsp_fast_pan(float pan, float* gain_l, float* gain_r) {
+    float pos = (pan + 1.0f) * 0.5f * (float)DSP_PAN_TABLE_SIZE;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > (float)DSP_PAN_TABLE_SIZE) pos = (float)DSP_PAN_TABLE_SIZE;
+    int index = (int)pos;
+    if (index >= DSP_PAN_TABLE_SIZE) index = DSP_PAN_TABLE_SIZE - 1;
+    float frac = pos - (float)index;
+    int mirror = DSP_PAN_TABLE_SIZE - index;
+    *gain_l = dsp_pan_table[index] + (dsp_pan_table[index + 1] - dsp_pan_table[index]) * frac;
+    *gain_r = dsp_pan_table[mirror] + (dsp_pan_table[mirror - 1] - dsp_pan_table[mirror]) * frac;
+}
+
+// Chamberlin SVF coefficient for a normalized cutoff, interpolated from the
+// table so cutoff modulation never calls sin
+static inline float dsp_fast_svf_f(float normalized) {
+    float pos = normalized * (2.0f * (float)DSP_SVF_TABLE_SIZE);
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > (float)DSP_SVF_TABLE_SIZE) pos = (float)DSP_SVF_TABLE_SIZE;
+    int index = (int)pos;
+    if (index >= DSP_SVF_TABLE_SIZE) index = DSP_SVF_TABLE_SIZE - 1;
+    float frac = pos - (float)index;
+    return dsp_svf_table[index] + (dsp_svf_table[index + 1] - dsp_svf_table[index]) * frac;
+}
+
+// ============================================================================
+// REFERENCE KERNELS (libm)
+// ============================================================================
+
+static inline float dsp_ref_exp2f(float x) { return exp2f(x); }
+static inline float dsp_ref_sin_turns(float phase) { return sinf(phase * 6.28318530717958647692f); }
+static inline float dsp_ref_cos_turns(float phase) { return cosf(phase * 6.28318530717958647692f); }
+static inline float dsp_ref_tanhf(float x) { return tanhf(x); }
+
+static inline float dsp_ref_svf_f(float normalized) {
+    return 2.0f * sinf(normalized * 3.14159265358979323846f);
+}
+
+static inline void dsp_ref_pan(float pan, float* gain_l, float* gain_r) {
+    float angle = (pan + 1.0f) * 0.25f * 3.14159265358979323846f;
+    *gain_l = cosf(angle);
+    *gain_r = sinf(angle);
+}
+
+// ============================================================================
+// BUILD-TIME SELECTION
+// ============================================================================
+
+#ifdef SYNTH_EXACT_MATH
+#define DSP_MATH_MODE "libm"
+#define dsp_exp2f dsp_ref_exp2f
+#define dsp_sin_turns dsp_ref_sin_turns
+#define dsp_cos_turns dsp_ref_cos_turns
+#define dsp_tanhf dsp_ref_tanhf
+#define dsp_pan dsp_ref_pan
+#define dsp_svf_f dsp_ref_svf_f
+#else
+#define DSP_MATH_MODE "fast"
+#define dsp_exp2f dsp_fast_exp2f
+#define dsp_sin_turns dsp_fast_sin_turns
+#define dsp_cos_turns dsp_fast_cos_turns
+#define dsp_tanhf dsp_fast_tanhf
+#define dsp_pan dsp_fast_pan
+#define dsp_svf_f dsp_fast_svf_f
+#endif
+
+#endif // DSP_MATH_H
@@ -0,0 +1,331 @@
+#include "dynamics.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "dsp_math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DYN_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DYN_NEON 1
+#endif
+
+// ============================================================================
+// DETECTOR AND GAIN COMPUTER
+// ============================================================================
+
+// Envelope coefficient for one control step: e^(-frames / (t * rate)) via
+// exp2 (log2 e = 1.44269504); 0 (instant) for a zero time
+static float dyn_step_coeff(float time_s, float sample_rate) {
+    if (time_s <= 0.0f) {
+        return 0.0f;
+    }
+    return dsp_exp2f(-1.44269504f * (float)DYN_CONTROL_FRAMES / (time_s * sample_rate));
+}
+
+void dyn_detector_set_times(DynDetector* detector, float attack_s, float release_s, float sample_rate) {
+    if (detector->attack_s == attack_s && detector->release_s == release_s &&
+        detector->coeff_rate == sample_rate) {
+        return;
+    }
+    detector->attack_coeff = dyn_step_coeff(attack_s, sample_rate);
+    detector->release_coeff = dyn_step_coeff(release_s, sample_rate);
+    detector->attack_s = attack_s;
+    detector->release_s = release_s;
+    detector->coeff_rate = sample_rate;
+}
+
+float dyn_compress_gain(float level, float threshold, float slope) {
+    if (level > threshold && slope < 0.0f) {
+        return dsp_exp2f(log2f(level / threshold) * slope);
+    }
+    return 1.0f;
+}
+
+// ============================================================================
+// BLOCK KERNELS
+// ============================================================================
+
+float dyn_peak(const float* left, const float* right, int frames) {
+    float peak = 0.0f;
+    int i = 0;
+#if defined(DYN_SSE2)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vpeak = _mm_setzero_ps();
+    for (; i + 4 <= frames; i += 4) {
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(_mm_loadu_ps(left + i), abs_mask));
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(_mm_loadu_ps(right + i), abs_mask));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, vpeak);
+    peak = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#elif defined(DYN_NEON)
+    float32x4_t vpeak = vdupq_n_f32(0.0f);
+    for (; i + 4 <= frames; i += 4) {
+        vpeak = vmaxq_f32(vpeak, vabsq_f32(vld1q_f32(left + i)));
+        vpeak = vmaxq_f32(vpeak, vabsq_f32(vld1q_f32(right + i)));
+    }
+    float lanes[4];
+    vst1q_f32(lanes, vpeak);
+    peak = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#endif
+    for (; i < frames; i++) {
+        peak = fmaxf(peak, fmaxf(fabsf(left[i]), fabsf(right[i])));
+    }
+    return peak;
+}
+
+void dyn_apply_gain_ramp(float* left, float* right, int frames, float gain, float step, int first) {
+    if (gain == 1.0f && step == 0.0f) {
+        return;
+    }
+#if defined(DYN_SSE2) || defined(DYN_NEON)
+    // A short tail goes through the vector path too, padded, so a frame's
+    // gain rounds the same however the stream is split
+    float tail_l[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float tail_r[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    int body = frames & ~3;
+    int rest = frames - body;
+    memcpy(tail_l, left + body, sizeof(float) * (size_t)rest);
+    memcpy(tail_r, right + body, sizeof(float) * (size_t)rest);
+#endif
+#if defined(DYN_SSE2)
+    const __m128 vgain = _mm_set1_ps(gain);
+    const __m128 vstep = _mm_set1_ps(step);
+    const __m128 four = _mm_set1_ps(4.0f);
+    __m128 index = _mm_add_ps(_mm_set1_ps((float)first), _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f));
+    for (int i = 0; i <= body; i += 4) {
+        float* l = i < body ? left + i : tail_l;
+        float* r = i < body ? right + i : tail_r;
+        __m128 g = _mm_add_ps(vgain, _mm_mul_ps(vstep, index));
+        _mm_storeu_ps(l, _mm_mul_ps(_mm_loadu_ps(l), g));
+        _mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(r), g));
+        index = _mm_add_ps(index, four);
+    }
+#elif defined(DYN_NEON)
+    const float32x4_t vgain = vdupq_n_f32(gain);
+    const float32x4_t vstep = vdupq_n_f32(step);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    static const float offsets[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float32x4_t index = vaddq_f32(vdupq_n_f32((float)first), vld1q_f32(offsets));
+    for (int i = 0; i <= body; i += 4) {
+        float* l = i < body ? left + i : tail_l;
+        float* r = i < body ? right + i : tail_r;
+        float32x4_t g = vaddq_f32(vgain, vmulq_f32(vstep, index));
+        vst1q_f32(l, vmulq_f32(vld1q_f32(l), g));
+        vst1q_f32(r, vmulq_f32(vld1q_f32(r), g));
+        index = vaddq_f32(index, four);
+    }
+#else
+    for (int i = 0; i < frames; i++) {
+        float g = gain + step * (float)(first + i + 1);
+        left[i] *= g;
+        right[i] *= g;
+    }
+#endif
+#if defined(DYN_SSE2) || defined(DYN_NEON)
+    memcpy(left + body, tail_l, sizeof(float) * (size_t)rest);
+    memcpy(right + body, tail_r, sizeof(float) * (size_t)rest);
+#endif
+}
+
+// ============================================================================
+// LOOKAHEAD LIMITER
+// ============================================================================
+
+void limiter_init(Limiter* limiter, float threshold, float release_s) {
+    memset(limiter, 0, sizeof(*limiter));
+    limiter->threshold = threshold;
+    limiter->release_s = release_s;
+    limiter->gain = 1.0f;
+    limiter->gain_target = 1.0f;
+}
+
+static int lookahead_blocks(float lookahead_ms, float sample_rate) {
+    float ms = fminf(fmaxf(lookahead_ms, 0.0f), DYN_LIMITER_MAX_LOOKAHEAD_MS);
+    int frames = (int)ceil((double)ms * sample_rate / 1000.0);
+    int blocks = (frames + DYN_CONTROL_FRAMES - 1) / DYN_CONTROL_FRAMES;
+    return blocks < DYN_LIMITER_MAX_BLOCKS ? blocks : DYN_LIMITER_MAX_BLOCKS;
+}
+
+int limiter_latency_frames(float lookahead_ms, float sample_rate) {
+    int blocks = lookahead_blocks(lookahead_ms, sample_rate);
+    return blocks > 0 ? blocks * DYN_CONTROL_FRAMES + DYN_LIMITER_TRUE_PEAK_LAG : 0;
+}
+
+// Detector, lookahead window and delay line back to silence
+static void limiter_clear(Limiter* limiter) {
+    limiter->gain_step = 0.0f;
+    limiter->control_fill = 0;
+    limiter->block_peak = 0.0f;
+    limiter->detector.envelope = 0.0f;
+    memset(limiter->history_l, 0, sizeof(limiter->history_l));
+    memset(limiter->history_r, 0, sizeof(limiter->history_r));
+    memset(limiter->levels, 0, sizeof(limiter->levels));
+    limiter->level_pos = 0;
+    memset(limiter->delay_l, 0, sizeof(limiter->delay_l));
+    memset(limiter->delay_r, 0, sizeof(limiter->delay_r));
+    limiter->delay_pos = 0;
+}
+
+void limiter_set_lookahead(Limiter* limiter, float lookahead_ms, float sample_rate) {
+    limiter->lookahead_blocks = lookahead_blocks(lookahead_ms, sample_rate);
+    limiter->latency = limiter_latency_frames(lookahead_ms, sample_rate);
+
+    // Start over from silence at the gain the ramp was heading for
+    limiter->gain = limiter->gain_target;
+    limiter_clear(limiter);
+}
+
+void limiter_reset(Limiter* limiter) {
+    limiter->gain = 1.0f;
+    limiter->gain_target = 1.0f;
+    limiter_clear(limiter);
+}
+
+// 4x true-peak interpolator: the points a quarter, half and three quarters
+// of the way from window[3] to window[4]. Kaiser-windowed sinc (beta 5),
+// 8 taps per phase, each phase at unity DC gain; reads sines within 0.2 dB
+// of their true peak up to 0.37 fs.
+static const float kTruePeakPhases[3][DYN_LIMITER_TRUE_PEAK_TAPS] = {
+    {-0.01159634f, 0.04665817f, -0.14422132f, 0.89338080f, 0.27755035f, -0.08233837f, 0.02478533f, -0.00421863f},
+    {-0.01034966f, 0.04864109f, -0.15356642f, 0.61527499f, 0.61527499f, -0.15356642f, 0.04864109f, -0.01034966f},
+    {-0.00421863f, 0.02478533f, -0.08233837f, 0.27755035f, 0.89338080f, -0.14422132f, 0.04665817f, -0.01159634f},
+};
+
+static inline float true_peak_window(const float* window) {
+    float peak = fabsf(window[DYN_LIMITER_TRUE_PEAK_TAPS / 2 - 1]);
+    for (int p = 0; p < 3; p++) {
+        float acc = 0.0f;
+        for (int k = 0; k < DYN_LIMITER_TRUE_PEAK_TAPS; k++) {
+            acc += kTruePeakPhases[p][k] * window[k];
+        }
+        peak = fmaxf(peak, fabsf(acc));
+    }
+    return peak;
+}
+
+// Peak of the detector signal for `frames` (<= DYN_CONTROL_FRAMES) new
+// inputs. It runs DYN_LIMITER_TRUE_PEAK_LAG frames behind, waiting for the
+// samples the interpolator needs.
+static float limiter_detect(Limiter* limiter, const float* left, const float* right, int frames) {
+    enum { HISTORY = DYN_LIMITER_TRUE_PEAK_TAPS - 1 };
+    float line_l[HISTORY + DYN_CONTROL_FRAMES];
+    float line_r[HISTORY + DYN_CONTROL_FRAMES];
+    memcpy(line_l, limiter->history_l, sizeof(limiter->history_l));
+    memcpy(line_r, limiter->history_r, sizeof(limiter->history_r));
+    memcpy(line_l + HISTORY, left, sizeof(float) * (size_t)frames);
+    memcpy(line_r + HISTORY, right, sizeof(float) * (size_t)frames);
+
+    float peak = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        peak = fmaxf(peak, fmaxf(true_peak_window(line_l + i), true_peak_window(line_r + i)));
+    }
+    memcpy(limiter->history_l, line_l + frames, sizeof(limiter->history_l));
+    memcpy(limiter->history_r, line_r + frames, sizeof(limiter->history_r));
+    return peak;
+}
+
+static void limiter_delay(Limiter* limiter, float* left, float* right, int frames) {
+    const int mask = DYN_LIMITER_MAX_DELAY - 1;
+    int pos = limiter->delay_pos;
+    for (int i = 0; i < frames; i++) {
+        int read = (pos - limiter->latency) & mask;
+        limiter->delay_l[pos] = left[i];
+        limiter->delay_r[pos] = right[i];
+        left[i] = limiter->delay_l[read];
+        right[i] = limiter->delay_r[read];
+        pos = (pos + 1) & mask;
+    }
+    limiter->delay_pos = pos;
+}
+
+// Gain computer, once per control block. The window holds the detector
+// peaks of the blocks still in the delay line, oldest (next out) first.
+// The ramp toward the next block is the shallowest that still has every
+// block at or under its ceiling by the time it is output; the detector
+// envelope then decides how fast the gain may come back up.
+static void limiter_control(Limiter* limiter) {
+    const float threshold = limiter->threshold;
+    const int blocks = limiter->lookahead_blocks;
+    float gain = limiter->gain;
+    float slope = 1.0f;
+    float window_peak = limiter->block_peak;
+
+    if (blocks > 0) {
+        limiter->level_pos = limiter->level_pos + 1 == blocks ? 0 : limiter->level_pos + 1;
+        limiter->levels[limiter->level_pos] = limiter->block_peak;
+        int index = limiter->level_pos;
+        for (int distance = 0; distance < blocks; distance++) {
+            index = index + 1 == blocks ? 0 : index + 1;
+            float level = limiter->levels[index];
+            window_peak = fmaxf(window_peak, level);
+            if (level <= threshold) {
+                continue;
+            }
+            float ceiling = threshold / level;
+            if (distance == 0) {
+                // Only with a single block of lookahead can this one arrive
+                // unannounced; clamp at its start
+                gain = fminf(gain, ceiling);
+                slope = fminf(slope, ceiling - gain);
+            } else {
+                slope = fminf(slope, (ceiling - gain) / (float)distance);
+            }
+        }
+    }
+
+    float envelope = dyn_detector_step(&limiter->detector, window_peak);
+    float release = envelope > threshold ? threshold / envelope : 1.0f;
+    float target = fminf(fmaxf(gain, release), gain + slope);
+
+    limiter->gain = gain;
+    limiter->gain_target = target;
+    limiter->gain_step = (target - gain) / (float)DYN_CONTROL_FRAMES;
+    limiter->block_peak = 0.0f;
+}
+
+void limiter_process(Limiter* limiter, float* left, float* right, int frames, float sample_rate) {
+    dyn_detector_set_times(&limiter->detector, 0.0f, limiter->release_s, sample_rate);
+    const float threshold = limiter->threshold;
+
+    int done = 0;
+    while (done < frames) {
+        int count = DYN_CONTROL_FRAMES - limiter->control_fill;
+        if (count > frames - done) {
+            count = frames - done;
+        }
+        float* l = left + done;
+        float* r = right + done;
+
+        if (limiter->lookahead_blocks > 0) {
+            limiter->block_peak = fmaxf(limiter->block_peak, limiter_detect(limiter, l, r, count));
+            limiter_delay(limiter, l, r, count);
+        } else {
+            // Zero latency: nothing to look ahead into. The ramp only ever
+            // releases here, so if its end would overshoot, clamp now and
+            // hold for the rest of the block.
+            float peak = dyn_peak(l, r, count);
+            limiter->block_peak = fmaxf(limiter->block_peak, peak);
+            float gain_end = limiter->gain + limiter->gain_step * (float)(limiter->control_fill + count);
+            if (peak * gain_end > threshold) {
+                float gain_now = limiter->gain + limiter->gain_step * (float)limiter->control_fill;
+                limiter->gain = fminf(gain_now, threshold / peak);
+                limiter->gain_target = limiter->gain;
+                limiter->gain_step = 0.0f;
+            }
+        }
+
+        dyn_apply_gain_ramp(l, r, count, limiter->gain, limiter->gain_step, limiter->control_fill);
+        limiter->control_fill += count;
+        if (limiter->control_fill == DYN_CONTROL_FRAMES) {
+            limiter->gain = limiter->gain_target; // Land exactly, no drift
+            limiter->control_fill = 0;
+            limiter_control(limiter);
+        }
+        done += count;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef DYNAMICS_H
+#define DYNAMICS_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Dynamics core shared by the FX compressor and the master limiter.
+ *
+ * Both run a block-rate gain computer: the stereo-linked peak of every
+ * DYN_CONTROL_FRAMES frames feeds one step of an attack/release envelope,
+ * whose per-step coefficients are computed only when the times or the rate
+ * change. The gain then ramps linearly to each new target across the next
+ * control block, applied with a SIMD loop (SSE2 or NEON, scalar otherwise).
+ *
+ * The limiter delays the audio by its lookahead so gain reduction can ramp
+ * in before a peak arrives. Its detector follows the true (inter-sample)
+ * peak, interpolated 4x. With no lookahead it adds no latency and instead
+ * clamps instantly, like a plain peak limiter.
+ */
+
+#define DYN_CONTROL_FRAMES 16                 // Gain computer rate; the gain ramps in between
+#define DYN_LIMITER_MAX_LOOKAHEAD_MS 5.0f
+#define DYN_LIMITER_MAX_BLOCKS 60             // Control blocks of lookahead (5 ms at 192 kHz)
+#define DYN_LIMITER_MAX_DELAY 1024            // Frames, power of two
+#define DYN_LIMITER_TRUE_PEAK_TAPS 8          // Per phase of the 4x interpolator
+#define DYN_LIMITER_TRUE_PEAK_LAG (DYN_LIMITER_TRUE_PEAK_TAPS / 2)   // Its delay, frames
+
+// Peak envelope stepped once per control block
+typedef struct {
+    float envelope;
+    float attack_coeff;      // Per step; 0 = instant
+    float release_coeff;
+    float attack_s;          // What the coefficients were computed for
+    float release_s;
+    float coeff_rate;
+} DynDetector;
+
+typedef struct {
+    float threshold;         // Linear ceiling, 0-1
+    float release_s;
+    DynDetector detector;
+
+    int lookahead_blocks;    // 0 = zero latency
+    int latency;             // Frames the output lags the input
+    float gain;              // Gain at the start of the control block
+    float gain_target;       // ...and at its end
+    float gain_step;         // Per-frame ramp between the two
+    int control_fill;        // Frames into the current control block
+    float block_peak;        // Detector peak of the control block so far
+
+    float history_l[DYN_LIMITER_TRUE_PEAK_TAPS - 1];   // Last inputs, oldest first
+    float history_r[DYN_LIMITER_TRUE_PEAK_TAPS - 1];
+    float levels[DYN_LIMITER_MAX_BLOCKS];   // Lookahead window, newest at level_pos
+    int level_pos;
+    float delay_l[DYN_LIMITER_MAX_DELAY];
+    float delay_r[DYN_LIMITER_MAX_DELAY];
+    int delay_pos;
+} Limiter;
+
+// Cache the per-step coefficients; a no-op unless something changed
+void dyn_detector_set_times(DynDetector* detector, float attack_s, float release_s, float sample_rate);
+
+static inline float dyn_detector_step(DynDetector* detector, float peak) {
+    float coeff = peak > detector->envelope ? detector->attack_coeff : detector->release_coeff;
+    detector->envelope = peak + (detector->envelope - peak) * coeff;
+    return detector->envelope;
+}
+
+// Downward gain for `level` over `threshold`; slope = 1 / ratio - 1 (<= 0)
+float dyn_compress_gain(float level, float threshold, float slope);
+
+// Stereo-linked sample peak
+float dyn_peak(const float* left, const float* right, int frames);
+// Multiply frame i by gain + step * (first + i + 1): the ramp from a
+// control block's start gain, resumed `first` frames in
+void dyn_apply_gain_ramp(float* left, float* right, int frames, float gain, float step, int first);
+
+void limiter_init(Limiter* limiter, float threshold, float release_s);
+// Lookahead in ms (0 to DYN_LIMITER_MAX_LOOKAHEAD_MS), rounded up to whole
+// control blocks. Clears the delay line; realtime-safe.
+void limiter_set_lookahead(Limiter* limiter, float lookahead_ms, float sample_rate);
+// Back to rest (unity gain, empty delay line), settings kept; realtime-safe
+void limiter_reset(Limiter* limiter);
+// The latency a lookahead setting gives, in frames
+int limiter_latency_frames(float lookahead_ms, float sample_rate);
+// In place on planar stereo, any frame count
+void limiter_process(Limiter* limiter, float* left, float* right, int frames, float sample_rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMICS_H
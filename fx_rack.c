@@ -0,0 +1,780 @@
+#include "fx_rack.h"
+#include "denormal.h"
+#include "dsp_math.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// RACK
+// ============================================================================
+
+void fx_rack_init(EffectsRack* rack) {
+    if (!rack) {
+        return;
+    }
+    memset(rack, 0, sizeof(*rack));
+    fx_delay_init(&rack->delay);
+    fx_chorus_init(&rack->chorus);
+    fx_compressor_init(&rack->compressor);
+    rack->distortion.drive = 2.0f;
+    rack->distortion.mix = 0.3f;
+    oversampler_init(&rack->distortion.os);
+    rack->reverb.size = 0.5f;
+    rack->reverb.damping = 0.5f;
+    rack->reverb.mix = 0.2f;
+    rack->reverb.quality = FX_REVERB_STANDARD;
+    rack->reverb.prepared_quality = -1;
+    for (int i = 0; i < FX_TYPE_COUNT; i++) {
+        rack->order[i] = (FxType)i;
+    }
+    rack->num_slots = FX_TYPE_COUNT;
+    rack->max_delay_ms = FX_DELAY_MAX_MS;
+}
+
+// ============================================================================
+// ARENA
+// ============================================================================
+
+#define FX_ARENA_ALIGN 16   // Floats (64 bytes): every carved buffer starts on a cache line
+
+static uint32_t fx_pow2_at_least(float frames) {
+    uint32_t needed = frames > 1.0f ? (uint32_t)ceilf(frames) : 1u;
+    uint32_t capacity = 1;
+    while (capacity < needed) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static size_t fx_arena_round(size_t count) {
+    return (count + FX_ARENA_ALIGN - 1) & ~(size_t)(FX_ARENA_ALIGN - 1);
+}
+
+static float* fx_arena_take(FxArena* arena, size_t count) {
+    count = fx_arena_round(count);
+    if (arena->used + count > arena->capacity) {
+        return NULL;
+    }
+    float* block = arena->base + arena->used;
+    arena->used += count;
+    return block;
+}
+
+bool fx_rack_prepare(EffectsRack* rack, float sample_rate) {
+    if (!rack || sample_rate <= 0.0f) {
+        return false;
+    }
+    float max_delay_ms = rack->max_delay_ms > 0.0f ? rack->max_delay_ms : FX_DELAY_MAX_MS;
+    if (rack->arena.base && rack->arena.sample_rate == sample_rate &&
+        rack->arena.max_delay_ms == max_delay_ms) {
+        return true;
+    }
+
+    float ms_to_frames = 0.001f * sample_rate;
+    uint32_t delay_size = fx_pow2_at_least(max_delay_ms * ms_to_frames + 1.0f);
+    uint32_t chorus_size = fx_pow2_at_least((FX_CHORUS_BASE_MS + FX_CHORUS_MAX_DEPTH_MS) * ms_to_frames + 3.0f);
+    uint32_t reverb_size = fx_pow2_at_least(FX_REVERB_MAX_LINE_MS * ms_to_frames + 2.0f);
+    size_t total = 2 * fx_arena_round(delay_size) + 2 * fx_arena_round(chorus_size) +
+                   fx_arena_round((size_t)reverb_size * FX_REVERB_MAX_LINES);
+
+    float* base = (float*)calloc(total + FX_ARENA_ALIGN, sizeof(float));
+    if (!base) {
+        fprintf(stderr, "❌ Failed to allocate %.1f MB of effect buffers for %.0f Hz\n",
+                (double)(total * sizeof(float)) / (1024.0 * 1024.0), sample_rate);
+        return false;
+    }
+    free(rack->arena.base);
+    rack->arena.base = base;
+    rack->arena.capacity = total + FX_ARENA_ALIGN;
+    rack->arena.sample_rate = sample_rate;
+    rack->arena.max_delay_ms = max_delay_ms;
+    // Start carving on a cache line; the extra FX_ARENA_ALIGN floats cover the skip
+    size_t misalign = (size_t)((uintptr_t)base % (FX_ARENA_ALIGN * sizeof(float)));
+    rack->arena.used = misalign ? (FX_ARENA_ALIGN * sizeof(float) - misalign) / sizeof(float) : 0;
+
+    DelayLine* lines[2] = {&rack->delay.delay_l, &rack->delay.delay_r};
+    for (int i = 0; i < 2; i++) {
+        lines[i]->buffer = fx_arena_take(&rack->arena, delay_size);
+        lines[i]->mask = delay_size - 1;
+        lines[i]->write_pos = 0;
+    }
+    rack->chorus.buffer_l = fx_arena_take(&rack->arena, chorus_size);
+    rack->chorus.buffer_r = fx_arena_take(&rack->arena, chorus_size);
+    rack->chorus.mask = chorus_size - 1;
+    rack->chorus.write_pos = 0;
+
+    Reverb* reverb = &rack->reverb;
+    reverb->lines = fx_arena_take(&rack->arena, (size_t)reverb_size * FX_REVERB_MAX_LINES);
+    reverb->line_capacity = reverb_size;
+    reverb->pos = 0;
+    reverb->sample_rate = sample_rate;
+    memset(reverb->lowpass, 0, sizeof(reverb->lowpass));
+    reverb->prepared_quality = -1; // Recompute lengths for the new rate
+    reverb->lines_zeroed = true;   // Fresh from calloc: the first tier needs no clear
+    reverb->clearing = false;
+    return true;
+}
+
+void fx_rack_free(EffectsRack* rack) {
+    if (!rack) {
+        return;
+    }
+    free(rack->arena.base);
+    memset(&rack->arena, 0, sizeof(rack->arena));
+    rack->delay.delay_l.buffer = NULL;
+    rack->delay.delay_r.buffer = NULL;
+    rack->chorus.buffer_l = NULL;
+    rack->chorus.buffer_r = NULL;
+    rack->reverb.lines = NULL;
+    rack->reverb.line_capacity = 0;
+}
+
+size_t fx_rack_memory_bytes(const EffectsRack* rack) {
+    return rack ? rack->arena.capacity * sizeof(float) : 0;
+}
+
+// ============================================================================
+// CHAIN
+// ============================================================================
+
+bool fx_rack_set_order(EffectsRack* rack, const FxType* order, int count) {
+    if (!rack || (!order && count > 0) || count < 0 || count > FX_TYPE_COUNT) {
+        return false;
+    }
+    bool seen[FX_TYPE_COUNT] = {false};
+    for (int i = 0; i < count; i++) {
+        if ((int)order[i] < 0 || order[i] >= FX_TYPE_COUNT || seen[order[i]]) {
+            return false;
+        }
+        seen[order[i]] = true;
+    }
+    for (int i = 0; i < count; i++) {
+        rack->order[i] = order[i];
+    }
+    rack->num_slots = count;
+    return true;
+}
+
+bool fx_rack_slot_enabled(const EffectsRack* rack, FxType type) {
+    if (!rack) {
+        return false;
+    }
+    switch (type) {
+        case FX_DISTORTION: return rack->distortion.enabled;
+        case FX_CHORUS:     return rack->chorus.enabled;
+        case FX_COMPRESSOR: return rack->compressor.enabled;
+        case FX_DELAY:      return rack->delay.enabled;
+        case FX_REVERB:     return rack->reverb.enabled;
+        default:            return false;
+    }
+}
+
+bool fx_rack_slot_asleep(const EffectsRack* rack, FxType type) {
+    return rack && (int)type >= 0 && type < FX_TYPE_COUNT && rack->sleep[type].asleep;
+}
+
+bool fx_rack_slot_at_rest(const EffectsRack* rack, FxType type) {
+    return fx_rack_slot_asleep(rack, type) && !rack->sleep[type].clearing;
+}
+
+const char* fx_type_name(FxType type) {
+    switch (type) {
+        case FX_DISTORTION: return "Distortion";
+        case FX_CHORUS:     return "Chorus";
+        case FX_COMPRESSOR: return "Compressor";
+        case FX_DELAY:      return "Delay";
+        case FX_REVERB:     return "Reverb";
+        default:            return "Unknown";
+    }
+}
+
+static void fx_rack_run_slot(EffectsRack* rack, FxType type, float* left, float* right,
+                             int num_frames, float sample_rate) {
+    switch (type) {
+        case FX_DISTORTION:
+            fx_distortion_process(&rack->distortion, left, right, num_frames);
+            break;
+        case FX_CHORUS:
+            fx_chorus_process(&rack->chorus, left, right, num_frames, sample_rate);
+            break;
+        case FX_COMPRESSOR:
+            fx_compressor_process(&rack->compressor, left, right, num_frames, sample_rate);
+            break;
+        case FX_DELAY:
+            fx_delay_process(&rack->delay, left, right, num_frames, sample_rate);
+            break;
+        case FX_REVERB:
+            fx_reverb_process(&rack->reverb, left, right, num_frames);
+            break;
+        default:
+            break;
+    }
+}
+
+static uint32_t fx_delay_frames(const Delay* fx, float sample_rate);
+
+// Decays are timed from FX_TAIL_HEADROOM above full scale: hot input, and
+// the reverb's lines run above its output level
+#define FX_TAIL_HEADROOM 10.0f   // +20 dB
+
+// Frames for the state to decay under FX_SLEEP_THRESHOLD when it loses
+// `gain` (linear) every `period` frames. Decided by the effect's own decay,
+// not its output, so a slot with its mix at 0 still rings out.
+static uint32_t fx_rack_decay_frames(float gain, float period) {
+    if (gain * FX_TAIL_HEADROOM <= FX_SLEEP_THRESHOLD) {
+        return (uint32_t)period;
+    }
+    float passes = ceilf(logf(FX_SLEEP_THRESHOLD / FX_TAIL_HEADROOM) / logf(gain)) + 1.0f;  // Plus the pass in flight
+    float frames = passes * period;
+    return frames < 4.0e9f ? (uint32_t)frames : 4000000000u;
+}
+
+// How long a slot can keep sounding once its input is silent
+static uint32_t fx_rack_tail_frames(const EffectsRack* rack, FxType type, float sample_rate) {
+    switch (type) {
+        case FX_DISTORTION:
+            return (uint32_t)(2.0f * oversampler_latency(&rack->distortion.os));   // Filter history
+        case FX_CHORUS:
+            return (uint32_t)((FX_CHORUS_BASE_MS + FX_CHORUS_MAX_DEPTH_MS) * 0.001f * sample_rate);
+        case FX_COMPRESSOR:
+            return (uint32_t)(4.0f * FX_COMP_RELEASE_MS * 0.001f * sample_rate);   // Gain recovered
+        case FX_DELAY:   // Every echo down to the threshold
+            return fx_rack_decay_frames(rack->delay.feedback, (float)fx_delay_frames(&rack->delay, sample_rate));
+        case FX_REVERB: {
+            // -60 dB per RT60, and the longest line still in flight
+            float size = fminf(fmaxf(rack->reverb.size, 0.0f), 1.0f);
+            float rt60_frames = (0.3f + 4.7f * size) * sample_rate;
+            float threshold_db = 20.0f * log10f(FX_TAIL_HEADROOM / FX_SLEEP_THRESHOLD);
+            uint32_t longest = 0;
+            for (int i = 0; i < rack->reverb.num_lines; i++) {
+                longest = rack->reverb.length[i] > longest ? rack->reverb.length[i] : longest;
+            }
+            return (uint32_t)(rt60_frames * threshold_db / 60.0f) + longest;
+        }
+        default:
+            return 0;
+    }
+}
+
+// State back to what endless silence would leave, so a sleeping slot wakes
+// the way a fresh one starts. Sample memory is left to fx_rack_clear_step.
+static void fx_rack_rest(EffectsRack* rack, FxType type) {
+    switch (type) {
+        case FX_DISTORTION:
+            oversampler_reset(&rack->distortion.os);
+            break;
+        case FX_COMPRESSOR:
+            rack->compressor.detector.envelope = 0.0f;
+            rack->compressor.gain = 1.0f;
+            rack->compressor.gain_target = 1.0f;
+            rack->compressor.gain_step = 0.0f;
+            rack->compressor.control_fill = 0;
+            rack->compressor.block_peak = 0.0f;
+            break;
+        case FX_REVERB:
+            memset(rack->reverb.lowpass, 0, sizeof(rack->reverb.lowpass));
+            break;
+        default:
+            break;
+    }
+}
+
+// The sample memory a slot's tail lives in; returns the region count
+static int fx_rack_slot_buffers(EffectsRack* rack, FxType type, float** buffers, size_t* sizes) {
+    switch (type) {
+        case FX_CHORUS:
+            buffers[0] = rack->chorus.buffer_l;
+            buffers[1] = rack->chorus.buffer_r;
+            sizes[0] = sizes[1] = (size_t)rack->chorus.mask + 1;
+            return rack->chorus.buffer_l && rack->chorus.buffer_r ? 2 : 0;
+        case FX_DELAY:
+            buffers[0] = rack->delay.delay_l.buffer;
+            buffers[1] = rack->delay.delay_r.buffer;
+            sizes[0] = (size_t)rack->delay.delay_l.mask + 1;
+            sizes[1] = (size_t)rack->delay.delay_r.mask + 1;
+            return buffers[0] && buffers[1] ? 2 : 0;
+        case FX_REVERB:
+            buffers[0] = rack->reverb.lines;
+            sizes[0] = (size_t)rack->reverb.line_capacity * FX_REVERB_MAX_LINES;
+            return buffers[0] ? 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+// Zero the next FX_REST_CHUNK_FLOATS of a sleeping slot's lines, so no
+// block pays for clearing them all. What is left is already under the
+// threshold, so a slot that wakes before the end just carries on.
+static void fx_rack_clear_step(EffectsRack* rack, FxType type, FxSleep* sleep) {
+    float* buffers[2];
+    size_t sizes[2];
+    int count = fx_rack_slot_buffers(rack, type, buffers, sizes);
+    size_t offset = sleep->cleared;
+    size_t budget = FX_REST_CHUNK_FLOATS;
+    for (int i = 0; i < count; i++) {
+        if (offset >= sizes[i]) {
+            offset -= sizes[i];
+            continue;
+        }
+        size_t n = sizes[i] - offset < budget ? sizes[i] - offset : budget;
+        memset(buffers[i] + offset, 0, n * sizeof(float));
+        sleep->cleared += n;
+        budget -= n;
+        offset = 0;
+        if (budget == 0) {
+            return;
+        }
+    }
+    sleep->clearing = false;   // Every region done
+    if (type == FX_REVERB) {
+        rack->reverb.lines_zeroed = true;
+    }
+}
+
+void fx_rack_process(EffectsRack* rack, float* frames, int num_frames, float sample_rate) {
+    if (!rack || !frames || num_frames <= 0) {
+        return;
+    }
+
+    // Gather the enabled slots once; an all-bypassed chain costs nothing
+    FxType active[FX_TYPE_COUNT];
+    int num_active = 0;
+    for (int s = 0; s < rack->num_slots; s++) {
+        if (fx_rack_slot_enabled(rack, rack->order[s])) {
+            active[num_active++] = rack->order[s];
+        }
+    }
+    if (num_active == 0) {
+        return;
+    }
+
+    for (int start = 0; start < num_frames; start += FX_RACK_BLOCK_FRAMES) {
+        int count = num_frames - start;
+        if (count > FX_RACK_BLOCK_FRAMES) {
+            count = FX_RACK_BLOCK_FRAMES;
+        }
+        float* block = frames + (size_t)start * 2;
+        for (int s = 0; s < num_active; s++) {
+            FxSleep* sleep = &rack->sleep[active[s]];
+            if (sleep->asleep && sleep->clearing) {
+                fx_rack_clear_step(rack, active[s], sleep);
+            }
+        }
+
+        // Silence into a chain that is all asleep passes straight through.
+        // The peak covers the interleaved block as two halves.
+        float peak = dyn_peak(block, block + count, count);
+        bool all_asleep = true;
+        for (int s = 0; s < num_active; s++) {
+            all_asleep = all_asleep && rack->sleep[active[s]].asleep;
+        }
+        if (all_asleep && peak < FX_SLEEP_THRESHOLD) {
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            rack->scratch_l[i] = block[i * 2];
+            rack->scratch_r[i] = block[i * 2 + 1];
+        }
+        for (int s = 0; s < num_active; s++) {
+            FxSleep* sleep = &rack->sleep[active[s]];
+            bool quiet_in = peak < FX_SLEEP_THRESHOLD;
+            if (quiet_in && sleep->asleep) {
+                continue;
+            }
+            sleep->asleep = false;
+            sleep->clearing = false;
+            fx_rack_run_slot(rack, active[s], rack->scratch_l, rack->scratch_r, count, sample_rate);
+
+            // Each slot's output peak is the next one's input peak
+            peak = dyn_peak(rack->scratch_l, rack->scratch_r, count);
+            if (quiet_in && peak < FX_SLEEP_THRESHOLD) {
+                sleep->quiet_frames += (uint32_t)count;
+                if (sleep->quiet_frames >= fx_rack_tail_frames(rack, active[s], sample_rate)) {
+                    fx_rack_rest(rack, active[s]);
+                    sleep->asleep = true;
+                    sleep->clearing = true;
+                    sleep->cleared = 0;
+                    sleep->quiet_frames = 0;
+                }
+            } else {
+                sleep->quiet_frames = 0;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            block[i * 2] = rack->scratch_l[i];
+            block[i * 2 + 1] = rack->scratch_r[i];
+        }
+    }
+}
+
+// ============================================================================
+// DISTORTION
+// ============================================================================
+
+static void distortion_shape(float* left, float* right, int num_frames, float drive, float dry, float wet) {
+    for (int i = 0; i < num_frames; i++) {
+        // Soft clipping
+        float l = dsp_tanhf(left[i] * drive);
+        float r = dsp_tanhf(right[i] * drive);
+        left[i] = left[i] * dry + l * wet;
+        right[i] = right[i] * dry + r * wet;
+    }
+}
+
+void fx_distortion_process(Distortion* fx, float* left, float* right, int num_frames) {
+    if (!fx->enabled) return;
+
+    float drive = fx->drive;
+    float dry = 1.0f - fx->mix;
+    float wet = fx->mix;
+    if (fx->oversample != fx->os.mode) {
+        oversampler_set_mode(&fx->os, fx->oversample);
+    }
+    if (fx->os.mode == OVERSAMPLE_OFF) {
+        distortion_shape(left, right, num_frames, drive, dry, wet);
+        return;
+    }
+    // tanh at high drive has harmonics far past Nyquist; shape at the
+    // higher rate so they are filtered out instead of folding back
+    for (int start = 0; start < num_frames; start += OVERSAMPLE_MAX_BLOCK) {
+        int count = num_frames - start;
+        if (count > OVERSAMPLE_MAX_BLOCK) {
+            count = OVERSAMPLE_MAX_BLOCK;
+        }
+        int oversampled = oversampler_upsample(&fx->os, left + start, right + start, count);
+        distortion_shape(fx->os.left, fx->os.right, oversampled, drive, dry, wet);
+        oversampler_downsample(&fx->os, left + start, right + start, count);
+    }
+}
+
+// ============================================================================
+// CHORUS
+// ============================================================================
+
+// Settings only; the lines come from fx_rack_prepare()
+void fx_chorus_init(Chorus* fx) {
+    fx->phase = 0.0f;
+    fx->rate = 0.5f;
+    fx->depth = 10.0f;
+    fx->mix = 0.5f;
+}
+
+// Linear-interpolated tap `delay` samples behind write_pos
+static inline float fx_chorus_tap(const float* line, uint32_t mask, uint32_t write_pos, float delay) {
+    float read = (float)write_pos - delay;
+    float base = floorf(read);
+    float frac = read - base;
+    uint32_t index = (uint32_t)(int32_t)base & mask;
+    float a = line[index];
+    float b = line[(index + 1) & mask];
+    return a + (b - a) * frac;
+}
+
+void fx_chorus_process(Chorus* fx, float* left, float* right, int num_frames, float sample_rate) {
+    if (!fx->enabled || !fx->buffer_l) return;
+
+    float depth_ms = fx->depth < 0.0f ? 0.0f : fx->depth;
+    if (depth_ms > FX_CHORUS_MAX_DEPTH_MS) depth_ms = FX_CHORUS_MAX_DEPTH_MS;
+    float ms_to_samples = sample_rate / 1000.0f;
+    float base = FX_CHORUS_BASE_MS * ms_to_samples;
+    float sweep = 0.5f * depth_ms * ms_to_samples;
+    uint32_t mask = fx->mask;
+    float max_delay = (float)(mask - 1);
+    float phase_inc = fx->rate / sample_rate;
+    float dry = 1.0f - fx->mix;
+    float wet = fx->mix;
+
+    float phase = fx->phase;
+    uint32_t pos = fx->write_pos;
+    for (int i = 0; i < num_frames; i++) {
+        fx->buffer_l[pos] = left[i];
+        fx->buffer_r[pos] = right[i];
+
+        // Quadrature LFOs keep the two sides from sweeping together
+        float delay_l = base + sweep * (1.0f + dsp_sin_turns(phase));
+        float delay_r = base + sweep * (1.0f + dsp_cos_turns(phase));
+        if (delay_l > max_delay) delay_l = max_delay;
+        if (delay_r > max_delay) delay_r = max_delay;
+        float wet_l = fx_chorus_tap(fx->buffer_l, mask, pos, delay_l);
+        float wet_r = fx_chorus_tap(fx->buffer_r, mask, pos, delay_r);
+        left[i] = left[i] * dry + wet_l * wet;
+        right[i] = right[i] * dry + wet_r * wet;
+
+        pos = (pos + 1) & mask;
+        phase += phase_inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+    }
+    fx->phase = phase;
+    fx->write_pos = pos;
+}
+
+// ============================================================================
+// COMPRESSOR
+// ============================================================================
+
+void fx_compressor_init(Compressor* fx) {
+    memset(fx, 0, sizeof(Compressor));
+    fx->threshold = 0.7f;
+    fx->ratio = 4.0f;
+    fx->gain = 1.0f;
+    fx->gain_target = 1.0f;
+}
+
+// Feed-forward, stereo-linked, on the shared block-rate detector: the
+// input peak of every DYN_CONTROL_FRAMES frames steps the envelope, and the
+// gain ramps linearly to the resulting target across the next control
+// block, so it never jumps and the result does not depend on how the
+// stream is split into blocks.
+void fx_compressor_process(Compressor* fx, float* left, float* right, int num_frames, float sample_rate) {
+    if (!fx->enabled) return;
+
+    dyn_detector_set_times(&fx->detector, FX_COMP_ATTACK_MS * 0.001f, FX_COMP_RELEASE_MS * 0.001f, sample_rate);
+    float threshold = fx->threshold > 1e-6f ? fx->threshold : 1e-6f;
+    float slope = 1.0f / (fx->ratio > 1.0f ? fx->ratio : 1.0f) - 1.0f; // <= 0
+
+    int done = 0;
+    while (done < num_frames) {
+        int count = DYN_CONTROL_FRAMES - fx->control_fill;
+        if (count > num_frames - done) {
+            count = num_frames - done;
+        }
+        fx->block_peak = fmaxf(fx->block_peak, dyn_peak(left + done, right + done, count));
+        dyn_apply_gain_ramp(left + done, right + done, count, fx->gain, fx->gain_step, fx->control_fill);
+
+        fx->control_fill += count;
+        if (fx->control_fill == DYN_CONTROL_FRAMES) {
+            fx->gain = fx->gain_target; // Land exactly, no drift
+            float envelope = dyn_detector_step(&fx->detector, fx->block_peak);
+            fx->gain_target = dyn_compress_gain(envelope, threshold, slope);
+            fx->gain_step = (fx->gain_target - fx->gain) / (float)DYN_CONTROL_FRAMES;
+            fx->control_fill = 0;
+            fx->block_peak = 0.0f;
+        }
+        done += count;
+    }
+}
+
+// ============================================================================
+// DELAY
+// ============================================================================
+
+// Settings only; the lines come from fx_rack_prepare()
+void fx_delay_init(Delay* fx) {
+    fx->time_ms = 500.0f;
+    fx->feedback = 0.3f;
+    fx->mix = 0.3f;
+}
+
+static inline void fx_delay_line_process(DelayLine* line, float* io, int num_frames,
+                                         uint32_t delay, float feedback, float dry, float wet) {
+    float* buffer = line->buffer;
+    uint32_t mask = line->mask;
+    uint32_t pos = line->write_pos;
+    for (int i = 0; i < num_frames; i++) {
+        float delayed = buffer[(pos - delay) & mask];
+        buffer[pos] = denormal_flush(io[i] + delayed * feedback);
+        io[i] = io[i] * dry + delayed * wet;
+        pos = (pos + 1) & mask;
+    }
+    line->write_pos = pos;
+}
+
+// Delay time in frames, within what the line holds
+static uint32_t fx_delay_frames(const Delay* fx, float sample_rate) {
+    int delay_samples = (int)((fx->time_ms / 1000.0f) * sample_rate);
+    if (delay_samples < 0) delay_samples = 0;
+    if ((uint32_t)delay_samples > fx->delay_l.mask) delay_samples = (int)fx->delay_l.mask;
+    return (uint32_t)delay_samples;
+}
+
+void fx_delay_process(Delay* fx, float* left, float* right, int num_frames, float sample_rate) {
+    if (!fx->enabled || !fx->delay_l.buffer || !fx->delay_r.buffer) return;
+
+    uint32_t delay_samples = fx_delay_frames(fx, sample_rate);
+    float dry = 1.0f - fx->mix;
+    fx_delay_line_process(&fx->delay_l, left, num_frames, delay_samples, fx->feedback, dry, fx->mix);
+    fx_delay_line_process(&fx->delay_r, right, num_frames, delay_samples, fx->feedback, dry, fx->mix);
+}
+
+// ============================================================================
+// REVERB
+// ============================================================================
+
+// Mutually prime-ish line lengths at full size; 8-line tiers take every other
+static const float fx_reverb_line_ms[FX_REVERB_MAX_LINES] = {
+    29.7f, 31.9f, 37.1f, 41.1f, 43.7f, 47.3f, 53.9f, 59.3f,
+    61.7f, 67.1f, 71.3f, 73.9f, 79.1f, 83.3f, 89.9f, 97.3f
+};
+
+int fx_reverb_line_count(FxReverbQuality quality) {
+    return quality == FX_REVERB_HIGH ? 16 : 8;
+}
+
+const char* fx_reverb_quality_name(FxReverbQuality quality) {
+    switch (quality) {
+        case FX_REVERB_ECO:      return "Eco";
+        case FX_REVERB_STANDARD: return "Standard";
+        case FX_REVERB_HIGH:     return "High";
+        default:                 return "Unknown";
+    }
+}
+
+// Line lengths scale with size; each line's loss per pass is set so the
+// whole network reaches -60 dB in the RT60, and longer lines get more
+// damping so high frequencies fade evenly across lines.
+static void fx_reverb_update(Reverb* fx) {
+    int quality = fx->quality >= 0 && fx->quality < FX_REVERB_QUALITY_COUNT ? (int)fx->quality
+                                                                            : FX_REVERB_STANDARD;
+    if (quality != fx->prepared_quality && !fx->lines_zeroed) {
+        // Lines a new tier brings in must not replay what they held before.
+        // Zeroing them all at once is megabytes at high rates, so the wet
+        // signal is muted while fx_reverb_clear_step does it in chunks.
+        fx->clearing = true;
+        fx->cleared = 0;
+        memset(fx->lowpass, 0, sizeof(fx->lowpass));
+    }
+    int n = fx_reverb_line_count((FxReverbQuality)quality);
+    float size = fx->size < 0.0f ? 0.0f : (fx->size > 1.0f ? 1.0f : fx->size);
+    float damping = fx->damping < 0.0f ? 0.0f : (fx->damping > 1.0f ? 1.0f : fx->damping);
+    float scale = 0.5f + 0.5f * size;
+    float rt60_frames = (0.3f + 4.7f * size) * fx->sample_rate;
+    float max_length = (float)(fx->line_capacity - 1);
+    float longest = fx_reverb_line_ms[FX_REVERB_MAX_LINES - 1] * scale * 0.001f * fx->sample_rate;
+    float mix_norm = quality == FX_REVERB_ECO ? 1.0f : 1.0f / sqrtf((float)n); // Hadamard is unnormalized
+
+    for (int i = 0; i < n; i++) {
+        float length = fx_reverb_line_ms[i * (FX_REVERB_MAX_LINES / n)] * scale * 0.001f * fx->sample_rate;
+        if (length < 1.0f) length = 1.0f;
+        if (length > max_length) length = max_length;
+        fx->length[i] = (uint32_t)length;
+        // 10^(-3 * length / rt60) via exp2 (log2 10 = 3.32192809)
+        fx->gain[i] = dsp_exp2f(-3.0f * 3.32192809f * (float)fx->length[i] / rt60_frames) * mix_norm;
+        fx->damp[i] = damping * 0.7f * ((float)fx->length[i] / longest);
+    }
+    fx->num_lines = n;
+    fx->prepared_size = fx->size;
+    fx->prepared_damping = fx->damping;
+    fx->prepared_quality = quality;
+}
+
+// In-place fast Walsh-Hadamard transform (n a power of two)
+static inline void fx_reverb_hadamard(float* x, int n) {
+    for (int h = 1; h < n; h <<= 1) {
+        for (int i = 0; i < n; i += h * 2) {
+            for (int j = i; j < i + h; j++) {
+                float a = x[j];
+                float b = x[j + h];
+                x[j] = a + b;
+                x[j + h] = a - b;
+            }
+        }
+    }
+}
+
+// I - (2/n) * ones: reflect about the all-ones vector
+static inline void fx_reverb_householder(float* x, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    sum *= 2.0f / (float)n;
+    for (int i = 0; i < n; i++) {
+        x[i] -= sum;
+    }
+}
+
+// One network run; called with a constant line count so the per-line loops
+// unroll and vectorize
+static inline void fx_reverb_run(Reverb* fx, float* left, float* right, int num_frames,
+                                 const int n, const bool hadamard) {
+    float* lines = fx->lines;
+    uint32_t mask = fx->line_capacity - 1;
+    uint32_t pos = fx->pos;
+    float dry = 1.0f - fx->mix;
+    float wet = fx->mix * (1.0f / sqrtf((float)(n / 2))); // Each side sums n/2 lines
+    float lowpass[FX_REVERB_MAX_LINES];
+    memcpy(lowpass, fx->lowpass, sizeof(lowpass));
+
+    for (int f = 0; f < num_frames; f++) {
+        float x[FX_REVERB_MAX_LINES];
+        for (int i = 0; i < n; i++) {
+            x[i] = lines[((pos - fx->length[i]) & mask) * FX_REVERB_MAX_LINES + i];
+        }
+        float out_l = 0.0f;
+        float out_r = 0.0f;
+        for (int i = 0; i < n; i += 2) {
+            out_l += x[i];
+            out_r += x[i + 1];
+        }
+        // Flushing the damping state keeps decaying tails out of the
+        // subnormal range in every line
+        for (int i = 0; i < n; i++) {
+            lowpass[i] = denormal_flush(x[i] + (lowpass[i] - x[i]) * fx->damp[i]);
+            x[i] = lowpass[i] * fx->gain[i];
+        }
+        if (hadamard) {
+            fx_reverb_hadamard(x, n);
+        } else {
+            fx_reverb_householder(x, n);
+        }
+
+        // Mono input fed with alternating pairs of signs
+        float input = (left[f] + right[f]) * 0.5f;
+        float* frame = lines + (size_t)pos * FX_REVERB_MAX_LINES;
+        for (int i = 0; i < n; i++) {
+            frame[i] = x[i] + ((i & 2) ? -input : input);
+        }
+        pos = (pos + 1) & mask;
+
+        left[f] = left[f] * dry + out_l * wet;
+        right[f] = right[f] * dry + out_r * wet;
+    }
+    memcpy(fx->lowpass, lowpass, sizeof(lowpass));
+    fx->pos = pos;
+}
+
+// Zero the next FX_REST_CHUNK_FLOATS of the lines after a live quality change
+static void fx_reverb_clear_step(Reverb* fx) {
+    size_t total = (size_t)fx->line_capacity * FX_REVERB_MAX_LINES;
+    size_t n = total - fx->cleared < FX_REST_CHUNK_FLOATS ? total - fx->cleared : FX_REST_CHUNK_FLOATS;
+    memset(fx->lines + fx->cleared, 0, n * sizeof(float));
+    fx->cleared += n;
+    if (fx->cleared >= total) {
+        fx->clearing = false;
+        fx->lines_zeroed = true;
+    }
+}
+
+void fx_reverb_process(Reverb* fx, float* left, float* right, int num_frames) {
+    if (!fx->enabled || !fx->lines) return;
+
+    if (fx->size != fx->prepared_size || fx->damping != fx->prepared_damping ||
+        (int)fx->quality != fx->prepared_quality) {
+        fx_reverb_update(fx);
+    }
+    if (fx->clearing) {
+        fx_reverb_clear_step(fx);
+        float dry = 1.0f - fx->mix;
+        for (int f = 0; f < num_frames; f++) {
+            left[f] *= dry;
+            right[f] *= dry;
+        }
+        return;
+    }
+    fx->lines_zeroed = false;
+    switch (fx->prepared_quality) {
+        case FX_REVERB_ECO:
+            fx_reverb_run(fx, left, right, num_frames, 8, false);
+            break;
+        case FX_REVERB_HIGH:
+            fx_reverb_run(fx, left, right, num_frames, 16, true);
+            break;
+        default:
+            fx_reverb_run(fx, left, right, num_frames, 8, true);
+            break;
+    }
+}
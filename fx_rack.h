@@ -0,0 +1,241 @@
+#ifndef FX_RACK_H
+#define FX_RACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dynamics.h"
+#include "oversample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// EFFECTS SYSTEM
+// ============================================================================
+//
+// Block-processing effects on planar stereo buffers, chained through a
+// reorderable list of slots. fx_rack_process() takes the engine's
+// interleaved output, splits it into the rack's planar scratch and runs
+// each enabled slot over the whole block. A bypassed slot is skipped
+// outright; with every slot bypassed the block is not even touched.
+//
+// Delay lines are power-of-two rings indexed with a mask, so a read never
+// needs a modulo or a wrap branch.
+//
+// The distortion can run 2x or 4x oversampled (oversample.h), so its
+// harmonics are filtered instead of aliasing. Only that slot pays for it;
+// the rest of the chain stays at the base rate.
+//
+// Memory: every sample buffer (delay, chorus and reverb lines) is carved
+// from one arena that fx_rack_prepare() allocates for the real sample rate
+// and the configured maximum times. Nothing allocates while processing, and
+// an effect whose buffers are not prepared passes audio through.
+//
+// Silence: a slot whose input and output stay under FX_SLEEP_THRESHOLD for
+// as long as its tail can ring (the delay's echoes and the reverb's RT60
+// down to the threshold, the compressor's release...) goes to sleep. It is
+// skipped, passing the block through, until input returns. Its state is
+// reset to rest, the delay lines FX_REST_CHUNK_FLOATS per block, so going
+// to sleep never costs a whole-arena clear in one callback. A silent block
+// into a chain that is all asleep costs one peak scan.
+//
+// Threading: the rack belongs to the audio thread. Parameter fields are
+// plain floats written between blocks (the app applies them from its
+// param queue); fx_rack_set_order() must be called between blocks too.
+
+#define FX_RACK_BLOCK_FRAMES 256          // Planar scratch; longer blocks are chunked
+
+#define FX_DELAY_MAX_MS 2000.0f           // Default longest delay time the arena holds
+
+#define FX_CHORUS_BASE_MS 5.0f            // Shortest tap delay
+#define FX_CHORUS_MAX_DEPTH_MS 20.0f      // Widest sweep on top of the base
+
+#define FX_REVERB_MAX_LINES 16
+#define FX_REVERB_MAX_LINE_MS 100.0f      // Longest FDN line at full size
+
+#define FX_COMP_ATTACK_MS 5.0f
+#define FX_COMP_RELEASE_MS 80.0f
+
+#define FX_SLEEP_THRESHOLD 1e-5f          // -100 dBFS
+#define FX_REST_CHUNK_FLOATS 8192         // Line memory a sleeping slot clears per block
+
+typedef enum {
+    FX_DISTORTION = 0,
+    FX_CHORUS,
+    FX_COMPRESSOR,
+    FX_DELAY,
+    FX_REVERB,
+    FX_TYPE_COUNT
+} FxType;
+
+// One preallocated block that the rack's buffers are carved from
+typedef struct {
+    float* base;
+    size_t capacity;  // Floats
+    size_t used;
+    float sample_rate;
+    float max_delay_ms;
+} FxArena;
+
+typedef struct {
+    float* buffer;    // Carved from the arena; mask + 1 floats
+    uint32_t mask;
+    uint32_t write_pos;
+} DelayLine;
+
+typedef struct {
+    bool enabled;
+    float drive;      // 0-10
+    float mix;        // 0-1
+    OversampleMode oversample;   // Picked up on the next block
+    Oversampler os;   // Dry and wet both run oversampled, so they stay aligned
+} Distortion;
+
+typedef struct {
+    bool enabled;
+    float rate;       // LFO Hz, 0.05-5
+    float depth;      // Sweep width in ms, 0-FX_CHORUS_MAX_DEPTH_MS
+    float mix;        // 0-1
+    float phase;      // LFO phase in turns (right channel runs a quarter ahead)
+    float* buffer_l;  // Carved from the arena; mask + 1 floats each
+    float* buffer_r;
+    uint32_t mask;
+    uint32_t write_pos;
+} Chorus;
+
+typedef struct {
+    bool enabled;
+    float threshold;  // Linear peak level, 0-1
+    float ratio;      // 1-20
+    DynDetector detector; // Stereo-linked peak envelope (dynamics.h)
+    float gain;       // Gain at the start of the control block
+    float gain_target; // ...and at its end
+    float gain_step;  // Per-frame ramp between the two
+    int control_fill; // Frames into the current control block
+    float block_peak; // Input peak of the control block so far
+} Compressor;
+
+typedef struct {
+    bool enabled;
+    float time_ms;    // 100-2000ms
+    float feedback;   // 0-0.95
+    float mix;        // 0-1
+    DelayLine delay_l;
+    DelayLine delay_r;
+} Delay;
+
+// Reverb quality/CPU tiers. Per-sample work is fixed by the tier alone:
+// every line does one read, one write and one damping one-pole, plus the
+// mixing matrix. No setting or signal changes that cost.
+//   ECO       8 lines, Householder mix (2N adds)
+//   STANDARD  8 lines, Hadamard mix (N log2 N adds)
+//   HIGH     16 lines, Hadamard mix
+typedef enum {
+    FX_REVERB_ECO = 0,
+    FX_REVERB_STANDARD,
+    FX_REVERB_HIGH,
+    FX_REVERB_QUALITY_COUNT
+} FxReverbQuality;
+
+// Feedback delay network. Line storage is frame-major (all lines' samples
+// for one frame are adjacent), so each frame's writes are one contiguous
+// FX_REVERB_MAX_LINES-wide store. It is carved from the rack arena.
+typedef struct {
+    bool enabled;
+    float size;       // 0-1: line lengths and decay time (0.3-5 s RT60)
+    float damping;    // 0-1: high-frequency loss in the feedback path
+    float mix;        // 0-1
+    FxReverbQuality quality;
+
+    float* lines;     // line_capacity * FX_REVERB_MAX_LINES floats
+    uint32_t line_capacity; // Power of two
+    uint32_t pos;
+    float sample_rate;
+
+    // Derived from size/damping/quality (recomputed when they change)
+    int num_lines;
+    uint32_t length[FX_REVERB_MAX_LINES];
+    float gain[FX_REVERB_MAX_LINES];      // Per-pass loss for the RT60
+    float damp[FX_REVERB_MAX_LINES];      // Per-line lowpass coefficient
+    float lowpass[FX_REVERB_MAX_LINES];   // Lowpass state
+    float prepared_size;
+    float prepared_damping;
+    int prepared_quality;
+
+    bool lines_zeroed;  // Nothing written since the lines were last zeroed
+    bool clearing;      // Quality changed live: wet muted until the lines are zeroed
+    size_t cleared;     // Floats zeroed so far while clearing
+} Reverb;
+
+// Silence tracking for one slot
+typedef struct {
+    uint32_t quiet_frames;   // Input and output under the threshold this long
+    bool asleep;
+    bool clearing;           // Asleep, lines not all zeroed yet
+    size_t cleared;          // Floats of the slot's lines zeroed so far
+} FxSleep;
+
+typedef struct {
+    Distortion distortion;
+    Chorus chorus;
+    Compressor compressor;
+    Delay delay;
+    Reverb reverb;
+    FxSleep sleep[FX_TYPE_COUNT];   // By FxType
+
+    // Processing order; types left out of the chain are not run at all
+    FxType order[FX_TYPE_COUNT];
+    int num_slots;
+
+    float scratch_l[FX_RACK_BLOCK_FRAMES];
+    float scratch_r[FX_RACK_BLOCK_FRAMES];
+
+    float max_delay_ms;   // Longest delay the next prepare should hold
+    FxArena arena;
+} EffectsRack;
+
+// Loads the default settings (all effects bypassed, chain in FxType order)
+// with no buffers. Free a prepared rack before re-initializing it.
+void fx_rack_init(EffectsRack* rack);
+// Allocate the arena for `sample_rate` and rack->max_delay_ms and carve every
+// buffer from it, cleared. Call outside the audio thread, before processing
+// and whenever the rate or max delay changes; a repeat call with the same
+// sizes keeps the buffers as they are. On failure the old arena is kept.
+bool fx_rack_prepare(EffectsRack* rack, float sample_rate);
+void fx_rack_free(EffectsRack* rack);
+// Bytes of sample memory the rack holds (the arena)
+size_t fx_rack_memory_bytes(const EffectsRack* rack);
+
+// Replace the chain with `count` distinct types; false (chain unchanged)
+// on a repeated or unknown type
+bool fx_rack_set_order(EffectsRack* rack, const FxType* order, int count);
+bool fx_rack_slot_enabled(const EffectsRack* rack, FxType type);
+// True while the slot sleeps through silence
+bool fx_rack_slot_asleep(const EffectsRack* rack, FxType type);
+// Asleep with its lines fully cleared: it will wake exactly as a fresh slot
+bool fx_rack_slot_at_rest(const EffectsRack* rack, FxType type);
+const char* fx_type_name(FxType type);
+
+// Interleaved stereo frames through the chain, in place
+void fx_rack_process(EffectsRack* rack, float* frames, int num_frames, float sample_rate);
+
+// Planar effects, in place
+void fx_distortion_process(Distortion* fx, float* left, float* right, int num_frames);
+void fx_chorus_init(Chorus* fx);
+void fx_chorus_process(Chorus* fx, float* left, float* right, int num_frames, float sample_rate);
+void fx_compressor_init(Compressor* fx);
+void fx_compressor_process(Compressor* fx, float* left, float* right, int num_frames, float sample_rate);
+void fx_delay_init(Delay* fx);
+void fx_delay_process(Delay* fx, float* left, float* right, int num_frames, float sample_rate);
+void fx_reverb_process(Reverb* fx, float* left, float* right, int num_frames);
+int fx_reverb_line_count(FxReverbQuality quality);
+const char* fx_reverb_quality_name(FxReverbQuality quality);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FX_RACK_H
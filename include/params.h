@@ -97,6 +97,10 @@ typedef enum ParamId {
 
     // Misc / utility
     PARAM_PANIC,
+
+    // Oscillator unison; appended so the ids above keep their values
+    PARAM_OSC1_UNISON,
+    PARAM_OSC2_UNISON,
     PARAM_PARAM_COUNT
 } ParamId;
 
@@ -0,0 +1,169 @@
+#include "meter_feed.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define METER_FEED_SILENCE_DB -120.0f
+
+void meter_feed_init(MeterFeed* feed) {
+    if (!feed) {
+        return;
+    }
+    memset(feed, 0, sizeof(*feed));
+    atomic_init(&feed->dropped_frames, 0);
+    atomic_init(&feed->dropped_scope, 0);
+    PaUtil_InitializeRingBuffer(&feed->frames, sizeof(MeterFrame), METER_FEED_QUEUE, feed->frame_buffer);
+    PaUtil_InitializeRingBuffer(&feed->scope, sizeof(float), METER_FEED_SCOPE_QUEUE, feed->scope_buffer);
+}
+
+// ============================================================================
+// AUDIO THREAD
+// ============================================================================
+
+void meter_feed_set_voices(MeterFeed* feed, const MeterVoices* voices) {
+    if (feed && voices) {
+        feed->voices = *voices;
+    }
+}
+
+static void meter_feed_publish(MeterFeed* feed) {
+    MeterFrame frame;
+    for (int c = 0; c < 2; c++) {
+        frame.peak[c] = feed->peak[c];
+        frame.rms[c] = (float)sqrt(feed->sum_squares[c] / (double)feed->window_frames);
+        feed->peak[c] = 0.0f;
+        feed->sum_squares[c] = 0.0;
+    }
+    frame.voices = feed->voices;
+    feed->window_frames = 0;
+    if (PaUtil_WriteRingBuffer(&feed->frames, &frame, 1) != 1) {
+        atomic_fetch_add_explicit(&feed->dropped_frames, 1u, memory_order_relaxed);
+    }
+}
+
+void meter_feed_push(MeterFeed* feed, const float* stereo, uint32_t frames) {
+    if (!feed || !stereo) {
+        return;
+    }
+    float mono[256];
+    uint32_t done = 0;
+    while (done < frames) {
+        uint32_t chunk = frames - done;
+        if (chunk > METER_FEED_WINDOW - feed->window_frames) {
+            chunk = METER_FEED_WINDOW - feed->window_frames;
+        }
+        if (chunk > sizeof(mono) / sizeof(mono[0])) {
+            chunk = sizeof(mono) / sizeof(mono[0]);
+        }
+        const float* in = stereo + (size_t)done * 2;
+        float peak_l = feed->peak[0];
+        float peak_r = feed->peak[1];
+        double sum_l = 0.0;
+        double sum_r = 0.0;
+        for (uint32_t i = 0; i < chunk; i++) {
+            float l = in[i * 2];
+            float r = in[i * 2 + 1];
+            peak_l = fmaxf(peak_l, fabsf(l));
+            peak_r = fmaxf(peak_r, fabsf(r));
+            sum_l += (double)l * l;
+            sum_r += (double)r * r;
+            mono[i] = 0.5f * (l + r);
+        }
+        feed->peak[0] = peak_l;
+        feed->peak[1] = peak_r;
+        feed->sum_squares[0] += sum_l;
+        feed->sum_squares[1] += sum_r;
+
+        // Whole chunks or nothing, so the scope never shows a seam mid-chunk
+        if (PaUtil_GetRingBufferWriteAvailable(&feed->scope) >= (ring_buffer_size_t)chunk) {
+            PaUtil_WriteRingBuffer(&feed->scope, mono, (ring_buffer_size_t)chunk);
+        } else {
+            atomic_fetch_add_explicit(&feed->dropped_scope, chunk, memory_order_relaxed);
+        }
+
+        feed->window_frames += chunk;
+        done += chunk;
+        if (feed->window_frames == METER_FEED_WINDOW) {
+            meter_feed_publish(feed);
+        }
+    }
+}
+
+// ============================================================================
+// UI THREAD
+// ============================================================================
+
+bool meter_feed_poll(MeterFeed* feed, MeterFrame* out) {
+    if (!feed || !out) {
+        return false;
+    }
+
+    float chunk[512];
+    ring_buffer_size_t got;
+    while ((got = PaUtil_ReadRingBuffer(&feed->scope, chunk, (ring_buffer_size_t)(sizeof(chunk) / sizeof(chunk[0])))) > 0) {
+        for (ring_buffer_size_t i = 0; i < got; i++) {
+            feed->scope_history[feed->scope_write] = chunk[i];
+            feed->scope_write = (feed->scope_write + 1) % METER_FEED_SCOPE_SIZE;
+        }
+    }
+
+    MeterFrame frame;
+    float peak[2] = {0.0f, 0.0f};
+    bool any = false;
+    while (PaUtil_ReadRingBuffer(&feed->frames, &frame, 1) == 1) {
+        peak[0] = fmaxf(peak[0], frame.peak[0]);
+        peak[1] = fmaxf(peak[1], frame.peak[1]);
+        any = true;
+    }
+    if (any) {
+        *out = frame;
+        out->peak[0] = peak[0];
+        out->peak[1] = peak[1];
+    }
+    return any;
+}
+
+int meter_feed_scope(const MeterFeed* feed, float* out, int count) {
+    if (!feed || !out || count <= 0) {
+        return 0;
+    }
+    if (count > METER_FEED_SCOPE_SIZE) {
+        count = METER_FEED_SCOPE_SIZE;
+    }
+    uint32_t start = (feed->scope_write + METER_FEED_SCOPE_SIZE - (uint32_t)count) % METER_FEED_SCOPE_SIZE;
+    for (int i = 0; i < count; i++) {
+        out[i] = feed->scope_history[(start + (uint32_t)i) % METER_FEED_SCOPE_SIZE];
+    }
+    return count;
+}
+
+void meter_feed_spectrum(const float* samples, int count, float sample_rate,
+                         float lo_hz, float hi_hz, float* bands_db, int band_count) {
+    if (!samples || !bands_db || count <= 1 || band_count <= 0 || sample_rate <= 0.0f) {
+        return;
+    }
+    hi_hz = fminf(hi_hz, sample_rate * 0.5f);
+    lo_hz = fmaxf(lo_hz, 1.0f);
+    double ratio = band_count > 1 ? pow((double)hi_hz / lo_hz, 1.0 / (band_count - 1)) : 1.0;
+    // Hann window gain is 0.5; scale so a full-scale sine reads 0 dB
+    double scale = 4.0 / (double)count;
+    double freq = lo_hz;
+    for (int b = 0; b < band_count; b++, freq *= ratio) {
+        double coeff = 2.0 * cos(2.0 * M_PI * freq / sample_rate);
+        double s1 = 0.0;
+        double s2 = 0.0;
+        for (int i = 0; i < count; i++) {
+            double window = 0.5 - 0.5 * cos(2.0 * M_PI * i / (count - 1));
+            double s0 = samples[i] * window + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+        double magnitude = sqrt(fmax(power, 0.0)) * scale;
+        bands_db[b] = magnitude > 1e-6 ? (float)(20.0 * log10(magnitude)) : METER_FEED_SILENCE_DB;
+    }
+}
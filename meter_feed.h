@@ -0,0 +1,103 @@
+/**
+ * Audio -> UI meter and scope feed
+ *
+ * The audio callback measures its final mix and publishes, without locks
+ * or allocation:
+ * - meter frames: per-channel peak and RMS over a fixed window of samples,
+ *   plus the voice state the UI displays (held-note bitmask, voice count,
+ *   the newest voices' notes and envelope levels)
+ * - scope samples: the mono mix at full rate
+ *
+ * Both travel through SPSC rings, so neither side ever waits. The UI drains
+ * them on its own schedule, keeps a short scope history and never reads the
+ * engine. A full ring drops the newest data and counts it; meters carry
+ * peaks, so a dropped frame loses detail but never a clip.
+ */
+
+#ifndef METER_FEED_H
+#define METER_FEED_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pa_ringbuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METER_FEED_WINDOW 512          // Frames per meter frame (~12 ms at 44.1 kHz)
+#define METER_FEED_QUEUE 64            // Meter frames in flight; power of two
+#define METER_FEED_SCOPE_QUEUE 16384   // Scope samples in flight; power of two
+#define METER_FEED_SCOPE_SIZE 2048     // Scope history the UI keeps
+#define METER_FEED_VOICE_ROWS 8
+
+typedef struct {
+    int note;                          // MIDI note
+    float level;                       // Amp envelope, 0..1
+    bool releasing;
+} MeterVoiceRow;
+
+typedef struct {
+    uint64_t notes[2];                 // Bit n: MIDI note n has a voice not in release
+    int active_voices;
+    int row_count;
+    MeterVoiceRow rows[METER_FEED_VOICE_ROWS];  // Newest sounding voices, oldest first
+} MeterVoices;
+
+typedef struct {
+    float peak[2];
+    float rms[2];
+    MeterVoices voices;
+} MeterFrame;
+
+typedef struct {
+    // Audio thread
+    float peak[2];
+    double sum_squares[2];
+    uint32_t window_frames;
+    MeterVoices voices;
+
+    // Audio -> UI
+    PaUtilRingBuffer frames;
+    MeterFrame frame_buffer[METER_FEED_QUEUE];
+    PaUtilRingBuffer scope;
+    float scope_buffer[METER_FEED_SCOPE_QUEUE];
+    atomic_uint dropped_frames;
+    atomic_uint dropped_scope;         // Samples
+
+    // UI thread
+    float scope_history[METER_FEED_SCOPE_SIZE];
+    uint32_t scope_write;
+} MeterFeed;
+
+void meter_feed_init(MeterFeed* feed);
+
+// Audio thread: voice state for the frames published from here on
+void meter_feed_set_voices(MeterFeed* feed, const MeterVoices* voices);
+// Audio thread: measure interleaved stereo output; publishes a meter frame
+// each time a window fills
+void meter_feed_push(MeterFeed* feed, const float* stereo, uint32_t frames);
+
+// UI thread: drain the feed. `out` gets the newest voices and RMS, and the
+// highest peak since the last poll. False if nothing arrived.
+bool meter_feed_poll(MeterFeed* feed, MeterFrame* out);
+// UI thread: the newest `count` scope samples, oldest first (count is
+// capped at METER_FEED_SCOPE_SIZE; returns the number written)
+int meter_feed_scope(const MeterFeed* feed, float* out, int count);
+
+// Level in dB (Hann-windowed Goertzel) at `band_count` log-spaced
+// frequencies from lo_hz to hi_hz. Runs on the UI thread over scope samples.
+void meter_feed_spectrum(const float* samples, int count, float sample_rate,
+                         float lo_hz, float hi_hz, float* bands_db, int band_count);
+
+static inline bool meter_voices_note_held(const MeterVoices* voices, int note) {
+    return note >= 0 && note < 128 && ((voices->notes[note >> 6] >> (note & 63)) & 1u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METER_FEED_H
@@ -0,0 +1,53 @@
+/**
+ * Host time to engine frame mapping for timestamped MIDI input
+ */
+
+#include "midi_clock.h"
+
+#include <math.h>
+#include <string.h>
+
+void midi_clock_reset(MidiClock* clock) {
+    memset(clock, 0, sizeof(*clock));
+}
+
+void midi_clock_begin_period(MidiClock* clock, uint64_t now_ns, uint64_t first_frame, uint32_t frames,
+                             float sample_rate) {
+    double ns_per_frame = sample_rate > 0.0f ? 1e9 / (double)sample_rate : 0.0;
+    double measured = (double)now_ns;
+    bool reset = !clock->valid || ns_per_frame != clock->ns_per_frame || first_frame < clock->first_frame;
+    if (!reset) {
+        // Where this period should start if callbacks kept perfect time
+        double predicted = clock->period_start_ns + (double)(first_frame - clock->first_frame) * ns_per_frame;
+        double error = measured - predicted;
+        double period_ns = (double)frames * ns_per_frame;
+        if (fabs(error) > period_ns) {
+            reset = true;
+        } else {
+            clock->period_start_ns = predicted + error / MIDI_CLOCK_SMOOTHING;
+        }
+    }
+    if (reset) {
+        clock->period_start_ns = measured;
+    }
+    clock->ns_per_frame = ns_per_frame;
+    clock->first_frame = first_frame;
+    clock->frames = frames;
+    clock->valid = ns_per_frame > 0.0;
+}
+
+uint64_t midi_clock_frame(const MidiClock* clock, uint64_t host_time_ns) {
+    if (!clock->valid) {
+        return 0;
+    }
+    // Played one period before this one started plays at its first frame
+    double played_from = clock->period_start_ns - (double)clock->frames * clock->ns_per_frame;
+    double offset = ((double)host_time_ns - played_from) / clock->ns_per_frame;
+    if (offset <= 0.0) {
+        return clock->first_frame;
+    }
+    if (offset >= (double)clock->frames) {
+        return clock->first_frame + clock->frames;
+    }
+    return clock->first_frame + (uint64_t)(offset + 0.5);
+}
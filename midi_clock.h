@@ -0,0 +1,52 @@
+#ifndef MIDI_CLOCK_H
+#define MIDI_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Host time to engine frame mapping for timestamped MIDI input.
+ *
+ * MIDI drivers stamp each message on arrival (on the rt_stats_now_ns()
+ * clock). The audio thread starts each period at a known engine frame, so a
+ * message that arrived during the previous period plays at the same offset
+ * into this one: every note lands exactly one period after it was played,
+ * whatever the buffer size, instead of snapping to the next callback.
+ *
+ * Callback start times jitter, so the period's start is predicted from the
+ * frames rendered so far and pulled 1/MIDI_CLOCK_SMOOTHING of the way to
+ * each measured start. A start more than a period off (first call, xrun,
+ * device restart) resets the prediction.
+ */
+
+#define MIDI_CLOCK_SMOOTHING 16.0
+
+typedef struct {
+    double period_start_ns;   // Filtered host time of the current period's start
+    double ns_per_frame;
+    uint64_t first_frame;     // Engine frame the current period starts at
+    uint32_t frames;
+    bool valid;
+} MidiClock;
+
+void midi_clock_reset(MidiClock* clock);
+
+// Audio thread, at the start of each period: `now_ns` is the callback's
+// start on the rt_stats_now_ns() clock
+void midi_clock_begin_period(MidiClock* clock, uint64_t now_ns, uint64_t first_frame, uint32_t frames,
+                             float sample_rate);
+
+// Engine frame for a message stamped `host_time_ns`: one period after it
+// was played, no earlier than the current period's first frame and no later
+// than the next period's. 0 (play now) before the first period.
+uint64_t midi_clock_frame(const MidiClock* clock, uint64_t host_time_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_CLOCK_H
@@ -1,23 +1,45 @@
 #include "midi_input.h"
+#include "midi_clock.h"
 #include "param_queue.h"
 #include "midi_shim.h"
+#include "rt_log.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
 static bool g_midi_running = false;
+static MidiClock g_midi_clock;                                // Audio thread only
+// The driver ring has one write end. CoreMIDI and ALSA deliver on one
+// thread; WinMM may call back per device, so those callbacks take turns.
+// The UI has its own ring and never waits here.
+static atomic_flag g_midi_driver_lock = ATOMIC_FLAG_INIT;
+
+static void midi_queue_warn_overflow(void) {
+    // CoreMIDI callback thread: never touch stdio here
+    static atomic_int warned = 0;
+    if (!atomic_exchange_explicit(&warned, 1, memory_order_relaxed)) {
+        rt_log(RT_LOG_WARN, "⚠️ MIDI queue overflow — dropping events.");
+    }
+}
 
 void midi_queue_push_event(const MidiEvent* event) {
     if (!event) {
         return;
     }
-    if (!midi_queue_enqueue(event)) {
-        static int warned = 0;
-        if (!warned) {
-            fprintf(stderr, "⚠️ MIDI queue overflow — dropping events.\n");
-            warned = 1;
-        }
+    while (atomic_flag_test_and_set_explicit(&g_midi_driver_lock, memory_order_acquire)) {
+    }
+    bool queued = midi_queue_enqueue(event);
+    atomic_flag_clear_explicit(&g_midi_driver_lock, memory_order_release);
+    if (!queued) {
+        midi_queue_warn_overflow();
+    }
+}
+
+void midi_queue_push_ui_event(const MidiEvent* event) {
+    if (event && !midi_ui_queue_enqueue(event)) {
+        midi_queue_warn_overflow();
     }
 }
 
@@ -26,11 +48,77 @@ void midi_queue_drain(midi_event_handler handler, void* userdata) {
         return;
     }
     MidiEvent event;
+    while (midi_ui_queue_dequeue(&event)) {
+        handler(&event, userdata);
+    }
     while (midi_queue_dequeue(&event)) {
         handler(&event, userdata);
     }
 }
 
+void midi_queue_begin_period(uint64_t now_ns, uint64_t first_frame, uint32_t frames, float sample_rate) {
+    midi_clock_begin_period(&g_midi_clock, now_ns, first_frame, frames, sample_rate);
+}
+
+uint64_t midi_event_due_frame(const MidiEvent* event) {
+    if (event->sample_frame != 0) {
+        return event->sample_frame;
+    }
+    return event->host_time_ns != 0 ? midi_clock_frame(&g_midi_clock, event->host_time_ns) : 0;
+}
+
+// The head of whichever ring is due first (the UI's on a tie); false when
+// both are empty. `*from_ui` says which ring to dequeue.
+static bool midi_queue_next(MidiEvent* event, uint64_t* due, bool* from_ui) {
+    MidiEvent ui;
+    MidiEvent driver;
+    bool have_ui = midi_ui_queue_peek(&ui);
+    bool have_driver = midi_queue_peek(&driver);
+    uint64_t ui_due = have_ui ? midi_event_due_frame(&ui) : 0;
+    uint64_t driver_due = have_driver ? midi_event_due_frame(&driver) : 0;
+    if (have_ui && (!have_driver || ui_due <= driver_due)) {
+        *event = ui;
+        *due = ui_due;
+        *from_ui = true;
+        return true;
+    }
+    if (have_driver) {
+        *event = driver;
+        *due = driver_due;
+        *from_ui = false;
+        return true;
+    }
+    return false;
+}
+
+void midi_queue_drain_until(midi_event_handler handler, void* userdata, uint64_t frame_limit) {
+    if (!handler) {
+        return;
+    }
+    // Each ring is in time order, so taking the earlier head each time hands
+    // out every due event, undated ones included, whatever waits in the other
+    MidiEvent event;
+    uint64_t due;
+    bool from_ui;
+    while (midi_queue_next(&event, &due, &from_ui)) {
+        if (due != 0 && due >= frame_limit) {
+            break;
+        }
+        if (from_ui) {
+            midi_ui_queue_dequeue(&event);
+        } else {
+            midi_queue_dequeue(&event);
+        }
+        handler(&event, userdata);
+    }
+}
+
+bool midi_queue_peek_due_frame(uint64_t* frame) {
+    MidiEvent event;
+    bool from_ui;
+    return midi_queue_next(&event, frame, &from_ui);
+}
+
 void midi_queue_send_note_on(uint8_t note, uint8_t velocity) {
     MidiEvent event = {
         .type = MIDI_EVENT_NOTE_ON,
@@ -38,7 +126,7 @@ void midi_queue_send_note_on(uint8_t note, uint8_t velocity) {
         .data1 = note,
         .data2 = velocity
     };
-    midi_queue_push_event(&event);
+    midi_queue_push_ui_event(&event);
 }
 
 void midi_queue_send_note_off(uint8_t note) {
@@ -48,7 +136,7 @@ void midi_queue_send_note_off(uint8_t note) {
         .data1 = note,
         .data2 = 0
     };
-    midi_queue_push_event(&event);
+    midi_queue_push_ui_event(&event);
 }
 
 void midi_input_start(void) {
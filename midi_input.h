@@ -1,6 +1,7 @@
 #ifndef MIDI_INPUT_H
 #define MIDI_INPUT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "synth_types.h"
 
@@ -20,9 +21,30 @@ void midi_input_stop(void);
 // Drain all pending MIDI events while invoking the handler.
 void midi_queue_drain(midi_event_handler handler, void* userdata);
 
-// Push a MIDI event into the queue from any producer thread (UI, MIDI driver, etc.).
+// Audio thread, at the start of each period: anchors driver timestamps to
+// engine frames (midi_clock.h). `now_ns` is the callback's start on the
+// rt_stats_now_ns() clock, `first_frame` the engine frame it renders first.
+void midi_queue_begin_period(uint64_t now_ns, uint64_t first_frame, uint32_t frames, float sample_rate);
+
+// Engine frame an event is due at: its sample_frame when set, else the
+// frame its host timestamp maps to, else 0 (due now)
+uint64_t midi_event_due_frame(const MidiEvent* event);
+
+// Drain only events due before frame_limit (due frame 0 is always due),
+// from the driver and UI rings in due order. A later event at the head of
+// one ring does not hold back due events in the other.
+void midi_queue_drain_until(midi_event_handler handler, void* userdata, uint64_t frame_limit);
+
+// Due frame of the next queued event; false when both rings are empty
+bool midi_queue_peek_due_frame(uint64_t* frame);
+
+// Push a MIDI event from a MIDI driver callback. Never call from the UI
+// (use midi_queue_push_ui_event) or the audio thread.
 void midi_queue_push_event(const MidiEvent* event);
 
+// Push a MIDI event from the UI thread into its own ring; never waits
+void midi_queue_push_ui_event(const MidiEvent* event);
+
 // Print the available hardware MIDI ports (implementation-defined formatting).
 void midi_input_list_ports(void);
 
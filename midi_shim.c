@@ -2,25 +2,32 @@
 
 #include "midi_input.h"
 #include "param_queue.h"
+#include "rt_stats.h"
 
 #include <stdio.h>
 #include <string.h>
 
-#ifdef __APPLE__
-#include <CoreFoundation/CoreFoundation.h>
-#include <CoreMIDI/CoreMIDI.h>
+// One backend per platform; all stamp messages on the rt_stats_now_ns()
+// clock so the audio thread can place them inside its period
+#if defined(__APPLE__)
+#define MIDI_SHIM_COREMIDI 1
+#elif defined(_WIN32)
+#define MIDI_SHIM_WINMM 1
+#elif defined(SYNTH_HAVE_ALSA)
+#define MIDI_SHIM_ALSA 1
+#endif
+
+#if defined(MIDI_SHIM_COREMIDI) || defined(MIDI_SHIM_WINMM) || defined(MIDI_SHIM_ALSA)
 
-static MIDIClientRef g_midi_client = 0;
-static MIDIPortRef g_midi_input_port = 0;
 static int g_sources_connected = 0;
 static bool g_shim_running = false;
 
-static void midi_handle_message(uint8_t status, uint8_t data1, uint8_t data2) {
+static void midi_handle_message(uint8_t status, uint8_t data1, uint8_t data2, uint64_t host_time_ns) {
     MidiEvent event = {0};
     uint8_t status_type = status & 0xF0;
     uint8_t channel = status & 0x0F;
     event.channel = channel;
-
+    event.host_time_ns = host_time_ns;
     switch (status_type) {
         case 0x80: // Note Off
             event.type = MIDI_EVENT_NOTE_OFF;
@@ -37,7 +44,7 @@ static void midi_handle_message(uint8_t status, uint8_t data1, uint8_t data2) {
             event.data2 = data2;
             break;
         case 0xA0: // Polyphonic aftertouch
-            event.type = MIDI_EVENT_AFTERTOUCH;
+            event.type = MIDI_EVENT_POLY_AFTERTOUCH;
             event.data1 = data1;
             event.data2 = data2;
             break;
@@ -68,7 +75,37 @@ static void midi_handle_message(uint8_t status, uint8_t data1, uint8_t data2) {
     midi_queue_push_event(&event);
 }
 
-static void midi_parse_packet(const uint8_t* bytes, size_t length) {
+// Driver stamps after the moment of receipt count as received now
+static uint64_t midi_stamp_no_later(uint64_t stamp_ns, uint64_t now_ns) {
+    return stamp_ns < now_ns ? stamp_ns : now_ns;
+}
+
+#endif // any backend
+
+#if defined(MIDI_SHIM_COREMIDI)
+#include <CoreFoundation/CoreFoundation.h>
+#include <CoreMIDI/CoreMIDI.h>
+#include <mach/mach_time.h>
+
+static MIDIClientRef g_midi_client = 0;
+static MIDIPortRef g_midi_input_port = 0;
+
+// Packet time (mach host time, 0 = now) on the rt_stats_now_ns() clock
+static uint64_t midi_packet_time_ns(MIDITimeStamp stamp) {
+    uint64_t now = rt_stats_now_ns();
+    uint64_t mach_now = mach_absolute_time();
+    if (stamp == 0 || stamp >= mach_now) {
+        return now;
+    }
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    uint64_t age = (mach_now - stamp) * timebase.numer / timebase.denom;
+    return age < now ? now - age : now;
+}
+
+static void midi_parse_packet(const uint8_t* bytes, size_t length, uint64_t host_time_ns) {
     if (!bytes || length == 0) {
         return;
     }
@@ -78,6 +115,11 @@ static void midi_parse_packet(const uint8_t* bytes, size_t length) {
     while (i < length) {
         uint8_t byte = bytes[i];
 
+        if (byte >= 0xF8) {
+            // Realtime (clock, start, stop) may sit inside any message
+            i++;
+            continue;
+        }
         if (byte & 0x80) {
             running_status = byte;
             i++;
@@ -93,7 +135,7 @@ static void midi_parse_packet(const uint8_t* bytes, size_t length) {
         switch (status_type) {
             case 0xC0:
             case 0xD0:
-                midi_handle_message(running_status, byte, 0);
+                midi_handle_message(running_status, byte, 0, host_time_ns);
                 i++;
                 break;
             case 0x80:
@@ -104,7 +146,7 @@ static void midi_parse_packet(const uint8_t* bytes, size_t length) {
                 if (i + 1 >= length) {
                     return;
                 }
-                midi_handle_message(running_status, byte, bytes[i + 1]);
+                midi_handle_message(running_status, byte, bytes[i + 1], host_time_ns);
                 i += 2;
                 break;
             default:
@@ -122,7 +164,7 @@ static void midi_read_proc(const MIDIPacketList* pktlist,
 
     const MIDIPacket* packet = &pktlist->packet[0];
     for (UInt32 i = 0; i < pktlist->numPackets; ++i) {
-        midi_parse_packet(packet->data, packet->length);
+        midi_parse_packet(packet->data, packet->length, midi_packet_time_ns(packet->timeStamp));
         packet = MIDIPacketNext(packet);
     }
 }
@@ -215,7 +257,305 @@ void midi_shim_list_ports(void) {
     }
 }
 
-#else // !__APPLE__
+
+#elif defined(MIDI_SHIM_WINMM)
+#include <windows.h>
+#include <mmsystem.h>
+
+#define MIDI_SHIM_MAX_INPUTS 16
+
+static HMIDIIN g_midi_inputs[MIDI_SHIM_MAX_INPUTS];
+static uint64_t g_midi_start_ns[MIDI_SHIM_MAX_INPUTS];   // WinMM stamps count ms from midiInStart()
+
+static void CALLBACK midi_in_proc(HMIDIIN handle, UINT message, DWORD_PTR instance,
+                                  DWORD_PTR param1, DWORD_PTR param2) {
+    (void)handle;
+    if (message != MIM_DATA || instance >= MIDI_SHIM_MAX_INPUTS) {
+        return;
+    }
+    uint64_t now = rt_stats_now_ns();
+    uint64_t stamp = g_midi_start_ns[instance] + (uint64_t)param2 * 1000000ull;
+    midi_handle_message((uint8_t)(param1 & 0xFF),
+                        (uint8_t)((param1 >> 8) & 0x7F),
+                        (uint8_t)((param1 >> 16) & 0x7F),
+                        midi_stamp_no_later(stamp, now));
+}
+
+bool midi_shim_start(void) {
+    if (g_shim_running) {
+        return true;
+    }
+
+    UINT sources = midiInGetNumDevs();
+    g_sources_connected = 0;
+    for (UINT i = 0; i < sources && g_sources_connected < MIDI_SHIM_MAX_INPUTS; ++i) {
+        int slot = g_sources_connected;
+        HMIDIIN handle = NULL;
+        if (midiInOpen(&handle, i, (DWORD_PTR)midi_in_proc, (DWORD_PTR)slot, CALLBACK_FUNCTION) !=
+            MMSYSERR_NOERROR) {
+            continue;
+        }
+        g_midi_inputs[slot] = handle;
+        g_midi_start_ns[slot] = rt_stats_now_ns();
+        if (midiInStart(handle) != MMSYSERR_NOERROR) {
+            midiInClose(handle);
+            g_midi_inputs[slot] = NULL;
+            continue;
+        }
+        g_sources_connected++;
+    }
+
+    g_shim_running = true;
+    printf("🎛  MIDI shim online (WinMM, %d/%u sources connected).\n", g_sources_connected, sources);
+    return true;
+}
+
+void midi_shim_stop(void) {
+    if (!g_shim_running) {
+        return;
+    }
+
+    for (int i = 0; i < g_sources_connected; ++i) {
+        midiInStop(g_midi_inputs[i]);
+        midiInReset(g_midi_inputs[i]);
+        midiInClose(g_midi_inputs[i]);
+        g_midi_inputs[i] = NULL;
+    }
+    g_sources_connected = 0;
+    g_shim_running = false;
+    printf("⏹  MIDI shim stopped.\n");
+}
+
+void midi_shim_list_ports(void) {
+    UINT sources = midiInGetNumDevs();
+    printf("🎹 Detected MIDI sources (%u):\n", sources);
+    for (UINT i = 0; i < sources; ++i) {
+        MIDIINCAPSA caps;
+        if (midiInGetDevCapsA(i, &caps, sizeof(caps)) != MMSYSERR_NOERROR) {
+            continue;
+        }
+        printf("  • %s\n", caps.szPname[0] ? caps.szPname : "(unnamed port)");
+    }
+    if (sources == 0) {
+        printf("  (no sources found)\n");
+    }
+}
+
+#elif defined(MIDI_SHIM_ALSA)
+#include <alsa/asoundlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MIDI_SHIM_MAX_POLL_FDS 4
+
+static snd_seq_t* g_seq = NULL;
+static int g_seq_port = -1;
+static int g_seq_queue = -1;
+static uint64_t g_seq_start_ns = 0;   // Host time of the queue's zero
+static pthread_t g_seq_thread;
+static atomic_bool g_seq_quit;
+
+typedef void (*midi_seq_port_fn)(snd_seq_t* seq, const snd_seq_port_info_t* port, void* userdata);
+
+// Every other client's port that can be subscribed to for input
+static int midi_seq_for_each_source(snd_seq_t* seq, midi_seq_port_fn fn, void* userdata) {
+    snd_seq_client_info_t* client;
+    snd_seq_port_info_t* port;
+    snd_seq_client_info_alloca(&client);
+    snd_seq_port_info_alloca(&port);
+    const unsigned int wanted = SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ;
+    int found = 0;
+
+    snd_seq_client_info_set_client(client, -1);
+    while (snd_seq_query_next_client(seq, client) >= 0) {
+        int id = snd_seq_client_info_get_client(client);
+        if (id == SND_SEQ_CLIENT_SYSTEM || id == snd_seq_client_id(seq)) {
+            continue;
+        }
+        snd_seq_port_info_set_client(port, id);
+        snd_seq_port_info_set_port(port, -1);
+        while (snd_seq_query_next_port(seq, port) >= 0) {
+            unsigned int caps = snd_seq_port_info_get_capability(port);
+            if ((caps & wanted) != wanted || (caps & SND_SEQ_PORT_CAP_NO_EXPORT)) {
+                continue;
+            }
+            fn(seq, port, userdata);
+            found++;
+        }
+    }
+    return found;
+}
+
+// Subscribe with real-time stamps from our queue, taken by the kernel as
+// each event arrives
+static void midi_seq_connect(snd_seq_t* seq, const snd_seq_port_info_t* port, void* userdata) {
+    (void)userdata;
+    snd_seq_port_subscribe_t* subs;
+    snd_seq_port_subscribe_alloca(&subs);
+    snd_seq_addr_t sender = {
+        .client = (unsigned char)snd_seq_port_info_get_client(port),
+        .port = (unsigned char)snd_seq_port_info_get_port(port)
+    };
+    snd_seq_addr_t dest = {
+        .client = (unsigned char)snd_seq_client_id(seq),
+        .port = (unsigned char)g_seq_port
+    };
+    snd_seq_port_subscribe_set_sender(subs, &sender);
+    snd_seq_port_subscribe_set_dest(subs, &dest);
+    snd_seq_port_subscribe_set_queue(subs, g_seq_queue);
+    snd_seq_port_subscribe_set_time_update(subs, 1);
+    snd_seq_port_subscribe_set_time_real(subs, 1);
+    if (snd_seq_subscribe_port(seq, subs) == 0) {
+        g_sources_connected++;
+    }
+}
+
+static void midi_seq_print(snd_seq_t* seq, const snd_seq_port_info_t* port, void* userdata) {
+    (void)seq;
+    (void)userdata;
+    const char* name = snd_seq_port_info_get_name(port);
+    printf("  • %s (%d:%d)\n", name && name[0] ? name : "(unnamed port)",
+           snd_seq_port_info_get_client(port), snd_seq_port_info_get_port(port));
+}
+
+static void midi_seq_handle_event(const snd_seq_event_t* ev) {
+    uint64_t now = rt_stats_now_ns();
+    uint64_t stamp = now;
+    if (snd_seq_ev_is_real(ev)) {
+        uint64_t since_start = (uint64_t)ev->time.time.tv_sec * 1000000000ull + ev->time.time.tv_nsec;
+        stamp = midi_stamp_no_later(g_seq_start_ns + since_start, now);
+    }
+
+    switch (ev->type) {
+        case SND_SEQ_EVENT_NOTEON:
+            midi_handle_message(0x90 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, stamp);
+            break;
+        case SND_SEQ_EVENT_NOTEOFF:
+            midi_handle_message(0x80 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, stamp);
+            break;
+        case SND_SEQ_EVENT_KEYPRESS:
+            midi_handle_message(0xA0 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, stamp);
+            break;
+        case SND_SEQ_EVENT_CONTROLLER:
+            midi_handle_message(0xB0 | ev->data.control.channel, (uint8_t)(ev->data.control.param & 0x7F),
+                                (uint8_t)(ev->data.control.value & 0x7F), stamp);
+            break;
+        case SND_SEQ_EVENT_PGMCHANGE:
+            midi_handle_message(0xC0 | ev->data.control.channel, (uint8_t)(ev->data.control.value & 0x7F), 0,
+                                stamp);
+            break;
+        case SND_SEQ_EVENT_CHANPRESS:
+            midi_handle_message(0xD0 | ev->data.control.channel, (uint8_t)(ev->data.control.value & 0x7F), 0,
+                                stamp);
+            break;
+        case SND_SEQ_EVENT_PITCHBEND: {
+            unsigned int value = (unsigned int)(ev->data.control.value + 8192) & 0x3FFF;
+            midi_handle_message(0xE0 | ev->data.control.channel, (uint8_t)(value & 0x7F), (uint8_t)(value >> 7),
+                                stamp);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Reader thread: wakes on input, exits within 100 ms of midi_shim_stop()
+static void* midi_seq_thread(void* arg) {
+    (void)arg;
+    struct pollfd fds[MIDI_SHIM_MAX_POLL_FDS];
+    int count = snd_seq_poll_descriptors(g_seq, fds, MIDI_SHIM_MAX_POLL_FDS, POLLIN);
+    while (!atomic_load_explicit(&g_seq_quit, memory_order_acquire)) {
+        if (poll(fds, (nfds_t)count, 100) <= 0) {
+            continue;
+        }
+        snd_seq_event_t* ev = NULL;
+        int result;
+        while ((result = snd_seq_event_input(g_seq, &ev)) >= 0 || result == -ENOSPC) {
+            if (result >= 0 && ev) {
+                midi_seq_handle_event(ev);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void midi_seq_close(void) {
+    snd_seq_close(g_seq);
+    g_seq = NULL;
+    g_seq_port = -1;
+    g_seq_queue = -1;
+}
+
+bool midi_shim_start(void) {
+    if (g_shim_running) {
+        return true;
+    }
+
+    if (snd_seq_open(&g_seq, "default", SND_SEQ_OPEN_INPUT, SND_SEQ_NONBLOCK) < 0) {
+        fprintf(stderr, "❌ Unable to open the ALSA sequencer.\n");
+        g_seq = NULL;
+        return false;
+    }
+    snd_seq_set_client_name(g_seq, "Synth MIDI");
+    g_seq_port = snd_seq_create_simple_port(g_seq, "Input",
+                                            SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE,
+                                            SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+    g_seq_queue = snd_seq_alloc_queue(g_seq);
+    if (g_seq_port < 0 || g_seq_queue < 0) {
+        fprintf(stderr, "❌ Unable to create MIDI input port.\n");
+        midi_seq_close();
+        return false;
+    }
+    snd_seq_start_queue(g_seq, g_seq_queue, NULL);
+    snd_seq_drain_output(g_seq);
+    g_seq_start_ns = rt_stats_now_ns();
+
+    g_sources_connected = 0;
+    int sources = midi_seq_for_each_source(g_seq, midi_seq_connect, NULL);
+
+    atomic_store_explicit(&g_seq_quit, false, memory_order_relaxed);
+    if (pthread_create(&g_seq_thread, NULL, midi_seq_thread, NULL) != 0) {
+        fprintf(stderr, "❌ Unable to start the MIDI reader thread.\n");
+        midi_seq_close();
+        return false;
+    }
+
+    g_shim_running = true;
+    printf("🎛  MIDI shim online (ALSA, %d/%d sources connected).\n", g_sources_connected, sources);
+    return true;
+}
+
+void midi_shim_stop(void) {
+    if (!g_shim_running) {
+        return;
+    }
+
+    atomic_store_explicit(&g_seq_quit, true, memory_order_release);
+    pthread_join(g_seq_thread, NULL);
+    midi_seq_close();
+    g_sources_connected = 0;
+    g_shim_running = false;
+    printf("⏹  MIDI shim stopped.\n");
+}
+
+void midi_shim_list_ports(void) {
+    snd_seq_t* seq = g_seq;
+    if (!seq && snd_seq_open(&seq, "default", SND_SEQ_OPEN_INPUT, SND_SEQ_NONBLOCK) < 0) {
+        printf("ℹ️ ALSA sequencer unavailable; no MIDI sources to list.\n");
+        return;
+    }
+    printf("🎹 Detected MIDI sources:\n");
+    if (midi_seq_for_each_source(seq, midi_seq_print, NULL) == 0) {
+        printf("  (no sources found)\n");
+    }
+    if (seq != g_seq) {
+        snd_seq_close(seq);
+    }
+}
+
+#else // no backend
 
 bool midi_shim_start(void) {
     fprintf(stderr, "⚠️ MIDI shim unavailable on this platform build.\n");
@@ -230,4 +570,4 @@ void midi_shim_list_ports(void) {
     printf("ℹ️ MIDI shim list not supported on this platform.\n");
 }
 
-#endif // __APPLE__
+#endif
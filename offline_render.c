@@ -0,0 +1,534 @@
+#include "offline_render.h"
+#include "synth_core.h"
+#include "dsp_math.h"
+#include "miniaudio.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <stdatomic.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#else
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+void offline_render_options_init(OfflineRenderOptions* options) {
+    if (!options) {
+        return;
+    }
+    memset(options, 0, sizeof(*options));
+}
+
+void offline_render_preview_pattern(Pattern* pattern) {
+    if (!pattern) {
+        return;
+    }
+    static const int notes[8] = {48, 55, 60, 63, 67, 63, 60, 55};
+    memset(pattern, 0, sizeof(*pattern));
+    snprintf(pattern->name, sizeof(pattern->name), "Preview");
+    pattern->length = STEPS_PER_PATTERN;
+    pattern->swing = 0.5f;
+    for (int i = 0; i < STEPS_PER_PATTERN; i++) {
+        SequencerStep* step = &pattern->steps[i];
+        step->active = (i % 2) == 0;
+        step->note = step->active ? notes[i / 2] : -1;
+        step->velocity = 0.8f;
+        step->length = 2;
+    }
+}
+
+// ============================================================================
+// PRESET -> ENGINE
+// ============================================================================
+
+static void render_set_float(SynthEngine* synth, ParamId id, float value) {
+    ParamMsg msg = {0};
+    msg.id = (uint32_t)id;
+    msg.type = PARAM_FLOAT;
+    msg.value.f = value;
+    synth_engine_apply_param(synth, &msg);
+}
+
+static void render_set_int(SynthEngine* synth, ParamId id, int value) {
+    ParamMsg msg = {0};
+    msg.id = (uint32_t)id;
+    msg.type = PARAM_INT;
+    msg.value.i = value;
+    synth_engine_apply_param(synth, &msg);
+}
+
+void offline_render_apply_preset(SynthCore* r, const PresetData* preset) {
+    SynthEngine* synth = &r->synth;
+    render_set_float(synth, PARAM_MASTER_VOLUME, preset->master_volume);
+    render_set_float(synth, PARAM_TEMPO, r->tempo);
+    render_set_int(synth, PARAM_FILTER_MODE, preset->filter_mode);
+    render_set_float(synth, PARAM_FILTER_CUTOFF, preset->filter_cutoff);
+    render_set_float(synth, PARAM_FILTER_RESONANCE, preset->filter_resonance);
+    render_set_float(synth, PARAM_FILTER_ENV_AMOUNT, preset->filter_env_amount);
+    render_set_float(synth, PARAM_ENV_AMP_ATTACK, preset->env_attack);
+    render_set_float(synth, PARAM_ENV_AMP_DECAY, preset->env_decay);
+    render_set_float(synth, PARAM_ENV_AMP_SUSTAIN, preset->env_sustain);
+    render_set_float(synth, PARAM_ENV_AMP_RELEASE, preset->env_release);
+    synth_snap_params(synth); // The bounce starts on the patch, not a ramp to it
+
+    r->fx.distortion.enabled = preset->distortion.enabled;
+    r->fx.distortion.drive = preset->distortion.drive;
+    r->fx.distortion.mix = preset->distortion.mix;
+    r->fx.chorus.enabled = preset->chorus.enabled;
+    r->fx.chorus.rate = preset->chorus.rate;
+    r->fx.chorus.depth = preset->chorus.depth;
+    r->fx.chorus.mix = preset->chorus.mix;
+    r->fx.compressor.enabled = preset->compressor.enabled;
+    r->fx.compressor.threshold = preset->compressor.threshold;
+    r->fx.compressor.ratio = preset->compressor.ratio;
+    r->fx.delay.enabled = preset->delay.enabled;
+    r->fx.delay.time_ms = preset->delay.time * 1000.0f; // Presets store seconds
+    r->fx.delay.feedback = preset->delay.feedback;
+    r->fx.delay.mix = preset->delay.mix;
+    r->fx.reverb.enabled = preset->reverb.enabled;
+    r->fx.reverb.size = preset->reverb.size;
+    r->fx.reverb.damping = preset->reverb.damping;
+    r->fx.reverb.mix = preset->reverb.mix;
+
+    arp_set_enabled(&r->arp, preset->arp.enabled);
+    r->arp.rate = synth_param_clamp(PARAM_ARP_RATE, preset_arp_rate(preset));
+    int mode = preset->arp.mode;
+    if (mode >= ARP_UP && mode <= ARP_RANDOM) {
+        r->arp.mode = (ArpMode)mode;
+    }
+}
+
+// ============================================================================
+// RENDER
+// ============================================================================
+
+static double render_wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Create each missing directory along `path` (the file itself excluded)
+static void render_ensure_parent_dirs(const char* path) {
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    for (char* p = dir + 1; *p; ++p) {
+        if (*p != '/' && *p != '\\') {
+            continue;
+        }
+        char saved = *p;
+        *p = '\0';
+#if defined(_WIN32)
+        _mkdir(dir);
+#else
+        mkdir(dir, 0755);
+#endif
+        *p = saved;
+    }
+}
+
+// One write block through the live signal chain; returns its peak. Each
+// write block is one synth_core_process call, as a period is live.
+static float render_block(SynthCore* r, float* out, uint32_t frames) {
+    synth_core_process(r, NULL, out, frames);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < frames * 2; i++) {
+        float magnitude = fabsf(out[i]);
+        if (magnitude > peak) {
+            peak = magnitude;
+        }
+    }
+    return peak;
+}
+
+// Engine, FX, arp and sequencer set up from the project and options;
+// NULL on failure. Free with render_destroy().
+static SynthCore* render_create(const ProjectData* project, const OfflineRenderOptions* options,
+                                uint32_t sample_rate) {
+    int polyphony = options->polyphony > 0 ? options->polyphony : OFFLINE_RENDER_DEFAULT_POLYPHONY;
+    SynthCore* r = (SynthCore*)malloc(sizeof(SynthCore));
+    if (!r) {
+        return NULL;
+    }
+    if (!synth_core_init(r, (float)sample_rate, polyphony)) {
+        synth_core_free(r);
+        free(r);
+        return NULL;
+    }
+    if (options->seed) {
+        synth_core_set_seed(r, options->seed);
+    }
+    r->tempo = project->tempo > 0.0f ? project->tempo : project->preset.tempo;
+    offline_render_apply_preset(r, &project->preset);
+    if (options->configure) {
+        options->configure(&r->synth, &r->fx, options->configure_userdata);
+    }
+
+    if (options->pattern) {
+        r->sequencer.patterns[0] = *options->pattern;
+    } else {
+        offline_render_preview_pattern(&r->sequencer.patterns[0]);
+    }
+    sequencer_start(&r->sequencer, 0);
+    return r;
+}
+
+static void render_destroy(SynthCore* r) {
+    synth_core_free(r);
+    free(r);
+}
+
+bool offline_render_project(const ProjectData* project, const OfflineRenderOptions* options,
+                            OfflineRenderStats* stats) {
+    if (!project) {
+        return false;
+    }
+    OfflineRenderOptions defaults;
+    if (!options) {
+        offline_render_options_init(&defaults);
+        options = &defaults;
+    }
+
+    const char* path = options->output_path ? options->output_path : project->export_path;
+    float duration = options->duration_seconds > 0.0f ? options->duration_seconds
+                                                      : project->export_duration_seconds;
+    uint32_t sample_rate = options->sample_rate ? options->sample_rate : OFFLINE_RENDER_DEFAULT_RATE;
+    if (!path || !path[0] || duration <= 0.0f) {
+        fprintf(stderr, "❌ Offline render needs an export path and a positive duration\n");
+        return false;
+    }
+
+    SynthCore* r = render_create(project, options, sample_rate);
+    if (!r) {
+        return false;
+    }
+
+    render_ensure_parent_dirs(path);
+    ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 2, sample_rate);
+    ma_encoder encoder;
+    ma_result result = ma_encoder_init_file(path, &config, &encoder);
+    if (result != MA_SUCCESS) {
+        fprintf(stderr, "❌ Failed to open bounce '%s' (error %d)\n", path, result);
+        render_destroy(r);
+        return false;
+    }
+
+    float* block = (float*)malloc(sizeof(float) * OFFLINE_RENDER_WRITE_FRAMES * 2);
+    if (!block) {
+        ma_encoder_uninit(&encoder);
+        render_destroy(r);
+        return false;
+    }
+
+    uint64_t total = (uint64_t)((double)duration * sample_rate + 0.5);
+    uint64_t done = 0;
+    float peak = 0.0f;
+    bool ok = true;
+    double started = render_wall_seconds();
+    while (done < total) {
+        uint32_t frames = (uint32_t)(total - done < OFFLINE_RENDER_WRITE_FRAMES
+                                         ? total - done : OFFLINE_RENDER_WRITE_FRAMES);
+        float block_peak = render_block(r, block, frames);
+        if (block_peak > peak) {
+            peak = block_peak;
+        }
+        ma_uint64 written = 0;
+        if (ma_encoder_write_pcm_frames(&encoder, block, frames, &written) != MA_SUCCESS || written != frames) {
+            fprintf(stderr, "❌ Failed writing bounce '%s'\n", path);
+            ok = false;
+            break;
+        }
+        done += frames;
+    }
+    double elapsed = render_wall_seconds() - started;
+
+    ma_encoder_uninit(&encoder);
+    free(block);
+    render_destroy(r);
+
+    if (stats) {
+        stats->frames = done;
+        stats->peak = peak;
+        stats->render_seconds = elapsed;
+    }
+    return ok;
+}
+
+bool offline_render_to_buffer(const ProjectData* project, const OfflineRenderOptions* options,
+                              float* out, uint64_t frames, OfflineRenderStats* stats) {
+    if (!project || !out) {
+        return false;
+    }
+    OfflineRenderOptions defaults;
+    if (!options) {
+        offline_render_options_init(&defaults);
+        options = &defaults;
+    }
+    uint32_t sample_rate = options->sample_rate ? options->sample_rate : OFFLINE_RENDER_DEFAULT_RATE;
+    SynthCore* r = render_create(project, options, sample_rate);
+    if (!r) {
+        return false;
+    }
+
+    // Same write-block size as the file path, so both split blocks alike
+    uint64_t done = 0;
+    float peak = 0.0f;
+    double started = render_wall_seconds();
+    while (done < frames) {
+        uint32_t count = (uint32_t)(frames - done < OFFLINE_RENDER_WRITE_FRAMES
+                                        ? frames - done : OFFLINE_RENDER_WRITE_FRAMES);
+        float block_peak = render_block(r, out + done * 2, count);
+        if (block_peak > peak) {
+            peak = block_peak;
+        }
+        done += count;
+    }
+    double elapsed = render_wall_seconds() - started;
+    render_destroy(r);
+
+    if (stats) {
+        stats->frames = done;
+        stats->peak = peak;
+        stats->render_seconds = elapsed;
+    }
+    return true;
+}
+
+// ============================================================================
+// BATCH
+// ============================================================================
+
+bool offline_render_load(ProjectData* project, const char* path) {
+    if (!project || !path) {
+        return false;
+    }
+    project_init(project);
+    if (project_load_file(project, path)) {
+        return true;
+    }
+    project_init(project);
+    if (!preset_load_file(&project->preset, path)) {
+        return false;
+    }
+    project->tempo = project->preset.tempo;
+    return true;
+}
+
+void offline_render_job_init(OfflineRenderJob* job, const char* input_path, const char* output_dir) {
+    if (!job) {
+        return;
+    }
+    memset(job, 0, sizeof(*job));
+    job->input_path = input_path;
+    if (!input_path) {
+        return;
+    }
+    const char* name = input_path;
+    for (const char* p = input_path; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
+        }
+    }
+    size_t stem = strlen(name);
+    const char* dot = strrchr(name, '.');
+    if (dot && dot != name) {
+        stem = (size_t)(dot - name);
+    }
+    snprintf(job->output_path, sizeof(job->output_path), "%s/%.*s.wav",
+             output_dir && output_dir[0] ? output_dir : ".", (int)stem, name);
+}
+
+// Case-insensitive, since macOS and Windows volumes usually are
+static bool output_paths_equal(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+            return false;
+        }
+    }
+    return *a == *b;
+}
+
+static bool output_path_taken(const OfflineRenderJob* jobs, int count, const char* path) {
+    for (int i = 0; i < count; ++i) {
+        if (output_paths_equal(jobs[i].output_path, path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Give jobs[index] an output path no earlier job uses: <stem>-2.wav, -3, ...
+static void batch_unique_output_path(OfflineRenderJob* jobs, int index) {
+    char* path = jobs[index].output_path;
+    if (!path[0] || !output_path_taken(jobs, index, path)) {
+        return;
+    }
+    const char* name = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
+        }
+    }
+    const char* dot = strrchr(name, '.');
+    size_t stem = dot && dot != name ? (size_t)(dot - path) : strlen(path);
+    char base[sizeof(jobs[index].output_path)];
+    snprintf(base, sizeof(base), "%s", path);
+    char candidate[sizeof(jobs[index].output_path)];
+    for (int n = 2; n <= index + 1; ++n) {
+        snprintf(candidate, sizeof(candidate), "%.*s-%d%s", (int)stem, base, n, base + stem);
+        if (!output_path_taken(jobs, index, candidate)) {
+            break;
+        }
+    }
+    fprintf(stderr, "⚠️ '%s' would overwrite another job's output, writing '%s'\n",
+            jobs[index].input_path ? jobs[index].input_path : "(null)", candidate);
+    snprintf(path, sizeof(jobs[index].output_path), "%s", candidate);
+}
+
+int offline_render_default_threads(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cores = (int)info.dwNumberOfProcessors;
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1) {
+        cores = 1;
+    }
+    return cores < OFFLINE_RENDER_MAX_THREADS ? cores : OFFLINE_RENDER_MAX_THREADS;
+}
+
+typedef struct {
+    OfflineRenderJob* jobs;
+    const ProjectData* projects;
+    const bool* loaded;
+    int count;
+    const OfflineRenderOptions* options;
+    atomic_int next_job;
+} BatchQueue;
+
+// Workers share nothing but the job counter: each render owns its engine
+#if defined(_WIN32)
+static DWORD WINAPI batch_worker_main(LPVOID arg) {
+#else
+static void* batch_worker_main(void* arg) {
+#endif
+    BatchQueue* queue = (BatchQueue*)arg;
+    while (1) {
+        int index = atomic_fetch_add(&queue->next_job, 1);
+        if (index >= queue->count) {
+            break;
+        }
+        OfflineRenderJob* job = &queue->jobs[index];
+        if (!queue->loaded[index]) {
+            continue;
+        }
+        OfflineRenderOptions options = *queue->options;
+        options.output_path = job->output_path;
+        job->ok = offline_render_project(&queue->projects[index], &options, &job->stats);
+    }
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+int offline_render_batch(OfflineRenderJob* jobs, int count, const OfflineRenderOptions* options, int threads) {
+    if (!jobs || count <= 0) {
+        return 0;
+    }
+    OfflineRenderOptions defaults;
+    if (!options) {
+        offline_render_options_init(&defaults);
+        options = &defaults;
+    }
+
+    // Files are parsed here, one after another, so workers only render and
+    // never wait on the parse lock (see preset_json_parse)
+    ProjectData* projects = (ProjectData*)calloc((size_t)count, sizeof(ProjectData));
+    bool* loaded = (bool*)calloc((size_t)count, sizeof(bool));
+    if (!projects || !loaded) {
+        free(projects);
+        free(loaded);
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        jobs[i].ok = false;
+        memset(&jobs[i].stats, 0, sizeof(jobs[i].stats));
+        batch_unique_output_path(jobs, i);
+        loaded[i] = offline_render_load(&projects[i], jobs[i].input_path);
+        if (!loaded[i]) {
+            fprintf(stderr, "❌ Failed to load '%s'\n", jobs[i].input_path ? jobs[i].input_path : "(null)");
+        }
+    }
+
+    // Shared tables are filled once up front so workers only read them
+    dsp_math_init();
+
+    if (threads <= 0) {
+        threads = offline_render_default_threads();
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads > OFFLINE_RENDER_MAX_THREADS) {
+        threads = OFFLINE_RENDER_MAX_THREADS;
+    }
+
+    BatchQueue queue;
+    queue.jobs = jobs;
+    queue.projects = projects;
+    queue.loaded = loaded;
+    queue.count = count;
+    queue.options = options;
+    atomic_init(&queue.next_job, 0);
+
+#if defined(_WIN32)
+    HANDLE workers[OFFLINE_RENDER_MAX_THREADS];
+#else
+    pthread_t workers[OFFLINE_RENDER_MAX_THREADS];
+#endif
+    int started = 0;
+    for (int i = 1; i < threads; ++i) {
+#if defined(_WIN32)
+        workers[started] = CreateThread(NULL, 0, batch_worker_main, &queue, 0, NULL);
+        if (!workers[started]) {
+            break;
+        }
+#else
+        if (pthread_create(&workers[started], NULL, batch_worker_main, &queue) != 0) {
+            break;
+        }
+#endif
+        started++;
+    }
+    batch_worker_main(&queue); // The calling thread works too
+    for (int i = 0; i < started; ++i) {
+#if defined(_WIN32)
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+#else
+        pthread_join(workers[i], NULL);
+#endif
+    }
+
+    int succeeded = 0;
+    for (int i = 0; i < count; ++i) {
+        succeeded += jobs[i].ok ? 1 : 0;
+    }
+    free(projects);
+    free(loaded);
+    return succeeded;
+}
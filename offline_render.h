@@ -0,0 +1,102 @@
+#ifndef OFFLINE_RENDER_H
+#define OFFLINE_RENDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fx_rack.h"
+#include "project.h"
+#include "sequencer.h"
+#include "synth_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Offline bounce.
+ *
+ * Renders a project headlessly, as fast as the CPU allows: the preset is
+ * applied to a private SynthCore, the same signal chain the live audio
+ * callback runs. Output streams to a 32-bit float stereo WAV through
+ * ma_encoder, so the length is not bounded by memory. No GLFW and no
+ * audio device are involved; the caller's translation unit provides the
+ * miniaudio implementation.
+ */
+
+#define OFFLINE_RENDER_DEFAULT_RATE 44100
+#define OFFLINE_RENDER_DEFAULT_POLYPHONY 32
+#define OFFLINE_RENDER_WRITE_FRAMES 4096
+
+// Runs once the preset is applied, before the first block: for settings a
+// preset does not store (oscillator waveforms and the like)
+typedef void (*offline_render_configure_fn)(SynthEngine* synth, EffectsRack* fx, void* userdata);
+
+typedef struct {
+    const char* output_path;   // NULL = project->export_path
+    float duration_seconds;    // <= 0 = project->export_duration_seconds
+    uint32_t sample_rate;      // 0 = OFFLINE_RENDER_DEFAULT_RATE
+    int polyphony;             // 0 = OFFLINE_RENDER_DEFAULT_POLYPHONY
+    const Pattern* pattern;    // NULL = offline_render_preview_pattern
+    uint32_t seed;             // Engine and arp seed; 0 = SYNTH_DEFAULT_SEED
+    offline_render_configure_fn configure;  // Optional
+    void* configure_userdata;
+} OfflineRenderOptions;
+
+typedef struct {
+    uint64_t frames;
+    float peak;
+    double render_seconds;     // Wall-clock time spent rendering
+} OfflineRenderStats;
+
+void offline_render_options_init(OfflineRenderOptions* options);
+
+// A one-bar phrase for auditioning presets that carry no notes of their own
+void offline_render_preview_pattern(Pattern* pattern);
+
+// Apply a preset to a core the way a bounce does: engine params, FX and arp
+void offline_render_apply_preset(SynthCore* core, const PresetData* preset);
+
+// Render `project` to a WAV file; `stats` may be NULL
+bool offline_render_project(const ProjectData* project, const OfflineRenderOptions* options,
+                            OfflineRenderStats* stats);
+// Render `frames` interleaved stereo frames of `project` into `out`, exactly
+// as offline_render_project would write them; output_path and
+// duration_seconds are ignored
+bool offline_render_to_buffer(const ProjectData* project, const OfflineRenderOptions* options,
+                              float* out, uint64_t frames, OfflineRenderStats* stats);
+
+// ============================================================================
+// BATCH
+// ============================================================================
+
+#define OFFLINE_RENDER_MAX_THREADS 64
+
+typedef struct {
+    const char* input_path;    // Project or bare preset JSON
+    char output_path[512];
+    bool ok;
+    OfflineRenderStats stats;
+} OfflineRenderJob;
+
+// Load a project file, or a bare preset into project defaults
+bool offline_render_load(ProjectData* project, const char* path);
+
+// Fill each job's output_path as <output_dir>/<input name>.wav
+void offline_render_job_init(OfflineRenderJob* job, const char* input_path, const char* output_dir);
+
+int offline_render_default_threads(void);
+
+// Render every job, one engine + FX instance per job, across `threads`
+// workers (0 = one per core). Inputs are parsed on the calling thread first.
+// `options` supplies length/rate/pattern; its output_path is ignored. A job
+// whose output_path an earlier job already uses gets -2, -3, ... before the
+// extension, so no two jobs write the same file.
+// Returns the number of jobs rendered successfully.
+int offline_render_batch(OfflineRenderJob* jobs, int count, const OfflineRenderOptions* options, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OFFLINE_RENDER_H
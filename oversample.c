@@ -0,0 +1,181 @@
+#include "oversample.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Base <-> 2x carries the audio band right up to the transition, so it gets
+// the long filter; at 2x <-> 4x everything above the base Nyquist is
+// already headroom and a short one does.
+#define OVERSAMPLE_PAIRS_2X 12
+#define OVERSAMPLE_PAIRS_4X 6
+#define OVERSAMPLE_KAISER_BETA 8.0   // ~80 dB stopband
+
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x * 0.5 / k) * (x * 0.5 / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Ideal half-band (0.5 sinc(n / 2)) under a Kaiser window; only the odd
+// distances from the center are nonzero. Scaled to unity gain at DC.
+static void halfband_design(HalfbandDesign* design, int pairs) {
+    const double half_length = 2.0 * pairs;
+    double sum = 0.0;
+    double taps[OVERSAMPLE_MAX_PAIRS];
+    for (int j = 0; j < pairs; j++) {
+        double d = 2.0 * j + 1.0;
+        double ideal = sin(M_PI * d * 0.5) / (M_PI * d);
+        double r = d / half_length;
+        double window = bessel_i0(OVERSAMPLE_KAISER_BETA * sqrt(1.0 - r * r)) / bessel_i0(OVERSAMPLE_KAISER_BETA);
+        taps[j] = ideal * window;
+        sum += taps[j];
+    }
+    design->pairs = pairs;
+    for (int j = 0; j < pairs; j++) {
+        design->coeffs[j] = (float)(taps[j] * 0.25 / sum); // Side taps sum to 0.5, center is 0.5
+    }
+}
+
+void oversampler_init(Oversampler* os) {
+    memset(os, 0, sizeof(*os));
+    halfband_design(&os->design[0], OVERSAMPLE_PAIRS_2X);
+    halfband_design(&os->design[1], OVERSAMPLE_PAIRS_4X);
+    os->mode = OVERSAMPLE_OFF;
+}
+
+void oversampler_reset(Oversampler* os) {
+    memset(os->up, 0, sizeof(os->up));
+    memset(os->down, 0, sizeof(os->down));
+}
+
+void oversampler_set_mode(Oversampler* os, OversampleMode mode) {
+    if ((int)mode < 0 || mode >= OVERSAMPLE_MODE_COUNT) {
+        mode = OVERSAMPLE_OFF;
+    }
+    os->mode = mode;
+    oversampler_reset(os);
+}
+
+int oversample_ratio(OversampleMode mode) {
+    switch (mode) {
+        case OVERSAMPLE_2X: return 2;
+        case OVERSAMPLE_4X: return 4;
+        default: return 1;
+    }
+}
+
+const char* oversample_mode_name(OversampleMode mode) {
+    switch (mode) {
+        case OVERSAMPLE_2X: return "2x";
+        case OVERSAMPLE_4X: return "4x";
+        default: return "Off";
+    }
+}
+
+float oversampler_latency(const Oversampler* os) {
+    // Each half-band delays by 2 * pairs - 1 samples at its own rate, once
+    // up and once down
+    float latency = 0.0f;
+    if (os->mode >= OVERSAMPLE_2X) {
+        latency += (float)(2 * os->design[0].pairs - 1);
+    }
+    if (os->mode >= OVERSAMPLE_4X) {
+        latency += (float)(2 * os->design[1].pairs - 1) * 0.5f;
+    }
+    return latency;
+}
+
+// Push `x` into a delay line stored twice over; returns the newest `length`
+// samples, oldest first
+static inline const float* line_push(float* line, int* pos, int length, float x) {
+    line[*pos] = x;
+    line[*pos + length] = x;
+    *pos = *pos + 1 == length ? 0 : *pos + 1;
+    return line + *pos;
+}
+
+// The symmetric phase over a 2 * pairs window, oldest first
+static inline float halfband_fir(const HalfbandDesign* design, const float* window) {
+    const int pairs = design->pairs;
+    float acc = 0.0f;
+    for (int j = 0; j < pairs; j++) {
+        acc += design->coeffs[j] * (window[pairs + j] + window[pairs - 1 - j]);
+    }
+    return acc;
+}
+
+// Zero-stuff and filter: the filter phase lands on even outputs, the
+// center tap (a pure delay) on odd ones
+static void halfband_up(const HalfbandDesign* design, HalfbandState* state,
+                        const float* in, float* out, int frames) {
+    const int pairs = design->pairs;
+    for (int n = 0; n < frames; n++) {
+        const float* window = line_push(state->even, &state->even_pos, 2 * pairs, in[n]);
+        out[2 * n] = 2.0f * halfband_fir(design, window);
+        out[2 * n + 1] = window[pairs];
+    }
+}
+
+// Filter and keep every other output: even inputs meet the symmetric
+// phase, odd ones only the center tap
+static void halfband_down(const HalfbandDesign* design, HalfbandState* state,
+                          const float* in, float* out, int frames) {
+    const int pairs = design->pairs;
+    for (int n = 0; n < frames; n++) {
+        const float* even = line_push(state->even, &state->even_pos, 2 * pairs, in[2 * n]);
+        const float* odd = line_push(state->odd, &state->odd_pos, pairs + 1, in[2 * n + 1]);
+        out[n] = halfband_fir(design, even) + 0.5f * odd[0];
+    }
+}
+
+int oversampler_upsample(Oversampler* os, const float* left, const float* right, int frames) {
+    if (frames > OVERSAMPLE_MAX_BLOCK) {
+        frames = OVERSAMPLE_MAX_BLOCK;
+    }
+    switch (os->mode) {
+        case OVERSAMPLE_2X:
+            halfband_up(&os->design[0], &os->up[0][0], left, os->left, frames);
+            halfband_up(&os->design[0], &os->up[0][1], right, os->right, frames);
+            return frames * 2;
+        case OVERSAMPLE_4X:
+            halfband_up(&os->design[0], &os->up[0][0], left, os->step_l, frames);
+            halfband_up(&os->design[0], &os->up[0][1], right, os->step_r, frames);
+            halfband_up(&os->design[1], &os->up[1][0], os->step_l, os->left, frames * 2);
+            halfband_up(&os->design[1], &os->up[1][1], os->step_r, os->right, frames * 2);
+            return frames * 4;
+        default:
+            memcpy(os->left, left, sizeof(float) * (size_t)frames);
+            memcpy(os->right, right, sizeof(float) * (size_t)frames);
+            return frames;
+    }
+}
+
+void oversampler_downsample(Oversampler* os, float* left, float* right, int frames) {
+    if (frames > OVERSAMPLE_MAX_BLOCK) {
+        frames = OVERSAMPLE_MAX_BLOCK;
+    }
+    switch (os->mode) {
+        case OVERSAMPLE_2X:
+            halfband_down(&os->design[0], &os->down[0][0], os->left, left, frames);
+            halfband_down(&os->design[0], &os->down[0][1], os->right, right, frames);
+            break;
+        case OVERSAMPLE_4X:
+            halfband_down(&os->design[1], &os->down[1][0], os->left, os->step_l, frames * 2);
+            halfband_down(&os->design[1], &os->down[1][1], os->right, os->step_r, frames * 2);
+            halfband_down(&os->design[0], &os->down[0][0], os->step_l, left, frames);
+            halfband_down(&os->design[0], &os->down[0][1], os->step_r, right, frames);
+            break;
+        default:
+            memcpy(left, os->left, sizeof(float) * (size_t)frames);
+            memcpy(right, os->right, sizeof(float) * (size_t)frames);
+            break;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef OVERSAMPLE_H
+#define OVERSAMPLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Per-stage oversampling for nonlinear processors.
+ *
+ * A stage that aliases (waveshaper, clipper) wraps just its own loop:
+ * upsample the block, run the nonlinearity over os->left/os->right at the
+ * higher rate, downsample back in place. The rest of the chain stays at
+ * the base rate.
+ *
+ * Each 2x step is a linear-phase half-band FIR in polyphase form: every
+ * other tap is zero, so one phase is a pure delay and the other a
+ * symmetric filter costing `pairs` multiplies per base-rate sample. 4x
+ * cascades a second, shorter half-band at 2x, where the transition band
+ * is wide. Coefficients are Kaiser-windowed sinc, designed at init.
+ */
+
+#define OVERSAMPLE_MAX_BLOCK 256      // Base-rate frames per up/down call
+#define OVERSAMPLE_MAX_RATIO 4
+#define OVERSAMPLE_MAX_PAIRS 12       // Nonzero tap pairs per half-band
+
+typedef enum {
+    OVERSAMPLE_OFF = 0,
+    OVERSAMPLE_2X,
+    OVERSAMPLE_4X,
+    OVERSAMPLE_MODE_COUNT
+} OversampleMode;
+
+typedef struct {
+    int pairs;
+    float coeffs[OVERSAMPLE_MAX_PAIRS];   // Tap at center +-(2j+1), j = 0..pairs-1
+} HalfbandDesign;
+
+// One channel of one 2x step. Delay lines are stored twice over, so the
+// newest window is always contiguous.
+typedef struct {
+    float even[4 * OVERSAMPLE_MAX_PAIRS];       // Last 2 * pairs inputs (even phase)
+    int even_pos;
+    float odd[2 * (OVERSAMPLE_MAX_PAIRS + 1)];  // Last pairs + 1 odd-phase inputs (decimator)
+    int odd_pos;
+} HalfbandState;
+
+typedef struct {
+    OversampleMode mode;
+    HalfbandDesign design[2];      // [0] base <-> 2x, [1] 2x <-> 4x
+    HalfbandState up[2][2];        // [step][channel]
+    HalfbandState down[2][2];
+
+    // Oversampled planar block for the caller's nonlinearity
+    float left[OVERSAMPLE_MAX_BLOCK * OVERSAMPLE_MAX_RATIO];
+    float right[OVERSAMPLE_MAX_BLOCK * OVERSAMPLE_MAX_RATIO];
+    float step_l[OVERSAMPLE_MAX_BLOCK * 2];   // 4x: the intermediate 2x signal
+    float step_r[OVERSAMPLE_MAX_BLOCK * 2];
+} Oversampler;
+
+// Designs the filters and starts at OVERSAMPLE_OFF. Not realtime-safe.
+void oversampler_init(Oversampler* os);
+// Switch mode and clear the filter history; realtime-safe
+void oversampler_set_mode(Oversampler* os, OversampleMode mode);
+void oversampler_reset(Oversampler* os);
+
+int oversample_ratio(OversampleMode mode);
+const char* oversample_mode_name(OversampleMode mode);
+// Delay an up/down round trip adds, in base-rate frames
+float oversampler_latency(const Oversampler* os);
+
+// Upsample `frames` (<= OVERSAMPLE_MAX_BLOCK) into os->left/os->right;
+// returns frames * ratio. OVERSAMPLE_OFF copies.
+int oversampler_upsample(Oversampler* os, const float* left, const float* right, int frames);
+// Downsample os->left/os->right back to `frames` base-rate frames
+void oversampler_downsample(Oversampler* os, float* left, float* right, int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OVERSAMPLE_H
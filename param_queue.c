@@ -1,5 +1,7 @@
 #include "param_queue.h"
 #include "synth_engine.h"
+#include "rt_log.h"
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -10,9 +12,35 @@ static ParamMsg g_param_buffer[PARAM_QUEUE_SIZE];
 static PaUtilRingBuffer g_midi_queue;
 static MidiEvent g_midi_buffer[MIDI_QUEUE_SIZE];
 
+static PaUtilRingBuffer g_midi_ui_queue;
+static MidiEvent g_midi_ui_buffer[MIDI_QUEUE_SIZE];
+
 static PaUtilRingBuffer g_seq_queue;
 static SeqEvent g_seq_buffer[SEQ_QUEUE_SIZE];
 
+// Coalescing slots: value bits in the low word, ParamType above them
+#define PARAM_DIRTY_WORDS ((PARAM_PARAM_COUNT + 63) / 64)
+static atomic_ullong g_param_slots[PARAM_PARAM_COUNT];
+static atomic_ullong g_param_dirty[PARAM_DIRTY_WORDS];
+
+// Events refused because their ring was full (any thread may read)
+static atomic_uint g_param_drops;
+static atomic_uint g_midi_drops;
+static atomic_uint g_seq_drops;
+
+// Copy the element at the read index without advancing it (consumer side only)
+static bool ring_peek(PaUtilRingBuffer* rb, void* out, size_t element_size) {
+    void* data1 = NULL;
+    void* data2 = NULL;
+    ring_buffer_size_t size1 = 0;
+    ring_buffer_size_t size2 = 0;
+    if (PaUtil_GetRingBufferReadRegions(rb, 1, &data1, &size1, &data2, &size2) < 1) {
+        return false;
+    }
+    memcpy(out, data1, element_size);
+    return true;
+}
+
 #ifdef PARAM_DEBUG
 #define PARAM_LOG(fmt, ...) printf("[PARAM] " fmt "\n", ##__VA_ARGS__)
 #else
@@ -26,9 +54,19 @@ void param_queue_init(void) {
     PaUtil_InitializeRingBuffer(&g_midi_queue, sizeof(MidiEvent),
                                 MIDI_QUEUE_SIZE, g_midi_buffer);
 
+    PaUtil_InitializeRingBuffer(&g_midi_ui_queue, sizeof(MidiEvent),
+                                MIDI_QUEUE_SIZE, g_midi_ui_buffer);
+
     PaUtil_InitializeRingBuffer(&g_seq_queue, sizeof(SeqEvent),
                                 SEQ_QUEUE_SIZE, g_seq_buffer);
 
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        atomic_store_explicit(&g_param_slots[i], 0, memory_order_relaxed);
+    }
+    for (int w = 0; w < PARAM_DIRTY_WORDS; w++) {
+        atomic_store_explicit(&g_param_dirty[w], 0, memory_order_relaxed);
+    }
+
     printf("✅ Parameter/MIDI/Seq queues initialized (lock-free)\n");
 }
 
@@ -38,7 +76,8 @@ bool param_queue_enqueue(const ParamMsg* msg) {
     }
     ring_buffer_size_t written = PaUtil_WriteRingBuffer(&g_param_queue, msg, 1);
     if (written == 0) {
-        printf("⚠️ Parameter queue full! Dropping change.\n");
+        atomic_fetch_add_explicit(&g_param_drops, 1u, memory_order_relaxed);
+        rt_log(RT_LOG_WARN, "⚠️ Parameter queue full! Dropping change.");
         return false;
     }
     PARAM_LOG("push param id=%u", msg->id);
@@ -64,22 +103,116 @@ void param_queue_drain(param_queue_handler handler, void* userdata) {
     }
 }
 
-bool midi_queue_enqueue(const MidiEvent* event) {
+bool param_queue_set(const ParamMsg* msg) {
+    if (!msg || msg->id >= PARAM_PARAM_COUNT) {
+        return false;
+    }
+    uint32_t bits = 0;
+    memcpy(&bits, &msg->value, sizeof(bits));
+    uint64_t packed = ((uint64_t)msg->type << 32) | bits;
+    atomic_store_explicit(&g_param_slots[msg->id], packed, memory_order_relaxed);
+    // Release: a consumer that sees the bit also sees the value
+    atomic_fetch_or_explicit(&g_param_dirty[msg->id / 64], 1ull << (msg->id % 64),
+                             memory_order_release);
+    PARAM_LOG("set param id=%u", msg->id);
+    return true;
+}
+
+bool param_queue_apply_latest(param_queue_handler handler, void* userdata) {
+    if (!handler) return false;
+    bool applied = false;
+    for (int w = 0; w < PARAM_DIRTY_WORDS; w++) {
+        if (atomic_load_explicit(&g_param_dirty[w], memory_order_relaxed) == 0) {
+            continue;
+        }
+        // A set that lands after the exchange re-marks its bit for next block
+        uint64_t dirty = atomic_exchange_explicit(&g_param_dirty[w], 0, memory_order_acquire);
+        for (int bit = 0; dirty != 0; bit++, dirty >>= 1) {
+            if ((dirty & 1ull) == 0) {
+                continue;
+            }
+            uint32_t id = (uint32_t)(w * 64 + bit);
+            uint64_t packed = atomic_load_explicit(&g_param_slots[id], memory_order_relaxed);
+            ParamMsg change;
+            memset(&change, 0, sizeof(change));
+            change.id = id;
+            change.type = (ParamType)(packed >> 32);
+            uint32_t bits = (uint32_t)packed;
+            memcpy(&change.value, &bits, sizeof(bits));
+            handler(&change, userdata);
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+bool param_queue_peek(ParamMsg* out_change) {
+    if (!out_change) {
+        return false;
+    }
+    return ring_peek(&g_param_queue, out_change, sizeof(ParamMsg));
+}
+
+void param_queue_drain_until(param_queue_handler handler, void* userdata, uint64_t frame_limit) {
+    if (!handler) return;
+    ParamMsg change;
+    while (param_queue_peek(&change)) {
+        if (change.sample_frame != 0 && change.sample_frame >= frame_limit) {
+            break;
+        }
+        PaUtil_AdvanceRingBufferReadIndex(&g_param_queue, 1);
+        handler(&change, userdata);
+    }
+}
+
+static bool midi_ring_enqueue(PaUtilRingBuffer* ring, const MidiEvent* event) {
     if (!event) {
         return false;
     }
-    if (PaUtil_WriteRingBuffer(&g_midi_queue, event, 1) == 0) {
-        printf("⚠️ MIDI queue full! Dropping event.\n");
+    if (PaUtil_WriteRingBuffer(ring, event, 1) == 0) {
+        atomic_fetch_add_explicit(&g_midi_drops, 1u, memory_order_relaxed);
+        rt_log(RT_LOG_WARN, "⚠️ MIDI queue full! Dropping event.");
         return false;
     }
     return true;
 }
 
-bool midi_queue_dequeue(MidiEvent* event) {
+static bool midi_ring_dequeue(PaUtilRingBuffer* ring, MidiEvent* event) {
+    if (!event) {
+        return false;
+    }
+    return PaUtil_ReadRingBuffer(ring, event, 1) == 1;
+}
+
+static bool midi_ring_peek(PaUtilRingBuffer* ring, MidiEvent* event) {
     if (!event) {
         return false;
     }
-    return PaUtil_ReadRingBuffer(&g_midi_queue, event, 1) == 1;
+    return ring_peek(ring, event, sizeof(MidiEvent));
+}
+
+bool midi_queue_enqueue(const MidiEvent* event) {
+    return midi_ring_enqueue(&g_midi_queue, event);
+}
+
+bool midi_queue_dequeue(MidiEvent* event) {
+    return midi_ring_dequeue(&g_midi_queue, event);
+}
+
+bool midi_queue_peek(MidiEvent* event) {
+    return midi_ring_peek(&g_midi_queue, event);
+}
+
+bool midi_ui_queue_enqueue(const MidiEvent* event) {
+    return midi_ring_enqueue(&g_midi_ui_queue, event);
+}
+
+bool midi_ui_queue_dequeue(MidiEvent* event) {
+    return midi_ring_dequeue(&g_midi_ui_queue, event);
+}
+
+bool midi_ui_queue_peek(MidiEvent* event) {
+    return midi_ring_peek(&g_midi_ui_queue, event);
 }
 
 bool seq_event_enqueue(const SeqEvent* event) {
@@ -87,7 +220,8 @@ bool seq_event_enqueue(const SeqEvent* event) {
         return false;
     }
     if (PaUtil_WriteRingBuffer(&g_seq_queue, event, 1) == 0) {
-        printf("⚠️ Sequencer queue full! Dropping event.\n");
+        atomic_fetch_add_explicit(&g_seq_drops, 1u, memory_order_relaxed);
+        rt_log(RT_LOG_WARN, "⚠️ Sequencer queue full! Dropping event.");
         return false;
     }
     return true;
@@ -99,3 +233,28 @@ bool seq_event_dequeue(SeqEvent* event) {
     }
     return PaUtil_ReadRingBuffer(&g_seq_queue, event, 1) == 1;
 }
+
+bool seq_event_peek(SeqEvent* event) {
+    if (!event) {
+        return false;
+    }
+    return ring_peek(&g_seq_queue, event, sizeof(SeqEvent));
+}
+
+void seq_event_drain_until(seq_event_handler handler, void* userdata, uint64_t frame_limit) {
+    if (!handler) return;
+    SeqEvent event;
+    while (seq_event_peek(&event)) {
+        if (event.sample_frame != 0 && event.sample_frame >= frame_limit) {
+            break;
+        }
+        PaUtil_AdvanceRingBufferReadIndex(&g_seq_queue, 1);
+        handler(&event, userdata);
+    }
+}
+
+void param_queue_drop_counts(uint32_t* param, uint32_t* midi, uint32_t* seq) {
+    if (param) *param = atomic_load_explicit(&g_param_drops, memory_order_relaxed);
+    if (midi) *midi = atomic_load_explicit(&g_midi_drops, memory_order_relaxed);
+    if (seq) *seq = atomic_load_explicit(&g_seq_drops, memory_order_relaxed);
+}
@@ -28,13 +28,48 @@ bool param_queue_dequeue(ParamMsg* out_change);
 typedef void (*param_queue_handler)(const ParamMsg* change, void* userdata);
 void param_queue_drain(param_queue_handler handler, void* userdata);
 
-// MIDI event queue helpers
+// Timestamped draining: events whose sample_frame is below frame_limit (or 0)
+// are handed to the handler in FIFO order; the first later event stops the
+// drain and stays queued. Producers must stamp each queue monotonically.
+void param_queue_drain_until(param_queue_handler handler, void* userdata, uint64_t frame_limit);
+
+// Copy the oldest pending change without removing it
+bool param_queue_peek(ParamMsg* out_change);
+
+// Coalescing transport for continuous parameters (knobs, sliders). Each
+// ParamId has one atomic value slot and a dirty bit; a newer value simply
+// replaces an older one that the audio thread has not applied yet, so a knob
+// dragged across many UI frames costs one apply per block. Discrete or
+// timestamped changes belong in the ring above, which keeps every message.
+// Any thread may set; returns false for an id outside ParamId.
+bool param_queue_set(const ParamMsg* msg);
+
+// Audio thread: hand the latest value of each changed parameter to the
+// handler once, in ParamId order (sample_frame is 0), and clear the bits
+bool param_queue_apply_latest(param_queue_handler handler, void* userdata);
+
+// MIDI event queue helpers: the ring the MIDI driver callbacks write
 bool midi_queue_enqueue(const MidiEvent* event);
 bool midi_queue_dequeue(MidiEvent* event);
+bool midi_queue_peek(MidiEvent* event);
+
+// A second MIDI ring, written only by the UI thread (QWERTY, mouse, test
+// tone), so the UI never contends with a driver thread for a write end
+bool midi_ui_queue_enqueue(const MidiEvent* event);
+bool midi_ui_queue_dequeue(MidiEvent* event);
+bool midi_ui_queue_peek(MidiEvent* event);
 
 // Sequencer event queue helpers
 bool seq_event_enqueue(const SeqEvent* event);
 bool seq_event_dequeue(SeqEvent* event);
+bool seq_event_peek(SeqEvent* event);
+
+// Same contract as param_queue_drain_until, for scheduled sequencer events
+typedef void (*seq_event_handler)(const SeqEvent* event, void* userdata);
+void seq_event_drain_until(seq_event_handler handler, void* userdata, uint64_t frame_limit);
+
+// Events each enqueue has refused (ring full) since startup; any thread
+void param_queue_drop_counts(uint32_t* param, uint32_t* midi, uint32_t* seq);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,120 @@
+/**
+ * Parameter Smoothing - control-rate ramps
+ */
+
+#include "param_smooth.h"
+#include "dsp_math.h"
+
+#include <string.h>
+
+#define PARAM_SMOOTH_SETTLE 1e-4f    // One-pole snaps once within this (relative)
+
+void param_smooth_init(ParamSmoothBank* bank, float sample_rate) {
+    memset(bank, 0, sizeof(ParamSmoothBank));
+    bank->sample_rate = sample_rate > 0.0f ? sample_rate : 44100.0f;
+    param_smooth_configure(bank, PARAM_MASTER_VOLUME, SMOOTH_LINEAR, 0.02f);
+    param_smooth_configure(bank, PARAM_FILTER_CUTOFF, SMOOTH_ONE_POLE, 0.015f);
+    param_smooth_configure(bank, PARAM_FILTER_RESONANCE, SMOOTH_LINEAR, 0.02f);
+    param_smooth_configure(bank, PARAM_FILTER_ENV_AMOUNT, SMOOTH_LINEAR, 0.02f);
+}
+
+void param_smooth_configure(ParamSmoothBank* bank, ParamId id, SmoothMode mode, float seconds) {
+    if (!bank || (int)id < 0 || id >= PARAM_SMOOTH_COUNT) {
+        return;
+    }
+    ParamSmoother* smoother = &bank->params[id];
+    smoother->mode = seconds > 0.0f ? mode : SMOOTH_NONE;
+    smoother->seconds = seconds;
+}
+
+bool param_smooth_is_smoothed(const ParamSmoothBank* bank, ParamId id) {
+    return bank && (int)id >= 0 && id < PARAM_SMOOTH_COUNT && bank->params[id].mode != SMOOTH_NONE;
+}
+
+static void param_smooth_stop(ParamSmoothBank* bank, ParamId id) {
+    ParamSmoother* smoother = &bank->params[id];
+    if (!smoother->moving) {
+        return;
+    }
+    smoother->moving = false;
+    for (int i = 0; i < bank->num_moving; i++) {
+        if (bank->moving[i] == id) {
+            bank->moving[i] = bank->moving[--bank->num_moving];
+            break;
+        }
+    }
+}
+
+void param_smooth_set_target(ParamSmoothBank* bank, ParamId id, float value) {
+    if (!param_smooth_is_smoothed(bank, id)) {
+        return;
+    }
+    ParamSmoother* smoother = &bank->params[id];
+    smoother->target = value;
+    if (smoother->current == value) {
+        param_smooth_stop(bank, id);
+        return;
+    }
+    if (smoother->mode == SMOOTH_LINEAR) {
+        smoother->remaining = smoother->seconds * bank->sample_rate;
+        smoother->step = (value - smoother->current) / smoother->remaining;
+    }
+    if (!smoother->moving) {
+        smoother->moving = true;
+        bank->moving[bank->num_moving++] = id;
+    }
+}
+
+void param_smooth_snap(ParamSmoothBank* bank, ParamId id, float value) {
+    if (!bank || (int)id < 0 || id >= PARAM_SMOOTH_COUNT) {
+        return;
+    }
+    ParamSmoother* smoother = &bank->params[id];
+    smoother->current = value;
+    smoother->target = value;
+    param_smooth_stop(bank, id);
+}
+
+void param_smooth_snap_all(ParamSmoothBank* bank) {
+    while (bank && bank->num_moving > 0) {
+        ParamId id = bank->moving[0];
+        param_smooth_snap(bank, id, bank->params[id].target);
+    }
+}
+
+void param_smooth_advance(ParamSmoothBank* bank, int num_frames,
+                          param_smooth_apply_fn apply, void* userdata) {
+    if (!bank || num_frames <= 0) {
+        return;
+    }
+    int i = 0;
+    while (i < bank->num_moving) {
+        ParamId id = bank->moving[i];
+        ParamSmoother* smoother = &bank->params[id];
+        bool arrived;
+        if (smoother->mode == SMOOTH_LINEAR) {
+            smoother->remaining -= (float)num_frames;
+            arrived = smoother->remaining <= 0.0f;
+            smoother->current += smoother->step * (float)num_frames;
+        } else {
+            // 1 - e^(-n / (tau * rate)), via exp2 (log2 e = 1.44269504)
+            float coeff = 1.0f - dsp_exp2f(-1.44269504f * (float)num_frames /
+                                           (smoother->seconds * bank->sample_rate));
+            smoother->current += (smoother->target - smoother->current) * coeff;
+            float delta = fabsf(smoother->target - smoother->current);
+            arrived = delta <= PARAM_SMOOTH_SETTLE * fmaxf(fabsf(smoother->target), 1.0f);
+        }
+        if (arrived) {
+            smoother->current = smoother->target;
+        }
+        if (apply) {
+            apply(id, smoother->current, userdata);
+        }
+        if (arrived) {
+            smoother->moving = false;
+            bank->moving[i] = bank->moving[--bank->num_moving]; // Revisit slot i
+        } else {
+            i++;
+        }
+    }
+}
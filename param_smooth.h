@@ -0,0 +1,68 @@
+/**
+ * Parameter Smoothing
+ *
+ * Control-rate ramps keyed on ParamId, so knob moves and automation glide
+ * instead of jumping (zipper noise). A parameter set to smooth gets either
+ * a linear ramp of fixed duration or a one-pole approach. Smoothers advance
+ * once per sub-block and hand back the end-of-block value; a consumer that
+ * needs sample accuracy interpolates from the value it applied last block.
+ *
+ * Only moving smoothers are visited, so a bank at rest costs nothing.
+ * Everything here is owned by the audio thread (the engine's bank is fed by
+ * synth_engine_apply_param).
+ */
+
+#ifndef PARAM_SMOOTH_H
+#define PARAM_SMOOTH_H
+
+#include <stdbool.h>
+#include "synth_types.h"
+
+#define PARAM_SMOOTH_COUNT PARAM_PARAM_COUNT
+
+typedef enum {
+    SMOOTH_NONE = 0,    // Apply immediately
+    SMOOTH_LINEAR,      // Reach the target in exactly `seconds`
+    SMOOTH_ONE_POLE     // Exponential approach, time constant `seconds`
+} SmoothMode;
+
+typedef struct {
+    SmoothMode mode;
+    float seconds;
+    float current;      // Value at the end of the last advanced block
+    float target;
+    float step;         // Linear: change per frame
+    float remaining;    // Linear: frames left
+    bool moving;
+} ParamSmoother;
+
+typedef struct {
+    ParamSmoother params[PARAM_SMOOTH_COUNT];
+    ParamId moving[PARAM_SMOOTH_COUNT];
+    int num_moving;
+    float sample_rate;
+} ParamSmoothBank;
+
+// Engine defaults: master volume, filter cutoff/resonance/env amount
+void param_smooth_init(ParamSmoothBank* bank, float sample_rate);
+void param_smooth_configure(ParamSmoothBank* bank, ParamId id, SmoothMode mode, float seconds);
+bool param_smooth_is_smoothed(const ParamSmoothBank* bank, ParamId id);
+
+// Start moving toward `value` (a new target restarts any ramp in flight)
+void param_smooth_set_target(ParamSmoothBank* bank, ParamId id, float value);
+// Jump straight to `value`
+void param_smooth_snap(ParamSmoothBank* bank, ParamId id, float value);
+void param_smooth_snap_all(ParamSmoothBank* bank);
+
+// Advance every moving smoother by num_frames. `apply` is called for each
+// one with its new end-of-block value, so the caller can push it into the
+// engine. Smoothers that arrive leave the moving list.
+typedef void (*param_smooth_apply_fn)(ParamId id, float value, void* userdata);
+void param_smooth_advance(ParamSmoothBank* bank, int num_frames,
+                          param_smooth_apply_fn apply, void* userdata);
+
+static inline const ParamSmoother* param_smooth_get(const ParamSmoothBank* bank, ParamId id) {
+    return &bank->params[id];
+}
+
+#endif // PARAM_SMOOTH_H
@@ -1,9 +1,33 @@
 #include "preset.h"
+#include "sequencer.h"
 
+#include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK g_json_parse_lock = SRWLOCK_INIT;
+#else
+#include <pthread.h>
+static pthread_mutex_t g_json_parse_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+cJSON* preset_json_parse(const char* text, size_t length) {
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&g_json_parse_lock);
+    cJSON* json = cJSON_ParseWithLength(text, length);
+    ReleaseSRWLockExclusive(&g_json_parse_lock);
+#else
+    pthread_mutex_lock(&g_json_parse_lock);
+    cJSON* json = cJSON_ParseWithLength(text, length);
+    pthread_mutex_unlock(&g_json_parse_lock);
+#endif
+    return json;
+}
+
 char* preset_read_text_file(const char* path, long* out_size) {
     if (!path) {
         return NULL;
@@ -84,7 +108,7 @@ void preset_init(PresetData* preset) {
     preset->compressor.threshold = 0.7f;
     preset->compressor.ratio = 4.0f;
     preset->arp.rate_multiplier = 1.0f;
-    preset->arp.mode = 0;
+    preset->arp.mode = ARP_UP;
 }
 
 static cJSON* preset_metadata_to_json(const PresetMetadata* meta) {
@@ -305,7 +329,12 @@ bool preset_load_file(PresetData* preset, const char* path) {
     if (!buffer) {
         return false;
     }
-    cJSON* json = cJSON_ParseWithLength(buffer, (size_t)length);
+    if (preset_is_binary((const uint8_t*)buffer, (size_t)length)) {
+        bool ok = preset_decode_binary(preset, (const uint8_t*)buffer, (size_t)length);
+        free(buffer);
+        return ok;
+    }
+    cJSON* json = preset_json_parse(buffer, (size_t)length);
     free(buffer);
     if (!json) {
         return false;
@@ -314,3 +343,312 @@ bool preset_load_file(PresetData* preset, const char* path) {
     cJSON_Delete(json);
     return ok;
 }
+
+// ============================================================================
+// BINARY ENCODING
+// ============================================================================
+
+// Header offsets
+#define BIN_MAGIC 0
+#define BIN_FORMAT_VERSION 4
+#define BIN_SCHEMA_VERSION 8
+#define BIN_RECORD_COUNT 12
+#define BIN_RECORD_OFFSET 16
+#define BIN_TOTAL_SIZE 20
+#define BIN_CHECKSUM 24        // FNV-1a of everything after the header
+
+typedef enum {
+    PRESET_FIELD_NONE = 0,
+    PRESET_FIELD_FLOAT,
+    PRESET_FIELD_INT,
+    PRESET_FIELD_BOOL
+} PresetFieldType;
+
+typedef struct {
+    PresetFieldType type;
+    size_t offset;
+} PresetBinaryField;
+
+#define FIELD_FLOAT(member) {PRESET_FIELD_FLOAT, offsetof(PresetData, member)}
+#define FIELD_INT(member) {PRESET_FIELD_INT, offsetof(PresetData, member)}
+#define FIELD_BOOL(member) {PRESET_FIELD_BOOL, offsetof(PresetData, member)}
+
+// Which PresetData member each stable ParamId is stored from
+static const PresetBinaryField g_preset_fields[PARAM_PARAM_COUNT] = {
+    [PARAM_MASTER_VOLUME] = FIELD_FLOAT(master_volume),
+    [PARAM_TEMPO] = FIELD_FLOAT(tempo),
+    [PARAM_FILTER_MODE] = FIELD_INT(filter_mode),
+    [PARAM_FILTER_CUTOFF] = FIELD_FLOAT(filter_cutoff),
+    [PARAM_FILTER_RESONANCE] = FIELD_FLOAT(filter_resonance),
+    [PARAM_FILTER_ENV_AMOUNT] = FIELD_FLOAT(filter_env_amount),
+    [PARAM_ENV_AMP_ATTACK] = FIELD_FLOAT(env_attack),
+    [PARAM_ENV_AMP_DECAY] = FIELD_FLOAT(env_decay),
+    [PARAM_ENV_AMP_SUSTAIN] = FIELD_FLOAT(env_sustain),
+    [PARAM_ENV_AMP_RELEASE] = FIELD_FLOAT(env_release),
+    [PARAM_FX_DISTORTION_ENABLED] = FIELD_BOOL(distortion.enabled),
+    [PARAM_FX_DISTORTION_DRIVE] = FIELD_FLOAT(distortion.drive),
+    [PARAM_FX_DISTORTION_MIX] = FIELD_FLOAT(distortion.mix),
+    [PARAM_FX_CHORUS_ENABLED] = FIELD_BOOL(chorus.enabled),
+    [PARAM_FX_CHORUS_RATE] = FIELD_FLOAT(chorus.rate),
+    [PARAM_FX_CHORUS_DEPTH] = FIELD_FLOAT(chorus.depth),
+    [PARAM_FX_CHORUS_MIX] = FIELD_FLOAT(chorus.mix),
+    [PARAM_FX_COMP_ENABLED] = FIELD_BOOL(compressor.enabled),
+    [PARAM_FX_COMP_THRESHOLD] = FIELD_FLOAT(compressor.threshold),
+    [PARAM_FX_COMP_RATIO] = FIELD_FLOAT(compressor.ratio),
+    [PARAM_FX_DELAY_ENABLED] = FIELD_BOOL(delay.enabled),
+    [PARAM_FX_DELAY_TIME] = FIELD_FLOAT(delay.time),
+    [PARAM_FX_DELAY_FEEDBACK] = FIELD_FLOAT(delay.feedback),
+    [PARAM_FX_DELAY_MIX] = FIELD_FLOAT(delay.mix),
+    [PARAM_FX_REVERB_ENABLED] = FIELD_BOOL(reverb.enabled),
+    [PARAM_FX_REVERB_SIZE] = FIELD_FLOAT(reverb.size),
+    [PARAM_FX_REVERB_DAMPING] = FIELD_FLOAT(reverb.damping),
+    [PARAM_FX_REVERB_MIX] = FIELD_FLOAT(reverb.mix),
+    [PARAM_ARP_MODE] = FIELD_INT(arp.mode),
+    [PARAM_ARP_RATE] = FIELD_FLOAT(arp.rate_multiplier), // Records keep the multiplier
+    [PARAM_ARP_ENABLED] = FIELD_BOOL(arp.enabled),
+};
+
+void preset_binary_put_u32(uint8_t* at, uint32_t value) {
+    at[0] = (uint8_t)value;
+    at[1] = (uint8_t)(value >> 8);
+    at[2] = (uint8_t)(value >> 16);
+    at[3] = (uint8_t)(value >> 24);
+}
+
+uint32_t preset_binary_get_u32(const uint8_t* at) {
+    return (uint32_t)at[0] | ((uint32_t)at[1] << 8) | ((uint32_t)at[2] << 16) | ((uint32_t)at[3] << 24);
+}
+
+void preset_binary_put_f32(uint8_t* at, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    preset_binary_put_u32(at, bits);
+}
+
+float preset_binary_get_f32(const uint8_t* at) {
+    uint32_t bits = preset_binary_get_u32(at);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint32_t preset_binary_checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t preset_binary_record_count(void) {
+    uint32_t count = 0;
+    for (int id = 0; id < PARAM_PARAM_COUNT; id++) {
+        if (g_preset_fields[id].type != PRESET_FIELD_NONE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t preset_binary_size(const PresetData* preset) {
+    if (!preset) {
+        return 0;
+    }
+    return PRESET_BINARY_HEADER_SIZE + PRESET_BINARY_META_SIZE +
+           (size_t)preset_binary_record_count() * PRESET_BINARY_RECORD_SIZE;
+}
+
+bool preset_is_binary(const uint8_t* data, size_t size) {
+    return data && size >= PRESET_BINARY_HEADER_SIZE &&
+           memcmp(data + BIN_MAGIC, PRESET_BINARY_MAGIC, 4) == 0;
+}
+
+static size_t bounded_length(const char* text, size_t limit) {
+    const char* end = (const char*)memchr(text, '\0', limit);
+    return end ? (size_t)(end - text) : limit;
+}
+
+// Fixed-width, zero-padded metadata strings; the last byte is always a terminator
+void preset_binary_put_text(uint8_t* at, size_t width, const char* text) {
+    memset(at, 0, width);
+    size_t length = bounded_length(text, width - 1);
+    memcpy(at, text, length);
+}
+
+void preset_binary_get_text(char* out, size_t out_size, const uint8_t* at, size_t width) {
+    size_t length = bounded_length((const char*)at, width);
+    if (length >= out_size) {
+        length = out_size - 1;
+    }
+    memcpy(out, at, length);
+    out[length] = '\0';
+}
+
+static float preset_field_get(const PresetData* preset, const PresetBinaryField* field) {
+    const char* base = (const char*)preset + field->offset;
+    switch (field->type) {
+        case PRESET_FIELD_FLOAT: return *(const float*)base;
+        case PRESET_FIELD_INT:   return (float)*(const int*)base;
+        case PRESET_FIELD_BOOL:  return *(const bool*)base ? 1.0f : 0.0f;
+        default:                 return 0.0f;
+    }
+}
+
+static void preset_field_set(PresetData* preset, const PresetBinaryField* field, float value) {
+    char* base = (char*)preset + field->offset;
+    switch (field->type) {
+        case PRESET_FIELD_FLOAT: *(float*)base = value; break;
+        case PRESET_FIELD_INT:   *(int*)base = (int)lrintf(value); break;
+        case PRESET_FIELD_BOOL:  *(bool*)base = value != 0.0f; break;
+        default: break;
+    }
+}
+
+void preset_to_params(const PresetData* preset, float* params) {
+    if (!preset || !params) {
+        return;
+    }
+    for (int id = 0; id < PARAM_PARAM_COUNT; id++) {
+        if (g_preset_fields[id].type != PRESET_FIELD_NONE) {
+            params[id] = preset_field_get(preset, &g_preset_fields[id]);
+        }
+    }
+    params[PARAM_ARP_RATE] = preset_arp_rate(preset);
+}
+
+void preset_from_params(PresetData* preset, const float* params) {
+    if (!preset || !params) {
+        return;
+    }
+    for (int id = 0; id < PARAM_PARAM_COUNT; id++) {
+        if (g_preset_fields[id].type != PRESET_FIELD_NONE) {
+            preset_field_set(preset, &g_preset_fields[id], params[id]);
+        }
+    }
+    preset->arp.rate_multiplier = params[PARAM_ARP_RATE] / ARP_BASE_RATE;
+}
+
+float preset_arp_rate(const PresetData* preset) {
+    if (!preset || !(preset->arp.rate_multiplier > 0.0f)) {
+        return ARP_BASE_RATE;
+    }
+    return ARP_BASE_RATE * preset->arp.rate_multiplier;
+}
+
+bool preset_encode_binary(const PresetData* preset, uint8_t* out, size_t capacity, size_t* out_size) {
+    size_t size = preset_binary_size(preset);
+    if (!preset || !out || capacity < size) {
+        return false;
+    }
+    memset(out, 0, size);
+    memcpy(out + BIN_MAGIC, PRESET_BINARY_MAGIC, 4);
+    preset_binary_put_u32(out + BIN_FORMAT_VERSION, PRESET_BINARY_VERSION);
+    preset_binary_put_u32(out + BIN_SCHEMA_VERSION, (uint32_t)preset->version);
+    preset_binary_put_u32(out + BIN_RECORD_COUNT, preset_binary_record_count());
+    preset_binary_put_u32(out + BIN_RECORD_OFFSET, PRESET_BINARY_HEADER_SIZE + PRESET_BINARY_META_SIZE);
+    preset_binary_put_u32(out + BIN_TOTAL_SIZE, (uint32_t)size);
+
+    uint8_t* meta = out + PRESET_BINARY_HEADER_SIZE;
+    preset_binary_put_text(meta, sizeof(preset->meta.name), preset->meta.name);
+    meta += sizeof(preset->meta.name);
+    preset_binary_put_text(meta, sizeof(preset->meta.author), preset->meta.author);
+    meta += sizeof(preset->meta.author);
+    preset_binary_put_text(meta, sizeof(preset->meta.category), preset->meta.category);
+    meta += sizeof(preset->meta.category);
+    preset_binary_put_text(meta, sizeof(preset->meta.description), preset->meta.description);
+
+    uint8_t* record = out + PRESET_BINARY_HEADER_SIZE + PRESET_BINARY_META_SIZE;
+    for (int id = 0; id < PARAM_PARAM_COUNT; id++) {
+        const PresetBinaryField* field = &g_preset_fields[id];
+        if (field->type == PRESET_FIELD_NONE) {
+            continue;
+        }
+        preset_binary_put_u32(record, (uint32_t)id);
+        preset_binary_put_f32(record + 4, preset_field_get(preset, field));
+        record += PRESET_BINARY_RECORD_SIZE;
+    }
+
+    preset_binary_put_u32(out + BIN_CHECKSUM,
+                          preset_binary_checksum(out + PRESET_BINARY_HEADER_SIZE, size - PRESET_BINARY_HEADER_SIZE));
+    if (out_size) {
+        *out_size = size;
+    }
+    return true;
+}
+
+bool preset_decode_binary(PresetData* preset, const uint8_t* data, size_t size) {
+    if (!preset || !preset_is_binary(data, size)) {
+        return false;
+    }
+    uint32_t format_version = preset_binary_get_u32(data + BIN_FORMAT_VERSION);
+    uint32_t record_count = preset_binary_get_u32(data + BIN_RECORD_COUNT);
+    uint32_t record_offset = preset_binary_get_u32(data + BIN_RECORD_OFFSET);
+    uint32_t total_size = preset_binary_get_u32(data + BIN_TOTAL_SIZE);
+    if (format_version == 0 || format_version > PRESET_BINARY_VERSION) {
+        fprintf(stderr, "❌ Unsupported binary preset version %u\n", format_version);
+        return false;
+    }
+    if (total_size > size || record_offset < PRESET_BINARY_HEADER_SIZE + PRESET_BINARY_META_SIZE ||
+        record_offset > total_size ||
+        record_count > (total_size - record_offset) / PRESET_BINARY_RECORD_SIZE) {
+        return false;
+    }
+    uint32_t checksum = preset_binary_checksum(data + PRESET_BINARY_HEADER_SIZE,
+                                               total_size - PRESET_BINARY_HEADER_SIZE);
+    if (checksum != preset_binary_get_u32(data + BIN_CHECKSUM)) {
+        fprintf(stderr, "❌ Binary preset checksum mismatch\n");
+        return false;
+    }
+
+    preset_init(preset);
+    preset->version = (int)preset_binary_get_u32(data + BIN_SCHEMA_VERSION);
+    const uint8_t* meta = data + PRESET_BINARY_HEADER_SIZE;
+    preset_binary_get_text(preset->meta.name, sizeof(preset->meta.name), meta, sizeof(preset->meta.name));
+    meta += sizeof(preset->meta.name);
+    preset_binary_get_text(preset->meta.author, sizeof(preset->meta.author), meta, sizeof(preset->meta.author));
+    meta += sizeof(preset->meta.author);
+    preset_binary_get_text(preset->meta.category, sizeof(preset->meta.category), meta, sizeof(preset->meta.category));
+    meta += sizeof(preset->meta.category);
+    preset_binary_get_text(preset->meta.description, sizeof(preset->meta.description), meta, sizeof(preset->meta.description));
+
+    const uint8_t* record = data + record_offset;
+    for (uint32_t i = 0; i < record_count; i++, record += PRESET_BINARY_RECORD_SIZE) {
+        uint32_t id = preset_binary_get_u32(record);
+        float value = preset_binary_get_f32(record + 4);
+        if (id >= PARAM_PARAM_COUNT || g_preset_fields[id].type == PRESET_FIELD_NONE || !isfinite(value)) {
+            continue;
+        }
+        preset_field_set(preset, &g_preset_fields[id], value);
+    }
+    return true;
+}
+
+bool preset_save_binary(const PresetData* preset, const char* path) {
+    if (!preset || !path) {
+        return false;
+    }
+    size_t size = preset_binary_size(preset);
+    uint8_t* buffer = (uint8_t*)malloc(size);
+    if (!buffer) {
+        return false;
+    }
+    bool ok = preset_encode_binary(preset, buffer, size, &size) &&
+              preset_write_text_file(path, (const char*)buffer, size);
+    free(buffer);
+    return ok;
+}
+
+bool preset_load_binary(PresetData* preset, const char* path) {
+    if (!preset || !path) {
+        return false;
+    }
+    long length = 0;
+    char* buffer = preset_read_text_file(path, &length);
+    if (!buffer) {
+        return false;
+    }
+    bool ok = preset_decode_binary(preset, (const uint8_t*)buffer, (size_t)length);
+    free(buffer);
+    return ok;
+}
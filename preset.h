@@ -3,7 +3,9 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
+#include "include/params.h"
 #include "third_party/cjson/cJSON.h"
 
 #ifdef __cplusplus
@@ -12,6 +14,17 @@ extern "C" {
 
 #define PRESET_SCHEMA_VERSION 1
 
+// Binary encoding: a fixed header and metadata block followed by 8-byte
+// {ParamId, value} records, all little-endian at fixed offsets, so a file can
+// be decoded straight out of a read or mapped buffer. Unknown ids are skipped,
+// which keeps older builds loading newer files.
+#define PRESET_BINARY_MAGIC "SYNP"
+#define PRESET_BINARY_EXTENSION ".synp"
+#define PRESET_BINARY_VERSION 1
+#define PRESET_BINARY_HEADER_SIZE 32
+#define PRESET_BINARY_META_SIZE 288
+#define PRESET_BINARY_RECORD_SIZE 8
+
 typedef struct {
     char name[64];
     char author[64];
@@ -83,11 +96,41 @@ void preset_init(PresetData* preset);
 cJSON* preset_to_json(const PresetData* preset);
 bool preset_from_json(PresetData* preset, const cJSON* json);
 bool preset_save_file(const PresetData* preset, const char* path, bool pretty);
+// Loads either encoding; binary files are recognised by their magic
 bool preset_load_file(PresetData* preset, const char* path);
 
+// Copy the stored settings into / out of a flat ParamId-indexed array
+// (PARAM_PARAM_COUNT entries). Ids a preset does not store are left alone.
+void preset_to_params(const PresetData* preset, float* params);
+void preset_from_params(PresetData* preset, const float* params);
+// Arp steps per beat: ARP_BASE_RATE times the stored rate multiplier, or the
+// base rate when the multiplier is not positive. The one conversion every
+// path (live patch, UI, offline render) uses.
+float preset_arp_rate(const PresetData* preset);
+
+// Bytes preset_encode_binary() writes for this preset
+size_t preset_binary_size(const PresetData* preset);
+bool preset_encode_binary(const PresetData* preset, uint8_t* out, size_t capacity, size_t* out_size);
+// Validates magic, version, sizes and checksum before touching `preset`
+bool preset_decode_binary(PresetData* preset, const uint8_t* data, size_t size);
+bool preset_is_binary(const uint8_t* data, size_t size);
+bool preset_save_binary(const PresetData* preset, const char* path);
+bool preset_load_binary(PresetData* preset, const char* path);
+
 // Shared helpers exposed for project serialization reuse
 char* preset_read_text_file(const char* path, long* out_size);
+// cJSON_ParseWithLength behind one lock. cJSON resets a global error slot on
+// every parse, so the library scan thread and the UI must not parse at once;
+// all app parsing goes through here.
+cJSON* preset_json_parse(const char* text, size_t length);
 bool preset_write_text_file(const char* path, const char* data, size_t size);
+void preset_binary_put_u32(uint8_t* at, uint32_t value);
+uint32_t preset_binary_get_u32(const uint8_t* at);
+void preset_binary_put_f32(uint8_t* at, float value);
+float preset_binary_get_f32(const uint8_t* at);
+uint32_t preset_binary_checksum(const uint8_t* data, size_t size);
+void preset_binary_put_text(uint8_t* at, size_t width, const char* text);
+void preset_binary_get_text(char* out, size_t out_size, const uint8_t* at, size_t width);
 
 #ifdef __cplusplus
 }
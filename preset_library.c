@@ -0,0 +1,846 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L   // opendir, stat, clock_gettime
+#endif
+
+#include "preset_library.h"
+#include "preset.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#endif
+
+// Search keys pack up to three lower-cased bytes; the entry index rides along
+typedef struct {
+    uint32_t key;
+    uint32_t entry;
+} PresetLibraryPosting;
+
+struct PresetLibraryIndex {
+    PresetLibraryEntry* entries;        // Sorted by name, then path
+    size_t count;
+    char* text;                         // Per entry: "name\nauthor\ncategory\ntags", lower case
+    uint32_t* text_offset;
+    PresetLibraryPosting* trigrams;     // Sorted by key, then entry; no duplicates
+    size_t trigram_count;
+    PresetLibraryPosting* prefixes;     // Two-character word starts, same layout
+    size_t prefix_count;
+};
+
+typedef struct {
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+} PresetLibraryThread;
+
+static double library_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool strings_equal_ci(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+            return false;
+        }
+    }
+    return *a == *b;
+}
+
+static int compare_ci(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        int diff = tolower((unsigned char)*a) - tolower((unsigned char)*b);
+        if (diff != 0) {
+            return diff;
+        }
+    }
+    return (unsigned char)*a - (unsigned char)*b;
+}
+
+// ============================================================================
+// INDEX SNAPSHOTS
+// ============================================================================
+
+static void index_free(PresetLibraryIndex* index) {
+    if (!index) {
+        return;
+    }
+    free(index->entries);
+    free(index->text);
+    free(index->text_offset);
+    free(index->trigrams);
+    free(index->prefixes);
+    free(index);
+}
+
+static int compare_entries(const void* a, const void* b) {
+    const PresetLibraryEntry* lhs = (const PresetLibraryEntry*)a;
+    const PresetLibraryEntry* rhs = (const PresetLibraryEntry*)b;
+    int order = compare_ci(lhs->name, rhs->name);
+    return order != 0 ? order : strcmp(lhs->path, rhs->path);
+}
+
+static int compare_postings(const void* a, const void* b) {
+    const PresetLibraryPosting* lhs = (const PresetLibraryPosting*)a;
+    const PresetLibraryPosting* rhs = (const PresetLibraryPosting*)b;
+    if (lhs->key != rhs->key) {
+        return lhs->key < rhs->key ? -1 : 1;
+    }
+    return lhs->entry < rhs->entry ? -1 : (lhs->entry > rhs->entry ? 1 : 0);
+}
+
+static size_t sort_unique(PresetLibraryPosting* postings, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    qsort(postings, count, sizeof(*postings), compare_postings);
+    size_t kept = 1;
+    for (size_t i = 1; i < count; i++) {
+        if (postings[i].key != postings[kept - 1].key || postings[i].entry != postings[kept - 1].entry) {
+            postings[kept++] = postings[i];
+        }
+    }
+    return kept;
+}
+
+static uint32_t pack_key(const char* text, size_t length) {
+    uint32_t key = 0;
+    for (size_t i = 0; i < 3; i++) {
+        key = (key << 8) | (i < length ? (uint8_t)text[i] : 0u);
+    }
+    return key;
+}
+
+static bool is_word_char(char c) {
+    return isalnum((unsigned char)c) != 0;
+}
+
+// Takes ownership of `entries`; sorts them and builds the search indexes
+static PresetLibraryIndex* index_build(PresetLibraryEntry* entries, size_t count) {
+    PresetLibraryIndex* index = (PresetLibraryIndex*)calloc(1, sizeof(PresetLibraryIndex));
+    if (!index) {
+        free(entries);
+        return NULL;
+    }
+    index->entries = entries;
+    index->count = count;
+    if (count > 0) {
+        qsort(entries, count, sizeof(*entries), compare_entries);
+    }
+
+    size_t text_size = 1;
+    for (size_t i = 0; i < count; i++) {
+        text_size += strlen(entries[i].name) + strlen(entries[i].author) + strlen(entries[i].category) +
+                     strlen(entries[i].tags) + 4;
+    }
+    index->text = (char*)malloc(text_size);
+    index->text_offset = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+    if (!index->text || !index->text_offset) {
+        index_free(index);
+        return NULL;
+    }
+    size_t at = 0;
+    for (size_t i = 0; i < count; i++) {
+        index->text_offset[i] = (uint32_t)at;
+        at += (size_t)sprintf(index->text + at, "%s\n%s\n%s\n%s", entries[i].name, entries[i].author,
+                              entries[i].category, entries[i].tags);
+        index->text[at++] = '\0';
+    }
+    index->text_offset[count] = (uint32_t)at;
+    for (size_t i = 0; i < at; i++) {
+        index->text[i] = (char)tolower((unsigned char)index->text[i]);
+    }
+
+    // At most one trigram and one word start per byte of text
+    index->trigrams = (PresetLibraryPosting*)malloc((at + 1) * sizeof(PresetLibraryPosting));
+    index->prefixes = (PresetLibraryPosting*)malloc((at + 1) * sizeof(PresetLibraryPosting));
+    if (!index->trigrams || !index->prefixes) {
+        index_free(index);
+        return NULL;
+    }
+    size_t trigrams = 0;
+    size_t prefixes = 0;
+    for (size_t i = 0; i < count; i++) {
+        const char* text = index->text + index->text_offset[i];
+        size_t length = strlen(text);
+        for (size_t c = 0; c + 3 <= length; c++) {
+            if (text[c] != '\n' && text[c + 1] != '\n' && text[c + 2] != '\n') {
+                index->trigrams[trigrams++] = (PresetLibraryPosting){pack_key(text + c, 3), (uint32_t)i};
+            }
+        }
+        for (size_t c = 0; c < length; c++) {
+            if (is_word_char(text[c]) && (c == 0 || !is_word_char(text[c - 1]))) {
+                size_t word = is_word_char(text[c + 1]) ? 2 : 1;
+                index->prefixes[prefixes++] = (PresetLibraryPosting){pack_key(text + c, word), (uint32_t)i};
+            }
+        }
+    }
+    index->trigram_count = sort_unique(index->trigrams, trigrams);
+    index->prefix_count = sort_unique(index->prefixes, prefixes);
+    return index;
+}
+
+// First posting with key >= `key`
+static size_t postings_lower_bound(const PresetLibraryPosting* postings, size_t count, uint32_t key) {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (postings[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// ============================================================================
+// ON-DISK INDEX
+// ============================================================================
+
+static void copy_json_string(char* out, size_t out_size, const cJSON* object, const char* key) {
+    const cJSON* item = cJSON_GetObjectItemCaseSensitive(object, key);
+    if (cJSON_IsString(item) && item->valuestring) {
+        snprintf(out, out_size, "%s", item->valuestring);
+    }
+}
+
+static PresetLibraryEntry* index_file_load(const char* path, size_t* out_count) {
+    *out_count = 0;
+    if (!path || !path[0]) {
+        return NULL;
+    }
+    long length = 0;
+    char* data = preset_read_text_file(path, &length);
+    if (!data) {
+        return NULL;
+    }
+    cJSON* root = preset_json_parse(data, (size_t)length);
+    free(data);
+    if (!root) {
+        fprintf(stderr, "❌ Preset index '%s' is unreadable, rescanning everything\n", path);
+        return NULL;
+    }
+    const cJSON* version = cJSON_GetObjectItemCaseSensitive(root, "version");
+    const cJSON* items = cJSON_GetObjectItemCaseSensitive(root, "entries");
+    if (!cJSON_IsNumber(version) || version->valueint != PRESET_LIBRARY_INDEX_VERSION || !cJSON_IsArray(items)) {
+        cJSON_Delete(root);
+        return NULL;
+    }
+    int capacity = cJSON_GetArraySize(items);
+    PresetLibraryEntry* entries = (PresetLibraryEntry*)calloc((size_t)capacity + 1, sizeof(PresetLibraryEntry));
+    size_t count = 0;
+    const cJSON* item = NULL;
+    cJSON_ArrayForEach(item, items) {
+        if (!entries) {
+            break;
+        }
+        const cJSON* mtime = cJSON_GetObjectItemCaseSensitive(item, "mtime");
+        const cJSON* size = cJSON_GetObjectItemCaseSensitive(item, "size");
+        PresetLibraryEntry* entry = &entries[count];
+        copy_json_string(entry->path, sizeof(entry->path), item, "path");
+        if (!entry->path[0] || !cJSON_IsNumber(mtime) || !cJSON_IsNumber(size)) {
+            memset(entry, 0, sizeof(*entry));
+            continue;
+        }
+        copy_json_string(entry->name, sizeof(entry->name), item, "name");
+        copy_json_string(entry->author, sizeof(entry->author), item, "author");
+        copy_json_string(entry->category, sizeof(entry->category), item, "category");
+        copy_json_string(entry->tags, sizeof(entry->tags), item, "tags");
+        entry->mtime = (int64_t)mtime->valuedouble;
+        entry->size = (int64_t)size->valuedouble;
+        count++;
+    }
+    cJSON_Delete(root);
+    *out_count = count;
+    return entries;
+}
+
+static bool index_file_save(const char* path, const PresetLibraryEntry* entries, size_t count) {
+    if (!path || !path[0]) {
+        return true;
+    }
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return false;
+    }
+    cJSON_AddNumberToObject(root, "version", PRESET_LIBRARY_INDEX_VERSION);
+    cJSON* items = cJSON_AddArrayToObject(root, "entries");
+    for (size_t i = 0; i < count; i++) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "path", entries[i].path);
+        cJSON_AddStringToObject(item, "name", entries[i].name);
+        cJSON_AddStringToObject(item, "author", entries[i].author);
+        cJSON_AddStringToObject(item, "category", entries[i].category);
+        cJSON_AddStringToObject(item, "tags", entries[i].tags);
+        cJSON_AddNumberToObject(item, "mtime", (double)entries[i].mtime);
+        cJSON_AddNumberToObject(item, "size", (double)entries[i].size);
+        cJSON_AddItemToArray(items, item);
+    }
+    char* text = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!text) {
+        return false;
+    }
+    bool ok = preset_write_text_file(path, text, strlen(text));
+    cJSON_free(text);
+    if (!ok) {
+        fprintf(stderr, "❌ Failed to write preset index '%s'\n", path);
+    }
+    return ok;
+}
+
+// ============================================================================
+// DIRECTORY WALK
+// ============================================================================
+
+typedef struct {
+    PresetLibraryEntry* items;
+    size_t count;
+    size_t capacity;
+} EntryList;
+
+typedef struct {
+    const PresetLibraryEntry* previous;  // Sorted by path
+    size_t previous_count;
+    EntryList found;
+    PresetLibraryScanStats stats;
+    atomic_int* stop;
+} ScanContext;
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(((const PresetLibraryEntry*)a)->path, ((const PresetLibraryEntry*)b)->path);
+}
+
+static bool entry_list_push(EntryList* list, const PresetLibraryEntry* entry) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        PresetLibraryEntry* grown = (PresetLibraryEntry*)realloc(list->items, capacity * sizeof(*grown));
+        if (!grown) {
+            return false;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = *entry;
+    return true;
+}
+
+static bool is_preset_file(const char* name) {
+    if (name[0] == '.') {
+        return false;
+    }
+    const char* dot = strrchr(name, '.');
+    return dot && (strings_equal_ci(dot, ".json") || strings_equal_ci(dot, PRESET_BINARY_EXTENSION));
+}
+
+static void join_tags(char* out, size_t out_size, const cJSON* tags) {
+    out[0] = '\0';
+    if (cJSON_IsString(tags) && tags->valuestring) {
+        snprintf(out, out_size, "%s", tags->valuestring);
+        return;
+    }
+    size_t used = 0;
+    const cJSON* tag = NULL;
+    cJSON_ArrayForEach(tag, tags) {
+        if (!cJSON_IsString(tag) || !tag->valuestring) {
+            continue;
+        }
+        int n = snprintf(out + used, out_size - used, "%s%s", used ? " " : "", tag->valuestring);
+        if (n < 0 || (size_t)n >= out_size - used) {
+            out[used] = '\0';
+            break;
+        }
+        used += (size_t)n;
+    }
+}
+
+// Read a new or modified file's metadata; false if it is not a preset
+static bool read_preset_metadata(PresetLibraryEntry* entry) {
+    long length = 0;
+    char* data = preset_read_text_file(entry->path, &length);
+    if (!data) {
+        return false;
+    }
+    PresetData preset;
+    bool ok;
+    entry->tags[0] = '\0';
+    if (preset_is_binary((const uint8_t*)data, (size_t)length)) {
+        ok = preset_decode_binary(&preset, (const uint8_t*)data, (size_t)length);
+    } else {
+        cJSON* json = preset_json_parse(data, (size_t)length);
+        // Projects carry a preset too, but only bare presets belong in the browser
+        ok = json && !cJSON_HasObjectItem(json, "preset") && preset_from_json(&preset, json);
+        if (ok) {
+            const cJSON* meta = cJSON_GetObjectItemCaseSensitive(json, "metadata");
+            join_tags(entry->tags, sizeof(entry->tags), cJSON_GetObjectItemCaseSensitive(meta, "tags"));
+        }
+        cJSON_Delete(json);
+    }
+    free(data);
+    if (!ok) {
+        return false;
+    }
+    snprintf(entry->name, sizeof(entry->name), "%s", preset.meta.name);
+    snprintf(entry->author, sizeof(entry->author), "%s", preset.meta.author);
+    snprintf(entry->category, sizeof(entry->category), "%s", preset.meta.category);
+    return true;
+}
+
+static void scan_file(ScanContext* scan, const char* path, int64_t mtime, int64_t size) {
+    PresetLibraryEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    snprintf(entry.path, sizeof(entry.path), "%s", path);
+    entry.mtime = mtime;
+    entry.size = size;
+    scan->stats.files++;
+
+    const PresetLibraryEntry* known = NULL;
+    if (scan->previous_count > 0) {
+        known = (const PresetLibraryEntry*)bsearch(&entry, scan->previous, scan->previous_count,
+                                                   sizeof(entry), compare_paths);
+    }
+    if (known && known->mtime == mtime && known->size == size) {
+        entry_list_push(&scan->found, known);
+        scan->stats.reused++;
+        return;
+    }
+    if (!read_preset_metadata(&entry)) {
+        scan->stats.failed++;
+        return;
+    }
+    entry_list_push(&scan->found, &entry);
+    scan->stats.parsed++;
+}
+
+static void scan_directory(ScanContext* scan, const char* directory, int depth) {
+    if (depth > 16 || atomic_load_explicit(scan->stop, memory_order_relaxed)) {
+        return;
+    }
+    char path[512];
+#if defined(_WIN32)
+    char pattern[512];
+    snprintf(pattern, sizeof(pattern), "%s\\*", directory);
+    WIN32_FIND_DATAA found;
+    HANDLE find = FindFirstFileA(pattern, &found);
+    if (find == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    do {
+        const char* name = found.cFileName;
+        if (name[0] == '.') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", directory, name);
+        if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            scan_directory(scan, path, depth + 1);
+        } else if (is_preset_file(name)) {
+            ULARGE_INTEGER written;
+            written.LowPart = found.ftLastWriteTime.dwLowDateTime;
+            written.HighPart = found.ftLastWriteTime.dwHighDateTime;
+            int64_t size = ((int64_t)found.nFileSizeHigh << 32) | found.nFileSizeLow;
+            scan_file(scan, path, (int64_t)(written.QuadPart / 10000000ull), size);
+        }
+    } while (FindNextFileA(find, &found));
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        return;
+    }
+    struct dirent* item;
+    while ((item = readdir(dir)) != NULL) {
+        const char* name = item->d_name;
+        if (name[0] == '.') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", directory, name);
+        struct stat info;
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            scan_directory(scan, path, depth + 1);
+        } else if (S_ISREG(info.st_mode) && is_preset_file(name)) {
+            scan_file(scan, path, (int64_t)info.st_mtime, (int64_t)info.st_size);
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+// ============================================================================
+// SCANNING
+// ============================================================================
+
+static void publish(PresetLibrary* library, PresetLibraryIndex* index) {
+    PresetLibraryIndex* unseen = atomic_exchange_explicit(&library->pending, index, memory_order_acq_rel);
+    index_free(unseen);
+}
+
+static PresetLibraryEntry* copy_entries(const PresetLibraryEntry* entries, size_t count) {
+    PresetLibraryEntry* copy = (PresetLibraryEntry*)malloc((count + 1) * sizeof(PresetLibraryEntry));
+    if (copy && count > 0) {
+        memcpy(copy, entries, count * sizeof(PresetLibraryEntry));
+    }
+    return copy;
+}
+
+static bool scan_run(PresetLibrary* library, PresetLibraryScanStats* out_stats) {
+    double started = library_seconds();
+    ScanContext scan;
+    memset(&scan, 0, sizeof(scan));
+    scan.stop = &library->stop;
+
+    // The saved index goes out first, so browsing starts before the walk ends
+    size_t previous_count = 0;
+    PresetLibraryEntry* previous = index_file_load(library->index_path, &previous_count);
+    if (previous && !library->published) {
+        publish(library, index_build(copy_entries(previous, previous_count), previous_count));
+    }
+    if (previous_count > 0) {
+        qsort(previous, previous_count, sizeof(*previous), compare_paths);
+    }
+    scan.previous = previous;
+    scan.previous_count = previous_count;
+
+    for (int r = 0; r < library->root_count; r++) {
+        scan_directory(&scan, library->roots[r], 0);
+    }
+    free(previous);
+    if (atomic_load(&library->stop)) {
+        free(scan.found.items);
+        return false;
+    }
+
+    // Removed files show up as a smaller count with nothing new
+    bool changed = scan.stats.parsed > 0 || scan.found.count != previous_count;
+    if (changed) {
+        index_file_save(library->index_path, scan.found.items, scan.found.count);
+    }
+    scan.stats.seconds = library_seconds() - started;
+    library->last_scan = scan.stats;
+    if (out_stats) {
+        *out_stats = scan.stats;
+    }
+    PresetLibraryIndex* index = index_build(scan.found.items, scan.found.count);
+    if (!index) {
+        return false;
+    }
+    publish(library, index);
+    library->published = true;
+    return true;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI scan_thread_main(LPVOID arg) {
+#else
+static void* scan_thread_main(void* arg) {
+#endif
+    PresetLibrary* library = (PresetLibrary*)arg;
+    scan_run(library, NULL);
+    atomic_store(&library->scanning, 0);
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+void preset_library_init(PresetLibrary* library, const char* index_path) {
+    if (!library) {
+        return;
+    }
+    memset(library, 0, sizeof(*library));
+    atomic_init(&library->pending, NULL);
+    atomic_init(&library->scanning, 0);
+    atomic_init(&library->stop, 0);
+    if (index_path) {
+        snprintf(library->index_path, sizeof(library->index_path), "%s", index_path);
+    }
+}
+
+bool preset_library_add_root(PresetLibrary* library, const char* directory) {
+    if (!library || !directory || library->root_count >= PRESET_LIBRARY_MAX_ROOTS ||
+        atomic_load(&library->scanning)) {
+        return false;
+    }
+    snprintf(library->roots[library->root_count++], sizeof(library->roots[0]), "%s", directory);
+    return true;
+}
+
+bool preset_library_scan(PresetLibrary* library, PresetLibraryScanStats* stats) {
+    if (!library || atomic_load(&library->scanning)) {
+        return false;
+    }
+    preset_library_wait(library);
+    atomic_store(&library->stop, 0);
+    return scan_run(library, stats);
+}
+
+bool preset_library_scan_async(PresetLibrary* library) {
+    if (!library || atomic_load(&library->scanning)) {
+        return false;
+    }
+    preset_library_wait(library);
+    PresetLibraryThread* thread = (PresetLibraryThread*)calloc(1, sizeof(PresetLibraryThread));
+    if (!thread) {
+        return false;
+    }
+    atomic_store(&library->stop, 0);
+    atomic_store(&library->scanning, 1);
+#if defined(_WIN32)
+    thread->handle = CreateThread(NULL, 0, scan_thread_main, library, 0, NULL);
+    bool started = thread->handle != NULL;
+#else
+    bool started = pthread_create(&thread->handle, NULL, scan_thread_main, library) == 0;
+#endif
+    if (!started) {
+        fprintf(stderr, "❌ Failed to start preset scan thread\n");
+        atomic_store(&library->scanning, 0);
+        free(thread);
+        return false;
+    }
+    library->thread = thread;
+    return true;
+}
+
+bool preset_library_is_scanning(PresetLibrary* library) {
+    return library && atomic_load(&library->scanning);
+}
+
+void preset_library_wait(PresetLibrary* library) {
+    if (!library || !library->thread) {
+        return;
+    }
+    PresetLibraryThread* thread = (PresetLibraryThread*)library->thread;
+#if defined(_WIN32)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+    library->thread = NULL;
+}
+
+// ============================================================================
+// UI THREAD
+// ============================================================================
+
+bool preset_library_poll(PresetLibrary* library) {
+    if (!library) {
+        return false;
+    }
+    PresetLibraryIndex* next = atomic_exchange_explicit(&library->pending, NULL, memory_order_acq_rel);
+    if (!next) {
+        return false;
+    }
+    index_free(library->current);
+    library->current = next;
+    library->cache_valid = false;
+    return true;
+}
+
+size_t preset_library_count(const PresetLibrary* library) {
+    return library && library->current ? library->current->count : 0;
+}
+
+const PresetLibraryEntry* preset_library_entry(const PresetLibrary* library, size_t index) {
+    if (!library || !library->current || index >= library->current->count) {
+        return NULL;
+    }
+    return &library->current->entries[index];
+}
+
+// Does any word of `text` start with `term` (one or two characters)?
+static bool text_has_word_prefix(const char* text, const char* term, size_t length) {
+    for (size_t c = 0; text[c]; c++) {
+        if ((c == 0 || !is_word_char(text[c - 1])) && strncmp(text + c, term, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool text_matches(const char* text, char terms[][PRESET_LIBRARY_QUERY], int term_count) {
+    for (int t = 0; t < term_count; t++) {
+        size_t length = strlen(terms[t]);
+        bool hit = length >= 3 ? strstr(text, terms[t]) != NULL : text_has_word_prefix(text, terms[t], length);
+        if (!hit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Candidate postings for one term: [*first, *last)
+static void term_range(const PresetLibraryIndex* index, const char* term, size_t* first, size_t* last,
+                       const PresetLibraryPosting** postings) {
+    size_t length = strlen(term);
+    if (length >= 3) {
+        // The rarest trigram of the term bounds the candidates
+        size_t best = SIZE_MAX;
+        for (size_t c = 0; c + 3 <= length; c++) {
+            uint32_t key = pack_key(term + c, 3);
+            size_t lo = postings_lower_bound(index->trigrams, index->trigram_count, key);
+            size_t hi = postings_lower_bound(index->trigrams, index->trigram_count, key + 1);
+            if (hi - lo < best) {
+                best = hi - lo;
+                *first = lo;
+                *last = hi;
+            }
+        }
+        *postings = index->trigrams;
+        return;
+    }
+    uint32_t key = pack_key(term, length);
+    uint32_t end = length == 1 ? key + 0x10000u : key + 0x100u;
+    *first = postings_lower_bound(index->prefixes, index->prefix_count, key);
+    *last = postings_lower_bound(index->prefixes, index->prefix_count, end);
+    *postings = index->prefixes;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t lhs = *(const uint32_t*)a;
+    uint32_t rhs = *(const uint32_t*)b;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+size_t preset_library_search(PresetLibrary* library, const char* query, const char* category,
+                             const uint32_t** out_results) {
+    if (out_results) {
+        *out_results = NULL;
+    }
+    if (!library || !library->current) {
+        return 0;
+    }
+    query = query ? query : "";
+    category = category ? category : "";
+    if (library->cache_valid && strcmp(library->cached_query, query) == 0 &&
+        strcmp(library->cached_category, category) == 0) {
+        if (out_results) {
+            *out_results = library->results;
+        }
+        return library->result_count;
+    }
+
+    const PresetLibraryIndex* index = library->current;
+    free(library->results);
+    library->results = (uint32_t*)malloc((index->count + 1) * sizeof(uint32_t));
+    library->result_count = 0;
+    library->cache_valid = false;
+    if (!library->results) {
+        return 0;
+    }
+
+    // Lower-cased, whitespace-separated terms
+    char terms[8][PRESET_LIBRARY_QUERY];
+    int term_count = 0;
+    for (const char* q = query; *q && term_count < 8;) {
+        while (*q && isspace((unsigned char)*q)) q++;
+        size_t length = 0;
+        while (q[length] && !isspace((unsigned char)q[length]) && length < PRESET_LIBRARY_QUERY - 1) {
+            terms[term_count][length] = (char)tolower((unsigned char)q[length]);
+            length++;
+        }
+        if (length == 0) {
+            break;
+        }
+        terms[term_count++][length] = '\0';
+        q += length;
+        while (*q && !isspace((unsigned char)*q)) q++;
+    }
+
+    size_t count = 0;
+    if (term_count == 0) {
+        for (size_t i = 0; i < index->count; i++) {
+            library->results[count++] = (uint32_t)i;
+        }
+    } else {
+        // Seed from the term with the fewest postings, then verify every term
+        size_t first = 0;
+        size_t last = SIZE_MAX;
+        const PresetLibraryPosting* postings = NULL;
+        for (int t = 0; t < term_count; t++) {
+            size_t lo = 0;
+            size_t hi = 0;
+            const PresetLibraryPosting* candidates = NULL;
+            term_range(index, terms[t], &lo, &hi, &candidates);
+            if (hi - lo < last - first) {
+                first = lo;
+                last = hi;
+                postings = candidates;
+            }
+        }
+        for (size_t p = first; p < last; p++) {
+            library->results[count++] = postings[p].entry;
+        }
+        if (postings == index->prefixes && count > 1) {
+            // One-character prefixes span several keys, so entries can repeat
+            qsort(library->results, count, sizeof(uint32_t), compare_u32);
+            size_t kept = 1;
+            for (size_t i = 1; i < count; i++) {
+                if (library->results[i] != library->results[kept - 1]) {
+                    library->results[kept++] = library->results[i];
+                }
+            }
+            count = kept;
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t entry = library->results[i];
+            if (text_matches(index->text + index->text_offset[entry], terms, term_count)) {
+                library->results[kept++] = entry;
+            }
+        }
+        count = kept;
+    }
+
+    if (category[0]) {
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (strings_equal_ci(index->entries[library->results[i]].category, category)) {
+                library->results[kept++] = library->results[i];
+            }
+        }
+        count = kept;
+    }
+
+    library->result_count = count;
+    snprintf(library->cached_query, sizeof(library->cached_query), "%s", query);
+    snprintf(library->cached_category, sizeof(library->cached_category), "%s", category);
+    library->cache_valid = true;
+    if (out_results) {
+        *out_results = library->results;
+    }
+    return count;
+}
+
+void preset_library_shutdown(PresetLibrary* library) {
+    if (!library) {
+        return;
+    }
+    atomic_store(&library->stop, 1);
+    preset_library_wait(library);
+    index_free(atomic_exchange(&library->pending, NULL));
+    index_free(library->current);
+    library->current = NULL;
+    free(library->results);
+    library->results = NULL;
+    library->result_count = 0;
+    library->cache_valid = false;
+}
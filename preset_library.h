@@ -0,0 +1,108 @@
+/**
+ * Indexed preset library
+ *
+ * Scans preset directories (JSON and binary presets, recursively) on a
+ * background thread and keeps an on-disk index of each file's metadata,
+ * modification time and size. A rescan reuses every indexed entry whose
+ * file is unchanged and only opens new or modified files. At startup the
+ * saved index is published first, so a large library is browsable before the
+ * directory walk finishes.
+ *
+ * Each published index is an immutable snapshot with entries sorted by name
+ * and two search indexes over the lower-cased name, author, category and
+ * tags: trigram postings for terms of three or more characters (substring
+ * match) and two-character word prefixes for shorter terms. A query's terms
+ * must all match. The UI thread owns the current snapshot and a one-query
+ * result cache, so redrawing the same search every frame costs nothing.
+ */
+
+#ifndef PRESET_LIBRARY_H
+#define PRESET_LIBRARY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PRESET_LIBRARY_MAX_ROOTS 4
+#define PRESET_LIBRARY_INDEX_VERSION 1
+#define PRESET_LIBRARY_QUERY 64        // Longest cached query, including the terminator
+
+typedef struct {
+    char path[512];
+    char name[64];
+    char author[64];
+    char category[32];
+    char tags[128];                    // Space separated
+    int64_t mtime;                     // Seconds, as reported by stat()
+    int64_t size;
+} PresetLibraryEntry;
+
+typedef struct {
+    size_t files;                      // Preset files found by the walk
+    size_t reused;                     // Taken from the saved index unchanged
+    size_t parsed;                     // New or modified, read from disk
+    size_t failed;                     // Unreadable or not a preset
+    double seconds;
+} PresetLibraryScanStats;
+
+// Immutable once published
+typedef struct PresetLibraryIndex PresetLibraryIndex;
+
+typedef struct {
+    char roots[PRESET_LIBRARY_MAX_ROOTS][260];
+    int root_count;
+    char index_path[260];
+
+    // Scanner -> UI handoff; the UI frees the snapshot it replaces
+    _Atomic(PresetLibraryIndex*) pending;
+    atomic_int scanning;
+    atomic_int stop;
+    void* thread;                      // Platform thread handle while a scan runs
+    bool published;                    // Scanner side: a full walk has been published
+    PresetLibraryScanStats last_scan;  // Read it once the scan has finished
+
+    // UI thread
+    PresetLibraryIndex* current;
+    char cached_query[PRESET_LIBRARY_QUERY];
+    char cached_category[32];
+    bool cache_valid;
+    uint32_t* results;
+    size_t result_count;
+} PresetLibrary;
+
+// `index_path` is where the index is saved between runs (NULL: no index)
+void preset_library_init(PresetLibrary* library, const char* index_path);
+bool preset_library_add_root(PresetLibrary* library, const char* directory);
+
+// Index, walk and publish on the calling thread
+bool preset_library_scan(PresetLibrary* library, PresetLibraryScanStats* stats);
+// Same work on a background thread; false if a scan is already running
+bool preset_library_scan_async(PresetLibrary* library);
+bool preset_library_is_scanning(PresetLibrary* library);
+// Joins a finished background scan's thread
+void preset_library_wait(PresetLibrary* library);
+
+// UI thread: adopt the newest published snapshot. True if it changed.
+bool preset_library_poll(PresetLibrary* library);
+size_t preset_library_count(const PresetLibrary* library);
+const PresetLibraryEntry* preset_library_entry(const PresetLibrary* library, size_t index);
+
+// UI thread: entry indices (name order) matching every term of `query` and,
+// when `category` is non-empty, that category (case-insensitive). The array
+// stays valid until the next search or poll. An empty query lists all.
+size_t preset_library_search(PresetLibrary* library, const char* query, const char* category,
+                             const uint32_t** out_results);
+
+// Stops a running scan and frees everything
+void preset_library_shutdown(PresetLibrary* library);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRESET_LIBRARY_H
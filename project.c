@@ -17,6 +17,7 @@ void project_init(ProjectData* project) {
     snprintf(project->export_path, sizeof(project->export_path), "exports/bounce.wav");
     project->export_duration_seconds = 8.0f;
     project->tempo = 120.0f;
+    audio_settings_init(&project->audio);
     preset_init(&project->preset);
 }
 
@@ -63,6 +64,7 @@ cJSON* project_to_json(const ProjectData* project) {
     cJSON_AddStringToObject(root, "exportPath", project->export_path);
     cJSON_AddNumberToObject(root, "exportDuration", project->export_duration_seconds);
     cJSON_AddNumberToObject(root, "tempo", project->tempo);
+    cJSON_AddItemToObject(root, "audio", audio_settings_to_json(&project->audio));
 
     cJSON* preset_obj = preset_to_json(&project->preset);
     if (!preset_obj) {
@@ -105,6 +107,7 @@ bool project_from_json(ProjectData* project, const cJSON* json) {
     if (cJSON_IsNumber(tempo)) {
         project->tempo = (float)tempo->valuedouble;
     }
+    audio_settings_from_json(&project->audio, cJSON_GetObjectItemCaseSensitive(json, "audio"));
 
     const cJSON* preset_obj = cJSON_GetObjectItemCaseSensitive(json, "preset");
     if (!cJSON_IsObject(preset_obj)) {
@@ -144,7 +147,12 @@ bool project_load_file(ProjectData* project, const char* path) {
     if (!buffer) {
         return false;
     }
-    cJSON* json = cJSON_ParseWithLength(buffer, (size_t)length);
+    if ((size_t)length >= 4 && memcmp(buffer, PROJECT_BINARY_MAGIC, 4) == 0) {
+        bool ok = project_decode_binary(project, (const uint8_t*)buffer, (size_t)length);
+        free(buffer);
+        return ok;
+    }
+    cJSON* json = preset_json_parse(buffer, (size_t)length);
     free(buffer);
     if (!json) {
         return false;
@@ -153,3 +161,156 @@ bool project_load_file(ProjectData* project, const char* path) {
     cJSON_Delete(json);
     return ok;
 }
+
+// ============================================================================
+// BINARY ENCODING
+// ============================================================================
+
+// Header offsets
+#define BIN_FORMAT_VERSION 4
+#define BIN_PRESET_OFFSET 8
+#define BIN_PRESET_SIZE 12
+#define BIN_TOTAL_SIZE 16
+#define BIN_CHECKSUM 20        // FNV-1a of the metadata and paths
+#define BIN_EXPORT_DURATION 24
+#define BIN_TEMPO 28
+#define BIN_HEADER_SIZE 32
+
+#define BIN_BODY_SIZE (sizeof(ProjectMetadata) + 3 * 512)   // Metadata and the three paths
+#define BIN_AUDIO_SIZE 32      // Version 2 on: audio settings after the body, under the checksum
+
+// Audio block offsets
+#define BIN_AUDIO_SAMPLE_RATE 0
+#define BIN_AUDIO_PERIOD_FRAMES 4
+#define BIN_AUDIO_PERIODS 8
+#define BIN_AUDIO_BACKEND 12
+#define BIN_AUDIO_FLAGS 16
+#define BIN_AUDIO_EXCLUSIVE 1u
+#define BIN_AUDIO_DUPLEX 2u
+#define BIN_AUDIO_REALTIME 4u
+
+static void project_put_audio(uint8_t* at, const AudioSettings* audio) {
+    preset_binary_put_u32(at + BIN_AUDIO_SAMPLE_RATE, audio->sample_rate);
+    preset_binary_put_u32(at + BIN_AUDIO_PERIOD_FRAMES, audio->period_frames);
+    preset_binary_put_u32(at + BIN_AUDIO_PERIODS, audio->periods);
+    preset_binary_put_u32(at + BIN_AUDIO_BACKEND, (uint32_t)audio->backend);
+    preset_binary_put_u32(at + BIN_AUDIO_FLAGS, (audio->exclusive ? BIN_AUDIO_EXCLUSIVE : 0u) |
+                                                (audio->duplex ? BIN_AUDIO_DUPLEX : 0u) |
+                                                (audio->realtime ? BIN_AUDIO_REALTIME : 0u));
+}
+
+static void project_get_audio(AudioSettings* audio, const uint8_t* at) {
+    audio->sample_rate = preset_binary_get_u32(at + BIN_AUDIO_SAMPLE_RATE);
+    audio->period_frames = preset_binary_get_u32(at + BIN_AUDIO_PERIOD_FRAMES);
+    audio->periods = preset_binary_get_u32(at + BIN_AUDIO_PERIODS);
+    uint32_t backend = preset_binary_get_u32(at + BIN_AUDIO_BACKEND);
+    audio->backend = backend < AUDIO_BACKEND_COUNT ? (AudioBackend)backend : AUDIO_BACKEND_AUTO;
+    uint32_t flags = preset_binary_get_u32(at + BIN_AUDIO_FLAGS);
+    audio->exclusive = (flags & BIN_AUDIO_EXCLUSIVE) != 0;
+    audio->duplex = (flags & BIN_AUDIO_DUPLEX) != 0;
+    audio->realtime = (flags & BIN_AUDIO_REALTIME) != 0;
+}
+
+bool project_save_binary(const ProjectData* project, const char* path) {
+    if (!project || !path) {
+        return false;
+    }
+    size_t preset_size = preset_binary_size(&project->preset);
+    size_t preset_offset = BIN_HEADER_SIZE + BIN_BODY_SIZE + BIN_AUDIO_SIZE;
+    size_t size = preset_offset + preset_size;
+    uint8_t* buffer = (uint8_t*)calloc(1, size);
+    if (!buffer) {
+        return false;
+    }
+    memcpy(buffer, PROJECT_BINARY_MAGIC, 4);
+    preset_binary_put_u32(buffer + BIN_FORMAT_VERSION, PROJECT_BINARY_VERSION);
+    preset_binary_put_u32(buffer + BIN_PRESET_OFFSET, (uint32_t)preset_offset);
+    preset_binary_put_u32(buffer + BIN_PRESET_SIZE, (uint32_t)preset_size);
+    preset_binary_put_u32(buffer + BIN_TOTAL_SIZE, (uint32_t)size);
+    preset_binary_put_f32(buffer + BIN_EXPORT_DURATION, project->export_duration_seconds);
+    preset_binary_put_f32(buffer + BIN_TEMPO, project->tempo);
+
+    uint8_t* at = buffer + BIN_HEADER_SIZE;
+    preset_binary_put_text(at, sizeof(project->meta.name), project->meta.name);
+    at += sizeof(project->meta.name);
+    preset_binary_put_text(at, sizeof(project->meta.author), project->meta.author);
+    at += sizeof(project->meta.author);
+    preset_binary_put_text(at, sizeof(project->meta.notes), project->meta.notes);
+    at += sizeof(project->meta.notes);
+    preset_binary_put_text(at, sizeof(project->preset_path), project->preset_path);
+    at += sizeof(project->preset_path);
+    preset_binary_put_text(at, sizeof(project->sample_path), project->sample_path);
+    at += sizeof(project->sample_path);
+    preset_binary_put_text(at, sizeof(project->export_path), project->export_path);
+    project_put_audio(buffer + BIN_HEADER_SIZE + BIN_BODY_SIZE, &project->audio);
+    preset_binary_put_u32(buffer + BIN_CHECKSUM,
+                          preset_binary_checksum(buffer + BIN_HEADER_SIZE, BIN_BODY_SIZE + BIN_AUDIO_SIZE));
+
+    bool ok = preset_encode_binary(&project->preset, buffer + preset_offset, preset_size, NULL) &&
+              preset_write_text_file(path, (const char*)buffer, size);
+    free(buffer);
+    return ok;
+}
+
+bool project_decode_binary(ProjectData* project, const uint8_t* data, size_t size) {
+    if (!project || !data || size < BIN_HEADER_SIZE + BIN_BODY_SIZE ||
+        memcmp(data, PROJECT_BINARY_MAGIC, 4) != 0) {
+        return false;
+    }
+    uint32_t format_version = preset_binary_get_u32(data + BIN_FORMAT_VERSION);
+    uint32_t preset_offset = preset_binary_get_u32(data + BIN_PRESET_OFFSET);
+    uint32_t preset_size = preset_binary_get_u32(data + BIN_PRESET_SIZE);
+    uint32_t total_size = preset_binary_get_u32(data + BIN_TOTAL_SIZE);
+    if (format_version == 0 || format_version > PROJECT_BINARY_VERSION) {
+        fprintf(stderr, "❌ Unsupported binary project version %u\n", format_version);
+        return false;
+    }
+    size_t body_size = BIN_BODY_SIZE + (format_version >= 2 ? BIN_AUDIO_SIZE : 0);
+    if (total_size > size || preset_offset < BIN_HEADER_SIZE + body_size ||
+        preset_offset > total_size || preset_size > total_size - preset_offset) {
+        return false;
+    }
+    if (preset_binary_checksum(data + BIN_HEADER_SIZE, body_size) !=
+        preset_binary_get_u32(data + BIN_CHECKSUM)) {
+        fprintf(stderr, "❌ Binary project checksum mismatch\n");
+        return false;
+    }
+
+    project_init(project);
+    if (!preset_decode_binary(&project->preset, data + preset_offset, preset_size)) {
+        return false;
+    }
+    project->export_duration_seconds = preset_binary_get_f32(data + BIN_EXPORT_DURATION);
+    project->tempo = preset_binary_get_f32(data + BIN_TEMPO);
+
+    const uint8_t* at = data + BIN_HEADER_SIZE;
+    preset_binary_get_text(project->meta.name, sizeof(project->meta.name), at, sizeof(project->meta.name));
+    at += sizeof(project->meta.name);
+    preset_binary_get_text(project->meta.author, sizeof(project->meta.author), at, sizeof(project->meta.author));
+    at += sizeof(project->meta.author);
+    preset_binary_get_text(project->meta.notes, sizeof(project->meta.notes), at, sizeof(project->meta.notes));
+    at += sizeof(project->meta.notes);
+    preset_binary_get_text(project->preset_path, sizeof(project->preset_path), at, sizeof(project->preset_path));
+    at += sizeof(project->preset_path);
+    preset_binary_get_text(project->sample_path, sizeof(project->sample_path), at, sizeof(project->sample_path));
+    at += sizeof(project->sample_path);
+    preset_binary_get_text(project->export_path, sizeof(project->export_path), at, sizeof(project->export_path));
+    if (format_version >= 2) {
+        project_get_audio(&project->audio, data + BIN_HEADER_SIZE + BIN_BODY_SIZE);
+    }
+    return true;
+}
+
+bool project_load_binary(ProjectData* project, const char* path) {
+    if (!project || !path) {
+        return false;
+    }
+    long length = 0;
+    char* buffer = preset_read_text_file(path, &length);
+    if (!buffer) {
+        return false;
+    }
+    bool ok = project_decode_binary(project, (const uint8_t*)buffer, (size_t)length);
+    free(buffer);
+    return ok;
+}
@@ -3,12 +3,19 @@
 
 #include <stdbool.h>
 
+#include "audio_settings.h"
 #include "preset.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Binary projects: a fixed header, the metadata and paths, then an embedded
+// binary preset (see preset.h)
+#define PROJECT_BINARY_MAGIC "SYNJ"
+#define PROJECT_BINARY_EXTENSION ".synj"
+#define PROJECT_BINARY_VERSION 2   // 2: audio device settings after the paths
+
 typedef struct {
     char name[64];
     char author[64];
@@ -22,6 +29,7 @@ typedef struct {
     char export_path[512];
     float export_duration_seconds;
     float tempo;
+    AudioSettings audio;      // Device the app asks for when it opens this project
     PresetData preset;
 } ProjectData;
 
@@ -29,7 +37,11 @@ void project_init(ProjectData* project);
 cJSON* project_to_json(const ProjectData* project);
 bool project_from_json(ProjectData* project, const cJSON* json);
 bool project_save_file(const ProjectData* project, const char* path, bool pretty);
+// Loads either encoding; binary files are recognised by their magic
 bool project_load_file(ProjectData* project, const char* path);
+bool project_save_binary(const ProjectData* project, const char* path);
+bool project_load_binary(ProjectData* project, const char* path);
+bool project_decode_binary(ProjectData* project, const uint8_t* data, size_t size);
 
 #ifdef __cplusplus
 }
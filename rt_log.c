@@ -0,0 +1,163 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L   // nanosleep
+#endif
+
+#include "rt_log.h"
+#include "pa_ringbuffer.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+typedef struct {
+    uint8_t level;                 // RtLogLevel
+    char text[RT_LOG_TEXT];
+} RtLogRecord;
+
+static PaUtilRingBuffer g_log_ring;
+static RtLogRecord g_log_buffer[RT_LOG_CAPACITY];
+static atomic_int g_log_ready = 0;
+static atomic_flag g_log_write_lock = ATOMIC_FLAG_INIT;  // Producers only
+static atomic_uint g_log_dropped = 0;
+
+static atomic_int g_writer_running = 0;
+static atomic_int g_writer_stop = 0;
+
+#if defined(_WIN32)
+static HANDLE g_writer_thread = NULL;
+#else
+static pthread_t g_writer_thread;
+#endif
+
+// ============================================================================
+// PRODUCERS
+// ============================================================================
+
+void rt_log_init(void) {
+    atomic_store(&g_log_ready, 0);
+    PaUtil_InitializeRingBuffer(&g_log_ring, sizeof(RtLogRecord), RT_LOG_CAPACITY, g_log_buffer);
+    atomic_store(&g_log_dropped, 0);
+    atomic_store(&g_log_ready, 1);
+}
+
+bool rt_log(RtLogLevel level, const char* format, ...) {
+    if (!format || !atomic_load_explicit(&g_log_ready, memory_order_acquire)) {
+        atomic_fetch_add_explicit(&g_log_dropped, 1u, memory_order_relaxed);
+        return false;
+    }
+
+    // Format before taking the lock so contention only covers the copy
+    RtLogRecord record;
+    record.level = (uint8_t)level;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    // The ring is single-producer; a second producer gives up rather than wait
+    if (atomic_flag_test_and_set_explicit(&g_log_write_lock, memory_order_acquire)) {
+        atomic_fetch_add_explicit(&g_log_dropped, 1u, memory_order_relaxed);
+        return false;
+    }
+    bool written = PaUtil_WriteRingBuffer(&g_log_ring, &record, 1) == 1;
+    atomic_flag_clear_explicit(&g_log_write_lock, memory_order_release);
+    if (!written) {
+        atomic_fetch_add_explicit(&g_log_dropped, 1u, memory_order_relaxed);
+    }
+    return written;
+}
+
+uint32_t rt_log_dropped(void) {
+    return atomic_load_explicit(&g_log_dropped, memory_order_relaxed);
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+size_t rt_log_drain(FILE* out, FILE* err) {
+    if (!atomic_load_explicit(&g_log_ready, memory_order_acquire)) {
+        return 0;
+    }
+    size_t count = 0;
+    RtLogRecord record;
+    while (PaUtil_ReadRingBuffer(&g_log_ring, &record, 1) == 1) {
+        FILE* stream = record.level == RT_LOG_INFO ? out : err;
+        if (stream) {
+            fputs(record.text, stream);
+            fputc('\n', stream);
+        }
+        count++;
+    }
+    if (count > 0) {
+        if (out) fflush(out);
+        if (err && err != out) fflush(err);
+    }
+    return count;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI writer_thread_main(LPVOID arg) {
+#else
+static void* writer_thread_main(void* arg) {
+#endif
+    (void)arg;
+    while (!atomic_load(&g_writer_stop)) {
+        rt_log_drain(stdout, stderr);
+#if defined(_WIN32)
+        Sleep(RT_LOG_POLL_MS);
+#else
+        struct timespec pause = {0, RT_LOG_POLL_MS * 1000000L};
+        nanosleep(&pause, NULL);
+#endif
+    }
+    rt_log_drain(stdout, stderr);
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+bool rt_log_writer_start(void) {
+    if (atomic_load(&g_writer_running)) {
+        return true;
+    }
+    atomic_store(&g_writer_stop, 0);
+#if defined(_WIN32)
+    g_writer_thread = CreateThread(NULL, 0, writer_thread_main, NULL, 0, NULL);
+    if (!g_writer_thread) {
+        fprintf(stderr, "❌ Failed to start log writer thread\n");
+        return false;
+    }
+#else
+    if (pthread_create(&g_writer_thread, NULL, writer_thread_main, NULL) != 0) {
+        fprintf(stderr, "❌ Failed to start log writer thread\n");
+        return false;
+    }
+#endif
+    atomic_store(&g_writer_running, 1);
+    return true;
+}
+
+void rt_log_writer_stop(void) {
+    if (!atomic_load(&g_writer_running)) {
+        return;
+    }
+    atomic_store(&g_writer_stop, 1);
+#if defined(_WIN32)
+    WaitForSingleObject(g_writer_thread, INFINITE);
+    CloseHandle(g_writer_thread);
+    g_writer_thread = NULL;
+#else
+    pthread_join(g_writer_thread, NULL);
+#endif
+    atomic_store(&g_writer_running, 0);
+}
@@ -0,0 +1,64 @@
+/**
+ * Real-time safe logging
+ *
+ * Threads that must not block (the audio callback, the MIDI callback, the
+ * queue-full paths they share with the UI) format a message into a fixed-size
+ * record and push it into a ring buffer. A background writer thread drains
+ * the ring to stdout/stderr, so stdio locks and terminal writes never happen
+ * on those threads.
+ *
+ * Producers never wait. Formatting uses a stack buffer with no allocation,
+ * and the ring is guarded by a try-lock: a record that finds the ring full or
+ * another producer mid-write is dropped and counted (rt_log_dropped()). Text
+ * longer than RT_LOG_TEXT - 1 bytes is truncated.
+ */
+
+#ifndef RT_LOG_H
+#define RT_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_LOG_TEXT 120        // Bytes per record, including the terminator
+#define RT_LOG_CAPACITY 256    // Records; power of two (PaUtilRingBuffer)
+#define RT_LOG_POLL_MS 20      // Writer thread drain interval
+
+typedef enum {
+    RT_LOG_INFO = 0,           // stdout
+    RT_LOG_WARN,               // stderr
+    RT_LOG_ERROR               // stderr
+} RtLogLevel;
+
+// Reset the ring and the drop counter. Call once at startup, before any
+// producer runs; until then every message is dropped and counted.
+void rt_log_init(void);
+
+// Any thread, never blocks. False if the record was dropped.
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((format(printf, 2, 3)))
+#endif
+bool rt_log(RtLogLevel level, const char* format, ...);
+
+// Records dropped since init (ring full, producer contention, no init)
+uint32_t rt_log_dropped(void);
+
+// Single consumer: write every pending record, one per line, info to `out`
+// and warnings/errors to `err`. Returns the number written. Only call this
+// while the writer thread is stopped.
+size_t rt_log_drain(FILE* out, FILE* err);
+
+// Background writer that drains every RT_LOG_POLL_MS; stop drains the rest
+bool rt_log_writer_start(void);
+void rt_log_writer_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RT_LOG_H
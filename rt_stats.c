@@ -0,0 +1,268 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L   // clock_gettime
+#endif
+
+#include "rt_stats.h"
+#include "third_party/cjson/cJSON.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+
+uint64_t rt_stats_now_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// ============================================================================
+// AUDIO THREAD
+// ============================================================================
+
+static void rt_stats_clear(RtStats* stats) {
+    memset(&stats->current, 0, sizeof(stats->current));
+    stats->total_ns = 0;
+    memset(stats->stage_total_ns, 0, sizeof(stats->stage_total_ns));
+    memset(stats->stage_max_ns, 0, sizeof(stats->stage_max_ns));
+    stats->min_ns = UINT64_MAX;
+    stats->max_ns = 0;
+    stats->previous_start_ns = 0;
+}
+
+void rt_stats_init(RtStats* stats, float sample_rate) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->sample_rate = sample_rate > 0.0f ? sample_rate : 44100.0f;
+    rt_stats_clear(stats);
+    atomic_init(&stats->reset_requested, 0);
+    PaUtil_InitializeRingBuffer(&stats->snapshots, sizeof(RtStatsSnapshot),
+                                RT_STATS_SNAPSHOT_QUEUE, stats->snapshot_buffer);
+}
+
+void rt_stats_begin_at(RtStats* stats, uint32_t frames, uint64_t now_ns) {
+    if (atomic_exchange_explicit(&stats->reset_requested, 0, memory_order_acquire)) {
+        rt_stats_clear(stats);
+    }
+    uint64_t budget_ns = (uint64_t)((double)frames * 1e9 / (double)stats->sample_rate);
+    if (stats->previous_start_ns != 0 && budget_ns > 0 &&
+        now_ns - stats->previous_start_ns > budget_ns + budget_ns / 2) {
+        stats->current.late_callbacks++;
+    }
+    stats->previous_start_ns = now_ns;
+    stats->callback_start_ns = now_ns;
+    stats->current.frames = frames;
+    stats->current.budget_us = (double)budget_ns / 1000.0;
+    memset(stats->stage_ns, 0, sizeof(stats->stage_ns));
+}
+
+void rt_stats_begin(RtStats* stats, uint32_t frames) {
+    if (stats) {
+        rt_stats_begin_at(stats, frames, rt_stats_now_ns());
+    }
+}
+
+void rt_stats_add_stage(RtStats* stats, RtStage stage, uint64_t ns) {
+    if (stats && (int)stage >= 0 && stage < RT_STAGE_COUNT) {
+        stats->stage_ns[stage] += ns;
+    }
+}
+
+void rt_stats_set_queue_drops(RtStats* stats, uint32_t param, uint32_t midi, uint32_t seq) {
+    if (stats) {
+        stats->current.param_drops = param;
+        stats->current.midi_drops = midi;
+        stats->current.seq_drops = seq;
+    }
+}
+
+void rt_stats_set_log_drops(RtStats* stats, uint32_t dropped) {
+    if (stats) {
+        stats->current.log_drops = dropped;
+    }
+}
+
+// Mean, p99 and stage figures from the running totals
+static void rt_stats_summarize(const RtStats* stats, RtStatsSnapshot* out) {
+    *out = stats->current;
+    uint64_t count = out->callbacks;
+    if (count == 0) {
+        return;
+    }
+    out->min_us = (double)stats->min_ns / 1000.0;
+    out->max_us = (double)stats->max_ns / 1000.0;
+    out->mean_us = (double)stats->total_ns / 1000.0 / (double)count;
+    for (int s = 0; s < RT_STAGE_COUNT; s++) {
+        out->stage_mean_us[s] = (double)stats->stage_total_ns[s] / 1000.0 / (double)count;
+        out->stage_max_us[s] = (double)stats->stage_max_ns[s] / 1000.0;
+    }
+    uint64_t wanted = count - count / 100; // 99% of callbacks at or below
+    uint64_t seen = 0;
+    for (int b = 0; b < RT_STATS_BUCKETS; b++) {
+        seen += out->histogram[b];
+        if (seen >= wanted) {
+            double edge = (double)((b + 1) * RT_STATS_BUCKET_PERCENT) / 100.0;
+            out->p99_us = b == RT_STATS_BUCKETS - 1 ? out->max_us : edge * out->budget_us;
+            break;
+        }
+    }
+}
+
+void rt_stats_end_at(RtStats* stats, int active_voices, uint64_t now_ns) {
+    uint64_t elapsed = now_ns - stats->callback_start_ns;
+    RtStatsSnapshot* current = &stats->current;
+    current->callbacks++;
+    stats->total_ns += elapsed;
+    if (elapsed < stats->min_ns) stats->min_ns = elapsed;
+    if (elapsed > stats->max_ns) stats->max_ns = elapsed;
+    for (int s = 0; s < RT_STAGE_COUNT; s++) {
+        stats->stage_total_ns[s] += stats->stage_ns[s];
+        if (stats->stage_ns[s] > stats->stage_max_ns[s]) {
+            stats->stage_max_ns[s] = stats->stage_ns[s];
+        }
+    }
+
+    double budget_ns = current->budget_us * 1000.0;
+    int bucket = RT_STATS_BUCKETS - 1;
+    if (budget_ns > 0.0) {
+        double percent = (double)elapsed * 100.0 / budget_ns;
+        int index = (int)(percent / RT_STATS_BUCKET_PERCENT);
+        bucket = index < RT_STATS_BUCKETS - 1 ? index : RT_STATS_BUCKETS - 1;
+        if ((double)elapsed > budget_ns) {
+            current->overruns++;
+        }
+    }
+    current->histogram[bucket]++;
+    current->active_voices = active_voices;
+    if (active_voices > current->peak_voices) {
+        current->peak_voices = active_voices;
+    }
+
+    // A few snapshots a second; if the UI has not caught up, skip this one
+    if (now_ns >= stats->next_publish_ns) {
+        stats->next_publish_ns = now_ns + (uint64_t)RT_STATS_PUBLISH_MS * 1000000ull;
+        if (PaUtil_GetRingBufferWriteAvailable(&stats->snapshots) > 0) {
+            RtStatsSnapshot snapshot;
+            rt_stats_summarize(stats, &snapshot);
+            PaUtil_WriteRingBuffer(&stats->snapshots, &snapshot, 1);
+        }
+    }
+}
+
+void rt_stats_end(RtStats* stats, int active_voices) {
+    if (stats) {
+        rt_stats_end_at(stats, active_voices, rt_stats_now_ns());
+    }
+}
+
+// ============================================================================
+// UI THREAD
+// ============================================================================
+
+bool rt_stats_poll(RtStats* stats, RtStatsSnapshot* out) {
+    if (!stats || !out) {
+        return false;
+    }
+    bool got = false;
+    RtStatsSnapshot snapshot;
+    while (PaUtil_ReadRingBuffer(&stats->snapshots, &snapshot, 1) == 1) {
+        got = true;
+    }
+    if (got) {
+        *out = snapshot;
+    }
+    return got;
+}
+
+void rt_stats_request_reset(RtStats* stats) {
+    if (stats) {
+        atomic_store_explicit(&stats->reset_requested, 1, memory_order_release);
+    }
+}
+
+const char* rt_stage_name(RtStage stage) {
+    switch (stage) {
+        case RT_STAGE_VOICES:   return "voices";
+        case RT_STAGE_FX:       return "fx";
+        case RT_STAGE_TRACKS:   return "tracks";
+        case RT_STAGE_SNIPPETS: return "snippets";
+        default:                return "unknown";
+    }
+}
+
+bool rt_stats_save_json(const RtStatsSnapshot* snapshot, const char* path) {
+    if (!snapshot || !path) {
+        return false;
+    }
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return false;
+    }
+    cJSON_AddNumberToObject(root, "callbacks", (double)snapshot->callbacks);
+    cJSON_AddNumberToObject(root, "frames", snapshot->frames);
+    cJSON_AddNumberToObject(root, "budget_us", snapshot->budget_us);
+    cJSON_AddNumberToObject(root, "min_us", snapshot->min_us);
+    cJSON_AddNumberToObject(root, "mean_us", snapshot->mean_us);
+    cJSON_AddNumberToObject(root, "p99_us", snapshot->p99_us);
+    cJSON_AddNumberToObject(root, "max_us", snapshot->max_us);
+    cJSON_AddNumberToObject(root, "overruns", (double)snapshot->overruns);
+    cJSON_AddNumberToObject(root, "late_callbacks", (double)snapshot->late_callbacks);
+    cJSON_AddNumberToObject(root, "active_voices", snapshot->active_voices);
+    cJSON_AddNumberToObject(root, "peak_voices", snapshot->peak_voices);
+
+    cJSON* drops = cJSON_AddObjectToObject(root, "queue_drops");
+    cJSON_AddNumberToObject(drops, "param", snapshot->param_drops);
+    cJSON_AddNumberToObject(drops, "midi", snapshot->midi_drops);
+    cJSON_AddNumberToObject(drops, "seq", snapshot->seq_drops);
+    cJSON_AddNumberToObject(drops, "log", snapshot->log_drops);
+
+    cJSON* stages = cJSON_AddObjectToObject(root, "stages");
+    for (int s = 0; s < RT_STAGE_COUNT; s++) {
+        cJSON* stage = cJSON_AddObjectToObject(stages, rt_stage_name((RtStage)s));
+        cJSON_AddNumberToObject(stage, "mean_us", snapshot->stage_mean_us[s]);
+        cJSON_AddNumberToObject(stage, "max_us", snapshot->stage_max_us[s]);
+    }
+
+    cJSON* histogram = cJSON_AddObjectToObject(root, "histogram");
+    cJSON_AddNumberToObject(histogram, "bucket_percent", RT_STATS_BUCKET_PERCENT);
+    cJSON* counts = cJSON_AddArrayToObject(histogram, "counts");
+    for (int b = 0; b < RT_STATS_BUCKETS; b++) {
+        cJSON_AddItemToArray(counts, cJSON_CreateNumber(snapshot->histogram[b]));
+    }
+
+    char* text = cJSON_Print(root);
+    cJSON_Delete(root);
+    if (!text) {
+        return false;
+    }
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "❌ Failed to write stats to '%s'\n", path);
+        cJSON_free(text);
+        return false;
+    }
+    bool ok = fputs(text, file) >= 0;
+    fclose(file);
+    cJSON_free(text);
+    return ok;
+}
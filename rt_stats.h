@@ -0,0 +1,114 @@
+/**
+ * Real-time callback instrumentation
+ *
+ * The audio callback times itself and its stages (voices, FX, tracks,
+ * snippets) and records the result here without locks or allocation:
+ * a histogram of callback time against the period budget, min/mean/max,
+ * overruns, voice counts and the queues' and RT log's drop counters. A few times a
+ * second it publishes a snapshot through an SPSC ring; the UI polls the
+ * latest one and can dump it to JSON.
+ *
+ * Overruns are callbacks that took longer than the audio they produced,
+ * which is when the device runs dry. Late callbacks are ones that began
+ * more than 1.5 periods after the previous one, which usually means the
+ * driver dropped a period on its own.
+ */
+
+#ifndef RT_STATS_H
+#define RT_STATS_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pa_ringbuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_STATS_BUCKETS 50          // Callback time histogram...
+#define RT_STATS_BUCKET_PERCENT 4    // ...4% of the budget per bucket; the last also takes overflow
+#define RT_STATS_PUBLISH_MS 250      // Snapshot cadence
+#define RT_STATS_SNAPSHOT_QUEUE 4    // Power of two (PaUtilRingBuffer)
+
+typedef enum {
+    RT_STAGE_VOICES = 0,   // synth_process
+    RT_STAGE_FX,           // fx_rack_process
+    RT_STAGE_TRACKS,       // Voice layer record/playback
+    RT_STAGE_SNIPPETS,     // Preset snippet record/playback
+    RT_STAGE_COUNT
+} RtStage;
+
+typedef struct {
+    uint64_t callbacks;
+    uint64_t overruns;
+    uint64_t late_callbacks;
+    uint32_t frames;             // Last period size
+    double budget_us;            // Last period's length in real time
+    double min_us;
+    double mean_us;
+    double p99_us;               // Upper edge of the p99 histogram bucket
+    double max_us;
+    double stage_mean_us[RT_STAGE_COUNT];
+    double stage_max_us[RT_STAGE_COUNT];
+    int active_voices;
+    int peak_voices;
+    uint32_t param_drops;
+    uint32_t midi_drops;
+    uint32_t seq_drops;
+    uint32_t log_drops;          // rt_log records lost
+    uint32_t histogram[RT_STATS_BUCKETS];
+} RtStatsSnapshot;
+
+typedef struct {
+    // Audio thread
+    float sample_rate;
+    RtStatsSnapshot current;
+    uint64_t callback_start_ns;
+    uint64_t previous_start_ns;
+    uint64_t total_ns;
+    uint64_t stage_ns[RT_STAGE_COUNT];        // This callback
+    uint64_t stage_total_ns[RT_STAGE_COUNT];
+    uint64_t stage_max_ns[RT_STAGE_COUNT];
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t next_publish_ns;
+
+    // UI -> audio
+    atomic_int reset_requested;
+
+    // Audio -> UI
+    PaUtilRingBuffer snapshots;
+    RtStatsSnapshot snapshot_buffer[RT_STATS_SNAPSHOT_QUEUE];
+} RtStats;
+
+void rt_stats_init(RtStats* stats, float sample_rate);
+
+// Monotonic clock for stage timing
+uint64_t rt_stats_now_ns(void);
+
+// Audio thread: bracket each callback; stages are added in between
+void rt_stats_begin(RtStats* stats, uint32_t frames);
+void rt_stats_add_stage(RtStats* stats, RtStage stage, uint64_t ns);
+void rt_stats_set_queue_drops(RtStats* stats, uint32_t param, uint32_t midi, uint32_t seq);
+void rt_stats_set_log_drops(RtStats* stats, uint32_t dropped);
+void rt_stats_end(RtStats* stats, int active_voices);
+
+// Same, with the caller's clock (tests, replays)
+void rt_stats_begin_at(RtStats* stats, uint32_t frames, uint64_t now_ns);
+void rt_stats_end_at(RtStats* stats, int active_voices, uint64_t now_ns);
+
+// UI thread: newest published snapshot, if one arrived since the last poll
+bool rt_stats_poll(RtStats* stats, RtStatsSnapshot* out);
+// UI thread: zero the counters at the start of the next callback
+void rt_stats_request_reset(RtStats* stats);
+
+bool rt_stats_save_json(const RtStatsSnapshot* snapshot, const char* path);
+const char* rt_stage_name(RtStage stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RT_STATS_H
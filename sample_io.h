@@ -1,6 +1,7 @@
 #ifndef SAMPLE_IO_H
 #define SAMPLE_IO_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -18,4 +19,98 @@ bool sample_buffer_write_wav(const char* path, const float* interleaved,
                              uint32_t frame_count, uint32_t channels,
                              uint32_t sample_rate);
 
+// ============================================================================
+// SAMPLE SOURCES
+// ============================================================================
+
+// A playable view of a sample that may not be decoded into RAM:
+// - MEMORY:   an owned SampleBuffer (f32)
+// - MAPPED:   uncompressed 16-bit PCM / 32-bit float WAV memory-mapped
+//             from disk, read in place with no decode or copy
+// - STREAMED: anything else miniaudio decodes (MP3, FLAC, other WAV
+//             encodings). The first SAMPLE_STREAM_HEAD_SECONDS are decoded
+//             at open; the rest is read ahead by the streamer thread.
+//
+// Open/close on the UI thread. sample_source_read_frame is RT-safe;
+// streamed sources must be read sequentially from any frame inside the
+// head (playback starting or looping back), which is how tracks and
+// snippets play.
+
+#define SAMPLE_STREAM_HEAD_SECONDS 2
+#define SAMPLE_STREAM_CHUNK_FRAMES 1024
+#define SAMPLE_STREAM_CHUNKS 64   // Read-ahead: ~1.5 s at 44.1 kHz
+
+typedef enum {
+    SAMPLE_SOURCE_EMPTY = 0,
+    SAMPLE_SOURCE_MEMORY,
+    SAMPLE_SOURCE_MAPPED,
+    SAMPLE_SOURCE_STREAMED
+} SampleSourceKind;
+
+typedef enum {
+    SAMPLE_FORMAT_F32 = 0,
+    SAMPLE_FORMAT_S16
+} SampleFormat;
+
+typedef struct SampleStream SampleStream;
+
+typedef struct SampleSource {
+    SampleSourceKind kind;
+    SampleFormat format;
+    const void* frames;       // Interleaved samples (STREAMED: the f32 head)
+    uint32_t frame_count;
+    uint32_t head_frames;     // STREAMED: frames held in `frames`
+    uint32_t channels;
+    uint32_t sample_rate;
+
+    SampleBuffer owned;       // MEMORY
+    void* map_base;           // MAPPED
+    size_t map_size;
+    void* map_handle;
+    SampleStream* stream;     // STREAMED
+} SampleSource;
+
+void sample_source_init(SampleSource* source);
+
+// Map the file if it is uncompressed 16/32-bit WAV, otherwise stream it
+bool sample_source_open(SampleSource* source, const char* path);
+bool sample_source_open_mapped(SampleSource* source, const char* path);
+bool sample_source_open_streamed(SampleSource* source, const char* path);
+
+// Wrap a decoded buffer; the source takes ownership of its data
+void sample_source_from_buffer(SampleSource* source, SampleBuffer* buffer);
+
+void sample_source_close(SampleSource* source);
+
+// Heap-allocated open/close, for sources handed to the audio thread
+SampleSource* sample_source_create(const char* path);
+void sample_source_destroy(SampleSource* source);
+
+// Read-ahead thread for streamed sources (UI thread start/stop)
+bool sample_streamer_start(void);
+void sample_streamer_stop(void);
+uint64_t sample_source_underruns(const SampleSource* source);
+
+void sample_stream_read_frame_rt(SampleSource* source, uint32_t frame, float* left, float* right);
+
+// RT: stereo frame `frame` (< frame_count); mono sources feed both sides
+static inline void sample_source_read_frame(SampleSource* source, uint32_t frame,
+                                            float* left, float* right) {
+    if (source->kind == SAMPLE_SOURCE_STREAMED) {
+        sample_stream_read_frame_rt(source, frame, left, right);
+        return;
+    }
+    size_t idx = (size_t)frame * source->channels;
+    size_t idx_r = source->channels > 1 ? idx + 1 : idx;
+    if (source->format == SAMPLE_FORMAT_S16) {
+        const int16_t* samples = (const int16_t*)source->frames;
+        *left = (float)samples[idx] * (1.0f / 32768.0f);
+        *right = (float)samples[idx_r] * (1.0f / 32768.0f);
+    } else {
+        const float* samples = (const float*)source->frames;
+        *left = samples[idx];
+        *right = samples[idx_r];
+    }
+}
+
 #endif // SAMPLE_IO_H
@@ -0,0 +1,599 @@
+#include "sample_io.h"
+#include "pa_ringbuffer.h"
+#include "miniaudio.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SAMPLE_STREAM_MAX 32
+#define SAMPLE_STREAMER_POLL_MS 5
+
+// One read-ahead block. Chunks are tagged with the epoch they were decoded
+// for, so the reader can drop stale ones after playback jumps back.
+typedef struct {
+    uint32_t epoch;
+    uint32_t start_frame;
+    uint32_t frames;
+    float samples[]; // frames * channels
+} SampleStreamChunk;
+
+struct SampleStream {
+    // Streamer thread
+    ma_decoder decoder;
+    uint32_t decode_epoch;
+    uint32_t decode_pos;
+
+    PaUtilRingBuffer ring;        // Of SampleStreamChunk, element size chunk_bytes
+    void* ring_storage;
+    size_t chunk_bytes;
+
+    // Audio thread
+    uint32_t rt_epoch;
+    int rt_past_head;               // Has consumed chunks since the last restart
+
+    atomic_uint requested_epoch;
+    atomic_ullong underruns;
+};
+
+// ============================================================================
+// COMMON
+// ============================================================================
+
+void sample_source_init(SampleSource* source) {
+    if (!source) {
+        return;
+    }
+    memset(source, 0, sizeof(*source));
+    sample_buffer_init(&source->owned);
+}
+
+void sample_source_from_buffer(SampleSource* source, SampleBuffer* buffer) {
+    if (!source || !buffer) {
+        return;
+    }
+    sample_source_init(source);
+    source->owned = *buffer;
+    sample_buffer_init(buffer);
+    source->kind = source->owned.data ? SAMPLE_SOURCE_MEMORY : SAMPLE_SOURCE_EMPTY;
+    source->format = SAMPLE_FORMAT_F32;
+    source->frames = source->owned.data;
+    source->frame_count = source->owned.frame_count;
+    source->channels = source->owned.channels;
+    source->sample_rate = source->owned.sample_rate;
+}
+
+bool sample_source_open(SampleSource* source, const char* path) {
+    if (sample_source_open_mapped(source, path)) {
+        return true;
+    }
+    return sample_source_open_streamed(source, path);
+}
+
+// ============================================================================
+// MAPPED WAV
+// ============================================================================
+
+static uint16_t read_u16_le(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32_le(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Find fmt/data in a RIFF WAVE image; only 16-bit PCM and 32-bit float qualify
+static bool wav_find_pcm(const unsigned char* bytes, size_t size, SampleFormat* format,
+                         uint32_t* channels, uint32_t* sample_rate,
+                         size_t* data_offset, size_t* data_size) {
+    if (size < 12 || memcmp(bytes, "RIFF", 4) != 0 || memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool have_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const unsigned char* chunk = bytes + pos;
+        uint32_t chunk_size = read_u32_le(chunk + 4);
+        size_t body = pos + 8;
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && body + 16 <= size) {
+            uint16_t tag = read_u16_le(bytes + body);
+            uint16_t bits = read_u16_le(bytes + body + 14);
+            if (tag == 0xFFFE && chunk_size >= 40 && body + 26 <= size) {
+                tag = read_u16_le(bytes + body + 24); // WAVE_FORMAT_EXTENSIBLE sub-format
+            }
+            *channels = read_u16_le(bytes + body + 2);
+            *sample_rate = read_u32_le(bytes + body + 4);
+            if (tag == 1 && bits == 16) {
+                *format = SAMPLE_FORMAT_S16;
+            } else if (tag == 3 && bits == 32) {
+                *format = SAMPLE_FORMAT_F32;
+            } else {
+                return false;
+            }
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt || *channels == 0) {
+                return false;
+            }
+            *data_offset = body;
+            // A take cut short by a crash may claim more than is there
+            *data_size = (chunk_size == 0 || body + chunk_size > size) ? size - body : chunk_size;
+            return true;
+        }
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+    return false;
+}
+
+static void mapping_release(SampleSource* source) {
+#if defined(_WIN32)
+    if (source->map_base) {
+        UnmapViewOfFile(source->map_base);
+    }
+    if (source->map_handle) {
+        CloseHandle((HANDLE)source->map_handle);
+    }
+#else
+    if (source->map_base) {
+        munmap(source->map_base, source->map_size);
+    }
+#endif
+    source->map_base = NULL;
+    source->map_handle = NULL;
+    source->map_size = 0;
+}
+
+bool sample_source_open_mapped(SampleSource* source, const char* path) {
+    if (!source || !path || path[0] == '\0') {
+        return false;
+    }
+    sample_source_init(source);
+
+#if defined(_WIN32)
+    // FILE_SHARE_DELETE keeps rename/remove of a mapped take working
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    source->map_handle = mapping;
+    source->map_size = (size_t)file_size.QuadPart;
+    source->map_base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!source->map_base) {
+        mapping_release(source);
+        return false;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    source->map_base = base;
+    source->map_size = (size_t)st.st_size;
+#endif
+
+    SampleFormat format = SAMPLE_FORMAT_F32;
+    uint32_t channels = 0;
+    uint32_t sample_rate = 0;
+    size_t data_offset = 0;
+    size_t data_size = 0;
+    const unsigned char* bytes = (const unsigned char*)source->map_base;
+    size_t sample_bytes = 0;
+    bool ok = wav_find_pcm(bytes, source->map_size, &format, &channels, &sample_rate,
+                           &data_offset, &data_size);
+    if (ok) {
+        sample_bytes = format == SAMPLE_FORMAT_S16 ? sizeof(int16_t) : sizeof(float);
+        ok = data_offset % sample_bytes == 0 && data_size >= sample_bytes * channels;
+    }
+    if (!ok) {
+        mapping_release(source); // Not zero-copy readable; caller may stream it
+        return false;
+    }
+
+    size_t frames = data_size / (sample_bytes * channels);
+    source->kind = SAMPLE_SOURCE_MAPPED;
+    source->format = format;
+    source->frames = bytes + data_offset;
+    source->frame_count = frames > UINT32_MAX ? UINT32_MAX : (uint32_t)frames;
+    source->channels = channels;
+    source->sample_rate = sample_rate;
+
+#if !defined(_WIN32)
+    // Start paging the file in now so the audio thread rarely faults
+    madvise(source->map_base, source->map_size, MADV_WILLNEED);
+#endif
+    // Touch the opening pages so playback can start without waiting on disk
+    size_t head_bytes = (size_t)SAMPLE_STREAM_HEAD_SECONDS * sample_rate * channels * sample_bytes;
+    size_t touch_end = data_offset + (head_bytes < data_size ? head_bytes : data_size);
+    volatile unsigned char sink = 0;
+    for (size_t i = data_offset; i < touch_end; i += 4096) {
+        sink ^= bytes[i];
+    }
+    (void)sink;
+    return true;
+}
+
+// ============================================================================
+// STREAMED
+// ============================================================================
+
+static SampleStream* g_streams[SAMPLE_STREAM_MAX];
+static ma_mutex g_streams_lock;
+static atomic_int g_streamer_running = 0;
+static atomic_int g_streamer_stop = 0;
+static atomic_int g_streams_lock_ready = 0;
+
+#if defined(_WIN32)
+static HANDLE g_streamer_thread = NULL;
+#else
+static pthread_t g_streamer_thread;
+#endif
+
+static void streams_lock_init(void) {
+    // Opens and the streamer start both come from the UI thread
+    if (!atomic_load(&g_streams_lock_ready)) {
+        ma_mutex_init(&g_streams_lock);
+        atomic_store(&g_streams_lock_ready, 1);
+    }
+}
+
+// Decode ahead until the ring is full or the file ends
+static void stream_fill(SampleStream* stream, uint32_t frame_count, uint32_t head_frames) {
+    while (1) {
+        uint32_t epoch = atomic_load(&stream->requested_epoch);
+        if (epoch != stream->decode_epoch) {
+            // Playback went back into the head; resume right after it
+            stream->decode_epoch = epoch;
+            stream->decode_pos = head_frames;
+            ma_decoder_seek_to_pcm_frame(&stream->decoder, head_frames);
+        }
+        if (stream->decode_pos >= frame_count) {
+            return;
+        }
+        void* region1 = NULL;
+        void* region2 = NULL;
+        ring_buffer_size_t size1 = 0;
+        ring_buffer_size_t size2 = 0;
+        if (PaUtil_GetRingBufferWriteRegions(&stream->ring, 1, &region1, &size1, &region2, &size2) < 1) {
+            return;
+        }
+        SampleStreamChunk* chunk = (SampleStreamChunk*)region1;
+        uint32_t want = frame_count - stream->decode_pos;
+        if (want > SAMPLE_STREAM_CHUNK_FRAMES) {
+            want = SAMPLE_STREAM_CHUNK_FRAMES;
+        }
+        ma_uint64 read = 0;
+        ma_decoder_read_pcm_frames(&stream->decoder, chunk->samples, want, &read);
+        if (read == 0) {
+            stream->decode_pos = frame_count; // Shorter than reported; stop here
+            return;
+        }
+        chunk->epoch = stream->decode_epoch;
+        chunk->start_frame = stream->decode_pos;
+        chunk->frames = (uint32_t)read;
+        PaUtil_AdvanceRingBufferWriteIndex(&stream->ring, 1);
+        stream->decode_pos += (uint32_t)read;
+    }
+}
+
+// The registry holds the SampleSource fields the streamer needs alongside
+// each stream, copied at open so the thread never touches UI-owned structs
+typedef struct {
+    uint32_t frame_count;
+    uint32_t head_frames;
+} SampleStreamShape;
+
+static SampleStreamShape g_shapes[SAMPLE_STREAM_MAX];
+
+static void streamer_pass(void) {
+    ma_mutex_lock(&g_streams_lock);
+    for (int i = 0; i < SAMPLE_STREAM_MAX; ++i) {
+        if (g_streams[i]) {
+            stream_fill(g_streams[i], g_shapes[i].frame_count, g_shapes[i].head_frames);
+        }
+    }
+    ma_mutex_unlock(&g_streams_lock);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI streamer_thread_main(LPVOID arg) {
+#else
+static void* streamer_thread_main(void* arg) {
+#endif
+    (void)arg;
+    while (!atomic_load(&g_streamer_stop)) {
+        streamer_pass();
+#if defined(_WIN32)
+        Sleep(SAMPLE_STREAMER_POLL_MS);
+#else
+        usleep(SAMPLE_STREAMER_POLL_MS * 1000U);
+#endif
+    }
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+bool sample_streamer_start(void) {
+    if (atomic_load(&g_streamer_running)) {
+        return true;
+    }
+    streams_lock_init();
+    atomic_store(&g_streamer_stop, 0);
+#if defined(_WIN32)
+    g_streamer_thread = CreateThread(NULL, 0, streamer_thread_main, NULL, 0, NULL);
+    if (!g_streamer_thread) {
+        fprintf(stderr, "❌ Failed to start sample streamer thread\n");
+        return false;
+    }
+#else
+    if (pthread_create(&g_streamer_thread, NULL, streamer_thread_main, NULL) != 0) {
+        fprintf(stderr, "❌ Failed to start sample streamer thread\n");
+        return false;
+    }
+#endif
+    atomic_store(&g_streamer_running, 1);
+    return true;
+}
+
+void sample_streamer_stop(void) {
+    if (!atomic_load(&g_streamer_running)) {
+        return;
+    }
+    atomic_store(&g_streamer_stop, 1);
+#if defined(_WIN32)
+    WaitForSingleObject(g_streamer_thread, INFINITE);
+    CloseHandle(g_streamer_thread);
+    g_streamer_thread = NULL;
+#else
+    pthread_join(g_streamer_thread, NULL);
+#endif
+    atomic_store(&g_streamer_running, 0);
+}
+
+static void stream_destroy(SampleStream* stream) {
+    if (!stream) {
+        return;
+    }
+    ma_decoder_uninit(&stream->decoder);
+    free(stream->ring_storage);
+    free(stream);
+}
+
+bool sample_source_open_streamed(SampleSource* source, const char* path) {
+    if (!source || !path || path[0] == '\0') {
+        return false;
+    }
+    sample_source_init(source);
+    streams_lock_init();
+
+    SampleStream* stream = (SampleStream*)calloc(1, sizeof(SampleStream));
+    if (!stream) {
+        return false;
+    }
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+    ma_result result = ma_decoder_init_file(path, &config, &stream->decoder);
+    if (result != MA_SUCCESS) {
+        fprintf(stderr, "❌ Failed to open sample '%s' (error %d)\n", path, result);
+        free(stream);
+        return false;
+    }
+
+    ma_uint64 length = 0;
+    uint32_t channels = stream->decoder.outputChannels;
+    uint32_t sample_rate = stream->decoder.outputSampleRate;
+    if (ma_decoder_get_length_in_pcm_frames(&stream->decoder, &length) != MA_SUCCESS ||
+        length == 0 || channels == 0) {
+        fprintf(stderr, "❌ Unable to determine sample length for '%s'\n", path);
+        ma_decoder_uninit(&stream->decoder);
+        free(stream);
+        return false;
+    }
+    if (length > UINT32_MAX) {
+        length = UINT32_MAX;
+    }
+
+    // Head: decoded now, so playback (and every loop restart) begins instantly
+    uint64_t head_target = (uint64_t)SAMPLE_STREAM_HEAD_SECONDS * (sample_rate ? sample_rate : 44100);
+    uint32_t head_frames = (uint32_t)(head_target < length ? head_target : length);
+    float* head = (float*)malloc((size_t)head_frames * channels * sizeof(float));
+    stream->chunk_bytes = sizeof(SampleStreamChunk) + (size_t)SAMPLE_STREAM_CHUNK_FRAMES * channels * sizeof(float);
+    stream->ring_storage = malloc(stream->chunk_bytes * SAMPLE_STREAM_CHUNKS);
+    if (!head || !stream->ring_storage) {
+        free(head);
+        stream_destroy(stream);
+        return false;
+    }
+    ma_uint64 head_read = 0;
+    ma_decoder_read_pcm_frames(&stream->decoder, head, head_frames, &head_read);
+    if (head_read == 0) {
+        fprintf(stderr, "❌ No audio frames read from '%s'\n", path);
+        free(head);
+        stream_destroy(stream);
+        return false;
+    }
+    if (head_read < head_frames) {
+        head_frames = (uint32_t)head_read;
+        length = head_read;
+    }
+    PaUtil_InitializeRingBuffer(&stream->ring, (ring_buffer_size_t)stream->chunk_bytes,
+                                SAMPLE_STREAM_CHUNKS, stream->ring_storage);
+    stream->decode_pos = head_frames;
+
+    source->kind = SAMPLE_SOURCE_STREAMED;
+    source->format = SAMPLE_FORMAT_F32;
+    source->frames = head;
+    source->frame_count = (uint32_t)length;
+    source->head_frames = head_frames;
+    source->channels = channels;
+    source->sample_rate = sample_rate;
+    source->stream = stream;
+
+    if (head_frames >= source->frame_count) {
+        return true; // Fits in the head; nothing to stream
+    }
+    ma_mutex_lock(&g_streams_lock);
+    int slot = -1;
+    for (int i = 0; i < SAMPLE_STREAM_MAX; ++i) {
+        if (!g_streams[i]) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot >= 0) {
+        g_shapes[slot].frame_count = source->frame_count;
+        g_shapes[slot].head_frames = head_frames;
+        stream_fill(stream, source->frame_count, head_frames); // Prime the read-ahead
+        g_streams[slot] = stream;
+    }
+    ma_mutex_unlock(&g_streams_lock);
+    if (slot < 0) {
+        fprintf(stderr, "⚠️ Too many streamed samples; '%s' plays its first %u s only\n",
+                path, (unsigned)SAMPLE_STREAM_HEAD_SECONDS);
+        source->frame_count = head_frames;
+    }
+    return true;
+}
+
+void sample_stream_read_frame_rt(SampleSource* source, uint32_t frame, float* left, float* right) {
+    SampleStream* stream = source->stream;
+    uint32_t channels = source->channels;
+    if (frame < source->head_frames) {
+        if (stream->rt_past_head) {
+            // Jumped back: invalidate the read-ahead and have it refilled
+            // from the end of the head while the head plays
+            stream->rt_epoch++;
+            atomic_store(&stream->requested_epoch, stream->rt_epoch);
+            PaUtil_AdvanceRingBufferReadIndex(&stream->ring, PaUtil_GetRingBufferReadAvailable(&stream->ring));
+            stream->rt_past_head = 0;
+        }
+        const float* head = (const float*)source->frames;
+        size_t idx = (size_t)frame * channels;
+        *left = head[idx];
+        *right = channels > 1 ? head[idx + 1] : head[idx];
+        return;
+    }
+
+    stream->rt_past_head = 1;
+    while (1) {
+        void* region1 = NULL;
+        void* region2 = NULL;
+        ring_buffer_size_t size1 = 0;
+        ring_buffer_size_t size2 = 0;
+        if (PaUtil_GetRingBufferReadRegions(&stream->ring, 1, &region1, &size1, &region2, &size2) < 1) {
+            break;
+        }
+        const SampleStreamChunk* chunk = (SampleStreamChunk*)region1;
+        if (chunk->epoch != stream->rt_epoch || frame >= chunk->start_frame + chunk->frames) {
+            PaUtil_AdvanceRingBufferReadIndex(&stream->ring, 1); // Stale or already played
+            continue;
+        }
+        if (frame < chunk->start_frame) {
+            break;
+        }
+        size_t idx = (size_t)(frame - chunk->start_frame) * channels;
+        *left = chunk->samples[idx];
+        *right = channels > 1 ? chunk->samples[idx + 1] : chunk->samples[idx];
+        if (frame + 1 == chunk->start_frame + chunk->frames) {
+            PaUtil_AdvanceRingBufferReadIndex(&stream->ring, 1);
+        }
+        return;
+    }
+    // Read-ahead fell behind: play silence rather than wait
+    atomic_fetch_add(&stream->underruns, 1);
+    *left = 0.0f;
+    *right = 0.0f;
+}
+
+uint64_t sample_source_underruns(const SampleSource* source) {
+    if (!source || source->kind != SAMPLE_SOURCE_STREAMED || !source->stream) {
+        return 0;
+    }
+    return atomic_load(&source->stream->underruns);
+}
+
+// ============================================================================
+// CLOSE
+// ============================================================================
+
+void sample_source_close(SampleSource* source) {
+    if (!source) {
+        return;
+    }
+    switch (source->kind) {
+        case SAMPLE_SOURCE_MEMORY:
+            sample_buffer_free(&source->owned);
+            break;
+        case SAMPLE_SOURCE_MAPPED:
+            mapping_release(source);
+            break;
+        case SAMPLE_SOURCE_STREAMED:
+            // Unregister under the lock so the streamer is not mid-decode
+            ma_mutex_lock(&g_streams_lock);
+            for (int i = 0; i < SAMPLE_STREAM_MAX; ++i) {
+                if (g_streams[i] == source->stream) {
+                    g_streams[i] = NULL;
+                }
+            }
+            ma_mutex_unlock(&g_streams_lock);
+            stream_destroy(source->stream);
+            free((void*)source->frames);
+            break;
+        default:
+            break;
+    }
+    sample_source_init(source);
+}
+
+SampleSource* sample_source_create(const char* path) {
+    SampleSource* source = (SampleSource*)malloc(sizeof(SampleSource));
+    if (!source) {
+        return NULL;
+    }
+    if (!sample_source_open(source, path)) {
+        free(source);
+        return NULL;
+    }
+    return source;
+}
+
+void sample_source_destroy(SampleSource* source) {
+    if (!source) {
+        return;
+    }
+    sample_source_close(source);
+    free(source);
+}
@@ -0,0 +1,455 @@
+#include "sequencer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// ARPEGGIATOR
+// ============================================================================
+
+void arp_init(Arpeggiator* arp) {
+    memset(arp, 0, sizeof(Arpeggiator));
+    arp->rate = ARP_BASE_RATE;  // Eighth notes
+    arp->gate = 0.8f;
+    arp->mode = ARP_UP;
+    arp->direction = 1;
+    arp->sounding_note = -1;
+    arp->rng_state = SYNTH_DEFAULT_SEED;
+}
+
+void arp_set_seed(Arpeggiator* arp, uint32_t seed) {
+    if (arp) {
+        arp->rng_state = seed;
+    }
+}
+
+void arp_set_enabled(Arpeggiator* arp, bool enabled) {
+    if (!enabled) {
+        // The sounding note still gets its note-off from the next arp_process
+        arp->num_held = 0;
+        arp->position = 0;
+    }
+    arp->enabled = enabled;
+}
+
+void arp_note_on(Arpeggiator* arp, int note) {
+    if (note < 0 || note > 127) {
+        return;
+    }
+    for (int i = 0; i < arp->num_held; i++) {
+        if (arp->held_notes[i] == note) {
+            return;
+        }
+    }
+    if (arp->num_held < ARP_MAX_NOTES) {
+        arp->held_notes[arp->num_held++] = note;
+    }
+}
+
+void arp_note_off(Arpeggiator* arp, int note) {
+    for (int i = 0; i < arp->num_held; i++) {
+        if (arp->held_notes[i] == note) {
+            for (int j = i; j < arp->num_held - 1; j++) {
+                arp->held_notes[j] = arp->held_notes[j + 1];
+            }
+            arp->num_held--;
+            // Keep the playhead on the note that followed the removed one
+            if (i < arp->position) {
+                arp->position--;
+            }
+            if (arp->position >= arp->num_held) {
+                arp->position = arp->num_held > 0 ? arp->num_held - 1 : 0;
+            }
+            break;
+        }
+    }
+}
+
+bool arp_play_event(const SeqEvent* event, void* synth) {
+    SynthEngine* engine = (SynthEngine*)synth;
+    if (event->velocity == 0) {
+        synth_note_off(engine, event->note);
+    } else {
+        synth_note_on(engine, event->note, (float)event->velocity / 127.0f);
+    }
+    return true;
+}
+
+static uint64_t arp_grid_frame(const Arpeggiator* arp, uint64_t steps) {
+    return arp->anchor_frame + (uint64_t)((double)steps * arp->frames_per_step + 0.5);
+}
+
+uint64_t arp_next_event_frame(const Arpeggiator* arp) {
+    if (!arp || !arp->running) {
+        return UINT64_MAX;
+    }
+    uint64_t next = arp_grid_frame(arp, arp->steps_from_anchor);
+    if (arp->sounding_note >= 0 && arp->note_off_frame < next) {
+        next = arp->note_off_frame;
+    }
+    return next;
+}
+
+// Note for the coming step; moves the playhead on for the one after
+static int arp_pick_note(Arpeggiator* arp) {
+    int n = arp->num_held;
+    if (arp->position >= n) {
+        arp->position = n - 1;
+    }
+    int index = arp->position;
+    switch (arp->mode) {
+        case ARP_DOWN:
+            arp->position = (index - 1 + n) % n;
+            break;
+        case ARP_UP_DOWN:
+            if (n > 1) {
+                if (index + arp->direction < 0 || index + arp->direction >= n) {
+                    arp->direction = -arp->direction;
+                }
+                arp->position = index + arp->direction;
+            }
+            break;
+        case ARP_RANDOM:
+            index = (int)(synth_rng_float(&arp->rng_state) * (float)n);
+            break;
+        case ARP_UP:
+        default:
+            arp->position = (index + 1) % n;
+            break;
+    }
+    return arp->held_notes[index];
+}
+
+static bool arp_emit(sequencer_emit_fn emit, void* userdata, uint64_t frame, int note,
+                     uint8_t velocity, uint32_t length_frames) {
+    SeqEvent event;
+    event.sample_frame = frame;
+    event.note = (uint8_t)note;
+    event.velocity = velocity;
+    event.length_frames = length_frames;
+    return emit(&event, userdata);
+}
+
+int arp_process(Arpeggiator* arp, uint64_t now, float sample_rate, double tempo,
+                sequencer_emit_fn emit, void* userdata) {
+    if (!arp || !emit) {
+        return 0;
+    }
+    int emitted = 0;
+
+    // Disabled or nothing held: end the sounding note now and idle
+    if (!arp->enabled || arp->num_held == 0 || arp->rate <= 0.0f || tempo <= 0.0 || sample_rate <= 0.0f) {
+        if (arp->sounding_note >= 0) {
+            if (!arp_emit(emit, userdata, now, arp->sounding_note, 0, 0)) {
+                return 0;
+            }
+            arp->sounding_note = -1;
+            emitted++;
+        }
+        arp->running = false;
+        return emitted;
+    }
+
+    double frames_per_step = (double)sample_rate * 60.0 / tempo / (double)arp->rate;
+    if (!arp->running) {
+        arp->running = true;
+        arp->anchor_frame = now;
+        arp->steps_from_anchor = 0;
+        arp->frames_per_step = frames_per_step;
+        arp->direction = 1;
+        arp->position = arp->mode == ARP_DOWN ? arp->num_held - 1 : 0;
+    } else if (frames_per_step != arp->frames_per_step) {
+        // Re-anchor on the next step so the new rate starts there
+        arp->anchor_frame = arp_grid_frame(arp, arp->steps_from_anchor);
+        arp->steps_from_anchor = 0;
+        arp->frames_per_step = frames_per_step;
+    }
+
+    for (;;) {
+        uint64_t step_frame = arp_grid_frame(arp, arp->steps_from_anchor);
+        if (arp->sounding_note >= 0 && arp->note_off_frame <= step_frame && arp->note_off_frame <= now) {
+            if (!arp_emit(emit, userdata, arp->note_off_frame, arp->sounding_note, 0, 0)) {
+                break;
+            }
+            arp->sounding_note = -1;
+            emitted++;
+            continue;
+        }
+        if (step_frame > now) {
+            break;
+        }
+        if (arp->sounding_note >= 0) {
+            // Legato: the last note ends exactly as the next begins
+            if (!arp_emit(emit, userdata, step_frame, arp->sounding_note, 0, 0)) {
+                break;
+            }
+            arp->sounding_note = -1;
+            emitted++;
+        }
+        uint64_t step_length = arp_grid_frame(arp, arp->steps_from_anchor + 1) - step_frame;
+        float gate = arp->gate < 0.0f ? 0.0f : (arp->gate > 1.0f ? 1.0f : arp->gate);
+        uint64_t gate_frames = (uint64_t)((double)gate * (double)step_length + 0.5);
+        if (gate_frames < 1) gate_frames = 1;
+        int position = arp->position;
+        int direction = arp->direction;
+        uint32_t rng_state = arp->rng_state;
+        int note = arp_pick_note(arp);
+        if (!arp_emit(emit, userdata, step_frame, note, 102, (uint32_t)gate_frames)) { // 0.8 velocity
+            arp->position = position; // Replay this step next call
+            arp->direction = direction;
+            arp->rng_state = rng_state;
+            break;
+        }
+        arp->sounding_note = note;
+        arp->note_off_frame = step_frame + gate_frames;
+        arp->steps_from_anchor++;
+        emitted++;
+    }
+    return emitted;
+}
+
+// ============================================================================
+// SEQUENCER
+// ============================================================================
+
+void sequencer_init(Sequencer* seq) {
+    memset(seq, 0, sizeof(Sequencer));
+    seq->loop_enabled = true;
+    seq->loop_start = 0;
+    seq->loop_end = 15;
+
+    // Initialize patterns
+    for (int i = 0; i < MAX_PATTERNS; i++) {
+        snprintf(seq->patterns[i].name, sizeof(seq->patterns[i].name), "Pattern %d", i + 1);
+        seq->patterns[i].length = 16;
+        seq->patterns[i].swing = 0.5f;
+
+        // Initialize all steps as inactive
+        for (int j = 0; j < STEPS_PER_PATTERN; j++) {
+            seq->patterns[i].steps[j].note = -1;
+            seq->patterns[i].steps[j].velocity = 0.8f;
+            seq->patterns[i].steps[j].length = 1;
+            seq->patterns[i].steps[j].active = false;
+        }
+    }
+    for (int j = 0; j < STEPS_PER_PATTERN; j++) {
+        seq->sounding_notes[j] = -1;
+    }
+}
+
+static void sequencer_note_on(Arpeggiator* arp, SynthEngine* synth, int note, float velocity) {
+    if (arp && arp->enabled) {
+        arp_note_on(arp, note);
+    } else {
+        synth_note_on(synth, note, velocity);
+    }
+}
+
+static void sequencer_note_off(Arpeggiator* arp, SynthEngine* synth, int note) {
+    if (arp && arp->enabled) {
+        arp_note_off(arp, note);
+    } else {
+        synth_note_off(synth, note);
+    }
+}
+
+void sequencer_dispatch(const SeqEvent* event, Arpeggiator* arp, SynthEngine* synth) {
+    if (!event || !synth) {
+        return;
+    }
+    if (event->velocity == 0) {
+        sequencer_note_off(arp, synth, event->note);
+    } else {
+        sequencer_note_on(arp, synth, event->note, (float)event->velocity / 127.0f);
+    }
+}
+
+// Inclusive step range the playhead cycles through
+static void sequencer_step_range(const Sequencer* seq, int* first, int* last) {
+    const Pattern* pattern = &seq->patterns[seq->current_pattern];
+    int end = pattern->length > 0 ? pattern->length - 1 : 0;
+    if (end >= STEPS_PER_PATTERN) {
+        end = STEPS_PER_PATTERN - 1;
+    }
+    *first = 0;
+    *last = end;
+    if (seq->loop_enabled) {
+        int start = seq->loop_start < 0 ? 0 : seq->loop_start;
+        int stop = seq->loop_end < end ? seq->loop_end : end;
+        if (start <= stop) {
+            *first = start;
+            *last = stop;
+        }
+    }
+}
+
+void sequencer_start(Sequencer* seq, uint64_t frame) {
+    seq->chain_pos = 0;
+    if (seq->chain_length > 0) {
+        seq->current_pattern = seq->chain[0];
+    }
+    int first = 0;
+    int last = 0;
+    sequencer_step_range(seq, &first, &last);
+    seq->current_step = first;
+    seq->anchor_frame = frame;
+    seq->steps_from_anchor = 0;
+    seq->frames_per_step = 0.0; // Taken from the first schedule call
+    seq->playing = true;
+}
+
+void sequencer_stop(Sequencer* seq, Arpeggiator* arp, SynthEngine* synth) {
+    for (int slot = 0; slot < STEPS_PER_PATTERN; slot++) {
+        if (seq->sounding_notes[slot] >= 0) {
+            sequencer_note_off(arp, synth, seq->sounding_notes[slot]);
+            seq->sounding_notes[slot] = -1;
+        }
+    }
+    seq->playing = false;
+}
+
+bool sequencer_set_chain(Sequencer* seq, const int* patterns, int count) {
+    if (!seq || (!patterns && count > 0) || count < 0 || count > MAX_PATTERNS) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (patterns[i] < 0 || patterns[i] >= MAX_PATTERNS) {
+            return false;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        seq->chain[i] = patterns[i];
+    }
+    seq->chain_length = count;
+    if (seq->chain_pos >= count) {
+        seq->chain_pos = 0;
+    }
+    return true;
+}
+
+static uint64_t sequencer_grid_frame(const Sequencer* seq, uint64_t steps) {
+    return seq->anchor_frame + (uint64_t)((double)steps * seq->frames_per_step + 0.5);
+}
+
+// Swung frame of current_step: odd steps move by (swing - 0.5) of a step
+static uint64_t sequencer_step_frame(const Sequencer* seq) {
+    uint64_t frame = sequencer_grid_frame(seq, seq->steps_from_anchor);
+    if (seq->current_step & 1) {
+        double swing = (double)seq->patterns[seq->current_pattern].swing;
+        double offset = (swing - 0.5) * seq->frames_per_step;
+        int64_t shift = (int64_t)(offset < 0.0 ? offset - 0.5 : offset + 0.5);
+        frame = shift < 0 && (uint64_t)(-shift) > frame ? 0 : (uint64_t)((int64_t)frame + shift);
+    }
+    return frame;
+}
+
+// Move the playhead past current_step: next step, loop, chain or stop
+static void sequencer_advance(Sequencer* seq) {
+    int first = 0;
+    int last = 0;
+    sequencer_step_range(seq, &first, &last);
+    seq->steps_from_anchor++;
+    if (seq->current_step < last) {
+        seq->current_step++;
+        return;
+    }
+    if (seq->chain_length > 0) {
+        if (++seq->chain_pos >= seq->chain_length) {
+            seq->chain_pos = 0;
+            if (!seq->loop_enabled) {
+                seq->playing = false; // Sounding notes still release on time
+                return;
+            }
+        }
+        seq->current_pattern = seq->chain[seq->chain_pos];
+        sequencer_step_range(seq, &first, &last);
+    } else if (!seq->loop_enabled) {
+        seq->playing = false;
+        return;
+    }
+    seq->current_step = first;
+}
+
+// Step velocity (0-1) as a note-on velocity; never 0, which means note off
+static uint8_t sequencer_velocity(float velocity) {
+    int level = (int)(velocity * 127.0f + 0.5f);
+    return (uint8_t)(level < 1 ? 1 : (level > 127 ? 127 : level));
+}
+
+static bool sequencer_emit(sequencer_emit_fn emit, void* userdata, uint64_t frame,
+                           int note, uint8_t velocity, uint32_t length_frames) {
+    SeqEvent event;
+    event.sample_frame = frame;
+    event.note = (uint8_t)note;
+    event.velocity = velocity;
+    event.length_frames = length_frames;
+    return emit(&event, userdata);
+}
+
+int sequencer_schedule(Sequencer* seq, uint64_t until, float sample_rate, double tempo,
+                       sequencer_emit_fn emit, void* userdata) {
+    if (!seq || !emit || sample_rate <= 0.0f) {
+        return 0;
+    }
+    if (tempo > 0.0) {
+        double frames_per_step = (double)sample_rate * 60.0 / tempo / SEQUENCER_STEPS_PER_BEAT;
+        if (frames_per_step != seq->frames_per_step) {
+            if (seq->frames_per_step > 0.0) {
+                // Re-anchor on the next unscheduled step so the new tempo starts there
+                seq->anchor_frame = sequencer_grid_frame(seq, seq->steps_from_anchor);
+                seq->steps_from_anchor = 0;
+            }
+            seq->frames_per_step = frames_per_step;
+        }
+    }
+    bool running = seq->playing && seq->frames_per_step > 0.0;
+
+    int emitted = 0;
+    for (;;) {
+        int off_slot = -1;
+        uint64_t off_frame = UINT64_MAX;
+        for (int slot = 0; slot < STEPS_PER_PATTERN; slot++) {
+            if (seq->sounding_notes[slot] >= 0 && seq->note_off_frames[slot] < off_frame) {
+                off_slot = slot;
+                off_frame = seq->note_off_frames[slot];
+            }
+        }
+        uint64_t on_frame = running && seq->playing ? sequencer_step_frame(seq) : UINT64_MAX;
+
+        if (off_slot >= 0 && off_frame <= on_frame && off_frame < until) {
+            if (!sequencer_emit(emit, userdata, off_frame, seq->sounding_notes[off_slot], 0, 0)) {
+                break;
+            }
+            seq->sounding_notes[off_slot] = -1;
+            emitted++;
+            continue;
+        }
+        if (on_frame >= until) {
+            break;
+        }
+
+        int index = seq->current_step;
+        const SequencerStep* step = &seq->patterns[seq->current_pattern].steps[index];
+        if (step->active && step->note >= 0 && step->note <= 127) {
+            if (seq->sounding_notes[index] >= 0) {
+                // The slot's previous note is still held: cut it at this step
+                if (!sequencer_emit(emit, userdata, on_frame, seq->sounding_notes[index], 0, 0)) {
+                    break;
+                }
+                seq->sounding_notes[index] = -1;
+                emitted++;
+            }
+            int length = step->length < 1 ? 1 : (step->length > STEPS_PER_PATTERN ? STEPS_PER_PATTERN : step->length);
+            uint64_t off = sequencer_grid_frame(seq, seq->steps_from_anchor + (uint64_t)length) -
+                           sequencer_grid_frame(seq, seq->steps_from_anchor) + on_frame;
+            if (!sequencer_emit(emit, userdata, on_frame, step->note, sequencer_velocity(step->velocity), (uint32_t)(off - on_frame))) {
+                break;
+            }
+            seq->sounding_notes[index] = step->note;
+            seq->note_off_frames[index] = off;
+            emitted++;
+        }
+        sequencer_advance(seq);
+    }
+    return emitted;
+}
@@ -0,0 +1,147 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "synth_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Scheduled note events (SeqEvent, velocity 0 = note off) go to a sink in
+// frame order; false = no room, the event (and everything after it) is
+// offered again on the next call
+typedef bool (*sequencer_emit_fn)(const SeqEvent* event, void* userdata);
+
+// ============================================================================
+// ARPEGGIATOR
+// ============================================================================
+
+// `enabled` turns the arp off. Modes start at 1, the values presets store;
+// a stored 0 (an old "off" mode) plays as ARP_UP.
+typedef enum { ARP_UP = 1, ARP_DOWN, ARP_UP_DOWN, ARP_RANDOM } ArpMode;
+
+#define ARP_MAX_NOTES 128   // One slot per MIDI note, so a press is never dropped
+#define ARP_BASE_RATE 2.0f  // Default steps per beat; presets store a multiple of it
+
+// Event generator on the engine's frame clock. Step k sounds at
+// anchor_frame + round(k * frames_per_step), where the anchor is the frame
+// the first note was held (or the last rate/tempo change). The gate only
+// sets when each note ends; it never moves the next step.
+typedef struct {
+    bool enabled;
+    ArpMode mode;
+    float rate;           // Steps per beat (1=quarter, 2=eighth, 4=sixteenth)
+    float gate;           // 0-1 of a step (1 = legato)
+    int held_notes[ARP_MAX_NOTES]; // Distinct notes, in press order
+    int num_held;
+    int position;         // Index into held_notes the next step plays
+    int direction;        // ARP_UP_DOWN: +1 or -1
+    uint32_t rng_state;   // ARP_RANDOM picks (per instance, reproducible)
+
+    bool running;
+    uint64_t anchor_frame;
+    uint64_t steps_from_anchor;
+    double frames_per_step;
+    int sounding_note;    // -1 = none
+    uint64_t note_off_frame;
+} Arpeggiator;
+
+void arp_init(Arpeggiator* arp);
+// ARP_RANDOM draws from the engine's LCG (synth_rng_float) seeded here
+void arp_set_seed(Arpeggiator* arp, uint32_t seed);
+// Disabling forgets the held notes, so re-enabling starts from an empty set
+void arp_set_enabled(Arpeggiator* arp, bool enabled);
+void arp_note_on(Arpeggiator* arp, int note);
+void arp_note_off(Arpeggiator* arp, int note);
+
+// Emit every arp note on/off due at or before `now`, stamped with its exact
+// frame. Call at each sub-block start after that frame's input is applied;
+// newly held notes start the clock at `now`.
+int arp_process(Arpeggiator* arp, uint64_t now, float sample_rate, double tempo,
+                sequencer_emit_fn emit, void* userdata);
+// Frame of the arp's next event (UINT64_MAX when idle), for splitting the block
+uint64_t arp_next_event_frame(const Arpeggiator* arp);
+// Sink that plays an event on the SynthEngine passed as userdata
+bool arp_play_event(const SeqEvent* event, void* synth);
+
+// ============================================================================
+// SEQUENCER & PATTERN SYSTEM
+// ============================================================================
+
+#define MAX_PATTERNS 16
+#define STEPS_PER_PATTERN 16
+#define SEQUENCER_STEPS_PER_BEAT 4   // Steps are sixteenth notes
+
+typedef struct {
+    int note;           // MIDI note number (0-127, -1 = no note)
+    float velocity;     // 0.0-1.0
+    int length;         // Step length (1-16)
+    bool active;        // Is this step active?
+} SequencerStep;
+
+typedef struct {
+    char name[32];
+    SequencerStep steps[STEPS_PER_PATTERN];
+    int length;         // Pattern length in steps (1-16)
+    float swing;        // 0.0-1.0 (0.5 = straight; offbeat steps move by up to half a step)
+} Pattern;
+
+// The clock runs in engine sample frames. Each step's frame is computed
+// from the step count since an anchor (the start, or the last tempo
+// change), never accumulated, so a long set does not drift. Steps are
+// scheduled ahead as timestamped SeqEvents (velocity 0 = note off); the
+// caller queues them and applies each on its frame with sequencer_dispatch().
+typedef struct {
+    Pattern patterns[MAX_PATTERNS];
+    int current_pattern;
+    int current_step;
+    bool playing;
+    bool loop_enabled;
+    int loop_start;     // 0-15
+    int loop_end;       // 0-15
+
+    // Pattern chain: each pass through a pattern moves to the next entry.
+    // Empty = repeat current_pattern. With loop_enabled off, the chain
+    // (or the single pattern) plays once and stops.
+    int chain[MAX_PATTERNS];
+    int chain_length;
+    int chain_pos;
+
+    // Clock: current_step's unswung frame is
+    // anchor_frame + round(steps_from_anchor * frames_per_step)
+    uint64_t anchor_frame;
+    uint64_t steps_from_anchor;
+    double frames_per_step;
+
+    // Notes started by each step, released once their length has elapsed
+    int sounding_notes[STEPS_PER_PATTERN];
+    uint64_t note_off_frames[STEPS_PER_PATTERN];
+} Sequencer;
+
+void sequencer_init(Sequencer* seq);
+// Start from the first step of the loop range (and of the chain) at `frame`
+void sequencer_start(Sequencer* seq, uint64_t frame);
+// Release every note the sequencer started, immediately. Call between
+// renders, once all scheduled events have been dispatched.
+void sequencer_stop(Sequencer* seq, Arpeggiator* arp, SynthEngine* synth);
+// Replace the chain; false (chain unchanged) on an out-of-range pattern
+bool sequencer_set_chain(Sequencer* seq, const int* patterns, int count);
+
+// Emit every note on/off due before frame `until`, in frame order (a
+// note-off sorts before a note-on on the same frame). Tempo changes take
+// effect from the next unscheduled step. Returns the number emitted.
+int sequencer_schedule(Sequencer* seq, uint64_t until, float sample_rate, double tempo,
+                       sequencer_emit_fn emit, void* userdata);
+
+// Apply one scheduled event; notes go through the arpeggiator when `arp` is
+// enabled, as live input does
+void sequencer_dispatch(const SeqEvent* event, Arpeggiator* arp, SynthEngine* synth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQUENCER_H
@@ -0,0 +1,826 @@
+/**
+ * DSP micro-benchmarks.
+ *
+ * Times the engine's hot paths in isolation and prints ns per unit of work
+ * (a sample, or a push+pop pair for the queues) with how many instances one
+ * core keeps up with in real time. Results can be written as JSON and
+ * compared against an earlier run, so an optimization can be shown and a
+ * regression caught.
+ *
+ *   synth_bench                                 # full run, table on stdout
+ *   synth_bench --json after.json --baseline before.json --threshold 5
+ *   synth_bench --filter osc/saw --voices 64
+ *   synth_bench --quick                         # smoke run (ctest)
+ *   synth_bench --filter tail/                  # decaying tails, subnormal cost
+ *
+ * Each case runs a warm-up pass, then several timed runs of a calibrated
+ * length; the median is reported along with the fastest run. With a
+ * baseline, a case whose median is more than --threshold percent slower
+ * is a regression and the exit status is 1.
+ */
+
+#include "synth_engine.h"
+#include "denormal.h"
+#include "fx_rack.h"
+#include "wavetable.h"
+#include "param_queue.h"
+#include "audio_handoff.h"
+#include "third_party/cjson/cJSON.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_RATE 48000.0f
+#define BENCH_BLOCK 256               // Frames per process call (typical device period)
+#define BENCH_RUNS 7
+#define BENCH_RUN_SECONDS 0.04
+#define BENCH_QUICK_RUNS 1
+#define BENCH_QUICK_RUN_SECONDS 0.002
+#define BENCH_DEFAULT_VOICES 32
+#define BENCH_MAX_VOICES 96           // Distinct notes from MIDI 24 up
+#define BENCH_DEFAULT_THRESHOLD 10.0  // Percent
+#define BENCH_MAX_RESULTS 96
+#define BENCH_QUEUE_BATCH 64
+
+typedef enum {
+    BENCH_UNIT_SAMPLE,
+    BENCH_UNIT_OP
+} BenchUnit;
+
+typedef struct BenchCase BenchCase;
+// Do `units` units of work (samples or queue ops)
+typedef void (*bench_fn)(BenchCase* bench, int units);
+
+struct BenchCase {
+    char name[48];
+    BenchUnit unit;
+    int instances;                    // Voices a unit covers (synth cases), else 1
+    bench_fn run;
+    void* state;
+    int param;                        // Case-specific (waveform, filter mode, FX type)
+};
+
+typedef struct {
+    char name[48];
+    BenchUnit unit;
+    double ns;                        // Median over the timed runs
+    double ns_min;
+    double per_core;                  // Instances one core renders in real time
+    double baseline_ns;               // 0 when the baseline has no such case
+} BenchResult;
+
+static volatile float g_sink;         // Keeps results observable to the optimizer
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static const char* unit_name(BenchUnit unit) {
+    return unit == BENCH_UNIT_OP ? "op" : "sample";
+}
+
+// ============================================================================
+// INPUT
+// ============================================================================
+
+static float g_noise[BENCH_BLOCK * 2];
+
+static void fill_noise(void) {
+    uint32_t state = 0x12345678u;
+    for (int i = 0; i < BENCH_BLOCK * 2; i++) {
+        state = state * 1664525u + 1013904223u;
+        g_noise[i] = (float)(state >> 8) / 8388608.0f - 1.0f;
+    }
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+typedef struct {
+    Oscillator osc;
+    WavetableMip mip;
+} OscState;
+
+static void run_osc(BenchCase* bench, int units) {
+    OscState* s = (OscState*)bench->state;
+    float acc = 0.0f;
+    for (int i = 0; i < units; i++) {
+        acc += osc_process(&s->osc, BENCH_RATE, 0.0f);
+    }
+    g_sink = acc;
+}
+
+static void run_filter(BenchCase* bench, int units) {
+    Filter* filter = (Filter*)bench->state;
+    float acc = 0.0f;
+    for (int i = 0; i < units; i++) {
+        acc += filter_process(filter, g_noise[i & (BENCH_BLOCK * 2 - 1)]);
+    }
+    g_sink = acc;
+}
+
+// Retriggers every ~107 ms so attack, decay, sustain and release all get time
+#define BENCH_ENV_CYCLE (BENCH_BLOCK * 20)
+
+typedef struct {
+    Envelope env;
+    int position;
+    float block[BENCH_BLOCK];
+} EnvState;
+
+static void env_advance(EnvState* s) {
+    if (s->position == 0) {
+        envelope_trigger(&s->env, 1.0f);
+    } else if (s->position == BENCH_ENV_CYCLE / 2) {
+        envelope_release(&s->env);
+    }
+}
+
+static void run_envelope(BenchCase* bench, int units) {
+    EnvState* s = (EnvState*)bench->state;
+    float acc = 0.0f;
+    for (int i = 0; i < units; i++) {
+        env_advance(s);
+        acc += envelope_process(&s->env, BENCH_RATE);
+        s->position = (s->position + 1) % BENCH_ENV_CYCLE;
+    }
+    g_sink = acc;
+}
+
+static void run_envelope_block(BenchCase* bench, int units) {
+    EnvState* s = (EnvState*)bench->state;
+    float acc = 0.0f;
+    // BENCH_BLOCK divides the half cycle, so blocks never straddle a gate edge
+    for (int done = 0; done < units; done += BENCH_BLOCK) {
+        env_advance(s);
+        envelope_process_block(&s->env, s->block, BENCH_BLOCK, BENCH_RATE);
+        acc += s->block[BENCH_BLOCK - 1];
+        s->position = (s->position + BENCH_BLOCK) % BENCH_ENV_CYCLE;
+    }
+    g_sink = acc;
+}
+
+static void run_synth(BenchCase* bench, int units) {
+    SynthEngine* synth = (SynthEngine*)bench->state;
+    static float out[BENCH_BLOCK * 2];
+    for (int done = 0; done < units; done += BENCH_BLOCK) {
+        synth_process(synth, out, BENCH_BLOCK);
+    }
+    g_sink = out[0];
+}
+
+typedef struct {
+    EffectsRack rack;
+    float left[BENCH_BLOCK];
+    float right[BENCH_BLOCK];
+} FxState;
+
+static void run_fx(BenchCase* bench, int units) {
+    FxState* s = (FxState*)bench->state;
+    for (int done = 0; done < units; done += BENCH_BLOCK) {
+        // Fresh input each block so feedback paths stay bounded and busy
+        memcpy(s->left, g_noise, sizeof(s->left));
+        memcpy(s->right, g_noise + BENCH_BLOCK, sizeof(s->right));
+        switch ((FxType)bench->param) {
+            case FX_DISTORTION:
+                fx_distortion_process(&s->rack.distortion, s->left, s->right, BENCH_BLOCK);
+                break;
+            case FX_CHORUS:
+                fx_chorus_process(&s->rack.chorus, s->left, s->right, BENCH_BLOCK, BENCH_RATE);
+                break;
+            case FX_COMPRESSOR:
+                fx_compressor_process(&s->rack.compressor, s->left, s->right, BENCH_BLOCK, BENCH_RATE);
+                break;
+            case FX_DELAY:
+                fx_delay_process(&s->rack.delay, s->left, s->right, BENCH_BLOCK, BENCH_RATE);
+                break;
+            case FX_REVERB:
+                fx_reverb_process(&s->rack.reverb, s->left, s->right, BENCH_BLOCK);
+                break;
+            default:
+                break;
+        }
+    }
+    g_sink = s->left[0] + s->right[BENCH_BLOCK - 1];
+}
+
+// param 1: silent input, so after the warm-up every slot is asleep
+static void run_fx_rack(BenchCase* bench, int units) {
+    FxState* s = (FxState*)bench->state;
+    static float frames[BENCH_BLOCK * 2];
+    for (int done = 0; done < units; done += BENCH_BLOCK) {
+        if (bench->param) {
+            memset(frames, 0, sizeof(frames));
+        } else {
+            memcpy(frames, g_noise, sizeof(frames));
+        }
+        fx_rack_process(&s->rack, frames, BENCH_BLOCK, BENCH_RATE);
+    }
+    g_sink = frames[0];
+}
+
+// Decaying tails: one block of noise at BENCH_TAIL_LEVEL per cycle, then
+// silence, so state left unprotected spends most of the cycle sinking
+// through the subnormal range as a release tail does. The stages run as
+// shipped (their own flushes, no CPU flags), with flush-to-zero set
+// (/ftz), and for the filter with its per-block flush skipped (/raw).
+#define BENCH_TAIL_LEVEL 1e-30f
+#define BENCH_TAIL_FILTER_CYCLE 16    // Blocks
+#define BENCH_TAIL_DELAY_CYCLE 64
+#define BENCH_TAIL_REVERB_CYCLE 256
+
+typedef enum {
+    TAIL_FILTER = 0,
+    TAIL_DELAY,
+    TAIL_REVERB,
+    TAIL_STAGE_COUNT
+} TailStage;
+
+typedef enum {
+    TAIL_SHIPPED = 0,
+    TAIL_FTZ,
+    TAIL_RAW
+} TailVariant;
+
+typedef struct {
+    Filter filter;
+    EffectsRack rack;
+    TailVariant variant;
+    int cycle;        // Blocks per burst
+    int position;
+    float left[BENCH_BLOCK];
+    float right[BENCH_BLOCK];
+} TailState;
+
+static void run_tail(BenchCase* bench, int units) {
+    TailState* s = (TailState*)bench->state;
+    DenormalMode mode = {0, false};
+    if (s->variant == TAIL_FTZ) {
+        mode = denormal_flush_begin();
+    }
+    for (int done = 0; done < units; done += BENCH_BLOCK) {
+        float level = s->position == 0 ? BENCH_TAIL_LEVEL : 0.0f;
+        for (int i = 0; i < BENCH_BLOCK; i++) {
+            s->left[i] = g_noise[i] * level;
+            s->right[i] = g_noise[BENCH_BLOCK + i] * level;
+        }
+        switch ((TailStage)bench->param) {
+            case TAIL_FILTER:
+                for (int i = 0; i < BENCH_BLOCK; i++) {
+                    s->left[i] = filter_process(&s->filter, s->left[i]);
+                }
+                if (s->variant != TAIL_RAW) {
+                    filter_flush_denormals(&s->filter);   // As voice rendering does
+                }
+                break;
+            case TAIL_DELAY:
+                fx_delay_process(&s->rack.delay, s->left, s->right, BENCH_BLOCK, BENCH_RATE);
+                break;
+            case TAIL_REVERB:
+                fx_reverb_process(&s->rack.reverb, s->left, s->right, BENCH_BLOCK);
+                break;
+            default:
+                break;
+        }
+        s->position = (s->position + 1) % s->cycle;
+    }
+    denormal_flush_end(mode);
+    g_sink = s->left[0] + s->right[BENCH_BLOCK - 1];
+}
+
+// Queue cases: one op is a push and the matching pop, in batches so the
+// ring wraps the way it does when a UI frame's worth of events piles up
+static void run_param_queue(BenchCase* bench, int units) {
+    (void)bench;
+    ParamMsg msg = {0};
+    msg.id = PARAM_FILTER_CUTOFF;
+    msg.type = PARAM_FLOAT;
+    for (int done = 0; done < units; done += BENCH_QUEUE_BATCH) {
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            msg.value.f = (float)i;
+            param_queue_enqueue(&msg);
+        }
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            param_queue_dequeue(&msg);
+        }
+    }
+    g_sink = msg.value.f;
+}
+
+static void run_midi_queue(BenchCase* bench, int units) {
+    (void)bench;
+    MidiEvent event = {0};
+    event.type = MIDI_EVENT_NOTE_ON;
+    for (int done = 0; done < units; done += BENCH_QUEUE_BATCH) {
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            event.data1 = (uint8_t)i;
+            midi_queue_enqueue(&event);
+        }
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            midi_queue_dequeue(&event);
+        }
+    }
+    g_sink = event.data1;
+}
+
+static void run_command_queue(BenchCase* bench, int units) {
+    (void)bench;
+    AudioHandoffMsg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = AUDIO_CMD_TRANSPORT_STOP;
+    for (int done = 0; done < units; done += BENCH_QUEUE_BATCH) {
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            audio_command_push(&msg);
+        }
+        for (int i = 0; i < BENCH_QUEUE_BATCH; i++) {
+            audio_command_pop(&msg);
+        }
+    }
+    g_sink = (float)msg.type;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+static const char* kWaveNames[WAVE_COUNT] = {"sine", "saw", "square", "triangle", "noise", "wavetable"};
+static const char* kFilterNames[FILTER_COUNT] = {"lp", "hp", "bp", "notch", "allpass"};
+// Case names are stable ids for baselines, so they do not use the display names
+static const char* kFxNames[FX_TYPE_COUNT] = {"distortion", "chorus", "compressor", "delay", "reverb"};
+static const char* kReverbNames[FX_REVERB_QUALITY_COUNT] = {"eco", "standard", "high"};
+
+static BenchCase g_cases[BENCH_MAX_RESULTS];
+static int g_case_count;
+static float g_saw_table[WAVETABLE_SIZE];
+
+static BenchCase* add_case(const char* name, BenchUnit unit, int instances, bench_fn run, void* state, int param) {
+    if (g_case_count >= BENCH_MAX_RESULTS) {
+        return NULL;
+    }
+    BenchCase* bench = &g_cases[g_case_count++];
+    snprintf(bench->name, sizeof(bench->name), "%s", name);
+    bench->unit = unit;
+    bench->instances = instances;
+    bench->run = run;
+    bench->state = state;
+    bench->param = param;
+    return bench;
+}
+
+static void add_osc_cases(void) {
+    for (int i = 0; i < WAVETABLE_SIZE; i++) {
+        g_saw_table[i] = 2.0f * (float)i / WAVETABLE_SIZE - 1.0f;
+    }
+    for (int w = 0; w < WAVE_COUNT; w++) {
+        for (int unison = 1; unison <= MAX_UNISON; unison++) {
+            OscState* s = (OscState*)calloc(1, sizeof(OscState));
+            if (!s) {
+                continue;
+            }
+            osc_init(&s->osc, BENCH_RATE);
+            osc_set_waveform(&s->osc, (WaveformType)w);
+            osc_set_frequency(&s->osc, 220.0f);
+            s->osc.unison_voices = unison;
+            s->osc.detune_cents = 12.0f;
+            if (w == WAVE_WAVETABLE && wavetable_mip_build(&s->mip, g_saw_table, WAVETABLE_SIZE)) {
+                s->osc.wavetable = g_saw_table;
+                s->osc.wavetable_mip = &s->mip;
+            }
+            char name[48];
+            snprintf(name, sizeof(name), "osc/%s/unison%d", kWaveNames[w], unison);
+            add_case(name, BENCH_UNIT_SAMPLE, 1, run_osc, s, w);
+        }
+    }
+}
+
+static void add_filter_cases(void) {
+    for (int m = 0; m < FILTER_COUNT; m++) {
+        Filter* filter = (Filter*)calloc(1, sizeof(Filter));
+        if (!filter) {
+            continue;
+        }
+        filter_init(filter, BENCH_RATE);
+        filter_set_mode(filter, (FilterMode)m);
+        filter_update_coefficients(filter, BENCH_RATE, 1200.0f, 0.5f);
+        char name[48];
+        snprintf(name, sizeof(name), "filter/%s", kFilterNames[m]);
+        add_case(name, BENCH_UNIT_SAMPLE, 1, run_filter, filter, m);
+    }
+}
+
+static void add_envelope_cases(void) {
+    for (int block = 0; block < 2; block++) {
+        EnvState* s = (EnvState*)calloc(1, sizeof(EnvState));
+        if (!s) {
+            continue;
+        }
+        envelope_init(&s->env);
+        s->env.attack = 0.01f;
+        s->env.decay = 0.02f;
+        s->env.release = 0.03f;
+        add_case(block ? "envelope/block" : "envelope/sample", BENCH_UNIT_SAMPLE, 1,
+                 block ? run_envelope_block : run_envelope, s, 0);
+    }
+}
+
+static void add_synth_case(int voices) {
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    if (!synth) {
+        return;
+    }
+    synth_init_with_polyphony(synth, BENCH_RATE, voices);
+    for (int v = 0; v < voices; v++) {
+        synth_note_on(synth, 24 + v, 0.8f);
+    }
+    // No voices: once the master tail has played out, the idle path
+    char name[48];
+    if (voices == 0) {
+        snprintf(name, sizeof(name), "synth/idle");
+    } else {
+        snprintf(name, sizeof(name), "synth/%dvoice%s", voices, voices == 1 ? "" : "s");
+    }
+    add_case(name, BENCH_UNIT_SAMPLE, voices > 0 ? voices : 1, run_synth, synth, voices);
+}
+
+static FxState* make_fx_state(void) {
+    FxState* s = (FxState*)calloc(1, sizeof(FxState));
+    if (!s) {
+        return NULL;
+    }
+    fx_rack_init(&s->rack);
+    if (!fx_rack_prepare(&s->rack, BENCH_RATE)) {
+        free(s);
+        return NULL;
+    }
+    s->rack.distortion.enabled = true;
+    s->rack.distortion.drive = 4.0f;
+    s->rack.distortion.mix = 1.0f;
+    s->rack.chorus.enabled = true;
+    s->rack.compressor.enabled = true;
+    s->rack.compressor.threshold = 0.2f;
+    s->rack.compressor.ratio = 4.0f;
+    s->rack.delay.enabled = true;
+    s->rack.delay.time_ms = 350.0f;
+    s->rack.delay.feedback = 0.5f;
+    s->rack.delay.mix = 0.3f;
+    s->rack.reverb.enabled = true;
+    s->rack.reverb.size = 0.7f;
+    s->rack.reverb.mix = 0.3f;
+    return s;
+}
+
+static void add_fx_cases(void) {
+    for (int t = 0; t < FX_TYPE_COUNT; t++) {
+        int tiers = t == FX_REVERB ? FX_REVERB_QUALITY_COUNT : t == FX_DISTORTION ? OVERSAMPLE_MODE_COUNT : 1;
+        for (int q = 0; q < tiers; q++) {
+            FxState* s = make_fx_state();
+            if (!s) {
+                continue;
+            }
+            char name[48];
+            if (t == FX_REVERB) {
+                s->rack.reverb.quality = (FxReverbQuality)q;
+                snprintf(name, sizeof(name), "fx/reverb/%s", kReverbNames[q]);
+            } else if (t == FX_DISTORTION && q > 0) {
+                s->rack.distortion.oversample = (OversampleMode)q;
+                snprintf(name, sizeof(name), "fx/distortion/%s", oversample_mode_name((OversampleMode)q));
+            } else {
+                snprintf(name, sizeof(name), "fx/%s", kFxNames[t]);
+            }
+            add_case(name, BENCH_UNIT_SAMPLE, 1, run_fx, s, t);
+        }
+    }
+    FxState* s = make_fx_state();
+    if (s) {
+        add_case("fx/rack_all", BENCH_UNIT_SAMPLE, 1, run_fx_rack, s, 0);
+    }
+    s = make_fx_state();
+    if (s) {
+        add_case("fx/rack_idle", BENCH_UNIT_SAMPLE, 1, run_fx_rack, s, 1);
+    }
+}
+
+static void add_tail_cases(void) {
+    static const char* stage_names[TAIL_STAGE_COUNT] = {"filter", "delay", "reverb"};
+    static const char* variant_suffix[3] = {"", "/ftz", "/raw"};
+    for (int stage = 0; stage < TAIL_STAGE_COUNT; stage++) {
+        int variants = stage == TAIL_FILTER ? 3 : 2;
+        for (int v = 0; v < variants; v++) {
+            TailState* s = (TailState*)calloc(1, sizeof(TailState));
+            if (!s) {
+                continue;
+            }
+            fx_rack_init(&s->rack);
+            if (stage != TAIL_FILTER && !fx_rack_prepare(&s->rack, BENCH_RATE)) {
+                free(s);
+                continue;
+            }
+            s->variant = (TailVariant)v;
+            // Each cycle spans the stage's fall from the burst to zero
+            switch (stage) {
+                case TAIL_FILTER:
+                    filter_init(&s->filter, BENCH_RATE);
+                    filter_update_coefficients(&s->filter, BENCH_RATE, 100.0f, 0.5f);
+                    s->cycle = BENCH_TAIL_FILTER_CYCLE;
+                    break;
+                case TAIL_DELAY:
+                    s->rack.delay.enabled = true;
+                    s->rack.delay.time_ms = 20.0f;
+                    s->rack.delay.feedback = 0.5f;
+                    s->rack.delay.mix = 0.3f;
+                    s->cycle = BENCH_TAIL_DELAY_CYCLE;
+                    break;
+                default:
+                    s->rack.reverb.enabled = true;
+                    s->rack.reverb.size = 0.0f;
+                    s->rack.reverb.mix = 0.3f;
+                    s->cycle = BENCH_TAIL_REVERB_CYCLE;
+                    break;
+            }
+            char name[48];
+            snprintf(name, sizeof(name), "tail/%s%s", stage_names[stage], variant_suffix[v]);
+            add_case(name, BENCH_UNIT_SAMPLE, 1, run_tail, s, stage);
+        }
+    }
+}
+
+static void add_queue_cases(void) {
+    param_queue_init();
+    audio_handoff_init();
+    add_case("queue/param", BENCH_UNIT_OP, 1, run_param_queue, NULL, 0);
+    add_case("queue/midi", BENCH_UNIT_OP, 1, run_midi_queue, NULL, 0);
+    add_case("queue/audio_command", BENCH_UNIT_OP, 1, run_command_queue, NULL, 0);
+}
+
+// ============================================================================
+// MEASUREMENT
+// ============================================================================
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void measure(BenchCase* bench, int runs, double run_seconds, BenchResult* result) {
+    // Calibrate: double the work until one pass takes a tenth of a run
+    int units = BENCH_BLOCK;
+    for (;;) {
+        double start = bench_now_ns();
+        bench->run(bench, units);
+        double elapsed = bench_now_ns() - start;
+        if (elapsed * 10.0 >= run_seconds * 1e9 || units >= (1 << 26)) {
+            units = (int)fmin((double)(1 << 28), units * fmax(1.0, run_seconds * 1e9 / fmax(elapsed, 1.0)));
+            break;
+        }
+        units *= 2;
+    }
+    units = (units + BENCH_BLOCK - 1) / BENCH_BLOCK * BENCH_BLOCK;
+
+    double ns[BENCH_RUNS];
+    if (runs > BENCH_RUNS) {
+        runs = BENCH_RUNS;
+    }
+    for (int r = 0; r < runs; r++) {
+        double start = bench_now_ns();
+        bench->run(bench, units);
+        ns[r] = (bench_now_ns() - start) / units;
+    }
+    qsort(ns, (size_t)runs, sizeof(double), compare_double);
+
+    memcpy(result->name, bench->name, sizeof(result->name));
+    result->unit = bench->unit;
+    result->ns = runs % 2 ? ns[runs / 2] : 0.5 * (ns[runs / 2 - 1] + ns[runs / 2]);
+    result->ns_min = ns[0];
+    result->per_core = 0.0;
+    if (bench->unit == BENCH_UNIT_SAMPLE && result->ns > 0.0) {
+        result->per_core = (1e9 / BENCH_RATE) / result->ns * bench->instances;
+    }
+    result->baseline_ns = 0.0;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+static bool save_json(const BenchResult* results, int count, int runs, const char* path) {
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return false;
+    }
+    cJSON_AddStringToObject(root, "benchmark", "synth_bench");
+    cJSON_AddNumberToObject(root, "version", 1);
+    cJSON_AddNumberToObject(root, "sample_rate", BENCH_RATE);
+    cJSON_AddNumberToObject(root, "block", BENCH_BLOCK);
+    cJSON_AddNumberToObject(root, "runs", runs);
+#ifdef SYNTH_EXACT_MATH
+    cJSON_AddBoolToObject(root, "fast_math", 0);
+#else
+    cJSON_AddBoolToObject(root, "fast_math", 1);
+#endif
+    cJSON* list = cJSON_AddArrayToObject(root, "results");
+    for (int i = 0; i < count; i++) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", results[i].name);
+        cJSON_AddStringToObject(item, "unit", unit_name(results[i].unit));
+        cJSON_AddNumberToObject(item, "ns", results[i].ns);
+        cJSON_AddNumberToObject(item, "ns_min", results[i].ns_min);
+        if (results[i].unit == BENCH_UNIT_SAMPLE) {
+            cJSON_AddNumberToObject(item, "per_core", results[i].per_core);
+        }
+        cJSON_AddItemToArray(list, item);
+    }
+
+    char* text = cJSON_Print(root);
+    cJSON_Delete(root);
+    if (!text) {
+        return false;
+    }
+    FILE* file = fopen(path, "w");
+    bool ok = file && fputs(text, file) >= 0;
+    if (file) {
+        ok = fclose(file) == 0 && ok;
+    }
+    free(text);
+    return ok;
+}
+
+static cJSON* load_json(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    cJSON* root = NULL;
+    char* text = length > 0 ? (char*)malloc((size_t)length + 1) : NULL;
+    if (text && fread(text, 1, (size_t)length, file) == (size_t)length) {
+        text[length] = '\0';
+        root = cJSON_Parse(text);
+    }
+    free(text);
+    fclose(file);
+    return root;
+}
+
+// Fill baseline_ns from a saved run's results array
+static void apply_baseline(BenchResult* results, int count, const cJSON* list) {
+    const cJSON* item;
+    cJSON_ArrayForEach(item, list) {
+        const cJSON* name = cJSON_GetObjectItemCaseSensitive(item, "name");
+        const cJSON* ns = cJSON_GetObjectItemCaseSensitive(item, "ns");
+        if (!cJSON_IsString(name) || !cJSON_IsNumber(ns)) {
+            continue;
+        }
+        for (int i = 0; i < count; i++) {
+            if (strcmp(results[i].name, name->valuestring) == 0) {
+                results[i].baseline_ns = ns->valuedouble;
+            }
+        }
+    }
+}
+
+static void print_header(bool baseline) {
+    printf("%-28s %-7s %10s %10s %10s", "case", "unit", "ns", "min ns", "per core");
+    if (baseline) {
+        printf(" %10s %8s", "base ns", "delta");
+    }
+    printf("\n");
+}
+
+// Returns true if the case regressed past the threshold
+static bool print_result(const BenchResult* result, bool baseline, double threshold) {
+    char per_core[24] = "-";
+    if (result->unit == BENCH_UNIT_SAMPLE) {
+        snprintf(per_core, sizeof(per_core), "%.0f", result->per_core);
+    }
+    printf("%-28s %-7s %10.2f %10.2f %10s", result->name, unit_name(result->unit), result->ns,
+           result->ns_min, per_core);
+    bool regressed = false;
+    if (baseline) {
+        if (result->baseline_ns > 0.0) {
+            double delta = (result->ns - result->baseline_ns) * 100.0 / result->baseline_ns;
+            regressed = delta > threshold;
+            printf(" %10.2f %+7.1f%%%s", result->baseline_ns, delta, regressed ? "  REGRESSION" : "");
+        } else {
+            printf(" %10s %8s", "-", "new");
+        }
+    }
+    printf("\n");
+    return regressed;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [--quick] [--filter text] [--voices n] [--json out.json]\n"
+            "          [--baseline base.json] [--threshold percent]\n"
+            "  --quick      One short run per case (smoke test; timings are rough)\n"
+            "  --filter     Only cases whose name contains text\n"
+            "  --voices     Voice count of the largest synth case (default: %d, max %d)\n"
+            "  --json       Write results as JSON\n"
+            "  --baseline   Compare against a JSON file from an earlier run\n"
+            "  --threshold  Percent slower than baseline that counts as a regression (default: %.0f)\n",
+            argv0, BENCH_DEFAULT_VOICES, BENCH_MAX_VOICES, BENCH_DEFAULT_THRESHOLD);
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    const char* filter = NULL;
+    const char* json_path = NULL;
+    const char* baseline_path = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    int voices = BENCH_DEFAULT_VOICES;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && has_value) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--voices") == 0 && has_value) {
+            voices = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && has_value) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && has_value) {
+            threshold = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (voices < 2 || voices > BENCH_MAX_VOICES) {
+        fprintf(stderr, "--voices must be 2-%d\n", BENCH_MAX_VOICES);
+        return 2;
+    }
+
+    // Read the baseline up front so a bad path fails before the long run
+    cJSON* baseline_root = NULL;
+    const cJSON* baseline_list = NULL;
+    if (baseline_path) {
+        baseline_root = load_json(baseline_path);
+        baseline_list = cJSON_GetObjectItemCaseSensitive(baseline_root, "results");
+        if (!cJSON_IsArray(baseline_list)) {
+            fprintf(stderr, "Could not read baseline %s\n", baseline_path);
+            cJSON_Delete(baseline_root);
+            return 2;
+        }
+    }
+
+    fill_noise();
+    add_osc_cases();
+    add_filter_cases();
+    add_envelope_cases();
+    add_synth_case(0);
+    add_synth_case(1);
+    if (voices > 8) {
+        add_synth_case(8);
+    }
+    add_synth_case(voices);
+    add_fx_cases();
+    add_tail_cases();
+    add_queue_cases();
+
+    const int runs = quick ? BENCH_QUICK_RUNS : BENCH_RUNS;
+    const double run_seconds = quick ? BENCH_QUICK_RUN_SECONDS : BENCH_RUN_SECONDS;
+    static BenchResult results[BENCH_MAX_RESULTS];
+    int count = 0;
+    for (int i = 0; i < g_case_count; i++) {
+        if (filter && !strstr(g_cases[i].name, filter)) {
+            continue;
+        }
+        g_cases[i].run(&g_cases[i], BENCH_BLOCK * 16); // Warm caches and state
+        measure(&g_cases[i], runs, run_seconds, &results[count++]);
+    }
+
+    const bool baseline = baseline_list != NULL;
+    if (baseline) {
+        apply_baseline(results, count, baseline_list);
+        cJSON_Delete(baseline_root);
+    }
+
+    printf("synth_bench: %.0f Hz, %d-frame blocks, %d run%s per case%s\n", BENCH_RATE, BENCH_BLOCK, runs,
+           runs == 1 ? "" : "s", quick ? " (quick)" : "");
+    print_header(baseline);
+    int regressions = 0;
+    for (int i = 0; i < count; i++) {
+        regressions += print_result(&results[i], baseline, threshold) ? 1 : 0;
+    }
+    if (baseline) {
+        printf("%d regression%s over %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+    }
+
+    if (json_path && !save_json(results, count, runs, json_path)) {
+        fprintf(stderr, "Could not write %s\n", json_path);
+        return 2;
+    }
+    return regressions > 0 ? 1 : 0;
+}
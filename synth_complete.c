@@ -27,13 +27,27 @@
 #include "miniaudio.h"
 
 #include "synth_engine.h"
+#include "dsp_math.h"
 #include "param_queue.h"
+#include "audio_handoff.h"
+#include "disk_stream.h"
+#include "fx_rack.h"
+#include "sequencer.h"
+#include "synth_core.h"
+#include "rt_stats.h"
+#include "meter_feed.h"
+#include "rt_log.h"
+#include "voice_pool.h"
 #include "midi_input.h"
 #include "ui/style.h"
 #include "ui/draw_helpers.h"
 #include "ui/knob_custom.h"
+#include "ui/frame_pacer.h"
 #include "sample_io.h"
 #include "preset.h"
+#include "preset_library.h"
+#include "project.h"
+#include "audio_settings.h"
 #include "third_party/cjson/cJSON.h"
 
 #if defined(_WIN32)
@@ -55,6 +69,7 @@
 #include <time.h>
 #include <math.h>
 #include <ctype.h>
+#include <stdatomic.h>
 
 // Forward declarations for note helpers used by UI components
 void play_note(int midi_note, const char* label);
@@ -75,6 +90,14 @@ static void sleep_milliseconds(unsigned int ms) {
 
 #define UI_MACRO_COUNT 4
 #define UI_MOD_SLOT_COUNT 4
+#define UI_VOICE_ROWS 8
+#define UI_METER_FLOOR_DB -60.0f
+#define UI_SCOPE_SAMPLES 1024   // ~23 ms at 44.1 kHz; also the spectrum window
+#define UI_SPECTRUM_BANDS 48
+
+#define APP_DEFAULT_POLYPHONY 32   // --polyphony overrides, up to SYNTH_MAX_POLYPHONY
+#define UI_METER_HZ 30.0   // Redraw cap while meters move
+#define UI_IDLE_HZ 4.0     // Housekeeping wakes when nothing moves
 
 typedef struct {
     int source;
@@ -83,193 +106,6 @@ typedef struct {
     int enabled;
 } ModMatrixSlot;
 
-// ============================================================================
-// EFFECTS SYSTEM
-// ============================================================================
-
-typedef struct {
-    float buffer[88200];  // 2 seconds at 44.1kHz
-    int write_pos;
-    int size;
-} DelayLine;
-
-typedef struct {
-    bool enabled;
-    float drive;      // 0-10
-    float mix;        // 0-1
-} Distortion;
-
-typedef struct {
-    bool enabled;
-    float time_ms;    // 100-2000ms
-    float feedback;   // 0-0.95
-    float mix;        // 0-1
-    DelayLine delay_l;
-    DelayLine delay_r;
-} Delay;
-
-typedef struct {
-    bool enabled;
-    float size;       // 0-1
-    float damping;    // 0-1  
-    float mix;        // 0-1
-    float buffer[4410]; // Simple comb filter
-    int pos;
-} Reverb;
-
-typedef struct {
-    Distortion distortion;
-    Delay delay;
-    Reverb reverb;
-} EffectsRack;
-
-void fx_distortion_process(Distortion* fx, float* left, float* right) {
-    if (!fx->enabled) return;
-    
-    float l = *left * fx->drive;
-    float r = *right * fx->drive;
-    
-    // Soft clipping
-    l = tanhf(l);
-    r = tanhf(r);
-    
-    *left = *left * (1.0f - fx->mix) + l * fx->mix;
-    *right = *right * (1.0f - fx->mix) + r * fx->mix;
-}
-
-void fx_delay_init(Delay* fx) {
-    memset(&fx->delay_l, 0, sizeof(DelayLine));
-    memset(&fx->delay_r, 0, sizeof(DelayLine));
-    fx->delay_l.size = fx->delay_r.size = 88200;
-    fx->delay_l.write_pos = fx->delay_r.write_pos = 0;
-    fx->time_ms = 500.0f;
-    fx->feedback = 0.3f;
-    fx->mix = 0.3f;
-}
-
-void fx_delay_process(Delay* fx, float* left, float* right, float sample_rate) {
-    if (!fx->enabled) return;
-    
-    int delay_samples = (int)((fx->time_ms / 1000.0f) * sample_rate);
-    delay_samples = delay_samples < 88200 ? delay_samples : 88199;
-    
-    // Left channel
-    int read_pos_l = (fx->delay_l.write_pos - delay_samples + 88200) % 88200;
-    float delayed_l = fx->delay_l.buffer[read_pos_l];
-    fx->delay_l.buffer[fx->delay_l.write_pos] = *left + delayed_l * fx->feedback;
-    fx->delay_l.write_pos = (fx->delay_l.write_pos + 1) % 88200;
-    *left = *left * (1.0f - fx->mix) + delayed_l * fx->mix;
-    
-    // Right channel  
-    int read_pos_r = (fx->delay_r.write_pos - delay_samples + 88200) % 88200;
-    float delayed_r = fx->delay_r.buffer[read_pos_r];
-    fx->delay_r.buffer[fx->delay_r.write_pos] = *right + delayed_r * fx->feedback;
-    fx->delay_r.write_pos = (fx->delay_r.write_pos + 1) % 88200;
-    *right = *right * (1.0f - fx->mix) + delayed_r * fx->mix;
-}
-
-void fx_reverb_process(Reverb* fx, float* left, float* right) {
-    if (!fx->enabled) return;
-    
-    float input = (*left + *right) * 0.5f;
-    float delay_time = (int)(fx->size * 4410);
-    if (delay_time < 1) delay_time = 1;
-    
-    int read_pos = (fx->pos - (int)delay_time + 4410) % 4410;
-    float delayed = fx->buffer[read_pos];
-    fx->buffer[fx->pos] = input + delayed * fx->damping;
-    fx->pos = (fx->pos + 1) % 4410;
-    
-    *left = *left * (1.0f - fx->mix) + delayed * fx->mix;
-    *right = *right * (1.0f - fx->mix) + delayed * fx->mix;
-}
-
-// ============================================================================
-// ARPEGGIATOR
-// ============================================================================
-
-typedef enum { ARP_OFF, ARP_UP, ARP_DOWN, ARP_UP_DOWN, ARP_RANDOM } ArpMode;
-
-typedef struct {
-    bool enabled;
-    ArpMode mode;
-    float rate;           // Steps per beat (1=quarter, 2=eighth, 4=sixteenth)
-    float gate;           // 0-1
-    int held_notes[16];
-    int num_held;
-    int current_step;
-    double next_step_time;
-    int last_played_note; // Track the last note we triggered
-} Arpeggiator;
-
-void arp_init(Arpeggiator* arp) {
-    memset(arp, 0, sizeof(Arpeggiator));
-    arp->rate = 2.0f;  // Eighth notes
-    arp->gate = 0.8f;
-    arp->mode = ARP_UP;
-    arp->last_played_note = -1;  // No note playing initially
-}
-
-void arp_note_on(Arpeggiator* arp, int note) {
-    if (arp->num_held < 16) {
-        arp->held_notes[arp->num_held++] = note;
-    }
-}
-
-void arp_note_off(Arpeggiator* arp, int note) {
-    for (int i = 0; i < arp->num_held; i++) {
-        if (arp->held_notes[i] == note) {
-            for (int j = i; j < arp->num_held - 1; j++) {
-                arp->held_notes[j] = arp->held_notes[j + 1];
-            }
-            arp->num_held--;
-            // Reset step index if we removed the current or last note
-            if (i <= arp->current_step || arp->current_step >= arp->num_held) {
-                arp->current_step = 0;
-            }
-            break;
-        }
-    }
-}
-
-void arp_process(Arpeggiator* arp, SynthEngine* synth, double time, double tempo) {
-    // If arpeggiator is disabled or no notes held, stop any playing note
-    if (!arp->enabled || arp->num_held == 0) {
-        // Stop the last note that was playing
-        if (arp->last_played_note >= 0) {
-            synth_note_off(synth, arp->last_played_note);
-            arp->last_played_note = -1;
-        }
-        return;
-    }
-    
-    double beat_duration = 60.0 / tempo;
-    double step_duration = beat_duration / arp->rate;
-    
-    if (time >= arp->next_step_time) {
-        // Release previous note
-        if (arp->last_played_note >= 0) {
-            synth_note_off(synth, arp->last_played_note);
-        }
-        
-        // Advance step
-        if (arp->mode == ARP_UP) {
-            arp->current_step = (arp->current_step + 1) % arp->num_held;
-        } else if (arp->mode == ARP_DOWN) {
-            arp->current_step = (arp->current_step - 1 + arp->num_held) % arp->num_held;
-        } else if (arp->mode == ARP_RANDOM) {
-            arp->current_step = rand() % arp->num_held;
-        }
-        
-        // Play new note and track it
-        int note_to_play = arp->held_notes[arp->current_step];
-        synth_note_on(synth, note_to_play, 0.8f);
-        arp->last_played_note = note_to_play;
-        
-        arp->next_step_time = time + step_duration * arp->gate;
-    }
-}
-
 // ============================================================================
 // KEYBOARD MAPPING (FL Studio Style)
 // ============================================================================
@@ -294,38 +130,6 @@ static KeyMapping g_keymap[] = {
 };
 #define KEYMAP_SIZE (sizeof(g_keymap) / sizeof(g_keymap[0]))
 
-// ============================================================================
-// SEQUENCER & PATTERN SYSTEM
-// ============================================================================
-
-#define MAX_PATTERNS 16
-#define STEPS_PER_PATTERN 16
-
-typedef struct {
-    int note;           // MIDI note number (0-127, -1 = no note)
-    float velocity;     // 0.0-1.0
-    int length;         // Step length (1-16)
-    bool active;        // Is this step active?
-} SequencerStep;
-
-typedef struct {
-    char name[32];
-    SequencerStep steps[STEPS_PER_PATTERN];
-    int length;         // Pattern length in steps (1-16)
-    float swing;        // 0.0-1.0
-} Pattern;
-
-typedef struct {
-    Pattern patterns[MAX_PATTERNS];
-    int current_pattern;
-    int current_step;
-    bool playing;
-    bool loop_enabled;
-    double next_step_time;
-    int loop_start;     // 0-15
-    int loop_end;       // 0-15
-} Sequencer;
-
 typedef struct {
     struct nk_rect bounds;
     int start_note;
@@ -333,37 +137,78 @@ typedef struct {
 } PianoKeyboardParams;
 
 #define MAX_VOICE_TRACKS 4
-#define VOICE_TRACK_MAX_SECONDS 60
 
 #define MAX_PRESET_SNIPPET_PRESETS 32
+#define PRESET_BROWSER_DIR "presets"
+#define PRESET_BROWSER_INDEX "presets/.preset_index.json"
+#define PRESET_BROWSER_MAX_ROWS 64   // Rows drawn per frame; the rest are counted
 #define MAX_SNIPPETS_PER_PRESET 3
-#define PRESET_SNIPPET_MAX_SECONDS 30
 
+#define RECORD_CHANNELS 2
+#define RECORD_STAGE_FRAMES 64
+
+// Audio thread: recorded frames are gathered into small blocks before they
+// go to the disk stream, so the ring is written in blocks, not per sample
 typedef struct {
-    SampleBuffer buffer;
-    uint32_t record_capacity_frames;
-    uint32_t recorded_frames;
-    uint32_t playback_pos;
-    int recording;
-    int playing;
+    int stream;
+    uint32_t frames;
+    float samples[RECORD_STAGE_FRAMES * RECORD_CHANNELS];
+} RecordStage;
+
+// Tracks and snippets are split by owner. The UI thread owns the take in
+// `buffer` plus names/metadata; the audio thread owns the rt_* fields and
+// publishes its status through atomics that the UI reads for display.
+// Buffers change hands only through audio_handoff commands/events.
+// Recording streams straight to disk; the finished file is opened as a
+// SampleSource (memory-mapped, or streamed if compressed) for playback.
+typedef struct {
+    // UI thread
+    SampleSource* source;             // Latest take (read-only once loaded)
     float volume;
+    int take_stream;                  // Disk stream still being finalized, or -1
+    int take_discard;                 // Cleared while in flight: delete when collected
+    char take_path[260];              // Unsaved take on disk
     char last_saved_path[260];
+
+    // Audio thread
+    SampleSource* rt_source;
+    uint32_t playback_pos;
+    float rt_volume;
+    RecordStage rt_stage;
+    atomic_uint recorded_frames;
+    atomic_int recording;
+    atomic_int playing;
 } VoiceTrack;
 
+// An unsaved take file whose source the audio thread may still be reading.
+// It is deleted when that source comes back retired: truncating or removing
+// a mapped file under the audio thread faults it (or fails, on Windows).
+typedef struct {
+    const SampleSource* source;
+    char path[260];
+} RetiringTake;
+
 typedef struct {
     VoiceTrack tracks[MAX_VOICE_TRACKS];
     char recordings_dir[260];
+    uint32_t take_serial;             // Every take gets a file of its own
+    RetiringTake retiring[MAX_VOICE_TRACKS * 2];
 } VoiceLayerRack;
 
 typedef struct {
-    SampleBuffer buffer;
-    uint32_t record_capacity_frames;
-    uint32_t recorded_frames;
-    uint32_t playback_pos;
-    int recording;
-    int playing;
+    // UI thread
+    SampleSource* source;
     float captured_tempo;
+    int take_stream;
+    char take_relative_path[260];
     char relative_path[260];
+
+    // Audio thread
+    SampleSource* rt_source;
+    uint32_t playback_pos;
+    atomic_uint recorded_frames;
+    atomic_int recording;
+    atomic_int playing;
 } PresetSnippet;
 
 typedef struct {
@@ -375,38 +220,40 @@ typedef struct {
 
 typedef struct {
     PresetSnippetEntry entries[MAX_PRESET_SNIPPET_PRESETS];
+
+    // Audio thread
     PresetSnippet* active_recording;
     PresetSnippet* active_playback;
-    int active_entry_index;
-    int active_snippet_index;
-    int play_all_active;
+    RecordStage record_stage;
+    int record_entry_index;
+    int record_snippet_index;
+    int play_entry_index;
+    int play_snippet_index;
+    atomic_int play_all_active;
     int play_all_entry_index;
     int play_all_snippet_index;
-    int pending_save_ready;
-    int pending_save_entry_index;
-    int pending_save_snippet_index;
+
+    // UI thread
     char base_dir[260];
     char manifest_path[260];
 } PresetSnippetLibrary;
 
 typedef struct {
-    SynthEngine synth;
-    EffectsRack fx;
-    Arpeggiator arp;
-    Sequencer sequencer;
+    SynthCore core;              // Engine, FX, arp, sequencer and tempo
     VoiceLayerRack voice_layers;
     PresetSnippetLibrary preset_snippets;
+    PresetLibrary preset_library;
     
+    ma_context audio_context;
     ma_device audio_device;
-    ma_mutex audio_mutex;
+    AudioLatency audio_latency;  // What the opened device actually runs at
+    char audio_summary[96];
     int capture_channels;
     GLFWwindow* window;
     struct nk_glfw glfw;
     struct nk_context* nk_ctx;
     struct nk_colorf bg;
     
-    double current_time;
-    float tempo;
     int playing;
     
     int active_tab;
@@ -449,9 +296,15 @@ typedef struct {
     float master_volume;
     
     int fx_dist_enabled;
+    int fx_chorus_enabled;
+    int fx_comp_enabled;
     int fx_delay_enabled;
     int fx_reverb_enabled;
+    int oversample[SYNTH_OVERSAMPLE_STAGE_COUNT];  // OversampleMode last sent per stage
+    float limiter_lookahead_ms;                    // Last sent
     int arp_enabled;
+    ArpMode arp_mode;
+    float arp_gate;
 
     // Custom knob states (hardware panel UI)
     UiKnobState knob_master_volume;
@@ -469,39 +322,19 @@ typedef struct {
     UiKnobState knob_macro[UI_MACRO_COUNT];
 
     double last_frame_time;
-} AppState;
+    UiFramePacer ui_pacer;
+    bool ui_continuous;      // SYNTH_UI_CONTINUOUS=1: redraw every vsync (the old loop)
 
-AppState g_app = {0};
+    VoicePool* voice_pool;   // Opt-in via SYNTH_VOICE_THREADS
 
-static void audio_state_lock(void) {
-    ma_mutex_lock(&g_app.audio_mutex);
-}
+    RtStats rt_stats;            // Written by the audio callback
+    RtStatsSnapshot rt_snapshot; // Latest copy the UI has polled
 
-static void audio_state_unlock(void) {
-    ma_mutex_unlock(&g_app.audio_mutex);
-}
+    MeterFeed meter_feed;        // Audio -> UI levels, scope and voice state
+    MeterFrame meter;            // Latest frame the UI has polled
+} AppState;
 
-void sequencer_init(Sequencer* seq) {
-    memset(seq, 0, sizeof(Sequencer));
-    seq->loop_enabled = true;
-    seq->loop_start = 0;
-    seq->loop_end = 15;
-    
-    // Initialize patterns
-    for (int i = 0; i < MAX_PATTERNS; i++) {
-        snprintf(seq->patterns[i].name, sizeof(seq->patterns[i].name), "Pattern %d", i + 1);
-        seq->patterns[i].length = 16;
-        seq->patterns[i].swing = 0.5f;
-        
-        // Initialize all steps as inactive
-        for (int j = 0; j < STEPS_PER_PATTERN; j++) {
-            seq->patterns[i].steps[j].note = -1;
-            seq->patterns[i].steps[j].velocity = 0.8f;
-            seq->patterns[i].steps[j].length = 1;
-            seq->patterns[i].steps[j].active = false;
-        }
-    }
-}
+AppState g_app = {0};
 
 static void ensure_directory_exists(const char* path) {
     if (!path || !path[0]) {
@@ -520,108 +353,340 @@ static void voice_layers_init(VoiceLayerRack* rack) {
     }
     memset(rack, 0, sizeof(VoiceLayerRack));
     for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
-        sample_buffer_init(&rack->tracks[i].buffer);
         rack->tracks[i].volume = 1.0f;
+        rack->tracks[i].take_stream = -1;
+        rack->tracks[i].rt_volume = 1.0f;
+        rack->tracks[i].rt_stage.stream = -1;
     }
     snprintf(rack->recordings_dir, sizeof(rack->recordings_dir), "recordings");
 }
 
-static void voice_track_finalize_recording(VoiceTrack* track) {
-    if (!track || !track->recording) {
+// ============================================================================
+// RECORDING (audio thread -> disk stream)
+// ============================================================================
+
+static void record_stage_flush_rt(RecordStage* stage) {
+    if (stage->frames > 0) {
+        // A full ring drops the block; disk_stream counts it for the UI
+        disk_stream_write(stage->stream, stage->samples, stage->frames);
+        stage->frames = 0;
+    }
+}
+
+static void record_stage_push_rt(RecordStage* stage, float left, float right) {
+    float* frame = &stage->samples[stage->frames * RECORD_CHANNELS];
+    frame[0] = left;
+    frame[1] = right;
+    if (++stage->frames >= RECORD_STAGE_FRAMES) {
+        record_stage_flush_rt(stage);
+    }
+}
+
+static void record_stage_end_rt(RecordStage* stage) {
+    if (stage->stream < 0) {
         return;
     }
-    track->recording = 0;
-    track->buffer.frame_count = track->recorded_frames;
-    if (track->buffer.frame_count == 0) {
-        sample_buffer_free(&track->buffer);
+    record_stage_flush_rt(stage);
+    disk_stream_finish(stage->stream);
+    stage->stream = -1;
+}
+
+static int record_sample_rate(void) {
+    return (int)(g_app.core.synth.sample_rate > 0.0f ? g_app.core.synth.sample_rate : 44100.0f);
+}
+
+// ============================================================================
+// VOICE TRACKS
+// ============================================================================
+
+static void voice_track_finalize_rt(int index) {
+    VoiceTrack* track = &g_app.voice_layers.tracks[index];
+    if (!atomic_load_explicit(&track->recording, memory_order_relaxed)) {
+        return;
+    }
+    atomic_store_explicit(&track->recording, 0, memory_order_relaxed);
+    // The UI picks the take up from disk once the writer has closed it
+    record_stage_end_rt(&track->rt_stage);
+}
+
+static void voice_track_apply_command_rt(const AudioHandoffMsg* cmd) {
+    if (cmd->index < 0 || cmd->index >= MAX_VOICE_TRACKS) {
+        audio_retire_source(cmd->source);
+        return;
+    }
+    VoiceTrack* track = &g_app.voice_layers.tracks[cmd->index];
+
+    switch (cmd->type) {
+        case AUDIO_CMD_TRACK_RECORD:
+            for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
+                voice_track_finalize_rt(i);
+            }
+            audio_retire_source(track->rt_source);
+            track->rt_source = NULL;
+            track->playback_pos = 0;
+            track->rt_stage.stream = cmd->stream;
+            track->rt_stage.frames = 0;
+            atomic_store_explicit(&track->recorded_frames, 0, memory_order_relaxed);
+            atomic_store_explicit(&track->playing, 0, memory_order_relaxed);
+            atomic_store_explicit(&track->recording, cmd->stream >= 0 ? 1 : 0, memory_order_relaxed);
+            break;
+
+        case AUDIO_CMD_TRACK_STOP_RECORD:
+            voice_track_finalize_rt(cmd->index);
+            break;
+
+        case AUDIO_CMD_TRACK_CLEAR:
+            voice_track_finalize_rt(cmd->index);
+            atomic_store_explicit(&track->playing, 0, memory_order_relaxed);
+            atomic_store_explicit(&track->recorded_frames, 0, memory_order_relaxed);
+            audio_retire_source(track->rt_source);
+            track->rt_source = NULL;
+            track->playback_pos = 0;
+            break;
+
+        case AUDIO_CMD_TRACK_TOGGLE_PLAY:
+            if (!track->rt_source || track->rt_source->frame_count == 0) {
+                atomic_store_explicit(&track->playing, 0, memory_order_relaxed);
+            } else {
+                int playing = !atomic_load_explicit(&track->playing, memory_order_relaxed);
+                atomic_store_explicit(&track->playing, playing, memory_order_relaxed);
+                if (playing) {
+                    track->playback_pos = 0;
+                }
+            }
+            break;
+
+        case AUDIO_CMD_TRACK_VOLUME:
+            track->rt_volume = cmd->value;
+            break;
+
+        case AUDIO_CMD_TRACK_LOAD:
+            if (atomic_load_explicit(&track->recording, memory_order_relaxed)) {
+                audio_retire_source(cmd->source); // A newer take is already underway
+                break;
+            }
+            audio_retire_source(track->rt_source);
+            track->rt_source = cmd->source;
+            track->playback_pos = 0;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Whether any track records or plays this block; when none does, the
+// per-frame track loop is skipped
+static bool voice_tracks_busy_rt(void) {
+    for (int t = 0; t < MAX_VOICE_TRACKS; ++t) {
+        VoiceTrack* track = &g_app.voice_layers.tracks[t];
+        if (atomic_load_explicit(&track->recording, memory_order_relaxed) ||
+            (atomic_load_explicit(&track->playing, memory_order_relaxed) &&
+             track->rt_source && track->rt_source->frame_count > 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void voice_track_process_frame_rt(float mic_l, float mic_r, float* mix_l, float* mix_r) {
+    for (int t = 0; t < MAX_VOICE_TRACKS; ++t) {
+        VoiceTrack* track = &g_app.voice_layers.tracks[t];
+
+        if (atomic_load_explicit(&track->recording, memory_order_relaxed)) {
+            record_stage_push_rt(&track->rt_stage, mic_l, mic_r);
+            uint32_t recorded = atomic_load_explicit(&track->recorded_frames, memory_order_relaxed);
+            atomic_store_explicit(&track->recorded_frames, recorded + 1, memory_order_relaxed);
+        }
+
+        if (atomic_load_explicit(&track->playing, memory_order_relaxed) &&
+            track->rt_source && track->rt_source->frame_count > 0) {
+            if (track->playback_pos >= track->rt_source->frame_count) {
+                track->playback_pos = 0;
+            }
+            float src_l = 0.0f;
+            float src_r = 0.0f;
+            sample_source_read_frame(track->rt_source, track->playback_pos, &src_l, &src_r);
+            *mix_l += src_l * track->rt_volume;
+            *mix_r += src_r * track->rt_volume;
+            track->playback_pos++;
+            if (track->playback_pos >= track->rt_source->frame_count) {
+                track->playback_pos = 0;
+            }
+        }
+    }
+}
+
+// UI-side status reads (values published by the audio thread)
+static int voice_track_is_recording(VoiceTrack* track) {
+    return atomic_load_explicit(&track->recording, memory_order_relaxed);
+}
+
+static int voice_track_is_playing(VoiceTrack* track) {
+    return atomic_load_explicit(&track->playing, memory_order_relaxed);
+}
+
+// UI thread: delete an unsaved take once nothing maps it. `source` is the
+// take's SampleSource if the audio thread may still hold it, else NULL.
+static void voice_track_remove_take_file(const SampleSource* source, const char* path) {
+    if (!path[0]) {
+        return;
+    }
+    if (source) {
+        VoiceLayerRack* rack = &g_app.voice_layers;
+        for (int i = 0; i < MAX_VOICE_TRACKS * 2; ++i) {
+            if (!rack->retiring[i].source) {
+                rack->retiring[i].source = source;
+                snprintf(rack->retiring[i].path, sizeof(rack->retiring[i].path), "%s", path);
+                return;
+            }
+        }
+        // No slot left: leave the file behind rather than pull it from under a reader
+        fprintf(stderr, "Keeping take %s: still in use\n", path);
+        return;
+    }
+    remove(path);
+}
+
+// UI thread: close a source the audio thread has retired, then delete its
+// take file if one was waiting on it
+static void retired_source_destroy(SampleSource* source) {
+    VoiceLayerRack* rack = &g_app.voice_layers;
+    RetiringTake* take = NULL;
+    for (int i = 0; i < MAX_VOICE_TRACKS * 2 && !take; ++i) {
+        if (rack->retiring[i].source == source) {
+            take = &rack->retiring[i];
+        }
+    }
+    sample_source_destroy(source);
+    if (take) {
+        remove(take->path);
+        take->source = NULL;
+        take->path[0] = '\0';
     }
-    track->playback_pos = 0;
 }
 
 static void voice_track_begin_recording(int index) {
     if (index < 0 || index >= MAX_VOICE_TRACKS) {
         return;
     }
-    audio_state_lock();
-    for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
-        voice_track_finalize_recording(&g_app.voice_layers.tracks[i]);
+    VoiceTrack* track = &g_app.voice_layers.tracks[index];
+    if (track->take_stream >= 0) {
+        return; // Previous take is still being finalized (a few ms)
     }
 
-    VoiceTrack* track = &g_app.voice_layers.tracks[index];
-    sample_buffer_free(&track->buffer);
-
-    uint32_t sample_rate = (uint32_t)(g_app.synth.sample_rate > 0.0f ? g_app.synth.sample_rate : 44100.0f);
-    uint32_t capacity = sample_rate * VOICE_TRACK_MAX_SECONDS;
-    size_t samples = (size_t)capacity * 2;
-    track->buffer.data = (float*)malloc(samples * sizeof(float));
-    if (!track->buffer.data) {
-        track->recording = 0;
-        audio_state_unlock();
-        fprintf(stderr, "âŒ Unable to allocate recording buffer for track %d\n", index + 1);
+    ensure_directory_exists(g_app.voice_layers.recordings_dir);
+    // A fresh name each time: the previous take may still be playing from its file
+    char take_path[260];
+    snprintf(take_path, sizeof(take_path), "%s/voice_track_%d_take_%u.wav",
+             g_app.voice_layers.recordings_dir, index + 1, (unsigned)++g_app.voice_layers.take_serial);
+
+    uint32_t sample_rate = (uint32_t)record_sample_rate();
+    int stream = disk_stream_open(take_path, RECORD_CHANNELS, sample_rate);
+    if (stream < 0) {
         return;
     }
-    track->buffer.channels = 2;
-    track->buffer.sample_rate = sample_rate;
-    track->buffer.frame_count = 0;
-    track->record_capacity_frames = capacity;
-    track->recorded_frames = 0;
-    track->playback_pos = 0;
-    track->playing = 0;
-    track->recording = 1;
+
+    AudioHandoffMsg cmd = {0};
+    cmd.type = AUDIO_CMD_TRACK_RECORD;
+    cmd.index = index;
+    cmd.stream = stream;
+    cmd.channels = RECORD_CHANNELS;
+    if (!audio_command_push(&cmd)) {
+        disk_stream_finish(stream); // Never reached the audio thread
+    }
+
+    // The previous take (if any) comes back as AUDIO_EVENT_RETIRE_SOURCE;
+    // an unsaved one is deleted then
+    voice_track_remove_take_file(track->source, track->take_path);
+    track->source = NULL;
+    track->take_stream = stream;
+    snprintf(track->take_path, sizeof(track->take_path), "%s", take_path);
     track->last_saved_path[0] = '\0';
-    audio_state_unlock();
 }
 
-static void voice_track_stop_recording(int index) {
-    if (index < 0 || index >= MAX_VOICE_TRACKS) {
+// UI thread: once a take's stream has closed, load the file for playback
+static void voice_track_collect_take(int index) {
+    VoiceTrack* track = &g_app.voice_layers.tracks[index];
+    if (track->take_stream < 0) {
+        return;
+    }
+    DiskStreamState state = disk_stream_state(track->take_stream);
+    if (state != DISK_STREAM_CLOSED && state != DISK_STREAM_FAILED) {
+        return;
+    }
+    uint64_t frames = disk_stream_frames_written(track->take_stream);
+    uint64_t dropped = disk_stream_frames_dropped(track->take_stream);
+    disk_stream_release(track->take_stream);
+    track->take_stream = -1;
+    if (dropped > 0) {
+        fprintf(stderr, "Track %d take dropped %llu frames (disk too slow)\n",
+                index + 1, (unsigned long long)dropped);
+    }
+    if (frames == 0 || track->take_discard) {
+        remove(track->take_path);
+        track->take_path[0] = '\0';
+        track->take_discard = 0;
+        return;
+    }
+
+    SampleSource* take = sample_source_create(track->take_path);
+    if (!take) {
+        return;
+    }
+    AudioHandoffMsg cmd = {0};
+    cmd.type = AUDIO_CMD_TRACK_LOAD;
+    cmd.index = index;
+    cmd.source = take;
+    if (!audio_command_push(&cmd)) {
+        sample_source_destroy(take);
         return;
     }
-    audio_state_lock();
-    voice_track_finalize_recording(&g_app.voice_layers.tracks[index]);
-    audio_state_unlock();
+    track->source = take;
 }
 
-static void voice_track_clear(int index) {
+static void voice_track_send_command(int index, AudioHandoffType type, float value) {
     if (index < 0 || index >= MAX_VOICE_TRACKS) {
         return;
     }
-    audio_state_lock();
-    VoiceTrack* track = &g_app.voice_layers.tracks[index];
-    sample_buffer_free(&track->buffer);
-    track->record_capacity_frames = 0;
-    track->recorded_frames = 0;
-    track->playback_pos = 0;
-    track->recording = 0;
-    track->playing = 0;
-    track->last_saved_path[0] = '\0';
-    audio_state_unlock();
+    AudioHandoffMsg cmd = {0};
+    cmd.type = type;
+    cmd.index = index;
+    cmd.value = value;
+    audio_command_push(&cmd);
 }
 
-static void voice_track_toggle_play(int index) {
+static void voice_track_stop_recording(int index) {
+    voice_track_send_command(index, AUDIO_CMD_TRACK_STOP_RECORD, 0.0f);
+}
+
+static void voice_track_clear(int index) {
     if (index < 0 || index >= MAX_VOICE_TRACKS) {
         return;
     }
-    audio_state_lock();
+    voice_track_send_command(index, AUDIO_CMD_TRACK_CLEAR, 0.0f);
     VoiceTrack* track = &g_app.voice_layers.tracks[index];
-    if (!track->buffer.data || track->buffer.frame_count == 0) {
-        track->playing = 0;
-        audio_state_unlock();
-        return;
-    }
-    track->playing = !track->playing;
-    if (track->playing) {
-        track->playback_pos = 0;
+    if (track->take_stream >= 0) {
+        track->take_discard = 1; // Removed once the writer lets go of it
+    } else if (track->take_path[0]) {
+        voice_track_remove_take_file(track->source, track->take_path);
+        track->take_path[0] = '\0';
     }
-    audio_state_unlock();
+    track->source = NULL; // Closed when it is retired
+    track->last_saved_path[0] = '\0';
+}
+
+static void voice_track_toggle_play(int index) {
+    voice_track_send_command(index, AUDIO_CMD_TRACK_TOGGLE_PLAY, 0.0f);
 }
 
 static void voice_track_set_volume(int index, float volume) {
     if (index < 0 || index >= MAX_VOICE_TRACKS) {
         return;
     }
-    audio_state_lock();
-    g_app.voice_layers.tracks[index].volume = fmaxf(0.0f, fminf(volume, 2.0f));
-    audio_state_unlock();
+    volume = fmaxf(0.0f, fminf(volume, 2.0f));
+    g_app.voice_layers.tracks[index].volume = volume;
+    voice_track_send_command(index, AUDIO_CMD_TRACK_VOLUME, volume);
 }
 
 static bool voice_track_save_to_disk(int index) {
@@ -629,43 +694,27 @@ static bool voice_track_save_to_disk(int index) {
         return false;
     }
 
-    float* copy = NULL;
-    uint32_t frame_count = 0;
-    uint32_t channels = 0;
-    uint32_t sample_rate = 0;
-
-    audio_state_lock();
+    // The take is already on disk; saving just moves it into place
     VoiceTrack* track = &g_app.voice_layers.tracks[index];
-    if (track->buffer.data && track->buffer.frame_count > 0) {
-        frame_count = track->buffer.frame_count;
-        channels = track->buffer.channels;
-        sample_rate = track->buffer.sample_rate;
-        size_t samples = (size_t)frame_count * channels;
-        copy = (float*)malloc(samples * sizeof(float));
-        if (copy) {
-            memcpy(copy, track->buffer.data, samples * sizeof(float));
-        }
-    }
-    audio_state_unlock();
-
-    if (!copy) {
+    if (!track->source || track->source->frame_count == 0) {
         return false;
     }
-
-    ensure_directory_exists(g_app.voice_layers.recordings_dir);
+    if (!track->take_path[0]) {
+        return track->last_saved_path[0] != '\0';
+    }
 
     char filepath[260];
     snprintf(filepath, sizeof(filepath), "%s/voice_track_%d.wav",
              g_app.voice_layers.recordings_dir, index + 1);
-    bool ok = sample_buffer_write_wav(filepath, copy, frame_count, channels, sample_rate);
-    free(copy);
+    remove(filepath); // rename() does not replace on Windows
+    bool ok = rename(track->take_path, filepath) == 0;
+    if (ok) {
+        track->take_path[0] = '\0';
+    }
 
     if (ok) {
-        audio_state_lock();
-        VoiceTrack* track = &g_app.voice_layers.tracks[index];
         strncpy(track->last_saved_path, filepath, sizeof(track->last_saved_path) - 1);
         track->last_saved_path[sizeof(track->last_saved_path) - 1] = '\0';
-        audio_state_unlock();
         printf("ðŸ’¾ Saved voice track %d to %s\n", index + 1, filepath);
     } else {
         fprintf(stderr, "âŒ Failed to save voice track %d to %s\n", index + 1, filepath);
@@ -678,23 +727,28 @@ static bool voice_track_save_to_disk(int index) {
 // APPLICATION STATE
 // ============================================================================
 
+// Knob/slider values coalesce: the audio thread applies only the latest one
 static void enqueue_param_float_msg(ParamId id, float value) {
     ParamMsg msg = {0};
     msg.id = (uint32_t)id;
     msg.type = PARAM_FLOAT;
     msg.value.f = value;
-    if (!param_queue_enqueue(&msg)) {
-        fprintf(stderr, "âš ï¸ Param queue full (float id %u)\n", msg.id);
+    if (!param_queue_set(&msg)) {
+        rt_log(RT_LOG_WARN, "Unknown param (float id %u)", msg.id);
     }
 }
 
+// Panic is an event, so it keeps its place in the ring; other int/bool
+// params are settings and coalesce like the floats
+
 static void enqueue_param_int_msg(ParamId id, int value) {
     ParamMsg msg = {0};
     msg.id = (uint32_t)id;
     msg.type = PARAM_INT;
     msg.value.i = value;
-    if (!param_queue_enqueue(&msg)) {
-        fprintf(stderr, "âš ï¸ Param queue full (int id %u)\n", msg.id);
+    bool queued = id == PARAM_PANIC ? param_queue_enqueue(&msg) : param_queue_set(&msg);
+    if (!queued) {
+        rt_log(RT_LOG_WARN, "Param queue full (int id %u)", msg.id);
     }
 }
 
@@ -702,8 +756,6 @@ static void app_apply_tempo(float bpm) {
     if (bpm <= 0.0f) {
         return;
     }
-    g_app.tempo = bpm;
-    synth_set_tempo(&g_app.synth, bpm);
     g_app.knob_tempo.value = bpm;
     enqueue_param_float_msg(PARAM_TEMPO, bpm);
 }
@@ -776,11 +828,16 @@ static PresetSnippetEntry* preset_snippet_entry_for_name(PresetSnippetLibrary* l
         if (entry->in_use) {
             continue;
         }
-        memset(entry, 0, sizeof(*entry));
+        // Only UI-owned fields; the audio side of a free entry is already idle
         entry->in_use = 1;
         snprintf(entry->preset_name, sizeof(entry->preset_name), "%s", preset_name);
         for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
-            sample_buffer_init(&entry->snippets[s].buffer);
+            PresetSnippet* snippet = &entry->snippets[s];
+            snippet->source = NULL;
+            snippet->captured_tempo = 0.0f;
+            snippet->take_stream = -1;
+            snippet->take_relative_path[0] = '\0';
+            snippet->relative_path[0] = '\0';
         }
         entry->average_tempo = 0.0f;
         if (out_index) {
@@ -793,10 +850,10 @@ static PresetSnippetEntry* preset_snippet_entry_for_name(PresetSnippetLibrary* l
 }
 
 static int preset_snippet_has_audio(const PresetSnippet* snippet) {
-    return snippet && snippet->buffer.data && snippet->buffer.frame_count > 0;
+    return snippet && snippet->source && snippet->source->frame_count > 0;
 }
 
-static void preset_snippet_play_all_advance_locked(PresetSnippetLibrary* lib);
+static void preset_snippet_play_all_advance_rt(PresetSnippetLibrary* lib);
 
 static void preset_snippet_update_average(PresetSnippetEntry* entry) {
     if (!entry) {
@@ -814,14 +871,14 @@ static void preset_snippet_update_average(PresetSnippetEntry* entry) {
     entry->average_tempo = count > 0 ? (sum / (float)count) : 0.0f;
 }
 
-static bool preset_snippet_write_to_disk(PresetSnippetLibrary* lib,
-                                         PresetSnippetEntry* entry,
-                                         PresetSnippet* snippet,
-                                         const float* interleaved,
-                                         uint32_t frame_count,
-                                         uint32_t channels,
-                                         uint32_t sample_rate) {
-    if (!lib || !entry || !snippet || !interleaved || frame_count == 0 || channels == 0) {
+// Pick the file a new take streams into: <base>/<preset>/<preset>_<time>.wav
+static bool preset_snippet_take_path(PresetSnippetLibrary* lib,
+                                     const PresetSnippetEntry* entry,
+                                     char* full_path,
+                                     size_t full_path_size,
+                                     char* relative_path,
+                                     size_t relative_path_size) {
+    if (!lib || !entry || !full_path || !relative_path) {
         return false;
     }
     ensure_directory_exists(lib->base_dir);
@@ -851,15 +908,9 @@ static bool preset_snippet_write_to_disk(PresetSnippetLibrary* lib,
              tm_info.tm_min,
              tm_info.tm_sec);
 
-    char full_path[520];
-    snprintf(full_path, sizeof(full_path), "%s/%s", preset_dir, filename);
-
-    bool ok = sample_buffer_write_wav(full_path, interleaved, frame_count, channels, sample_rate);
-    if (ok) {
-        snprintf(snippet->relative_path, sizeof(snippet->relative_path), "%s/%s", preset_folder, filename);
-        printf("ðŸ’¾ Preset snippet saved to %s\n", full_path);
-    }
-    return ok;
+    snprintf(full_path, full_path_size, "%s/%s", preset_dir, filename);
+    snprintf(relative_path, relative_path_size, "%s/%s", preset_folder, filename);
+    return true;
 }
 
 static void preset_snippet_library_save_manifest(PresetSnippetLibrary* lib) {
@@ -931,7 +982,7 @@ static void preset_snippet_library_load_manifest(PresetSnippetLibrary* lib) {
     if (!data) {
         return;
     }
-    cJSON* root = cJSON_ParseWithLength(data, (size_t)size);
+    cJSON* root = preset_json_parse(data, (size_t)size);
     free(data);
     if (!root) {
         return;
@@ -967,12 +1018,15 @@ static void preset_snippet_library_load_manifest(PresetSnippetLibrary* lib) {
                 char full_path[520];
                 snprintf(full_path, sizeof(full_path), "%s/%s", lib->base_dir, file->valuestring);
                 PresetSnippet* snippet = &entry->snippets[slot];
-                if (sample_buffer_load_wav(&snippet->buffer, full_path)) {
-                    snippet->record_capacity_frames = snippet->buffer.frame_count;
-                    snippet->recorded_frames = snippet->buffer.frame_count;
+                snippet->source = sample_source_create(full_path);
+                if (snippet->source) {
+                    // Loaded before the audio device starts, so the audio-side
+                    // fields can be seeded directly
+                    snippet->rt_source = snippet->source;
                     snippet->playback_pos = 0;
-                    snippet->recording = 0;
-                    snippet->playing = 0;
+                    atomic_store(&snippet->recorded_frames, snippet->source->frame_count);
+                    atomic_store(&snippet->recording, 0);
+                    atomic_store(&snippet->playing, 0);
                     snippet->captured_tempo = cJSON_IsNumber(tempo) ? (float)tempo->valuedouble : 120.0f;
                     snprintf(snippet->relative_path, sizeof(snippet->relative_path), "%s", file->valuestring);
                     ++slot;
@@ -995,142 +1049,223 @@ static void preset_snippet_library_init(PresetSnippetLibrary* lib) {
     for (int i = 0; i < MAX_PRESET_SNIPPET_PRESETS; ++i) {
         lib->entries[i].in_use = 0;
         for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
-            sample_buffer_init(&lib->entries[i].snippets[s].buffer);
+            lib->entries[i].snippets[s].source = NULL;
         }
     }
-    lib->active_entry_index = -1;
-    lib->active_snippet_index = -1;
+    lib->record_entry_index = -1;
+    lib->record_snippet_index = -1;
+    lib->play_entry_index = -1;
+    lib->play_snippet_index = -1;
     lib->play_all_entry_index = -1;
     lib->play_all_snippet_index = -1;
-    lib->pending_save_entry_index = -1;
-    lib->pending_save_snippet_index = -1;
+    lib->record_stage.stream = -1;
+    for (int i = 0; i < MAX_PRESET_SNIPPET_PRESETS; ++i) {
+        for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
+            lib->entries[i].snippets[s].take_stream = -1;
+        }
+    }
     preset_snippet_library_load_manifest(lib);
 }
 
-static void preset_snippet_schedule_save_locked(PresetSnippetLibrary* lib,
-                                                int entry_index,
-                                                int snippet_index) {
-    if (!lib) {
-        return;
-    }
-    lib->pending_save_ready = 1;
-    lib->pending_save_entry_index = entry_index;
-    lib->pending_save_snippet_index = snippet_index;
+static int preset_snippet_is_recording(PresetSnippet* snippet) {
+    return snippet && atomic_load_explicit(&snippet->recording, memory_order_relaxed);
+}
+
+static int preset_snippet_rt_has_audio(const PresetSnippet* snippet) {
+    return snippet->rt_source && snippet->rt_source->frame_count > 0;
 }
 
-static void preset_snippet_finalize_recording_locked(PresetSnippetLibrary* lib,
-                                                     int entry_index,
-                                                     int snippet_index) {
-    if (!lib || entry_index < 0 || snippet_index < 0) {
+static void preset_snippet_finalize_recording_rt(PresetSnippetLibrary* lib) {
+    PresetSnippet* snippet = lib->active_recording;
+    if (!snippet) {
         return;
     }
-    PresetSnippetEntry* entry = &lib->entries[entry_index];
-    PresetSnippet* snippet = &entry->snippets[snippet_index];
-    snippet->recording = 0;
-    snippet->buffer.frame_count = snippet->recorded_frames;
+    atomic_store_explicit(&snippet->recording, 0, memory_order_relaxed);
     lib->active_recording = NULL;
-    lib->active_entry_index = entry_index;
-    lib->active_snippet_index = snippet_index;
-    if (snippet->recorded_frames == 0) {
+    record_stage_end_rt(&lib->record_stage);
+}
+
+static void preset_snippet_stop_playback_rt(PresetSnippetLibrary* lib, int preserve_play_all) {
+    if (!lib) {
         return;
     }
-    preset_snippet_schedule_save_locked(lib, entry_index, snippet_index);
+    if (lib->active_playback) {
+        atomic_store_explicit(&lib->active_playback->playing, 0, memory_order_relaxed);
+        lib->active_playback->playback_pos = 0;
+        lib->active_playback = NULL;
+    }
+    if (!preserve_play_all) {
+        atomic_store_explicit(&lib->play_all_active, 0, memory_order_relaxed);
+        lib->play_all_entry_index = -1;
+        lib->play_all_snippet_index = -1;
+    }
 }
 
-static void preset_snippet_flush_pending_save(PresetSnippetLibrary* lib) {
-    if (!lib || !lib->pending_save_ready) {
+static void preset_snippet_start_playback_rt(PresetSnippetLibrary* lib,
+                                             int entry_index,
+                                             int snippet_index) {
+    if (!lib || entry_index < 0 || snippet_index < 0 ||
+        entry_index >= MAX_PRESET_SNIPPET_PRESETS || snippet_index >= MAX_SNIPPETS_PER_PRESET) {
         return;
     }
-    const int entry_index = lib->pending_save_entry_index;
-    const int snippet_index = lib->pending_save_snippet_index;
-    if (entry_index < 0 || snippet_index < 0 || entry_index >= MAX_PRESET_SNIPPET_PRESETS) {
-        lib->pending_save_ready = 0;
+    PresetSnippet* snippet = &lib->entries[entry_index].snippets[snippet_index];
+    if (!preset_snippet_rt_has_audio(snippet) || snippet == lib->active_recording) {
         return;
     }
-    PresetSnippetEntry* entry = &lib->entries[entry_index];
-    if (!entry->in_use) {
-        lib->pending_save_ready = 0;
+    preset_snippet_stop_playback_rt(lib, atomic_load_explicit(&lib->play_all_active, memory_order_relaxed));
+    atomic_store_explicit(&snippet->playing, 1, memory_order_relaxed);
+    snippet->playback_pos = 0;
+    lib->active_playback = snippet;
+    lib->play_entry_index = entry_index;
+    lib->play_snippet_index = snippet_index;
+
+    // The UI applies the entry's tempo when it sees this
+    AudioHandoffMsg event = {0};
+    event.type = AUDIO_EVENT_SNIPPET_STARTED;
+    event.index = entry_index;
+    event.slot = snippet_index;
+    audio_event_push(&event);
+}
+
+static void preset_snippet_play_all_advance_rt(PresetSnippetLibrary* lib) {
+    if (!lib) {
         return;
     }
-    PresetSnippet* snippet = &entry->snippets[snippet_index];
-    if (!preset_snippet_has_audio(snippet)) {
-        lib->pending_save_ready = 0;
+    int start_entry = lib->play_all_entry_index;
+    int start_slot = lib->play_all_snippet_index;
+    if (start_entry < 0) {
+        start_entry = 0;
+        start_slot = -1;
+    }
+    int entry = start_entry;
+    int slot = start_slot;
+    const int max_iters = MAX_PRESET_SNIPPET_PRESETS * MAX_SNIPPETS_PER_PRESET;
+    for (int iter = 0; iter < max_iters; ++iter) {
+        ++slot;
+        if (slot >= MAX_SNIPPETS_PER_PRESET) {
+            slot = 0;
+            ++entry;
+            if (entry >= MAX_PRESET_SNIPPET_PRESETS) {
+                entry = 0;
+            }
+        }
+        if (entry == start_entry && slot == start_slot) {
+            break;
+        }
+        // Free entries have no audio-side data, so in_use (UI-owned) isn't needed
+        if (!preset_snippet_rt_has_audio(&lib->entries[entry].snippets[slot])) {
+            continue;
+        }
+        preset_snippet_start_playback_rt(lib, entry, slot);
+        lib->play_all_entry_index = entry;
+        lib->play_all_snippet_index = slot;
         return;
     }
+    atomic_store_explicit(&lib->play_all_active, 0, memory_order_relaxed);
+    lib->play_all_entry_index = -1;
+    lib->play_all_snippet_index = -1;
+    lib->active_playback = NULL;
+}
 
-    float* copy = NULL;
-    uint32_t frame_count = 0;
-    uint32_t channels = 0;
-    uint32_t sample_rate = 0;
+static void preset_snippet_apply_command_rt(const AudioHandoffMsg* cmd) {
+    PresetSnippetLibrary* lib = &g_app.preset_snippets;
+    bool has_slot = cmd->index >= 0 && cmd->index < MAX_PRESET_SNIPPET_PRESETS &&
+                    cmd->slot >= 0 && cmd->slot < MAX_SNIPPETS_PER_PRESET;
 
-    audio_state_lock();
-    size_t sample_count = (size_t)snippet->buffer.frame_count * snippet->buffer.channels;
-    if (sample_count > 0 && snippet->buffer.data) {
-        copy = (float*)malloc(sample_count * sizeof(float));
-        if (copy) {
-            memcpy(copy, snippet->buffer.data, sample_count * sizeof(float));
-            frame_count = snippet->buffer.frame_count;
-            channels = snippet->buffer.channels;
-            sample_rate = snippet->buffer.sample_rate;
+    switch (cmd->type) {
+        case AUDIO_CMD_SNIPPET_RECORD: {
+            if (!has_slot) {
+                return;
+            }
+            preset_snippet_stop_playback_rt(lib, 0);
+            preset_snippet_finalize_recording_rt(lib);
+            PresetSnippet* snippet = &lib->entries[cmd->index].snippets[cmd->slot];
+            audio_retire_source(snippet->rt_source);
+            snippet->rt_source = NULL;
+            snippet->playback_pos = 0;
+            lib->record_stage.stream = cmd->stream;
+            lib->record_stage.frames = 0;
+            atomic_store_explicit(&snippet->recorded_frames, 0, memory_order_relaxed);
+            atomic_store_explicit(&snippet->playing, 0, memory_order_relaxed);
+            atomic_store_explicit(&snippet->recording, cmd->stream >= 0 ? 1 : 0, memory_order_relaxed);
+            lib->active_recording = cmd->stream >= 0 ? snippet : NULL;
+            lib->record_entry_index = cmd->index;
+            lib->record_snippet_index = cmd->slot;
+            break;
         }
-    }
-    lib->pending_save_ready = 0;
-    audio_state_unlock();
 
-    if (!copy) {
-        return;
-    }
+        case AUDIO_CMD_SNIPPET_STOP_RECORD:
+            if (has_slot && lib->active_recording == &lib->entries[cmd->index].snippets[cmd->slot]) {
+                preset_snippet_finalize_recording_rt(lib);
+            }
+            break;
+
+        case AUDIO_CMD_SNIPPET_PLAY:
+            atomic_store_explicit(&lib->play_all_active, 0, memory_order_relaxed);
+            lib->play_all_entry_index = -1;
+            lib->play_all_snippet_index = -1;
+            if (has_slot) {
+                preset_snippet_start_playback_rt(lib, cmd->index, cmd->slot);
+            }
+            break;
+
+        case AUDIO_CMD_SNIPPET_PLAY_ALL:
+            atomic_store_explicit(&lib->play_all_active, 1, memory_order_relaxed);
+            lib->play_all_entry_index = -1;
+            lib->play_all_snippet_index = -1;
+            preset_snippet_play_all_advance_rt(lib);
+            break;
+
+        case AUDIO_CMD_SNIPPET_STOP:
+            preset_snippet_stop_playback_rt(lib, 0);
+            break;
+
+        case AUDIO_CMD_SNIPPET_LOAD: {
+            PresetSnippet* snippet = has_slot ? &lib->entries[cmd->index].snippets[cmd->slot] : NULL;
+            if (!snippet || snippet == lib->active_recording) {
+                audio_retire_source(cmd->source);
+                break;
+            }
+            if (snippet == lib->active_playback) {
+                preset_snippet_stop_playback_rt(lib, 0);
+            }
+            audio_retire_source(snippet->rt_source);
+            snippet->rt_source = cmd->source;
+            snippet->playback_pos = 0;
+            break;
+        }
 
-    if (preset_snippet_write_to_disk(lib, entry, snippet, copy, frame_count, channels, sample_rate)) {
-        preset_snippet_update_average(entry);
-        preset_snippet_library_save_manifest(lib);
+        default:
+            break;
     }
-    free(copy);
 }
 
 static void preset_snippet_process_frame(float* left, float* right) {
     PresetSnippetLibrary* lib = &g_app.preset_snippets;
-    if (!lib) {
-        return;
-    }
-    if (lib->active_recording && lib->active_recording->recording) {
+    if (lib->active_recording) {
         PresetSnippet* rec = lib->active_recording;
-        if (rec->recorded_frames < rec->record_capacity_frames && rec->buffer.data) {
-            size_t idx = (size_t)rec->recorded_frames * rec->buffer.channels;
-            rec->buffer.data[idx] = *left;
-            if (rec->buffer.channels > 1) {
-                rec->buffer.data[idx + 1] = *right;
-            }
-            rec->recorded_frames++;
-            if (rec->recorded_frames >= rec->record_capacity_frames) {
-                preset_snippet_finalize_recording_locked(lib,
-                                                        lib->active_entry_index,
-                                                        lib->active_snippet_index);
-            }
-        }
+        record_stage_push_rt(&lib->record_stage, *left, *right);
+        uint32_t recorded = atomic_load_explicit(&rec->recorded_frames, memory_order_relaxed);
+        atomic_store_explicit(&rec->recorded_frames, recorded + 1, memory_order_relaxed);
     }
 
     float playback_l = 0.0f;
     float playback_r = 0.0f;
-    if (lib->active_playback && lib->active_playback->playing) {
+    if (lib->active_playback) {
         PresetSnippet* snippet = lib->active_playback;
-        if (snippet->playback_pos < snippet->buffer.frame_count) {
-            size_t idx = (size_t)snippet->playback_pos * snippet->buffer.channels;
-            playback_l = snippet->buffer.data[idx];
-            playback_r = (snippet->buffer.channels > 1) ? snippet->buffer.data[idx + 1] : playback_l;
+        if (snippet->playback_pos < snippet->rt_source->frame_count) {
+            sample_source_read_frame(snippet->rt_source, snippet->playback_pos, &playback_l, &playback_r);
             snippet->playback_pos++;
-        } else {
-            snippet->playing = 0;
         }
 
-        if (!snippet->playing || snippet->playback_pos >= snippet->buffer.frame_count) {
-            snippet->playing = 0;
+        if (snippet->playback_pos >= snippet->rt_source->frame_count) {
+            atomic_store_explicit(&snippet->playing, 0, memory_order_relaxed);
             snippet->playback_pos = 0;
             lib->active_playback = NULL;
-            if (lib->play_all_active) {
-                lib->play_all_entry_index = lib->active_entry_index;
-                lib->play_all_snippet_index = lib->active_snippet_index;
-                preset_snippet_play_all_advance_locked(lib);
+            if (atomic_load_explicit(&lib->play_all_active, memory_order_relaxed)) {
+                lib->play_all_entry_index = lib->play_entry_index;
+                lib->play_all_snippet_index = lib->play_snippet_index;
+                preset_snippet_play_all_advance_rt(lib);
             } else {
                 lib->play_all_entry_index = -1;
                 lib->play_all_snippet_index = -1;
@@ -1142,107 +1277,211 @@ static void preset_snippet_process_frame(float* left, float* right) {
     *right += playback_r;
 }
 
-static void preset_snippet_tick(void) {
-    preset_snippet_flush_pending_save(&g_app.preset_snippets);
+// ============================================================================
+// AUDIO HANDOFF
+// ============================================================================
+
+static void patch_apply_rt(SynthPatch* patch);
+
+// Audio thread: apply everything the UI queued since the last period
+static void audio_commands_apply_rt(void) {
+    audio_retire_flush();
+    AudioHandoffMsg cmd;
+    while (audio_command_pop(&cmd)) {
+        if (cmd.type <= AUDIO_CMD_TRACK_LOAD) { // Track commands come first in the enum
+            voice_track_apply_command_rt(&cmd);
+        } else if (cmd.type == AUDIO_CMD_TRANSPORT_START) {
+            sequencer_start(&g_app.core.sequencer, g_app.core.synth.sample_counter);
+        } else if (cmd.type == AUDIO_CMD_TRANSPORT_STOP) {
+            sequencer_stop(&g_app.core.sequencer, &g_app.core.arp, &g_app.core.synth);
+        } else if (cmd.type == AUDIO_CMD_PATCH_LOAD) {
+            patch_apply_rt(cmd.patch);
+        } else if (cmd.type == AUDIO_CMD_SET_OVERSAMPLE) {
+            synth_core_set_oversample(&g_app.core, (SynthOversampleStage)cmd.index, (OversampleMode)cmd.slot);
+        } else if (cmd.type == AUDIO_CMD_SET_LIMITER_LOOKAHEAD) {
+            synth_set_limiter_lookahead(&g_app.core.synth, cmd.value);
+        } else {
+            preset_snippet_apply_command_rt(&cmd);
+        }
+    }
 }
 
-static void preset_snippet_stop_playback_locked(PresetSnippetLibrary* lib, int preserve_play_all) {
-    if (!lib || !lib->active_playback) {
-        return;
+// UI thread: start or stop sequencer playback
+static void transport_set_playing(bool playing) {
+    AudioHandoffMsg cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = playing ? AUDIO_CMD_TRANSPORT_START : AUDIO_CMD_TRANSPORT_STOP;
+    if (audio_command_push(&cmd)) {
+        g_app.playing = playing;
     }
-    lib->active_playback->playing = 0;
-    lib->active_playback->playback_pos = 0;
-    lib->active_playback = NULL;
-    if (!preserve_play_all) {
-        lib->play_all_active = 0;
-        lib->play_all_entry_index = -1;
-        lib->play_all_snippet_index = -1;
+}
+
+// UI thread: Off/2x/4x picker for one oversampled stage
+static void ui_oversample_combo(struct nk_context* ctx, const char* label, SynthOversampleStage stage) {
+    static const char* modes[OVERSAMPLE_MODE_COUNT] = {"Off", "2x", "4x"};
+    nk_layout_row_dynamic(ctx, 28, 2);
+    nk_label(ctx, label, NK_TEXT_LEFT);
+    int mode = g_app.oversample[stage];
+    int new_mode = nk_combo(ctx, modes, OVERSAMPLE_MODE_COUNT, mode, 28, nk_vec2(120, 100));
+    if (new_mode != mode) {
+        AudioHandoffMsg cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = AUDIO_CMD_SET_OVERSAMPLE;
+        cmd.index = (int32_t)stage;
+        cmd.slot = new_mode;
+        if (audio_command_push(&cmd)) {
+            g_app.oversample[stage] = new_mode;
+        }
     }
 }
 
-static void preset_snippet_start_playback_locked(PresetSnippetLibrary* lib,
-                                                 int entry_index,
-                                                 int snippet_index) {
-    if (!lib || entry_index < 0 || snippet_index < 0) {
-        return;
+// UI thread: master limiter lookahead, with the latency it adds
+static void ui_limiter_lookahead(struct nk_context* ctx) {
+    char label[64];
+    snprintf(label, sizeof(label), "Limiter lookahead %.1f ms (%d frames)", g_app.limiter_lookahead_ms,
+             limiter_latency_frames(g_app.limiter_lookahead_ms, g_app.core.synth.sample_rate));
+    nk_layout_row_dynamic(ctx, 20, 1);
+    nk_label(ctx, label, NK_TEXT_LEFT);
+    nk_layout_row_dynamic(ctx, 28, 1);
+    float ms = g_app.limiter_lookahead_ms;
+    if (nk_slider_float(ctx, 0.0f, &ms, DYN_LIMITER_MAX_LOOKAHEAD_MS, 0.5f)) {
+        AudioHandoffMsg cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = AUDIO_CMD_SET_LIMITER_LOOKAHEAD;
+        cmd.value = ms;
+        if (audio_command_push(&cmd)) {
+            g_app.limiter_lookahead_ms = ms;
+        }
+    }
+}
+
+// UI thread: drop any view of a retired source. Normally a newer take or a
+// clear has already replaced it; this keeps stale views from surviving.
+static void audio_forget_source(const SampleSource* source) {
+    for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
+        if (g_app.voice_layers.tracks[i].source == source) {
+            g_app.voice_layers.tracks[i].source = NULL;
+        }
     }
+    for (int e = 0; e < MAX_PRESET_SNIPPET_PRESETS; ++e) {
+        for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
+            PresetSnippet* snippet = &g_app.preset_snippets.entries[e].snippets[s];
+            if (snippet->source == source) {
+                snippet->source = NULL;
+            }
+        }
+    }
+}
+
+// UI thread: react to the audio thread and free retired buffers
+static void audio_events_process(void) {
+    AudioHandoffMsg event;
+    while (audio_event_pop(&event)) {
+        switch (event.type) {
+            case AUDIO_EVENT_RETIRE:
+                free(event.buffer);
+                break;
+
+            case AUDIO_EVENT_RETIRE_SOURCE:
+                audio_forget_source(event.source);
+                retired_source_destroy(event.source);
+                break;
+
+            case AUDIO_EVENT_RETIRE_PATCH:
+                free(event.patch);
+                break;
+
+            case AUDIO_EVENT_SNIPPET_STARTED: {
+                if (event.index < 0 || event.index >= MAX_PRESET_SNIPPET_PRESETS) {
+                    break;
+                }
+                const PresetSnippetEntry* entry = &g_app.preset_snippets.entries[event.index];
+                if (entry->average_tempo > 0.0f) {
+                    app_apply_tempo(entry->average_tempo);
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+// UI thread: once a snippet's stream has closed, load it for playback and
+// record it in the manifest (the file itself is already in place)
+static void preset_snippet_collect_take(PresetSnippetLibrary* lib, int entry_index, int slot_index) {
     PresetSnippetEntry* entry = &lib->entries[entry_index];
-    if (!entry->in_use) {
+    PresetSnippet* snippet = &entry->snippets[slot_index];
+    if (snippet->take_stream < 0) {
         return;
     }
-    PresetSnippet* snippet = &entry->snippets[snippet_index];
-    if (!preset_snippet_has_audio(snippet)) {
+    DiskStreamState state = disk_stream_state(snippet->take_stream);
+    if (state != DISK_STREAM_CLOSED && state != DISK_STREAM_FAILED) {
         return;
     }
-    preset_snippet_stop_playback_locked(lib, lib->play_all_active);
-    snippet->playing = 1;
-    snippet->playback_pos = 0;
-    lib->active_playback = snippet;
-    lib->active_entry_index = entry_index;
-    lib->active_snippet_index = snippet_index;
-    if (entry->average_tempo > 0.0f) {
-        app_apply_tempo(entry->average_tempo);
+    uint64_t frames = disk_stream_frames_written(snippet->take_stream);
+    uint64_t dropped = disk_stream_frames_dropped(snippet->take_stream);
+    disk_stream_release(snippet->take_stream);
+    snippet->take_stream = -1;
+    if (dropped > 0) {
+        fprintf(stderr, "Preset snippet take dropped %llu frames (disk too slow)\n",
+                (unsigned long long)dropped);
     }
-}
 
-static void preset_snippet_play_all_advance_locked(PresetSnippetLibrary* lib) {
-    if (!lib) {
+    char full_path[520];
+    snprintf(full_path, sizeof(full_path), "%s/%s", lib->base_dir, snippet->take_relative_path);
+    if (frames == 0) {
+        remove(full_path);
         return;
     }
-    int start_entry = lib->play_all_entry_index;
-    int start_slot = lib->play_all_snippet_index;
-    if (start_entry < 0) {
-        start_entry = 0;
-        start_slot = -1;
+    SampleSource* take = sample_source_create(full_path);
+    if (!take) {
+        return;
     }
-    int entry = start_entry;
-    int slot = start_slot;
-    const int max_iters = MAX_PRESET_SNIPPET_PRESETS * MAX_SNIPPETS_PER_PRESET;
-    for (int iter = 0; iter < max_iters; ++iter) {
-        ++slot;
-        if (slot >= MAX_SNIPPETS_PER_PRESET) {
-            slot = 0;
-            ++entry;
-            if (entry >= MAX_PRESET_SNIPPET_PRESETS) {
-                entry = 0;
-            }
-        }
-        if (entry == start_entry && slot == start_slot) {
-            break;
-        }
-        PresetSnippetEntry* candidate = &lib->entries[entry];
-        if (!candidate->in_use) {
-            continue;
-        }
-        if (!preset_snippet_has_audio(&candidate->snippets[slot])) {
-            continue;
-        }
-        preset_snippet_start_playback_locked(lib, entry, slot);
-        lib->play_all_entry_index = entry;
-        lib->play_all_snippet_index = slot;
+    AudioHandoffMsg cmd = {0};
+    cmd.type = AUDIO_CMD_SNIPPET_LOAD;
+    cmd.index = entry_index;
+    cmd.slot = slot_index;
+    cmd.source = take;
+    if (!audio_command_push(&cmd)) {
+        sample_source_destroy(take);
         return;
     }
-    lib->play_all_active = 0;
-    lib->play_all_entry_index = -1;
-    lib->play_all_snippet_index = -1;
-    lib->active_playback = NULL;
+    snippet->source = take;
+    memcpy(snippet->relative_path, snippet->take_relative_path, sizeof(snippet->relative_path));
+    printf("Preset snippet saved to %s\n", full_path);
+    preset_snippet_update_average(entry);
+    preset_snippet_library_save_manifest(lib);
 }
 
-static void preset_snippet_play_all_start(void) {
+static void preset_snippet_tick(void) {
+    audio_events_process();
+    for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
+        voice_track_collect_take(i);
+    }
     PresetSnippetLibrary* lib = &g_app.preset_snippets;
-    preset_snippet_flush_pending_save(lib);
-    audio_state_lock();
-    lib->play_all_active = 1;
-    lib->play_all_entry_index = -1;
-    lib->play_all_snippet_index = -1;
-    preset_snippet_play_all_advance_locked(lib);
-    audio_state_unlock();
+    for (int e = 0; e < MAX_PRESET_SNIPPET_PRESETS; ++e) {
+        for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
+            preset_snippet_collect_take(lib, e, s);
+        }
+    }
+}
+
+static void preset_snippet_send_command(AudioHandoffType type, int entry_index, int slot_index) {
+    AudioHandoffMsg cmd = {0};
+    cmd.type = type;
+    cmd.index = entry_index;
+    cmd.slot = slot_index;
+    audio_command_push(&cmd);
+}
+
+static void preset_snippet_play_all_start(void) {
+    preset_snippet_send_command(AUDIO_CMD_SNIPPET_PLAY_ALL, -1, -1);
 }
 
 static void preset_snippet_play_all_stop(void) {
-    audio_state_lock();
-    preset_snippet_stop_playback_locked(&g_app.preset_snippets, 0);
-    audio_state_unlock();
+    preset_snippet_send_command(AUDIO_CMD_SNIPPET_STOP, -1, -1);
 }
 
 static void preset_snippet_begin_recording_slot(const char* preset_name, int slot_index) {
@@ -1250,84 +1489,73 @@ static void preset_snippet_begin_recording_slot(const char* preset_name, int slo
         return;
     }
     PresetSnippetLibrary* lib = &g_app.preset_snippets;
-    preset_snippet_flush_pending_save(lib);
-    audio_state_lock();
-    preset_snippet_stop_playback_locked(lib, 0);
     int entry_index = -1;
     PresetSnippetEntry* entry = preset_snippet_entry_for_name(lib, preset_name, 1, &entry_index);
     if (!entry) {
-        audio_state_unlock();
         return;
     }
     PresetSnippet* snippet = &entry->snippets[slot_index];
-    sample_buffer_free(&snippet->buffer);
-    snippet->relative_path[0] = '\0';
-    snippet->buffer.channels = 2;
-    snippet->buffer.sample_rate = (uint32_t)(g_app.synth.sample_rate > 0.0f ? g_app.synth.sample_rate : 44100.0f);
-    snippet->record_capacity_frames = snippet->buffer.sample_rate * PRESET_SNIPPET_MAX_SECONDS;
-    size_t samples = (size_t)snippet->record_capacity_frames * snippet->buffer.channels;
-    snippet->buffer.data = (float*)malloc(samples * sizeof(float));
-    if (!snippet->buffer.data) {
-        audio_state_unlock();
-        fprintf(stderr, "âŒ Unable to allocate preset snippet buffer\n");
+    if (snippet->take_stream >= 0) {
+        return; // Previous take is still being finalized
+    }
+
+    char full_path[520];
+    char relative_path[260];
+    if (!preset_snippet_take_path(lib, entry, full_path, sizeof(full_path),
+                                  relative_path, sizeof(relative_path))) {
         return;
     }
-    snippet->buffer.frame_count = 0;
-    snippet->recorded_frames = 0;
-    snippet->playback_pos = 0;
-    snippet->recording = 1;
-    snippet->playing = 0;
-    snippet->captured_tempo = g_app.tempo;
-    lib->active_recording = snippet;
-    lib->active_entry_index = entry_index;
-    lib->active_snippet_index = slot_index;
-    audio_state_unlock();
+    uint32_t sample_rate = (uint32_t)record_sample_rate();
+    int stream = disk_stream_open(full_path, RECORD_CHANNELS, sample_rate);
+    if (stream < 0) {
+        return;
+    }
+
+    AudioHandoffMsg cmd = {0};
+    cmd.type = AUDIO_CMD_SNIPPET_RECORD;
+    cmd.index = entry_index;
+    cmd.slot = slot_index;
+    cmd.stream = stream;
+    cmd.channels = RECORD_CHANNELS;
+    if (!audio_command_push(&cmd)) {
+        disk_stream_finish(stream);
+    }
+
+    snippet->source = NULL;
+    snippet->take_stream = stream;
+    snprintf(snippet->take_relative_path, sizeof(snippet->take_relative_path), "%s", relative_path);
+    snippet->relative_path[0] = '\0';
+    snippet->captured_tempo = g_app.knob_tempo.value;
 }
 
 static void preset_snippet_stop_recording_slot(const char* preset_name, int slot_index) {
     if (slot_index < 0 || slot_index >= MAX_SNIPPETS_PER_PRESET) {
         return;
     }
-    PresetSnippetLibrary* lib = &g_app.preset_snippets;
-    audio_state_lock();
     int entry_index = -1;
-    PresetSnippetEntry* entry = preset_snippet_entry_for_name(lib, preset_name, 0, &entry_index);
-    if (!entry) {
-        audio_state_unlock();
+    PresetSnippetEntry* entry = preset_snippet_entry_for_name(&g_app.preset_snippets, preset_name, 0, &entry_index);
+    if (!entry || !preset_snippet_is_recording(&entry->snippets[slot_index])) {
         return;
     }
-    PresetSnippet* snippet = &entry->snippets[slot_index];
-    if (!snippet->recording) {
-        audio_state_unlock();
-        return;
-    }
-    preset_snippet_finalize_recording_locked(lib, entry_index, slot_index);
-    audio_state_unlock();
-    preset_snippet_flush_pending_save(lib);
+    // The take is loaded and added to the manifest once its stream closes
+    preset_snippet_send_command(AUDIO_CMD_SNIPPET_STOP_RECORD, entry_index, slot_index);
 }
 
 static void preset_snippet_play_slot(const char* preset_name, int slot_index) {
     PresetSnippetLibrary* lib = &g_app.preset_snippets;
-    preset_snippet_flush_pending_save(lib);
-    audio_state_lock();
-    lib->play_all_active = 0;
-    lib->play_all_entry_index = -1;
-    lib->play_all_snippet_index = -1;
     int entry_index = -1;
     PresetSnippetEntry* entry = preset_snippet_entry_for_name(lib, preset_name, 0, &entry_index);
     if (!entry) {
-        audio_state_unlock();
         return;
     }
-    preset_snippet_start_playback_locked(lib, entry_index, slot_index);
-    audio_state_unlock();
+    preset_snippet_send_command(AUDIO_CMD_SNIPPET_PLAY, entry_index, slot_index);
 }
 
 static void ui_knobs_init(void) {
-    const float filter_cutoff_max = fminf(g_app.synth.sample_rate * 0.45f, 20000.0f);
+    const float filter_cutoff_max = fminf(g_app.core.synth.sample_rate * 0.45f, 20000.0f);
     const float filter_cutoff_default = fminf(g_app.filter_cutoff, filter_cutoff_max);
     ui_knob_state_init(&g_app.knob_master_volume, 0.0f, 1.0f, g_app.master_volume);
-    ui_knob_state_init(&g_app.knob_tempo, 60.0f, 300.0f, g_app.tempo);
+    ui_knob_state_init(&g_app.knob_tempo, 60.0f, 300.0f, g_app.core.tempo);
     ui_knob_state_init(&g_app.knob_filter_cutoff, 20.0f, filter_cutoff_max, filter_cutoff_default);
     ui_knob_state_init(&g_app.knob_filter_resonance, 0.0f, 1.0f, g_app.filter_resonance);
     ui_knob_state_init(&g_app.knob_filter_env, -1.0f, 1.0f, g_app.filter_env);
@@ -1337,7 +1565,8 @@ static void ui_knobs_init(void) {
     ui_knob_state_init(&g_app.knob_env_release, 0.001f, 5.0f, g_app.env_release);
     ui_knob_state_init(&g_app.knob_osc1_detune, -50.0f, 50.0f, g_app.osc1_detune);
     ui_knob_state_init(&g_app.knob_osc1_pwm, 0.0f, 1.0f, g_app.osc1_pwm);
-    ui_knob_state_init(&g_app.knob_arp_rate, 1.0f, 16.0f, g_app.arp.rate > 0.0f ? g_app.arp.rate : 2.0f);
+    g_app.arp_mode = g_app.core.arp.mode;
+    ui_knob_state_init(&g_app.knob_arp_rate, 1.0f, 16.0f, g_app.core.arp.rate > 0.0f ? g_app.core.arp.rate : 2.0f);
     for (int i = 0; i < UI_MACRO_COUNT; ++i) {
         ui_knob_state_init(&g_app.knob_macro[i], 0.0f, 1.0f, g_app.macro_values[i]);
     }
@@ -1359,7 +1588,8 @@ static struct nk_rect ui_panel_cell_rect(int col,
 }
 
 static bool ui_note_is_active(int midi_note) {
-    if (g_app.mouse_note_playing == midi_note) {
+    // Notes from MIDI, the arp and the sequencer light up through the feed
+    if (g_app.mouse_note_playing == midi_note || meter_voices_note_held(&g_app.meter.voices, midi_note)) {
         return true;
     }
     for (size_t j = 0; j < KEYMAP_SIZE; ++j) {
@@ -1487,72 +1717,178 @@ static void draw_piano_keyboard(struct nk_context* ctx,
     }
 }
 
+// UI thread: point every control at the preset's values. Nothing is queued
+// and no engine state is touched; the patch carries them to the audio thread.
+static void app_show_preset(const PresetData* preset) {
+    g_app.master_volume = preset->master_volume;
+    g_app.knob_master_volume.value = preset->master_volume;
+    g_app.knob_tempo.value = preset->tempo;
+    g_app.filter_mode = (FilterMode)preset->filter_mode;
+    g_app.filter_cutoff = preset->filter_cutoff;
+    g_app.knob_filter_cutoff.value = preset->filter_cutoff;
+    g_app.filter_resonance = preset->filter_resonance;
+    g_app.knob_filter_resonance.value = preset->filter_resonance;
+    g_app.filter_env = preset->filter_env_amount;
+    g_app.knob_filter_env.value = preset->filter_env_amount;
+    g_app.env_attack = preset->env_attack;
+    g_app.knob_env_attack.value = preset->env_attack;
+    g_app.env_decay = preset->env_decay;
+    g_app.knob_env_decay.value = preset->env_decay;
+    g_app.env_sustain = preset->env_sustain;
+    g_app.knob_env_sustain.value = preset->env_sustain;
+    g_app.env_release = preset->env_release;
+    g_app.knob_env_release.value = preset->env_release;
+    g_app.arp_mode = (ArpMode)(int)synth_param_clamp(PARAM_ARP_MODE, (float)preset->arp.mode);
+    g_app.knob_arp_rate.value = preset_arp_rate(preset);
+    g_app.arp_enabled = preset->arp.enabled;
+    if (preset->meta.name[0]) {
+        snprintf(g_app.patch_name, sizeof(g_app.patch_name), "%s", preset->meta.name);
+    }
+}
+
+// UI thread: build the complete patch here and hand it over in one command,
+// so the audio thread never plays a half-applied preset
+static bool app_load_preset(const char* path, SynthPatchTransition transition, float fade_seconds) {
+    PresetData preset;
+    if (!preset_load_file(&preset, path)) {
+        fprintf(stderr, "❌ Failed to load preset '%s'\n", path);
+        return false;
+    }
+    SynthPatch* patch = (SynthPatch*)malloc(sizeof(SynthPatch));
+    if (!patch) {
+        return false;
+    }
+    synth_patch_init(patch);
+    // Presets don't store the oscillator deck; keep what it is set to
+    patch->params[PARAM_OSC1_WAVE] = (float)g_app.osc1_wave;
+    patch->params[PARAM_OSC1_FINE] = g_app.osc1_detune;
+    patch->params[PARAM_OSC1_PWM] = g_app.osc1_pwm;
+    patch->params[PARAM_OSC1_UNISON] = (float)g_app.osc1_unison;
+    preset_to_params(&preset, patch->params);
+    // Files are untrusted: hold every value to the engine's range and show
+    // the clamped preset, so the mode combos never index past their lists
+    for (int i = 0; i < PARAM_PARAM_COUNT; ++i) {
+        patch->params[i] = synth_param_clamp((ParamId)i, patch->params[i]);
+    }
+    preset_from_params(&preset, patch->params);
+    patch->transition = transition;
+    patch->fade_seconds = fade_seconds;
+
+    AudioHandoffMsg cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = AUDIO_CMD_PATCH_LOAD;
+    cmd.patch = patch;
+    if (!audio_command_push(&cmd)) {
+        free(patch);
+        return false;
+    }
+    app_show_preset(&preset);
+    return true;
+}
+
 // ============================================================================
 // AUDIO CALLBACK
 // ============================================================================
 
-static void apply_param_change(const ParamMsg* change, void* userdata) {
-    (void)userdata;
-    if (!change) {
-        return;
-    }
-    switch (change->id) {
-        case PARAM_FX_DISTORTION_ENABLED:
-            g_app.fx.distortion.enabled = param_msg_get_bool(change);
-            g_app.fx_dist_enabled = g_app.fx.distortion.enabled;
-            return;
-        case PARAM_FX_DISTORTION_DRIVE:
-            g_app.fx.distortion.drive = param_msg_get_float(change);
-            return;
-        case PARAM_FX_DISTORTION_MIX:
-            g_app.fx.distortion.mix = param_msg_get_float(change);
-            return;
-        case PARAM_FX_DELAY_ENABLED:
-            g_app.fx.delay.enabled = param_msg_get_bool(change);
-            g_app.fx_delay_enabled = g_app.fx.delay.enabled;
-            return;
-        case PARAM_FX_DELAY_TIME:
-            g_app.fx.delay.time_ms = param_msg_get_float(change);
-            return;
-        case PARAM_FX_DELAY_FEEDBACK:
-            g_app.fx.delay.feedback = param_msg_get_float(change);
-            return;
-        case PARAM_FX_DELAY_MIX:
-            g_app.fx.delay.mix = param_msg_get_float(change);
-            return;
-        case PARAM_FX_REVERB_ENABLED:
-            g_app.fx.reverb.enabled = param_msg_get_bool(change);
-            g_app.fx_reverb_enabled = g_app.fx.reverb.enabled;
-            return;
-        case PARAM_FX_REVERB_SIZE:
-            g_app.fx.reverb.size = param_msg_get_float(change);
-            return;
-        case PARAM_FX_REVERB_DAMPING:
-            g_app.fx.reverb.damping = param_msg_get_float(change);
-            return;
-        case PARAM_FX_REVERB_MIX:
-            g_app.fx.reverb.mix = param_msg_get_float(change);
-            return;
+// Where each FX parameter lands in the rack. Everything else goes to the
+// engine's own table.
+typedef struct {
+    float* value;     // Continuous setting
+    bool* enabled;    // Or a slot's bypass switch...
+    int* ui_enabled;  // ...and its UI mirror
+} FxParamTarget;
+
+static const FxParamTarget g_fx_param_targets[PARAM_PARAM_COUNT] = {
+    [PARAM_FX_DISTORTION_ENABLED] = {NULL, &g_app.core.fx.distortion.enabled, &g_app.fx_dist_enabled},
+    [PARAM_FX_DISTORTION_DRIVE] = {&g_app.core.fx.distortion.drive, NULL, NULL},
+    [PARAM_FX_DISTORTION_MIX] = {&g_app.core.fx.distortion.mix, NULL, NULL},
+    [PARAM_FX_CHORUS_ENABLED] = {NULL, &g_app.core.fx.chorus.enabled, &g_app.fx_chorus_enabled},
+    [PARAM_FX_CHORUS_RATE] = {&g_app.core.fx.chorus.rate, NULL, NULL},
+    [PARAM_FX_CHORUS_DEPTH] = {&g_app.core.fx.chorus.depth, NULL, NULL},
+    [PARAM_FX_CHORUS_MIX] = {&g_app.core.fx.chorus.mix, NULL, NULL},
+    [PARAM_FX_COMP_ENABLED] = {NULL, &g_app.core.fx.compressor.enabled, &g_app.fx_comp_enabled},
+    [PARAM_FX_COMP_THRESHOLD] = {&g_app.core.fx.compressor.threshold, NULL, NULL},
+    [PARAM_FX_COMP_RATIO] = {&g_app.core.fx.compressor.ratio, NULL, NULL},
+    [PARAM_FX_DELAY_ENABLED] = {NULL, &g_app.core.fx.delay.enabled, &g_app.fx_delay_enabled},
+    [PARAM_FX_DELAY_TIME] = {&g_app.core.fx.delay.time_ms, NULL, NULL},
+    [PARAM_FX_DELAY_FEEDBACK] = {&g_app.core.fx.delay.feedback, NULL, NULL},
+    [PARAM_FX_DELAY_MIX] = {&g_app.core.fx.delay.mix, NULL, NULL},
+    [PARAM_FX_REVERB_ENABLED] = {NULL, &g_app.core.fx.reverb.enabled, &g_app.fx_reverb_enabled},
+    [PARAM_FX_REVERB_SIZE] = {&g_app.core.fx.reverb.size, NULL, NULL},
+    [PARAM_FX_REVERB_DAMPING] = {&g_app.core.fx.reverb.damping, NULL, NULL},
+    [PARAM_FX_REVERB_MIX] = {&g_app.core.fx.reverb.mix, NULL, NULL},
+};
+
+// Host-scope settings the engine doesn't keep: tempo for the arp and
+// sequencer, and the arpeggiator. Written on the audio thread only.
+static void core_param_apply_rt(ParamId id, float value) {
+    value = synth_param_clamp(id, value);
+    switch (id) {
+        case PARAM_TEMPO:
+            g_app.core.tempo = value;
+            break;
+        case PARAM_ARP_MODE:
+            g_app.core.arp.mode = (ArpMode)(int)value;
+            break;
+        case PARAM_ARP_RATE:
+            g_app.core.arp.rate = value;
+            break;
+        case PARAM_ARP_GATE:
+            g_app.core.arp.gate = value;
+            break;
+        case PARAM_ARP_ENABLED:
+            arp_set_enabled(&g_app.core.arp, value != 0.0f);
+            break;
         default:
-            synth_engine_apply_param(&g_app.synth, change);
             break;
     }
 }
 
-static void dispatch_note_on(uint8_t note, float velocity) {
-    if (g_app.arp_enabled) {
-        arp_note_on(&g_app.arp, note);
+static void apply_param_change(const ParamMsg* change, void* userdata) {
+    (void)userdata;
+    if (!change || change->id >= PARAM_PARAM_COUNT) {
+        return;
+    }
+    ParamId id = (ParamId)change->id;
+    const FxParamTarget* fx = &g_fx_param_targets[id];
+    if (fx->value) {
+        *fx->value = synth_param_clamp(id, param_msg_get_float(change));
+    } else if (fx->enabled) {
+        *fx->enabled = param_msg_get_bool(change);
+        *fx->ui_enabled = *fx->enabled;
     } else {
-        synth_note_on(&g_app.synth, note, velocity > 0.0f ? velocity : 1.0f);
+        if (id == PARAM_PANIC) {
+            g_app.core.arp.num_held = 0;  // Or the arp keeps playing what was held
+        }
+        synth_engine_apply_param(&g_app.core.synth, change);
+        core_param_apply_rt(id, param_msg_get_float(change));
     }
 }
 
-static void dispatch_note_off(uint8_t note) {
-    if (g_app.arp_enabled) {
-        arp_note_off(&g_app.arp, note);
-    } else {
-        synth_note_off(&g_app.synth, note);
+// What a patch sets in the core; presets don't store the arp gate
+static const ParamId g_patch_core_params[] = {PARAM_TEMPO, PARAM_ARP_MODE, PARAM_ARP_RATE, PARAM_ARP_ENABLED};
+
+// Audio thread: switch to a whole patch at once. FX settings land in the
+// rack, tempo and arp in the core, and the engine takes the rest in one
+// call; sounding voices keep the old patch or crossfade, as the patch asks.
+static void patch_apply_rt(SynthPatch* patch) {
+    if (!patch) {
+        return;
+    }
+    synth_load_patch(&g_app.core.synth, patch);
+    for (size_t i = 0; i < sizeof(g_patch_core_params) / sizeof(g_patch_core_params[0]); ++i) {
+        core_param_apply_rt(g_patch_core_params[i], patch->params[g_patch_core_params[i]]);
+    }
+    for (int i = 0; i < PARAM_PARAM_COUNT; ++i) {
+        const FxParamTarget* fx = &g_fx_param_targets[i];
+        if (fx->value) {
+            *fx->value = synth_param_clamp((ParamId)i, patch->params[i]);
+        } else if (fx->enabled) {
+            *fx->enabled = patch->params[i] != 0.0f;
+            *fx->ui_enabled = *fx->enabled;
+        }
     }
+    audio_retire_patch(patch);
 }
 
 static void handle_midi_event(const MidiEvent* event, void* userdata) {
@@ -1561,112 +1897,155 @@ static void handle_midi_event(const MidiEvent* event, void* userdata) {
         return;
     }
 
+    // Channels stay apart so MPE notes keep their own bend and pressure;
+    // controllers are single stores the voices read at the next block
+    SynthEngine* synth = &g_app.core.synth;
+    const int channel = event->channel & 0x0F;
     switch (event->type) {
         case MIDI_EVENT_NOTE_ON: {
             float velocity = (float)event->data2 / 127.0f;
             if (velocity <= 0.0f) {
-                dispatch_note_off(event->data1);
+                synth_core_channel_note_off(&g_app.core, channel, event->data1);
             } else {
-                dispatch_note_on(event->data1, velocity);
+                synth_core_channel_note_on(&g_app.core, channel, event->data1, velocity);
             }
             break;
         }
         case MIDI_EVENT_NOTE_OFF:
-            dispatch_note_off(event->data1);
+            synth_core_channel_note_off(&g_app.core, channel, event->data1);
             break;
         case MIDI_EVENT_PITCH_BEND: {
             uint16_t value = ((uint16_t)event->data2 << 7) | event->data1;
             float amount = ((float)value - 8192.0f) / 8192.0f;
-            synth_pitch_bend(&g_app.synth, amount);
+            synth_channel_pitch_bend(synth, channel, amount);
             break;
         }
         case MIDI_EVENT_CONTROL_CHANGE:
+            synth_control_change(synth, channel, event->data1, event->data2);
+            break;
         case MIDI_EVENT_AFTERTOUCH:
+            synth_channel_pressure(synth, channel, (float)event->data2 / 127.0f);
+            break;
+        case MIDI_EVENT_POLY_AFTERTOUCH:
+            synth_poly_pressure(synth, channel, event->data1, (float)event->data2 / 127.0f);
+            break;
         case MIDI_EVENT_PROGRAM_CHANGE:
         default:
             break;
     }
 }
 
-void audio_callback(ma_device* device, void* output, const void* input, ma_uint32 frameCount) {
-    float* out = (float*)output;
-    const float* in = (const float*)input;
-    
-    double sample_duration = 1.0 / g_app.synth.sample_rate;
-
-    param_queue_drain(apply_param_change, NULL);
-    midi_queue_drain(handle_midi_event, NULL);
-
-    audio_state_lock();
+// Core hook: apply queued param/MIDI events due by `now`; frames until the
+// next one is due, capped at limit
+static uint32_t core_apply_queued_events(SynthCore* core, uint64_t now, uint32_t limit, void* userdata) {
+    (void)core;
+    (void)userdata;
+    param_queue_drain_until(apply_param_change, NULL, now + 1);
+    midi_queue_drain_until(handle_midi_event, NULL, now + 1);
 
-    const int capture_channels = device->capture.channels > 0 ? device->capture.channels : g_app.capture_channels;
+    uint32_t frames = limit;
+    ParamMsg change;
+    if (param_queue_peek(&change) && change.sample_frame > now &&
+        change.sample_frame - now < frames) {
+        frames = (uint32_t)(change.sample_frame - now);
+    }
+    uint64_t midi_due;
+    if (midi_queue_peek_due_frame(&midi_due) && midi_due > now && midi_due - now < frames) {
+        frames = (uint32_t)(midi_due - now);
+    }
+    return frames;
+}
 
-    for (ma_uint32 i = 0; i < frameCount; i++) {
+// Core hook: voice layers (with the capture input) and snippets after the FX
+static void core_mix_recorders(SynthCore* core, const float* in, float* out, uint32_t frames, void* userdata) {
+    (void)userdata;
+    const int capture_channels = core->input_channels;
+    uint64_t t_tracks = rt_stats_now_ns();
+    // Idle layers and snippets add nothing; skip their per-frame loops
+    uint32_t track_frames = voice_tracks_busy_rt() ? frames : 0;
+    for (uint32_t f = 0; f < track_frames; f++) {
         float mic_l = 0.0f;
         float mic_r = 0.0f;
         if (in && capture_channels > 0) {
-            mic_l = in[i * capture_channels];
-            mic_r = (capture_channels > 1) ? in[i * capture_channels + 1] : mic_l;
+            mic_l = in[f * capture_channels];
+            mic_r = (capture_channels > 1) ? in[f * capture_channels + 1] : mic_l;
         }
-
-        arp_process(&g_app.arp, &g_app.synth, g_app.current_time, g_app.tempo);
-        
-        float left = 0.0f, right = 0.0f;
-        float temp_buffer[2];
-        synth_process(&g_app.synth, temp_buffer, 1);
-        left = temp_buffer[0];
-        right = temp_buffer[1];
-        
-        fx_distortion_process(&g_app.fx.distortion, &left, &right);
-        fx_delay_process(&g_app.fx.delay, &left, &right, g_app.synth.sample_rate);
-        fx_reverb_process(&g_app.fx.reverb, &left, &right);
-
         float voice_mix_l = 0.0f;
         float voice_mix_r = 0.0f;
+        voice_track_process_frame_rt(mic_l, mic_r, &voice_mix_l, &voice_mix_r);
+        out[f * 2 + 0] += voice_mix_l;
+        out[f * 2 + 1] += voice_mix_r;
+    }
+    uint64_t t_snippets = rt_stats_now_ns();
+    const PresetSnippetLibrary* snippets = &g_app.preset_snippets;
+    uint32_t snippet_frames = snippets->active_recording || snippets->active_playback ? frames : 0;
+    for (uint32_t f = 0; f < snippet_frames; f++) {
+        preset_snippet_process_frame(&out[f * 2 + 0], &out[f * 2 + 1]);
+    }
+    uint64_t t_done = rt_stats_now_ns();
+    rt_stats_add_stage(&g_app.rt_stats, RT_STAGE_TRACKS, t_snippets - t_tracks);
+    rt_stats_add_stage(&g_app.rt_stats, RT_STAGE_SNIPPETS, t_done - t_snippets);
+}
 
-        for (int t = 0; t < MAX_VOICE_TRACKS; ++t) {
-            VoiceTrack* track = &g_app.voice_layers.tracks[t];
-
-            if (track->recording && track->buffer.data && track->recorded_frames < track->record_capacity_frames) {
-                size_t idx = (size_t)track->recorded_frames * track->buffer.channels;
-                track->buffer.data[idx] = mic_l;
-                if (track->buffer.channels > 1) {
-                    track->buffer.data[idx + 1] = mic_r;
-                }
-                track->recorded_frames++;
-                if (track->recorded_frames >= track->record_capacity_frames) {
-                    track->recording = 0;
-                    track->buffer.frame_count = track->recorded_frames;
-                }
-            }
-
-            if (track->playing && track->buffer.data && track->buffer.frame_count > 0) {
-                if (track->playback_pos >= track->buffer.frame_count) {
-                    track->playback_pos = 0;
-                }
-                size_t idx = (size_t)track->playback_pos * track->buffer.channels;
-                float src_l = track->buffer.data[idx];
-                float src_r = (track->buffer.channels > 1) ? track->buffer.data[idx + 1] : src_l;
-                voice_mix_l += src_l * track->volume;
-                voice_mix_r += src_r * track->volume;
-                track->playback_pos++;
-                if (track->playback_pos >= track->buffer.frame_count) {
-                    track->playback_pos = 0;
-                }
-            }
+// Voice state the UI displays, copied out while this thread owns the engine
+static void meter_capture_voices_rt(void) {
+    const SynthEngine* synth = &g_app.core.synth;
+    MeterVoices voices;
+    memset(&voices, 0, sizeof(voices));
+    voices.active_voices = synth->num_active_voices;
+    for (int i = 0; i < synth->num_active_voices; i++) {
+        const Voice* voice = &synth->voices[synth->active_voices[i]];
+        if (voice->state != VOICE_OFF && voice->state != VOICE_RELEASE &&
+            voice->midi_note >= 0 && voice->midi_note < 128) {
+            voices.notes[voice->midi_note >> 6] |= 1ull << (voice->midi_note & 63);
         }
-
-        float output_l = left + voice_mix_l;
-        float output_r = right + voice_mix_r;
-        preset_snippet_process_frame(&output_l, &output_r);
-
-        out[i * 2 + 0] = output_l;
-        out[i * 2 + 1] = output_r;
-
-        g_app.current_time += sample_duration;
     }
+    const int first_shown = synth->num_active_voices > METER_FEED_VOICE_ROWS
+                                ? synth->num_active_voices - METER_FEED_VOICE_ROWS : 0;
+    for (int i = first_shown; i < synth->num_active_voices; i++) {
+        const Voice* voice = &synth->voices[synth->active_voices[i]];
+        if (voice->state == VOICE_OFF) {
+            continue;
+        }
+        MeterVoiceRow* row = &voices.rows[voices.row_count++];
+        row->note = voice->midi_note;
+        row->level = voice->env_amp.current_level;
+        row->releasing = voice->state == VOICE_RELEASE;
+    }
+    meter_feed_set_voices(&g_app.meter_feed, &voices);
+}
+
+void audio_callback(ma_device* device, void* output, const void* input, ma_uint32 frameCount) {
+    float* out = (float*)output;
+    const float* in = (const float*)input;
 
-    audio_state_unlock();
+    rt_stats_begin(&g_app.rt_stats, frameCount);
+    // Hardware MIDI stamped during the last period plays at the same offset
+    // into this one
+    midi_queue_begin_period(g_app.rt_stats.callback_start_ns, g_app.core.synth.sample_counter, frameCount,
+                            g_app.core.synth.sample_rate);
+
+    // Never blocks: UI state arrives as commands, never through a lock
+    audio_commands_apply_rt();
+    // Latest value of each knob moved since the last period, once each
+    param_queue_apply_latest(apply_param_change, NULL);
+
+    g_app.core.input_channels = device->type != ma_device_type_duplex ? 0
+                                : device->capture.channels > 0 ? (int)device->capture.channels
+                                                               : g_app.capture_channels;
+    // Renders with flush-to-zero set, on ARM too (miniaudio only sets it on x86)
+    synth_core_process(&g_app.core, g_app.core.input_channels > 0 ? in : NULL, out, frameCount);
+
+    meter_capture_voices_rt();
+    meter_feed_push(&g_app.meter_feed, out, frameCount);
+
+    uint32_t param_drops = 0;
+    uint32_t midi_drops = 0;
+    uint32_t seq_drops = 0;
+    param_queue_drop_counts(&param_drops, &midi_drops, &seq_drops);
+    rt_stats_set_queue_drops(&g_app.rt_stats, param_drops, midi_drops, seq_drops);
+    rt_stats_set_log_drops(&g_app.rt_stats, rt_log_dropped());
+    rt_stats_end(&g_app.rt_stats, g_app.core.synth.num_active_voices);
 }
 
 // ============================================================================
@@ -1679,8 +2058,7 @@ void play_note(int midi_note, const char* label) {
         return;
     }
     midi_queue_send_note_on((uint8_t)midi_note, 110);
-    printf("ðŸŽµ QUEUE NOTE ON: %s (MIDI %d)\n", label, midi_note);
-    fflush(stdout);
+    rt_log(RT_LOG_INFO, "QUEUE NOTE ON: %s (MIDI %d)", label, midi_note);
 }
 
 void stop_note(int midi_note, const char* label) {
@@ -1688,8 +2066,15 @@ void stop_note(int midi_note, const char* label) {
         return;
     }
     midi_queue_send_note_off((uint8_t)midi_note);
-    printf("ðŸ”‡ QUEUE NOTE OFF: %s (MIDI %d)\n", label, midi_note);
-    fflush(stdout);
+    rt_log(RT_LOG_INFO, "QUEUE NOTE OFF: %s (MIDI %d)", label, midi_note);
+}
+
+// UI thread: forget held keys and let the audio thread silence the voices
+// and the arp at its next block
+static void app_panic(void) {
+    memset(g_app.keys_pressed, 0, sizeof(g_app.keys_pressed));
+    g_app.mouse_note_playing = -1;
+    enqueue_param_int_msg(PARAM_PANIC, 1);
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -1713,19 +2098,21 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     // Global shortcuts
     if (action == GLFW_PRESS) {
         if (key == GLFW_KEY_ESCAPE) {
-            synth_all_notes_off(&g_app.synth);
-            for (size_t i = 0; i < KEYMAP_SIZE; i++) {
-                g_app.keys_pressed[i] = 0;
-            }
-            g_app.arp.num_held = 0;
+            app_panic();
             printf("ðŸš¨ PANIC - All notes off\n");
         } else if (key == GLFW_KEY_SPACE) {
-            g_app.playing = !g_app.playing;
+            transport_set_playing(!g_app.playing);
             printf("%s %s\n", g_app.playing ? "â–¶" : "â¸", g_app.playing ? "Playing" : "Stopped");
         }
     }
 }
 
+// The compositor dropped the window contents; the next frame must render
+void window_refresh_callback(GLFWwindow* window) {
+    (void)window;
+    ui_frame_pacer_invalidate(&g_app.ui_pacer);
+}
+
 void error_callback(int error, const char* description) {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
@@ -1734,6 +2121,32 @@ void error_callback(int error, const char* description) {
 // GUI
 // ============================================================================
 
+// Anything on screen that moves without input: meters, transport, takes
+static bool ui_is_animating(void) {
+    // Output above -80 dB keeps the meters live through FX tails
+    const MeterFrame* meter = &g_app.meter;
+    if (meter->voices.active_voices > 0 || fmaxf(meter->peak[0], meter->peak[1]) > 1e-4f || g_app.playing ||
+        preset_library_is_scanning(&g_app.preset_library) ||
+        atomic_load(&g_app.preset_snippets.play_all_active)) {
+        return true;
+    }
+    for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
+        VoiceTrack* track = &g_app.voice_layers.tracks[i];
+        if (voice_track_is_recording(track) || voice_track_is_playing(track)) {
+            return true;
+        }
+    }
+    for (int e = 0; e < MAX_PRESET_SNIPPET_PRESETS; ++e) {
+        for (int s = 0; s < MAX_SNIPPETS_PER_PRESET; ++s) {
+            PresetSnippet* snippet = &g_app.preset_snippets.entries[e].snippets[s];
+            if (atomic_load(&snippet->recording) || atomic_load(&snippet->playing)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void draw_gui(struct nk_context *ctx, float width, float height) {
     preset_snippet_tick();
     const UiMetrics* metrics = ui_style_metrics();
@@ -1813,34 +2226,32 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
         nk_layout_row_begin(ctx, NK_STATIC, 42, 3);
         nk_layout_row_push(ctx, region.w * 0.30f);
         if (nk_button_label(ctx, g_app.playing ? "â¹ Stop Transport" : "â–¶ Start Transport")) {
-            g_app.playing = !g_app.playing;
+            transport_set_playing(!g_app.playing);
         }
         nk_layout_row_push(ctx, region.w * 0.38f);
-        nk_size voice_meter = (nk_size)g_app.synth.num_active_voices;
-        nk_progress(ctx, &voice_meter, MAX_VOICES, nk_false);
+        nk_size voice_meter = (nk_size)g_app.meter.voices.active_voices;
+        nk_progress(ctx, &voice_meter, (nk_size)g_app.core.synth.polyphony, nk_false);
         nk_layout_row_push(ctx, region.w * 0.24f);
         int previous_arp_enabled = g_app.arp_enabled;
         nk_checkbox_label(ctx, "Arp Enabled", &g_app.arp_enabled);
         if (previous_arp_enabled != g_app.arp_enabled) {
-            g_app.arp.enabled = g_app.arp_enabled;
             enqueue_param_int_msg(PARAM_ARP_ENABLED, g_app.arp_enabled);
-        } else {
-            g_app.arp.enabled = g_app.arp_enabled != 0;
         }
         nk_layout_row_end(ctx);
 
         nk_layout_row_begin(ctx, NK_STATIC, 24, 3);
         nk_layout_row_push(ctx, region.w * 0.30f);
         char voice_info[64];
-        snprintf(voice_info, sizeof(voice_info), "%d / %d voices", g_app.synth.num_active_voices, MAX_VOICES);
+        snprintf(voice_info, sizeof(voice_info), "%d / %d voices", g_app.meter.voices.active_voices, g_app.core.synth.polyphony);
         nk_label(ctx, voice_info, NK_TEXT_LEFT);
         nk_layout_row_push(ctx, region.w * 0.32f);
         char tempo_info[64];
-        snprintf(tempo_info, sizeof(tempo_info), "Tempo %.1f BPM", g_app.tempo);
+        snprintf(tempo_info, sizeof(tempo_info), "Tempo %.1f BPM", g_app.knob_tempo.value);
         nk_label(ctx, tempo_info, NK_TEXT_CENTERED);
         nk_layout_row_push(ctx, region.w * 0.24f);
-        int minutes = (int)(g_app.current_time / 60.0);
-        int seconds = (int)fmod(g_app.current_time, 60.0);
+        double current_time = synth_core_time(&g_app.core);
+        int minutes = (int)(current_time / 60.0);
+        int seconds = (int)fmod(current_time, 60.0);
         char time_info[32];
         snprintf(time_info, sizeof(time_info), "%s %02d:%02d", g_app.playing ? "â–¶" : "â¸", minutes, seconds);
         nk_label(ctx, time_info, NK_TEXT_RIGHT);
@@ -1895,11 +2306,24 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                                            sizeof(g_app.browser_search),
                                            nk_filter_ascii);
 
+            // Scanned presets when there are any, the curated list otherwise
+            const size_t library_count = preset_library_count(&g_app.preset_library);
+            const uint32_t* library_results = NULL;
+            const size_t library_matches = preset_library_search(&g_app.preset_library,
+                                                                 g_app.browser_search,
+                                                                 NULL,
+                                                                 &library_results);
+
             nk_layout_row_dynamic(ctx, 20, 1);
-            nk_label(ctx,
-                     g_app.browser_search[0] ? "Filtering results below (prototype)"
-                                             : "Type to quickly jump between curated presets.",
-                     NK_TEXT_LEFT);
+            if (library_count > 0) {
+                nk_labelf(ctx, NK_TEXT_LEFT, "%zu of %zu presets%s", library_matches, library_count,
+                          preset_library_is_scanning(&g_app.preset_library) ? " (scanning...)" : "");
+            } else {
+                nk_label(ctx,
+                         g_app.browser_search[0] ? "Filtering results below (prototype)"
+                                                 : "Type to quickly jump between curated presets.",
+                         NK_TEXT_LEFT);
+            }
 
             const int chips_per_row = 3;
             for (int start = 0; start < patch_category_count; start += chips_per_row) {
@@ -1916,7 +2340,18 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
             nk_layout_row_dynamic(ctx, 110, 1);
             if (nk_group_begin(ctx, "NAV_BROWSER_LIST", NK_WINDOW_BORDER | NK_WINDOW_NO_SCROLLBAR)) {
                 int visible = 0;
-                for (int i = 0; i < browser_patch_count; ++i) {
+                for (size_t r = 0; r < library_matches && r < PRESET_BROWSER_MAX_ROWS; ++r) {
+                    const int index = (int)library_results[r];
+                    const PresetLibraryEntry* entry = preset_library_entry(&g_app.preset_library, (size_t)index);
+                    ++visible;
+                    nk_bool selected = (nk_bool)(g_app.browser_selection == index);
+                    if (nk_selectable_label(ctx, entry->name, NK_TEXT_LEFT, &selected) &&
+                        g_app.browser_selection != index) {
+                        g_app.browser_selection = index;
+                        app_load_preset(entry->path, SYNTH_PATCH_HOLD, 0.0f);
+                    }
+                }
+                for (int i = 0; library_count == 0 && i < browser_patch_count; ++i) {
                     if (!ui_str_icontains(kBrowserPatches[i], g_app.browser_search)) {
                         continue;
                     }
@@ -1990,14 +2425,13 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 for (int slot = 0; slot < MAX_SNIPPETS_PER_PRESET && entry; ++slot) {
                     PresetSnippet* snippet = entry ? &entry->snippets[slot] : NULL;
                     char status[128];
-                    if (snippet && snippet->recording) {
-                        float seconds = snippet->recorded_frames > 0 && snippet->buffer.sample_rate > 0
-                                            ? (float)snippet->recorded_frames / (float)snippet->buffer.sample_rate
-                                            : 0.0f;
+                    if (preset_snippet_is_recording(snippet)) {
+                        uint32_t recorded = atomic_load_explicit(&snippet->recorded_frames, memory_order_relaxed);
+                        float seconds = (float)recorded / (float)record_sample_rate();
                         snprintf(status, sizeof(status), "Recordingâ€¦ (%.1fs)", seconds);
                     } else if (snippet && preset_snippet_has_audio(snippet)) {
-                        float seconds = (snippet->buffer.sample_rate > 0)
-                                            ? (float)snippet->buffer.frame_count / (float)snippet->buffer.sample_rate
+                        float seconds = (snippet->source->sample_rate > 0)
+                                            ? (float)snippet->source->frame_count / (float)snippet->source->sample_rate
                                             : 0.0f;
                         snprintf(status,
                                  sizeof(status),
@@ -2016,7 +2450,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
 
                     nk_layout_row_begin(ctx, NK_STATIC, 26, 3);
                     nk_layout_row_push(ctx, 70);
-                    if (snippet && snippet->recording) {
+                    if (preset_snippet_is_recording(snippet)) {
                         if (nk_button_label(ctx, "Stop")) {
                             preset_snippet_stop_recording_slot(preset_name, slot);
                         }
@@ -2064,7 +2498,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 }
 
                 nk_layout_row_dynamic(ctx, 18, 1);
-                if (lib->play_all_active) {
+                if (atomic_load_explicit(&lib->play_all_active, memory_order_relaxed)) {
                     nk_label(ctx, "Playing recorded preset showcaseâ€¦", NK_TEXT_LEFT);
                 } else {
                     nk_label(ctx, "Play a snippet to audition captured presets.", NK_TEXT_LEFT);
@@ -2096,20 +2530,16 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 int selected_wave = nk_combo(ctx, waves, 5, wave_idx, 28, nk_vec2(160, 200));
                 if (selected_wave != wave_idx) {
                     g_app.osc1_wave = (WaveformType)selected_wave;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].osc1.waveform = g_app.osc1_wave;
-                    }
                     enqueue_param_int_msg(PARAM_OSC1_WAVE, selected_wave);
                 }
 
                 nk_layout_row_dynamic(ctx, 28, 2);
                 nk_label(ctx, "Unison Voices", NK_TEXT_LEFT);
-                int prev_unison = g_app.osc1_unison;
-                nk_slider_int(ctx, 1, &g_app.osc1_unison, 5, 1);
-                if (prev_unison != g_app.osc1_unison) {
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].osc1.unison_voices = g_app.osc1_unison;
-                    }
+                int unison = g_app.osc1_unison;
+                nk_slider_int(ctx, 1, &unison, MAX_UNISON, 1);
+                if (unison != g_app.osc1_unison) {
+                    g_app.osc1_unison = unison;
+                    enqueue_param_int_msg(PARAM_OSC1_UNISON, unison);
                 }
 
                 const float knob_width = fminf(column_width * 0.45f, 140.0f);
@@ -2118,9 +2548,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig detune_cfg = {.label = "DETUNE", .unit = "Â¢", .snap_increment = 1.0f};
                 if (ui_knob_render(ctx, &g_app.knob_osc1_detune, &detune_cfg)) {
                     g_app.osc1_detune = g_app.knob_osc1_detune.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].osc1.detune_cents = g_app.osc1_detune;
-                    }
                     enqueue_param_float_msg(PARAM_OSC1_FINE, g_app.osc1_detune);
                 }
 
@@ -2128,9 +2555,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig pwm_cfg = {.label = "PULSE", .unit = ""};
                 if (ui_knob_render(ctx, &g_app.knob_osc1_pwm, &pwm_cfg)) {
                     g_app.osc1_pwm = g_app.knob_osc1_pwm.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].osc1.pulse_width = g_app.osc1_pwm;
-                    }
                     enqueue_param_float_msg(PARAM_OSC1_PWM, g_app.osc1_pwm);
                 }
                 nk_layout_row_end(ctx);
@@ -2147,9 +2571,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 int new_mode = nk_combo(ctx, filter_modes, 5, mode_idx, 28, nk_vec2(120, 200));
                 if (new_mode != mode_idx) {
                     g_app.filter_mode = (FilterMode)new_mode;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].filter.mode = g_app.filter_mode;
-                    }
                     enqueue_param_int_msg(PARAM_FILTER_MODE, new_mode);
                 }
 
@@ -2160,9 +2581,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig cutoff_cfg = {.label = "CUTOFF", .unit = "Hz"};
                 if (ui_knob_render(ctx, &g_app.knob_filter_cutoff, &cutoff_cfg)) {
                     g_app.filter_cutoff = g_app.knob_filter_cutoff.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].filter.cutoff = g_app.filter_cutoff;
-                    }
                     enqueue_param_float_msg(PARAM_FILTER_CUTOFF, g_app.filter_cutoff);
                 }
 
@@ -2170,9 +2588,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig resonance_cfg = {.label = "RESONANCE", .unit = ""};
                 if (ui_knob_render(ctx, &g_app.knob_filter_resonance, &resonance_cfg)) {
                     g_app.filter_resonance = g_app.knob_filter_resonance.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].filter.resonance = g_app.filter_resonance;
-                    }
                     enqueue_param_float_msg(PARAM_FILTER_RESONANCE, g_app.filter_resonance);
                 }
 
@@ -2180,9 +2595,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig env_cfg = {.label = "ENV AMT", .unit = ""};
                 if (ui_knob_render(ctx, &g_app.knob_filter_env, &env_cfg)) {
                     g_app.filter_env = g_app.knob_filter_env.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].filter.env_amount = g_app.filter_env;
-                    }
                     enqueue_param_float_msg(PARAM_FILTER_ENV_AMOUNT, g_app.filter_env);
                 }
                 nk_layout_row_end(ctx);
@@ -2197,9 +2609,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig attack_cfg = {.label = "ATTACK", .unit = "s"};
                 if (ui_knob_render(ctx, &g_app.knob_env_attack, &attack_cfg)) {
                     g_app.env_attack = g_app.knob_env_attack.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].env_amp.attack = g_app.env_attack;
-                    }
                     enqueue_param_float_msg(PARAM_ENV_ATTACK, g_app.env_attack);
                 }
 
@@ -2207,9 +2616,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig decay_cfg = {.label = "DECAY", .unit = "s"};
                 if (ui_knob_render(ctx, &g_app.knob_env_decay, &decay_cfg)) {
                     g_app.env_decay = g_app.knob_env_decay.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].env_amp.decay = g_app.env_decay;
-                    }
                     enqueue_param_float_msg(PARAM_ENV_DECAY, g_app.env_decay);
                 }
 
@@ -2217,9 +2623,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig sustain_cfg = {.label = "SUSTAIN", .unit = ""};
                 if (ui_knob_render(ctx, &g_app.knob_env_sustain, &sustain_cfg)) {
                     g_app.env_sustain = g_app.knob_env_sustain.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].env_amp.sustain = g_app.env_sustain;
-                    }
                     enqueue_param_float_msg(PARAM_ENV_SUSTAIN, g_app.env_sustain);
                 }
 
@@ -2227,9 +2630,6 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig release_cfg = {.label = "RELEASE", .unit = "s"};
                 if (ui_knob_render(ctx, &g_app.knob_env_release, &release_cfg)) {
                     g_app.env_release = g_app.knob_env_release.value;
-                    for (int i = 0; i < MAX_VOICES; ++i) {
-                        g_app.synth.voices[i].env_amp.release = g_app.env_release;
-                    }
                     enqueue_param_float_msg(PARAM_ENV_RELEASE, g_app.env_release);
                 }
                 nk_layout_row_end(ctx);
@@ -2245,16 +2645,14 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 UiKnobConfig master_cfg = {.label = "MASTER", .unit = ""};
                 if (ui_knob_render(ctx, &g_app.knob_master_volume, &master_cfg)) {
                     g_app.master_volume = g_app.knob_master_volume.value;
-                    g_app.synth.master_volume = g_app.master_volume;
+                    g_app.core.synth.master_volume = g_app.master_volume;
                     enqueue_param_float_msg(PARAM_MASTER_VOLUME, g_app.master_volume);
                 }
 
                 nk_layout_row_push(ctx, master_knob_width);
                 UiKnobConfig tempo_cfg = {.label = "TEMPO", .unit = "BPM"};
                 if (ui_knob_render(ctx, &g_app.knob_tempo, &tempo_cfg)) {
-                    g_app.tempo = g_app.knob_tempo.value;
-                    synth_set_tempo(&g_app.synth, g_app.tempo);
-                    enqueue_param_float_msg(PARAM_TEMPO, g_app.tempo);
+                    enqueue_param_float_msg(PARAM_TEMPO, g_app.knob_tempo.value);
                 }
                 nk_layout_row_end(ctx);
 
@@ -2262,17 +2660,28 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 nk_label(ctx, "Effects", NK_TEXT_LEFT);
 
                 int prev_dist_enabled = g_app.fx_dist_enabled;
+                int prev_chorus_enabled = g_app.fx_chorus_enabled;
+                int prev_comp_enabled = g_app.fx_comp_enabled;
                 int prev_delay_enabled = g_app.fx_delay_enabled;
                 int prev_reverb_enabled = g_app.fx_reverb_enabled;
 
                 nk_layout_row_dynamic(ctx, 32, 3);
                 nk_checkbox_label(ctx, "Dist", &g_app.fx_dist_enabled);
+                nk_checkbox_label(ctx, "Chorus", &g_app.fx_chorus_enabled);
+                nk_checkbox_label(ctx, "Comp", &g_app.fx_comp_enabled);
+                nk_layout_row_dynamic(ctx, 32, 3);
                 nk_checkbox_label(ctx, "Delay", &g_app.fx_delay_enabled);
                 nk_checkbox_label(ctx, "Reverb", &g_app.fx_reverb_enabled);
 
                 if (prev_dist_enabled != g_app.fx_dist_enabled) {
                     enqueue_param_int_msg(PARAM_FX_DISTORTION_ENABLED, g_app.fx_dist_enabled);
                 }
+                if (prev_chorus_enabled != g_app.fx_chorus_enabled) {
+                    enqueue_param_int_msg(PARAM_FX_CHORUS_ENABLED, g_app.fx_chorus_enabled);
+                }
+                if (prev_comp_enabled != g_app.fx_comp_enabled) {
+                    enqueue_param_int_msg(PARAM_FX_COMP_ENABLED, g_app.fx_comp_enabled);
+                }
                 if (prev_delay_enabled != g_app.fx_delay_enabled) {
                     enqueue_param_int_msg(PARAM_FX_DELAY_ENABLED, g_app.fx_delay_enabled);
                 }
@@ -2280,76 +2689,113 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                     enqueue_param_int_msg(PARAM_FX_REVERB_ENABLED, g_app.fx_reverb_enabled);
                 }
 
-                g_app.fx.distortion.enabled = g_app.fx_dist_enabled;
-                g_app.fx.delay.enabled = g_app.fx_delay_enabled;
-                g_app.fx.reverb.enabled = g_app.fx_reverb_enabled;
+                g_app.core.fx.distortion.enabled = g_app.fx_dist_enabled;
+                g_app.core.fx.chorus.enabled = g_app.fx_chorus_enabled;
+                g_app.core.fx.compressor.enabled = g_app.fx_comp_enabled;
+                g_app.core.fx.delay.enabled = g_app.fx_delay_enabled;
+                g_app.core.fx.reverb.enabled = g_app.fx_reverb_enabled;
 
                 nk_layout_row_dynamic(ctx, 28, 1);
                 nk_label(ctx, "Distortion", NK_TEXT_LEFT);
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.distortion.drive, 10.0f, 0.1f)) {
-                    enqueue_param_float_msg(PARAM_FX_DISTORTION_DRIVE, g_app.fx.distortion.drive);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.distortion.drive, 10.0f, 0.1f)) {
+                    enqueue_param_float_msg(PARAM_FX_DISTORTION_DRIVE, g_app.core.fx.distortion.drive);
+                }
+                nk_layout_row_dynamic(ctx, 34, 1);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.distortion.mix, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_DISTORTION_MIX, g_app.core.fx.distortion.mix);
+                }
+                ui_oversample_combo(ctx, "Oversampling", SYNTH_OVERSAMPLE_DISTORTION);
+
+                nk_layout_row_dynamic(ctx, 28, 1);
+                nk_label(ctx, "Chorus", NK_TEXT_LEFT);
+                nk_layout_row_dynamic(ctx, 34, 1);
+                if (nk_slider_float(ctx, 0.05f, &g_app.core.fx.chorus.rate, 5.0f, 0.05f)) {
+                    enqueue_param_float_msg(PARAM_FX_CHORUS_RATE, g_app.core.fx.chorus.rate);
+                }
+                nk_layout_row_dynamic(ctx, 34, 1);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.chorus.depth, FX_CHORUS_MAX_DEPTH_MS, 0.1f)) {
+                    enqueue_param_float_msg(PARAM_FX_CHORUS_DEPTH, g_app.core.fx.chorus.depth);
+                }
+                nk_layout_row_dynamic(ctx, 34, 1);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.chorus.mix, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_CHORUS_MIX, g_app.core.fx.chorus.mix);
+                }
+
+                nk_layout_row_dynamic(ctx, 28, 1);
+                nk_label(ctx, "Compressor", NK_TEXT_LEFT);
+                nk_layout_row_dynamic(ctx, 34, 1);
+                if (nk_slider_float(ctx, 0.05f, &g_app.core.fx.compressor.threshold, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_COMP_THRESHOLD, g_app.core.fx.compressor.threshold);
                 }
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.distortion.mix, 1.0f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_DISTORTION_MIX, g_app.fx.distortion.mix);
+                if (nk_slider_float(ctx, 1.0f, &g_app.core.fx.compressor.ratio, 20.0f, 0.1f)) {
+                    enqueue_param_float_msg(PARAM_FX_COMP_RATIO, g_app.core.fx.compressor.ratio);
                 }
 
                 nk_layout_row_dynamic(ctx, 28, 1);
                 nk_label(ctx, "Delay", NK_TEXT_LEFT);
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 100.0f, &g_app.fx.delay.time_ms, 2000.0f, 10.0f)) {
-                    enqueue_param_float_msg(PARAM_FX_DELAY_TIME, g_app.fx.delay.time_ms);
+                if (nk_slider_float(ctx, 100.0f, &g_app.core.fx.delay.time_ms, 2000.0f, 10.0f)) {
+                    enqueue_param_float_msg(PARAM_FX_DELAY_TIME, g_app.core.fx.delay.time_ms);
                 }
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.delay.feedback, 0.95f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_DELAY_FEEDBACK, g_app.fx.delay.feedback);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.delay.feedback, 0.95f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_DELAY_FEEDBACK, g_app.core.fx.delay.feedback);
                 }
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.delay.mix, 1.0f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_DELAY_MIX, g_app.fx.delay.mix);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.delay.mix, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_DELAY_MIX, g_app.core.fx.delay.mix);
                 }
 
                 nk_layout_row_dynamic(ctx, 28, 1);
                 nk_label(ctx, "Reverb", NK_TEXT_LEFT);
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.reverb.size, 1.0f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_REVERB_SIZE, g_app.fx.reverb.size);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.reverb.size, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_REVERB_SIZE, g_app.core.fx.reverb.size);
                 }
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.reverb.damping, 1.0f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_REVERB_DAMPING, g_app.fx.reverb.damping);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.reverb.damping, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_REVERB_DAMPING, g_app.core.fx.reverb.damping);
                 }
                 nk_layout_row_dynamic(ctx, 34, 1);
-                if (nk_slider_float(ctx, 0.0f, &g_app.fx.reverb.mix, 1.0f, 0.01f)) {
-                    enqueue_param_float_msg(PARAM_FX_REVERB_MIX, g_app.fx.reverb.mix);
+                if (nk_slider_float(ctx, 0.0f, &g_app.core.fx.reverb.mix, 1.0f, 0.01f)) {
+                    enqueue_param_float_msg(PARAM_FX_REVERB_MIX, g_app.core.fx.reverb.mix);
+                }
+                nk_layout_row_dynamic(ctx, 28, 2);
+                nk_label(ctx, "Quality", NK_TEXT_LEFT);
+                static const char *reverb_qualities[] = {"Eco (8)", "Standard (8)", "High (16)"};
+                int reverb_quality = (int)g_app.core.fx.reverb.quality;
+                int new_reverb_quality = nk_combo(ctx, reverb_qualities, FX_REVERB_QUALITY_COUNT,
+                                                  reverb_quality, 28, nk_vec2(160, 120));
+                if (new_reverb_quality != reverb_quality) {
+                    g_app.core.fx.reverb.quality = (FxReverbQuality)new_reverb_quality; // Picked up next block
                 }
 
                 nk_layout_row_dynamic(ctx, 24, 1);
                 nk_label(ctx, "Arpeggiator", NK_TEXT_LEFT);
                 nk_layout_row_dynamic(ctx, 28, 2);
                 nk_label(ctx, "Mode", NK_TEXT_LEFT);
-                static const char *arp_modes[] = {"Off", "Up", "Down", "Up+Down", "Random"};
-                int arp_mode = (int)g_app.arp.mode;
-                int new_arp_mode = nk_combo(ctx, arp_modes, 5, arp_mode, 28, nk_vec2(140, 200));
+                static const char *arp_modes[] = {"Up", "Down", "Up+Down", "Random"};
+                int arp_mode = (int)g_app.arp_mode - ARP_UP;
+                int new_arp_mode = nk_combo(ctx, arp_modes, 4, arp_mode, 28, nk_vec2(140, 200));
                 if (new_arp_mode != arp_mode) {
-                    g_app.arp.mode = (ArpMode)new_arp_mode;
-                    enqueue_param_int_msg(PARAM_ARP_MODE, new_arp_mode);
+                    g_app.arp_mode = (ArpMode)(new_arp_mode + ARP_UP);
+                    enqueue_param_int_msg(PARAM_ARP_MODE, g_app.arp_mode);
                 }
 
                 nk_layout_row_begin(ctx, NK_STATIC, 120, 1);
                 nk_layout_row_push(ctx, master_knob_width);
                 UiKnobConfig arp_rate_cfg = {.label = "RATE", .unit = "stp"};
                 if (ui_knob_render(ctx, &g_app.knob_arp_rate, &arp_rate_cfg)) {
-                    g_app.arp.rate = g_app.knob_arp_rate.value;
-                    enqueue_param_float_msg(PARAM_ARP_RATE, g_app.arp.rate);
+                    enqueue_param_float_msg(PARAM_ARP_RATE, g_app.knob_arp_rate.value);
                 }
                 nk_layout_row_end(ctx);
 
                 nk_layout_row_dynamic(ctx, 28, 2);
                 nk_label(ctx, "Gate", NK_TEXT_LEFT);
-                if (nk_slider_float(ctx, 0.1f, &g_app.arp.gate, 1.0f, 0.05f)) {
-                    enqueue_param_float_msg(PARAM_ARP_GATE, g_app.arp.gate);
+                if (nk_slider_float(ctx, 0.1f, &g_app.arp_gate, 1.0f, 0.05f)) {
+                    enqueue_param_float_msg(PARAM_ARP_GATE, g_app.arp_gate);
                 }
 
                 nk_group_end(ctx);
@@ -2497,7 +2943,10 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
             nk_layout_row_push(ctx, (content_width - column_gap) * 0.5f);
             if (nk_group_begin_titled(ctx, "PANEL_VOICES", "Voice Activity", compact_panel_flags)) {
                 const float voice_bar_width = fminf((content_width - column_gap) * 0.3f, 280.0f);
-                for (int i = 0; i < MAX_VOICES; ++i) {
+                // One row per slot; slots show the newest sounding voices
+                const MeterVoices* voices = &g_app.meter.voices;
+                for (int i = 0; i < UI_VOICE_ROWS; ++i) {
+                    const MeterVoiceRow* voice = i < voices->row_count ? &voices->rows[i] : NULL;
                     nk_layout_row_begin(ctx, NK_STATIC, 22, 3);
                     nk_layout_row_push(ctx, 40);
                     char label[8];
@@ -2505,16 +2954,13 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                     nk_label(ctx, label, NK_TEXT_LEFT);
 
                     nk_layout_row_push(ctx, voice_bar_width);
-                    float level = 0.0f;
-                    if (g_app.synth.voices[i].state != VOICE_OFF) {
-                        level = g_app.synth.voices[i].env_amp.current_level;
-                    }
+                    float level = voice ? voice->level : 0.0f;
                     nk_size bar = (nk_size)(level * 100.0f);
                     nk_progress(ctx, &bar, 100, nk_false);
 
                     nk_layout_row_push(ctx, 60);
-                    if (g_app.synth.voices[i].state != VOICE_OFF) {
-                        snprintf(label, sizeof(label), "M%d", g_app.synth.voices[i].midi_note);
+                    if (voice) {
+                        snprintf(label, sizeof(label), voice->releasing ? "M%d~" : "M%d", voice->note);
                         nk_label(ctx, label, NK_TEXT_RIGHT);
                     } else {
                         nk_label(ctx, "-", NK_TEXT_RIGHT);
@@ -2528,7 +2974,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
             nk_layout_row_dynamic(ctx, 240, 1);
             if (nk_group_begin_titled(ctx, "PANEL_VOICE_LAYERS", "Voice Layers", compact_panel_flags)) {
                 for (int i = 0; i < MAX_VOICE_TRACKS; ++i) {
-                    const VoiceTrack* track = &g_app.voice_layers.tracks[i];
+                    VoiceTrack* track = &g_app.voice_layers.tracks[i];
 
                     nk_layout_row_dynamic(ctx, 24, 2);
                     char title_buf[32];
@@ -2536,17 +2982,18 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                     nk_label(ctx, title_buf, NK_TEXT_LEFT);
 
                     char status_buf[96];
-                    if (track->recording) {
-                        snprintf(status_buf, sizeof(status_buf), "Recordingâ€¦ (%u/%u frames)",
-                                 track->recorded_frames, track->record_capacity_frames);
-                    } else if (track->playing) {
+                    if (voice_track_is_recording(track)) {
+                        uint32_t recorded = atomic_load_explicit(&track->recorded_frames, memory_order_relaxed);
+                        snprintf(status_buf, sizeof(status_buf), "Recordingâ€¦ (%.1fs)",
+                                 recorded / (float)record_sample_rate());
+                    } else if (voice_track_is_playing(track) && track->source) {
                         snprintf(status_buf, sizeof(status_buf), "Playing (%.1fs)",
-                                 (track->buffer.sample_rate > 0)
-                                     ? (track->buffer.frame_count / (float)track->buffer.sample_rate)
+                                 (track->source->sample_rate > 0)
+                                     ? (track->source->frame_count / (float)track->source->sample_rate)
                                      : 0.0f);
-                    } else if (track->buffer.data && track->buffer.frame_count > 0) {
-                        float seconds = (track->buffer.sample_rate > 0)
-                                            ? (track->buffer.frame_count / (float)track->buffer.sample_rate)
+                    } else if (track->source && track->source->frame_count > 0) {
+                        float seconds = (track->source->sample_rate > 0)
+                                            ? (track->source->frame_count / (float)track->source->sample_rate)
                                             : 0.0f;
                         snprintf(status_buf, sizeof(status_buf), "Ready (%.1fs)", seconds);
                     } else {
@@ -2556,7 +3003,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
 
                     nk_layout_row_begin(ctx, NK_STATIC, 28, 4);
                     nk_layout_row_push(ctx, 80);
-                    if (track->recording) {
+                    if (voice_track_is_recording(track)) {
                         if (nk_button_label(ctx, "Stop")) {
                             voice_track_stop_recording(i);
                         }
@@ -2567,7 +3014,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                     }
 
                     nk_layout_row_push(ctx, 80);
-                    const char* play_label = track->playing ? "Stop Play" : "Play";
+                    const char* play_label = voice_track_is_playing(track) ? "Stop Play" : "Play";
                     if (nk_button_label(ctx, play_label)) {
                         voice_track_toggle_play(i);
                     }
@@ -2603,15 +3050,107 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
                 nk_group_end(ctx);
             }
 
-            nk_layout_row_dynamic(ctx, 200, 1);
+            nk_layout_row_dynamic(ctx, 345, 1);
+            if (nk_group_begin_titled(ctx, "PANEL_OUTPUT", "Output", compact_panel_flags)) {
+                const MeterFrame* meter = &g_app.meter;
+                static const char* channel_names[2] = {"L", "R"};
+                for (int c = 0; c < 2; ++c) {
+                    nk_layout_row_begin(ctx, NK_STATIC, 18, 3);
+                    nk_layout_row_push(ctx, 20);
+                    nk_label(ctx, channel_names[c], NK_TEXT_LEFT);
+                    nk_layout_row_push(ctx, 260);
+                    struct nk_rect meter_bounds;
+                    if (nk_widget(&meter_bounds, ctx) != NK_WIDGET_INVALID) {
+                        ui_draw_level_meter(nk_window_get_canvas(ctx), meter_bounds,
+                                            meter->peak[c], meter->rms[c], UI_METER_FLOOR_DB);
+                    }
+                    nk_layout_row_push(ctx, 90);
+                    char level_buf[32];
+                    float peak_db = meter->peak[c] > 0.0f ? 20.0f * log10f(meter->peak[c]) : UI_METER_FLOOR_DB;
+                    snprintf(level_buf, sizeof(level_buf), "%.1f dB", fmaxf(peak_db, UI_METER_FLOOR_DB));
+                    nk_label(ctx, level_buf, NK_TEXT_RIGHT);
+                    nk_layout_row_end(ctx);
+                }
+
+                float scope[UI_SCOPE_SAMPLES];
+                int scope_count = meter_feed_scope(&g_app.meter_feed, scope, UI_SCOPE_SAMPLES);
+                float bands[UI_SPECTRUM_BANDS];
+                meter_feed_spectrum(scope, scope_count, g_app.core.synth.sample_rate, 40.0f, 16000.0f,
+                                    bands, UI_SPECTRUM_BANDS);
+
+                nk_layout_row_dynamic(ctx, 80, 2);
+                struct nk_rect view_bounds;
+                if (nk_widget(&view_bounds, ctx) != NK_WIDGET_INVALID) {
+                    ui_draw_scope(nk_window_get_canvas(ctx), view_bounds, scope, scope_count);
+                }
+                if (nk_widget(&view_bounds, ctx) != NK_WIDGET_INVALID) {
+                    ui_draw_spectrum(nk_window_get_canvas(ctx), view_bounds, bands, UI_SPECTRUM_BANDS,
+                                     UI_METER_FLOOR_DB);
+                }
+
+                nk_layout_row_dynamic(ctx, 20, 1);
+                char drop_buf[96];
+                snprintf(drop_buf, sizeof(drop_buf), "Feed drops: %u frames / %u scope samples",
+                         atomic_load_explicit(&g_app.meter_feed.dropped_frames, memory_order_relaxed),
+                         atomic_load_explicit(&g_app.meter_feed.dropped_scope, memory_order_relaxed));
+                nk_label(ctx, drop_buf, NK_TEXT_LEFT);
+                ui_oversample_combo(ctx, "Clip oversampling", SYNTH_OVERSAMPLE_MASTER_CLIP);
+                ui_limiter_lookahead(ctx);
+                nk_group_end(ctx);
+            }
+
+            nk_layout_row_dynamic(ctx, 380, 1);
             if (nk_group_begin_titled(ctx, "PANEL_PERF", "Performance Monitor", compact_panel_flags)) {
+                rt_stats_poll(&g_app.rt_stats, &g_app.rt_snapshot);
+                const RtStatsSnapshot* stats = &g_app.rt_snapshot;
+                char stats_buf[96];
+
+                nk_layout_row_dynamic(ctx, 20, 1);
+                nk_label(ctx, g_app.audio_summary, NK_TEXT_LEFT);
+                snprintf(stats_buf, sizeof(stats_buf), "Latency: round trip %.1f ms, MIDI to output %.1f ms",
+                         audio_latency_ms(&g_app.audio_latency, g_app.audio_latency.round_trip_frames),
+                         audio_latency_ms(&g_app.audio_latency, g_app.audio_latency.midi_frames));
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                snprintf(stats_buf, sizeof(stats_buf), "Callback: mean %.0f / p99 %.0f / max %.0f us",
+                         stats->mean_us, stats->p99_us, stats->max_us);
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                double load = stats->budget_us > 0.0 ? stats->mean_us * 100.0 / stats->budget_us : 0.0;
+                snprintf(stats_buf, sizeof(stats_buf), "Budget: %.0f us (%u frames), load %.0f%%",
+                         stats->budget_us, stats->frames, load);
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                snprintf(stats_buf, sizeof(stats_buf), "Overruns: %llu   Late: %llu   Callbacks: %llu",
+                         (unsigned long long)stats->overruns, (unsigned long long)stats->late_callbacks,
+                         (unsigned long long)stats->callbacks);
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                snprintf(stats_buf, sizeof(stats_buf), "Voices: %d (peak %d)",
+                         stats->active_voices, stats->peak_voices);
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                snprintf(stats_buf, sizeof(stats_buf), "Drops: param %u / midi %u / seq %u / log %u",
+                         stats->param_drops, stats->midi_drops, stats->seq_drops, stats->log_drops);
+                nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                for (int s = 0; s < RT_STAGE_COUNT; s++) {
+                    snprintf(stats_buf, sizeof(stats_buf), "  %-9s mean %.1f / max %.1f us",
+                             rt_stage_name((RtStage)s), stats->stage_mean_us[s], stats->stage_max_us[s]);
+                    nk_label(ctx, stats_buf, NK_TEXT_LEFT);
+                }
+
+                nk_layout_row_dynamic(ctx, 26, 2);
+                if (nk_button_label(ctx, "Reset Stats")) {
+                    rt_stats_request_reset(&g_app.rt_stats);
+                }
+                if (nk_button_label(ctx, "Dump JSON")) {
+                    if (rt_stats_save_json(stats, "rt_stats.json")) {
+                        printf("Saved callback stats to rt_stats.json\n");
+                    }
+                }
+
                 nk_layout_row_dynamic(ctx, 26, 2);
                 nk_label(ctx, "Held notes", NK_TEXT_LEFT);
                 nk_label(ctx, "Mouse note", NK_TEXT_RIGHT);
 
                 nk_layout_row_dynamic(ctx, 26, 2);
                 char held_buf[64];
-                snprintf(held_buf, sizeof(held_buf), "%d active", g_app.arp.num_held);
+                snprintf(held_buf, sizeof(held_buf), "%d active", g_app.core.arp.num_held);
                 nk_label(ctx, held_buf, NK_TEXT_LEFT);
                 if (g_app.mouse_note_playing >= 0) {
                     char mouse_buf[32];
@@ -2623,11 +3162,7 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
 
                 nk_layout_row_dynamic(ctx, 32, 1);
                 if (nk_button_label(ctx, "Panic (All Notes Off)")) {
-                    synth_all_notes_off(&g_app.synth);
-                    memset(g_app.keys_pressed, 0, sizeof(g_app.keys_pressed));
-                    g_app.mouse_note_playing = -1;
-                    g_app.arp.num_held = 0;
-                    enqueue_param_int_msg(PARAM_PANIC, 1);
+                    app_panic();
                 }
 
                 nk_layout_row_dynamic(ctx, 24, 1);
@@ -2662,18 +3197,166 @@ void draw_gui(struct nk_context *ctx, float width, float height) {
     nk_end(ctx);
 }
 
+// ============================================================================
+// AUDIO DEVICE
+// ============================================================================
+
+static ma_backend audio_backend_to_ma(AudioBackend backend) {
+    switch (backend) {
+        case AUDIO_BACKEND_WASAPI:     return ma_backend_wasapi;
+        case AUDIO_BACKEND_DSOUND:     return ma_backend_dsound;
+        case AUDIO_BACKEND_WINMM:      return ma_backend_winmm;
+        case AUDIO_BACKEND_COREAUDIO:  return ma_backend_coreaudio;
+        case AUDIO_BACKEND_PULSEAUDIO: return ma_backend_pulseaudio;
+        case AUDIO_BACKEND_ALSA:       return ma_backend_alsa;
+        case AUDIO_BACKEND_JACK:       return ma_backend_jack;
+        case AUDIO_BACKEND_NULL:       return ma_backend_null;
+        default:                       return ma_backend_null;
+    }
+}
+
+// Opens (without starting) the device `settings` asks for. A backend that
+// refuses exclusive mode gets a second, shared attempt; anything else the
+// user asked for explicitly is an error rather than a silent substitute.
+static bool audio_device_open(const AudioSettings* settings) {
+    ma_context_config context_config = ma_context_config_init();
+    context_config.threadPriority = settings->realtime ? ma_thread_priority_realtime : ma_thread_priority_highest;
+    ma_backend backend = audio_backend_to_ma(settings->backend);
+    const bool any_backend = settings->backend == AUDIO_BACKEND_AUTO;
+    if (ma_context_init(any_backend ? NULL : &backend, any_backend ? 0 : 1, &context_config,
+                        &g_app.audio_context) != MA_SUCCESS) {
+        fprintf(stderr, "❌ Audio backend '%s' is not available\n", audio_backend_name(settings->backend));
+        return false;
+    }
+
+    ma_device_config config = ma_device_config_init(settings->duplex ? ma_device_type_duplex
+                                                                     : ma_device_type_playback);
+    config.playback.format = ma_format_f32;
+    config.playback.channels = 2;
+    config.capture.format = ma_format_f32;
+    config.capture.channels = 1;
+    config.sampleRate = settings->sample_rate;
+    config.periodSizeInFrames = settings->period_frames;
+    config.periods = settings->periods;
+    config.performanceProfile = ma_performance_profile_low_latency;
+    config.playback.shareMode = settings->exclusive ? ma_share_mode_exclusive : ma_share_mode_shared;
+    config.capture.shareMode = config.playback.shareMode;
+    if (settings->realtime || settings->exclusive) {
+        config.wasapi.usage = ma_wasapi_usage_pro_audio;   // MMCSS "Pro Audio" thread
+    }
+    config.dataCallback = audio_callback;
+    config.pUserData = &g_app;
+
+    ma_result result = ma_device_init(&g_app.audio_context, &config, &g_app.audio_device);
+    if (result != MA_SUCCESS && settings->exclusive) {
+        fprintf(stderr, "⚠️  Exclusive mode refused (%s), using shared mode\n", ma_result_description(result));
+        config.playback.shareMode = ma_share_mode_shared;
+        config.capture.shareMode = ma_share_mode_shared;
+        result = ma_device_init(&g_app.audio_context, &config, &g_app.audio_device);
+    }
+    if (result != MA_SUCCESS) {
+        fprintf(stderr, "❌ Failed to initialize audio: %s\n", ma_result_description(result));
+        ma_context_uninit(&g_app.audio_context);
+        return false;
+    }
+    return true;
+}
+
+// What the backend actually granted: its rate, period and buffer depth
+static void audio_device_report(void) {
+    const ma_device* device = &g_app.audio_device;
+    const bool duplex = device->type == ma_device_type_duplex;
+    AudioLatency* latency = &g_app.audio_latency;
+    audio_latency_compute(latency, device->playback.internalSampleRate,
+                          device->playback.internalPeriodSizeInFrames, device->playback.internalPeriods,
+                          duplex, device->capture.internalPeriodSizeInFrames, device->capture.internalPeriods);
+    const char* share = device->playback.shareMode == ma_share_mode_exclusive ? "exclusive" : "shared";
+    snprintf(g_app.audio_summary, sizeof(g_app.audio_summary), "%s %u Hz, %u x %u frames, %s, %s",
+             ma_get_backend_name(device->pContext->backend), latency->sample_rate, latency->period_frames,
+             device->playback.internalPeriods, share, duplex ? "duplex" : "playback only");
+    printf("✅ Audio: %s\n", g_app.audio_summary);
+    if (device->sampleRate != device->playback.internalSampleRate) {
+        printf("   Resampling %u Hz to the device's %u Hz\n", device->sampleRate,
+               device->playback.internalSampleRate);
+    }
+    printf("   Latency: output %.1f ms, input %.1f ms, round trip %.1f ms, MIDI to output %.1f ms\n",
+           audio_latency_ms(latency, latency->output_frames), audio_latency_ms(latency, latency->input_frames),
+           audio_latency_ms(latency, latency->round_trip_frames), audio_latency_ms(latency, latency->midi_frames));
+    if (!duplex) {
+        printf("   Playback only: voice tracks record silence (run with --duplex to use the input)\n");
+    }
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [--project file] [--polyphony n] [audio flags]\n"
+                    "  --project <file>    Take the audio device settings from a project (flags still win)\n"
+                    "  --polyphony <n>     Voices, 1-%d (default %d)\n",
+            argv0, SYNTH_MAX_POLYPHONY, APP_DEFAULT_POLYPHONY);
+    audio_settings_print_usage(stderr);
+}
+
+// The project's audio settings first, then the flags over them
+static bool parse_command_line(int argc, char** argv, AudioSettings* settings, int* polyphony) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--project") == 0) {
+            static ProjectData project;
+            if (!project_load_file(&project, argv[i + 1])) {
+                fprintf(stderr, "❌ Could not load project %s\n", argv[i + 1]);
+                return false;
+            }
+            *settings = project.audio;
+        }
+    }
+    for (int i = 1; i < argc;) {
+        int used = audio_settings_parse_arg(settings, argc, argv, i);
+        if (used == 0 && strcmp(argv[i], "--project") == 0 && i + 1 < argc) {
+            used = 2;
+        } else if (used == 0 && strcmp(argv[i], "--polyphony") == 0) {
+            char* end = NULL;
+            long voices = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : 0;
+            if (end && end != argv[i + 1] && *end == '\0' && voices >= 1 && voices <= SYNTH_MAX_POLYPHONY) {
+                *polyphony = (int)voices;
+                used = 2;
+            } else {
+                used = -1;
+            }
+        }
+        if (used <= 0) {
+            usage(argv[0]);
+            return false;
+        }
+        i += used;
+    }
+    return true;
+}
+
 // ============================================================================
 // MAIN
 // ============================================================================
 
-int main(void) {
+int main(int argc, char** argv) {
+    AudioSettings audio_settings;
+    audio_settings_init(&audio_settings);
+    int polyphony = APP_DEFAULT_POLYPHONY;
+    if (!parse_command_line(argc, argv, &audio_settings, &polyphony)) {
+        return 1;
+    }
+
     printf("â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•\n");
     printf("     ðŸŽ¹ PROFESSIONAL SYNTHESIZER ðŸŽ¹\n");
     printf("â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•â•\n\n");
 
+    rt_log_init();
+    rt_log_writer_start();
     voice_layers_init(&g_app.voice_layers);
+    audio_handoff_init();
     preset_snippet_library_init(&g_app.preset_snippets);
-    ma_mutex_init(&g_app.audio_mutex);
+    ensure_directory_exists(PRESET_BROWSER_DIR);
+    preset_library_init(&g_app.preset_library, PRESET_BROWSER_INDEX);
+    preset_library_add_root(&g_app.preset_library, PRESET_BROWSER_DIR);
+    preset_library_scan_async(&g_app.preset_library);
+    disk_writer_start();
+    sample_streamer_start();
 
     // Init GLFW
     glfwSetErrorCallback(error_callback);
@@ -2705,6 +3388,10 @@ int main(void) {
     }
 
     glfwSwapInterval(1);
+    glfwSetWindowRefreshCallback(g_app.window, window_refresh_callback);
+    ui_frame_pacer_init(&g_app.ui_pacer, UI_METER_HZ, UI_IDLE_HZ);
+    const char* ui_continuous = getenv("SYNTH_UI_CONTINUOUS");
+    g_app.ui_continuous = ui_continuous && atoi(ui_continuous) != 0;
     
     // Init Nuklear (don't let it install callbacks, we'll handle keyboard ourselves)
     g_app.nk_ctx = nk_glfw3_init(&g_app.glfw, g_app.window, NK_GLFW3_DEFAULT);
@@ -2721,11 +3408,31 @@ int main(void) {
     midi_input_start();
     midi_input_list_ports();
 
-    // Init synth
-    synth_init(&g_app.synth, 44100.0f);
-    g_app.tempo = 120.0f;
+    // Init audio. The engine runs at whatever rate the device opened at.
+    if (!audio_device_open(&audio_settings)) {
+        return 1;
+    }
+
+    // Init synth core: engine, FX, arp & sequencer
+    if (!synth_core_init(&g_app.core, (float)g_app.audio_device.sampleRate, polyphony)) {
+        fprintf(stderr, "❌ Failed to allocate effect buffers\n");
+        return 1;
+    }
+    synth_core_set_hooks(&g_app.core, core_apply_queued_events, core_mix_recorders, NULL);
+    g_app.core.stats = &g_app.rt_stats;
+
+    // Parallel voice rendering: SYNTH_VOICE_THREADS=<workers> (0 = one per spare core)
+    const char* voice_threads = getenv("SYNTH_VOICE_THREADS");
+    if (voice_threads && voice_threads[0] != '\0') {
+        g_app.voice_pool = voice_pool_create(atoi(voice_threads));
+        synth_set_voice_pool(&g_app.core.synth, g_app.voice_pool, 0);
+        if (g_app.voice_pool) {
+            printf("Voice rendering on %d worker threads\n", voice_pool_worker_count(g_app.voice_pool));
+        }
+    }
+    g_app.core.tempo = 120.0f;
     g_app.master_volume = 0.8f;
-    g_app.synth.master_volume = 0.8f;
+    g_app.core.synth.master_volume = 0.8f;
     g_app.filter_cutoff = 8000.0f;  // Start with brighter sound
     g_app.filter_resonance = 0.3f;
     g_app.env_attack = 0.01f;
@@ -2735,6 +3442,7 @@ int main(void) {
     g_app.osc1_wave = WAVE_SAW;
     g_app.osc1_unison = 1;
     g_app.osc1_pwm = 0.5f;
+    g_app.arp_gate = g_app.core.arp.gate;
     snprintf(g_app.patch_name, sizeof(g_app.patch_name), "Init Patch");
     g_app.patch_category = 0;
     g_app.ui_section = 0;
@@ -2751,62 +3459,63 @@ int main(void) {
         g_app.mod_slots[i].enabled = (i == 0);
     }
     
-    // Init FX
-    fx_delay_init(&g_app.fx.delay);
-    g_app.fx.distortion.drive = 2.0f;
-    g_app.fx.distortion.mix = 0.3f;
-    g_app.fx.reverb.size = 0.5f;
-    g_app.fx.reverb.damping = 0.5f;
-    g_app.fx.reverb.mix = 0.2f;
-    
-    // Init arp
-    arp_init(&g_app.arp);
     ui_knobs_init();
     
     // Init mouse tracking
     g_app.mouse_note_playing = -1;
     g_app.mouse_was_down = false;
     
-    // Init audio
-    ma_device_config config = ma_device_config_init(ma_device_type_duplex);
-    config.playback.format = ma_format_f32;
-    config.playback.channels = 2;
-    config.capture.format = ma_format_f32;
-    config.capture.channels = 1;
-    config.sampleRate = 44100;
-    config.dataCallback = audio_callback;
-    config.pUserData = &g_app;
-    
-    if (ma_device_init(NULL, &config, &g_app.audio_device) != MA_SUCCESS) {
-        fprintf(stderr, "âŒ Failed to initialize audio\n");
-        return 1;
-    }
-    g_app.capture_channels = g_app.audio_device.capture.channels;
+    g_app.capture_channels = g_app.audio_device.type == ma_device_type_duplex
+                                 ? (int)g_app.audio_device.capture.channels : 0;
+    rt_stats_init(&g_app.rt_stats, g_app.core.synth.sample_rate);
+    meter_feed_init(&g_app.meter_feed);
+    printf("Effect buffers: %.1f MB at %.0f Hz\n",
+           (double)fx_rack_memory_bytes(&g_app.core.fx) / (1024.0 * 1024.0), g_app.core.synth.sample_rate);
     
     if (ma_device_start(&g_app.audio_device) != MA_SUCCESS) {
         fprintf(stderr, "âŒ Failed to start audio\n");
         return 1;
     }
     
-    printf("âœ… Audio: 44100 Hz, stereo, %.1f ms latency\n", 
-           (float)config.periodSizeInFrames / 44100.0f * 1000.0f);
+    audio_device_report();
     printf("âœ… GUI: Ready\n");
     printf("âœ… Controls: QWERTY keyboard â†’ Notes\n\n");
     
     // Play test tone to verify audio
     printf("ðŸ”Š Playing test tone (C4)...\n");
-    synth_note_on(&g_app.synth, 60, 1.0f);  // C4 (middle C)
+    midi_queue_send_note_on(60, 127);  // C4 (middle C)
     sleep_milliseconds(1000);
-    synth_note_off(&g_app.synth, 60);
+    midi_queue_send_note_off(60);
     printf("âœ… Audio test complete!\n\n");
     
     printf("Ready to play! ðŸŽµ\n\n");
     
     g_app.bg.r = 0.10f; g_app.bg.g = 0.18f; g_app.bg.b = 0.24f; g_app.bg.a = 1.0f;
     
-    // Main loop
+    // Main loop. Sleeps until input or the pacer's next deadline, and only
+    // renders frames whose Nuklear commands changed.
+    const double loop_start = glfwGetTime();
+    const clock_t loop_cpu_start = clock();
     while (!glfwWindowShouldClose(g_app.window)) {
-        glfwPollEvents();
+        bool input = true;
+        if (g_app.ui_continuous) {
+            glfwPollEvents();
+            g_app.ui_pacer.wakes++;
+            g_app.ui_pacer.frames_rendered++;
+        } else {
+            double wait = ui_frame_pacer_wait_time(&g_app.ui_pacer, glfwGetTime(), ui_is_animating());
+            if (wait > 0.0) {
+                glfwWaitEventsTimeout(wait);
+            } else {
+                glfwPollEvents();
+            }
+            input = ui_frame_pacer_woke_for_input(&g_app.ui_pacer, glfwGetTime());
+        }
+        if (preset_library_poll(&g_app.preset_library)) {
+            g_app.browser_selection = -1; // Indices refer to the previous snapshot
+        }
+        // Before ui_is_animating() runs again, so the loop idles once output stops
+        meter_feed_poll(&g_app.meter_feed, &g_app.meter);
         
         // Poll keyboard state directly (backup to callback system)
         for (size_t i = 0; i < KEYMAP_SIZE; i++) {
@@ -2829,33 +3538,58 @@ int main(void) {
         if (mouse_state == GLFW_RELEASE && g_app.mouse_was_down) {
             // Mouse released - stop any mouse-triggered note
             if (g_app.mouse_note_playing >= 0) {
-                synth_note_off(&g_app.synth, g_app.mouse_note_playing);
+                stop_note(g_app.mouse_note_playing, "mouse");
                 printf("ðŸ”‡ Mouse released - stopping note %d\n", g_app.mouse_note_playing);
                 g_app.mouse_note_playing = -1;
             }
         }
         g_app.mouse_was_down = (mouse_state == GLFW_PRESS);
         
-    int fb_width = 0;
-    int fb_height = 0;
-    glfwGetFramebufferSize(g_app.window, &fb_width, &fb_height);
+        int fb_width = 0;
+        int fb_height = 0;
+        glfwGetFramebufferSize(g_app.window, &fb_width, &fb_height);
 
-    nk_glfw3_new_frame(&g_app.glfw);
+        nk_glfw3_new_frame(&g_app.glfw);
         
-    draw_gui(g_app.nk_ctx, (float)fb_width, (float)fb_height);
+        draw_gui(g_app.nk_ctx, (float)fb_width, (float)fb_height);
+
+        if (!g_app.ui_continuous &&
+            !ui_frame_pacer_frame_changed(&g_app.ui_pacer, g_app.nk_ctx, fb_width, fb_height, input)) {
+            nk_clear(g_app.nk_ctx); // Same commands as the frame on screen
+            continue;
+        }
         
-    glViewport(0, 0, fb_width, fb_height);
-    glClear(GL_COLOR_BUFFER_BIT);
+        glViewport(0, 0, fb_width, fb_height);
+        glClear(GL_COLOR_BUFFER_BIT);
         glClearColor(g_app.bg.r, g_app.bg.g, g_app.bg.b, g_app.bg.a);
         
         nk_glfw3_render(&g_app.glfw, NK_ANTI_ALIASING_ON, MAX_VERTEX_BUFFER, MAX_ELEMENT_BUFFER);
         glfwSwapBuffers(g_app.window);
     }
+
+    // Idle cost of the loop; compare against a SYNTH_UI_CONTINUOUS=1 run
+    const double loop_seconds = glfwGetTime() - loop_start;
+    const double loop_cpu = (double)(clock() - loop_cpu_start) / CLOCKS_PER_SEC;
+    if (loop_seconds > 0.0) {
+        printf("UI loop: %.0f s, process CPU %.1f%%, %llu wakes, %llu frames rendered, %llu skipped%s\n",
+               loop_seconds, loop_cpu * 100.0 / loop_seconds,
+               (unsigned long long)g_app.ui_pacer.wakes,
+               (unsigned long long)g_app.ui_pacer.frames_rendered,
+               (unsigned long long)g_app.ui_pacer.frames_skipped,
+               g_app.ui_continuous ? " (continuous)" : "");
+    }
     
     // Cleanup
     midi_input_stop();
     ma_device_uninit(&g_app.audio_device);
-    ma_mutex_uninit(&g_app.audio_mutex);
+    ma_context_uninit(&g_app.audio_context);
+    synth_core_free(&g_app.core);
+    synth_set_voice_pool(&g_app.core.synth, NULL, 0);
+    voice_pool_destroy(g_app.voice_pool);
+    disk_writer_stop(); // Finalizes any take still recording
+    sample_streamer_stop();
+    preset_library_shutdown(&g_app.preset_library);
+    rt_log_writer_stop(); // Prints whatever is still queued
     nk_glfw3_shutdown(&g_app.glfw);
     glfwTerminate();
     
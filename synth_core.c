@@ -0,0 +1,152 @@
+#include "synth_core.h"
+#include "denormal.h"
+
+#include <string.h>
+
+bool synth_core_init(SynthCore* core, float sample_rate, int polyphony) {
+    if (!core) {
+        return false;
+    }
+    memset(core, 0, sizeof(*core));
+    synth_init_with_polyphony(&core->synth, sample_rate, polyphony > 0 ? polyphony : MAX_VOICES);
+    synth_set_steal_mode(&core->synth, VOICE_STEAL_RELEASED_FIRST);
+    fx_rack_init(&core->fx);
+    if (!fx_rack_prepare(&core->fx, sample_rate)) {
+        return false;
+    }
+    arp_init(&core->arp);
+    sequencer_init(&core->sequencer);
+    core->tempo = 120.0f;
+    return true;
+}
+
+void synth_core_free(SynthCore* core) {
+    if (core) {
+        fx_rack_free(&core->fx);
+    }
+}
+
+void synth_core_set_hooks(SynthCore* core, synth_core_events_fn events, synth_core_insert_fn insert,
+                          void* userdata) {
+    core->events = events;
+    core->insert = insert;
+    core->hook_userdata = userdata;
+}
+
+void synth_core_set_seed(SynthCore* core, uint32_t seed) {
+    if (seed == 0) {
+        seed = SYNTH_DEFAULT_SEED;
+    }
+    synth_set_seed(&core->synth, seed);
+    arp_set_seed(&core->arp, seed);
+}
+
+void synth_core_set_oversample(SynthCore* core, SynthOversampleStage stage, OversampleMode mode) {
+    switch (stage) {
+        case SYNTH_OVERSAMPLE_DISTORTION:
+            core->fx.distortion.oversample = mode;
+            break;
+        case SYNTH_OVERSAMPLE_MASTER_CLIP:
+            synth_set_master_oversample(&core->synth, mode);
+            break;
+        default:
+            break;
+    }
+}
+
+void synth_core_note_on(SynthCore* core, uint8_t note, float velocity) {
+    synth_core_channel_note_on(core, 0, note, velocity);
+}
+
+void synth_core_note_off(SynthCore* core, uint8_t note) {
+    if (core->arp.enabled) {
+        arp_note_off(&core->arp, note);
+    } else {
+        synth_note_off(&core->synth, note);
+    }
+}
+
+void synth_core_channel_note_on(SynthCore* core, int channel, uint8_t note, float velocity) {
+    if (core->arp.enabled) {
+        arp_note_on(&core->arp, note);
+    } else {
+        synth_note_on_channel(&core->synth, channel, note, velocity > 0.0f ? velocity : 1.0f);
+    }
+}
+
+void synth_core_channel_note_off(SynthCore* core, int channel, uint8_t note) {
+    if (core->arp.enabled) {
+        arp_note_off(&core->arp, note);
+    } else {
+        synth_note_off_channel(&core->synth, channel, note);
+    }
+}
+
+double synth_core_time(const SynthCore* core) {
+    return (double)core->synth.sample_counter / core->synth.sample_rate;
+}
+
+static bool synth_core_collect_event(const SeqEvent* event, void* userdata) {
+    SynthCore* core = (SynthCore*)userdata;
+    if (core->num_seq_events >= SYNTH_CORE_MAX_EVENTS) {
+        return false; // Scheduled again with the next call
+    }
+    core->seq_events[core->num_seq_events++] = *event;
+    return true;
+}
+
+void synth_core_process(SynthCore* core, const float* in, float* out, uint32_t frames) {
+    float sample_rate = core->synth.sample_rate;
+    DenormalMode fp_mode = denormal_flush_begin();
+
+    // Everything the sequencer plays this call, stamped with its frame
+    core->num_seq_events = 0;
+    core->next_seq_event = 0;
+    sequencer_schedule(&core->sequencer, core->synth.sample_counter + frames, sample_rate, core->tempo,
+                       synth_core_collect_event, core);
+
+    // One sub-block at a time, split at every event's timestamp so notes
+    // and params land on their exact frame
+    uint32_t start = 0;
+    while (start < frames) {
+        uint64_t now = core->synth.sample_counter;
+        uint32_t block_frames = frames - start;
+        if (block_frames > SYNTH_BLOCK_SIZE) {
+            block_frames = SYNTH_BLOCK_SIZE;
+        }
+        if (core->events) {
+            block_frames = core->events(core, now, block_frames, core->hook_userdata);
+        }
+        while (core->next_seq_event < core->num_seq_events &&
+               core->seq_events[core->next_seq_event].sample_frame <= now) {
+            sequencer_dispatch(&core->seq_events[core->next_seq_event++], &core->arp, &core->synth);
+        }
+        if (core->next_seq_event < core->num_seq_events &&
+            core->seq_events[core->next_seq_event].sample_frame - now < block_frames) {
+            block_frames = (uint32_t)(core->seq_events[core->next_seq_event].sample_frame - now);
+        }
+        // Arp steps due now play here; the block then ends on the next one
+        arp_process(&core->arp, now, sample_rate, core->tempo, arp_play_event, &core->synth);
+        uint64_t arp_next = arp_next_event_frame(&core->arp);
+        if (arp_next > now && arp_next - now < block_frames) {
+            block_frames = (uint32_t)(arp_next - now);
+        }
+
+        float* block = out + (size_t)start * 2;
+        uint64_t t_voices = core->stats ? rt_stats_now_ns() : 0;
+        synth_process(&core->synth, block, (int)block_frames);
+        uint64_t t_fx = core->stats ? rt_stats_now_ns() : 0;
+        fx_rack_process(&core->fx, block, (int)block_frames, sample_rate);
+        if (core->stats) {
+            uint64_t t_done = rt_stats_now_ns();
+            rt_stats_add_stage(core->stats, RT_STAGE_VOICES, t_fx - t_voices);
+            rt_stats_add_stage(core->stats, RT_STAGE_FX, t_done - t_fx);
+        }
+        if (core->insert) {
+            const float* block_in = in ? in + (size_t)start * (size_t)core->input_channels : NULL;
+            core->insert(core, block_in, block, block_frames, core->hook_userdata);
+        }
+        start += block_frames;
+    }
+    denormal_flush_end(fp_mode);
+}
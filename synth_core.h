@@ -0,0 +1,107 @@
+#ifndef SYNTH_CORE_H
+#define SYNTH_CORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fx_rack.h"
+#include "rt_stats.h"
+#include "sequencer.h"
+#include "synth_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Headless synth core.
+ *
+ * One context holding everything the audio callback renders from: engine,
+ * FX rack, arpeggiator, sequencer and tempo. synth_core_process() is the
+ * live signal chain with no device, GLFW or UI behind it: the sequencer
+ * schedules the period up front, sub-blocks end on every event's frame,
+ * then voices and FX render in place. The app, the offline bounce and the
+ * benchmarks all render through it.
+ *
+ * The host plugs in around the chain with two optional hooks: `events`
+ * applies its own timestamped input (param and MIDI queues) at each
+ * sub-block start, and `insert` processes each sub-block after the FX
+ * (the app's voice layers and snippets).
+ */
+
+#define SYNTH_CORE_MAX_EVENTS 256   // Sequencer events per process call
+
+// Nonlinear stages that can run oversampled (oversample.h)
+typedef enum {
+    SYNTH_OVERSAMPLE_DISTORTION = 0,   // FX rack distortion
+    SYNTH_OVERSAMPLE_MASTER_CLIP,      // Engine master soft clip
+    SYNTH_OVERSAMPLE_STAGE_COUNT
+} SynthOversampleStage;
+
+typedef struct SynthCore SynthCore;
+
+// Apply the host's events due at or before frame `now`; return the frames
+// until its next one, at most `limit`
+typedef uint32_t (*synth_core_events_fn)(SynthCore* core, uint64_t now, uint32_t limit, void* userdata);
+
+// Process one sub-block after the FX. `in` is the matching input frames
+// (core->input_channels per frame), NULL when there is no input.
+typedef void (*synth_core_insert_fn)(SynthCore* core, const float* in, float* out, uint32_t frames,
+                                     void* userdata);
+
+struct SynthCore {
+    SynthEngine synth;
+    EffectsRack fx;
+    Arpeggiator arp;
+    Sequencer sequencer;
+    float tempo;
+
+    int input_channels;            // Interleaved channels of process() input
+    RtStats* stats;                // Optional: voice and FX stage timings
+
+    synth_core_events_fn events;
+    synth_core_insert_fn insert;
+    void* hook_userdata;
+
+    // Sequencer events scheduled for the current process call, in frame order
+    SeqEvent seq_events[SYNTH_CORE_MAX_EVENTS];
+    int num_seq_events;
+    int next_seq_event;
+};
+
+// Engine at `polyphony` voices (<= 0 = MAX_VOICES), FX buffers
+// sized for `sample_rate`, arp and sequencer idle. False if the FX buffers
+// cannot be allocated. Call from a non-realtime thread.
+bool synth_core_init(SynthCore* core, float sample_rate, int polyphony);
+void synth_core_free(SynthCore* core);
+
+void synth_core_set_hooks(SynthCore* core, synth_core_events_fn events, synth_core_insert_fn insert,
+                          void* userdata);
+// Engine and arp random state; 0 = SYNTH_DEFAULT_SEED
+void synth_core_set_seed(SynthCore* core, uint32_t seed);
+
+// Oversampling for one stage; realtime-safe, call from the rendering thread
+void synth_core_set_oversample(SynthCore* core, SynthOversampleStage stage, OversampleMode mode);
+
+// Live note input: through the arpeggiator when it is enabled, as
+// sequencer steps are. Velocity 0-1; call from the rendering thread.
+void synth_core_note_on(SynthCore* core, uint8_t note, float velocity);
+void synth_core_note_off(SynthCore* core, uint8_t note);
+// The same on a MIDI channel (0-15), for MPE and multi-channel input;
+// the arpeggiator ignores the channel
+void synth_core_channel_note_on(SynthCore* core, int channel, uint8_t note, float velocity);
+void synth_core_channel_note_off(SynthCore* core, int channel, uint8_t note);
+
+// Render `frames` interleaved stereo frames into `out`. `in` may be NULL.
+// Runs with flush-to-zero set on the calling thread (denormal.h) and
+// restores the caller's mode on return.
+void synth_core_process(SynthCore* core, const float* in, float* out, uint32_t frames);
+
+// Seconds rendered so far, from the engine's frame counter
+double synth_core_time(const SynthCore* core);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYNTH_CORE_H
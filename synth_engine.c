@@ -4,31 +4,44 @@
  */
 
 #include "synth_engine.h"
+#include "denormal.h"
+#include "dsp_math.h"
+#include "voice_pool.h"
+#include "voice_simd.h"
+#include "wavetable.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 #define TWO_PI (2.0f * M_PI)
+#define ENV_SILENCE_LEVEL 0.0001f   // -80 dB: release stage ends here
+
+// Analog-style segments. Attack charges toward twice the peak and stops on
+// it, landing in exactly the attack time. Decay and release are RC curves
+// with their times as time constants; decay aims 0.1% of its drop below
+// sustain so the segment still ends (after ~6.9 time constants).
+#define ENV_ATTACK_OVERSHOOT 1.0f
+#define ENV_ATTACK_LOG_RATIO 0.69314718f    // ln((1 + 1) / 1)
+#define ENV_DECAY_OVERSHOOT 0.001f
 
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
 
 float midi_to_freq(int midi_note) {
-    return 440.0f * powf(2.0f, (midi_note - 69) / 12.0f);
+    return 440.0f * dsp_exp2f((float)(midi_note - 69) / 12.0f);
 }
 
 float cents_to_ratio(float cents) {
-    return powf(2.0f, cents / 1200.0f);
+    return dsp_exp2f(cents / 1200.0f);
 }
 
 float db_to_linear(float db) {
-    return powf(10.0f, db / 20.0f);
+    return dsp_exp2f(db * (3.32192809f / 20.0f)); // log2(10) / 20
 }
 
 float linear_to_db(float linear) {
@@ -39,7 +52,7 @@ float soft_clip(float x) {
     // Soft clipping using tanh
     if (x > 1.0f) return 1.0f;
     if (x < -1.0f) return -1.0f;
-    return tanhf(x * 1.5f) / tanhf(1.5f);
+    return dsp_tanhf(x * 1.5f) * (1.0f / 0.905148254f); // 1 / tanh(1.5)
 }
 
 float clamp(float value, float min, float max) {
@@ -52,11 +65,30 @@ float lerp(float a, float b, float t) {
     return a + (b - a) * t;
 }
 
-// Fast random float between 0.0 and 1.0
-static uint32_t rng_state = 123456789;
-float fast_rand(void) {
-    rng_state = rng_state * 1664525 + 1013904223;
-    return (float)(rng_state >> 8) / 16777216.0f;
+// Two-sample polynomial band-limited step residual (t = phase, dt = increment)
+float poly_blep(float t, float dt) {
+    if (t < dt) {
+        float x = t / dt;
+        return x + x - x * x - 1.0f;
+    }
+    if (t > 1.0f - dt) {
+        float x = (t - 1.0f) / dt;
+        return x * x + x + x + 1.0f;
+    }
+    return 0.0f;
+}
+
+// Integrated PolyBLEP: residual for a unit change of slope per sample
+float poly_blamp(float t, float dt) {
+    if (t < dt) {
+        float x = t / dt - 1.0f;
+        return -(x * x * x) / 3.0f;
+    }
+    if (t > 1.0f - dt) {
+        float x = (t - 1.0f) / dt + 1.0f;
+        return (x * x * x) / 3.0f;
+    }
+    return 0.0f;
 }
 
 // ============================================================================
@@ -75,6 +107,9 @@ void osc_init(Oscillator* osc, float sample_rate) {
     osc->detune_cents = 0.0f;
     osc->unison_spread = 0.5f;
     osc->wavetable_size = WAVETABLE_SIZE;
+    osc->band_limited = true;
+    osc->noise_state = SYNTH_DEFAULT_SEED;
+    osc_reset_unison_phases(osc);
 }
 
 void osc_set_waveform(Oscillator* osc, WaveformType type) {
@@ -85,21 +120,74 @@ void osc_set_frequency(Oscillator* osc, float freq) {
     osc->frequency = freq;
 }
 
-// Generate basic waveform sample (internal)
-static float osc_generate_basic(Oscillator* osc, float phase, float pw) {
+// Spread sub-voice phases evenly from the master phase (note-on / sync)
+void osc_reset_unison_phases(Oscillator* osc) {
+    int count = osc->unison_voices > 0 ? osc->unison_voices : 1;
+    for (int i = 0; i < MAX_UNISON; i++) {
+        float phase = osc->phase + (float)i / (float)count;
+        osc->unison_phases[i] = phase - floorf(phase);
+    }
+}
+
+// Rebuild detune ratios only when the unison settings move; pitch changes
+// don't matter since the ratios are relative to the base frequency
+static void osc_update_unison(Oscillator* osc) {
+    if (osc->unison_cached_voices == osc->unison_voices &&
+        osc->unison_cached_detune == osc->detune_cents &&
+        osc->unison_cached_spread == osc->unison_spread) {
+        return;
+    }
+    
+    int count = osc->unison_voices;
+    if (count > MAX_UNISON) count = MAX_UNISON;
+    float center = (float)(count - 1) * 0.5f;
+    float denom = center > 0.0f ? center : 1.0f;
+    
+    for (int i = 0; i < MAX_UNISON; i++) {
+        float spread = ((float)i - center) / denom; // -1.0 to 1.0 symmetric
+        float detune_offset = spread * osc->detune_cents * osc->unison_spread;
+        osc->unison_ratios[i] = i < count ? cents_to_ratio(detune_offset) : 1.0f;
+    }
+    
+    // Newly enabled sub-voices start evenly spread instead of stacked at 0
+    if (count != osc->unison_cached_voices) {
+        osc_reset_unison_phases(osc);
+    }
+    
+    osc->unison_cached_voices = osc->unison_voices;
+    osc->unison_cached_detune = osc->detune_cents;
+    osc->unison_cached_spread = osc->unison_spread;
+}
+
+static inline float phase_wrap_offset(float phase, float offset) {
+    float t = phase + offset;
+    if (t >= 1.0f) t -= 1.0f;
+    return t;
+}
+
+// Generate basic waveform sample (internal); dt is the phase increment used
+// for band-limiting corrections
+static float osc_generate_basic(Oscillator* osc, float phase, float pw, float dt) {
     float output = 0.0f;
     
     switch (osc->waveform) {
         case WAVE_SINE:
-            output = sinf(phase * TWO_PI);
+            output = dsp_sin_turns(phase);
             break;
             
         case WAVE_SAW:
             output = (phase * 2.0f) - 1.0f;
+            if (osc->band_limited) {
+                output -= poly_blep(phase, dt);
+            }
             break;
             
         case WAVE_SQUARE:
             output = (phase < pw) ? 1.0f : -1.0f;
+            if (osc->band_limited) {
+                output += poly_blep(phase, dt);
+                output -= poly_blep(phase_wrap_offset(phase, 1.0f - pw), dt);
+            }
             break;
             
         case WAVE_TRIANGLE:
@@ -108,14 +196,23 @@ static float osc_generate_basic(Oscillator* osc, float phase, float pw) {
             } else {
                 output = 3.0f - (phase * 4.0f);
             }
+            if (osc->band_limited) {
+                // Slope flips by +/-8 per cycle at the trough (0) and peak (0.5);
+                // poly_blamp() spans two samples, so the per-corner weight is 4 * dt
+                output += 4.0f * dt * (poly_blamp(phase, dt) -
+                                       poly_blamp(phase_wrap_offset(phase, 0.5f), dt));
+            }
             break;
             
         case WAVE_NOISE:
-            output = (fast_rand() * 2.0f) - 1.0f;
+            output = (synth_rng_float(&osc->noise_state) * 2.0f) - 1.0f;
             break;
             
         case WAVE_WAVETABLE:
-            if (osc->wavetable && osc->wavetable_size > 0) {
+            if (osc->band_limited && osc->wavetable_mip) {
+                int level = wavetable_mip_select(osc->wavetable_mip, dt);
+                output = wavetable_mip_read(osc->wavetable_mip, level, phase);
+            } else if (osc->wavetable && osc->wavetable_size > 0) {
                 float pos = phase * osc->wavetable_size;
                 int index = (int)pos;
                 float frac = pos - index;
@@ -123,7 +220,7 @@ static float osc_generate_basic(Oscillator* osc, float phase, float pw) {
                 output = lerp(osc->wavetable[index], 
                             osc->wavetable[next_index], frac);
             } else {
-                output = sinf(phase * TWO_PI); // Fallback to sine
+                output = dsp_sin_turns(phase); // Fallback to sine
             }
             break;
             
@@ -145,37 +242,35 @@ float osc_process(Oscillator* osc, float sample_rate, float fm_input) {
     
     // Apply drift (analog feel)
     if (osc->drift_amount > 0.0f) {
-        float drift_lfo = sinf(osc->drift_phase * TWO_PI);
+        float drift_lfo = dsp_sin_turns(osc->drift_phase);
         base_freq *= 1.0f + (drift_lfo * osc->drift_amount * 0.01f); // ±1% max
         osc->drift_phase += osc->drift_rate / sample_rate;
         if (osc->drift_phase >= 1.0f) osc->drift_phase -= 1.0f;
     }
     
+    float phase_increment = base_freq / sample_rate;
+    
     // Unison processing
     if (osc->unison_voices > 1) {
+        osc_update_unison(osc);
+        int count = osc->unison_voices > MAX_UNISON ? MAX_UNISON : osc->unison_voices;
+        
         float unison_output = 0.0f;
-        float center = (float)(osc->unison_voices - 1) * 0.5f;
-        float denom = center > 0.0f ? center : 1.0f;
-
-        for (int i = 0; i < osc->unison_voices; i++) {
-            float spread = ( (float)i - center ) / denom; // -1.0 to 1.0 symmetric
-            float detune_offset = spread * osc->detune_cents * osc->unison_spread;
-
-            float voice_freq = base_freq * cents_to_ratio(detune_offset);
-            float detune_ratio = voice_freq / fmaxf(base_freq, 0.0001f);
-
-            float phase_jitter = (float)i / (float)osc->unison_voices;
-            float voice_phase = osc->phase * detune_ratio + phase_jitter;
-            voice_phase -= floorf(voice_phase);
-
-            float pw = osc->pulse_width;
-            unison_output += osc_generate_basic(osc, voice_phase, pw);
+        for (int i = 0; i < count; i++) {
+            unison_output += osc_generate_basic(osc, osc->unison_phases[i], osc->pulse_width,
+                                                phase_increment * osc->unison_ratios[i]);
+        }
+        
+        // Fixed-length advance so the compiler can vectorize it
+        for (int i = 0; i < MAX_UNISON; i++) {
+            float phase = osc->unison_phases[i] + phase_increment * osc->unison_ratios[i];
+            osc->unison_phases[i] = phase >= 1.0f ? phase - 1.0f : phase;
         }
 
-        output = unison_output / osc->unison_voices;
+        output = unison_output / (float)count;
     } else {
         // Single voice
-        output = osc_generate_basic(osc, osc->phase, osc->pulse_width);
+        output = osc_generate_basic(osc, osc->phase, osc->pulse_width, phase_increment);
     }
     
     // Hard sync (sync to sync_phase)
@@ -183,11 +278,13 @@ float osc_process(Oscillator* osc, float sample_rate, float fm_input) {
         if (osc->sync_phase >= 1.0f) {
             osc->phase = 0.0f;
             osc->sync_phase = 0.0f;
+            if (osc->unison_voices > 1) {
+                osc_reset_unison_phases(osc);
+            }
         }
     }
     
     // Advance phase
-    float phase_increment = base_freq / sample_rate;
     osc->phase += phase_increment;
     osc->sync_phase += phase_increment;
     
@@ -230,10 +327,25 @@ void filter_update_coefficients(Filter* filter, float sample_rate, float cutoff,
     filter->cutoff_actual = clamp(cutoff, 20.0f, sample_rate * 0.45f);
     filter->resonance_actual = clamp(resonance, 0.0f, 0.99f);
 
-    float freq = filter->cutoff_actual;
-    filter->f = 2.0f * sinf(M_PI * freq / sample_rate);
-    filter->f = clamp(filter->f, 0.01f, 0.95f);
+    filter->f = clamp(dsp_svf_f(filter->cutoff_actual / sample_rate), 0.01f, 0.95f);
     filter->q = clamp(1.0f - filter->resonance_actual, 0.1f, 1.0f);
+    filter->f_end = filter->f;
+    filter->f_step = 0.0f;
+}
+
+void filter_glide_coefficients(Filter* filter, float sample_rate, float cutoff, float resonance,
+                               int num_frames) {
+    float f_start = filter->f;
+    filter_update_coefficients(filter, sample_rate, cutoff, resonance);
+    if (num_frames > 1) {
+        filter->f_step = (filter->f_end - f_start) / (float)num_frames;
+        filter->f = f_start;
+    }
+}
+
+void filter_flush_denormals(Filter* filter) {
+    filter->low = denormal_flush(filter->low);
+    filter->band = denormal_flush(filter->band);
 }
 
 float filter_process(Filter* filter, float input) {
@@ -303,73 +415,137 @@ void envelope_release(Envelope* env) {
     env->target_level = 0.0f;
 }
 
-float envelope_process(Envelope* env, float sample_rate) {
-    if (env->state == ENV_OFF) {
+// Per-sample pole for a segment of `seconds` over which the distance to
+// its aim shrinks by e^log_ratio (0 = jump straight there)
+static float envelope_segment_coef(float seconds, float sample_rate, float log_ratio) {
+    if (seconds <= 0.0f) {
         return 0.0f;
     }
-    
-    float rate = 0.0f;
-    
-    switch (env->state) {
-        case ENV_ATTACK:
-            if (env->attack > 0.0f) {
-                rate = 1.0f / (env->attack * sample_rate);
-                env->current_level += rate;
-                if (env->current_level >= env->target_level) {
-                    env->current_level = env->target_level;
-                    env->state = ENV_DECAY;
+    return expf(-log_ratio / (seconds * sample_rate));
+}
+
+void envelope_prepare(Envelope* env, float sample_rate) {
+    bool times_changed = env->attack != env->prepared_attack || env->decay != env->prepared_decay ||
+                         env->release != env->prepared_release || sample_rate != env->prepared_rate;
+    if (times_changed) {
+        env->attack_coef = envelope_segment_coef(env->attack, sample_rate, ENV_ATTACK_LOG_RATIO);
+        env->decay_coef = envelope_segment_coef(env->decay, sample_rate, 1.0f);
+        env->release_coef = envelope_segment_coef(env->release, sample_rate, 1.0f);
+        env->prepared_attack = env->attack;
+        env->prepared_decay = env->decay;
+        env->prepared_release = env->release;
+        env->prepared_rate = sample_rate;
+    }
+
+    // The release target is zero; attack and decay aims depend on the peak
+    // (set per note by velocity) and the sustain level
+    if (times_changed || env->sustain != env->prepared_sustain ||
+        (env->state == ENV_ATTACK && env->target_level != env->prepared_peak)) {
+        float peak = env->state == ENV_ATTACK ? env->target_level : env->prepared_peak;
+        float attack_aim = peak * (1.0f + ENV_ATTACK_OVERSHOOT);
+        float decay_aim = env->sustain - ENV_DECAY_OVERSHOOT * (peak - env->sustain);
+        env->attack_base = attack_aim * (1.0f - env->attack_coef);
+        env->decay_base = decay_aim * (1.0f - env->decay_coef);
+        env->prepared_sustain = env->sustain;
+        env->prepared_peak = peak;
+    }
+}
+
+int envelope_process_block(Envelope* env, float* out, int num_frames, float sample_rate) {
+    if (num_frames <= 0) {
+        return 0;
+    }
+    if (env->state == ENV_OFF) {
+        memset(out, 0, sizeof(float) * (size_t)num_frames);
+        return 0;
+    }
+    envelope_prepare(env, sample_rate);
+
+    float level = env->current_level;
+    int n = 0;
+    while (n < num_frames && env->state != ENV_OFF) {
+        switch (env->state) {
+            case ENV_ATTACK: {
+                float peak = env->prepared_peak;
+                while (n < num_frames) {
+                    level = env->attack_base + level * env->attack_coef;
+                    if (level >= peak) {
+                        level = peak;
+                        env->state = ENV_DECAY;
+                    }
+                    out[n++] = clamp(level, 0.0f, 1.0f);
+                    if (env->state != ENV_ATTACK) {
+                        break;
+                    }
                 }
-            } else {
-                env->current_level = env->target_level;
-                env->state = ENV_DECAY;
+                break;
             }
-            break;
-            
-        case ENV_DECAY:
-            if (env->decay > 0.0f) {
-                rate = (env->target_level - env->sustain) / (env->decay * sample_rate);
-                env->current_level -= rate;
-                if (env->current_level <= env->sustain) {
-                    env->current_level = env->sustain;
-                    env->state = ENV_SUSTAIN;
+
+            case ENV_DECAY:
+                while (n < num_frames) {
+                    level = env->decay_base + level * env->decay_coef;
+                    if (level <= env->sustain) {
+                        level = env->sustain;
+                        env->state = ENV_SUSTAIN;
+                    }
+                    out[n++] = clamp(level, 0.0f, 1.0f);
+                    if (env->state != ENV_DECAY) {
+                        break;
+                    }
                 }
-            } else {
-                env->current_level = env->sustain;
-                env->state = ENV_SUSTAIN;
-            }
-            break;
-            
-        case ENV_SUSTAIN:
-            env->current_level = env->sustain;
-            
-            // Loop back to attack if looping enabled
-            if (env->loop) {
-                env->state = ENV_ATTACK;
-                if (env->retrigger) {
-                    env->current_level = 0.0f;
+                break;
+
+            case ENV_SUSTAIN:
+                level = env->sustain;
+                if (env->loop) {
+                    // Loop back to attack for the next sample
+                    out[n++] = clamp(level, 0.0f, 1.0f);
+                    env->state = ENV_ATTACK;
+                    if (env->retrigger) {
+                        level = 0.0f;
+                    }
+                    env->current_level = level;
+                    envelope_prepare(env, sample_rate);
+                } else {
+                    float held = clamp(level, 0.0f, 1.0f);
+                    while (n < num_frames) {
+                        out[n++] = held;
+                    }
                 }
-            }
-            break;
-            
-        case ENV_RELEASE:
-            if (env->release > 0.0f) {
-                rate = env->current_level / (env->release * sample_rate);
-                env->current_level -= rate;
-                if (env->current_level <= 0.0f) {
-                    env->current_level = 0.0f;
-                    env->state = ENV_OFF;
+                break;
+
+            case ENV_RELEASE:
+                while (n < num_frames) {
+                    level *= env->release_coef;
+                    // The exponential release never reaches zero on its own;
+                    // end the note once it is inaudible so the voice is freed.
+                    if (level <= ENV_SILENCE_LEVEL) {
+                        level = 0.0f;
+                        env->state = ENV_OFF;
+                        break;
+                    }
+                    out[n++] = clamp(level, 0.0f, 1.0f);
                 }
-            } else {
-                env->current_level = 0.0f;
+                break;
+
+            default:
                 env->state = ENV_OFF;
-            }
-            break;
-            
-        default:
-            break;
+                break;
+        }
     }
-    
-    return clamp(env->current_level, 0.0f, 1.0f);
+    env->current_level = level;
+
+    int rendered = n;
+    while (n < num_frames) {
+        out[n++] = 0.0f;
+    }
+    return rendered;
+}
+
+float envelope_process(Envelope* env, float sample_rate) {
+    float level = 0.0f;
+    envelope_process_block(env, &level, 1, sample_rate);
+    return level;
 }
 
 bool envelope_is_active(Envelope* env) {
@@ -389,6 +565,7 @@ void lfo_init(LFO* lfo) {
     lfo->tempo_division = 1.0f; // Quarter note
     lfo->bipolar = true;
     lfo->fade_level = 1.0f;
+    lfo->noise_state = SYNTH_DEFAULT_SEED;
 }
 
 void lfo_trigger(LFO* lfo) {
@@ -399,6 +576,14 @@ void lfo_trigger(LFO* lfo) {
 }
 
 float lfo_process(LFO* lfo, float sample_rate, float tempo) {
+    return lfo_process_block(lfo, sample_rate, tempo, 1);
+}
+
+// Evaluate the LFO at its current phase, then advance it by num_frames.
+// Used at control rate: one call per render sub-block.
+float lfo_process_block(LFO* lfo, float sample_rate, float tempo, int num_frames) {
+    if (num_frames < 1) num_frames = 1;
+
     // Calculate effective rate
     float rate = lfo->rate;
     if (lfo->tempo_sync && tempo > 0.0f) {
@@ -409,7 +594,7 @@ float lfo_process(LFO* lfo, float sample_rate, float tempo) {
     
     // Update fade-in
     if (lfo->fade_level < 1.0f && lfo->fade_time > 0.0f) {
-        lfo->fade_level += 1.0f / (lfo->fade_time * sample_rate);
+        lfo->fade_level += (float)num_frames / (lfo->fade_time * sample_rate);
         if (lfo->fade_level > 1.0f) lfo->fade_level = 1.0f;
     }
     
@@ -417,7 +602,7 @@ float lfo_process(LFO* lfo, float sample_rate, float tempo) {
     float output = 0.0f;
     switch (lfo->waveform) {
         case WAVE_SINE:
-            output = sinf(lfo->phase * TWO_PI);
+            output = dsp_sin_turns(lfo->phase);
             break;
         case WAVE_TRIANGLE:
             output = fabsf((lfo->phase * 4.0f) - 2.0f) - 1.0f;
@@ -429,7 +614,7 @@ float lfo_process(LFO* lfo, float sample_rate, float tempo) {
             output = (lfo->phase < 0.5f) ? 1.0f : -1.0f;
             break;
         case WAVE_NOISE:
-            output = (fast_rand() * 2.0f) - 1.0f;
+            output = (synth_rng_float(&lfo->noise_state) * 2.0f) - 1.0f;
             break;
         default:
             output = 0.0f;
@@ -444,8 +629,8 @@ float lfo_process(LFO* lfo, float sample_rate, float tempo) {
     output *= lfo->amount * lfo->fade_level;
     
     // Advance phase
-    lfo->phase += rate / sample_rate;
-    if (lfo->phase >= 1.0f) lfo->phase -= 1.0f;
+    lfo->phase += rate * (float)num_frames / sample_rate;
+    if (lfo->phase >= 1.0f) lfo->phase -= floorf(lfo->phase);
     
     return output;
 }
@@ -456,6 +641,9 @@ float lfo_process(LFO* lfo, float sample_rate, float tempo) {
 
 void mod_matrix_init(ModulationMatrix* matrix) {
     memset(matrix, 0, sizeof(ModulationMatrix));
+    for (int i = 0; i < MOD_SOURCE_COUNT; i++) {
+        matrix->source_rate[i] = 1;
+    }
 }
 
 void mod_matrix_add_slot(ModulationMatrix* matrix, ModSource source, 
@@ -467,56 +655,320 @@ void mod_matrix_add_slot(ModulationMatrix* matrix, ModSource source,
         slot->amount = amount;
         slot->enabled = true;
         matrix->num_slots++;
+        matrix->dirty = true;
     }
 }
 
-void mod_matrix_update_sources(ModulationMatrix* matrix, SynthEngine* synth) {
-    if (!matrix || !synth) {
+void mod_matrix_clear(ModulationMatrix* matrix) {
+    matrix->num_slots = 0;
+    matrix->dirty = true;
+}
+
+void mod_matrix_set_source_rate(ModulationMatrix* matrix, ModSource source, int blocks) {
+    if (!matrix || source <= MOD_SOURCE_NONE || source >= MOD_SOURCE_COUNT) {
         return;
     }
+    matrix->source_rate[source] = blocks > 1 ? blocks : 1;
+    matrix->source_countdown[source] = 0; // Refresh on the next block
+}
+
+bool mod_matrix_source_is_per_voice(ModSource source) {
+    switch (source) {
+        case MOD_SOURCE_ENV_AMP:
+        case MOD_SOURCE_ENV_FILTER:
+        case MOD_SOURCE_ENV_PITCH:
+        case MOD_SOURCE_VELOCITY:
+        case MOD_SOURCE_KEYTRACK:
+        case MOD_SOURCE_MODWHEEL:
+        case MOD_SOURCE_AFTERTOUCH:
+        case MOD_SOURCE_TIMBRE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool mod_slot_routable(const ModSlot* slot) {
+    return slot->enabled && slot->amount != 0.0f &&
+           slot->source > MOD_SOURCE_NONE && slot->source < MOD_SOURCE_COUNT &&
+           slot->destination > MOD_DEST_NONE && slot->destination < MOD_DEST_COUNT;
+}
+
+void mod_matrix_compile(ModulationMatrix* matrix) {
+    bool had_routes = matrix->dest_first[MOD_DEST_COUNT] > 0 || matrix->num_voice_routes > 0;
+    bool used[MOD_SOURCE_COUNT] = {false};
+    int fill[MOD_DEST_COUNT];
+
+    // Counting sort of the engine-wide routes by destination
+    memset(matrix->dest_first, 0, sizeof(matrix->dest_first));
+    matrix->num_voice_routes = 0;
+    for (int i = 0; i < matrix->num_slots; i++) {
+        const ModSlot* slot = &matrix->slots[i];
+        if (!mod_slot_routable(slot)) {
+            continue;
+        }
+        if (mod_matrix_source_is_per_voice(slot->source)) {
+            ModRoute route = {slot->source, slot->destination, slot->amount};
+            matrix->voice_routes[matrix->num_voice_routes++] = route;
+        } else {
+            matrix->dest_first[slot->destination + 1]++;
+            used[slot->source] = true;
+        }
+    }
+    for (int d = 0; d < MOD_DEST_COUNT; d++) {
+        matrix->dest_first[d + 1] += matrix->dest_first[d];
+        fill[d] = matrix->dest_first[d];
+    }
+    for (int i = 0; i < matrix->num_slots; i++) {
+        const ModSlot* slot = &matrix->slots[i];
+        if (mod_slot_routable(slot) && !mod_matrix_source_is_per_voice(slot->source)) {
+            ModRoute route = {slot->source, slot->destination, slot->amount};
+            matrix->global_routes[fill[slot->destination]++] = route;
+        }
+    }
 
+    matrix->num_used_sources = 0;
     for (int i = 0; i < MOD_SOURCE_COUNT; i++) {
-        matrix->source_values[i] = 0.0f;
+        if (used[i]) {
+            matrix->used_sources[matrix->num_used_sources++] = (ModSource)i;
+        } else {
+            matrix->source_values[i] = 0.0f;
+        }
+        matrix->source_countdown[i] = 0; // Fresh values on the next block
+        matrix->source_frames[i] = 0;
+    }
+    memset(matrix->dest_values, 0, sizeof(matrix->dest_values));
+    bool has_routes = matrix->dest_first[MOD_DEST_COUNT] > 0 || matrix->num_voice_routes > 0;
+    matrix->voices_stale = had_routes && !has_routes;
+    matrix->dirty = false;
+}
+
+void mod_matrix_update_sources(ModulationMatrix* matrix, SynthEngine* synth) {
+    mod_matrix_update_sources_block(matrix, synth, 1);
+}
+
+static float mod_matrix_eval_source(ModSource source, SynthEngine* synth, int frames) {
+    switch (source) {
+        case MOD_SOURCE_LFO1:
+        case MOD_SOURCE_LFO2:
+        case MOD_SOURCE_LFO3:
+        case MOD_SOURCE_LFO4:
+            return lfo_process_block(&synth->lfos[source - MOD_SOURCE_LFO1],
+                                     synth->sample_rate, synth->tempo, frames);
+        case MOD_SOURCE_RANDOM:
+            return (synth_rng_float(&synth->rng_state) * 2.0f) - 1.0f;
+        default:
+            return 0.0f;
     }
+}
 
-    for (int i = 0; i < MAX_LFO && (MOD_SOURCE_LFO1 + i) < MOD_SOURCE_COUNT; i++) {
-        matrix->source_values[MOD_SOURCE_LFO1 + i] =
-            lfo_process(&synth->lfos[i], synth->sample_rate, synth->tempo);
+// Refresh the referenced engine-wide sources (each at its own control rate;
+// an LFO advances by every frame since its last update), then each active
+// voice's per-voice routes.
+void mod_matrix_update_sources_block(ModulationMatrix* matrix, SynthEngine* synth, int num_frames) {
+    if (!matrix || !synth) {
+        return;
+    }
+    if (matrix->dirty) {
+        mod_matrix_compile(matrix);
+    }
+    if (matrix->voices_stale) {
+        for (int i = 0; i < synth->polyphony; i++) {
+            memset(synth->voices[i].mod, 0, sizeof(synth->voices[i].mod));
+            synth->voices[i].env_filter_routed = false;
+            synth->voices[i].env_pitch_routed = false;
+        }
+        matrix->voices_stale = false;
+    }
+    if (matrix->dest_first[MOD_DEST_COUNT] == 0 && matrix->num_voice_routes == 0) {
+        return; // Nothing routed: no source is evaluated
     }
 
-    float velocity_sum = 0.0f;
-    float keytrack_sum = 0.0f;
-    int active = 0;
-    for (int i = 0; i < MAX_VOICES; i++) {
-        Voice* voice = &synth->voices[i];
-        if (voice_is_active(voice)) {
-            velocity_sum += voice->velocity;
-            float normalized_note = (float)(voice->midi_note - 60) / 36.0f;
-            keytrack_sum += normalized_note;
-            active++;
+    bool changed = false;
+    for (int i = 0; i < matrix->num_used_sources; i++) {
+        ModSource source = matrix->used_sources[i];
+        matrix->source_frames[source] += num_frames;
+        if (--matrix->source_countdown[source] > 0) {
+            continue;
+        }
+        matrix->source_countdown[source] = matrix->source_rate[source];
+        matrix->source_values[source] =
+            mod_matrix_eval_source(source, synth, matrix->source_frames[source]);
+        matrix->source_frames[source] = 0;
+        changed = true;
+    }
+    if (changed) {
+        for (int d = 0; d < MOD_DEST_COUNT; d++) {
+            float total = 0.0f;
+            for (int r = matrix->dest_first[d]; r < matrix->dest_first[d + 1]; r++) {
+                const ModRoute* route = &matrix->global_routes[r];
+                total += matrix->source_values[route->source] * route->amount;
+            }
+            matrix->dest_values[d] = total;
         }
     }
 
-    if (active > 0) {
-        matrix->source_values[MOD_SOURCE_VELOCITY] = clamp(velocity_sum / active, 0.0f, 1.0f);
-        matrix->source_values[MOD_SOURCE_KEYTRACK] = clamp(keytrack_sum / active, -1.0f, 1.0f);
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        mod_matrix_apply_voice(matrix, &synth->voices[synth->active_voices[k]]);
     }
+}
 
-    matrix->source_values[MOD_SOURCE_RANDOM] = (fast_rand() * 2.0f) - 1.0f;
+float mod_matrix_get_value(const ModulationMatrix* matrix, ModDestination dest) {
+    if (!matrix || dest <= MOD_DEST_NONE || dest >= MOD_DEST_COUNT) {
+        return 0.0f;
+    }
+    return clamp(matrix->dest_values[dest], -1.0f, 1.0f);
 }
 
-float mod_matrix_get_value(ModulationMatrix* matrix, ModDestination dest) {
-    float total = 0.0f;
-    
-    for (int i = 0; i < matrix->num_slots; i++) {
-        ModSlot* slot = &matrix->slots[i];
-        if (slot->enabled && slot->destination == dest) {
-            float source_val = matrix->source_values[slot->source];
-            total += source_val * slot->amount;
+static float mod_matrix_voice_source(const Voice* voice, ModSource source) {
+    switch (source) {
+        case MOD_SOURCE_ENV_AMP:    return voice->env_amp.current_level;
+        case MOD_SOURCE_ENV_FILTER: return voice->env_filter.current_level;
+        case MOD_SOURCE_ENV_PITCH:  return voice->env_pitch.current_level;
+        case MOD_SOURCE_VELOCITY:   return voice->velocity;
+        case MOD_SOURCE_KEYTRACK:   return clamp((float)(voice->midi_note - 60) / 36.0f, -1.0f, 1.0f);
+        case MOD_SOURCE_MODWHEEL:   return voice->expression.mod_wheel;
+        case MOD_SOURCE_AFTERTOUCH: return voice->expression.pressure;
+        case MOD_SOURCE_TIMBRE:     return voice->expression.timbre;
+        default:                    return 0.0f;
+    }
+}
+
+// Engine-wide destinations plus this voice's own sources
+void mod_matrix_apply_voice(const ModulationMatrix* matrix, Voice* voice) {
+    float totals[MOD_DEST_COUNT];
+    memcpy(totals, matrix->dest_values, sizeof(totals));
+    voice->env_filter_routed = false;
+    voice->env_pitch_routed = false;
+    for (int r = 0; r < matrix->num_voice_routes; r++) {
+        const ModRoute* route = &matrix->voice_routes[r];
+        totals[route->destination] += mod_matrix_voice_source(voice, route->source) * route->amount;
+        voice->env_filter_routed |= route->source == MOD_SOURCE_ENV_FILTER;
+        voice->env_pitch_routed |= route->source == MOD_SOURCE_ENV_PITCH;
+    }
+    for (int d = 0; d < MOD_DEST_COUNT; d++) {
+        voice->mod[d] = clamp(totals[d], -1.0f, 1.0f);
+    }
+}
+
+// ============================================================================
+// EXPRESSION
+// ============================================================================
+
+#define EXPRESSION_NO_RPN 127
+#define EXPRESSION_NO_MASTER (-1)
+
+static void expression_init(SynthExpression* expression) {
+    memset(expression, 0, sizeof(*expression));
+    for (int c = 0; c < SYNTH_MIDI_CHANNELS; c++) {
+        expression->bend_range[c] = -1.0f;
+        expression->timbre[c] = SYNTH_TIMBRE_DEFAULT;
+        expression->rpn[c][0] = EXPRESSION_NO_RPN;
+        expression->rpn[c][1] = EXPRESSION_NO_RPN;
+    }
+}
+
+static bool expression_channel_valid(int channel) {
+    return channel >= 0 && channel < SYNTH_MIDI_CHANNELS;
+}
+
+// Master channel of the MPE zone `channel` is a member of
+static int expression_master(const SynthExpression* expression, int channel) {
+    if (channel >= 1 && channel <= expression->lower_members) {
+        return 0;
+    }
+    if (channel <= 14 && channel >= 15 - expression->upper_members) {
+        return 15;
+    }
+    return EXPRESSION_NO_MASTER;
+}
+
+// Room for the other zone's members: 16 channels hold both zones' masters
+static int expression_zone_room(int members) {
+    return members > 0 ? 14 - members : 15;
+}
+
+// The upper zone gives way when both do not fit. Members default to a
+// +/-48 bend, everyone else to the engine range.
+static void expression_set_zones(SynthExpression* expression, int lower, int upper) {
+    expression->lower_members = lower < 0 ? 0 : (lower > 15 ? 15 : lower);
+    int room = expression_zone_room(expression->lower_members);
+    expression->upper_members = upper < 0 ? 0 : (upper > room ? (room > 0 ? room : 0) : upper);
+    for (int c = 0; c < SYNTH_MIDI_CHANNELS; c++) {
+        expression->bend_range[c] = expression_master(expression, c) == EXPRESSION_NO_MASTER
+                                        ? -1.0f : (float)SYNTH_MPE_MEMBER_BEND_RANGE;
+    }
+    expression->serial++;
+}
+
+// Bend range; on an MPE member it sets the whole zone's members
+static void expression_set_bend_range(SynthExpression* expression, int channel, float range) {
+    int master = expression_master(expression, channel);
+    for (int c = 0; c < SYNTH_MIDI_CHANNELS; c++) {
+        if (c == channel || (master != EXPRESSION_NO_MASTER && expression_master(expression, c) == master)) {
+            expression->bend_range[c] = range;
         }
     }
-    
-    return clamp(total, -1.0f, 1.0f);
+    expression->serial++;
+}
+
+// Data entry for the selected RPN: MSB (CC 6) or LSB (CC 38)
+static void expression_rpn(SynthExpression* expression, int channel, int controller, int value,
+                           int default_range) {
+    const uint8_t* rpn = expression->rpn[channel];
+    if (rpn[0] == 0 && rpn[1] == 0) {
+        // MSB sets semitones, LSB cents; each keeps the other's part
+        float current = expression->bend_range[channel] >= 0.0f ? expression->bend_range[channel]
+                                                                 : (float)default_range;
+        float semitones = floorf(current);
+        float cents = current - semitones;
+        if (controller == 6) {
+            semitones = (float)(value < SYNTH_MPE_MAX_BEND_RANGE ? value : SYNTH_MPE_MAX_BEND_RANGE);
+        } else {
+            cents = (float)(value < 99 ? value : 99) / 100.0f;
+        }
+        expression_set_bend_range(expression, channel,
+                                  fminf(semitones + cents, (float)SYNTH_MPE_MAX_BEND_RANGE));
+    } else if (rpn[0] == 0 && rpn[1] == 6 && controller == 6) {
+        // MPE configuration, sent on a zone's master channel. The zone
+        // configured last keeps its size; the other one shrinks.
+        if (channel == 0) {
+            expression_set_zones(expression, value, expression->upper_members);
+        } else if (channel == 15) {
+            int room = expression_zone_room(value > 15 ? 15 : value);
+            int lower = expression->lower_members;
+            expression_set_zones(expression, lower > room ? room : lower, value);
+        }
+    }
+}
+
+static VoiceExpression expression_for_note(const SynthExpression* expression, int channel, int note,
+                                           int default_range) {
+    VoiceExpression heard = {0.0f, 0.0f, SYNTH_TIMBRE_DEFAULT, 0.0f};
+    if (!expression_channel_valid(channel)) {
+        return heard;
+    }
+    float range = expression->bend_range[channel] >= 0.0f ? expression->bend_range[channel] : (float)default_range;
+    heard.bend = expression->bend[channel] * range;
+    heard.pressure = expression->pressure[channel];
+    if (note >= 0 && note < 128) {
+        heard.pressure = fmaxf(heard.pressure, expression->poly_pressure[channel][note]);
+    }
+    heard.timbre = expression->timbre[channel];
+    heard.mod_wheel = expression->mod_wheel[channel];
+
+    // An MPE zone's master channel speaks for all its notes
+    int master = expression_master(expression, channel);
+    if (master != EXPRESSION_NO_MASTER) {
+        float master_range = expression->bend_range[master] >= 0.0f ? expression->bend_range[master]
+                                                                   : (float)default_range;
+        heard.bend += expression->bend[master] * master_range;
+        heard.pressure = fmaxf(heard.pressure, expression->pressure[master]);
+        // Timbre rests mid-way, so the master's offsets it both ways
+        heard.timbre = clamp(heard.timbre + expression->timbre[master] - SYNTH_TIMBRE_DEFAULT, 0.0f, 1.0f);
+        heard.mod_wheel = fmaxf(heard.mod_wheel, expression->mod_wheel[master]);
+    }
+    return heard;
 }
 
 // ============================================================================
@@ -535,7 +987,8 @@ void voice_init(Voice* voice, float sample_rate) {
     envelope_init(&voice->env_pitch);
     
     voice->pan = 0.0f; // Center
-    voice->random_value = fast_rand();
+    voice->pitch_env_amount = 0.1f; // Up to +10% from the pitch envelope
+    voice->random_value = 0.5f; // Drawn from the engine's RNG by synth_set_seed
 }
 
 void voice_note_on(Voice* voice, int midi_note, float velocity, uint64_t time) {
@@ -545,6 +998,7 @@ void voice_note_on(Voice* voice, int midi_note, float velocity, uint64_t time) {
     voice->velocity = velocity;
     voice->note_on_time = time;
     voice->target_pitch = voice->frequency;
+    voice->patch_held = false;  // A new note plays the current patch
     
     // Trigger envelopes
     envelope_trigger(&voice->env_amp, velocity);
@@ -554,9 +1008,11 @@ void voice_note_on(Voice* voice, int midi_note, float velocity, uint64_t time) {
     // Reset oscillator phases if phase_reset is enabled
     if (voice->osc1.phase_reset) {
         voice->osc1.phase = 0.0f;
+        osc_reset_unison_phases(&voice->osc1);
     }
     if (voice->osc2.phase_reset) {
         voice->osc2.phase = 0.0f;
+        osc_reset_unison_phases(&voice->osc2);
     }
     
     // Set initial pitch for glide
@@ -600,12 +1056,12 @@ void voice_process(Voice* voice, float* left, float* right, float sample_rate) {
         float glide_speed = 12.0f / (voice->glide_rate * sample_rate); // Semitones per sample
         
         if (voice->current_pitch < voice->target_pitch) {
-            voice->current_pitch *= powf(2.0f, glide_speed / 12.0f);
+            voice->current_pitch *= dsp_exp2f(glide_speed / 12.0f);
             if (voice->current_pitch >= voice->target_pitch) {
                 voice->current_pitch = voice->target_pitch;
             }
         } else {
-            voice->current_pitch *= powf(2.0f, -glide_speed / 12.0f);
+            voice->current_pitch *= dsp_exp2f(-glide_speed / 12.0f);
             if (voice->current_pitch <= voice->target_pitch) {
                 voice->current_pitch = voice->target_pitch;
             }
@@ -615,7 +1071,7 @@ void voice_process(Voice* voice, float* left, float* right, float sample_rate) {
     }
     
     // Set oscillator frequencies with pitch envelope
-    float pitch_mod = 1.0f + (env_pitch * 0.1f); // ±10% max from envelope
+    float pitch_mod = 1.0f + (env_pitch * voice->pitch_env_amount);
     voice->osc1.frequency = voice->current_pitch * pitch_mod;
     voice->osc2.frequency = voice->current_pitch * pitch_mod;
     
@@ -642,59 +1098,438 @@ void voice_process(Voice* voice, float* left, float* right, float sample_rate) {
     float output = filtered * env_amp * voice->velocity;
     
     // Apply panning (constant power)
-    float pan_angle = (voice->pan + 1.0f) * 0.25f * M_PI; // -1..1 -> 0..PI/2
-    *left = output * cosf(pan_angle);
-    *right = output * sinf(pan_angle);
+    float gain_l, gain_r;
+    dsp_pan(voice->pan, &gain_l, &gain_r);
+    *left = output * gain_l;
+    *right = output * gain_r;
+}
+
+// Per-sample control pass shared by the scalar and SIMD voice paths.
+// Retargets the filter once for the block (f then glides there by f_step
+// per frame, so cutoff moves never step), then runs envelopes and
+// glide, writing the VCA gain (env * velocity) and oscillator frequency for
+// each frame at amp[n * stride] / freq[n * stride]. Returns the number of
+// frames rendered; the voice is switched off if its amp envelope finishes.
+int voice_render_controls(Voice* voice, float* amp, float* freq, int stride,
+                          int num_frames, float sample_rate) {
+    if (voice->state == VOICE_OFF || num_frames <= 0) {
+        return 0;
+    }
+    if (num_frames > SYNTH_BLOCK_SIZE) {
+        num_frames = SYNTH_BLOCK_SIZE;
+    }
+
+    // Filter cutoff follows the filter envelope and mod matrix at block rate
+    const float* mod = voice->mod;
+    float env_filter_start = clamp(voice->env_filter.current_level, 0.0f, 1.0f);
+    float filter_cutoff = voice->filter.cutoff;
+    filter_cutoff *= 1.0f + (env_filter_start * voice->filter.env_amount * 10.0f);
+    if (mod[MOD_DEST_FILTER_CUTOFF] != 0.0f) {
+        filter_cutoff *= dsp_exp2f(mod[MOD_DEST_FILTER_CUTOFF] * MOD_CUTOFF_RANGE_OCTAVES);
+    }
+    filter_cutoff = clamp(filter_cutoff, 20.0f, sample_rate * 0.45f);
+    float filter_resonance = clamp(voice->filter.resonance + mod[MOD_DEST_FILTER_RESONANCE], 0.0f, 0.99f);
+
+    // Block-rate gain and osc1 pitch from the matrix and the note's bend
+    // (osc2 is offset by the renderer)
+    float mod_gain = clamp(1.0f + mod[MOD_DEST_AMP], 0.0f, 2.0f);
+    float mod_pitch = 1.0f;
+    if (mod[MOD_DEST_OSC1_PITCH] != 0.0f || voice->expression.bend != 0.0f) {
+        mod_pitch = dsp_exp2f(mod[MOD_DEST_OSC1_PITCH] * (MOD_PITCH_RANGE_SEMITONES / 12.0f) +
+                              voice->expression.bend * (1.0f / 12.0f));
+    }
+
+    voice->filter.f_step = 0.0f;
+    if (fabsf(filter_cutoff - voice->filter.cutoff_actual) > 1.0f ||
+        fabsf(filter_resonance - voice->filter.resonance_actual) > 0.001f) {
+        filter_glide_coefficients(&voice->filter, sample_rate, filter_cutoff, filter_resonance,
+                                  num_frames);
+    }
+
+    // Per-sample glide factor (one octave per glide_rate seconds)
+    float glide_up = 1.0f;
+    float glide_down = 1.0f;
+    if (voice->glide_rate > 0.0f) {
+        glide_up = dsp_exp2f(1.0f / (voice->glide_rate * sample_rate));
+        glide_down = 1.0f / glide_up;
+    }
+
+    // Envelopes a block at a time. Filter and pitch envelopes nothing
+    // listens to are skipped; they pick up where they stopped if an amount
+    // or route brings them back mid-note.
+    float env_amp[SYNTH_BLOCK_SIZE];
+    float env_filter[SYNTH_BLOCK_SIZE];
+    float env_pitch[SYNTH_BLOCK_SIZE];
+    int rendered = envelope_process_block(&voice->env_amp, env_amp, num_frames, sample_rate);
+    if (rendered < num_frames) {
+        voice->state = VOICE_OFF;
+    }
+    if (rendered > 0 && (voice->filter.env_amount != 0.0f || voice->env_filter_routed)) {
+        envelope_process_block(&voice->env_filter, env_filter, rendered, sample_rate);
+    }
+    bool pitch_env = voice->pitch_env_amount != 0.0f;
+    if (rendered > 0 && (pitch_env || voice->env_pitch_routed)) {
+        envelope_process_block(&voice->env_pitch, env_pitch, rendered, sample_rate);
+    }
+
+    for (int n = 0; n < rendered; n++) {
+        if (voice->glide_rate > 0.0f && voice->current_pitch != voice->target_pitch) {
+            if (voice->current_pitch < voice->target_pitch) {
+                voice->current_pitch *= glide_up;
+                if (voice->current_pitch >= voice->target_pitch) {
+                    voice->current_pitch = voice->target_pitch;
+                }
+            } else {
+                voice->current_pitch *= glide_down;
+                if (voice->current_pitch <= voice->target_pitch) {
+                    voice->current_pitch = voice->target_pitch;
+                }
+            }
+        } else {
+            voice->current_pitch = voice->target_pitch;
+        }
+
+        float pitch_mod = pitch_env ? 1.0f + (env_pitch[n] * voice->pitch_env_amount) : 1.0f;
+        amp[n * stride] = env_amp[n] * voice->velocity * mod_gain;
+        freq[n * stride] = voice->current_pitch * pitch_mod * mod_pitch;
+    }
+
+    return rendered;
+}
+
+// Render num_frames (<= SYNTH_BLOCK_SIZE) of this voice into the mono scratch
+// buffer, then pan and accumulate into left/right.
+void voice_render_block(Voice* voice, float* scratch, float* left, float* right,
+                        int num_frames, float sample_rate) {
+    float amp[SYNTH_BLOCK_SIZE];
+    float freq[SYNTH_BLOCK_SIZE];
+    if (num_frames > SYNTH_BLOCK_SIZE) {
+        num_frames = SYNTH_BLOCK_SIZE;
+    }
+
+    int rendered = voice_render_controls(voice, amp, freq, 1, num_frames, sample_rate);
+
+    // Matrix pitch/PWM offsets hold for the block; base widths are restored
+    float osc2_ratio = voice_mod_osc2_ratio(voice);
+    float pw1 = voice->osc1.pulse_width;
+    float pw2 = voice->osc2.pulse_width;
+    voice->osc1.pulse_width = voice_mod_pulse_width(pw1, voice->mod[MOD_DEST_OSC1_PWM]);
+    voice->osc2.pulse_width = voice_mod_pulse_width(pw2, voice->mod[MOD_DEST_OSC2_PWM]);
+    for (int n = 0; n < rendered; n++) {
+        voice->osc1.frequency = freq[n];
+        voice->osc2.frequency = freq[n] * osc2_ratio;
+
+        float osc1_out = osc_process(&voice->osc1, sample_rate, 0.0f);
+        float osc2_out = osc_process(&voice->osc2, sample_rate, osc1_out);
+        float mixed = (osc1_out + osc2_out) * 0.5f;
+
+        float filtered = filter_process(&voice->filter, mixed);
+        voice->filter.f += voice->filter.f_step;
+        scratch[n] = filtered * amp[n];
+    }
+    voice->filter.f = voice->filter.f_end;
+    filter_flush_denormals(&voice->filter);
+    voice->osc1.pulse_width = pw1;
+    voice->osc2.pulse_width = pw2;
+
+    voice_accumulate_panned(voice, scratch, left, right, rendered);
+}
+
+// Constant-power pan gains are computed once per block
+void voice_accumulate_panned(const Voice* voice, const float* scratch,
+                             float* left, float* right, int num_frames) {
+    float gain_l, gain_r;
+    float pan = voice->pan;
+    if (voice->mod[MOD_DEST_PAN] != 0.0f) {
+        pan = clamp(pan + voice->mod[MOD_DEST_PAN], -1.0f, 1.0f);
+    }
+    dsp_pan(pan, &gain_l, &gain_r);
+    for (int n = 0; n < num_frames; n++) {
+        left[n] += scratch[n] * gain_l;
+        right[n] += scratch[n] * gain_r;
+    }
+}
+
+float voice_mod_osc2_ratio(const Voice* voice) {
+    float offset = voice->mod[MOD_DEST_OSC2_PITCH] - voice->mod[MOD_DEST_OSC1_PITCH];
+    return offset != 0.0f ? dsp_exp2f(offset * (MOD_PITCH_RANGE_SEMITONES / 12.0f)) : 1.0f;
+}
+
+float voice_mod_pulse_width(float base, float mod) {
+    if (mod == 0.0f) {
+        return base;
+    }
+    return clamp(base + mod * MOD_PWM_RANGE, 0.05f, 0.95f);
 }
 
 bool voice_is_active(Voice* voice) {
     return voice->state != VOICE_OFF;
 }
 
+// ============================================================================
+// PARAMETER TABLE
+// ============================================================================
+
+static void param_hook_master_volume(SynthEngine* synth, float value) {
+    synth->master_volume = value;
+}
+
+static void param_hook_tempo(SynthEngine* synth, float value) {
+    synth_set_tempo(synth, value);
+}
+
+static void param_hook_panic(SynthEngine* synth, float value) {
+    (void)value;
+    synth_all_notes_off(synth);
+}
+
+#define HOST_FLOAT(key, lo, hi, def) \
+    {key, PARAM_FLOAT, lo, hi, def, SYNTH_PARAM_HOST, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define HOST_INT(key, lo, hi, def) \
+    {key, PARAM_INT, lo, hi, def, SYNTH_PARAM_HOST, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define HOST_BOOL(key, def) \
+    {key, PARAM_BOOL, 0.0f, 1.0f, def, SYNTH_PARAM_HOST, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define VOICE_FLOAT(key, lo, hi, def) \
+    {key, PARAM_FLOAT, lo, hi, def, SYNTH_PARAM_VOICE, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define VOICE_INT(key, lo, hi, def) \
+    {key, PARAM_INT, lo, hi, def, SYNTH_PARAM_VOICE, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define VOICE_BOOL(key, def) \
+    {key, PARAM_BOOL, 0.0f, 1.0f, def, SYNTH_PARAM_VOICE, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define ENGINE_FLOAT(key, lo, hi, def) \
+    {key, PARAM_FLOAT, lo, hi, def, SYNTH_PARAM_ENGINE, SMOOTH_NONE, 0.0f, 0u, NULL}
+#define ENGINE_BOOL(key, def) \
+    {key, PARAM_BOOL, 0.0f, 1.0f, def, SYNTH_PARAM_ENGINE, SMOOTH_NONE, 0.0f, 0u, NULL}
+
+static const SynthParamDesc g_synth_params[PARAM_PARAM_COUNT] = {
+    [PARAM_MASTER_VOLUME] = {"master_volume", PARAM_FLOAT, 0.0f, 1.0f, 0.7f, SYNTH_PARAM_ENGINE,
+                             SMOOTH_LINEAR, 0.02f, 0u, param_hook_master_volume},
+    [PARAM_TEMPO] = {"tempo", PARAM_FLOAT, 20.0f, 300.0f, 120.0f, SYNTH_PARAM_ENGINE,
+                     SMOOTH_NONE, 0.0f, 0u, param_hook_tempo},
+
+    [PARAM_OSC1_WAVE] = VOICE_INT("osc1_wave", 0.0f, WAVE_COUNT - 1, WAVE_SAW),
+    [PARAM_OSC1_COARSE] = HOST_FLOAT("osc1_coarse", -24.0f, 24.0f, 0.0f),
+    [PARAM_OSC1_FINE] = VOICE_FLOAT("osc1_fine", -100.0f, 100.0f, 0.0f),
+    [PARAM_OSC1_PWM] = VOICE_FLOAT("osc1_pwm", 0.05f, 0.95f, 0.5f),
+    [PARAM_OSC1_SUB_MIX] = HOST_FLOAT("osc1_sub_mix", 0.0f, 1.0f, 0.0f),
+    [PARAM_OSC1_SYNC] = VOICE_BOOL("osc1_sync", 0.0f),
+    [PARAM_OSC2_WAVE] = VOICE_INT("osc2_wave", 0.0f, WAVE_COUNT - 1, WAVE_SAW),
+    [PARAM_OSC2_COARSE] = HOST_FLOAT("osc2_coarse", -24.0f, 24.0f, 0.0f),
+    [PARAM_OSC2_FINE] = VOICE_FLOAT("osc2_fine", -100.0f, 100.0f, 0.0f),
+    [PARAM_OSC2_PWM] = VOICE_FLOAT("osc2_pwm", 0.05f, 0.95f, 0.5f),
+    [PARAM_OSC2_SUB_MIX] = HOST_FLOAT("osc2_sub_mix", 0.0f, 1.0f, 0.0f),
+    [PARAM_OSC2_SYNC] = VOICE_BOOL("osc2_sync", 0.0f),
+    [PARAM_OSC_MIX] = HOST_FLOAT("osc_mix", 0.0f, 1.0f, 0.5f),
+    [PARAM_PORTAMENTO_TIME] = HOST_FLOAT("portamento_time", 0.0f, 2.0f, 0.0f),
+    [PARAM_LEGATO_MODE] = HOST_BOOL("legato_mode", 0.0f),
+
+    [PARAM_FILTER_MODE] = {"filter_mode", PARAM_INT, FILTER_LP, FILTER_COUNT - 1, FILTER_LP,
+                           SYNTH_PARAM_VOICE, SMOOTH_NONE, 0.0f, 0u, NULL},
+    [PARAM_FILTER_CUTOFF] = {"filter_cutoff", PARAM_FLOAT, 20.0f, 20000.0f, 8000.0f, SYNTH_PARAM_VOICE,
+                             SMOOTH_ONE_POLE, 0.015f, SYNTH_PARAM_NYQUIST_LIMITED, NULL},
+    [PARAM_FILTER_RESONANCE] = {"filter_resonance", PARAM_FLOAT, 0.0f, 1.0f, 0.3f, SYNTH_PARAM_VOICE,
+                                SMOOTH_LINEAR, 0.02f, 0u, NULL},
+    [PARAM_FILTER_DRIVE] = HOST_FLOAT("filter_drive", 0.0f, 1.0f, 0.0f),
+    [PARAM_FILTER_KEYTRACK] = HOST_FLOAT("filter_keytrack", 0.0f, 1.0f, 0.0f),
+    [PARAM_FILTER_ENV_AMOUNT] = {"filter_env_amount", PARAM_FLOAT, -1.0f, 1.0f, 0.0f, SYNTH_PARAM_VOICE,
+                                 SMOOTH_LINEAR, 0.02f, 0u, NULL},
+
+    [PARAM_ENV_AMP_ATTACK] = VOICE_FLOAT("env_amp_attack", 0.001f, 2.0f, 0.01f),
+    [PARAM_ENV_AMP_DECAY] = VOICE_FLOAT("env_amp_decay", 0.001f, 2.0f, 0.1f),
+    [PARAM_ENV_AMP_SUSTAIN] = VOICE_FLOAT("env_amp_sustain", 0.0f, 1.0f, 0.7f),
+    [PARAM_ENV_AMP_RELEASE] = VOICE_FLOAT("env_amp_release", 0.001f, 5.0f, 0.3f),
+    [PARAM_ENV_FILTER_ATTACK] = VOICE_FLOAT("env_filter_attack", 0.001f, 2.0f, 0.01f),
+    [PARAM_ENV_FILTER_DECAY] = VOICE_FLOAT("env_filter_decay", 0.001f, 2.0f, 0.1f),
+    [PARAM_ENV_FILTER_SUSTAIN] = VOICE_FLOAT("env_filter_sustain", 0.0f, 1.0f, 0.7f),
+    [PARAM_ENV_FILTER_RELEASE] = VOICE_FLOAT("env_filter_release", 0.001f, 5.0f, 0.3f),
+    [PARAM_ENV_PITCH_ATTACK] = VOICE_FLOAT("env_pitch_attack", 0.001f, 2.0f, 0.01f),
+    [PARAM_ENV_PITCH_DECAY] = VOICE_FLOAT("env_pitch_decay", 0.001f, 2.0f, 0.1f),
+    [PARAM_ENV_PITCH_SUSTAIN] = VOICE_FLOAT("env_pitch_sustain", 0.0f, 1.0f, 0.7f),
+    [PARAM_ENV_PITCH_RELEASE] = VOICE_FLOAT("env_pitch_release", 0.001f, 5.0f, 0.3f),
+
+    [PARAM_LFO1_RATE] = ENGINE_FLOAT("lfo1_rate", 0.01f, 20.0f, 2.0f),
+    [PARAM_LFO1_DEPTH] = ENGINE_FLOAT("lfo1_depth", 0.0f, 1.0f, 0.5f),
+    [PARAM_LFO1_DEST] = HOST_INT("lfo1_dest", 0.0f, MOD_DEST_COUNT - 1, MOD_DEST_NONE),
+    [PARAM_LFO1_SYNC] = ENGINE_BOOL("lfo1_sync", 0.0f),
+    [PARAM_LFO1_FADE] = ENGINE_FLOAT("lfo1_fade", 0.0f, 5.0f, 0.0f),
+    [PARAM_LFO2_RATE] = ENGINE_FLOAT("lfo2_rate", 0.01f, 20.0f, 2.0f),
+    [PARAM_LFO2_DEPTH] = ENGINE_FLOAT("lfo2_depth", 0.0f, 1.0f, 0.5f),
+    [PARAM_LFO2_DEST] = HOST_INT("lfo2_dest", 0.0f, MOD_DEST_COUNT - 1, MOD_DEST_NONE),
+    [PARAM_LFO2_SYNC] = ENGINE_BOOL("lfo2_sync", 0.0f),
+    [PARAM_LFO2_FADE] = ENGINE_FLOAT("lfo2_fade", 0.0f, 5.0f, 0.0f),
+
+    [PARAM_FX_DISTORTION_ENABLED] = HOST_BOOL("fx_distortion_enabled", 0.0f),
+    [PARAM_FX_DISTORTION_DRIVE] = HOST_FLOAT("fx_distortion_drive", 0.0f, 10.0f, 2.0f),
+    [PARAM_FX_DISTORTION_MIX] = HOST_FLOAT("fx_distortion_mix", 0.0f, 1.0f, 0.5f),
+    [PARAM_FX_CHORUS_ENABLED] = HOST_BOOL("fx_chorus_enabled", 0.0f),
+    [PARAM_FX_CHORUS_RATE] = HOST_FLOAT("fx_chorus_rate", 0.05f, 5.0f, 0.5f),
+    [PARAM_FX_CHORUS_DEPTH] = HOST_FLOAT("fx_chorus_depth", 0.0f, 20.0f, 5.0f),
+    [PARAM_FX_CHORUS_MIX] = HOST_FLOAT("fx_chorus_mix", 0.0f, 1.0f, 0.5f),
+    [PARAM_FX_COMP_ENABLED] = HOST_BOOL("fx_comp_enabled", 0.0f),
+    [PARAM_FX_COMP_THRESHOLD] = HOST_FLOAT("fx_comp_threshold", 0.0f, 1.0f, 0.5f),
+    [PARAM_FX_COMP_RATIO] = HOST_FLOAT("fx_comp_ratio", 1.0f, 20.0f, 4.0f),
+    [PARAM_FX_DELAY_ENABLED] = HOST_BOOL("fx_delay_enabled", 0.0f),
+    [PARAM_FX_DELAY_TIME] = HOST_FLOAT("fx_delay_time", 100.0f, 2000.0f, 500.0f),
+    [PARAM_FX_DELAY_FEEDBACK] = HOST_FLOAT("fx_delay_feedback", 0.0f, 0.95f, 0.4f),
+    [PARAM_FX_DELAY_MIX] = HOST_FLOAT("fx_delay_mix", 0.0f, 1.0f, 0.3f),
+    [PARAM_FX_REVERB_ENABLED] = HOST_BOOL("fx_reverb_enabled", 0.0f),
+    [PARAM_FX_REVERB_SIZE] = HOST_FLOAT("fx_reverb_size", 0.0f, 1.0f, 0.5f),
+    [PARAM_FX_REVERB_DAMPING] = HOST_FLOAT("fx_reverb_damping", 0.0f, 1.0f, 0.5f),
+    [PARAM_FX_REVERB_MIX] = HOST_FLOAT("fx_reverb_mix", 0.0f, 1.0f, 0.3f),
+
+    [PARAM_ARP_MODE] = HOST_INT("arp_mode", 1.0f, 4.0f, 1.0f),
+    [PARAM_ARP_RATE] = HOST_FLOAT("arp_rate", 0.25f, 16.0f, 4.0f),
+    [PARAM_ARP_GATE] = HOST_FLOAT("arp_gate", 0.05f, 1.0f, 0.5f),
+    [PARAM_ARP_ENABLED] = HOST_BOOL("arp_enabled", 0.0f),
+    [PARAM_PITCH_BEND_RANGE] = HOST_INT("pitch_bend_range", 0.0f, 24.0f, 2.0f),
+    [PARAM_MOD_WHEEL_DEPTH] = HOST_FLOAT("mod_wheel_depth", 0.0f, 1.0f, 0.0f),
+
+    [PARAM_PANIC] = {"panic", PARAM_BOOL, 0.0f, 1.0f, 0.0f, SYNTH_PARAM_ENGINE,
+                     SMOOTH_NONE, 0.0f, 0u, param_hook_panic},
+
+    [PARAM_OSC1_UNISON] = VOICE_INT("osc1_unison", 1.0f, MAX_UNISON, 1.0f),
+    [PARAM_OSC2_UNISON] = VOICE_INT("osc2_unison", 1.0f, MAX_UNISON, 1.0f),
+};
+
+#undef HOST_FLOAT
+#undef HOST_INT
+#undef HOST_BOOL
+#undef VOICE_FLOAT
+#undef VOICE_INT
+#undef VOICE_BOOL
+#undef ENGINE_FLOAT
+#undef ENGINE_BOOL
+
+const SynthParamDesc* synth_param_desc(ParamId id) {
+    if ((int)id < 0 || id >= PARAM_PARAM_COUNT) {
+        return NULL;
+    }
+    return &g_synth_params[id];
+}
+
+float synth_param_clamp(ParamId id, float value) {
+    const SynthParamDesc* desc = synth_param_desc(id);
+    if (!desc) {
+        return value;
+    }
+    if (desc->type != PARAM_FLOAT) {
+        value = roundf(value);
+    }
+    return clamp(value, desc->min_value, desc->max_value);
+}
+
+ParamId synth_param_find(const char* name) {
+    if (!name) {
+        return PARAM_PARAM_COUNT;
+    }
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        if (g_synth_params[i].name && strcmp(g_synth_params[i].name, name) == 0) {
+            return (ParamId)i;
+        }
+    }
+    return PARAM_PARAM_COUNT;
+}
+
+// Attack, decay, sustain and release are consecutive ids
+static void voice_read_envelope(Envelope* env, const float* params, ParamId attack) {
+    env->attack = params[attack];
+    env->decay = params[attack + 1];
+    env->sustain = params[attack + 2];
+    env->release = params[attack + 3];
+}
+
+// Wave, coarse, fine, pwm, sub mix and sync are consecutive ids; coarse and
+// sub mix have no oscillator field yet
+static void voice_read_oscillator(Oscillator* osc, const float* params, ParamId wave, ParamId unison) {
+    osc->waveform = (WaveformType)(int)params[wave];
+    osc->detune_cents = params[wave + (PARAM_OSC1_FINE - PARAM_OSC1_WAVE)];
+    osc->pulse_width = params[wave + (PARAM_OSC1_PWM - PARAM_OSC1_WAVE)];
+    osc->hard_sync = params[wave + (PARAM_OSC1_SYNC - PARAM_OSC1_WAVE)] != 0.0f;
+    osc->unison_voices = (int)params[unison];
+}
+
+// Copy the voice-scope entries of the store into a voice. Runs once per
+// sounding voice per block, so a change never loops over the pool.
+static void voice_read_shared_params(Voice* voice, const float* params) {
+    voice->filter.mode = (FilterMode)(int)params[PARAM_FILTER_MODE];
+    voice->filter.cutoff = params[PARAM_FILTER_CUTOFF];
+    voice->filter.resonance = params[PARAM_FILTER_RESONANCE];
+    voice->filter.env_amount = params[PARAM_FILTER_ENV_AMOUNT];
+    voice->env_amp.attack = params[PARAM_ENV_AMP_ATTACK];
+    voice->env_amp.decay = params[PARAM_ENV_AMP_DECAY];
+    voice->env_amp.sustain = params[PARAM_ENV_AMP_SUSTAIN];
+    voice->env_amp.release = params[PARAM_ENV_AMP_RELEASE];
+    voice_read_envelope(&voice->env_filter, params, PARAM_ENV_FILTER_ATTACK);
+    voice_read_envelope(&voice->env_pitch, params, PARAM_ENV_PITCH_ATTACK);
+    voice_read_oscillator(&voice->osc1, params, PARAM_OSC1_WAVE, PARAM_OSC1_UNISON);
+    voice_read_oscillator(&voice->osc2, params, PARAM_OSC2_WAVE, PARAM_OSC2_UNISON);
+}
+
+// The LFOs are shared by every voice; read them once per block
+static void synth_read_lfo_params(SynthEngine* synth) {
+    static const ParamId rates[] = {PARAM_LFO1_RATE, PARAM_LFO2_RATE};
+    for (int i = 0; i < 2; i++) {
+        LFO* lfo = &synth->lfos[i];
+        lfo->rate = synth->params[rates[i]];
+        lfo->amount = synth->params[rates[i] + (PARAM_LFO1_DEPTH - PARAM_LFO1_RATE)];
+        lfo->tempo_sync = synth->params[rates[i] + (PARAM_LFO1_SYNC - PARAM_LFO1_RATE)] != 0.0f;
+        lfo->fade_time = synth->params[rates[i] + (PARAM_LFO1_FADE - PARAM_LFO1_RATE)];
+    }
+}
+
 // ============================================================================
 // SYNTH ENGINE IMPLEMENTATION
 // ============================================================================
 
 void synth_init(SynthEngine* synth, float sample_rate) {
+    synth_init_with_polyphony(synth, sample_rate, MAX_VOICES);
+}
+
+void synth_init_with_polyphony(SynthEngine* synth, float sample_rate, int polyphony) {
     memset(synth, 0, sizeof(SynthEngine));
+    dsp_math_init();
+    
+    if (polyphony < 1) polyphony = 1;
+    if (polyphony > SYNTH_MAX_POLYPHONY) polyphony = SYNTH_MAX_POLYPHONY;
+    synth->polyphony = polyphony;
+    synth->steal_mode = VOICE_STEAL_OLDEST;
     
     synth->sample_rate = sample_rate;
-    synth->tempo = 120.0f;
-    synth->master_volume = 0.7f;
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        synth->params[i] = g_synth_params[i].default_value;
+    }
+    synth->params[PARAM_FILTER_CUTOFF] = fminf(synth->params[PARAM_FILTER_CUTOFF], sample_rate * 0.45f);
+    synth->tempo = synth->params[PARAM_TEMPO];
+    synth->master_volume = synth->params[PARAM_MASTER_VOLUME];
     synth->master_tune = 0.0f;
     synth->pitch_bend_range = 2; // ±2 semitones
+    expression_init(&synth->expression);
+    synth->expression_bend_range = synth->pitch_bend_range;
     
     synth->mono_mode = false;
     synth->legato_mode = false;
     synth->glide_time = 0.0f;
 
-    synth->filter_cutoff = 8000.0f;
-    synth->filter_resonance = 0.3f;
-    synth->filter_mode = FILTER_LP;
-    synth->filter_env_amount = 0.0f;
-
-    synth->env_attack = 0.01f;
-    synth->env_decay = 0.1f;
-    synth->env_sustain = 0.7f;
-    synth->env_release = 0.3f;
+    limiter_init(&synth->limiter, 0.95f, 0.1f);
+    oversampler_init(&synth->master_os);
+    
+    synth->simd_voices = true;
+    synth->voice_pool_min_voices = VOICE_POOL_DEFAULT_MIN_VOICES;
     
-    synth->limiter_threshold = 0.95f;
-    synth->limiter_release = 0.1f;
-    synth->limiter_gain = 1.0f;
+    param_smooth_init(&synth->smoothing, sample_rate);
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        param_smooth_configure(&synth->smoothing, (ParamId)i, g_synth_params[i].smoothing,
+                               g_synth_params[i].smooth_seconds);
+    }
+    synth->master_volume_applied = synth->master_volume;
     
-    // Initialize voices
-    for (int i = 0; i < MAX_VOICES; i++) {
+    // Initialize voices; the free stack pops voice 0 first
+    for (int i = 0; i < synth->polyphony; i++) {
         voice_init(&synth->voices[i], sample_rate);
-        synth->voices[i].filter.cutoff = synth->filter_cutoff;
-        synth->voices[i].filter.resonance = synth->filter_resonance;
-        synth->voices[i].filter.mode = synth->filter_mode;
-        synth->voices[i].filter.env_amount = synth->filter_env_amount;
-
-        synth->voices[i].env_amp.attack = synth->env_attack;
-        synth->voices[i].env_amp.decay = synth->env_decay;
-        synth->voices[i].env_amp.sustain = synth->env_sustain;
-        synth->voices[i].env_amp.release = synth->env_release;
+        voice_read_shared_params(&synth->voices[i], synth->params);
+        synth->free_voices[i] = synth->polyphony - 1 - i;
     }
+    synth->num_free_voices = synth->polyphony;
+    synth->num_active_voices = 0;
     
     // Initialize LFOs
     for (int i = 0; i < MAX_LFO; i++) {
@@ -704,42 +1539,144 @@ void synth_init(SynthEngine* synth, float sample_rate) {
     // Initialize modulation matrix
     mod_matrix_init(&synth->mod_matrix);
     
-    // Seed random
-    rng_state = (uint32_t)time(NULL);
+    synth_set_seed(synth, SYNTH_DEFAULT_SEED);
+}
+
+// Derive every generator from one seed so a given seed always renders the
+// same audio, independent of any other engine in the process
+void synth_set_seed(SynthEngine* synth, uint32_t seed) {
+    if (!synth) {
+        return;
+    }
+    synth->rng_state = seed;
+    for (int i = 0; i < synth->polyphony; i++) {
+        Voice* voice = &synth->voices[i];
+        voice->random_value = synth_rng_float(&synth->rng_state);
+        voice->osc1.noise_state = synth->rng_state * 2654435761u + 1u;
+        synth_rng_float(&synth->rng_state);
+        voice->osc2.noise_state = synth->rng_state * 2654435761u + 1u;
+    }
+    for (int i = 0; i < MAX_LFO; i++) {
+        synth_rng_float(&synth->rng_state);
+        synth->lfos[i].noise_state = synth->rng_state * 2654435761u + 1u;
+    }
+}
+
+void synth_set_master_oversample(SynthEngine* synth, OversampleMode mode) {
+    if (synth && mode != synth->master_os.mode) {
+        oversampler_set_mode(&synth->master_os, mode);
+    }
+}
+
+void synth_set_limiter_lookahead(SynthEngine* synth, float lookahead_ms) {
+    if (synth) {
+        limiter_set_lookahead(&synth->limiter, lookahead_ms, synth->sample_rate);
+    }
+}
+
+float synth_output_latency(const SynthEngine* synth) {
+    return (float)synth->limiter.latency + oversampler_latency(&synth->master_os);
+}
+
+void synth_set_voice_pool(SynthEngine* synth, struct VoicePool* pool, int min_voices) {
+    if (!synth) {
+        return;
+    }
+    synth->voice_pool = pool;
+    synth->voice_pool_min_voices = min_voices > 0 ? min_voices : VOICE_POOL_DEFAULT_MIN_VOICES;
 }
 
 void synth_set_tempo(SynthEngine* synth, float bpm) {
     synth->tempo = clamp(bpm, 20.0f, 300.0f);
 }
 
-// Find a free voice or steal the oldest
-static Voice* synth_allocate_voice(SynthEngine* synth) {
-    // First, look for a free voice
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (synth->voices[i].state == VOICE_OFF) {
-            return &synth->voices[i];
+void synth_set_steal_mode(SynthEngine* synth, VoiceStealMode mode) {
+    if (!synth || mode < VOICE_STEAL_OLDEST || mode >= VOICE_STEAL_COUNT) {
+        return;
+    }
+    synth->steal_mode = mode;
+}
+
+// Remove the entry at pos from the active list, keeping note-on order
+static void synth_active_list_remove(SynthEngine* synth, int pos) {
+    for (int k = pos; k < synth->num_active_voices - 1; k++) {
+        synth->active_voices[k] = synth->active_voices[k + 1];
+    }
+    synth->num_active_voices--;
+}
+
+// Make voice `index` the newest entry of the active list
+static void synth_claim_voice(SynthEngine* synth, int index) {
+    if (voice_is_active(&synth->voices[index])) {
+        for (int k = 0; k < synth->num_active_voices; k++) {
+            if (synth->active_voices[k] == index) {
+                synth_active_list_remove(synth, k);
+                break;
+            }
+        }
+    } else {
+        for (int k = synth->num_free_voices - 1; k >= 0; k--) {
+            if (synth->free_voices[k] == index) {
+                synth->free_voices[k] = synth->free_voices[--synth->num_free_voices];
+                break;
+            }
         }
     }
-    
-    // No free voices, find the oldest playing voice
-    Voice* oldest = &synth->voices[0];
-    uint64_t oldest_time = synth->voices[0].note_on_time;
-    
-    for (int i = 1; i < MAX_VOICES; i++) {
-        if (synth->voices[i].note_on_time < oldest_time) {
-            oldest = &synth->voices[i];
-            oldest_time = synth->voices[i].note_on_time;
+    synth->active_voices[synth->num_active_voices++] = index;
+}
+
+// Pick the active-list position to steal according to steal_mode
+static int synth_steal_position(const SynthEngine* synth) {
+    switch (synth->steal_mode) {
+        case VOICE_STEAL_QUIETEST: {
+            int best = 0;
+            float best_level = 2.0f;
+            for (int k = 0; k < synth->num_active_voices; k++) {
+                float level = synth->voices[synth->active_voices[k]].env_amp.current_level;
+                if (level < best_level) {
+                    best = k;
+                    best_level = level;
+                }
+            }
+            return best;
         }
+        case VOICE_STEAL_RELEASED_FIRST:
+            for (int k = 0; k < synth->num_active_voices; k++) {
+                if (synth->voices[synth->active_voices[k]].state == VOICE_RELEASE) {
+                    return k;
+                }
+            }
+            return 0;
+        case VOICE_STEAL_OLDEST:
+        default:
+            return 0; // Active list is kept in note-on order
     }
-    
-    return oldest;
+}
+
+// Pop a free voice or steal one; the result is the newest active voice
+static Voice* synth_allocate_voice(SynthEngine* synth) {
+    int index;
+    if (synth->num_free_voices > 0) {
+        index = synth->free_voices[--synth->num_free_voices];
+    } else {
+        int pos = synth_steal_position(synth);
+        index = synth->active_voices[pos];
+        synth_active_list_remove(synth, pos);
+    }
+    synth->active_voices[synth->num_active_voices++] = index;
+    return &synth->voices[index];
 }
 
 void synth_note_on(SynthEngine* synth, int note, float velocity) {
+    synth_note_on_channel(synth, 0, note, velocity);
+}
+
+void synth_note_on_channel(SynthEngine* synth, int channel, int note, float velocity) {
+    Voice* voice;
     // Mono mode handling
     if (synth->mono_mode) {
         // In mono mode, use first voice only
-        Voice* voice = &synth->voices[0];
+        voice = &synth->voices[0];
         
         if (synth->legato_mode && voice_is_active(voice)) {
             // Legato: change pitch without retriggering envelopes
@@ -747,197 +1684,449 @@ void synth_note_on(SynthEngine* synth, int note, float velocity) {
             voice->target_pitch = midi_to_freq(note);
         } else {
             // Normal mono: retrigger
+            synth_claim_voice(synth, 0);
             voice_note_on(voice, note, velocity, synth->sample_counter);
         }
         
         voice->glide_rate = synth->glide_time;
     } else {
         // Polyphonic mode: allocate a voice
-        Voice* voice = synth_allocate_voice(synth);
+        voice = synth_allocate_voice(synth);
         voice_note_on(voice, note, velocity, synth->sample_counter);
         voice->glide_rate = synth->glide_time;
     }
+    // An MPE note's initial bend and pressure arrive just before it
+    voice->channel = channel;
+    voice->expression = expression_for_note(&synth->expression, channel, note, synth->pitch_bend_range);
 }
 
 void synth_note_off(SynthEngine* synth, int note) {
     // Find and release all voices playing this note
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (synth->voices[i].midi_note == note && 
-            synth->voices[i].state != VOICE_OFF &&
-            synth->voices[i].state != VOICE_RELEASE) {
-            voice_note_off(&synth->voices[i], synth->sample_counter);
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        if (voice->midi_note == note && 
+            voice->state != VOICE_OFF &&
+            voice->state != VOICE_RELEASE) {
+            voice_note_off(voice, synth->sample_counter);
         }
     }
 }
 
 void synth_all_notes_off(SynthEngine* synth) {
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (voice_is_active(&synth->voices[i])) {
-            voice_note_off(&synth->voices[i], synth->sample_counter);
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        if (voice_is_active(voice)) {
+            voice_note_off(voice, synth->sample_counter);
         }
     }
 }
 
-void synth_pitch_bend(SynthEngine* synth, float amount) {
-    // amount is -1.0 to 1.0
-    float bend_semitones = amount * synth->pitch_bend_range;
-    float bend_ratio = cents_to_ratio(bend_semitones * 100.0f);
-    
-    // Apply to all active voices
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (voice_is_active(&synth->voices[i])) {
-            synth->voices[i].pitch_bend = amount;
-            synth->voices[i].target_pitch = midi_to_freq(synth->voices[i].midi_note) * bend_ratio;
+void synth_note_off_channel(SynthEngine* synth, int channel, int note) {
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        if (voice->midi_note == note && voice->channel == channel &&
+            voice->state != VOICE_OFF && voice->state != VOICE_RELEASE) {
+            voice_note_off(voice, synth->sample_counter);
         }
     }
 }
 
+void synth_pitch_bend(SynthEngine* synth, float amount) {
+    synth_channel_pitch_bend(synth, 0, amount);
+}
+
+void synth_channel_pitch_bend(SynthEngine* synth, int channel, float amount) {
+    if (expression_channel_valid(channel)) {
+        synth->expression.bend[channel] = clamp(amount, -1.0f, 1.0f);
+        synth->expression.serial++;
+    }
+}
+
+void synth_channel_pressure(SynthEngine* synth, int channel, float amount) {
+    if (expression_channel_valid(channel)) {
+        synth->expression.pressure[channel] = clamp(amount, 0.0f, 1.0f);
+        synth->expression.serial++;
+    }
+}
+
+void synth_poly_pressure(SynthEngine* synth, int channel, int note, float amount) {
+    if (expression_channel_valid(channel) && note >= 0 && note < 128) {
+        synth->expression.poly_pressure[channel][note] = clamp(amount, 0.0f, 1.0f);
+        synth->expression.serial++;
+    }
+}
+
+void synth_control_change(SynthEngine* synth, int channel, int controller, int value) {
+    if (!expression_channel_valid(channel)) {
+        return;
+    }
+    SynthExpression* expression = &synth->expression;
+    float amount = clamp((float)value / 127.0f, 0.0f, 1.0f);
+    switch (controller) {
+        case 1:
+            expression->mod_wheel[channel] = amount;
+            break;
+        case 74:
+            expression->timbre[channel] = amount;
+            break;
+        case 101:
+        case 100:
+            expression->rpn[channel][controller == 101 ? 0 : 1] = (uint8_t)(value & 0x7F);
+            return;
+        case 99:
+        case 98:
+            // An NRPN deselects the RPN, so its data entry is not misread
+            expression->rpn[channel][0] = EXPRESSION_NO_RPN;
+            expression->rpn[channel][1] = EXPRESSION_NO_RPN;
+            return;
+        case 6:
+        case 38:
+            expression_rpn(expression, channel, controller, value, synth->pitch_bend_range);
+            return;
+        case 121:
+            expression->bend[channel] = 0.0f;
+            expression->pressure[channel] = 0.0f;
+            expression->timbre[channel] = SYNTH_TIMBRE_DEFAULT;
+            expression->mod_wheel[channel] = 0.0f;
+            memset(expression->poly_pressure[channel], 0, sizeof(expression->poly_pressure[channel]));
+            break;
+        default:
+            return;
+    }
+    expression->serial++;
+}
+
+void synth_set_mpe_zones(SynthEngine* synth, int lower_members, int upper_members) {
+    expression_set_zones(&synth->expression, lower_members, upper_members);
+}
+
+// Controllers moved since the last block: each sounding voice re-reads what
+// it hears, once, however many messages arrived
+static void synth_read_expression(SynthEngine* synth) {
+    if (synth->expression.serial == synth->expression_serial &&
+        synth->pitch_bend_range == synth->expression_bend_range) {
+        return;
+    }
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        voice->expression = expression_for_note(&synth->expression, voice->channel, voice->midi_note,
+                                                synth->pitch_bend_range);
+    }
+    synth->expression_serial = synth->expression.serial;
+    synth->expression_bend_range = synth->pitch_bend_range;
+}
+
+// ============================================================================
+// PARAMETER SMOOTHING
+// ============================================================================
+
+// Apply a parameter's value (already clamped) right now
+static void synth_set_param_now(ParamId id, float value, void* userdata) {
+    SynthEngine* synth = (SynthEngine*)userdata;
+    synth->params[id] = value;
+    const SynthParamDesc* desc = &g_synth_params[id];
+    if (desc->apply) {
+        desc->apply(synth, value);
+    }
+}
+
+// What the engine plays now. Master volume stays a plain field that hosts
+// may set directly, so read that rather than the store.
+static float synth_param_current(const SynthEngine* synth, ParamId id) {
+    return id == PARAM_MASTER_VOLUME ? synth->master_volume : synth->params[id];
+}
+
+// Ramp toward `value` when the parameter is smoothed, else jump
+static void synth_smooth_param(SynthEngine* synth, ParamId id, float value) {
+    ParamSmoothBank* bank = &synth->smoothing;
+    if (!param_smooth_is_smoothed(bank, id)) {
+        synth_set_param_now(id, value, synth);
+        return;
+    }
+    if (!param_smooth_get(bank, id)->moving) {
+        param_smooth_snap(bank, id, synth_param_current(synth, id));
+    }
+    param_smooth_set_target(bank, id, value);
+}
+
+void synth_snap_params(SynthEngine* synth) {
+    if (!synth) {
+        return;
+    }
+    for (int i = 0; i < synth->smoothing.num_moving; i++) {
+        ParamId id = synth->smoothing.moving[i];
+        synth_set_param_now(id, param_smooth_get(&synth->smoothing, id)->target, synth);
+    }
+    param_smooth_snap_all(&synth->smoothing);
+    synth->master_volume_applied = synth->master_volume;
+}
+
 bool synth_engine_apply_param(SynthEngine* synth, const ParamMsg* msg) {
-    if (!synth || !msg) {
+    if (!synth || !msg || msg->id >= PARAM_PARAM_COUNT) {
         return false;
     }
-
     ParamId id = (ParamId)msg->id;
-    switch (id) {
-        case PARAM_MASTER_VOLUME: {
-            float volume = clamp(param_msg_get_float(msg), 0.0f, 1.0f);
-            synth->master_volume = volume;
-            return true;
-        }
-        case PARAM_TEMPO: {
-            float bpm = param_msg_get_float(msg);
-            synth_set_tempo(synth, bpm);
-            return true;
+    const SynthParamDesc* desc = &g_synth_params[id];
+    if (desc->scope == SYNTH_PARAM_HOST) {
+        return false;
+    }
+    float value = synth_param_clamp(id, param_msg_get_float(msg));
+    if (desc->flags & SYNTH_PARAM_NYQUIST_LIMITED) {
+        value = fmaxf(desc->min_value, fminf(value, synth->sample_rate * 0.45f));
+    }
+    synth_smooth_param(synth, id, value);
+    return true;
+}
+
+// ============================================================================
+// PATCHES
+// ============================================================================
+
+static void synth_params_blend(float* out, const float* a, const float* b, float t) {
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        if (g_synth_params[i].type == PARAM_FLOAT) {
+            out[i] = a[i] + (b[i] - a[i]) * t;
+        } else {
+            out[i] = t < 0.5f ? a[i] : b[i];
         }
-        case PARAM_FILTER_CUTOFF: {
-            float max_cutoff = fminf(20000.0f, synth->sample_rate * 0.45f);
-            float cutoff = clamp(param_msg_get_float(msg), 20.0f, max_cutoff);
-            synth->filter_cutoff = cutoff;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].filter.cutoff = cutoff;
-            }
-            return true;
+    }
+}
+
+void synth_patch_init(SynthPatch* patch) {
+    if (!patch) {
+        return;
+    }
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        patch->params[i] = g_synth_params[i].default_value;
+    }
+    patch->transition = SYNTH_PATCH_HOLD;
+    patch->fade_seconds = 0.0f;
+}
+
+void synth_patch_blend(SynthPatch* out, const SynthPatch* a, const SynthPatch* b, float t) {
+    if (!out || !a || !b) {
+        return;
+    }
+    t = clamp(t, 0.0f, 1.0f);
+    synth_params_blend(out->params, a->params, b->params, t);
+    out->transition = a->transition;
+    out->fade_seconds = a->fade_seconds;
+}
+
+void synth_load_patch(SynthEngine* synth, const SynthPatch* patch) {
+    if (!synth || !patch) {
+        return;
+    }
+
+    // Voices sounding now keep what they are playing; a crossfade still in
+    // flight is frozen where it is. Only one old patch is kept, so voices
+    // still holding an earlier one move to the patch being replaced.
+    float playing[PARAM_PARAM_COUNT];
+    if (synth->patch_fade_frames > 0) {
+        float t = (float)(synth->sample_counter - synth->patch_fade_start) /
+                  (float)synth->patch_fade_frames;
+        synth_params_blend(playing, synth->held_params, synth->params, clamp(t, 0.0f, 1.0f));
+    } else {
+        memcpy(playing, synth->params, sizeof(playing));
+    }
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        synth->voices[synth->active_voices[k]].patch_held = true;
+    }
+    memcpy(synth->held_params, playing, sizeof(playing));
+
+    synth->patch_fade_frames = 0;
+    if (patch->transition == SYNTH_PATCH_CROSSFADE && patch->fade_seconds > 0.0f) {
+        synth->patch_fade_frames = (int)(patch->fade_seconds * synth->sample_rate);
+        synth->patch_fade_start = synth->sample_counter;
+    }
+
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        ParamId id = (ParamId)i;
+        const SynthParamDesc* desc = &g_synth_params[i];
+        if (id == PARAM_PANIC) {
+            continue;
         }
-        case PARAM_FILTER_RESONANCE: {
-            float resonance = clamp(param_msg_get_float(msg), 0.0f, 1.0f);
-            synth->filter_resonance = resonance;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].filter.resonance = resonance;
-            }
-            return true;
+        float value = synth_param_clamp(id, patch->params[i]);
+        if (desc->flags & SYNTH_PARAM_NYQUIST_LIMITED) {
+            value = fmaxf(desc->min_value, fminf(value, synth->sample_rate * 0.45f));
         }
-        case PARAM_FILTER_MODE: {
-            int mode = param_msg_get_int(msg);
-            if (mode < FILTER_LP) mode = FILTER_LP;
-            if (mode >= FILTER_COUNT) mode = FILTER_COUNT - 1;
-            synth->filter_mode = (FilterMode)mode;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].filter.mode = synth->filter_mode;
-            }
-            return true;
+        if (desc->scope == SYNTH_PARAM_ENGINE) {
+            synth_smooth_param(synth, id, value);
+        } else {
+            // Held voices are shielded from the jump; stop any knob ramp so
+            // it cannot drag the new value back
+            param_smooth_snap(&synth->smoothing, id, value);
+            synth->params[i] = value;
         }
-        case PARAM_FILTER_ENV_AMOUNT: {
-            float amount = clamp(param_msg_get_float(msg), -1.0f, 1.0f);
-            synth->filter_env_amount = amount;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].filter.env_amount = amount;
+    }
+}
+
+// Refresh each sounding voice from the store it follows: the current patch,
+// the held one, or a blend of the two while a crossfade runs
+static void synth_read_voice_params(SynthEngine* synth) {
+    const float* held = synth->held_params;
+    float faded[PARAM_PARAM_COUNT];
+    if (synth->patch_fade_frames > 0) {
+        float t = (float)(synth->sample_counter - synth->patch_fade_start) /
+                  (float)synth->patch_fade_frames;
+        if (t >= 1.0f) {
+            synth->patch_fade_frames = 0;
+            for (int k = 0; k < synth->num_active_voices; k++) {
+                synth->voices[synth->active_voices[k]].patch_held = false;
             }
-            return true;
+        } else {
+            synth_params_blend(faded, synth->held_params, synth->params, t);
+            held = faded;
         }
-        case PARAM_ENV_AMP_ATTACK: {
-            float attack = clamp(param_msg_get_float(msg), 0.001f, 2.0f);
-            synth->env_attack = attack;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].env_amp.attack = attack;
+    }
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        voice_read_shared_params(voice, voice->patch_held ? held : synth->params);
+    }
+}
+
+// Frames the master stage keeps sounding after the last voice ends: the
+// limiter's delay and release, and the clip oversampler's filter history
+static uint32_t synth_master_tail_frames(const SynthEngine* synth) {
+    return (uint32_t)(2.0f * synth_output_latency(synth) + synth->limiter.release_s * synth->sample_rate);
+}
+
+// Render one sub-block (num_frames <= SYNTH_BLOCK_SIZE). Modulation sources
+// and voice control values are refreshed once at the top of the block.
+static void synth_render_block(SynthEngine* synth, float* output, int num_frames) {
+    param_smooth_advance(&synth->smoothing, num_frames, synth_set_param_now, synth);
+    synth_read_voice_params(synth);
+    synth_read_lfo_params(synth);
+    synth_read_expression(synth);
+    mod_matrix_update_sources_block(&synth->mod_matrix, synth, num_frames);
+
+    // Idle: no voices and the master stage has drained, so the block is
+    // silence. Skip the mix, limiter and clip and just write zeros.
+    if (synth->num_active_voices == 0 && synth->idle_frames >= synth_master_tail_frames(synth)) {
+        memset(output, 0, sizeof(float) * 2 * (size_t)num_frames);
+        synth->master_volume_applied = synth->master_volume;
+        synth->sample_counter += (uint64_t)num_frames;
+        return;
+    }
+
+    memset(synth->mix_left, 0, sizeof(float) * (size_t)num_frames);
+    memset(synth->mix_right, 0, sizeof(float) * (size_t)num_frames);
+
+    // Render each active voice into the mix buffers. Eligible voices are
+    // batched into SoA lanes; everything else takes the scalar path.
+    int active_voices = synth->num_active_voices;
+    if (synth->voice_pool && active_voices >= synth->voice_pool_min_voices) {
+        voice_pool_render(synth->voice_pool, synth, num_frames);
+    } else {
+        Voice* lane_voices[VOICE_SIMD_LANES];
+        int lane_count = 0;
+        for (int k = 0; k < active_voices; k++) {
+            Voice* voice = &synth->voices[synth->active_voices[k]];
+
+            if (synth->simd_voices && voice_simd_eligible(voice)) {
+                lane_voices[lane_count++] = voice;
+                if (lane_count == VOICE_SIMD_LANES) {
+                    voice_simd_render_group(lane_voices, lane_count,
+                                            synth->mix_left, synth->mix_right,
+                                            num_frames, synth->sample_rate);
+                    lane_count = 0;
+                }
+            } else {
+                voice_render_block(voice, synth->voice_buffer,
+                                   synth->mix_left, synth->mix_right,
+                                   num_frames, synth->sample_rate);
             }
-            return true;
         }
-        case PARAM_ENV_AMP_DECAY: {
-            float decay = clamp(param_msg_get_float(msg), 0.001f, 2.0f);
-            synth->env_decay = decay;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].env_amp.decay = decay;
-            }
-            return true;
+        if (lane_count > 0) {
+            voice_simd_render_group(lane_voices, lane_count,
+                                    synth->mix_left, synth->mix_right,
+                                    num_frames, synth->sample_rate);
         }
-        case PARAM_ENV_AMP_SUSTAIN: {
-            float sustain = clamp(param_msg_get_float(msg), 0.0f, 1.0f);
-            synth->env_sustain = sustain;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].env_amp.sustain = sustain;
-            }
-            return true;
+    }
+
+    // Retire voices whose envelopes finished during this block
+    int kept = 0;
+    for (int k = 0; k < active_voices; k++) {
+        int index = synth->active_voices[k];
+        if (voice_is_active(&synth->voices[index])) {
+            synth->active_voices[kept++] = index;
+        } else {
+            synth->free_voices[synth->num_free_voices++] = index;
         }
-        case PARAM_ENV_AMP_RELEASE: {
-            float release = clamp(param_msg_get_float(msg), 0.001f, 5.0f);
-            synth->env_release = release;
-            for (int i = 0; i < MAX_VOICES; ++i) {
-                synth->voices[i].env_amp.release = release;
-            }
-            return true;
+    }
+    synth->num_active_voices = kept;
+
+    // Mix down (energy-preserving) and apply master volume, ramped across
+    // the block from last block's gain
+    float voice_scale = 1.0f;
+    if (active_voices > 0) {
+        voice_scale /= sqrtf((float)active_voices);
+    }
+    float gain = synth->master_volume_applied;
+    float gain_step = (synth->master_volume - gain) / (float)num_frames;
+    synth->master_volume_applied = synth->master_volume;
+
+    for (int frame = 0; frame < num_frames; frame++) {
+        gain += gain_step;
+        float scale = gain * voice_scale;
+        synth->mix_left[frame] *= scale;
+        synth->mix_right[frame] *= scale;
+    }
+
+    limiter_process(&synth->limiter, synth->mix_left, synth->mix_right, num_frames, synth->sample_rate);
+
+    // Soft clip to prevent digital clipping; oversampled, its harmonics
+    // above Nyquist are filtered rather than folded back
+    float* clip_left = synth->mix_left;
+    float* clip_right = synth->mix_right;
+    int clip_frames = num_frames;
+    if (synth->master_os.mode != OVERSAMPLE_OFF) {
+        clip_frames = oversampler_upsample(&synth->master_os, synth->mix_left, synth->mix_right, num_frames);
+        clip_left = synth->master_os.left;
+        clip_right = synth->master_os.right;
+    }
+    for (int i = 0; i < clip_frames; i++) {
+        clip_left[i] = soft_clip(clip_left[i]);
+        clip_right[i] = soft_clip(clip_right[i]);
+    }
+    if (synth->master_os.mode != OVERSAMPLE_OFF) {
+        oversampler_downsample(&synth->master_os, synth->mix_left, synth->mix_right, num_frames);
+    }
+
+    // Write output (interleaved stereo)
+    for (int frame = 0; frame < num_frames; frame++) {
+        output[frame * 2 + 0] = synth->mix_left[frame];
+        output[frame * 2 + 1] = synth->mix_right[frame];
+    }
+
+    // Count silence from the first block with no voice; once the tail has
+    // played out the master stage goes back to rest for the idle path
+    if (active_voices > 0) {
+        synth->idle_frames = 0;
+    } else {
+        synth->idle_frames += (uint32_t)num_frames;
+        if (synth->idle_frames >= synth_master_tail_frames(synth)) {
+            limiter_reset(&synth->limiter);
+            oversampler_reset(&synth->master_os);
         }
-        case PARAM_PANIC:
-            synth_all_notes_off(synth);
-            return true;
-        default:
-            return false;
     }
+
+    synth->sample_counter += (uint64_t)num_frames;
 }
 
 void synth_process(SynthEngine* synth, float* output, int num_frames) {
-    // Process audio buffer
-    for (int frame = 0; frame < num_frames; frame++) {
-        float left = 0.0f;
-        float right = 0.0f;
-        
-        mod_matrix_update_sources(&synth->mod_matrix, synth);
-        
-        // Process each voice
-        int active_voices = 0;
-        for (int i = 0; i < MAX_VOICES; i++) {
-            if (voice_is_active(&synth->voices[i])) {
-                float voice_left, voice_right;
-                voice_process(&synth->voices[i], &voice_left, &voice_right, synth->sample_rate);
-                
-                left += voice_left;
-                right += voice_right;
-                active_voices++;
-            }
-        }
-        
-        // Mix down
-        if (active_voices > 0) {
-            float scale = 1.0f / sqrtf((float)active_voices); // Energy-preserving mix
-            left *= scale;
-            right *= scale;
-        }
-        
-        // Apply master volume
-        left *= synth->master_volume;
-        right *= synth->master_volume;
-        
-        // Simple limiter
-        float peak = fmaxf(fabsf(left), fabsf(right));
-        if (peak > synth->limiter_threshold) {
-            float target_gain = synth->limiter_threshold / peak;
-            synth->limiter_gain = fminf(synth->limiter_gain, target_gain);
-        } else {
-            // Release
-            float release_coeff = 1.0f - expf(-1.0f / (synth->limiter_release * synth->sample_rate));
-            synth->limiter_gain += (1.0f - synth->limiter_gain) * release_coeff;
+    if (!synth || !output || num_frames <= 0) {
+        return;
+    }
+
+    // Process audio buffer in control-rate sub-blocks
+    int frame = 0;
+    while (frame < num_frames) {
+        int block = num_frames - frame;
+        if (block > SYNTH_BLOCK_SIZE) {
+            block = SYNTH_BLOCK_SIZE;
         }
-        
-        left *= synth->limiter_gain;
-        right *= synth->limiter_gain;
-        
-        // Soft clip to prevent digital clipping
-        left = soft_clip(left);
-        right = soft_clip(right);
-        
-        // Write output (interleaved stereo)
-        output[frame * 2 + 0] = left;
-        output[frame * 2 + 1] = right;
-        
-        synth->sample_counter++;
+        synth_render_block(synth, output + frame * 2, block);
+        frame += block;
     }
 }
@@ -16,16 +16,22 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "synth_types.h"
+#include "param_smooth.h"
+#include "dynamics.h"
+#include "oversample.h"
 
 // ============================================================================
 // CONFIGURATION
 // ============================================================================
 
-#define MAX_VOICES 8
+#define MAX_VOICES 8              // Default polyphony
+#define SYNTH_MAX_POLYPHONY 256   // Voice pool capacity (polyphony is set at init)
 #define MAX_UNISON 5
 #define MAX_LFO 4
 #define MAX_MOD_SLOTS 16
 #define WAVETABLE_SIZE 2048
+#define SYNTH_BLOCK_SIZE 32   // Control-rate sub-block (frames per mod/filter update)
+#define SYNTH_DEFAULT_SEED 123456789u
 
 // ============================================================================
 // ENUMS
@@ -72,6 +78,7 @@ typedef enum {
     MOD_SOURCE_AFTERTOUCH,
     MOD_SOURCE_KEYTRACK,
     MOD_SOURCE_RANDOM,
+    MOD_SOURCE_TIMBRE,        // CC 74 (MPE "slide")
     MOD_SOURCE_COUNT
 } ModSource;
 
@@ -89,6 +96,13 @@ typedef enum {
     MOD_DEST_COUNT
 } ModDestination;
 
+typedef enum {
+    VOICE_STEAL_OLDEST,         // Steal the longest-sounding note
+    VOICE_STEAL_QUIETEST,       // Steal the voice with the lowest amp envelope
+    VOICE_STEAL_RELEASED_FIRST, // Prefer the oldest released voice, then oldest
+    VOICE_STEAL_COUNT
+} VoiceStealMode;
+
 typedef enum {
     VOICE_OFF,
     VOICE_ATTACK,
@@ -100,6 +114,8 @@ typedef enum {
 // OSCILLATOR
 // ============================================================================
 
+struct WavetableMip; // wavetable.h
+
 typedef struct {
     // Core parameters
     WaveformType waveform;
@@ -115,6 +131,14 @@ typedef struct {
     float detune_cents;       // -100 to +100
     float unison_spread;      // 0.0 to 1.0
     
+    // Unison sub-voices: own phase accumulators plus increment ratios that
+    // are only recomputed when voices/detune/spread change
+    float unison_phases[MAX_UNISON];
+    float unison_ratios[MAX_UNISON];
+    int unison_cached_voices;  // 0 = ratios need rebuilding
+    float unison_cached_detune;
+    float unison_cached_spread;
+    
     // Sync
     bool hard_sync;
     float sync_phase;
@@ -136,6 +160,14 @@ typedef struct {
     float* wavetable;
     int wavetable_size;
     float wavetable_position; // 0.0 to 1.0 through table
+    
+    // Anti-aliasing: PolyBLEP saw/square, PolyBLAMP triangle, and the
+    // per-octave mip level of the wavetable when one has been built
+    bool band_limited;
+    const struct WavetableMip* wavetable_mip;
+    
+    // Noise generator state (seeded per voice by synth_set_seed)
+    uint32_t noise_state;
 } Oscillator;
 
 // ============================================================================
@@ -160,6 +192,8 @@ typedef struct {
     // Coefficients (updated when cutoff/resonance change)
     float f;                  // Frequency coefficient
     float q;                  // Resonance coefficient
+    float f_step;             // Per-frame glide of f across the current block
+    float f_end;              // f once the glide completes
 } Filter;
 
 // ============================================================================
@@ -185,6 +219,23 @@ typedef struct {
     // Retrigger/loop
     bool retrigger;
     bool loop;
+
+    // Segment coefficients (see envelope_prepare). Attack and decay are
+    // one-pole approaches toward a target past the segment's end level, so
+    // each sample is level = base + level * coef; release decays toward zero.
+    float attack_coef;
+    float attack_base;
+    float decay_coef;
+    float decay_base;
+    float release_coef;
+
+    // Inputs the coefficients were computed from
+    float prepared_attack;
+    float prepared_decay;
+    float prepared_sustain;
+    float prepared_release;
+    float prepared_peak;
+    float prepared_rate;
 } Envelope;
 
 // ============================================================================
@@ -209,6 +260,8 @@ typedef struct {
     
     // Bipolar output
     bool bipolar;             // -1 to 1 vs 0 to 1
+    
+    uint32_t noise_state;     // S&H/noise generator state
 } LFO;
 
 // ============================================================================
@@ -222,14 +275,79 @@ typedef struct {
     bool enabled;
 } ModSlot;
 
+// Compiled route: one enabled slot with a non-zero amount
+typedef struct {
+    ModSource source;
+    ModDestination destination;
+    float amount;
+} ModRoute;
+
+// Depth of a full-scale (1.0) per-voice modulation
+#define MOD_PITCH_RANGE_SEMITONES 12.0f
+#define MOD_CUTOFF_RANGE_OCTAVES 4.0f
+#define MOD_PWM_RANGE 0.45f
+
 typedef struct {
     ModSlot slots[MAX_MOD_SLOTS];
     int num_slots;
+    bool dirty;               // Slots changed; recompiled before the next block
+    
+    // Routing compiled from the slots (mod_matrix_compile). Engine-wide
+    // routes are grouped by destination: global_routes[dest_first[d] ..
+    // dest_first[d + 1]). Per-voice routes are evaluated per voice.
+    ModRoute global_routes[MAX_MOD_SLOTS];
+    int dest_first[MOD_DEST_COUNT + 1];
+    ModRoute voice_routes[MAX_MOD_SLOTS];
+    int num_voice_routes;
+    ModSource used_sources[MOD_SOURCE_COUNT]; // Engine-wide sources some route reads
+    int num_used_sources;
+    bool voices_stale;        // Routing shrank; clear every voice's mod once
+    
+    // Per-source control rate in sub-blocks (1 = every SYNTH_BLOCK_SIZE frames)
+    int source_rate[MOD_SOURCE_COUNT];
+    int source_countdown[MOD_SOURCE_COUNT];
+    int source_frames[MOD_SOURCE_COUNT];   // Frames since the last update
     
-    // Cached source values (updated once per buffer)
+    // Cached engine-wide source values and their summed destinations
     float source_values[MOD_SOURCE_COUNT];
+    float dest_values[MOD_DEST_COUNT];
 } ModulationMatrix;
 
+// ============================================================================
+// EXPRESSION
+// ============================================================================
+
+#define SYNTH_MIDI_CHANNELS 16
+#define SYNTH_MPE_MEMBER_BEND_RANGE 48   // Semitones; MPE's default on member channels
+#define SYNTH_MPE_MAX_BEND_RANGE 96      // Semitones; the most RPN 0 may set
+#define SYNTH_TIMBRE_DEFAULT (64.0f / 127.0f)   // CC 74 at rest, as MPE specifies
+
+// What one note hears from the controllers
+typedef struct {
+    float bend;               // Semitones (an MPE note adds its zone master's)
+    float pressure;           // 0-1: channel or poly aftertouch, whichever is higher
+    float timbre;             // 0-1: CC 74 (rests at SYNTH_TIMBRE_DEFAULT)
+    float mod_wheel;          // 0-1: CC 1
+} VoiceExpression;
+
+// Controller values per channel and per note, stored as they arrive: a
+// message costs one store, never a loop over the voices. Sounding voices
+// copy what they hear once per block, and only in blocks after a change.
+// MPE zones: the lower zone's master is channel 0 with members 1..n, the
+// upper zone's is channel 15 with members 15-n..14.
+typedef struct {
+    float bend[SYNTH_MIDI_CHANNELS];          // -1 to 1
+    float bend_range[SYNTH_MIDI_CHANNELS];    // Semitones and cents (RPN 0); -1 = pitch_bend_range
+    float pressure[SYNTH_MIDI_CHANNELS];
+    float timbre[SYNTH_MIDI_CHANNELS];
+    float mod_wheel[SYNTH_MIDI_CHANNELS];
+    float poly_pressure[SYNTH_MIDI_CHANNELS][128];
+    uint8_t rpn[SYNTH_MIDI_CHANNELS][2];      // Selected RPN (CC 101, CC 100); 127 = none
+    int lower_members;        // 0 = no lower zone
+    int upper_members;        // 0 = no upper zone
+    uint32_t serial;          // Bumped by every change
+} SynthExpression;
+
 // ============================================================================
 // VOICE
 // ============================================================================
@@ -251,7 +369,7 @@ typedef struct {
     
     // Voice parameters
     float pan;                // -1.0 (left) to 1.0 (right)
-    float pitch_bend;         // -1.0 to 1.0 (semitones based on bend range)
+    float pitch_env_amount;   // Pitch envelope depth (fraction of frequency, 0 = skip it)
     
     // Glide/portamento
     float glide_rate;         // Seconds to glide full octave
@@ -264,6 +382,21 @@ typedef struct {
     
     // Per-voice random
     float random_value;       // 0.0 to 1.0
+
+    // MIDI channel of the note and the controllers it hears (bend is
+    // applied to both oscillators at block rate)
+    int channel;
+    VoiceExpression expression;
+    
+    // Modulation matrix output for the current block, -1.0 to 1.0 per
+    // destination (all zero when nothing is routed)
+    float mod[MOD_DEST_COUNT];
+    // The matrix reads these envelopes, so they run even at zero amount
+    bool env_filter_routed;
+    bool env_pitch_routed;
+    // Sounding when the last patch was loaded: reads the engine's
+    // held_params instead of params until it ends or the crossfade completes
+    bool patch_held;
 } Voice;
 
 // ============================================================================
@@ -275,9 +408,16 @@ typedef struct {
     float sample_rate;
     float tempo;              // BPM
     
-    // Voices
-    Voice voices[MAX_VOICES];
+    // Voices (preallocated pool; only the first `polyphony` are used)
+    Voice voices[SYNTH_MAX_POLYPHONY];
+    int polyphony;
+    VoiceStealMode steal_mode;
+    
+    // Sounding voices in note-on order (oldest first) and idle voice stack
+    int active_voices[SYNTH_MAX_POLYPHONY];
     int num_active_voices;
+    int free_voices[SYNTH_MAX_POLYPHONY];
+    int num_free_voices;
     
     // Global LFOs
     LFO lfos[MAX_LFO];
@@ -289,84 +429,248 @@ typedef struct {
     float master_volume;      // 0.0 to 1.0
     float master_tune;        // -100 to +100 cents
     int pitch_bend_range;     // Semitones (default 2)
+
+    // Controller input (synth_control_change and friends)
+    SynthExpression expression;
+    uint32_t expression_serial;   // What the voices last read
+    int expression_bend_range;
     
     // Voice management
     bool mono_mode;
     bool legato_mode;
     float glide_time;         // Global glide time
 
-    // Cached parameter snapshot for filters/envelopes
-    float filter_cutoff;
-    float filter_resonance;
-    FilterMode filter_mode;
-    float filter_env_amount;
-
-    float env_attack;
-    float env_decay;
-    float env_sustain;
-    float env_release;
+    // Flat parameter store: the applied value of every ParamId, indexed by
+    // id. Voice-scope entries are read by each voice when it renders, so a
+    // change costs one store, not a loop over the voices.
+    float params[PARAM_PARAM_COUNT];
+    
+    // Patch that synth_load_patch replaced. Voices that were sounding keep
+    // it until they end (hold) or morph away from it over patch_fade_frames.
+    float held_params[PARAM_PARAM_COUNT];
+    uint64_t patch_fade_start;
+    int patch_fade_frames;    // 0 = held voices keep the old patch
+    
+    // Zipper-free parameter changes (synth_engine_apply_param feeds it)
+    ParamSmoothBank smoothing;
+    float master_volume_applied; // Gain at the end of the last block
     
     // Protection
-    float limiter_threshold;  // 0.0 to 1.0
-    float limiter_release;    // Seconds
-    float limiter_gain;       // Current gain reduction
+    Limiter limiter;          // Lookahead master limiter (synth_set_limiter_lookahead)
+    Oversampler master_os;    // Soft clip rate (synth_set_master_oversample)
+    uint32_t idle_frames;     // Rendered with no voice; past the master tail, blocks are zeros
+    
+    // Render backend: gather eligible voices into SoA lanes (voice_simd.c)
+    bool simd_voices;
+    
+    // Optional parallel voice rendering (voice_pool.c); NULL = this thread only
+    struct VoicePool* voice_pool;
+    int voice_pool_min_voices; // Use the pool from this many active voices
+    
+    // Block render scratch (one sub-block of SYNTH_BLOCK_SIZE frames)
+    float voice_buffer[SYNTH_BLOCK_SIZE];
+    float mix_left[SYNTH_BLOCK_SIZE];
+    float mix_right[SYNTH_BLOCK_SIZE];
     
     // Sample counter (for time-based calculations)
     uint64_t sample_counter;
+    
+    // Random mod source state. All randomness lives in the engine instance
+    // (no globals), so engines are reentrant and renders repeat exactly.
+    uint32_t rng_state;
 } SynthEngine;
 
+// ============================================================================
+// PARAMETER TABLE
+// ============================================================================
+
+typedef enum {
+    SYNTH_PARAM_ENGINE,   // Engine-wide; the descriptor's hook puts it to use
+    SYNTH_PARAM_VOICE,    // Shared by every voice, read from the store at render time
+    SYNTH_PARAM_HOST      // Handled by the host (FX rack, arp...); the engine ignores it
+} SynthParamScope;
+
+#define SYNTH_PARAM_NYQUIST_LIMITED 0x1u  // Also capped at 0.45 * sample rate
+
+// One static descriptor per ParamId, so ranges, defaults and names live in
+// one place for the engine, presets, UI and automation
+typedef struct {
+    const char* name;         // Stable key for files and automation
+    ParamType type;
+    float min_value;
+    float max_value;
+    float default_value;
+    SynthParamScope scope;
+    SmoothMode smoothing;     // Engine-scope and voice-scope params only
+    float smooth_seconds;
+    unsigned flags;
+    // Push the (clamped, smoothed) value into the engine; NULL = store only
+    void (*apply)(SynthEngine* synth, float value);
+} SynthParamDesc;
+
+// NULL for an id outside ParamId
+const SynthParamDesc* synth_param_desc(ParamId id);
+// Clamp to the descriptor's range (and round integer/bool params)
+float synth_param_clamp(ParamId id, float value);
+// PARAM_PARAM_COUNT when no descriptor has that name
+ParamId synth_param_find(const char* name);
+static inline float synth_param_get(const SynthEngine* synth, ParamId id) {
+    return synth->params[id];
+}
+
+// ============================================================================
+// PATCHES
+// ============================================================================
+
+typedef enum {
+    SYNTH_PATCH_HOLD,         // Sounding voices keep the old patch until they end
+    SYNTH_PATCH_CROSSFADE     // Sounding voices morph to the new one over fade_seconds
+} SynthPatchTransition;
+
+// A complete set of parameter values. The host builds it off the audio
+// thread and the engine takes it in one call, so a preset change never
+// plays a mix of old and new values.
+typedef struct SynthPatch {
+    float params[PARAM_PARAM_COUNT];
+    SynthPatchTransition transition;
+    float fade_seconds;
+} SynthPatch;
+
+// Descriptor defaults, hold transition
+void synth_patch_init(SynthPatch* patch);
+// Float params interpolate; int and bool params switch at t = 0.5. `out`
+// takes a's transition. Also the building block for scene blending.
+void synth_patch_blend(SynthPatch* out, const SynthPatch* a, const SynthPatch* b, float t);
+// Audio thread: switch to `patch`. Engine-scope params take their usual
+// smoothing, voice-scope params change for new notes at once, and host
+// params are stored for the host to read back. Panic is never triggered.
+void synth_load_patch(SynthEngine* synth, const SynthPatch* patch);
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
 
 // Engine
 void synth_init(SynthEngine* synth, float sample_rate);
+void synth_init_with_polyphony(SynthEngine* synth, float sample_rate, int polyphony);
+void synth_set_steal_mode(SynthEngine* synth, VoiceStealMode mode);
 void synth_process(SynthEngine* synth, float* output, int num_frames);
 void synth_set_tempo(SynthEngine* synth, float bpm);
+// Reseed the engine, its voices and LFOs (synth_init uses SYNTH_DEFAULT_SEED)
+void synth_set_seed(SynthEngine* synth, uint32_t seed);
+// Run the master soft clip at 1x (default), 2x or 4x. Realtime-safe; call
+// from the rendering thread. Changing it clears the filter history.
+void synth_set_master_oversample(SynthEngine* synth, OversampleMode mode);
+// Master limiter lookahead in ms (0 = none, the default; up to
+// DYN_LIMITER_MAX_LOOKAHEAD_MS). Same threading rules as above.
+void synth_set_limiter_lookahead(SynthEngine* synth, float lookahead_ms);
+// Frames the master stage delays the output: limiter lookahead plus the
+// clip oversampler's filters
+float synth_output_latency(const SynthEngine* synth);
+// Render voices on `pool` once at least `min_voices` are active
+// (0 = VOICE_POOL_DEFAULT_MIN_VOICES). NULL detaches; the engine never owns it.
+void synth_set_voice_pool(SynthEngine* synth, struct VoicePool* pool, int min_voices);
 
 // MIDI
 void synth_note_on(SynthEngine* synth, int note, float velocity);
 void synth_note_off(SynthEngine* synth, int note);
 void synth_all_notes_off(SynthEngine* synth);
-void synth_pitch_bend(SynthEngine* synth, float amount);
+// Notes on a MIDI channel (0-15). synth_note_on plays on channel 0;
+// synth_note_off releases the note on every channel.
+void synth_note_on_channel(SynthEngine* synth, int channel, int note, float velocity);
+void synth_note_off_channel(SynthEngine* synth, int channel, int note);
+
+// Controller input, realtime-safe. Each call stores one value; voices pick
+// it up at the next block. Bend is -1 to 1, pressure 0 to 1.
+void synth_pitch_bend(SynthEngine* synth, float amount);   // Channel 0
+void synth_channel_pitch_bend(SynthEngine* synth, int channel, float amount);
+void synth_channel_pressure(SynthEngine* synth, int channel, float amount);
+void synth_poly_pressure(SynthEngine* synth, int channel, int note, float amount);
+// CC 1 (mod wheel), 74 (timbre), 121 (reset controllers) and, through
+// CC 101/100 with data entry CC 6/38, RPN 0 (bend range: semitones up to
+// 96, and cents) and RPN 6 (MPE configuration)
+void synth_control_change(SynthEngine* synth, int channel, int controller, int value);
+// MPE zones by member channel count, as an MPE configuration message sets
+// them: members bend +/-48 semitones, masters keep pitch_bend_range
+void synth_set_mpe_zones(SynthEngine* synth, int lower_members, int upper_members);
+// Table-driven: clamp, then store (ramping smoothed params) and run the
+// descriptor's hook. False for host-scope and unknown ids.
 bool synth_engine_apply_param(SynthEngine* synth, const ParamMsg* msg);
+// Finish every parameter ramp at once (after loading a patch offline)
+void synth_snap_params(SynthEngine* synth);
 
 // Oscillator
 void osc_init(Oscillator* osc, float sample_rate);
 float osc_process(Oscillator* osc, float sample_rate, float fm_input);
 void osc_set_waveform(Oscillator* osc, WaveformType type);
 void osc_set_frequency(Oscillator* osc, float freq);
+void osc_reset_unison_phases(Oscillator* osc);
 
 // Filter
 void filter_init(Filter* filter, float sample_rate);
 float filter_process(Filter* filter, float input);
+// Zero state that has decayed below DENORMAL_FLOOR; once per block
+void filter_flush_denormals(Filter* filter);
 void filter_set_mode(Filter* filter, FilterMode mode);
 void filter_update_coefficients(Filter* filter, float sample_rate, float cutoff, float resonance);
+// Like filter_update_coefficients, but f glides there over num_frames
+void filter_glide_coefficients(Filter* filter, float sample_rate, float cutoff, float resonance,
+                               int num_frames);
 
 // Envelope
 void envelope_init(Envelope* env);
 void envelope_trigger(Envelope* env, float velocity);
 void envelope_release(Envelope* env);
 float envelope_process(Envelope* env, float sample_rate);
+// Recompute segment coefficients if the ADSR, peak or rate changed (the
+// process calls do this themselves; parameters may be written directly)
+void envelope_prepare(Envelope* env, float sample_rate);
+// Fill out[0..num_frames) with envelope levels. Returns the frames rendered
+// before the envelope finished; the rest of out is zeroed.
+int envelope_process_block(Envelope* env, float* out, int num_frames, float sample_rate);
 bool envelope_is_active(Envelope* env);
 
 // LFO
 void lfo_init(LFO* lfo);
 void lfo_trigger(LFO* lfo);
 float lfo_process(LFO* lfo, float sample_rate, float tempo);
+float lfo_process_block(LFO* lfo, float sample_rate, float tempo, int num_frames);
 
 // Modulation
 void mod_matrix_init(ModulationMatrix* matrix);
 void mod_matrix_add_slot(ModulationMatrix* matrix, ModSource source, 
                          ModDestination dest, float amount);
+void mod_matrix_clear(ModulationMatrix* matrix);
+// Rebuild the routing table. add_slot/clear mark the matrix dirty and the
+// next block compiles it; after editing slots[] directly, set `dirty`.
+void mod_matrix_compile(ModulationMatrix* matrix);
+// Evaluate an engine-wide source every `blocks` sub-blocks (per-voice
+// sources always follow their voice at block rate)
+void mod_matrix_set_source_rate(ModulationMatrix* matrix, ModSource source, int blocks);
+bool mod_matrix_source_is_per_voice(ModSource source);
 void mod_matrix_update_sources(ModulationMatrix* matrix, SynthEngine* synth);
-float mod_matrix_get_value(ModulationMatrix* matrix, ModDestination dest);
+// Refresh referenced sources and every active voice's mod[]; free when no
+// slot is routed
+void mod_matrix_update_sources_block(ModulationMatrix* matrix, SynthEngine* synth, int num_frames);
+// Engine-wide contribution to `dest` (per-voice sources excluded)
+float mod_matrix_get_value(const ModulationMatrix* matrix, ModDestination dest);
+void mod_matrix_apply_voice(const ModulationMatrix* matrix, Voice* voice);
 
 // Voice
 void voice_init(Voice* voice, float sample_rate);
 void voice_note_on(Voice* voice, int midi_note, float velocity, uint64_t time);
 void voice_note_off(Voice* voice, uint64_t time);
 void voice_process(Voice* voice, float* left, float* right, float sample_rate);
+void voice_render_block(Voice* voice, float* scratch, float* left, float* right,
+                        int num_frames, float sample_rate);
+int voice_render_controls(Voice* voice, float* amp, float* freq, int stride,
+                          int num_frames, float sample_rate);
+void voice_accumulate_panned(const Voice* voice, const float* scratch,
+                             float* left, float* right, int num_frames);
+// Osc2 frequency relative to osc1, and a pulse width, after the voice's
+// matrix offsets (exactly 1.0 / `base` when unmodulated)
+float voice_mod_osc2_ratio(const Voice* voice);
+float voice_mod_pulse_width(float base, float mod);
 bool voice_is_active(Voice* voice);
 
 // Utilities
@@ -375,5 +679,13 @@ float cents_to_ratio(float cents);
 float db_to_linear(float db);
 float linear_to_db(float linear);
 float soft_clip(float x);
+float poly_blep(float t, float dt);
+float poly_blamp(float t, float dt);
+
+// LCG step: uniform float in [0, 1) from caller-owned state
+static inline float synth_rng_float(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
 
 #endif // SYNTH_ENGINE_H
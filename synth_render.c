@@ -0,0 +1,206 @@
+/**
+ * Headless bounce tool.
+ *
+ * Renders a project (or a bare preset) to WAV through offline_render,
+ * faster than real time and without a window or audio device.
+ *
+ *   synth_render project.json                 # -> project's exportPath
+ *   synth_render -p preset.json -o out.wav -d 4
+ *   synth_render --batch out/ -j 8 pad.json lead.json bass.json
+ *   synth_render --convert pad.json pad.synp   # JSON <-> binary, by extension
+ */
+
+#define MINIAUDIO_IMPLEMENTATION
+#define MA_NO_DEVICE_IO
+#define MA_NO_ENGINE
+#define MA_NO_NODE_GRAPH
+#include "miniaudio.h"
+
+#include "offline_render.h"
+#include "project.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [project.json] [-p preset.json] [-o out.wav] [-d seconds] [-r rate]\n"
+            "       %s --batch out_dir [-j threads] [-d seconds] [-r rate] file.json...\n"
+            "       %s --convert in_file out_file\n"
+            "  project.json   Project to render (defaults apply when omitted)\n"
+            "  -p             Render this preset instead of the project's own\n"
+            "  -o             Output path (default: the project's exportPath)\n"
+            "  -d             Duration in seconds (default: exportDuration)\n"
+            "  -r             Sample rate (default: %d)\n"
+            "  --batch        Render each project/preset file to out_dir/<name>.wav\n"
+            "  -j             Worker threads for --batch (default: one per core)\n"
+            "  --convert      Rewrite a project/preset; " PRESET_BINARY_EXTENSION " and "
+            PROJECT_BINARY_EXTENSION " outputs are binary, anything else JSON\n",
+            argv0, argv0, argv0, OFFLINE_RENDER_DEFAULT_RATE);
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int run_batch(const char* output_dir, char** inputs, int count,
+                     const OfflineRenderOptions* options, int threads) {
+    OfflineRenderJob* jobs = (OfflineRenderJob*)calloc((size_t)count, sizeof(OfflineRenderJob));
+    if (!jobs) {
+        return 1;
+    }
+    for (int i = 0; i < count; ++i) {
+        offline_render_job_init(&jobs[i], inputs[i], output_dir);
+    }
+    if (threads <= 0) {
+        threads = offline_render_default_threads();
+    }
+    if (threads > count) {
+        threads = count;
+    }
+
+    double started = wall_seconds();
+    int succeeded = offline_render_batch(jobs, count, options, threads);
+    double elapsed = wall_seconds() - started;
+
+    uint32_t rate = options->sample_rate ? options->sample_rate : OFFLINE_RENDER_DEFAULT_RATE;
+    double audio_seconds = 0.0;
+    for (int i = 0; i < count; ++i) {
+        if (!jobs[i].ok) {
+            fprintf(stderr, "❌ %s: render failed\n", jobs[i].input_path);
+            continue;
+        }
+        audio_seconds += (double)jobs[i].stats.frames / rate;
+    }
+    printf("✅ Rendered %d/%d files (%.1f s of audio) in %.2f s on %d threads (%.0fx real time)\n",
+           succeeded, count, audio_seconds, elapsed, threads,
+           elapsed > 0.0 ? audio_seconds / elapsed : 0.0);
+    free(jobs);
+    return succeeded == count ? 0 : 1;
+}
+
+static bool has_extension(const char* path, const char* extension) {
+    size_t length = strlen(path);
+    size_t ext_length = strlen(extension);
+    return length >= ext_length && strcmp(path + length - ext_length, extension) == 0;
+}
+
+// Either file may be JSON or binary; the output extension picks the encoding
+static int run_convert(const char* input_path, const char* output_path) {
+    ProjectData project;
+    project_init(&project);
+    bool ok;
+    if (project_load_file(&project, input_path)) {
+        ok = has_extension(output_path, PROJECT_BINARY_EXTENSION)
+                 ? project_save_binary(&project, output_path)
+                 : project_save_file(&project, output_path, true);
+    } else if (preset_load_file(&project.preset, input_path)) {
+        ok = has_extension(output_path, PRESET_BINARY_EXTENSION)
+                 ? preset_save_binary(&project.preset, output_path)
+                 : preset_save_file(&project.preset, output_path, true);
+    } else {
+        fprintf(stderr, "❌ Failed to load '%s'\n", input_path);
+        return 1;
+    }
+    if (!ok) {
+        fprintf(stderr, "❌ Failed to write '%s'\n", output_path);
+        return 1;
+    }
+    printf("✅ Converted %s -> %s\n", input_path, output_path);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && strcmp(argv[1], "--convert") == 0) {
+        return run_convert(argv[2], argv[3]);
+    }
+
+    const char* project_path = NULL;
+    const char* preset_path = NULL;
+    const char* batch_dir = NULL;
+    int threads = 0;
+    char** inputs = (char**)calloc((size_t)argc, sizeof(char*));
+    int input_count = 0;
+    OfflineRenderOptions options;
+    offline_render_options_init(&options);
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "-p") == 0 && has_value) {
+            preset_path = argv[++i];
+        } else if (strcmp(arg, "-o") == 0 && has_value) {
+            options.output_path = argv[++i];
+        } else if (strcmp(arg, "-d") == 0 && has_value) {
+            options.duration_seconds = (float)atof(argv[++i]);
+        } else if (strcmp(arg, "-r") == 0 && has_value) {
+            options.sample_rate = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(arg, "--batch") == 0 && has_value) {
+            batch_dir = argv[++i];
+        } else if (strcmp(arg, "-j") == 0 && has_value) {
+            threads = atoi(argv[++i]);
+        } else if (arg[0] != '-') {
+            inputs[input_count++] = argv[i];
+        } else {
+            usage(argv[0]);
+            free(inputs);
+            return 1;
+        }
+    }
+
+    if (batch_dir) {
+        int status = 1;
+        if (input_count > 0 && !preset_path && !options.output_path) {
+            status = run_batch(batch_dir, inputs, input_count, &options, threads);
+        } else {
+            usage(argv[0]);
+        }
+        free(inputs);
+        return status;
+    }
+
+    if (input_count > 1) {
+        usage(argv[0]);
+        free(inputs);
+        return 1;
+    }
+    project_path = input_count == 1 ? inputs[0] : NULL;
+    free(inputs);
+    if (!project_path && !preset_path) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ProjectData project;
+    project_init(&project);
+    if (project_path && !project_load_file(&project, project_path)) {
+        fprintf(stderr, "❌ Failed to load project '%s'\n", project_path);
+        return 1;
+    }
+    if (preset_path) {
+        if (!preset_load_file(&project.preset, preset_path)) {
+            fprintf(stderr, "❌ Failed to load preset '%s'\n", preset_path);
+            return 1;
+        }
+        if (!project_path) {
+            project.tempo = project.preset.tempo;
+        }
+    }
+
+    OfflineRenderStats stats;
+    if (!offline_render_project(&project, &options, &stats)) {
+        return 1;
+    }
+
+    const char* output = options.output_path ? options.output_path : project.export_path;
+    uint32_t rate = options.sample_rate ? options.sample_rate : OFFLINE_RENDER_DEFAULT_RATE;
+    double seconds = (double)stats.frames / rate;
+    printf("✅ Rendered %.2f s to %s in %.3f s (%.0fx real time, peak %.3f)\n",
+           seconds, output, stats.render_seconds,
+           stats.render_seconds > 0.0 ? seconds / stats.render_seconds : 0.0, stats.peak);
+    return 0;
+}
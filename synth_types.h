@@ -24,6 +24,7 @@ typedef struct {
         int   i;
         int   b;
     } value;
+    uint64_t sample_frame; // Engine frame to apply at (0 = start of next block)
 } ParamMsg;
 
 static inline float param_msg_get_float(const ParamMsg* msg) {
@@ -69,8 +70,9 @@ typedef enum {
     MIDI_EVENT_NOTE_OFF,
     MIDI_EVENT_CONTROL_CHANGE,
     MIDI_EVENT_PITCH_BEND,
-    MIDI_EVENT_AFTERTOUCH,
-    MIDI_EVENT_PROGRAM_CHANGE
+    MIDI_EVENT_AFTERTOUCH,          // Channel pressure (data2)
+    MIDI_EVENT_PROGRAM_CHANGE,
+    MIDI_EVENT_POLY_AFTERTOUCH      // Per-note pressure: note in data1, value in data2
 } MidiEventType;
 
 typedef struct {
@@ -78,13 +80,15 @@ typedef struct {
     uint8_t channel;
     uint8_t data1;   // note/cc/program or LSB for pitch bend
     uint8_t data2;   // velocity/value/MSB for pitch bend
+    uint64_t sample_frame; // Engine frame to apply at (0 = start of next block)
+    uint64_t host_time_ns; // Driver timestamp on the rt_stats_now_ns() clock (0 = none)
 } MidiEvent;
 
 typedef struct {
     uint64_t sample_frame; // absolute frame at which to trigger
     uint8_t note;
-    uint8_t velocity;
-    uint8_t length_frames;
+    uint8_t velocity;      // 1-127; 0 = note off
+    uint32_t length_frames; // Note-ons: frames until the matching note-off
 } SeqEvent;
 
 #endif // SYNTH_TYPES_H
@@ -4,7 +4,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dsp_math.h"
+#include "fx_rack.h"
 #include "synth_engine.h"
+#include "wavetable.h"
 
 #define SAMPLE_RATE 44100
 #define SHORT_FRAMES 4096
@@ -21,149 +24,13 @@ typedef struct {
     char detail[256];
 } TestResult;
 
-static float lerpf(float a, float b, float t) {
-    return a + (b - a) * t;
-}
-
-typedef struct {
-    bool enabled;
-    float drive;
-    float mix;
-} TestDistortion;
-
-static void fx_distortion_process_buffer(TestDistortion* fx, float* buffer, int frames) {
-    if (!fx->enabled) {
-        return;
-    }
-    for (int i = 0; i < frames; i++) {
-        float left = buffer[i * 2];
-        float right = buffer[i * 2 + 1];
-        float left_wet = tanhf(left * fx->drive);
-        float right_wet = tanhf(right * fx->drive);
-        buffer[i * 2] = lerpf(left, left_wet, fx->mix);
-        buffer[i * 2 + 1] = lerpf(right, right_wet, fx->mix);
-    }
-}
-
-typedef struct {
-    bool enabled;
-    float* buffer_l;
-    float* buffer_r;
-    int size;
-    int write_pos;
-    int delay_samples;
-    float feedback;
-    float mix;
-} TestDelay;
-
-static void fx_delay_init(TestDelay* fx, float max_seconds) {
-    memset(fx, 0, sizeof(TestDelay));
-    fx->size = (int)(SAMPLE_RATE * max_seconds);
-    if (fx->size < 2) {
-        fx->size = 2;
-    }
-    fx->buffer_l = (float*)calloc(fx->size, sizeof(float));
-    fx->buffer_r = (float*)calloc(fx->size, sizeof(float));
-}
-
-static void fx_delay_free(TestDelay* fx) {
-    free(fx->buffer_l);
-    free(fx->buffer_r);
-    fx->buffer_l = fx->buffer_r = NULL;
-}
-
-static void fx_delay_set(TestDelay* fx, float time_seconds, float feedback, float mix) {
-    fx->delay_samples = (int)(time_seconds * SAMPLE_RATE);
-    if (fx->delay_samples >= fx->size) {
-        fx->delay_samples = fx->size - 1;
-    }
-    if (fx->delay_samples < 1) {
-        fx->delay_samples = 1;
-    }
-    fx->feedback = feedback;
-    fx->mix = mix;
-}
-
-static void fx_delay_process_buffer(TestDelay* fx, float* buffer, int frames) {
-    if (!fx->enabled || !fx->buffer_l || !fx->buffer_r) {
-        return;
-    }
-    for (int i = 0; i < frames; i++) {
-        float left = buffer[i * 2];
-        float right = buffer[i * 2 + 1];
-
-        int read_pos = fx->write_pos - fx->delay_samples;
-        if (read_pos < 0) {
-            read_pos += fx->size;
-        }
-
-        float delayed_l = fx->buffer_l[read_pos];
-        float delayed_r = fx->buffer_r[read_pos];
-
-        fx->buffer_l[fx->write_pos] = left + delayed_l * fx->feedback;
-        fx->buffer_r[fx->write_pos] = right + delayed_r * fx->feedback;
-
-        buffer[i * 2] = lerpf(left, delayed_l, fx->mix);
-        buffer[i * 2 + 1] = lerpf(right, delayed_r, fx->mix);
-
-        fx->write_pos = (fx->write_pos + 1) % fx->size;
-    }
-}
-
-typedef struct {
-    bool enabled;
-    float* buffer;
-    int size;
-    int write_pos;
-    int tap_offset;
-    float damping;
-    float mix;
-} TestReverb;
-
-static void fx_reverb_init(TestReverb* fx, float max_seconds) {
-    memset(fx, 0, sizeof(TestReverb));
-    fx->size = (int)(SAMPLE_RATE * max_seconds);
-    if (fx->size < 2) {
-        fx->size = 2;
-    }
-    fx->buffer = (float*)calloc(fx->size, sizeof(float));
-}
-
-static void fx_reverb_free(TestReverb* fx) {
-    free(fx->buffer);
-    fx->buffer = NULL;
-}
-
-static void fx_reverb_set(TestReverb* fx, float size_factor, float damping, float mix) {
-    if (size_factor < 0.1f) size_factor = 0.1f;
-    if (size_factor > 0.95f) size_factor = 0.95f;
-    fx->tap_offset = (int)(size_factor * (float)fx->size);
-    if (fx->tap_offset < 1) {
-        fx->tap_offset = 1;
-    }
-    fx->damping = damping;
-    fx->mix = mix;
-}
-
-static void fx_reverb_process_buffer(TestReverb* fx, float* buffer, int frames) {
-    if (!fx->enabled || !fx->buffer) {
-        return;
-    }
-    for (int i = 0; i < frames; i++) {
-        float input = 0.5f * (buffer[i * 2] + buffer[i * 2 + 1]);
-        fx->buffer[fx->write_pos] = input + fx->buffer[fx->write_pos] * fx->damping;
-
-        int read_pos = fx->write_pos - fx->tap_offset;
-        if (read_pos < 0) {
-            read_pos += fx->size;
-        }
-
-        float reverb_out = fx->buffer[read_pos];
-        buffer[i * 2] = lerpf(buffer[i * 2], reverb_out, fx->mix);
-        buffer[i * 2 + 1] = lerpf(buffer[i * 2 + 1], reverb_out, fx->mix);
-
-        fx->write_pos = (fx->write_pos + 1) % fx->size;
+// The production rack with only `type` in its chain; free with fx_rack_free()
+static bool checklist_fx_rack(EffectsRack* rack, FxType type) {
+    fx_rack_init(rack);
+    if (!fx_rack_prepare(rack, SAMPLE_RATE)) {
+        return false;
     }
+    return fx_rack_set_order(rack, &type, 1);
 }
 
 static BufferStats compute_stats(const float* buffer, int frames) {
@@ -189,25 +56,21 @@ static BufferStats compute_stats(const float* buffer, int frames) {
 }
 
 static void set_all_waveforms(SynthEngine* synth, WaveformType wave) {
-    for (int i = 0; i < MAX_VOICES; i++) {
-        synth->voices[i].osc1.waveform = wave;
-        synth->voices[i].osc2.waveform = wave;
-    }
+    synth->params[PARAM_OSC1_WAVE] = (float)wave;
+    synth->params[PARAM_OSC2_WAVE] = (float)wave;
 }
 
 static void set_unison(SynthEngine* synth, int voices, float detune) {
-    for (int i = 0; i < MAX_VOICES; i++) {
-        synth->voices[i].osc1.unison_voices = voices;
-        synth->voices[i].osc1.detune_cents = detune;
-        synth->voices[i].osc2.unison_voices = voices;
-        synth->voices[i].osc2.detune_cents = detune;
-    }
+    synth->params[PARAM_OSC1_UNISON] = (float)voices;
+    synth->params[PARAM_OSC1_FINE] = detune;
+    synth->params[PARAM_OSC2_UNISON] = (float)voices;
+    synth->params[PARAM_OSC2_FINE] = detune;
 }
 
 static void set_filter(SynthEngine* synth, float cutoff, float resonance) {
-    for (int i = 0; i < MAX_VOICES; i++) {
-        synth->voices[i].filter.cutoff = cutoff;
-        synth->voices[i].filter.resonance = resonance;
+    synth->params[PARAM_FILTER_CUTOFF] = cutoff;
+    synth->params[PARAM_FILTER_RESONANCE] = resonance;
+    for (int i = 0; i < synth->polyphony; i++) {
         synth->voices[i].filter.low = 0.0f;
         synth->voices[i].filter.high = 0.0f;
         synth->voices[i].filter.band = 0.0f;
@@ -216,12 +79,10 @@ static void set_filter(SynthEngine* synth, float cutoff, float resonance) {
 }
 
 static void set_amp_env(SynthEngine* synth, float attack, float decay, float sustain, float release) {
-    for (int i = 0; i < MAX_VOICES; i++) {
-        synth->voices[i].env_amp.attack = attack;
-        synth->voices[i].env_amp.decay = decay;
-        synth->voices[i].env_amp.sustain = sustain;
-        synth->voices[i].env_amp.release = release;
-    }
+    synth->params[PARAM_ENV_AMP_ATTACK] = attack;
+    synth->params[PARAM_ENV_AMP_DECAY] = decay;
+    synth->params[PARAM_ENV_AMP_SUSTAIN] = sustain;
+    synth->params[PARAM_ENV_AMP_RELEASE] = release;
 }
 
 static int frames_from_seconds(float seconds) {
@@ -361,6 +222,15 @@ static TestResult test_unison(void) {
     synth_process(&synth, unison_buf, frames);
     synth_note_off(&synth, 60);
 
+    // Cached ratios must follow detune changes; sub-voice phases run independently
+    const Oscillator* osc = &synth.voices[0].osc1;
+    bool spread_ok = osc->unison_ratios[0] < 1.0f && osc->unison_ratios[4] > 1.0f;
+    float wide_ratio = osc->unison_ratios[4];
+    set_unison(&synth, 5, 30.0f);
+    float scratch[SYNTH_BLOCK_SIZE * 2];
+    synth_process(&synth, scratch, SYNTH_BLOCK_SIZE);
+    bool cache_ok = osc->unison_ratios[4] > wide_ratio;
+
     BufferStats mono_stats = compute_stats(mono_buf, frames);
     BufferStats unison_stats = compute_stats(unison_buf, frames);
     float diff = average_abs_difference(mono_buf, unison_buf, frames);
@@ -368,9 +238,10 @@ static TestResult test_unison(void) {
     free(mono_buf);
     free(unison_buf);
 
-    bool pass = diff > 0.005f;
+    bool pass = diff > 0.005f && spread_ok && cache_ok;
     result.passed = pass;
-    snprintf(result.detail, sizeof(result.detail), "diff=%.3f mono_peak=%.3f unison_peak=%.3f", diff, mono_stats.peak, unison_stats.peak);
+    snprintf(result.detail, sizeof(result.detail), "diff=%.3f mono_peak=%.3f unison_peak=%.3f ratios=%d",
+             diff, mono_stats.peak, unison_stats.peak, spread_ok && cache_ok);
     return result;
 }
 
@@ -473,7 +344,7 @@ static TestResult test_polyphony(void) {
     free(buffer);
 
     int active = 0;
-    for (int i = 0; i < MAX_VOICES; i++) {
+    for (int i = 0; i < synth.polyphony; i++) {
         if (synth.voices[i].state != VOICE_OFF) {
             active++;
         }
@@ -485,6 +356,670 @@ static TestResult test_polyphony(void) {
     return result;
 }
 
+static TestResult test_block_render(void) {
+    TestResult result = {.name = "Block render consistency"};
+    int frames = SHORT_FRAMES;
+    float* whole = (float*)calloc(frames * 2, sizeof(float));
+    float* chunked = (float*)calloc(frames * 2, sizeof(float));
+
+    SynthEngine a;
+    synth_init(&a, (float)SAMPLE_RATE);
+    set_all_waveforms(&a, WAVE_SAW);
+    synth_note_on(&a, 60, 1.0f);
+    synth_note_on(&a, 67, 0.7f);
+    synth_process(&a, whole, frames);
+
+    SynthEngine b;
+    synth_init(&b, (float)SAMPLE_RATE);
+    set_all_waveforms(&b, WAVE_SAW);
+    synth_note_on(&b, 60, 1.0f);
+    synth_note_on(&b, 67, 0.7f);
+    for (int offset = 0; offset < frames; offset += SYNTH_BLOCK_SIZE) {
+        synth_process(&b, chunked + offset * 2, SYNTH_BLOCK_SIZE);
+    }
+
+    float diff = average_abs_difference(whole, chunked, frames);
+    BufferStats stats = compute_stats(whole, frames);
+    free(whole);
+    free(chunked);
+
+    bool pass = diff < 1e-6f && stats.rms > 0.01f && a.sample_counter == (uint64_t)frames;
+    result.passed = pass;
+    snprintf(result.detail, sizeof(result.detail), "diff=%.7f rms=%.3f", diff, stats.rms);
+    return result;
+}
+
+static void render_chord(bool simd, WaveformType wave, float* buffer, int frames) {
+    SynthEngine synth;
+    synth_init(&synth, (float)SAMPLE_RATE);
+    synth.simd_voices = simd;
+    set_all_waveforms(&synth, wave);
+    set_filter(&synth, 2000.0f, 0.4f);
+    int notes[6] = {48, 55, 60, 64, 67, 71};
+    for (int i = 0; i < 6; i++) {
+        synth_note_on(&synth, notes[i], 0.9f);
+    }
+    synth_process(&synth, buffer, frames / 2);
+    for (int i = 0; i < 6; i += 2) {
+        synth_note_off(&synth, notes[i]);
+    }
+    synth_process(&synth, buffer + (frames / 2) * 2, frames - frames / 2);
+}
+
+static TestResult test_simd_voices(void) {
+    TestResult result = {.name = "SIMD voice lanes"};
+    int frames = SHORT_FRAMES;
+    float* scalar = (float*)calloc(frames * 2, sizeof(float));
+    float* simd = (float*)calloc(frames * 2, sizeof(float));
+
+    render_chord(false, WAVE_SAW, scalar, frames);
+    render_chord(true, WAVE_SAW, simd, frames);
+    float saw_diff = average_abs_difference(scalar, simd, frames);
+
+    render_chord(false, WAVE_SQUARE, scalar, frames);
+    render_chord(true, WAVE_SQUARE, simd, frames);
+    float square_diff = average_abs_difference(scalar, simd, frames);
+    BufferStats stats = compute_stats(simd, frames);
+
+    free(scalar);
+    free(simd);
+
+    bool pass = saw_diff < 1e-5f && square_diff < 1e-5f && stats.rms > 0.01f;
+    result.passed = pass;
+    snprintf(result.detail, sizeof(result.detail), "saw_diff=%.7f square_diff=%.7f rms=%.3f",
+             saw_diff, square_diff, stats.rms);
+    return result;
+}
+
+static TestResult test_voice_pool(void) {
+    TestResult result = {.name = "Voice pool + stealing"};
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init_with_polyphony(synth, (float)SAMPLE_RATE, 64);
+    set_all_waveforms(synth, WAVE_SAW);
+    set_amp_env(synth, 0.005f, 0.05f, 0.6f, 0.05f);
+
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    for (int i = 0; i < 40; i++) {
+        synth_note_on(synth, 36 + i, 0.5f);
+    }
+    synth_process(synth, buffer, 256);
+    int sounding = synth->num_active_voices;
+
+    synth_all_notes_off(synth);
+    for (int block = 0; block < (SAMPLE_RATE * 10) / SHORT_FRAMES && synth->num_active_voices > 0; block++) {
+        synth_process(synth, buffer, SHORT_FRAMES);
+    }
+    int drained = synth->num_active_voices;
+    int free_after = synth->num_free_voices;
+    free(synth);
+
+    // Released-first stealing on a 4-voice pool
+    SynthEngine small;
+    synth_init_with_polyphony(&small, (float)SAMPLE_RATE, 4);
+    synth_set_steal_mode(&small, VOICE_STEAL_RELEASED_FIRST);
+    set_amp_env(&small, 0.005f, 0.05f, 0.6f, 1.0f);
+    for (int i = 0; i < 4; i++) {
+        synth_note_on(&small, 60 + i, 0.8f);
+    }
+    synth_process(&small, buffer, 256);
+    synth_note_off(&small, 62);
+    synth_process(&small, buffer, 256);
+    synth_note_on(&small, 72, 0.8f);
+    bool stole_released = false;
+    bool kept_oldest = false;
+    for (int i = 0; i < small.polyphony; i++) {
+        if (small.voices[i].midi_note == 72) stole_released = (i == 2);
+        if (small.voices[i].midi_note == 60) kept_oldest = true;
+    }
+    free(buffer);
+
+    bool pass = sounding == 40 && drained == 0 && free_after == 64 &&
+                stole_released && kept_oldest && small.num_active_voices == 4;
+    result.passed = pass;
+    snprintf(result.detail, sizeof(result.detail), "sounding=%d drained=%d free=%d stole_released=%d",
+             sounding, drained, free_after, stole_released);
+    return result;
+}
+
+static void render_mod_chord(bool simd, bool route, float* buffer, int frames) {
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    synth->simd_voices = simd;
+    set_all_waveforms(synth, WAVE_SQUARE);
+    set_filter(synth, 1200.0f, 0.3f);
+    if (route) {
+        mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_VELOCITY, MOD_DEST_FILTER_CUTOFF, 0.5f);
+        mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_KEYTRACK, MOD_DEST_PAN, 0.8f);
+        mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_LFO1, MOD_DEST_OSC1_PWM, 0.5f);
+        mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_LFO1, MOD_DEST_OSC2_PWM, 0.5f);
+        mod_matrix_set_source_rate(&synth->mod_matrix, MOD_SOURCE_LFO1, 4);
+    }
+    synth_note_on(synth, 48, 0.2f);
+    synth_note_on(synth, 72, 1.0f);
+    synth_process(synth, buffer, frames);
+    free(synth);
+}
+
+static TestResult test_mod_matrix(void) {
+    TestResult result = {.name = "Mod matrix routing"};
+
+    // An empty matrix evaluates nothing: LFO1 never advances
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    synth_note_on(synth, 60, 0.5f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    bool idle_free = synth->lfos[0].phase == 0.0f;
+
+    // Per-voice sources follow each voice instead of the voice average
+    mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_VELOCITY, MOD_DEST_FILTER_CUTOFF, 0.5f);
+    synth_note_on(synth, 72, 1.0f);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    float soft = 0.0f;
+    float hard = 0.0f;
+    for (int i = 0; i < synth->polyphony; i++) {
+        if (synth->voices[i].midi_note == 60) soft = synth->voices[i].mod[MOD_DEST_FILTER_CUTOFF];
+        if (synth->voices[i].midi_note == 72) hard = synth->voices[i].mod[MOD_DEST_FILTER_CUTOFF];
+    }
+    bool per_voice = fabsf(soft - 0.25f) < 1e-6f && fabsf(hard - 0.5f) < 1e-6f;
+
+    // Clearing the matrix zeroes every voice's modulation
+    mod_matrix_clear(&synth->mod_matrix);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    bool cleared = true;
+    for (int i = 0; i < synth->polyphony; i++) {
+        cleared = cleared && synth->voices[i].mod[MOD_DEST_FILTER_CUTOFF] == 0.0f;
+    }
+    free(synth);
+
+    // Routed output differs from dry and the SIMD lanes still match scalar
+    int frames = SHORT_FRAMES;
+    float* dry = (float*)calloc(frames * 2, sizeof(float));
+    float* scalar = (float*)calloc(frames * 2, sizeof(float));
+    render_mod_chord(false, false, dry, frames);
+    render_mod_chord(false, true, scalar, frames);
+    render_mod_chord(true, true, buffer, frames);
+    float routed_diff = average_abs_difference(dry, scalar, frames);
+    float simd_diff = average_abs_difference(scalar, buffer, frames);
+    free(dry);
+    free(scalar);
+    free(buffer);
+
+    result.passed = idle_free && per_voice && cleared && routed_diff > 1e-3f && simd_diff < 1e-5f;
+    snprintf(result.detail, sizeof(result.detail),
+             "idle_free=%d voice_mod=%.2f/%.2f cleared=%d routed_diff=%.4f simd_diff=%.7f",
+             idle_free, soft, hard, cleared, routed_diff, simd_diff);
+    return result;
+}
+
+static int count_rising_crossings(const float* stereo, int frames) {
+    int crossings = 0;
+    for (int i = 1; i < frames; i++) {
+        crossings += stereo[(i - 1) * 2] < 0.0f && stereo[i * 2] >= 0.0f;
+    }
+    return crossings;
+}
+
+static Voice* find_voice(SynthEngine* synth, int note) {
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        if (voice->midi_note == note) return voice;
+    }
+    return NULL;
+}
+
+// MPE: member-channel bend and poly pressure reach one note, the zone
+// master's reach all of them, and a burst of messages costs one re-read
+static TestResult test_expression(void) {
+    TestResult result = {.name = "MPE expression"};
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    synth_init(synth, (float)SAMPLE_RATE);
+    mod_matrix_add_slot(&synth->mod_matrix, MOD_SOURCE_AFTERTOUCH, MOD_DEST_FILTER_CUTOFF, 0.5f);
+
+    // MPE configuration message on the lower zone's master: 15 members
+    synth_control_change(synth, 0, 101, 0);
+    synth_control_change(synth, 0, 100, 6);
+    synth_control_change(synth, 0, 6, 15);
+    bool zoned = synth->expression.lower_members == 15 && synth->expression.bend_range[1] == 48 &&
+                 synth->expression.bend_range[0] == -1;
+
+    synth_note_on_channel(synth, 1, 60, 0.8f);
+    synth_note_on_channel(synth, 2, 67, 0.8f);
+    synth_channel_pitch_bend(synth, 1, 0.25f);            // +12 semitones on note 60 only
+    synth_poly_pressure(synth, 2, 67, 1.0f);
+    for (int i = 0; i < 1000; i++) {
+        synth_control_change(synth, 2, 74, i & 127);      // A controller burst
+    }
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    Voice* low = find_voice(synth, 60);
+    Voice* high = find_voice(synth, 67);
+    bool per_note = low && high && low->expression.bend == 12.0f && high->expression.bend == 0.0f &&
+                    low->mod[MOD_DEST_FILTER_CUTOFF] == 0.0f && high->mod[MOD_DEST_FILTER_CUTOFF] == 0.5f;
+    bool one_pass = synth->expression_serial == synth->expression.serial && high &&
+                    high->expression.timbre == (float)(999 & 127) / 127.0f;
+
+    // The master's bend (pitch_bend_range, 2 semitones) adds to every note
+    synth_pitch_bend(synth, 1.0f);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    bool master = low && high && low->expression.bend == 14.0f && high->expression.bend == 2.0f;
+
+    // RPN 0 on a member: semitones clamp to 96, CC 38 adds cents, zone-wide
+    synth_control_change(synth, 3, 101, 0);
+    synth_control_change(synth, 3, 100, 0);
+    synth_control_change(synth, 3, 6, 127);
+    bool range_clamped = synth->expression.bend_range[1] == 96.0f;
+    synth_control_change(synth, 3, 6, 12);
+    synth_control_change(synth, 3, 38, 50);
+    bool range_cents = synth->expression.bend_range[1] == 12.5f && synth->expression.bend_range[0] == -1.0f;
+
+    // Reset All Controllers puts timbre back at its centre
+    synth_control_change(synth, 2, 121, 0);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    bool reset = high && high->expression.timbre == SYNTH_TIMBRE_DEFAULT && high->expression.pressure == 0.0f;
+
+    // A note-off on another channel leaves the note playing
+    synth_note_off_channel(synth, 3, 60);
+    bool channel_off = low && low->state != VOICE_RELEASE;
+    free(synth);
+
+    // The bend moves the sound: +12 semitones doubles the pitch
+    int crossings[2];
+    for (int bent = 0; bent < 2; bent++) {
+        synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+        synth_init(synth, (float)SAMPLE_RATE);
+        set_all_waveforms(synth, WAVE_SINE);
+        synth_set_mpe_zones(synth, 15, 0);
+        synth_note_on_channel(synth, 4, 57, 1.0f);
+        synth_channel_pitch_bend(synth, 4, bent ? 0.25f : 0.0f);
+        synth_process(synth, buffer, SHORT_FRAMES);
+        crossings[bent] = count_rising_crossings(buffer, SHORT_FRAMES);
+        free(synth);
+    }
+    free(buffer);
+    float ratio = crossings[0] > 0 ? (float)crossings[1] / (float)crossings[0] : 0.0f;
+
+    result.passed = zoned && per_note && one_pass && master && range_clamped && range_cents && reset &&
+                    channel_off && fabsf(ratio - 2.0f) < 0.05f;
+    snprintf(result.detail, sizeof(result.detail),
+             "zoned=%d per_note=%d one_pass=%d master=%d rpn0=%d/%d reset=%d channel_off=%d pitch_ratio=%.3f",
+             zoned, per_note, one_pass, master, range_clamped, range_cents, reset, channel_off, ratio);
+    return result;
+}
+
+static void apply_float_param(SynthEngine* synth, ParamId id, float value) {
+    ParamMsg msg = {.id = (uint32_t)id, .type = PARAM_FLOAT, .value.f = value};
+    synth_engine_apply_param(synth, &msg);
+}
+
+static TestResult test_param_smoothing(void) {
+    TestResult result = {.name = "Parameter smoothing"};
+
+    // A 20 ms linear ramp lands exactly on its target in the block it expires
+    ParamSmoothBank bank;
+    param_smooth_init(&bank, (float)SAMPLE_RATE);
+    param_smooth_snap(&bank, PARAM_MASTER_VOLUME, 1.0f);
+    param_smooth_set_target(&bank, PARAM_MASTER_VOLUME, 0.0f);
+    int blocks = 0;
+    while (bank.num_moving > 0 && blocks < 1000) {
+        param_smooth_advance(&bank, SYNTH_BLOCK_SIZE, NULL, NULL);
+        blocks++;
+    }
+    int ramp_frames = (int)(0.02f * SAMPLE_RATE);
+    bool linear_ok = blocks == (ramp_frames + SYNTH_BLOCK_SIZE - 1) / SYNTH_BLOCK_SIZE &&
+                     param_smooth_get(&bank, PARAM_MASTER_VOLUME)->current == 0.0f;
+
+    // Volume cut: no step at the change, silence once the ramp ends
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    set_all_waveforms(synth, WAVE_SINE);
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    synth_note_on(synth, 69, 1.0f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    float last = buffer[(SHORT_FRAMES - 1) * 2];
+    apply_float_param(synth, PARAM_MASTER_VOLUME, 0.0f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    float first_step = fabsf(buffer[0] - last);
+    float tail_peak = 0.0f;
+    for (int i = ramp_frames + SYNTH_BLOCK_SIZE; i < SHORT_FRAMES; i++) {
+        tail_peak = fmaxf(tail_peak, fabsf(buffer[i * 2]));
+    }
+
+    // Cutoff glides (one-pole) instead of jumping, then settles on target
+    apply_float_param(synth, PARAM_MASTER_VOLUME, 0.7f);
+    apply_float_param(synth, PARAM_FILTER_CUTOFF, 200.0f);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    float cutoff_after_block = synth->voices[0].filter.cutoff;
+    for (int i = 0; i < 4; i++) {
+        synth_process(synth, buffer, SHORT_FRAMES);
+    }
+    float cutoff_settled = synth->voices[0].filter.cutoff;
+
+    // Snapping finishes ramps immediately
+    apply_float_param(synth, PARAM_FILTER_RESONANCE, 0.8f);
+    synth_snap_params(synth);
+    bool snapped = synth->params[PARAM_FILTER_RESONANCE] == 0.8f && synth->smoothing.num_moving == 0;
+    free(buffer);
+    free(synth);
+
+    result.passed = linear_ok && first_step < 0.05f && tail_peak == 0.0f &&
+                    cutoff_after_block > 1000.0f && cutoff_settled == 200.0f && snapped;
+    snprintf(result.detail, sizeof(result.detail),
+             "ramp_blocks=%d step=%.4f tail=%.4f cutoff=%.0f->%.0f snapped=%d",
+             blocks, first_step, tail_peak, cutoff_after_block, cutoff_settled, snapped);
+    return result;
+}
+
+static TestResult test_param_table(void) {
+    TestResult result = {.name = "Parameter table"};
+
+    // Every id has a named, in-range descriptor that find() resolves back
+    bool table_ok = true;
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        const SynthParamDesc* desc = synth_param_desc((ParamId)i);
+        if (!desc || !desc->name || synth_param_find(desc->name) != (ParamId)i ||
+            desc->min_value > desc->max_value ||
+            desc->default_value < desc->min_value || desc->default_value > desc->max_value) {
+            table_ok = false;
+        }
+    }
+    table_ok = table_ok && synth_param_desc(PARAM_PARAM_COUNT) == NULL &&
+               synth_param_find("no_such_param") == PARAM_PARAM_COUNT &&
+               synth_param_clamp(PARAM_FILTER_MODE, 2.6f) == 3.0f &&
+               synth_param_clamp(PARAM_ENV_AMP_RELEASE, 99.0f) == 5.0f;
+
+    // A voice-scope change is one store; sounding voices pick it up at render
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    float buffer[SYNTH_BLOCK_SIZE * 2];
+    synth_note_on(synth, 60, 1.0f);
+    synth_note_on(synth, 64, 1.0f);
+    apply_float_param(synth, PARAM_ENV_AMP_ATTACK, 0.25f);
+    bool stored = synth->params[PARAM_ENV_AMP_ATTACK] == 0.25f;
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    bool voices_read = true;
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        voices_read = voices_read && synth->voices[synth->active_voices[k]].env_amp.attack == 0.25f;
+    }
+
+    // Ranges come from the table; host-scope ids are left to the host
+    apply_float_param(synth, PARAM_TEMPO, 1000.0f);
+    ParamMsg fx = {.id = PARAM_FX_DELAY_MIX, .type = PARAM_FLOAT};
+    fx.value.f = 0.5f;
+    bool host_ignored = !synth_engine_apply_param(synth, &fx);
+    bool tempo_clamped = synth->tempo == 300.0f && synth->params[PARAM_TEMPO] == 300.0f;
+    free(synth);
+
+    result.passed = table_ok && stored && voices_read && host_ignored && tempo_clamped;
+    snprintf(result.detail, sizeof(result.detail),
+             "table=%d stored=%d voices=%d host=%d tempo=%d",
+             table_ok, stored, voices_read, host_ignored, tempo_clamped);
+    return result;
+}
+
+static TestResult test_patch_swap(void) {
+    TestResult result = {.name = "Patch swap"};
+
+    SynthPatch patch;
+    synth_patch_init(&patch);
+    patch.params[PARAM_FILTER_CUTOFF] = 300.0f;
+    patch.params[PARAM_ENV_AMP_RELEASE] = 2.0f;
+    patch.params[PARAM_FX_DELAY_MIX] = 0.9f;
+    patch.params[PARAM_PANIC] = 1.0f;
+
+    // Hold: the sounding note keeps the old patch, a new note takes the new
+    // one, and no ramp drags the store back
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    synth_note_on(synth, 60, 1.0f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    float old_cutoff = synth->voices[0].filter.cutoff;
+    synth_load_patch(synth, &patch);
+    synth_note_on(synth, 64, 1.0f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    const Voice* held = &synth->voices[synth->active_voices[0]];
+    const Voice* fresh = &synth->voices[synth->active_voices[1]];
+    bool hold_ok = held->patch_held && held->filter.cutoff == old_cutoff &&
+                   !fresh->patch_held && fresh->filter.cutoff == 300.0f &&
+                   fresh->env_amp.release == 2.0f &&
+                   synth->params[PARAM_FX_DELAY_MIX] == 0.9f &&
+                   synth->num_active_voices == 2; // Panic is never part of a patch
+
+    // Crossfade: the held note moves to the new cutoff over the fade time
+    synth_patch_init(&patch);
+    patch.params[PARAM_FILTER_CUTOFF] = 1000.0f;
+    patch.transition = SYNTH_PATCH_CROSSFADE;
+    patch.fade_seconds = 0.05f;
+    synth_init(synth, (float)SAMPLE_RATE);
+    synth_note_on(synth, 60, 1.0f);
+    synth_process(synth, buffer, SYNTH_BLOCK_SIZE);
+    synth_load_patch(synth, &patch);
+    int fade_frames = (int)(0.05f * SAMPLE_RATE);
+    synth_process(synth, buffer, fade_frames / 2);
+    float mid_cutoff = synth->voices[0].filter.cutoff;
+    synth_process(synth, buffer, fade_frames);
+    float end_cutoff = synth->voices[0].filter.cutoff;
+    bool fade_ok = mid_cutoff < 8000.0f && mid_cutoff > 1000.0f && end_cutoff == 1000.0f &&
+                   !synth->voices[0].patch_held;
+
+    // Blending switches int params halfway and interpolates floats
+    SynthPatch a;
+    SynthPatch b;
+    SynthPatch mix;
+    synth_patch_init(&a);
+    synth_patch_init(&b);
+    b.params[PARAM_FILTER_MODE] = FILTER_HP;
+    b.params[PARAM_FILTER_RESONANCE] = 1.0f;
+    synth_patch_blend(&mix, &a, &b, 0.25f);
+    bool blend_ok = mix.params[PARAM_FILTER_MODE] == FILTER_LP &&
+                    fabsf(mix.params[PARAM_FILTER_RESONANCE] - 0.475f) < 1e-5f;
+    synth_patch_blend(&mix, &a, &b, 0.75f);
+    blend_ok = blend_ok && mix.params[PARAM_FILTER_MODE] == FILTER_HP;
+    free(buffer);
+    free(synth);
+
+    result.passed = hold_ok && fade_ok && blend_ok;
+    snprintf(result.detail, sizeof(result.detail),
+             "hold=%d fade=%.0f->%.0f blend=%d", hold_ok, mid_cutoff, end_cutoff, blend_ok);
+    return result;
+}
+
+static TestResult test_envelope_segments(void) {
+    TestResult result = {.name = "Envelope segments"};
+
+    // Block and per-sample forms run the same segments, including a
+    // parameter written mid-note (coefficients are recomputed lazily)
+    Envelope block_env;
+    Envelope sample_env;
+    envelope_init(&block_env);
+    block_env.attack = 0.005f;
+    block_env.decay = 0.02f;
+    block_env.sustain = 0.5f;
+    block_env.release = 0.005f;
+    sample_env = block_env;
+    envelope_trigger(&block_env, 1.0f);
+    envelope_trigger(&sample_env, 1.0f);
+    float levels[SYNTH_BLOCK_SIZE];
+    float block_diff = 0.0f;
+    int block_frames = 0;
+    for (int b = 0; b < 200; b++) {
+        if (b == 20) {
+            block_env.sustain = sample_env.sustain = 0.3f;
+        }
+        if (b == 100) {
+            envelope_release(&block_env);
+            envelope_release(&sample_env);
+        }
+        int rendered = envelope_process_block(&block_env, levels, SYNTH_BLOCK_SIZE, (float)SAMPLE_RATE);
+        block_frames += rendered;
+        for (int n = 0; n < SYNTH_BLOCK_SIZE; n++) {
+            block_diff = fmaxf(block_diff, fabsf(levels[n] - envelope_process(&sample_env, (float)SAMPLE_RATE)));
+        }
+    }
+    bool finished = !envelope_is_active(&block_env) && !envelope_is_active(&sample_env);
+
+    // Attack lands on the velocity-scaled peak in exactly the attack time
+    Envelope attack_env;
+    envelope_init(&attack_env);
+    attack_env.attack = 0.01f;
+    attack_env.velocity_sensitivity = 1.0f;
+    envelope_trigger(&attack_env, 0.8f);
+    int attack_frames = 0;
+    while (attack_env.state == ENV_ATTACK && attack_frames < SAMPLE_RATE) {
+        envelope_process(&attack_env, (float)SAMPLE_RATE);
+        attack_frames++;
+    }
+    int expected = (int)(0.01f * SAMPLE_RATE);
+    bool attack_ok = abs(attack_frames - expected) <= 1 && fabsf(attack_env.current_level - 0.8f) < 1e-6f;
+
+    // With no filter env amount, pitch env depth or routes, those envelopes
+    // are skipped; the note itself is unchanged
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init(synth, (float)SAMPLE_RATE);
+    set_all_waveforms(synth, WAVE_SAW);
+    for (int i = 0; i < synth->polyphony; i++) {
+        synth->voices[i].pitch_env_amount = 0.0f;
+    }
+    float* buffer = (float*)calloc(SHORT_FRAMES * 2, sizeof(float));
+    synth_note_on(synth, 60, 1.0f);
+    synth_process(synth, buffer, SHORT_FRAMES);
+    BufferStats stats = compute_stats(buffer, SHORT_FRAMES);
+    bool skipped = synth->voices[0].env_filter.current_level == 0.0f &&
+                   synth->voices[0].env_pitch.current_level == 0.0f &&
+                   synth->voices[0].env_amp.current_level > 0.0f;
+    free(buffer);
+    free(synth);
+
+    result.passed = block_diff == 0.0f && finished && block_frames > 100 * SYNTH_BLOCK_SIZE &&
+                    attack_ok && skipped && stats.rms > 0.05f;
+    snprintf(result.detail, sizeof(result.detail),
+             "block_diff=%.7f finished=%d attack_frames=%d/%d skipped=%d rms=%.3f",
+             block_diff, finished, attack_frames, expected, skipped, stats.rms);
+    return result;
+}
+
+// Energy in DFT bins that are not harmonics of bin `fundamental_bin`,
+// relative to the total. frames must be a whole number of periods.
+static float inharmonic_energy_ratio(const float* signal, int frames, int fundamental_bin) {
+    double inharmonic = 0.0;
+    double total = 0.0;
+    for (int bin = 1; bin < frames / 2; bin++) {
+        double re = 0.0;
+        double im = 0.0;
+        for (int n = 0; n < frames; n++) {
+            double angle = 2.0 * 3.14159265358979323846 * (double)bin * (double)n / (double)frames;
+            re += signal[n] * cos(angle);
+            im -= signal[n] * sin(angle);
+        }
+        double energy = re * re + im * im;
+        total += energy;
+        if (bin % fundamental_bin != 0) {
+            inharmonic += energy;
+        }
+    }
+    return total > 0.0 ? (float)(inharmonic / total) : 0.0f;
+}
+
+static float render_osc_alias(WaveformType wave, bool band_limited, const WavetableMip* mip,
+                              int frames, int fundamental_bin) {
+    Oscillator osc;
+    osc_init(&osc, (float)SAMPLE_RATE);
+    osc.waveform = wave;
+    osc.band_limited = band_limited;
+    osc.wavetable_mip = mip;
+    osc.frequency = (float)fundamental_bin * (float)SAMPLE_RATE / (float)frames;
+
+    float* signal = (float*)calloc(frames, sizeof(float));
+    for (int n = 0; n < frames; n++) {
+        signal[n] = osc_process(&osc, (float)SAMPLE_RATE, 0.0f);
+    }
+    float ratio = inharmonic_energy_ratio(signal, frames, fundamental_bin);
+    free(signal);
+    return ratio;
+}
+
+static TestResult test_band_limited_oscs(void) {
+    TestResult result = {.name = "Band-limited oscillators"};
+    // Prime bin count so aliased partials never land on harmonic bins (~3.6 kHz)
+    const int frames = 2048;
+    const int bin = 167;
+
+    float saw_naive = render_osc_alias(WAVE_SAW, false, NULL, frames, bin);
+    float saw_blep = render_osc_alias(WAVE_SAW, true, NULL, frames, bin);
+    float square_naive = render_osc_alias(WAVE_SQUARE, false, NULL, frames, bin);
+    float square_blep = render_osc_alias(WAVE_SQUARE, true, NULL, frames, bin);
+    float tri_naive = render_osc_alias(WAVE_TRIANGLE, false, NULL, frames, bin);
+    float tri_blamp = render_osc_alias(WAVE_TRIANGLE, true, NULL, frames, bin);
+
+    float table[WAVETABLE_SIZE];
+    for (int i = 0; i < WAVETABLE_SIZE; i++) {
+        table[i] = 2.0f * (float)i / (float)WAVETABLE_SIZE - 1.0f;
+    }
+    WavetableMip mip;
+    bool built = wavetable_mip_build(&mip, table, WAVETABLE_SIZE);
+    float table_mip = built ? render_osc_alias(WAVE_WAVETABLE, true, &mip, frames, bin) : 1.0f;
+    wavetable_mip_free(&mip);
+
+    bool pass = built &&
+                saw_blep < saw_naive * 0.25f &&
+                square_blep < square_naive * 0.25f &&
+                tri_blamp < tri_naive * 0.25f &&
+                table_mip < saw_naive * 0.25f;
+    result.passed = pass;
+    snprintf(result.detail, sizeof(result.detail),
+             "alias saw %.4f->%.4f square %.4f->%.4f tri %.5f->%.5f table %.4f",
+             saw_naive, saw_blep, square_naive, square_blep, tri_naive, tri_blamp, table_mip);
+    return result;
+}
+
+static TestResult test_fast_math(void) {
+    TestResult result = {.name = "Fast-math kernels"};
+    dsp_math_init();
+
+    float exp2_err = 0.0f;
+    float sin_err = 0.0f;
+    float tanh_err = 0.0f;
+    float pan_err = 0.0f;
+    float svf_err = 0.0f;
+    const int steps = 20000;
+    for (int i = 0; i <= steps; i++) {
+        float t = (float)i / (float)steps;
+
+        float x = -126.0f + 252.0f * t;
+        float rel = fabsf(dsp_fast_exp2f(x) / dsp_ref_exp2f(x) - 1.0f);
+        if (rel > exp2_err) exp2_err = rel;
+
+        float phase = -4.0f + 8.0f * t;
+        // Double-precision reference: sinf(phase * 2pi) rounds the argument
+        float e = (float)fabs(dsp_fast_sin_turns(phase) - sin(6.283185307179586 * (double)phase));
+        if (e > sin_err) sin_err = e;
+
+        float y = -8.0f + 16.0f * t;
+        e = fabsf(dsp_fast_tanhf(y) - dsp_ref_tanhf(y));
+        if (e > tanh_err) tanh_err = e;
+
+        float pan = -1.0f + 2.0f * t;
+        float fl, fr, rl, rr;
+        dsp_fast_pan(pan, &fl, &fr);
+        dsp_ref_pan(pan, &rl, &rr);
+        e = fmaxf(fabsf(fl - rl), fabsf(fr - rr));
+        if (e > pan_err) pan_err = e;
+
+        float normalized = 0.5f * t;
+        e = (float)fabs(dsp_fast_svf_f(normalized) - 2.0 * sin(3.141592653589793 * (double)normalized));
+        if (e > svf_err) svf_err = e;
+    }
+
+    bool pass = exp2_err < 2e-7f && sin_err < 5e-7f && tanh_err < 1e-5f && pan_err < 1e-5f &&
+                svf_err < 2e-6f;
+    result.passed = pass;
+    snprintf(result.detail, sizeof(result.detail),
+             "engine=%s exp2=%.1e sin=%.1e tanh=%.1e pan=%.1e svf=%.1e",
+             DSP_MATH_MODE, exp2_err, sin_err, tanh_err, pan_err, svf_err);
+    return result;
+}
+
 static TestResult test_master_volume(void) {
     TestResult result = {.name = "Master volume scaling"};
     BufferStats unity = render_note(WAVE_SINE, 0.2f, 1.0f);
@@ -496,6 +1031,58 @@ static TestResult test_master_volume(void) {
     return result;
 }
 
+// After the last voice and the master tail, blocks come from the idle path
+// (zeros, idle_frames no longer counting) and the limiter is back at rest
+static TestResult test_idle_silence(void) {
+    TestResult result = {.name = "Idle silence fast path"};
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    static float block[SYNTH_BLOCK_SIZE * 2];
+    synth_init(synth, SAMPLE_RATE);
+    synth_set_limiter_lookahead(synth, 2.0f);
+    const int notes[3] = {48, 55, 64};
+    for (int n = 0; n < 3; n++) {
+        synth_note_on(synth, notes[n], 1.0f);
+    }
+    for (int f = 0; f < frames_from_seconds(0.3f); f += SYNTH_BLOCK_SIZE) {
+        synth_process(synth, block, SYNTH_BLOCK_SIZE);
+    }
+    for (int n = 0; n < 3; n++) {
+        synth_note_off(synth, notes[n]);
+    }
+    int release_frames = 0;
+    while (synth->num_active_voices > 0 && release_frames < frames_from_seconds(5.0f)) {
+        synth_process(synth, block, SYNTH_BLOCK_SIZE);
+        release_frames += SYNTH_BLOCK_SIZE;
+    }
+    for (int f = 0; f < frames_from_seconds(0.5f); f += SYNTH_BLOCK_SIZE) {
+        synth_process(synth, block, SYNTH_BLOCK_SIZE);
+    }
+    uint32_t idle_frames = synth->idle_frames;
+    bool zeros = true;
+    for (int f = 0; f < frames_from_seconds(1.0f); f += SYNTH_BLOCK_SIZE) {
+        synth_process(synth, block, SYNTH_BLOCK_SIZE);
+        for (int i = 0; i < SYNTH_BLOCK_SIZE * 2; i++) {
+            zeros = zeros && block[i] == 0.0f;
+        }
+    }
+    bool fast_path = idle_frames > 0 && synth->idle_frames == idle_frames;
+    bool at_rest = synth->limiter.gain == 1.0f && synth->limiter.detector.envelope == 0.0f;
+
+    synth_note_on(synth, 60, 0.8f);
+    for (int f = 0; f < frames_from_seconds(0.05f); f += SYNTH_BLOCK_SIZE) {
+        synth_process(synth, block, SYNTH_BLOCK_SIZE);
+    }
+    BufferStats wake = compute_stats(block, SYNTH_BLOCK_SIZE);
+    bool woke = wake.rms > 0.01f && synth->idle_frames == 0;
+
+    result.passed = zeros && fast_path && at_rest && woke;
+    snprintf(result.detail, sizeof(result.detail),
+             "release=%.2fs idle_after=%u zeros=%d fast_path=%d at_rest=%d wake_rms=%.3f",
+             (float)release_frames / SAMPLE_RATE, idle_frames, zeros, fast_path, at_rest, wake.rms);
+    free(synth);
+    return result;
+}
+
 static TestResult test_distortion_effect(void) {
     TestResult result = {.name = "Distortion saturation"};
     int frames = frames_from_seconds(0.4f);
@@ -504,12 +1091,13 @@ static TestResult test_distortion_effect(void) {
     render_note_buffer(WAVE_SAW, 0.4f, 0.9f, dry);
     memcpy(wet, dry, sizeof(float) * frames * 2);
 
-    TestDistortion fx = {
-        .enabled = true,
-        .drive = 6.0f,
-        .mix = 0.8f
-    };
-    fx_distortion_process_buffer(&fx, wet, frames);
+    EffectsRack fx;
+    checklist_fx_rack(&fx, FX_DISTORTION);
+    fx.distortion.enabled = true;
+    fx.distortion.drive = 6.0f;
+    fx.distortion.mix = 0.8f;
+    fx_rack_process(&fx, wet, frames, SAMPLE_RATE);
+    fx_rack_free(&fx);
 
     BufferStats dry_stats = compute_stats(dry, frames);
     BufferStats wet_stats = compute_stats(wet, frames);
@@ -545,11 +1133,13 @@ static TestResult test_delay_effect(void) {
     float* wet = (float*)calloc(frames * 2, sizeof(float));
     memcpy(wet, dry, sizeof(float) * frames * 2);
 
-    TestDelay fx;
-    fx_delay_init(&fx, 2.0f);
-    fx.enabled = true;
-    fx_delay_set(&fx, 0.35f, 0.45f, 0.6f);
-    fx_delay_process_buffer(&fx, wet, frames);
+    EffectsRack fx;
+    checklist_fx_rack(&fx, FX_DELAY);
+    fx.delay.enabled = true;
+    fx.delay.time_ms = 350.0f;
+    fx.delay.feedback = 0.45f;
+    fx.delay.mix = 0.6f;
+    fx_rack_process(&fx, wet, frames, SAMPLE_RATE);
 
     float dry_tail = segment_rms_seconds(dry, frames, 0.9f, 0.4f);
     float wet_tail = segment_rms_seconds(wet, frames, 0.9f, 0.4f);
@@ -560,7 +1150,7 @@ static TestResult test_delay_effect(void) {
              "tail_wet=%.4f tail_dry=%.4f",
              wet_tail, dry_tail);
 
-    fx_delay_free(&fx);
+    fx_rack_free(&fx);
     free(dry);
     free(wet);
     return result;
@@ -583,11 +1173,13 @@ static TestResult test_reverb_effect(void) {
     float* wet = (float*)calloc(frames * 2, sizeof(float));
     memcpy(wet, dry, sizeof(float) * frames * 2);
 
-    TestReverb fx;
-    fx_reverb_init(&fx, 2.0f);
-    fx.enabled = true;
-        fx_reverb_set(&fx, 0.45f, 0.55f, 0.65f);
-    fx_reverb_process_buffer(&fx, wet, frames);
+    EffectsRack fx;
+    checklist_fx_rack(&fx, FX_REVERB);
+    fx.reverb.enabled = true;
+    fx.reverb.size = 0.45f;
+    fx.reverb.damping = 0.55f;
+    fx.reverb.mix = 0.65f;
+    fx_rack_process(&fx, wet, frames, SAMPLE_RATE);
 
     float dry_tail = segment_rms_seconds(dry, frames, 0.75f, 0.6f);
     float wet_tail = segment_rms_seconds(wet, frames, 0.75f, 0.6f);
@@ -598,7 +1190,7 @@ static TestResult test_reverb_effect(void) {
              "tail_wet=%.4f tail_dry=%.4f",
              wet_tail, dry_tail);
 
-    fx_reverb_free(&fx);
+    fx_rack_free(&fx);
     free(dry);
     free(wet);
     return result;
@@ -612,7 +1204,19 @@ int main(void) {
         test_filter_sweep(),
         test_adsr_behavior(),
         test_polyphony(),
+        test_block_render(),
+        test_simd_voices(),
+        test_voice_pool(),
+        test_mod_matrix(),
+        test_expression(),
+        test_param_smoothing(),
+        test_param_table(),
+        test_patch_swap(),
+        test_envelope_segments(),
+        test_band_limited_oscs(),
+        test_fast_math(),
         test_master_volume(),
+        test_idle_silence(),
         test_delay_effect(),
         test_reverb_effect(),
         test_distortion_effect()
@@ -639,6 +1243,5 @@ int main(void) {
         printf("All headless checklist tests passed.\n");
     }
 
-    printf("\nNote: FX tests model the production rack algorithms offline so they can run headlessly in CI.\n");
     return (passed == total) ? 0 : 1;
 }
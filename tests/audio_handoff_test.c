@@ -0,0 +1,111 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_handoff.h"
+
+#define STRESS_BUFFERS 20000
+
+// Audio-thread stand-in: take each command's buffer, "use" it, retire it
+static void* fake_audio_thread(void* arg) {
+    (void)arg;
+    int handled = 0;
+    while (handled < STRESS_BUFFERS) {
+        audio_retire_flush();
+        AudioHandoffMsg cmd;
+        while (audio_command_pop(&cmd)) {
+            assert(cmd.type == AUDIO_CMD_TRACK_RECORD);
+            assert(cmd.buffer && (int)cmd.buffer[0] == cmd.index && "Buffer content must survive the handoff");
+            audio_retire_buffer(cmd.buffer);
+            handled++;
+        }
+    }
+    // Keep flushing the backlog until the UI says every retire has arrived
+    while (1) {
+        audio_retire_flush();
+        AudioHandoffMsg done;
+        if (audio_command_pop(&done) && done.type == AUDIO_CMD_SNIPPET_STOP) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    printf("Running audio_handoff tests...\n");
+    audio_handoff_init();
+
+    AudioHandoffMsg msg;
+    assert(audio_command_pop(&msg) == false && "Command queue should start empty");
+    assert(audio_event_pop(&msg) == false && "Event queue should start empty");
+
+    // FIFO ordering and payload round-trip
+    AudioHandoffMsg play = {.type = AUDIO_CMD_TRACK_TOGGLE_PLAY, .index = 2};
+    AudioHandoffMsg volume = {.type = AUDIO_CMD_TRACK_VOLUME, .index = 1, .value = 0.5f};
+    assert(audio_command_push(&play));
+    assert(audio_command_push(&volume));
+    assert(audio_command_pop(&msg) && msg.type == AUDIO_CMD_TRACK_TOGGLE_PLAY && msg.index == 2);
+    assert(audio_command_pop(&msg) && msg.type == AUDIO_CMD_TRACK_VOLUME && msg.value == 0.5f);
+
+    // Full command queue reports failure instead of blocking
+    for (int i = 0; i < AUDIO_COMMAND_QUEUE_SIZE; ++i) {
+        assert(audio_command_push(&play));
+    }
+    assert(audio_command_push(&play) == false && "Full queue should reject");
+    while (audio_command_pop(&msg)) {
+    }
+
+    // Retirements that overflow the event ring wait in the backlog
+    float dummy[AUDIO_EVENT_QUEUE_SIZE + 4];
+    for (int i = 0; i < AUDIO_EVENT_QUEUE_SIZE + 4; ++i) {
+        audio_retire_buffer(&dummy[i]);
+    }
+    int retired = 0;
+    while (audio_event_pop(&msg)) {
+        assert(msg.type == AUDIO_EVENT_RETIRE && msg.buffer == &dummy[retired]);
+        retired++;
+    }
+    assert(retired == AUDIO_EVENT_QUEUE_SIZE);
+    audio_retire_flush();
+    while (audio_event_pop(&msg)) {
+        assert(msg.buffer == &dummy[retired]);
+        retired++;
+    }
+    assert(retired == AUDIO_EVENT_QUEUE_SIZE + 4 && "Backlog must drain in order");
+
+    // Two-thread stress: every buffer handed over comes back exactly once
+    pthread_t audio;
+    pthread_create(&audio, NULL, fake_audio_thread, NULL);
+    int sent = 0;
+    int freed = 0;
+    while (freed < STRESS_BUFFERS) {
+        // Bounding the in-flight count keeps the command ring from filling
+        if (sent < STRESS_BUFFERS && sent - freed < AUDIO_COMMAND_QUEUE_SIZE / 2) {
+            float* buffer = (float*)malloc(16 * sizeof(float));
+            buffer[0] = (float)sent;
+            AudioHandoffMsg cmd = {.type = AUDIO_CMD_TRACK_RECORD, .index = sent, .buffer = buffer};
+            bool ok = audio_command_push(&cmd);
+            assert(ok);
+            (void)ok;
+            sent++;
+        }
+        while (audio_event_pop(&msg)) {
+            assert(msg.type == AUDIO_EVENT_RETIRE);
+            assert((int)msg.buffer[0] == freed && "Retires arrive in hand-off order");
+            free(msg.buffer);
+            freed++;
+        }
+    }
+    AudioHandoffMsg done = {.type = AUDIO_CMD_SNIPPET_STOP};
+    while (!audio_command_push(&done)) {
+    }
+    pthread_join(audio, NULL);
+    assert(sent == STRESS_BUFFERS && freed == STRESS_BUFFERS);
+
+    printf("audio_handoff tests passed.\n");
+    return 0;
+}
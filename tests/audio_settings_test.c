@@ -0,0 +1,88 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "audio_settings.h"
+
+// Applies every flag in `args` the way the app's main() does; false on the
+// first unknown or invalid one
+static bool parse(AudioSettings* settings, int argc, char** argv) {
+    for (int i = 0; i < argc;) {
+        int used = audio_settings_parse_arg(settings, argc, argv, i);
+        if (used <= 0) {
+            return false;
+        }
+        i += used;
+    }
+    return true;
+}
+
+int main(void) {
+    printf("Running audio_settings tests...\n");
+
+    AudioSettings settings;
+    audio_settings_init(&settings);
+    assert(settings.sample_rate == 44100 && settings.duplex && !settings.exclusive);
+    assert(settings.period_frames == 0 && settings.periods == 0 && settings.backend == AUDIO_BACKEND_AUTO);
+
+    // Backend names: case-insensitive, whole words only
+    AudioBackend backend = AUDIO_BACKEND_AUTO;
+    assert(audio_backend_from_name("JACK", &backend) && backend == AUDIO_BACKEND_JACK);
+    assert(audio_backend_from_name("wasapi", &backend) && backend == AUDIO_BACKEND_WASAPI);
+    assert(!audio_backend_from_name("alsa2", &backend) && !audio_backend_from_name("als", &backend));
+    for (int b = 0; b < AUDIO_BACKEND_COUNT; b++) {
+        assert(audio_backend_from_name(audio_backend_name((AudioBackend)b), &backend) && backend == (AudioBackend)b);
+    }
+
+    // A low-latency command line
+    char* low_latency[] = {"--rate", "48000", "--period", "64", "--periods", "2", "--backend", "alsa",
+                           "--exclusive", "--playback-only", "--realtime"};
+    bool ok = parse(&settings, 11, low_latency);
+    assert(ok);
+    assert(settings.sample_rate == 48000 && settings.period_frames == 64 && settings.periods == 2);
+    assert(settings.backend == AUDIO_BACKEND_ALSA && settings.exclusive && !settings.duplex && settings.realtime);
+
+    // Later flags win; unknown flags and bad values are reported, not guessed
+    char* back[] = {"--shared", "--duplex"};
+    ok = parse(&settings, 2, back);
+    assert(ok && !settings.exclusive && settings.duplex);
+    char* bad_values[][2] = {{"--period", "-64"}, {"--period", "64k"}, {"--rate", "1000000"},
+                             {"--periods", ""}, {"--backend", "asio"}};
+    for (int i = 0; i < 5; i++) {
+        assert(audio_settings_parse_arg(&settings, 2, bad_values[i], 0) == -1);
+    }
+    char* missing[] = {"--rate"};
+    assert(audio_settings_parse_arg(&settings, 1, missing, 0) == -1);
+    char* other[] = {"--project", "show.json"};
+    assert(audio_settings_parse_arg(&settings, 2, other, 0) == 0);
+    assert(settings.sample_rate == 48000 && settings.period_frames == 64 && "Failed flags change nothing");
+
+    // JSON round trip; missing keys keep what was there
+    cJSON* json = audio_settings_to_json(&settings);
+    AudioSettings loaded;
+    audio_settings_init(&loaded);
+    audio_settings_from_json(&loaded, json);
+    assert(memcmp(&loaded, &settings, sizeof(loaded)) == 0);
+    cJSON_Delete(json);
+    json = cJSON_Parse("{\"periodFrames\": 128, \"backend\": \"nonsense\", \"periods\": -3}");
+    audio_settings_from_json(&loaded, json);
+    cJSON_Delete(json);
+    assert(loaded.period_frames == 128 && loaded.periods == 2 && loaded.backend == AUDIO_BACKEND_ALSA);
+
+    // Latency: buffers on each side, plus a period of MIDI placement
+    AudioLatency latency;
+    audio_latency_compute(&latency, 48000, 64, 2, false, 64, 2);
+    assert(latency.output_frames == 128 && latency.input_frames == 0);
+    assert(latency.round_trip_frames == 128 && latency.midi_frames == 192);
+    assert(fabsf(audio_latency_ms(&latency, latency.midi_frames) - 4.0f) < 1e-4f);
+    audio_latency_compute(&latency, 44100, 441, 3, true, 441, 2);
+    assert(latency.input_frames == 882 && latency.round_trip_frames == 882 + 1323);
+    assert(fabsf(audio_latency_ms(&latency, latency.round_trip_frames) - 50.0f) < 1e-3f);
+    audio_latency_compute(&latency, 48000, 256, 0, true, 256, 0);
+    assert(latency.output_frames == 256 && latency.input_frames == 256 && "Unknown period counts count as one");
+
+    audio_settings_print_usage(stdout);
+    printf("audio_settings tests passed.\n");
+    return 0;
+}
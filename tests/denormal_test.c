@@ -0,0 +1,144 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "denormal.h"
+#include "fx_rack.h"
+#include "synth_core.h"
+#include "synth_engine.h"
+
+#define TEST_RATE 48000.0f
+#define TEST_BLOCK 256
+#define TEST_TAIL_BLOCKS 2500   // 13 s: past every stage's fall to zero
+
+static float left[TEST_BLOCK];
+static float right[TEST_BLOCK];
+
+static int count_subnormals(const float* samples, size_t count) {
+    int found = 0;
+    for (size_t i = 0; i < count; i++) {
+        found += fpclassify(samples[i]) == FP_SUBNORMAL;
+    }
+    return found;
+}
+
+static int count_nonzero(const float* samples, size_t count) {
+    int found = 0;
+    for (size_t i = 0; i < count; i++) {
+        found += samples[i] != 0.0f;
+    }
+    return found;
+}
+
+// One loud block, then silence. Every block's output and the final state
+// must be free of subnormals without any CPU flags set.
+static void burst(int block) {
+    for (int i = 0; i < TEST_BLOCK; i++) {
+        float level = block == 0 ? 0.8f : 0.0f;
+        left[i] = level * sinf((float)i * 0.3f);
+        right[i] = level * cosf((float)i * 0.7f);
+    }
+}
+
+static float tiny_product(void) {
+    volatile float a = 1e-30f;
+    volatile float b = 1e-10f;
+    return a * b;
+}
+
+int main(void) {
+    printf("Running denormal tests...\n");
+
+    assert(denormal_flush(1e-20f) == 0.0f && denormal_flush(-1e-20f) == 0.0f);
+    assert(denormal_flush(1e-10f) == 1e-10f && denormal_flush(-0.5f) == -0.5f);
+
+    // Flags: set, nested (no-op), restored
+    assert(fpclassify(tiny_product()) == FP_SUBNORMAL && "Tests start with the flags clear");
+    if (denormal_flags_supported()) {
+        DenormalMode outer = denormal_flush_begin();
+        assert(outer.changed);
+        assert(tiny_product() == 0.0f);
+        DenormalMode inner = denormal_flush_begin();
+        assert(!inner.changed);
+        denormal_flush_end(inner);
+        assert(tiny_product() == 0.0f);
+        denormal_flush_end(outer);
+        assert(fpclassify(tiny_product()) == FP_SUBNORMAL);
+        printf("  flush-to-zero flags: supported\n");
+    } else {
+        printf("  flush-to-zero flags: not on this CPU, guards only\n");
+    }
+
+    // Filter: per-block flush takes a low-cutoff tail to exact zero
+    {
+        Filter filter;
+        filter_init(&filter, TEST_RATE);
+        filter_update_coefficients(&filter, TEST_RATE, 30.0f, 0.5f);
+        int subnormals = 0;
+        for (int b = 0; b < TEST_TAIL_BLOCKS; b++) {
+            burst(b);
+            for (int i = 0; i < TEST_BLOCK; i++) {
+                left[i] = filter_process(&filter, left[i]);
+            }
+            filter_flush_denormals(&filter);
+            subnormals += count_subnormals(left, TEST_BLOCK);
+            subnormals += fpclassify(filter.low) == FP_SUBNORMAL;
+            subnormals += fpclassify(filter.band) == FP_SUBNORMAL;
+        }
+        assert(subnormals == 0);
+        assert(filter.low == 0.0f && filter.band == 0.0f);
+    }
+
+    // Delay and reverb at long settings: lines and damping state reach
+    // exact zero, never passing through the subnormal range
+    static EffectsRack rack;
+    fx_rack_init(&rack);
+    bool prepared = fx_rack_prepare(&rack, TEST_RATE);
+    assert(prepared);
+    (void)prepared;
+    rack.delay.enabled = true;
+    rack.delay.time_ms = 40.0f;
+    rack.delay.feedback = 0.7f;
+    rack.reverb.enabled = true;
+    rack.reverb.size = 0.2f;
+    rack.reverb.damping = 0.8f;
+    for (int quality = 0; quality < FX_REVERB_QUALITY_COUNT; quality++) {
+        rack.reverb.quality = (FxReverbQuality)quality;
+        int subnormals = 0;
+        for (int b = 0; b < TEST_TAIL_BLOCKS; b++) {
+            burst(b);
+            fx_delay_process(&rack.delay, left, right, TEST_BLOCK, TEST_RATE);
+            fx_reverb_process(&rack.reverb, left, right, TEST_BLOCK);
+            subnormals += count_subnormals(left, TEST_BLOCK) + count_subnormals(right, TEST_BLOCK);
+        }
+        size_t delay_size = rack.delay.delay_l.mask + 1;
+        size_t line_size = (size_t)rack.reverb.line_capacity * FX_REVERB_MAX_LINES;
+        subnormals += count_subnormals(rack.delay.delay_l.buffer, delay_size);
+        subnormals += count_subnormals(rack.delay.delay_r.buffer, delay_size);
+        subnormals += count_subnormals(rack.reverb.lines, line_size);
+        subnormals += count_subnormals(rack.reverb.lowpass, FX_REVERB_MAX_LINES);
+        int residue = count_nonzero(rack.delay.delay_l.buffer, delay_size) +
+                      count_nonzero(rack.reverb.lines, line_size) +
+                      count_nonzero(rack.reverb.lowpass, FX_REVERB_MAX_LINES);
+        printf("  %s reverb + delay tail: %d subnormals, %d nonzero state values left\n",
+               fx_reverb_quality_name((FxReverbQuality)quality), subnormals, residue);
+        assert(subnormals == 0 && residue == 0);
+    }
+    fx_rack_free(&rack);
+
+    // The core renders with the flags set and hands the caller's mode back
+    {
+        static SynthCore core;
+        static float out[TEST_BLOCK * 2];
+        bool ok = synth_core_init(&core, TEST_RATE, 4);
+        assert(ok);
+        (void)ok;
+        synth_core_note_on(&core, 60, 1.0f);
+        synth_core_process(&core, NULL, out, TEST_BLOCK);
+        assert(fpclassify(tiny_product()) == FP_SUBNORMAL && "Caller's mode restored");
+        synth_core_free(&core);
+    }
+
+    printf("denormal tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dynamics.h"
+#include "synth_engine.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define TEST_RATE 48000.0f
+#define TEST_FRAMES 48000
+#define TEST_THRESHOLD 0.95f
+#define TEST_STEP_FRAME 12000   // Where the level jumps
+
+static float input_l[TEST_FRAMES];
+static float input_r[TEST_FRAMES];
+static float out_l[TEST_FRAMES];
+static float out_r[TEST_FRAMES];
+
+static void run_limiter(float lookahead_ms, int chunk) {
+    static Limiter limiter;
+    limiter_init(&limiter, TEST_THRESHOLD, 0.1f);
+    limiter_set_lookahead(&limiter, lookahead_ms, TEST_RATE);
+    memcpy(out_l, input_l, sizeof(out_l));
+    memcpy(out_r, input_r, sizeof(out_r));
+    for (int start = 0; start < TEST_FRAMES; start += chunk) {
+        int n = TEST_FRAMES - start < chunk ? TEST_FRAMES - start : chunk;
+        limiter_process(&limiter, out_l + start, out_r + start, n, TEST_RATE);
+    }
+}
+
+// DC at 0.3, jumping to `high` at TEST_STEP_FRAME and back at twice that
+static void fill_step(float high) {
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        float level = i >= TEST_STEP_FRAME && i < 2 * TEST_STEP_FRAME ? high : 0.3f;
+        input_l[i] = level;
+        input_r[i] = -0.5f * level;
+    }
+}
+
+int main(void) {
+    printf("Running dynamics tests...\n");
+
+    // Block kernels match their scalar definitions at every length and offset
+    {
+        float a[37], b[37], ref_a[37], ref_b[37];
+        for (int frames = 0; frames <= 37; frames++) {
+            for (int i = 0; i < frames; i++) {
+                a[i] = ref_a[i] = sinf((float)i * 0.7f);
+                b[i] = ref_b[i] = -cosf((float)i * 1.3f) * 1.1f;
+            }
+            float peak = 0.0f;
+            for (int i = 0; i < frames; i++) {
+                peak = fmaxf(peak, fmaxf(fabsf(a[i]), fabsf(b[i])));
+            }
+            assert(dyn_peak(a, b, frames) == peak);
+
+            dyn_apply_gain_ramp(a, b, frames, 0.8f, -0.01f, 5);
+            for (int i = 0; i < frames; i++) {
+                float g = 0.8f - 0.01f * (float)(5 + i + 1);
+                assert(fabsf(a[i] - ref_a[i] * g) <= 1e-6f && fabsf(b[i] - ref_b[i] * g) <= 1e-6f);
+            }
+        }
+    }
+
+    // Zero lookahead: no latency, quiet audio untouched, loud audio clamped
+    // on the spot
+    assert(limiter_latency_frames(0.0f, TEST_RATE) == 0);
+    fill_step(0.5f);
+    run_limiter(0.0f, 64);
+    assert(memcmp(out_l, input_l, sizeof(out_l)) == 0 && "Under the threshold must be unity gain");
+    fill_step(2.0f);
+    run_limiter(0.0f, 64);
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        assert(fabsf(out_l[i]) <= TEST_THRESHOLD * 1.0001f && fabsf(out_r[i]) <= TEST_THRESHOLD * 1.0001f);
+    }
+
+    // Lookahead rounds up to whole control blocks, plus the detector's lag
+    const float lookahead_ms = 2.0f;
+    const int latency = limiter_latency_frames(lookahead_ms, TEST_RATE);
+    assert(latency == 6 * DYN_CONTROL_FRAMES + DYN_LIMITER_TRUE_PEAK_LAG);
+    assert(limiter_latency_frames(100.0f, TEST_RATE) <= DYN_LIMITER_MAX_DELAY);
+    fill_step(0.5f);
+    run_limiter(lookahead_ms, 64);
+    for (int i = latency; i < TEST_FRAMES; i++) {
+        assert(out_l[i] == input_l[i - latency] && "Quiet audio is the input, delayed");
+    }
+
+    // A jump to 1.5: the gain has ramped down by the time the step comes
+    // out, never overshoots, moves without jumps and recovers afterwards
+    fill_step(1.5f);
+    run_limiter(lookahead_ms, 64);
+    const float ceiling = TEST_THRESHOLD / 1.5f;
+    float max_out = 0.0f;
+    float max_move = 0.0f;
+    float previous = 1.0f;
+    int first_reduced = -1;
+    for (int i = latency; i < TEST_FRAMES; i++) {
+        max_out = fmaxf(max_out, fmaxf(fabsf(out_l[i]), fabsf(out_r[i])));
+        float gain = out_l[i] / input_l[i - latency];
+        if (first_reduced < 0 && gain < 0.999f) {
+            first_reduced = i;
+        }
+        max_move = fmaxf(max_move, fabsf(gain - previous));
+        previous = gain;
+    }
+    float gain_at_step = out_l[TEST_STEP_FRAME + latency] / input_l[TEST_STEP_FRAME];
+    float gain_after = out_l[TEST_FRAMES - 1] / input_l[TEST_FRAMES - 1 - latency];
+    printf("  2 ms lookahead (%d frames): ramp starts %d frames early, gain %.3f at the step "
+           "(ceiling %.3f), largest move %.4f/frame, recovered to %.3f\n",
+           latency, TEST_STEP_FRAME + latency - first_reduced, gain_at_step, ceiling, max_move, gain_after);
+    assert(max_out <= TEST_THRESHOLD * 1.0001f);
+    assert(gain_at_step <= ceiling * 1.0001f);
+    assert(first_reduced < TEST_STEP_FRAME + latency - 3 * DYN_CONTROL_FRAMES && "Attack must use the lookahead");
+    assert(max_move < (1.0f - ceiling) / (2.0f * DYN_CONTROL_FRAMES) && "No instant clamp with lookahead");
+    assert(gain_after > 0.999f);
+
+    // Call size never changes the result
+    {
+        static float ref_l[TEST_FRAMES];
+        memcpy(ref_l, out_l, sizeof(ref_l));
+        const int chunks[3] = {1, 37, 333};
+        for (int c = 0; c < 3; c++) {
+            run_limiter(lookahead_ms, chunks[c]);
+            assert(memcmp(out_l, ref_l, sizeof(ref_l)) == 0 && "Output must not depend on call size");
+        }
+    }
+
+    // fs/4 at 45 degrees: every sample sits at 0.71 of the true peak, so a
+    // 1.2 tone has sample peaks under the threshold. Only the true-peak
+    // detector (lookahead) catches it.
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        input_l[i] = input_r[i] = 1.2f * (float)sin(M_PI * 0.5 * i + M_PI * 0.25);
+    }
+    run_limiter(0.0f, 64);
+    assert(memcmp(out_l, input_l, sizeof(out_l)) == 0 && "Sample peaks alone stay under the threshold");
+    run_limiter(lookahead_ms, 64);
+    float sample_peak = 0.0f;
+    for (int i = TEST_FRAMES / 2; i < TEST_FRAMES; i++) {
+        sample_peak = fmaxf(sample_peak, fabsf(out_l[i]));
+    }
+    float true_peak = sample_peak / (float)sin(M_PI * 0.25);
+    printf("  fs/4 tone at 1.2: true peak out %.3f (threshold %.2f)\n", true_peak, TEST_THRESHOLD);
+    assert(true_peak <= TEST_THRESHOLD * 1.02f && true_peak > TEST_THRESHOLD * 0.9f);
+
+    // The engine reports the master stage's delay
+    {
+        static SynthEngine synth;
+        synth_init(&synth, TEST_RATE);
+        assert(synth_output_latency(&synth) == 0.0f);
+        synth_set_limiter_lookahead(&synth, lookahead_ms);
+        assert(synth_output_latency(&synth) == (float)latency);
+        synth_set_master_oversample(&synth, OVERSAMPLE_2X);
+        assert(synth_output_latency(&synth) == (float)latency + oversampler_latency(&synth.master_os));
+    }
+
+    printf("dynamics tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+// The checks below drive the pacer, so they must run in Release builds too
+#undef NDEBUG
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// The pacer hashes the command buffer, so build it with the app's Nuklear
+// configuration. Only the core is compiled in: no GLFW or GL backend.
+#include "nuklear_config.h"
+#include "ui/frame_pacer.h"
+#define NK_IMPLEMENTATION
+#include "nuklear.h"
+
+#define TEST_METER_HZ 30.0
+#define TEST_IDLE_HZ 4.0
+#define TEST_WIDTH 640
+#define TEST_HEIGHT 480
+
+static bool near(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+// Fixed-pitch glyphs: enough for the layout to place text
+static float text_width(nk_handle handle, float height, const char* text, int len) {
+    (void)handle;
+    (void)text;
+    return (float)len * height * 0.5f;
+}
+
+// One window with a label, like a panel of the app
+static void build_frame(struct nk_context* ctx, const char* text) {
+    if (nk_begin(ctx, "Pacer", nk_rect(0, 0, 320, 200), NK_WINDOW_BORDER)) {
+        nk_layout_row_dynamic(ctx, 20, 1);
+        nk_label(ctx, text, NK_TEXT_LEFT);
+    }
+    nk_end(ctx);
+}
+
+// Build, ask the pacer, and drop the frame the way the main loop does
+static bool frame_changed(UiFramePacer* pacer, struct nk_context* ctx, const char* text,
+                          int width, int height, bool input) {
+    build_frame(ctx, text);
+    bool changed = ui_frame_pacer_frame_changed(pacer, ctx, width, height, input);
+    nk_clear(ctx);
+    return changed;
+}
+
+int main(void) {
+    printf("Running frame_pacer tests...\n");
+
+    struct nk_user_font font;
+    memset(&font, 0, sizeof(font));
+    font.height = 13.0f;
+    font.width = text_width;
+    static struct nk_context ctx;
+    bool ready = nk_init_default(&ctx, &font);
+    assert(ready && "Nuklear context should initialize");
+    (void)ready;
+
+    // Redraw hash: identical frames hash alike, any visible change doesn't
+    build_frame(&ctx, "Voices 3");
+    uint64_t first = ui_frame_pacer_hash(&ctx);
+    nk_clear(&ctx);
+    build_frame(&ctx, "Voices 3");
+    uint64_t again = ui_frame_pacer_hash(&ctx);
+    nk_clear(&ctx);
+    build_frame(&ctx, "Voices 4");
+    uint64_t other = ui_frame_pacer_hash(&ctx);
+    nk_clear(&ctx);
+    assert(first == again && "Rebuilding the same frame must hash the same");
+    assert(first != other && "A changed label must change the hash");
+
+    UiFramePacer pacer;
+    ui_frame_pacer_init(&pacer, TEST_METER_HZ, TEST_IDLE_HZ);
+    assert(frame_changed(&pacer, &ctx, "Voices 3", TEST_WIDTH, TEST_HEIGHT, false) && "The first frame always renders");
+    for (int i = 0; i < 10; i++) {
+        assert(!frame_changed(&pacer, &ctx, "Voices 3", TEST_WIDTH, TEST_HEIGHT, false));
+    }
+    assert(pacer.frames_rendered == 1 && pacer.frames_skipped == 10);
+    assert(frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH, TEST_HEIGHT, false));
+    assert(frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH + 1, TEST_HEIGHT, false) && "Resizes render");
+    assert(!frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH + 1, TEST_HEIGHT, false));
+    ui_frame_pacer_invalidate(&pacer);
+    assert(frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH + 1, TEST_HEIGHT, false) && "Lost contents render");
+
+    // Wait time: the meter rate while animating, the idle tick otherwise
+    ui_frame_pacer_init(&pacer, TEST_METER_HZ, TEST_IDLE_HZ);
+    assert(ui_frame_pacer_wait_time(&pacer, 10.0, false) == 0.0 && "Nothing on screen yet: poll");
+    frame_changed(&pacer, &ctx, "Voices 3", TEST_WIDTH, TEST_HEIGHT, false);
+    assert(near(ui_frame_pacer_wait_time(&pacer, 10.0, true), 1.0 / TEST_METER_HZ));
+    assert(near(pacer.deadline, 10.0 + 1.0 / TEST_METER_HZ));
+    assert(near(ui_frame_pacer_wait_time(&pacer, 20.0, false), 1.0 / TEST_IDLE_HZ));
+    assert(near(pacer.deadline, 20.0 + 1.0 / TEST_IDLE_HZ));
+    assert(pacer.wakes == 3);
+
+    // An early return is input; the deadline, within a millisecond, is not
+    assert(ui_frame_pacer_woke_for_input(&pacer, 20.1));
+    assert(!ui_frame_pacer_woke_for_input(&pacer, 20.0 + 1.0 / TEST_IDLE_HZ - 0.0005));
+    assert(!ui_frame_pacer_woke_for_input(&pacer, 20.0 + 1.0 / TEST_IDLE_HZ + 0.01));
+
+    // A frame input changed earns one quick settle frame; a meter changing
+    // without input does not, or it would keep the loop at full rate
+    assert(frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH, TEST_HEIGHT, true));
+    assert(near(ui_frame_pacer_wait_time(&pacer, 30.0, false), pacer.settle_interval));
+    assert(!frame_changed(&pacer, &ctx, "Voices 4", TEST_WIDTH, TEST_HEIGHT, true) && "Settled: nothing new");
+    assert(near(ui_frame_pacer_wait_time(&pacer, 30.0, false), 1.0 / TEST_IDLE_HZ));
+    assert(frame_changed(&pacer, &ctx, "Voices 5", TEST_WIDTH, TEST_HEIGHT, false));
+    assert(near(ui_frame_pacer_wait_time(&pacer, 30.0, true), 1.0 / TEST_METER_HZ));
+
+    // Rates of 0 fall back to 30 Hz and 2 Hz
+    ui_frame_pacer_init(&pacer, 0.0, 0.0);
+    assert(near(pacer.meter_interval, 1.0 / 30.0) && near(pacer.idle_interval, 0.5));
+
+    nk_free(&ctx);
+    printf("frame_pacer tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,447 @@
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dsp_math.h"
+#include "fx_rack.h"
+
+#define TEST_RATE 44100.0f
+#define TEST_FRAMES 22050   // 0.5 s
+
+// Decaying two-tone burst with a silent tail, so delay/reverb output shows up late
+static void fill_signal(float* frames, int count) {
+    for (int i = 0; i < count; i++) {
+        float t = (float)i / TEST_RATE;
+        float env = i < count / 4 ? expf(-8.0f * t) : 0.0f;
+        frames[i * 2] = 0.6f * env * sinf(6.2831853f * 220.0f * t);
+        frames[i * 2 + 1] = 0.6f * env * sinf(6.2831853f * 330.0f * t);
+    }
+}
+
+// Run `frames` through the rack in chunks of `chunk`
+static void run_rack(EffectsRack* rack, float* frames, int count, int chunk) {
+    for (int start = 0; start < count; start += chunk) {
+        int n = count - start < chunk ? count - start : chunk;
+        fx_rack_process(rack, frames + (size_t)start * 2, n, TEST_RATE);
+    }
+}
+
+static float max_difference(const float* a, const float* b, size_t count) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        diff = fmaxf(diff, fabsf(a[i] - b[i]));
+    }
+    return diff;
+}
+
+// Fresh rack with its reverb lines sized for the test rate
+static void reset_rack(EffectsRack* rack) {
+    fx_rack_free(rack);
+    fx_rack_init(rack);
+    bool prepared = fx_rack_prepare(rack, TEST_RATE);
+    assert(prepared && "Reverb lines should allocate");
+    (void)prepared;
+}
+
+static void enable_all(EffectsRack* rack) {
+    rack->distortion.enabled = true;
+    rack->chorus.enabled = true;
+    rack->compressor.enabled = true;
+    rack->compressor.threshold = 0.2f;
+    rack->delay.enabled = true;
+    rack->delay.time_ms = 120.0f;
+    rack->reverb.enabled = true;
+}
+
+int main(void) {
+    printf("Running fx_rack tests...\n");
+    dsp_math_init();
+
+    size_t samples = (size_t)TEST_FRAMES * 2;
+    EffectsRack* rack = (EffectsRack*)calloc(1, sizeof(EffectsRack));
+    float* input = (float*)malloc(samples * sizeof(float));
+    float* a = (float*)malloc(samples * sizeof(float));
+    float* b = (float*)malloc(samples * sizeof(float));
+    assert(rack && input && a && b);
+    fill_signal(input, TEST_FRAMES);
+
+    // A fully bypassed chain leaves the block untouched
+    reset_rack(rack);
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 64);
+    assert(memcmp(a, input, samples * sizeof(float)) == 0 && "Bypassed rack must not touch audio");
+
+    // Block size never changes the result (including chunking past the scratch)
+    reset_rack(rack);
+    enable_all(rack);
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 1);
+    reset_rack(rack);
+    enable_all(rack);
+    memcpy(b, input, samples * sizeof(float));
+    run_rack(rack, b, TEST_FRAMES, FX_RACK_BLOCK_FRAMES * 3 + 7);
+    assert(memcmp(a, b, samples * sizeof(float)) == 0 && "Output must not depend on block size");
+
+    // The mask-indexed delay matches the reference modulo ring
+    reset_rack(rack);
+    rack->delay.enabled = true;
+    rack->delay.time_ms = 250.0f;
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32);
+    {
+        enum { RING = 88200 };
+        float* ring = (float*)calloc(RING, sizeof(float));
+        assert(ring);
+        int delay = (int)((250.0f / 1000.0f) * TEST_RATE);
+        int pos = 0;
+        float diff = 0.0f;
+        for (int i = 0; i < TEST_FRAMES; i++) {
+            float in = input[i * 2];
+            float delayed = ring[(pos - delay + RING) % RING];
+            ring[pos] = in + delayed * 0.3f;
+            pos = (pos + 1) % RING;
+            diff = fmaxf(diff, fabsf(a[i * 2] - (in * 0.7f + delayed * 0.3f)));
+        }
+        free(ring);
+        printf("  delay vs modulo reference: max diff %.2e\n", diff);
+        assert(diff == 0.0f && "Delay must match the reference ring");
+    }
+
+    // Chorus: audible wet signal, and a dry mix passes the input straight through
+    reset_rack(rack);
+    rack->chorus.enabled = true;
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32);
+    float chorus_diff = max_difference(a, input, samples);
+    assert(chorus_diff > 0.05f && "Chorus should change the signal");
+    reset_rack(rack);
+    rack->chorus.enabled = true;
+    rack->chorus.mix = 0.0f;
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32);
+    assert(max_difference(a, input, samples) == 0.0f && "Dry chorus must be transparent");
+
+    // Compressor: a steady 0.9 tone over a 0.3 threshold at 4:1 settles near
+    // 0.3 * 3^(1/4); a tone under the threshold is left alone
+    reset_rack(rack);
+    rack->compressor.enabled = true;
+    rack->compressor.threshold = 0.3f;
+    rack->compressor.ratio = 4.0f;
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        float s = 0.9f * sinf(6.2831853f * 441.0f * (float)i / TEST_RATE);
+        a[i * 2] = s;
+        a[i * 2 + 1] = s;
+    }
+    run_rack(rack, a, TEST_FRAMES, 32);
+    float settled = 0.0f;
+    for (int i = TEST_FRAMES - 4410; i < TEST_FRAMES; i++) {
+        settled = fmaxf(settled, fabsf(a[i * 2]));
+    }
+    float expected = 0.3f * powf(3.0f, 0.25f);
+    printf("  compressor: settled peak %.3f (expected ~%.3f)\n", settled, expected);
+    assert(fabsf(settled - expected) < expected * 0.1f && "Compressor should follow its ratio");
+    reset_rack(rack);
+    rack->compressor.enabled = true;
+    rack->compressor.threshold = 0.9f;
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        a[i * 2] = a[i * 2 + 1] = 0.2f * sinf(6.2831853f * 441.0f * (float)i / TEST_RATE);
+    }
+    memcpy(b, a, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32);
+    assert(memcmp(a, b, samples * sizeof(float)) == 0 && "Below threshold must be unity gain");
+
+    // FDN reverb: passes audio through until prepared, then every tier rings
+    // out stereo and decays at roughly its RT60 (2.65 s at size 0.5)
+    {
+        Reverb unprepared;
+        memset(&unprepared, 0, sizeof(unprepared));
+        unprepared.enabled = true;
+        unprepared.mix = 1.0f;
+        memcpy(a, input, samples * sizeof(float));
+        float* left = b;
+        float* right = b + TEST_FRAMES;
+        for (int i = 0; i < TEST_FRAMES; i++) {
+            left[i] = a[i * 2];
+            right[i] = a[i * 2 + 1];
+        }
+        fx_reverb_process(&unprepared, left, right, TEST_FRAMES);
+        assert(left[100] == a[200] && right[100] == a[201] && "Unprepared reverb must pass through");
+
+        int long_frames = (int)(1.5f * TEST_RATE);
+        float* wet_l = (float*)calloc((size_t)long_frames, sizeof(float));
+        float* wet_r = (float*)calloc((size_t)long_frames, sizeof(float));
+        assert(wet_l && wet_r);
+        for (int q = 0; q < FX_REVERB_QUALITY_COUNT; q++) {
+            reset_rack(rack);
+            rack->reverb.enabled = true;
+            rack->reverb.mix = 1.0f;
+            rack->reverb.quality = (FxReverbQuality)q;
+            memset(wet_l, 0, sizeof(float) * (size_t)long_frames);
+            memset(wet_r, 0, sizeof(float) * (size_t)long_frames);
+            wet_l[0] = wet_r[0] = 1.0f;
+            for (int start = 0; start < long_frames; start += 32) {
+                int n = long_frames - start < 32 ? long_frames - start : 32;
+                fx_reverb_process(&rack->reverb, wet_l + start, wet_r + start, n);
+            }
+            double early = 0.0, late = 0.0, side = 0.0;
+            int window = (int)(0.2f * TEST_RATE);
+            int early_start = (int)(0.1f * TEST_RATE);
+            int late_start = (int)(1.2f * TEST_RATE);
+            for (int i = 0; i < window; i++) {
+                early += wet_l[early_start + i] * wet_l[early_start + i];
+                late += wet_l[late_start + i] * wet_l[late_start + i];
+                side += fabsf(wet_l[early_start + i] - wet_r[early_start + i]);
+            }
+            float decay_db = 10.0f * log10f((float)(late / early));
+            printf("  reverb %-8s (%2d lines): 0.1 s -> 1.2 s %.1f dB\n",
+                   fx_reverb_quality_name((FxReverbQuality)q),
+                   rack->reverb.num_lines, decay_db);
+            assert(rack->reverb.num_lines == fx_reverb_line_count((FxReverbQuality)q));
+            assert(early > 1e-6 && side > 0.0 && "Reverb should ring out in stereo");
+            assert(decay_db < -15.0f && decay_db > -40.0f && "Decay should follow the RT60");
+        }
+        free(wet_r);
+        free(wet_l);
+
+        // Lines are sized from the real rate
+        assert(rack->reverb.line_capacity >= (uint32_t)(FX_REVERB_MAX_LINE_MS * 0.001f * TEST_RATE));
+
+        // The first block after prepare picks its tier without clearing (the
+        // arena is zeroed). A live tier change mutes the wet signal while the
+        // lines are zeroed a chunk per block, then the reverb comes back.
+        reset_rack(rack);
+        rack->reverb.enabled = true;
+        rack->reverb.mix = 0.5f;
+        rack->reverb.quality = FX_REVERB_HIGH;
+        float chunk_l[32];
+        float chunk_r[32];
+        for (int i = 0; i < 32; i++) {
+            chunk_l[i] = chunk_r[i] = 0.5f;
+        }
+        fx_reverb_process(&rack->reverb, chunk_l, chunk_r, 32);
+        assert(!rack->reverb.clearing && rack->reverb.num_lines == 16 && "A fresh arena needs no clear");
+        for (int start = 0; start < 4096; start += 32) {
+            for (int i = 0; i < 32; i++) {
+                chunk_l[i] = chunk_r[i] = 0.5f;
+            }
+            fx_reverb_process(&rack->reverb, chunk_l, chunk_r, 32);
+        }
+        rack->reverb.quality = FX_REVERB_ECO;
+        int muted_blocks = 0;
+        do {
+            for (int i = 0; i < 32; i++) {
+                chunk_l[i] = chunk_r[i] = 0.5f;
+            }
+            fx_reverb_process(&rack->reverb, chunk_l, chunk_r, 32);
+            for (int i = 0; i < 32; i++) {
+                assert(chunk_l[i] == 0.25f && chunk_r[i] == 0.25f && "Wet must be muted while clearing");
+            }
+            muted_blocks++;
+        } while (rack->reverb.clearing);
+        size_t line_floats = (size_t)rack->reverb.line_capacity * FX_REVERB_MAX_LINES;
+        assert(muted_blocks == (int)((line_floats + FX_REST_CHUNK_FLOATS - 1) / FX_REST_CHUNK_FLOATS) &&
+               muted_blocks > 1 && "Lines must be cleared over several blocks");
+        for (size_t i = 0; i < line_floats; i++) {
+            assert(rack->reverb.lines[i] == 0.0f);
+        }
+        for (int start = 0; start < 4096; start += 32) {
+            for (int i = 0; i < 32; i++) {
+                chunk_l[i] = chunk_r[i] = 0.5f;
+            }
+            fx_reverb_process(&rack->reverb, chunk_l, chunk_r, 32);
+        }
+        assert(rack->reverb.num_lines == 8 && chunk_l[31] != 0.25f && "The new tier must ring once cleared");
+    }
+
+    // Arena: every buffer is carved from one block sized for the rate and the
+    // max delay; an unprepared rack passes audio through
+    {
+        EffectsRack* bare = (EffectsRack*)calloc(1, sizeof(EffectsRack));
+        assert(bare);
+        fx_rack_init(bare);
+        bare->chorus.enabled = true;
+        bare->delay.enabled = true;
+        bare->reverb.enabled = true;
+        memcpy(a, input, samples * sizeof(float));
+        run_rack(bare, a, TEST_FRAMES, 64);
+        assert(fx_rack_memory_bytes(bare) == 0);
+        assert(memcmp(a, input, samples * sizeof(float)) == 0 && "Unprepared buffers must pass through");
+
+        float fast_rate = 96000.0f;
+        bool prepared = fx_rack_prepare(bare, fast_rate);
+        assert(prepared);
+        size_t bytes = fx_rack_memory_bytes(bare);
+        uint32_t two_seconds = (uint32_t)(FX_DELAY_MAX_MS * 0.001f * fast_rate);
+        printf("  arena at 96 kHz: %.2f MB\n", (double)bytes / (1024.0 * 1024.0));
+        assert(bare->delay.delay_l.mask >= two_seconds && "Full max delay must fit at 96 kHz");
+        assert((bare->delay.delay_l.mask & (bare->delay.delay_l.mask + 1)) == 0);
+        assert(bare->reverb.line_capacity >= 9600 &&
+               (bare->reverb.line_capacity & (bare->reverb.line_capacity - 1)) == 0);
+        assert((uintptr_t)bare->delay.delay_r.buffer % 64 == 0 &&
+               (uintptr_t)bare->reverb.lines % 64 == 0 && "Carved buffers start on a cache line");
+        assert(bare->arena.used <= bare->arena.capacity && bytes == bare->arena.capacity * sizeof(float));
+
+        // Same sizes keep the arena; a shorter max delay shrinks it
+        float* base = bare->arena.base;
+        prepared = fx_rack_prepare(bare, fast_rate);
+        assert(prepared && bare->arena.base == base);
+        bare->max_delay_ms = 500.0f;
+        prepared = fx_rack_prepare(bare, fast_rate);
+        assert(prepared && fx_rack_memory_bytes(bare) < bytes);
+        bare->max_delay_ms = FX_DELAY_MAX_MS;
+        prepared = fx_rack_prepare(bare, fast_rate);
+        assert(prepared);
+        (void)prepared;
+
+        // A 2 s echo at 96 kHz lands exactly two seconds later
+        int echo_frames = (int)two_seconds + 64;
+        float* echo_l = (float*)calloc((size_t)echo_frames, sizeof(float));
+        float* echo_r = (float*)calloc((size_t)echo_frames, sizeof(float));
+        assert(echo_l && echo_r);
+        echo_l[0] = echo_r[0] = 1.0f;
+        bare->delay.enabled = true;
+        bare->delay.time_ms = FX_DELAY_MAX_MS;
+        bare->delay.mix = 0.5f;
+        for (int start = 0; start < echo_frames; start += 256) {
+            int n = echo_frames - start < 256 ? echo_frames - start : 256;
+            fx_delay_process(&bare->delay, echo_l + start, echo_r + start, n, fast_rate);
+        }
+        assert(echo_l[two_seconds] == 0.5f && echo_r[two_seconds] == 0.5f && "Echo must arrive on time");
+        free(echo_r);
+        free(echo_l);
+        fx_rack_free(bare);
+        assert(fx_rack_memory_bytes(bare) == 0 && !bare->reverb.lines);
+        free(bare);
+    }
+
+    // Reordering changes the result; slots left out of the chain never run
+    FxType dist_first[] = {FX_DISTORTION, FX_DELAY};
+    FxType delay_first[] = {FX_DELAY, FX_DISTORTION};
+    reset_rack(rack);
+    rack->distortion.enabled = true;
+    rack->distortion.drive = 6.0f;
+    rack->distortion.mix = 1.0f;
+    rack->delay.enabled = true;
+    rack->delay.time_ms = 100.0f;
+    rack->delay.mix = 0.5f;
+    bool ordered = fx_rack_set_order(rack, dist_first, 2);
+    assert(ordered && rack->num_slots == 2);
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32);
+    reset_rack(rack);
+    rack->distortion.enabled = true;
+    rack->distortion.drive = 6.0f;
+    rack->distortion.mix = 1.0f;
+    rack->delay.enabled = true;
+    rack->delay.time_ms = 100.0f;
+    rack->delay.mix = 0.5f;
+    ordered = fx_rack_set_order(rack, delay_first, 2);
+    assert(ordered);
+    memcpy(b, input, samples * sizeof(float));
+    run_rack(rack, b, TEST_FRAMES, 32);
+    assert(max_difference(a, b, samples) > 0.01f && "Slot order should matter");
+
+    FxType repeated[] = {FX_DELAY, FX_DELAY};
+    ordered = fx_rack_set_order(rack, repeated, 2);
+    assert(!ordered && rack->order[0] == FX_DELAY && rack->num_slots == 2);
+    FxType reverb_only[] = {FX_REVERB};
+    ordered = fx_rack_set_order(rack, reverb_only, 1);
+    assert(ordered);
+    (void)ordered;
+    memcpy(a, input, samples * sizeof(float));
+    run_rack(rack, a, TEST_FRAMES, 32); // Distortion/delay enabled but unslotted; reverb bypassed
+    assert(memcmp(a, input, samples * sizeof(float)) == 0 && "Unslotted effects must not run");
+    assert(strcmp(fx_type_name(FX_COMPRESSOR), "Compressor") == 0);
+
+    // Silence: every slot falls asleep once its tail is under the threshold,
+    // an asleep chain leaves silent blocks alone, and input wakes each slot
+    // at rest (lines cleared over the following blocks), so it then plays
+    // exactly as a fresh rack would. (The chorus is left out of that
+    // comparison: its LFO keeps its phase.)
+    {
+        reset_rack(rack);
+        enable_all(rack);
+        rack->chorus.enabled = false;
+        memcpy(a, input, samples * sizeof(float));
+        run_rack(rack, a, TEST_FRAMES, 256);
+        const FxType slept[] = {FX_DISTORTION, FX_COMPRESSOR, FX_DELAY, FX_REVERB};
+        float silence[256 * 2];
+        int silent_blocks = 0;
+        int reverb_asleep_at = -1;
+        bool all_at_rest = false;
+        while (!all_at_rest && silent_blocks < (int)(15.0f * TEST_RATE / 256)) {
+            memset(silence, 0, sizeof(silence));
+            fx_rack_process(rack, silence, 256, TEST_RATE);
+            silent_blocks++;
+            if (reverb_asleep_at < 0 && fx_rack_slot_asleep(rack, FX_REVERB)) {
+                reverb_asleep_at = silent_blocks;
+            }
+            all_at_rest = true;
+            for (int t = 0; t < 4; t++) {
+                all_at_rest = all_at_rest && fx_rack_slot_at_rest(rack, slept[t]);
+            }
+        }
+        printf("  FX tails at rest after %.2f s of silence (reverb asleep at %.2f s)\n",
+               silent_blocks * 256 / TEST_RATE, reverb_asleep_at * 256 / TEST_RATE);
+        assert(all_at_rest && "Delay and reverb must sleep once their tails die");
+        assert(reverb_asleep_at * 256 >= (int)((0.3f + 4.7f * rack->reverb.size) * TEST_RATE) &&
+               "The reverb must ring for at least its RT60");
+        assert(silent_blocks > reverb_asleep_at && "Clearing the lines is spread over blocks");
+        assert(!fx_rack_slot_asleep(rack, FX_CHORUS) && "Disabled slots are never run");
+        memset(silence, 0, sizeof(silence));
+        fx_rack_process(rack, silence, 256, TEST_RATE);
+        for (int i = 0; i < 256 * 2; i++) {
+            assert(silence[i] == 0.0f);
+        }
+
+        memcpy(a, input, samples * sizeof(float));
+        run_rack(rack, a, TEST_FRAMES, 256);
+        assert(!fx_rack_slot_asleep(rack, FX_REVERB));
+        reset_rack(rack);
+        enable_all(rack);
+        rack->chorus.enabled = false;
+        memcpy(b, input, samples * sizeof(float));
+        run_rack(rack, b, TEST_FRAMES, 256);
+        float wake_diff = max_difference(a, b, samples);
+        printf("  woken rack vs fresh rack: max difference %.2e\n", wake_diff);
+        assert(wake_diff == 0.0f && "A woken slot must start from rest");
+    }
+
+    // A reverb at mix 0 is silent at the output but still rings inside:
+    // it must hold off sleeping until the RT60 has taken that energy away,
+    // so turning the mix up later doesn't replay an old tail
+    {
+        reset_rack(rack);
+        rack->reverb.enabled = true;
+        rack->reverb.mix = 0.0f;
+        memcpy(a, input, samples * sizeof(float));
+        run_rack(rack, a, TEST_FRAMES, 256);
+        float silence[256 * 2];
+        int silent_blocks = 0;
+        while (!fx_rack_slot_asleep(rack, FX_REVERB) && silent_blocks < (int)(15.0f * TEST_RATE / 256)) {
+            memset(silence, 0, sizeof(silence));
+            fx_rack_process(rack, silence, 256, TEST_RATE);
+            silent_blocks++;
+        }
+        float energy = 0.0f;
+        size_t line_floats = (size_t)rack->reverb.line_capacity * FX_REVERB_MAX_LINES;
+        for (size_t i = 0; i < line_floats; i++) {
+            energy = fmaxf(energy, fabsf(rack->reverb.lines[i]));
+        }
+        printf("  mix-0 reverb asleep after %.2f s, line peak %.2e\n", silent_blocks * 256 / TEST_RATE, energy);
+        assert(fx_rack_slot_asleep(rack, FX_REVERB) && energy < FX_SLEEP_THRESHOLD &&
+               "A mix-0 reverb must not sleep holding its tail");
+    }
+
+    free(b);
+    free(a);
+    free(input);
+    fx_rack_free(rack);
+    free(rack);
+
+    printf("fx_rack tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,370 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MINIAUDIO_IMPLEMENTATION
+#define MA_NO_DEVICE_IO
+#define MA_NO_ENGINE
+#define MA_NO_NODE_GRAPH
+#include "miniaudio.h"
+
+#include "offline_render.h"
+#include "sample_io.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * Golden-render regression harness.
+ *
+ * Each scenario is bounced through offline_render, which is the
+ * production engine, FX rack, arpeggiator and sequencer, with a fixed
+ * seed. The result is compared against tests/golden/<name>.wav:
+ * - max error: the largest per-sample difference;
+ * - spectral distance: the mean log-spectral distance in dB over Hann
+ *   frames of the mono mix.
+ * The goldens come from the exact-math reference build (SYNTH_EXACT_MATH,
+ * CMake -DSYNTH_FAST_MATH=OFF), which is the only build that may re-record
+ * them. A fast-path change, such as approximate math, SIMD or block
+ * rendering, is accepted if both distances stay within tolerance.
+ *
+ *   golden_render_test                         # compare every scenario
+ *   golden_render_test --max-error 1e-3 --spectral-db 0.5 fx_chain
+ *   golden_render_test --update                # re-record (reference build only)
+ *   golden_render_test --out /tmp/golden_out   # also write the renders to listen to
+ */
+
+#define GOLDEN_RATE 22050
+#define GOLDEN_SECONDS 0.8f
+#define GOLDEN_SEED 0x60D5EEDu
+#define GOLDEN_DEFAULT_DIR "tests/golden"
+#define GOLDEN_MAX_ERROR 1e-3           // Default tolerances; see --max-error / --spectral-db
+#define GOLDEN_SPECTRAL_DB 0.5
+#define GOLDEN_FFT_SIZE 1024
+#define GOLDEN_FFT_HOP 512
+#define GOLDEN_FLOOR_DB -90.0           // Bins below this (re full scale) count as equal
+
+typedef struct {
+    const char* name;
+    const char* covers;
+    void (*preset)(PresetData* preset);
+    offline_render_configure_fn configure;
+} GoldenScenario;
+
+typedef struct {
+    double max_error;
+    double spectral_db;
+} GoldenDistance;
+
+// ============================================================================
+// SCENARIOS
+// ============================================================================
+
+static void set_osc1(SynthEngine* synth, WaveformType wave, int unison, float detune) {
+    synth->params[PARAM_OSC1_WAVE] = (float)wave;
+    synth->params[PARAM_OSC1_UNISON] = (float)unison;
+    synth->params[PARAM_OSC1_FINE] = detune;
+}
+
+static void preset_resonant(PresetData* preset) {
+    preset->filter_cutoff = 500.0f;
+    preset->filter_resonance = 0.85f;
+    preset->filter_env_amount = 0.8f;
+    preset->env_decay = 0.15f;
+    preset->env_sustain = 0.4f;
+}
+
+static void preset_fx_chain(PresetData* preset) {
+    preset->distortion.enabled = true;
+    preset->distortion.drive = 3.0f;
+    preset->distortion.mix = 0.5f;
+    preset->chorus.enabled = true;
+    preset->chorus.rate = 1.2f;
+    preset->chorus.depth = 6.0f;
+    preset->chorus.mix = 0.4f;
+    preset->compressor.enabled = true;
+    preset->compressor.threshold = 0.3f;
+    preset->compressor.ratio = 4.0f;
+    preset->delay.enabled = true;
+    preset->delay.time = 0.18f;
+    preset->delay.feedback = 0.45f;
+    preset->delay.mix = 0.35f;
+    preset->reverb.enabled = true;
+    preset->reverb.size = 0.6f;
+    preset->reverb.damping = 0.4f;
+    preset->reverb.mix = 0.3f;
+}
+
+static void preset_arp(PresetData* preset) {
+    preset->arp.enabled = true;
+    preset->arp.mode = ARP_RANDOM;
+    preset->arp.rate_multiplier = 2.0f;
+    preset->env_release = 0.05f;
+}
+
+static void configure_square_unison(SynthEngine* synth, EffectsRack* fx, void* userdata) {
+    (void)fx;
+    (void)userdata;
+    set_osc1(synth, WAVE_SQUARE, 5, 18.0f);
+}
+
+static void configure_triangle(SynthEngine* synth, EffectsRack* fx, void* userdata) {
+    (void)fx;
+    (void)userdata;
+    set_osc1(synth, WAVE_TRIANGLE, 1, 0.0f);
+}
+
+static void configure_noise(SynthEngine* synth, EffectsRack* fx, void* userdata) {
+    (void)fx;
+    (void)userdata;
+    set_osc1(synth, WAVE_NOISE, 1, 0.0f);
+}
+
+static const GoldenScenario kScenarios[] = {
+    {"init_saw", "default patch: band-limited saw, lowpass, ADSR", NULL, NULL},
+    {"square_unison5", "square PolyBLEP with 5-voice unison", NULL, configure_square_unison},
+    {"triangle_resonant", "triangle into a resonant filter-envelope sweep", preset_resonant, configure_triangle},
+    {"fx_chain", "every effect in the rack", preset_fx_chain, NULL},
+    {"noise_arp_random", "seeded noise and random arpeggio", preset_arp, configure_noise},
+};
+#define GOLDEN_SCENARIO_COUNT ((int)(sizeof(kScenarios) / sizeof(kScenarios[0])))
+
+static bool render_scenario(const GoldenScenario* scenario, float* out, uint32_t frames) {
+    ProjectData* project = (ProjectData*)calloc(1, sizeof(ProjectData));
+    if (!project) {
+        return false;
+    }
+    project_init(project);
+    if (scenario->preset) {
+        scenario->preset(&project->preset);
+    }
+    OfflineRenderOptions options;
+    offline_render_options_init(&options);
+    options.sample_rate = GOLDEN_RATE;
+    options.seed = GOLDEN_SEED;
+    options.configure = scenario->configure;
+    bool ok = offline_render_to_buffer(project, &options, out, frames, NULL);
+    free(project);
+    return ok;
+}
+
+// ============================================================================
+// DISTANCE
+// ============================================================================
+
+// In-place radix-2 FFT; n is a power of two
+static void fft(double* re, double* im, int n) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        double angle = -2.0 * M_PI / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < len / 2; k++) {
+                double wr = cos(angle * k);
+                double wi = sin(angle * k);
+                int a = start + k;
+                int b = a + len / 2;
+                double xr = re[b] * wr - im[b] * wi;
+                double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+// Magnitudes in dB re a full-scale sine, floored at GOLDEN_FLOOR_DB
+static void frame_spectrum_db(const float* stereo, uint32_t start, double* db) {
+    static double re[GOLDEN_FFT_SIZE];
+    static double im[GOLDEN_FFT_SIZE];
+    for (int i = 0; i < GOLDEN_FFT_SIZE; i++) {
+        double window = 0.5 - 0.5 * cos(2.0 * M_PI * i / (GOLDEN_FFT_SIZE - 1));
+        const float* frame = stereo + (size_t)(start + (uint32_t)i) * 2;
+        re[i] = 0.5 * (frame[0] + frame[1]) * window;
+        im[i] = 0.0;
+    }
+    fft(re, im, GOLDEN_FFT_SIZE);
+    const double scale = 4.0 / GOLDEN_FFT_SIZE; // Hann gain 0.5, one-sided
+    for (int k = 0; k <= GOLDEN_FFT_SIZE / 2; k++) {
+        double magnitude = sqrt(re[k] * re[k] + im[k] * im[k]) * scale;
+        db[k] = magnitude > 0.0 ? fmax(20.0 * log10(magnitude), GOLDEN_FLOOR_DB) : GOLDEN_FLOOR_DB;
+    }
+}
+
+static GoldenDistance compare_renders(const float* actual, const float* expected, uint32_t frames) {
+    GoldenDistance distance = {0.0, 0.0};
+    for (size_t i = 0; i < (size_t)frames * 2; i++) {
+        double error = fabs((double)actual[i] - (double)expected[i]);
+        if (error > distance.max_error || isnan(error)) {
+            distance.max_error = isnan(error) ? INFINITY : error;
+        }
+    }
+
+    static double db_actual[GOLDEN_FFT_SIZE / 2 + 1];
+    static double db_expected[GOLDEN_FFT_SIZE / 2 + 1];
+    double total = 0.0;
+    int count = 0;
+    for (uint32_t start = 0; start + GOLDEN_FFT_SIZE <= frames; start += GOLDEN_FFT_HOP) {
+        frame_spectrum_db(actual, start, db_actual);
+        frame_spectrum_db(expected, start, db_expected);
+        double sum = 0.0;
+        for (int k = 0; k <= GOLDEN_FFT_SIZE / 2; k++) {
+            double d = db_actual[k] - db_expected[k];
+            sum += d * d;
+        }
+        total += sqrt(sum / (GOLDEN_FFT_SIZE / 2 + 1));
+        count++;
+    }
+    distance.spectral_db = count > 0 ? total / count : 0.0;
+    return distance;
+}
+
+// ============================================================================
+// DRIVER
+// ============================================================================
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [--update] [--dir golden_dir] [--out dir] [--max-error x] [--spectral-db x] [scenario...]\n"
+            "  --update       Record the current renders as the new goldens\n"
+            "  --dir          Golden WAV directory (default: %s)\n"
+            "  --out          Also write each render to dir/<name>.wav\n"
+            "  --max-error    Largest per-sample difference allowed (default: %g)\n"
+            "  --spectral-db  Mean log-spectral distance allowed, in dB (default: %g)\n",
+            argv0, GOLDEN_DEFAULT_DIR, GOLDEN_MAX_ERROR, GOLDEN_SPECTRAL_DB);
+}
+
+static bool selected(const char* name, char** names, int count) {
+    if (count == 0) {
+        return true;
+    }
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    const char* dir = GOLDEN_DEFAULT_DIR;
+    const char* out_dir = NULL;
+    bool update = false;
+    double max_error = GOLDEN_MAX_ERROR;
+    double spectral_db = GOLDEN_SPECTRAL_DB;
+    char* names[GOLDEN_SCENARIO_COUNT];
+    int name_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--dir") == 0 && has_value) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && has_value) {
+            out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--max-error") == 0 && has_value) {
+            max_error = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--spectral-db") == 0 && has_value) {
+            spectral_db = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && name_count < GOLDEN_SCENARIO_COUNT) {
+            names[name_count++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+#ifndef SYNTH_EXACT_MATH
+    if (update) {
+        fprintf(stderr, "--update needs the reference build (SYNTH_EXACT_MATH); goldens are not recorded "
+                        "from the fast-math path they are meant to check\n");
+        return 2;
+    }
+#endif
+
+    const uint32_t frames = (uint32_t)(GOLDEN_SECONDS * GOLDEN_RATE);
+    float* render = (float*)malloc(sizeof(float) * frames * 2);
+    if (!render) {
+        return 2;
+    }
+
+    int failures = 0;
+    int ran = 0;
+    for (int s = 0; s < GOLDEN_SCENARIO_COUNT; s++) {
+        const GoldenScenario* scenario = &kScenarios[s];
+        if (!selected(scenario->name, names, name_count)) {
+            continue;
+        }
+        ran++;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, scenario->name);
+        if (!render_scenario(scenario, render, frames)) {
+            printf("FAIL %-20s render failed\n", scenario->name);
+            failures++;
+            continue;
+        }
+        if (out_dir) {
+            char out_path[512];
+            snprintf(out_path, sizeof(out_path), "%s/%s.wav", out_dir, scenario->name);
+            sample_buffer_write_wav(out_path, render, frames, 2, GOLDEN_RATE);
+        }
+        if (update) {
+            bool written = sample_buffer_write_wav(path, render, frames, 2, GOLDEN_RATE);
+            printf("%s %-20s -> %s\n", written ? "wrote" : "FAIL ", scenario->name, path);
+            failures += written ? 0 : 1;
+            continue;
+        }
+
+        SampleBuffer golden;
+        sample_buffer_init(&golden);
+        if (!sample_buffer_load_wav(&golden, path)) {
+            printf("FAIL %-20s no golden at %s (record with --update)\n", scenario->name, path);
+            failures++;
+            continue;
+        }
+        if (golden.channels != 2 || golden.sample_rate != GOLDEN_RATE || golden.frame_count != frames) {
+            printf("FAIL %-20s golden is %u ch / %u Hz / %u frames, expected 2 / %d / %u\n", scenario->name,
+                   golden.channels, golden.sample_rate, golden.frame_count, GOLDEN_RATE, frames);
+            sample_buffer_free(&golden);
+            failures++;
+            continue;
+        }
+        GoldenDistance distance = compare_renders(render, golden.data, frames);
+        sample_buffer_free(&golden);
+        bool pass = distance.max_error <= max_error && distance.spectral_db <= spectral_db;
+        printf("%s %-20s max error %.2e (<= %.0e), spectral %.3f dB (<= %.2f)  [%s]\n", pass ? "ok  " : "FAIL",
+               scenario->name, distance.max_error, max_error, distance.spectral_db, spectral_db,
+               scenario->covers);
+        failures += pass ? 0 : 1;
+    }
+    free(render);
+
+    if (ran == 0) {
+        fprintf(stderr, "No scenario matched\n");
+        return 2;
+    }
+    if (failures > 0) {
+        printf("%d of %d golden scenario%s failed.\n", failures, ran, ran == 1 ? "" : "s");
+        return 1;
+    }
+    printf("golden_render tests passed.\n");
+    return 0;
+}
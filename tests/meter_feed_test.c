@@ -0,0 +1,118 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "meter_feed.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define TEST_RATE 48000.0f
+#define TEST_PERIOD 300   // Not a divisor of the window, so windows straddle callbacks
+
+static bool near(double a, double b, double tolerance) {
+    return fabs(a - b) < tolerance;
+}
+
+// Left: a sine at `amplitude`; right: silence
+static void fill_sine(float* stereo, int frames, int start, float amplitude, float freq) {
+    for (int i = 0; i < frames; i++) {
+        stereo[i * 2] = amplitude * (float)sin(2.0 * M_PI * freq * (start + i) / TEST_RATE);
+        stereo[i * 2 + 1] = 0.0f;
+    }
+}
+
+int main(void) {
+    static MeterFeed feed;
+    static float block[METER_FEED_WINDOW * 8 * 2];
+    MeterFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    meter_feed_init(&feed);
+    bool polled = meter_feed_poll(&feed, &frame);
+    assert(!polled && "Nothing is published before a window fills");
+
+    // Voice state rides along with the levels
+    MeterVoices voices;
+    memset(&voices, 0, sizeof(voices));
+    voices.active_voices = 3;
+    voices.notes[60 >> 6] |= 1ull << (60 & 63);
+    voices.notes[100 >> 6] |= 1ull << (100 & 63);
+    voices.row_count = 1;
+    voices.rows[0] = (MeterVoiceRow){100, 0.5f, false};
+    meter_feed_set_voices(&feed, &voices);
+
+    // 1.5 windows in odd-sized periods: one frame, the rest carried over
+    int done = 0;
+    while (done < METER_FEED_WINDOW * 3 / 2) {
+        fill_sine(block, TEST_PERIOD, done, 0.5f, 1000.0f);
+        meter_feed_push(&feed, block, TEST_PERIOD);
+        done += TEST_PERIOD;
+    }
+    polled = meter_feed_poll(&feed, &frame);
+    assert(polled);
+    assert(near(frame.peak[0], 0.5, 1e-3) && frame.peak[1] == 0.0f);
+    assert(near(frame.rms[0], 0.5 / sqrt(2.0), 0.01) && "RMS of a sine is peak / sqrt(2)");
+    assert(frame.voices.active_voices == 3 && frame.voices.row_count == 1);
+    assert(meter_voices_note_held(&frame.voices, 60) && meter_voices_note_held(&frame.voices, 100));
+    assert(!meter_voices_note_held(&frame.voices, 61) && !meter_voices_note_held(&frame.voices, 128));
+    polled = meter_feed_poll(&feed, &frame);
+    assert(!polled && "Each frame is returned once");
+
+    // Several frames between polls: the loudest peak survives, RMS is the newest
+    fill_sine(block, METER_FEED_WINDOW * 4, 0, 0.25f, 1000.0f);
+    const int spike_frame = METER_FEED_WINDOW * 2;
+    block[spike_frame * 2] = 0.9f;          // One spike mid-block
+    for (int i = METER_FEED_WINDOW * 3; i < METER_FEED_WINDOW * 4; i++) {
+        block[i * 2] = 0.0f;                // The last window of input is silent
+    }
+    meter_feed_push(&feed, block, METER_FEED_WINDOW * 4);
+    polled = meter_feed_poll(&feed, &frame);
+    assert(polled);
+    assert(near(frame.peak[0], 0.9, 1e-6));
+    assert(frame.rms[0] < 0.25f);
+
+    // The scope history holds the newest mono samples, oldest first
+    float scope[METER_FEED_SCOPE_SIZE + 16];
+    int count = meter_feed_scope(&feed, scope, 64);
+    assert(count == 64);
+    for (int i = 0; i < count; i++) {
+        assert(scope[i] == 0.0f && "The input ended in silence");
+    }
+    count = meter_feed_scope(&feed, scope, METER_FEED_SCOPE_SIZE + 16);
+    assert(count == METER_FEED_SCOPE_SIZE);
+    int spike = METER_FEED_SCOPE_SIZE - METER_FEED_WINDOW * 4 + spike_frame;
+    assert(near(scope[spike], 0.45, 1e-6) && "Mono is the mean of the channels");
+
+    // Nobody polling: the rings fill, drop and count, and never block
+    uint32_t pushed = 0;
+    while (pushed < (METER_FEED_QUEUE + 8) * METER_FEED_WINDOW) {
+        fill_sine(block, METER_FEED_WINDOW * 8, 0, 0.1f, 440.0f);
+        meter_feed_push(&feed, block, METER_FEED_WINDOW * 8);
+        pushed += METER_FEED_WINDOW * 8;
+    }
+    assert(atomic_load(&feed.dropped_frames) > 0);
+    assert(atomic_load(&feed.dropped_scope) > 0);
+    polled = meter_feed_poll(&feed, &frame);
+    assert(polled && near(frame.peak[0], 0.1, 1e-3));
+
+    // Spectrum: a full-scale 1 kHz sine reads near 0 dB at 1 kHz, far below elsewhere
+    static float tone[1024];
+    for (int i = 0; i < 1024; i++) {
+        tone[i] = (float)sin(2.0 * M_PI * 1000.0 * i / TEST_RATE);
+    }
+    float bands[3];
+    meter_feed_spectrum(tone, 1024, TEST_RATE, 250.0f, 4000.0f, bands, 3);
+    assert(near(bands[1], 0.0, 1.0) && "Band centres are log-spaced: 250, 1000, 4000 Hz");
+    assert(bands[0] < -40.0f && bands[2] < -40.0f);
+    memset(tone, 0, sizeof(tone));
+    meter_feed_spectrum(tone, 1024, TEST_RATE, 250.0f, 4000.0f, bands, 3);
+    assert(bands[1] <= -100.0f && "Silence reads as the floor");
+    (void)polled;
+    (void)count;
+    (void)spike;
+
+    printf("meter_feed tests passed.\n");
+    return 0;
+}
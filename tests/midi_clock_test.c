@@ -0,0 +1,108 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "midi_clock.h"
+
+#define TEST_RATE 48000.0f
+#define TEST_NS_PER_FRAME (1e9 / 48000.0)
+#define TEST_T0 5000000000ull   // Host time of frame 0
+#define TEST_NOTES 2000
+#define TEST_NOTE_SPACING_NS 7300000ull   // 7.3 ms: never a whole number of periods
+
+static uint32_t rng_state = 12345u;
+
+static double jitter(double amplitude) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return amplitude * ((double)(rng_state >> 8) / (double)(1u << 24) * 2.0 - 1.0);
+}
+
+typedef struct {
+    double worst;   // Frames between a note's placement and its stamp plus one period
+    double rms;
+} Placement;
+
+// Play TEST_NOTES stamped notes against callbacks of `frames`, each off by
+// up to `jitter_ns`, each note mapped in the first callback after it
+static Placement place_notes(uint32_t frames, double jitter_ns) {
+    MidiClock clock;
+    midi_clock_reset(&clock);
+    Placement result = {0.0, 0.0};
+    int measured = 0;
+    int note = 0;
+    uint64_t first_frame = 0;
+    while (note < TEST_NOTES) {
+        double start = (double)TEST_T0 + (double)first_frame * TEST_NS_PER_FRAME + jitter(jitter_ns);
+        midi_clock_begin_period(&clock, (uint64_t)start, first_frame, frames, TEST_RATE);
+        for (;;) {
+            uint64_t stamp = TEST_T0 + TEST_NOTE_SPACING_NS * (uint64_t)(note + 1);
+            if (note >= TEST_NOTES || (double)stamp >= start) {
+                break;
+            }
+            double ideal = ((double)stamp - (double)TEST_T0) / TEST_NS_PER_FRAME + frames;
+            uint64_t due = midi_clock_frame(&clock, stamp);
+            assert(due >= first_frame && due <= first_frame + frames);
+            if (first_frame >= 64 * (uint64_t)frames) {   // Past the filter's settling
+                double error = fabs((double)due - ideal);
+                result.worst = fmax(result.worst, error);
+                result.rms += error * error;
+                measured++;
+            }
+            note++;
+        }
+        first_frame += frames;
+    }
+    result.rms = measured > 0 ? sqrt(result.rms / measured) : 0.0;
+    return result;
+}
+
+int main(void) {
+    printf("Running midi_clock tests...\n");
+
+    MidiClock clock;
+    midi_clock_reset(&clock);
+    assert(midi_clock_frame(&clock, TEST_T0) == 0 && "Before the first period, play now");
+
+    // Steady callbacks: every note lands one period after it was played, to
+    // the frame, at any buffer size
+    const uint32_t sizes[4] = {32, 128, 512, 2048};
+    for (int s = 0; s < 4; s++) {
+        Placement placement = place_notes(sizes[s], 0.0);
+        printf("  %4u-frame periods: worst placement error %.2f frames\n", sizes[s], placement.worst);
+        assert(placement.worst <= 0.5 + 1e-6);
+    }
+
+    // Jittery callbacks: the filtered start keeps notes far steadier than
+    // the callback times they are measured against (uniform jitter of +/-J
+    // has an RMS of J / sqrt(3))
+    for (int s = 1; s < 4; s++) {
+        double jitter_frames = sizes[s] / 8.0;
+        Placement placement = place_notes(sizes[s], jitter_frames * TEST_NS_PER_FRAME);
+        printf("  %4u-frame periods, +/-%.0f frames of callback jitter: placement error %.1f RMS, "
+               "%.1f worst\n", sizes[s], jitter_frames, placement.rms, placement.worst);
+        assert(placement.rms < jitter_frames / sqrt(3.0) * 0.5);
+    }
+
+    // Stamps outside the window clamp to this period's first frame or the
+    // next period's
+    const uint32_t frames = 256;
+    midi_clock_begin_period(&clock, TEST_T0, 0, frames, TEST_RATE);
+    midi_clock_begin_period(&clock, TEST_T0 + (uint64_t)(frames * TEST_NS_PER_FRAME), frames, frames, TEST_RATE);
+    assert(midi_clock_frame(&clock, TEST_T0 - 1000000000ull) == frames && "Late stamps play at once");
+    assert(midi_clock_frame(&clock, TEST_T0 + 1000000000ull) == 2 * frames && "Early stamps wait a period");
+    assert(midi_clock_frame(&clock, TEST_T0) == frames);
+
+    // A callback a second late (xrun) re-anchors instead of smoothing
+    uint64_t late_start = TEST_T0 + 2000000000ull;
+    midi_clock_begin_period(&clock, late_start, 2 * frames, frames, TEST_RATE);
+    assert(clock.period_start_ns == (double)late_start);
+    uint64_t half_period_ago = late_start - (uint64_t)(frames / 2 * TEST_NS_PER_FRAME);
+    assert(midi_clock_frame(&clock, half_period_ago) == 2 * frames + frames / 2);
+
+    // So does a rate change
+    midi_clock_begin_period(&clock, late_start + 1000, 3 * frames, frames, 96000.0f);
+    assert(clock.period_start_ns == (double)(late_start + 1000));
+
+    printf("midi_clock tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MINIAUDIO_IMPLEMENTATION
+#define MA_NO_DEVICE_IO
+#define MA_NO_ENGINE
+#define MA_NO_NODE_GRAPH
+#include "miniaudio.h"
+
+#include "offline_render.h"
+#include "sample_io.h"
+
+#define TEST_SECONDS 2.0f
+#define TEST_RATE 44100
+
+typedef struct {
+    SeqEvent events[512];
+    int count;
+} EventLog;
+
+static bool log_event(const SeqEvent* event, void* userdata) {
+    EventLog* log = (EventLog*)userdata;
+    if (log->count >= 512) {
+        return false;
+    }
+    log->events[log->count++] = *event;
+    return true;
+}
+
+static void sequencer_step_test(void) {
+    SynthEngine* synth = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+    synth_init_with_polyphony(synth, TEST_RATE, 8);
+    Arpeggiator arp;
+    arp_init(&arp);
+    Sequencer seq;
+    sequencer_init(&seq);
+    seq.loop_enabled = false;
+    seq.patterns[0].length = 2;
+    seq.patterns[0].steps[0] = (SequencerStep){.note = 60, .velocity = 1.0f, .length = 1, .active = true};
+
+    // 120 BPM sixteenths: 5512.5 frames per step at 44.1 kHz
+    EventLog* log = (EventLog*)calloc(1, sizeof(EventLog));
+    sequencer_start(&seq, 1000);
+    sequencer_schedule(&seq, 1000, TEST_RATE, 120.0, log_event, log);
+    assert(log->count == 0 && "Nothing is due before the start frame");
+    sequencer_schedule(&seq, 1001, TEST_RATE, 120.0, log_event, log);
+    assert(log->count == 1 && log->events[0].sample_frame == 1000 && log->events[0].velocity == 127);
+    assert(log->events[0].length_frames == 5513);
+    sequencer_dispatch(&log->events[0], &arp, synth);
+    assert(synth->num_active_voices == 1 && "Step 0 should start its note");
+    assert(seq.sounding_notes[0] == 60 && seq.playing);
+
+    sequencer_schedule(&seq, 20000, TEST_RATE, 120.0, log_event, log);
+    assert(log->count == 2 && log->events[1].sample_frame == 6513 && log->events[1].velocity == 0 &&
+           "One-step note should release exactly one step later");
+    assert(seq.sounding_notes[0] == -1);
+    assert(!seq.playing && "Unlooped pattern stops after its last step");
+
+    // No drift: over an hour at 133 BPM (a fractional 4973.68 frames per
+    // step) every bar still lands on its exactly rounded grid frame
+    sequencer_init(&seq);
+    seq.patterns[0].steps[0] = (SequencerStep){.note = 48, .velocity = 0.5f, .length = 1, .active = true};
+    sequencer_start(&seq, 0);
+    double frames_per_step = TEST_RATE * 60.0 / 133.0 / SEQUENCER_STEPS_PER_BEAT;
+    uint64_t hour = (uint64_t)TEST_RATE * 3600;
+    uint64_t bar = 0;
+    for (uint64_t frame = 0; frame < hour; frame += 512) {
+        log->count = 0;
+        sequencer_schedule(&seq, frame + 512, TEST_RATE, 133.0, log_event, log);
+        for (int e = 0; e < log->count; e++) {
+            if (log->events[e].velocity > 0) {
+                uint64_t expected = (uint64_t)((double)(bar * 16) * frames_per_step + 0.5);
+                assert(log->events[e].sample_frame == expected && "Steps must not drift over a long set");
+                (void)expected;
+                bar++;
+            }
+        }
+    }
+    assert(bar > 1990);
+
+    // Swing moves odd steps only; loop range and step length are honoured
+    sequencer_init(&seq);
+    for (int k = 0; k < STEPS_PER_PATTERN; k++) {
+        seq.patterns[0].steps[k] = (SequencerStep){.note = 60 + k, .velocity = 0.8f, .length = 2, .active = true};
+    }
+    seq.patterns[0].swing = 0.75f;
+    seq.loop_start = 4;
+    seq.loop_end = 5;
+    sequencer_start(&seq, 0);
+    log->count = 0;
+    sequencer_schedule(&seq, 4 * 5513, TEST_RATE, 120.0, log_event, log);
+    assert(log->events[0].note == 64 && log->events[0].sample_frame == 0);
+    assert(log->events[1].note == 65 && log->events[1].sample_frame == 6891 && "Odd step swings late by a quarter step");
+    assert(log->events[2].velocity == 0 && log->events[2].note == 64 && log->events[2].sample_frame == 11025 &&
+           "Two-step note releases two steps later");
+    assert(log->events[3].note == 64 && log->events[3].velocity > 0 && log->events[3].sample_frame == 11025 &&
+           "Loop wraps back to loop_start");
+
+    // Chaining: pattern 2 follows pattern 0, then the chain repeats
+    sequencer_init(&seq);
+    seq.patterns[0].length = 1;
+    seq.patterns[0].steps[0] = (SequencerStep){.note = 40, .velocity = 0.8f, .length = 1, .active = true};
+    seq.patterns[2].length = 1;
+    seq.patterns[2].steps[0] = (SequencerStep){.note = 52, .velocity = 0.8f, .length = 1, .active = true};
+    int chain[] = {0, 2};
+    bool chained = sequencer_set_chain(&seq, chain, 2);
+    assert(chained);
+    int bad_chain[] = {MAX_PATTERNS};
+    chained = sequencer_set_chain(&seq, bad_chain, 1);
+    assert(!chained && seq.chain_length == 2);
+    (void)chained;
+    sequencer_start(&seq, 0);
+    log->count = 0;
+    sequencer_schedule(&seq, 4 * 5513, TEST_RATE, 120.0, log_event, log);
+    int ons[4] = {0};
+    int num_ons = 0;
+    for (int e = 0; e < log->count && num_ons < 4; e++) {
+        if (log->events[e].velocity > 0) {
+            ons[num_ons++] = log->events[e].note;
+        }
+    }
+    assert(num_ons == 4 && ons[0] == 40 && ons[1] == 52 && ons[2] == 40 && ons[3] == 52);
+
+    // A full queue loses nothing: the rest is offered on the next call
+    sequencer_init(&seq);
+    seq.patterns[0].steps[0] = (SequencerStep){.note = 60, .velocity = 0.8f, .length = 1, .active = true};
+    seq.patterns[0].length = 1;
+    sequencer_start(&seq, 0);
+    log->count = 511;
+    sequencer_schedule(&seq, 3 * 5512, TEST_RATE, 120.0, log_event, log);
+    assert(log->count == 512);
+    log->count = 0;
+    sequencer_schedule(&seq, 3 * 5512, TEST_RATE, 120.0, log_event, log);
+    assert(log->count == 4 && log->events[0].velocity == 0 && log->events[0].sample_frame == 5513);
+
+    free(log);
+    free(synth);
+}
+
+// Run the arp over `total` frames split the way the callback splits blocks
+static void run_arp(Arpeggiator* arp, EventLog* log, uint64_t total, uint64_t max_block) {
+    uint64_t now = 0;
+    while (now < total) {
+        arp_process(arp, now, TEST_RATE, 120.0, log_event, log);
+        uint64_t next = arp_next_event_frame(arp);
+        uint64_t step = max_block;
+        if (next > now && next - now < step) {
+            step = next - now;
+        }
+        now += step;
+    }
+}
+
+static void arpeggiator_test(void) {
+    EventLog* a = (EventLog*)calloc(1, sizeof(EventLog));
+    EventLog* b = (EventLog*)calloc(1, sizeof(EventLog));
+    Arpeggiator arp;
+
+    // Eighths at 120 BPM (11025 frames); exact frames whatever the buffer size
+    arp_init(&arp);
+    arp.enabled = true;
+    arp_note_on(&arp, 60);
+    arp_note_on(&arp, 64);
+    arp_note_on(&arp, 67);
+    run_arp(&arp, a, 4 * 11025, 4096);
+    assert(a->count == 8);
+    static const int up[] = {60, 64, 67, 60};
+    for (int k = 0; k < 4; k++) {
+        assert(a->events[k * 2].velocity > 0 && a->events[k * 2].note == up[k]);
+        assert(a->events[k * 2].sample_frame == (uint64_t)k * 11025 && "Steps land on exact frames");
+        assert(a->events[k * 2 + 1].velocity == 0 && a->events[k * 2 + 1].sample_frame == (uint64_t)k * 11025 + 8820);
+    }
+
+    // Gate length changes note length only, never the step frames
+    arp_init(&arp);
+    arp.enabled = true;
+    arp.gate = 0.25f;
+    arp_note_on(&arp, 60);
+    run_arp(&arp, b, 4 * 11025, 64);
+    assert(b->count == 8);
+    for (int k = 0; k < 4; k++) {
+        assert(b->events[k * 2].sample_frame == a->events[k * 2].sample_frame);
+        assert(b->events[k * 2 + 1].sample_frame == (uint64_t)k * 11025 + 2756);
+    }
+
+    // Up-down bounces without repeating the ends
+    arp_init(&arp);
+    arp.enabled = true;
+    arp.mode = ARP_UP_DOWN;
+    arp_note_on(&arp, 60);
+    arp_note_on(&arp, 64);
+    arp_note_on(&arp, 67);
+    a->count = 0;
+    run_arp(&arp, a, 6 * 11025, 512);
+    static const int bounce[] = {60, 64, 67, 64, 60, 64};
+    for (int k = 0; k < 6; k++) {
+        assert(a->events[k * 2].note == bounce[k]);
+    }
+
+    // Random picks come from the seeded LCG: same seed, same phrase
+    int phrases[2][16];
+    for (int run = 0; run < 2; run++) {
+        arp_init(&arp);
+        arp_set_seed(&arp, 1234u);
+        arp.enabled = true;
+        arp.mode = ARP_RANDOM;
+        for (int n = 0; n < 8; n++) {
+            arp_note_on(&arp, 48 + n);
+        }
+        a->count = 0;
+        run_arp(&arp, a, 16 * 11025, 300 + run * 700);
+        for (int k = 0; k < 16; k++) {
+            phrases[run][k] = a->events[k * 2].note;
+        }
+    }
+    assert(memcmp(phrases[0], phrases[1], sizeof(phrases[0])) == 0 && "Seeded arp must be reproducible");
+
+    // Every MIDI note can be held; releasing all ends the sounding note now
+    arp_init(&arp);
+    arp.enabled = true;
+    for (int n = 0; n < 128; n++) {
+        arp_note_on(&arp, n);
+    }
+    arp_note_on(&arp, 5);
+    assert(arp.num_held == 128 && "Pool holds every note once");
+    a->count = 0;
+    arp_process(&arp, 0, TEST_RATE, 120.0, log_event, a);
+    for (int n = 0; n < 128; n++) {
+        arp_note_off(&arp, n);
+    }
+    arp_process(&arp, 100, TEST_RATE, 120.0, log_event, a);
+    assert(a->count == 2 && a->events[1].velocity == 0 && a->events[1].sample_frame == 100);
+    assert(arp_next_event_frame(&arp) == UINT64_MAX);
+
+    // Disabling ends the sounding note and forgets the held set; re-enabling
+    // with nothing pressed stays silent
+    arp_init(&arp);
+    arp_set_enabled(&arp, true);
+    arp_note_on(&arp, 60);
+    arp_note_on(&arp, 64);
+    a->count = 0;
+    arp_process(&arp, 0, TEST_RATE, 120.0, log_event, a);
+    arp_set_enabled(&arp, false);
+    assert(arp.num_held == 0 && "Disabling clears the held notes");
+    arp_process(&arp, 100, TEST_RATE, 120.0, log_event, a);
+    assert(a->count == 2 && a->events[1].velocity == 0 && a->events[1].note == 60);
+    arp_set_enabled(&arp, true);
+    arp_process(&arp, 200, TEST_RATE, 120.0, log_event, a);
+    arp_process(&arp, 4 * 11025, TEST_RATE, 120.0, log_event, a);
+    assert(a->count == 2 && "No stale notes after re-enabling");
+
+    free(b);
+    free(a);
+}
+
+// Two engines rendering interleaved must not disturb each other's noise or
+// random sources: all generator state lives in the instance
+static void engine_reentrancy_test(void) {
+    SynthEngine* engines[2];
+    float out[2][SYNTH_BLOCK_SIZE * 2];
+    for (int e = 0; e < 2; ++e) {
+        engines[e] = (SynthEngine*)calloc(1, sizeof(SynthEngine));
+        synth_init_with_polyphony(engines[e], TEST_RATE, 4);
+        engines[e]->params[PARAM_OSC1_WAVE] = WAVE_NOISE;
+        mod_matrix_add_slot(&engines[e]->mod_matrix, MOD_SOURCE_RANDOM, MOD_DEST_FILTER_CUTOFF, 0.5f);
+        synth_note_on(engines[e], 60, 1.0f);
+    }
+    for (int block = 0; block < 64; ++block) {
+        synth_process(engines[0], out[0], SYNTH_BLOCK_SIZE);
+        synth_process(engines[1], out[1], SYNTH_BLOCK_SIZE);
+        assert(memcmp(out[0], out[1], sizeof(out[0])) == 0 && "Engines must render independently");
+    }
+
+    // A different seed gives different noise
+    synth_set_seed(engines[1], 42u);
+    synth_note_on(engines[1], 64, 1.0f);
+    synth_note_on(engines[0], 64, 1.0f);
+    synth_process(engines[0], out[0], SYNTH_BLOCK_SIZE);
+    synth_process(engines[1], out[1], SYNTH_BLOCK_SIZE);
+    assert(memcmp(out[0], out[1], sizeof(out[0])) != 0);
+    free(engines[0]);
+    free(engines[1]);
+}
+
+static bool files_equal(const char* a, const char* b) {
+    FILE* fa = fopen(a, "rb");
+    FILE* fb = fopen(b, "rb");
+    bool equal = fa && fb;
+    while (equal) {
+        int ca = fgetc(fa);
+        int cb = fgetc(fb);
+        equal = ca == cb;
+        if (ca == EOF || cb == EOF) {
+            break;
+        }
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return equal;
+}
+
+// A preset file gives the same arp rate live (patch params, UI knob) and
+// offline: both scale the arpeggiator's base rate by the stored multiplier
+static void arp_rate_parity_test(void) {
+    const char* path = "/tmp/offline_render_test/arp_rate.json";
+    PresetData saved;
+    preset_init(&saved);
+    saved.arp.enabled = true;
+    saved.arp.mode = ARP_UP;
+    saved.arp.rate_multiplier = 2.0f;
+    assert(preset_save_file(&saved, path, false));
+    PresetData preset;
+    assert(preset_load_file(&preset, path));
+    remove(path);
+
+    float params[PARAM_PARAM_COUNT] = {0};
+    preset_to_params(&preset, params);
+    float live = synth_param_clamp(PARAM_ARP_RATE, params[PARAM_ARP_RATE]);
+
+    SynthCore* core = (SynthCore*)calloc(1, sizeof(SynthCore));
+    assert(core && synth_core_init(core, TEST_RATE, 4));
+    offline_render_apply_preset(core, &preset);
+    assert(core->arp.rate == live && live == ARP_BASE_RATE * 2.0f && "Live and offline arp rates differ");
+    assert(preset_arp_rate(&preset) == live && "The UI shows the rate the patch plays");
+
+    // The multiplier survives a trip through the params, as a loaded patch's does
+    PresetData shown;
+    preset_init(&shown);
+    preset_from_params(&shown, params);
+    assert(shown.arp.rate_multiplier == 2.0f);
+    synth_core_free(core);
+    free(core);
+}
+
+// Threaded batch output is byte-identical to a single-threaded render
+static void batch_test(ProjectData* project) {
+    const char* project_path = "/tmp/offline_render_test/batch_project.json";
+    const char* preset_path = "/tmp/offline_render_test/batch_preset.json";
+    assert(project_save_file(project, project_path, false));
+    assert(preset_save_file(&project->preset, preset_path, false));
+
+    OfflineRenderOptions options;
+    offline_render_options_init(&options);
+    options.duration_seconds = 0.5f;
+    options.output_path = "/tmp/offline_render_test/reference.wav";
+    assert(offline_render_project(project, &options, NULL));
+
+    enum { JOBS = 6 };
+    OfflineRenderJob jobs[JOBS];
+    for (int i = 0; i < JOBS; ++i) {
+        offline_render_job_init(&jobs[i], (i % 2) ? preset_path : project_path, "/tmp/offline_render_test/batch");
+    }
+    offline_render_job_init(&jobs[JOBS - 1], "/tmp/offline_render_test/missing.json", "/tmp/offline_render_test/batch");
+    assert(strcmp(jobs[0].output_path, "/tmp/offline_render_test/batch/batch_project.wav") == 0);
+
+    int ok = offline_render_batch(jobs, JOBS, &options, 3);
+    assert(ok == JOBS - 1 && "Missing input fails alone");
+    // Repeated inputs share a stem; each job still gets a file of its own
+    assert(strcmp(jobs[1].output_path, "/tmp/offline_render_test/batch/batch_preset.wav") == 0);
+    assert(strcmp(jobs[2].output_path, "/tmp/offline_render_test/batch/batch_project-2.wav") == 0);
+    assert(strcmp(jobs[3].output_path, "/tmp/offline_render_test/batch/batch_preset-2.wav") == 0);
+    assert(strcmp(jobs[4].output_path, "/tmp/offline_render_test/batch/batch_project-3.wav") == 0);
+    assert(!jobs[JOBS - 1].ok);
+    for (int i = 0; i < JOBS - 1; ++i) {
+        assert(jobs[i].ok && jobs[i].stats.frames == (uint64_t)(0.5f * TEST_RATE));
+        assert(files_equal(jobs[i].output_path, options.output_path) && "Batch renders are deterministic");
+    }
+
+    for (int i = 0; i < JOBS - 1; ++i) {
+        remove(jobs[i].output_path);
+    }
+    remove("/tmp/offline_render_test/batch");
+    remove(options.output_path);
+    remove(project_path);
+    remove(preset_path);
+}
+
+int main(void) {
+    printf("Running offline_render tests...\n");
+    sequencer_step_test();
+    arpeggiator_test();
+    engine_reentrancy_test();
+
+    const char* path = "/tmp/offline_render_test/bounce.wav";
+    ProjectData project;
+    project_init(&project);
+    project.export_duration_seconds = TEST_SECONDS;
+    snprintf(project.export_path, sizeof(project.export_path), "%s", path);
+    project.preset.delay.enabled = true;
+    project.preset.reverb.enabled = true;
+
+    // Defaults come from the project; the missing directory is created
+    OfflineRenderStats stats;
+    assert(offline_render_project(&project, NULL, &stats));
+    assert(stats.frames == (uint64_t)(TEST_SECONDS * TEST_RATE));
+    assert(stats.peak > 0.01f && "Preview phrase should be audible");
+    assert(stats.render_seconds < TEST_SECONDS && "Offline bounce should beat real time");
+
+    SampleBuffer bounce;
+    sample_buffer_init(&bounce);
+    assert(sample_buffer_load_wav(&bounce, path));
+    assert(bounce.channels == 2 && bounce.sample_rate == TEST_RATE);
+    assert(bounce.frame_count == stats.frames);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < bounce.frame_count * 2; ++i) {
+        assert(isfinite(bounce.data[i]));
+        peak = fmaxf(peak, fabsf(bounce.data[i]));
+    }
+    assert(fabsf(peak - stats.peak) < 1e-6f && "Reported peak matches the file");
+    sample_buffer_free(&bounce);
+
+    // Options override the project; an empty pattern renders silence
+    Pattern empty;
+    offline_render_preview_pattern(&empty);
+    for (int i = 0; i < STEPS_PER_PATTERN; ++i) {
+        empty.steps[i].active = false;
+    }
+    OfflineRenderOptions options;
+    offline_render_options_init(&options);
+    options.output_path = "/tmp/offline_render_test/silent.wav";
+    options.duration_seconds = 0.5f;
+    options.sample_rate = 48000;
+    options.pattern = &empty;
+    assert(offline_render_project(&project, &options, &stats));
+    assert(stats.frames == 24000);
+    assert(stats.peak == 0.0f);
+
+    options.duration_seconds = 0.0f;
+    project.export_duration_seconds = 0.0f;
+    assert(!offline_render_project(&project, &options, NULL) && "Zero-length bounce is rejected");
+
+    arp_rate_parity_test();
+    batch_test(&project);
+
+    remove(path);
+    remove(options.output_path);
+    remove("/tmp/offline_render_test");
+    printf("offline_render tests passed.\n");
+    return 0;
+}
@@ -1,10 +1,37 @@
+// The checks below drive the queues, so they must run in Release builds too
+#undef NDEBUG
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "midi_input.h"
 #include "param_queue.h"
 
+typedef struct {
+    uint8_t notes[8];
+    int count;
+} NoteLog;
+
+static void note_handler(const MidiEvent* event, void* userdata) {
+    NoteLog* log = (NoteLog*)userdata;
+    if (log->count < 8) {
+        log->notes[log->count++] = event->data1;
+    }
+}
+
+typedef struct {
+    ParamMsg changes[PARAM_PARAM_COUNT];
+    int count;
+} ChangeLog;
+
+static void logging_handler(const ParamMsg* change, void* userdata) {
+    ChangeLog* log = (ChangeLog*)userdata;
+    if (log->count < PARAM_PARAM_COUNT) {
+        log->changes[log->count++] = *change;
+    }
+}
+
 static void counting_handler(const ParamMsg* change, void* userdata) {
     (void)change;
     int* counter = (int*)userdata;
@@ -72,6 +99,87 @@ int main(void) {
         assert(param_queue_dequeue(&change) == false && "Queue should be empty after drain");
     }
 
+    // Timestamped drain: immediate (0) and due events run, later ones stay queued
+    ParamMsg now_msg = {.id = PARAM_MASTER_VOLUME, .type = PARAM_FLOAT};
+    ParamMsg due_msg = {.id = PARAM_TEMPO, .type = PARAM_FLOAT, .sample_frame = 100};
+    ParamMsg late_msg = {.id = PARAM_FILTER_CUTOFF, .type = PARAM_FLOAT, .sample_frame = 164};
+    assert(param_queue_enqueue(&now_msg) == true);
+    assert(param_queue_enqueue(&due_msg) == true);
+    assert(param_queue_enqueue(&late_msg) == true);
+
+    int due = 0;
+    param_queue_drain_until(counting_handler, &due, 101);
+    assert(due == 2);
+    assert(param_queue_peek(&change) == true && change.id == PARAM_FILTER_CUTOFF);
+    assert(change.sample_frame == 164);
+
+    param_queue_drain_until(counting_handler, &due, 164);
+    assert(due == 2 && "Event stamped at the limit belongs to the next block");
+    param_queue_drain_until(counting_handler, &due, 165);
+    assert(due == 3);
+    assert(param_queue_peek(&change) == false);
+
+    // Coalescing slots: a burst of knob moves applies once, with the last value
+    ChangeLog log = {0};
+    assert(param_queue_apply_latest(logging_handler, &log) == false && "Nothing set yet");
+    for (int i = 0; i < 1000; ++i) {
+        ParamMsg cutoff = {.id = PARAM_FILTER_CUTOFF, .type = PARAM_FLOAT};
+        cutoff.value.f = (float)i;
+        assert(param_queue_set(&cutoff) == true && "Slots never fill up");
+    }
+    ParamMsg wave = {.id = PARAM_OSC1_WAVE, .type = PARAM_INT};
+    wave.value.i = 3;
+    assert(param_queue_set(&wave) == true);
+    ParamMsg arp = {.id = PARAM_ARP_ENABLED, .type = PARAM_BOOL};
+    arp.value.b = 1;
+    assert(param_queue_set(&arp) == true);
+    ParamMsg bogus = {.id = PARAM_PARAM_COUNT, .type = PARAM_FLOAT};
+    assert(param_queue_set(&bogus) == false);
+    assert(param_queue_peek(&change) == false && "Slots bypass the ring");
+
+    assert(param_queue_apply_latest(logging_handler, &log) == true);
+    assert(log.count == 3 && "One apply per changed parameter");
+    assert(log.changes[0].id == PARAM_OSC1_WAVE && log.changes[0].type == PARAM_INT);
+    assert(log.changes[0].value.i == 3);
+    assert(log.changes[1].id == PARAM_FILTER_CUTOFF && log.changes[1].type == PARAM_FLOAT);
+    assert(log.changes[1].value.f == 999.0f && "Last value wins");
+    assert(log.changes[1].sample_frame == 0);
+    assert(log.changes[2].id == PARAM_ARP_ENABLED && param_msg_get_bool(&log.changes[2]));
+    log.count = 0;
+    assert(param_queue_apply_latest(logging_handler, &log) == false && log.count == 0 &&
+           "Applied parameters are clean until set again");
+
+    // Ids in both dirty words (0 and the last one)
+    ParamMsg first = {.id = PARAM_MASTER_VOLUME, .type = PARAM_FLOAT};
+    first.value.f = 0.5f;
+    ParamMsg last = {.id = PARAM_PARAM_COUNT - 1, .type = PARAM_INT};
+    last.value.i = 1;
+    assert(param_queue_set(&last) == true);
+    assert(param_queue_set(&first) == true);
+    assert(param_queue_apply_latest(logging_handler, &log) == true && log.count == 2);
+    assert(log.changes[0].id == PARAM_MASTER_VOLUME && log.changes[1].id == PARAM_PARAM_COUNT - 1);
+
+    MidiEvent note = {.type = MIDI_EVENT_NOTE_ON, .data1 = 60, .data2 = 100, .sample_frame = 42};
+    MidiEvent peeked;
+    assert(midi_queue_enqueue(&note) == true);
+    assert(midi_queue_peek(&peeked) == true && peeked.sample_frame == 42);
+    assert(midi_queue_dequeue(&peeked) == true && peeked.data1 == 60);
+    assert(midi_queue_peek(&peeked) == false);
+
+    // A UI note goes out with the block even behind a future driver event
+    MidiEvent later = {.type = MIDI_EVENT_NOTE_ON, .data1 = 72, .data2 = 100, .sample_frame = 5000};
+    NoteLog notes = {{0}, 0};
+    uint64_t next_due = 0;
+    assert(midi_queue_enqueue(&later) == true);
+    midi_queue_send_note_on(64, 100);
+    assert(midi_queue_peek_due_frame(&next_due) == true && next_due == 0);
+    midi_queue_drain_until(note_handler, &notes, 1000);
+    assert(notes.count == 1 && notes.notes[0] == 64);
+    assert(midi_queue_peek_due_frame(&next_due) == true && next_due == 5000);
+    midi_queue_drain_until(note_handler, &notes, 6000);
+    assert(notes.count == 2 && notes.notes[1] == 72);
+    assert(midi_ui_queue_peek(&peeked) == false && midi_queue_peek(&peeked) == false);
+
     printf("param_queue tests passed.\n");
     return 0;
 }
@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <utime.h>
+
+#include "preset.h"
+#include "preset_library.h"
+
+#define TEST_ROOT "/tmp/preset_library_test"
+#define TEST_INDEX TEST_ROOT "/.preset_index.json"
+#define PRESET_COUNT 3000
+
+static const char* kCategories[] = {"Bass", "Lead", "Pad", "Keys", "Pluck"};
+static const char* kWords[] = {"Glass", "Neon", "Dub", "Velvet", "Acid", "Cloud", "Iron", "Solar"};
+
+static void write_preset(int n, const char* name_override) {
+    PresetData preset;
+    preset_init(&preset);
+    const char* category = kCategories[n % 5];
+    if (name_override) {
+        snprintf(preset.meta.name, sizeof(preset.meta.name), "%s", name_override);
+    } else {
+        snprintf(preset.meta.name, sizeof(preset.meta.name), "%s %s %04d", kWords[n % 8], category, n);
+    }
+    snprintf(preset.meta.author, sizeof(preset.meta.author), "%s", n % 3 == 0 ? "Ada" : "Moog Fan");
+    snprintf(preset.meta.category, sizeof(preset.meta.category), "%s", category);
+    char path[256];
+    snprintf(path, sizeof(path), TEST_ROOT "/bank%d/p%04d%s", n % 4, n,
+             n % 2 ? PRESET_BINARY_EXTENSION : ".json");
+    bool ok;
+    if (n % 2) {
+        ok = preset_save_binary(&preset, path);
+    } else {
+        // JSON presets can carry tags; add them by hand since PresetData has none
+        cJSON* json = preset_to_json(&preset);
+        cJSON* tags = cJSON_AddArrayToObject(cJSON_GetObjectItemCaseSensitive(json, "metadata"), "tags");
+        cJSON_AddItemToArray(tags, cJSON_CreateString(n % 4 == 0 ? "warm" : "bright"));
+        cJSON_AddItemToArray(tags, cJSON_CreateString("analog"));
+        char* text = cJSON_PrintUnformatted(json);
+        ok = preset_write_text_file(path, text, strlen(text));
+        cJSON_free(text);
+        cJSON_Delete(json);
+    }
+    assert(ok);
+    (void)ok;
+}
+
+static bool contains_ci(const char* haystack, const char* needle) {
+    for (const char* h = haystack; *h; ++h) {
+        size_t i = 0;
+        while (needle[i] && tolower((unsigned char)h[i]) == tolower((unsigned char)needle[i])) {
+            ++i;
+        }
+        if (!needle[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reference for single terms of three or more characters: a linear scan
+static size_t linear_count(PresetLibrary* library, const char* term) {
+    size_t count = 0;
+    for (size_t i = 0; i < preset_library_count(library); i++) {
+        const PresetLibraryEntry* entry = preset_library_entry(library, i);
+        if (contains_ci(entry->name, term) || contains_ci(entry->author, term) ||
+            contains_ci(entry->category, term) || contains_ci(entry->tags, term)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+    (void)system("rm -rf " TEST_ROOT);
+    mkdir(TEST_ROOT, 0755);
+    for (int b = 0; b < 4; b++) {
+        char dir[128];
+        snprintf(dir, sizeof(dir), TEST_ROOT "/bank%d", b);
+        mkdir(dir, 0755);
+    }
+    for (int n = 0; n < PRESET_COUNT; n++) {
+        write_preset(n, NULL);
+    }
+    // Not presets: a project, a broken file and an unrelated extension
+    preset_write_text_file(TEST_ROOT "/bank0/song.json", "{\"preset\":{\"values\":{}}}", 25);
+    preset_write_text_file(TEST_ROOT "/bank1/broken.json", "{ nope", 6);
+    preset_write_text_file(TEST_ROOT "/bank2/notes.txt", "hello", 5);
+
+    // First scan parses everything and saves the index
+    static PresetLibrary library;
+    preset_library_init(&library, TEST_INDEX);
+    bool ok = preset_library_add_root(&library, TEST_ROOT);
+    assert(ok);
+    PresetLibraryScanStats stats;
+    ok = preset_library_scan(&library, &stats);
+    assert(ok);
+    printf("Cold scan: %zu files, %zu parsed, %zu rejected in %.1f ms\n", stats.files, stats.parsed,
+           stats.failed, stats.seconds * 1000.0);
+    assert(stats.files == PRESET_COUNT + 2 && stats.parsed == PRESET_COUNT && stats.failed == 2);
+    assert(preset_library_poll(&library));
+    assert(preset_library_count(&library) == PRESET_COUNT);
+    for (size_t i = 1; i < preset_library_count(&library); i++) {
+        const char* a = preset_library_entry(&library, i - 1)->name;
+        const char* b = preset_library_entry(&library, i)->name;
+        assert(strcmp(a, b) <= 0 && "Entries are sorted by name");
+        (void)a;
+        (void)b;
+    }
+
+    // Trigram search agrees with a linear scan
+    const char* terms[] = {"glass", "NEON", "ada", "warm", "analog", "pad 00", "0042", "moog fan"};
+    for (size_t t = 0; t < sizeof(terms) / sizeof(terms[0]); t++) {
+        const uint32_t* results = NULL;
+        size_t count = preset_library_search(&library, terms[t], NULL, &results);
+        if (!strchr(terms[t], ' ')) {
+            assert(count == linear_count(&library, terms[t]));
+        }
+        for (size_t i = 1; i < count; i++) {
+            assert(results[i - 1] < results[i] && "Results are in name order, without repeats");
+        }
+    }
+    const uint32_t* results = NULL;
+    size_t count = preset_library_search(&library, "glass", NULL, &results);
+    assert(count == PRESET_COUNT / 8);
+    count = preset_library_search(&library, "glass bass", NULL, &results);
+    assert(count == PRESET_COUNT / 40 && "Every term must match");
+    count = preset_library_search(&library, "zzz", NULL, &results);
+    assert(count == 0);
+    count = preset_library_search(&library, "", "pad", &results);
+    assert(count == PRESET_COUNT / 5 && "Category filter is case-insensitive");
+    count = preset_library_search(&library, "", NULL, &results);
+    assert(count == PRESET_COUNT);
+
+    // Short terms match word starts
+    count = preset_library_search(&library, "v", NULL, &results);
+    assert(count == PRESET_COUNT / 8 && "Only Velvet has a word starting with v");
+    count = preset_library_search(&library, "ac", NULL, &results);
+    assert(count == PRESET_COUNT / 8);
+    count = preset_library_search(&library, "so pl", NULL, &results);
+    assert(count == PRESET_COUNT / 40);
+
+    // The same query again comes from the cache
+    const uint32_t* first = NULL;
+    size_t first_count = preset_library_search(&library, "cloud", "Keys", &first);
+    const uint32_t* again = NULL;
+    size_t again_count = preset_library_search(&library, "cloud", "Keys", &again);
+    assert(first == again && first_count == again_count && first_count == PRESET_COUNT / 40);
+    (void)first_count;
+    (void)again_count;
+
+    double started = now_seconds();
+    size_t total = 0;
+    for (int i = 0; i < 1000; i++) {
+        char query[16];
+        snprintf(query, sizeof(query), "%04d", i);
+        total += preset_library_search(&library, query, NULL, NULL);
+    }
+    double elapsed = now_seconds() - started;
+    printf("1000 uncached searches over %d presets: %.2f ms (%zu hits)\n", PRESET_COUNT, elapsed * 1000.0, total);
+
+    // A rescan with nothing changed opens no preset files
+    ok = preset_library_scan(&library, &stats);
+    assert(ok && stats.reused == PRESET_COUNT && stats.parsed == 0);
+    printf("Warm scan: %zu reused in %.1f ms\n", stats.reused, stats.seconds * 1000.0);
+
+    // A renamed preset, a touched one and a deleted one. Binary presets keep
+    // their size on rename, so both changes show up through the mtime.
+    write_preset(7, "Renamed Choir");
+    struct utimbuf later = {time(NULL) + 120, time(NULL) + 120};
+    utime(TEST_ROOT "/bank3/p0007" PRESET_BINARY_EXTENSION, &later);
+    utime(TEST_ROOT "/bank0/p0008.json", &later);
+    remove(TEST_ROOT "/bank1/p0009" PRESET_BINARY_EXTENSION);
+
+    // A fresh library picks up the saved index at once, then the background
+    // walk publishes the changes
+    preset_library_shutdown(&library);
+    preset_library_init(&library, TEST_INDEX);
+    preset_library_add_root(&library, TEST_ROOT);
+    ok = preset_library_scan_async(&library);
+    assert(ok);
+    int polls = 0;
+    bool saw_renamed = false;
+    while (true) {
+        bool scanning = preset_library_is_scanning(&library);
+        if (preset_library_poll(&library)) {
+            polls++;
+            saw_renamed = preset_library_search(&library, "renamed choir", NULL, NULL) == 1;
+        }
+        if (!scanning) {
+            break;
+        }
+        struct timespec pause = {0, 1000000L};
+        nanosleep(&pause, NULL);
+    }
+    preset_library_poll(&library);
+    preset_library_wait(&library);
+    assert(polls >= 1);
+    assert(library.last_scan.parsed == 2 && library.last_scan.reused == PRESET_COUNT - 3);
+    assert(preset_library_count(&library) == PRESET_COUNT - 1);
+    saw_renamed = preset_library_search(&library, "renamed choir", NULL, NULL) == 1;
+    assert(saw_renamed);
+    (void)saw_renamed;
+    count = preset_library_search(&library, "0009", NULL, NULL);
+    assert(count == 0 && "Deleted presets leave the index");
+    (void)count;
+
+    preset_library_shutdown(&library);
+    (void)system("rm -rf " TEST_ROOT);
+    printf("preset_library tests passed.\n");
+    return 0;
+}
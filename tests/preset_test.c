@@ -0,0 +1,211 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "preset.h"
+#include "project.h"
+
+#define LOAD_ITERATIONS 2000
+
+// Every value moved off its default so a dropped field shows up
+static void make_test_preset(PresetData* preset) {
+    preset_init(preset);
+    snprintf(preset->meta.name, sizeof(preset->meta.name), "Glass Pad");
+    snprintf(preset->meta.author, sizeof(preset->meta.author), "Tests");
+    snprintf(preset->meta.category, sizeof(preset->meta.category), "Pad");
+    snprintf(preset->meta.description, sizeof(preset->meta.description), "Slow, bright, wide");
+    preset->tempo = 97.5f;
+    preset->master_volume = 0.61f;
+    preset->filter_cutoff = 3210.5f;
+    preset->filter_resonance = 0.72f;
+    preset->filter_mode = 2;
+    preset->filter_env_amount = -0.35f;
+    preset->env_attack = 0.8f;
+    preset->env_decay = 0.45f;
+    preset->env_sustain = 0.55f;
+    preset->env_release = 2.25f;
+    preset->distortion = (PresetDistortionSettings){true, 3.5f, 0.25f};
+    preset->chorus = (PresetChorusSettings){true, 0.9f, 12.0f, 0.4f};
+    preset->delay = (PresetDelaySettings){true, 0.375f, 0.6f, 0.2f};
+    preset->reverb = (PresetReverbSettings){true, 0.85f, 0.3f, 0.45f};
+    preset->compressor = (PresetCompressorSettings){true, 0.4f, 6.0f};
+    preset->arp = (PresetArpSettings){true, 2.0f, 3};
+}
+
+// Both sides come from preset_init (zeroed padding) plus field stores
+static bool presets_equal(const PresetData* a, const PresetData* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static double seconds_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+    PresetData source;
+    make_test_preset(&source);
+
+    // Binary round trip keeps every field and the metadata
+    size_t size = preset_binary_size(&source);
+    assert(size == PRESET_BINARY_HEADER_SIZE + PRESET_BINARY_META_SIZE + 31 * PRESET_BINARY_RECORD_SIZE);
+    uint8_t* image = (uint8_t*)malloc(size);
+    size_t written = 0;
+    bool ok = preset_encode_binary(&source, image, size, &written);
+    assert(ok && written == size);
+    ok = preset_encode_binary(&source, image, size - 1, NULL);
+    assert(!ok && "Encoding refuses a short buffer");
+    assert(preset_is_binary(image, size));
+    PresetData decoded;
+    ok = preset_decode_binary(&decoded, image, size);
+    assert(ok && presets_equal(&source, &decoded));
+
+    // JSON and binary convert into each other without loss
+    cJSON* json = preset_to_json(&decoded);
+    PresetData from_json;
+    ok = preset_from_json(&from_json, json);
+    cJSON_Delete(json);
+    assert(ok && presets_equal(&source, &from_json));
+
+    // The flat ParamId array a patch is built from carries the same fields
+    float params[PARAM_PARAM_COUNT];
+    for (int i = 0; i < PARAM_PARAM_COUNT; i++) {
+        params[i] = -1.0f;
+    }
+    preset_to_params(&source, params);
+    assert(params[PARAM_FILTER_CUTOFF] == source.filter_cutoff);
+    assert(params[PARAM_OSC1_WAVE] == -1.0f && "Unstored ids are left alone");
+    PresetData from_params = source;
+    memset(&from_params.reverb, 0, sizeof(from_params.reverb));
+    from_params.filter_mode = 0;
+    preset_from_params(&from_params, params);
+    assert(presets_equal(&source, &from_params));
+
+    // preset_load_file recognises both encodings
+    const char* binary_path = "/tmp/preset_test" PRESET_BINARY_EXTENSION;
+    const char* json_path = "/tmp/preset_test.json";
+    ok = preset_save_binary(&source, binary_path) && preset_save_file(&source, json_path, false);
+    assert(ok);
+    PresetData loaded;
+    ok = preset_load_file(&loaded, binary_path);
+    assert(ok && presets_equal(&source, &loaded));
+    ok = preset_load_binary(&loaded, binary_path);
+    assert(ok && presets_equal(&source, &loaded));
+    ok = preset_load_file(&loaded, json_path);
+    assert(ok && presets_equal(&source, &loaded));
+    ok = preset_load_binary(&loaded, json_path);
+    assert(!ok && "JSON is not a binary preset");
+
+    // Damaged files are rejected before the preset is touched
+    PresetData untouched;
+    make_test_preset(&untouched);
+    PresetData target = untouched;
+    ok = preset_decode_binary(&target, image, size - 1);
+    assert(!ok && "Truncated");
+    image[size - 2] ^= 0x40;
+    ok = preset_decode_binary(&target, image, size);
+    assert(!ok && "Checksum mismatch");
+    image[size - 2] ^= 0x40;
+    preset_binary_put_u32(image + 4, PRESET_BINARY_VERSION + 1);
+    ok = preset_decode_binary(&target, image, size);
+    assert(!ok && "Newer format version");
+    preset_binary_put_u32(image + 4, PRESET_BINARY_VERSION);
+    assert(presets_equal(&untouched, &target));
+
+    // Ids this build does not store are skipped, so newer files still load
+    uint8_t* last_record = image + size - PRESET_BINARY_RECORD_SIZE;
+    preset_binary_put_u32(last_record, PARAM_PARAM_COUNT + 7);
+    preset_binary_put_u32(image + 24, preset_binary_checksum(image + PRESET_BINARY_HEADER_SIZE,
+                                                             size - PRESET_BINARY_HEADER_SIZE));
+    ok = preset_decode_binary(&decoded, image, size);
+    assert(ok);
+    PresetData expected = source;
+    expected.arp.enabled = false; // The overwritten record was the last id, PARAM_ARP_ENABLED
+    assert(presets_equal(&expected, &decoded));
+
+    // Projects: binary round trip with the preset embedded, and sniffing
+    ProjectData project;
+    project_init(&project);
+    snprintf(project.meta.name, sizeof(project.meta.name), "Night Drive");
+    snprintf(project.sample_path, sizeof(project.sample_path), "samples/night.wav");
+    snprintf(project.export_path, sizeof(project.export_path), "exports/night.wav");
+    project.export_duration_seconds = 12.0f;
+    project.tempo = 104.0f;
+    project.audio.sample_rate = 48000;
+    project.audio.period_frames = 64;
+    project.audio.periods = 2;
+    project.audio.backend = AUDIO_BACKEND_JACK;
+    project.audio.duplex = false;
+    project.audio.realtime = true;
+    project.preset = source;
+    const char* project_path = "/tmp/preset_test" PROJECT_BINARY_EXTENSION;
+    ok = project_save_binary(&project, project_path);
+    assert(ok);
+    ProjectData project_loaded;
+    ok = project_load_file(&project_loaded, project_path);
+    assert(ok);
+    assert(strcmp(project_loaded.meta.name, "Night Drive") == 0);
+    assert(strcmp(project_loaded.export_path, "exports/night.wav") == 0);
+    assert(project_loaded.export_duration_seconds == 12.0f && project_loaded.tempo == 104.0f);
+    assert(presets_equal(&source, &project_loaded.preset));
+    assert(memcmp(&project.audio, &project_loaded.audio, sizeof(project.audio)) == 0);
+
+    // A version 1 project (no audio block) still loads, with default audio
+    long project_length = 0;
+    uint8_t* v1 = (uint8_t*)preset_read_text_file(project_path, &project_length);
+    assert(v1);
+    const size_t audio_block = 32;
+    const size_t body_end = 32 + sizeof(ProjectMetadata) + 3 * 512;
+    memmove(v1 + body_end, v1 + body_end + audio_block, (size_t)project_length - body_end - audio_block);
+    preset_binary_put_u32(v1 + 4, 1);
+    preset_binary_put_u32(v1 + 8, preset_binary_get_u32(v1 + 8) - (uint32_t)audio_block);
+    preset_binary_put_u32(v1 + 16, preset_binary_get_u32(v1 + 16) - (uint32_t)audio_block);
+    preset_binary_put_u32(v1 + 20, preset_binary_checksum(v1 + 32, body_end - 32));
+    ok = project_decode_binary(&project_loaded, v1, (size_t)project_length - audio_block);
+    assert(ok);
+    assert(project_loaded.audio.sample_rate == 44100 && project_loaded.audio.duplex);
+    assert(presets_equal(&source, &project_loaded.preset));
+    free(v1);
+
+    // ...and the JSON encoding carries the audio settings too
+    cJSON* project_json = project_to_json(&project);
+    ok = project_from_json(&project_loaded, project_json);
+    cJSON_Delete(project_json);
+    assert(ok);
+    assert(memcmp(&project.audio, &project_loaded.audio, sizeof(project.audio)) == 0);
+    ok = project_load_file(&project_loaded, binary_path);
+    assert(!ok && "A binary preset is not a project");
+
+    // The fast path: decoding from memory against parsing the same patch as JSON
+    long json_length = 0;
+    char* json_text = preset_read_text_file(json_path, &json_length);
+    assert(json_text);
+    double started = seconds_now();
+    for (int i = 0; i < LOAD_ITERATIONS; i++) {
+        cJSON* parsed = cJSON_ParseWithLength(json_text, (size_t)json_length);
+        ok = preset_from_json(&loaded, parsed);
+        cJSON_Delete(parsed);
+        assert(ok);
+    }
+    double json_seconds = seconds_now() - started;
+    started = seconds_now();
+    for (int i = 0; i < LOAD_ITERATIONS; i++) {
+        ok = preset_decode_binary(&decoded, image, size);
+        assert(ok);
+    }
+    double binary_seconds = seconds_now() - started;
+    (void)ok;
+    printf("%d loads: JSON %.2f ms, binary %.2f ms (%zu vs %ld bytes)\n", LOAD_ITERATIONS,
+           json_seconds * 1000.0, binary_seconds * 1000.0, size, json_length);
+
+    free(json_text);
+    free(image);
+    remove(binary_path);
+    remove(json_path);
+    remove(project_path);
+    printf("preset tests passed.\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rt_log.h"
+
+#define PRODUCERS 4
+#define MESSAGES_PER_PRODUCER 5000
+
+static void* producer_main(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int n = 0; n < MESSAGES_PER_PRODUCER; n++) {
+        rt_log(RT_LOG_INFO, "producer %d message %d", id, n);
+    }
+    return NULL;
+}
+
+// Count lines in `file` and check each is a whole producer message
+static size_t count_lines(FILE* file, bool check_producer_format) {
+    rewind(file);
+    char line[256];
+    size_t lines = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (check_producer_format) {
+            int id = -1;
+            int n = -1;
+            int fields = sscanf(line, "producer %d message %d", &id, &n);
+            assert(fields == 2 && id >= 0 && id < PRODUCERS && n >= 0 && n < MESSAGES_PER_PRODUCER);
+            (void)fields;
+        }
+        lines++;
+    }
+    return lines;
+}
+
+int main(void) {
+    // Before init everything is dropped, and nothing crashes
+    bool logged = rt_log(RT_LOG_WARN, "too early");
+    assert(!logged);
+    assert(rt_log_dropped() == 1);
+    rt_log_init();
+    assert(rt_log_dropped() == 0);
+
+    // Levels route to the right stream, one line per record
+    FILE* out = tmpfile();
+    FILE* err = tmpfile();
+    assert(out && err);
+    logged = rt_log(RT_LOG_INFO, "note %d", 60);
+    assert(logged);
+    logged = rt_log(RT_LOG_WARN, "queue %s", "full");
+    assert(logged);
+    logged = rt_log(RT_LOG_ERROR, "error %.1f", 1.5);
+    assert(logged);
+    size_t drained = rt_log_drain(out, err);
+    assert(drained == 3);
+    rewind(out);
+    rewind(err);
+    char line[256];
+    char* got = fgets(line, sizeof(line), out);
+    assert(got && strcmp(line, "note 60\n") == 0);
+    got = fgets(line, sizeof(line), err);
+    assert(got && strcmp(line, "queue full\n") == 0);
+    got = fgets(line, sizeof(line), err);
+    assert(got && strcmp(line, "error 1.5\n") == 0);
+    (void)got;
+    fclose(out);
+    fclose(err);
+
+    // Long text is truncated to the record size
+    char long_text[300];
+    memset(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    out = tmpfile();
+    logged = rt_log(RT_LOG_INFO, "%s", long_text);
+    assert(logged);
+    drained = rt_log_drain(out, NULL);
+    assert(drained == 1);
+    rewind(out);
+    got = fgets(line, sizeof(line), out);
+    assert(got && strlen(line) == RT_LOG_TEXT); // RT_LOG_TEXT - 1 characters plus the newline
+    fclose(out);
+
+    // A full ring drops and counts instead of waiting
+    for (int i = 0; i < RT_LOG_CAPACITY + 10; i++) {
+        rt_log(RT_LOG_INFO, "fill %d", i);
+    }
+    assert(rt_log_dropped() == 10);
+    drained = rt_log_drain(NULL, NULL);
+    assert(drained == RT_LOG_CAPACITY);
+
+    // Several producers against a concurrent drain: every message is either
+    // written whole or counted as dropped
+    rt_log_init();
+    out = tmpfile();
+    pthread_t producers[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; i++) {
+        int created = pthread_create(&producers[i], NULL, producer_main, (void*)(intptr_t)i);
+        assert(created == 0);
+        (void)created;
+    }
+    for (int i = 0; i < 200; i++) {
+        rt_log_drain(out, NULL);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    rt_log_drain(out, NULL);
+    size_t lines = count_lines(out, true);
+    fclose(out);
+    printf("Concurrent producers: %zu written, %u dropped\n", lines, rt_log_dropped());
+    assert(lines + rt_log_dropped() == PRODUCERS * MESSAGES_PER_PRODUCER);
+    assert(lines > 0);
+
+    // Stopping the writer thread empties the ring
+    rt_log_init();
+    bool started = rt_log_writer_start();
+    assert(started);
+    (void)started;
+    logged = rt_log(RT_LOG_INFO, "rt_log writer thread online");
+    assert(logged);
+    (void)logged;
+    rt_log_writer_stop();
+    drained = rt_log_drain(NULL, NULL);
+    assert(drained == 0);
+    (void)drained;
+
+    printf("rt_log tests passed.\n");
+    return 0;
+}
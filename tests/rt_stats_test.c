@@ -0,0 +1,115 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rt_stats.h"
+#include "third_party/cjson/cJSON.h"
+
+// 512 frames at 51.2 kHz: a 10 ms budget, so each histogram bucket is 400 us
+#define TEST_RATE 51200.0f
+#define TEST_FRAMES 512
+#define MS 1000000ull
+#define T0 (1000ull * MS)
+
+static bool near(double a, double b) {
+    return fabs(a - b) < 1e-6;
+}
+
+static cJSON* child(const cJSON* object, const char* name) {
+    return cJSON_GetObjectItemCaseSensitive(object, name);
+}
+
+int main(void) {
+    static RtStats stats;
+    RtStatsSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    rt_stats_init(&stats, TEST_RATE);
+    bool polled = rt_stats_poll(&stats, &snapshot);
+    assert(!polled && "Nothing is published before the first callback");
+
+    // 101 callbacks a period apart, 2 ms each. Callback 10 overruns at 11 ms,
+    // and from callback 50 on the starts slip by one period (one late start).
+    // The UI polls after every callback.
+    int publishes = 0;
+    for (int k = 0; k <= 100; k++) {
+        uint64_t start = T0 + (uint64_t)k * 10 * MS + (k >= 50 ? 10 * MS : 0);
+        uint64_t length = k == 10 ? 11 * MS : 2 * MS;
+        rt_stats_begin_at(&stats, TEST_FRAMES, start);
+        rt_stats_add_stage(&stats, RT_STAGE_VOICES, k == 10 ? 9 * MS : 1 * MS);
+        rt_stats_add_stage(&stats, RT_STAGE_FX, MS / 4);
+        rt_stats_add_stage(&stats, RT_STAGE_FX, MS / 4);
+        rt_stats_set_queue_drops(&stats, 1, 2, 3);
+        rt_stats_end_at(&stats, k % 8, start + length);
+        if (rt_stats_poll(&stats, &snapshot)) {
+            publishes++;
+            assert(snapshot.callbacks == (uint64_t)k + 1 && "Poll returns the newest snapshot");
+        }
+    }
+    polled = rt_stats_poll(&stats, &snapshot);
+    assert(!polled && "A snapshot is read only once");
+
+    // Published at callbacks 0, 25, 50, 75 and 100 (every 250 ms)
+    assert(publishes == 5);
+    assert(snapshot.callbacks == 101);
+    assert(snapshot.frames == TEST_FRAMES);
+    assert(near(snapshot.budget_us, 10000.0));
+    assert(snapshot.overruns == 1);
+    assert(snapshot.late_callbacks == 1);
+    assert(near(snapshot.min_us, 2000.0));
+    assert(near(snapshot.max_us, 11000.0));
+    assert(near(snapshot.mean_us, (100.0 * 2000.0 + 11000.0) / 101.0));
+    assert(near(snapshot.p99_us, 2400.0) && "p99 is the top of the 20-24% bucket");
+    assert(snapshot.histogram[5] == 100 && snapshot.histogram[27] == 1);
+    assert(near(snapshot.stage_mean_us[RT_STAGE_VOICES], (100.0 * 1000.0 + 9000.0) / 101.0));
+    assert(near(snapshot.stage_max_us[RT_STAGE_VOICES], 9000.0));
+    assert(near(snapshot.stage_mean_us[RT_STAGE_FX], 500.0) && "Stage time accumulates within a callback");
+    assert(near(snapshot.stage_max_us[RT_STAGE_FX], 500.0));
+    assert(snapshot.stage_max_us[RT_STAGE_TRACKS] == 0.0);
+    assert(snapshot.active_voices == 100 % 8 && snapshot.peak_voices == 7);
+    assert(snapshot.param_drops == 1 && snapshot.midi_drops == 2 && snapshot.seq_drops == 3);
+    printf("Callback stats: mean %.0f us, p99 %.0f us, max %.0f us\n",
+           snapshot.mean_us, snapshot.p99_us, snapshot.max_us);
+
+    // The stats survive a JSON round trip
+    const char* path = "rt_stats_test.json";
+    bool saved = rt_stats_save_json(&snapshot, path);
+    assert(saved);
+    (void)saved;
+    FILE* file = fopen(path, "rb");
+    assert(file);
+    char text[8192];
+    size_t length = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    remove(path);
+    text[length] = '\0';
+    cJSON* root = cJSON_Parse(text);
+    assert(root);
+    assert(child(root, "callbacks")->valuedouble == 101.0);
+    assert(child(root, "overruns")->valuedouble == 1.0);
+    assert(child(child(root, "queue_drops"), "seq")->valuedouble == 3.0);
+    assert(near(child(child(child(root, "stages"), "voices"), "max_us")->valuedouble, 9000.0));
+    const cJSON* counts = child(child(root, "histogram"), "counts");
+    assert(cJSON_GetArraySize(counts) == RT_STATS_BUCKETS);
+    assert(cJSON_GetArrayItem(counts, 5)->valuedouble == 100.0);
+    cJSON_Delete(root);
+
+    // A reset lands at the next callback and clears everything
+    rt_stats_request_reset(&stats);
+    uint64_t start = T0 + 5000 * MS;
+    rt_stats_begin_at(&stats, TEST_FRAMES, start);
+    rt_stats_end_at(&stats, 3, start + 3 * MS);
+    polled = rt_stats_poll(&stats, &snapshot);
+    assert(polled);
+    (void)polled;
+    assert(snapshot.callbacks == 1);
+    assert(snapshot.overruns == 0 && snapshot.late_callbacks == 0 && "No late start right after a reset");
+    assert(near(snapshot.min_us, 3000.0) && near(snapshot.max_us, 3000.0));
+    assert(snapshot.peak_voices == 3);
+    assert(snapshot.histogram[5] == 0 && snapshot.histogram[7] == 1);
+    assert(strcmp(rt_stage_name(RT_STAGE_SNIPPETS), "snippets") == 0);
+
+    printf("rt_stats tests passed.\n");
+    return 0;
+}
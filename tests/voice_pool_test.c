@@ -0,0 +1,119 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dsp_math.h"
+#include "synth_engine.h"
+#include "voice_pool.h"
+
+#define TEST_RATE 44100.0f
+#define TEST_VOICES 24
+#define TEST_FRAMES 256
+#define TEST_BLOCKS 200   // ~1.2 s, long enough to cover note-offs and releases
+
+// A chord mixing SoA-eligible saws with scalar-only noise voices, released
+// halfway so voices retire while the pool is in use. The noise voices hold
+// the patch they started on while the rest play a saw patch.
+static void render_take(SynthEngine* synth, VoicePool* pool, int min_voices, float* out) {
+    synth_init_with_polyphony(synth, TEST_RATE, TEST_VOICES);
+    synth->params[PARAM_OSC1_WAVE] = WAVE_NOISE;
+    synth_set_voice_pool(synth, pool, min_voices);
+    for (int n = 0; n < TEST_VOICES; n += 3) {
+        synth_note_on(synth, 36 + n * 2, 0.7f);
+    }
+    SynthPatch saw;
+    synth_patch_init(&saw);
+    synth_load_patch(synth, &saw);
+    for (int n = 0; n < TEST_VOICES; ++n) {
+        if (n % 3 != 0) {
+            synth_note_on(synth, 36 + n * 2, 0.7f);
+        }
+    }
+    for (int b = 0; b < TEST_BLOCKS; ++b) {
+        if (b == TEST_BLOCKS / 2) {
+            for (int n = 0; n < TEST_VOICES; n += 2) {
+                synth_note_off(synth, 36 + n * 2);
+            }
+        }
+        synth_process(synth, out + (size_t)b * TEST_FRAMES * 2, TEST_FRAMES);
+    }
+}
+
+static float max_difference(const float* a, const float* b, size_t count) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float d = fabsf(a[i] - b[i]);
+        if (d > diff) {
+            diff = d;
+        }
+    }
+    return diff;
+}
+
+int main(void) {
+    printf("Running voice_pool tests...\n");
+    dsp_math_init();
+
+    size_t samples = (size_t)TEST_BLOCKS * TEST_FRAMES * 2;
+    SynthEngine* synth = (SynthEngine*)malloc(sizeof(SynthEngine));
+    float* reference = (float*)malloc(samples * sizeof(float));
+    float* pooled = (float*)malloc(samples * sizeof(float));
+    float* repeat = (float*)malloc(samples * sizeof(float));
+    assert(synth && reference && pooled && repeat);
+
+    assert(voice_pool_worker_count(NULL) == 0);
+    voice_pool_destroy(NULL); // No-op
+
+    render_take(synth, NULL, 0, reference);
+    float peak = 0.0f;
+    for (size_t i = 0; i < samples; ++i) {
+        peak = fmaxf(peak, fabsf(reference[i]));
+    }
+    assert(peak > 0.01f && "Reference take should be audible");
+
+    // Only the summation order differs from the single-threaded path
+    VoicePool* pool = voice_pool_create(3);
+    assert(pool && voice_pool_worker_count(pool) == 3);
+    render_take(synth, pool, 1, pooled);
+    float diff = max_difference(reference, pooled, samples);
+    printf("  3 workers vs single-threaded: max diff %.2e\n", diff);
+    assert(diff < 1e-5f && "Pooled render should match the single-threaded mix");
+
+    // Job-order summing makes the result independent of the worker count
+    VoicePool* single = voice_pool_create(1);
+    assert(single && voice_pool_worker_count(single) == 1);
+    render_take(synth, single, 1, repeat);
+    assert(memcmp(pooled, repeat, samples * sizeof(float)) == 0 && "Worker count must not change output");
+    render_take(synth, pool, 1, repeat);
+    assert(memcmp(pooled, repeat, samples * sizeof(float)) == 0 && "Pooled renders must repeat exactly");
+
+    // Idle workers block instead of polling: a quarter second between blocks
+    // costs next to no CPU, and the next block still wakes every worker
+    clock_t idle_start = clock();
+    struct timespec pause = {0, 250000000L};
+    nanosleep(&pause, NULL);
+    double idle_cpu = (double)(clock() - idle_start) / CLOCKS_PER_SEC;
+    printf("  4 idle workers: %.1f ms CPU in 250 ms\n", idle_cpu * 1000.0);
+    assert(idle_cpu < 0.004 && "Idle workers must sleep, not spin");
+    render_take(synth, pool, 1, repeat);
+    assert(memcmp(pooled, repeat, samples * sizeof(float)) == 0 && "Woken workers must render the same");
+
+    // Below the threshold the engine keeps the single-threaded path
+    render_take(synth, pool, TEST_VOICES + 1, repeat);
+    assert(memcmp(reference, repeat, samples * sizeof(float)) == 0 && "Threshold should bypass the pool");
+
+    voice_pool_destroy(single);
+    voice_pool_destroy(pool);
+    free(repeat);
+    free(pooled);
+    free(reference);
+    free(synth);
+
+    printf("voice_pool tests passed.\n");
+    return 0;
+}
@@ -154,3 +154,108 @@ void ui_draw_mod_meter(struct nk_command_buffer* cmd,
 
     nk_stroke_line(cmd, center, inner.y, center, inner.y + inner.h, 1.0f, palette->border);
 }
+
+static float db_fraction(float db, float floor_db) {
+    if (floor_db >= 0.0f) {
+        return 0.0f;
+    }
+    return clamp01(1.0f - db / floor_db);
+}
+
+static float amplitude_fraction(float amplitude, float floor_db) {
+    if (amplitude <= 0.0f) {
+        return 0.0f;
+    }
+    return db_fraction(20.0f * log10f(amplitude), floor_db);
+}
+
+static struct nk_rect inset_rect(struct nk_rect bounds, float inset) {
+    struct nk_rect inner = bounds;
+    inner.x += inset;
+    inner.y += inset;
+    inner.w = inner.w > inset * 2.0f ? inner.w - inset * 2.0f : inner.w;
+    inner.h = inner.h > inset * 2.0f ? inner.h - inset * 2.0f : inner.h;
+    return inner;
+}
+
+void ui_draw_level_meter(struct nk_command_buffer* cmd,
+                         struct nk_rect bounds,
+                         float peak,
+                         float rms,
+                         float floor_db) {
+    if (!cmd) {
+        return;
+    }
+    const UiPalette* palette = ui_style_palette();
+    nk_fill_rect(cmd, bounds, 3.0f, palette->panel_bezel);
+    struct nk_rect inner = inset_rect(bounds, 2.0f);
+    nk_fill_rect(cmd, inner, 2.0f, palette->panel_inset);
+
+    struct nk_rect fill = inner;
+    fill.w = inner.w * amplitude_fraction(rms, floor_db);
+    nk_fill_rect(cmd, fill, 2.0f, palette->meter_positive);
+
+    // Anything at or over full scale lights the tick as a clip warning
+    const float peak_x = inner.x + inner.w * amplitude_fraction(peak, floor_db);
+    const struct nk_color tick = peak >= 1.0f ? palette->meter_negative : palette->text;
+    nk_stroke_line(cmd, peak_x, inner.y, peak_x, inner.y + inner.h, 2.0f, tick);
+}
+
+void ui_draw_scope(struct nk_command_buffer* cmd,
+                   struct nk_rect bounds,
+                   const float* samples,
+                   int count) {
+    if (!cmd) {
+        return;
+    }
+    const UiPalette* palette = ui_style_palette();
+    nk_fill_rect(cmd, bounds, 3.0f, palette->panel_inset);
+    const float mid = bounds.y + bounds.h * 0.5f;
+    nk_stroke_line(cmd, bounds.x, mid, bounds.x + bounds.w, mid, 1.0f, palette->border);
+    if (!samples || count < 2 || bounds.w < 2.0f) {
+        return;
+    }
+
+    // One min/max column per pixel keeps the cost bounded by the width
+    const int columns = (int)bounds.w;
+    const float half = bounds.h * 0.5f;
+    for (int x = 0; x < columns; ++x) {
+        int begin = (int)((long long)x * count / columns);
+        int end = (int)((long long)(x + 1) * count / columns);
+        if (end <= begin) {
+            end = begin + 1;
+        }
+        float lo = samples[begin];
+        float hi = samples[begin];
+        for (int i = begin + 1; i < end && i < count; ++i) {
+            lo = fminf(lo, samples[i]);
+            hi = fmaxf(hi, samples[i]);
+        }
+        lo = lo < -1.0f ? -1.0f : lo;
+        hi = hi > 1.0f ? 1.0f : hi;
+        const float px = bounds.x + (float)x + 0.5f;
+        nk_stroke_line(cmd, px, mid - hi * half, px, mid - lo * half + 1.0f, 1.0f, palette->accent);
+    }
+}
+
+void ui_draw_spectrum(struct nk_command_buffer* cmd,
+                      struct nk_rect bounds,
+                      const float* bands_db,
+                      int count,
+                      float floor_db) {
+    if (!cmd) {
+        return;
+    }
+    const UiPalette* palette = ui_style_palette();
+    nk_fill_rect(cmd, bounds, 3.0f, palette->panel_inset);
+    if (!bands_db || count <= 0) {
+        return;
+    }
+    const float slot = bounds.w / (float)count;
+    const float gap = slot > 3.0f ? 1.0f : 0.0f;
+    for (int b = 0; b < count; ++b) {
+        const float h = bounds.h * db_fraction(bands_db[b], floor_db);
+        struct nk_rect bar = {bounds.x + slot * (float)b, bounds.y + bounds.h - h, slot - gap, h};
+        nk_fill_rect(cmd, bar, 0.0f, palette->meter_positive);
+    }
+}
@@ -30,6 +30,27 @@ void ui_draw_mod_meter(struct nk_command_buffer* cmd,
                        struct nk_rect bounds,
                        float amount);
 
+// Horizontal level bar: RMS filled, peak as a tick. Levels are linear
+// amplitude, drawn on a dB scale from floor_db to 0 dB.
+void ui_draw_level_meter(struct nk_command_buffer* cmd,
+                         struct nk_rect bounds,
+                         float peak,
+                         float rms,
+                         float floor_db);
+
+// Waveform of `count` samples in -1..1, scaled to the bounds
+void ui_draw_scope(struct nk_command_buffer* cmd,
+                   struct nk_rect bounds,
+                   const float* samples,
+                   int count);
+
+// One bar per band, dB from floor_db to 0 dB
+void ui_draw_spectrum(struct nk_command_buffer* cmd,
+                      struct nk_rect bounds,
+                      const float* bands_db,
+                      int count,
+                      float floor_db);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,77 @@
+// The command buffer is read directly, so match the app's Nuklear configuration
+#include "nuklear_config.h"
+#include "frame_pacer.h"
+
+#include <string.h>
+
+#define UI_SETTLE_SECONDS (1.0 / 60.0)
+
+void ui_frame_pacer_init(UiFramePacer* pacer, double meter_hz, double idle_hz) {
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->meter_interval = meter_hz > 0.0 ? 1.0 / meter_hz : 1.0 / 30.0;
+    pacer->idle_interval = idle_hz > 0.0 ? 1.0 / idle_hz : 0.5;
+    pacer->settle_interval = UI_SETTLE_SECONDS;
+}
+
+double ui_frame_pacer_wait_time(UiFramePacer* pacer, double now, bool animating) {
+    double wait = animating ? pacer->meter_interval : pacer->idle_interval;
+    if (pacer->settle && pacer->settle_interval < wait) {
+        wait = pacer->settle_interval;
+    }
+    if (!pacer->valid) {
+        wait = 0.0;
+    }
+    pacer->deadline = now + wait;
+    pacer->wakes++;
+    return wait;
+}
+
+bool ui_frame_pacer_woke_for_input(const UiFramePacer* pacer, double now) {
+    // A millisecond of slack for timer granularity
+    return now + 0.001 < pacer->deadline;
+}
+
+// 64-bit words through a multiply-xorshift mix; the tail is padded with zeros
+uint64_t ui_frame_pacer_hash(const struct nk_context* ctx) {
+    const unsigned char* bytes = (const unsigned char*)nk_buffer_memory_const(&ctx->memory);
+    size_t size = ctx->memory.allocated;
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ (uint64_t)size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, size - i);
+        hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+bool ui_frame_pacer_frame_changed(UiFramePacer* pacer, const struct nk_context* ctx,
+                                  int width, int height, bool input) {
+    uint64_t hash = ui_frame_pacer_hash(ctx);
+    bool changed = !pacer->valid || hash != pacer->last_hash ||
+                   width != pacer->last_width || height != pacer->last_height;
+    // Only input earns a settle frame; a meter that changes on every tick
+    // would otherwise keep the loop at full rate
+    pacer->settle = changed && input;
+    if (changed) {
+        pacer->last_hash = hash;
+        pacer->last_width = width;
+        pacer->last_height = height;
+        pacer->valid = true;
+        pacer->frames_rendered++;
+    } else {
+        pacer->frames_skipped++;
+    }
+    return changed;
+}
+
+void ui_frame_pacer_invalidate(UiFramePacer* pacer) {
+    pacer->valid = false;
+}
@@ -0,0 +1,63 @@
+#ifndef UI_FRAME_PACER_H
+#define UI_FRAME_PACER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nuklear.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Idle-aware pacing for the GUI loop.
+ *
+ * The loop sleeps in glfwWaitEventsTimeout() until input arrives or the
+ * pacer's deadline passes: a capped meter rate while something animates
+ * (voices sounding, transport running, a take recording), a slow
+ * housekeeping tick otherwise. Each wake still builds the Nuklear frame,
+ * which is cheap; the pacer hashes the command buffer and the loop only
+ * converts, uploads and swaps when the hash or framebuffer size changed.
+ * A frame that input changed is followed by one quick settle frame, since
+ * Nuklear resolves hover and popups a frame late.
+ */
+
+typedef struct {
+    double meter_interval;     // Seconds between wakes while animating
+    double idle_interval;      // Seconds between housekeeping wakes
+    double settle_interval;    // Follow-up after input changed the frame
+    double deadline;           // When the current wait times out
+    bool settle;
+
+    uint64_t last_hash;
+    int last_width;
+    int last_height;
+    bool valid;                // last_hash matches what is on screen
+
+    uint64_t wakes;
+    uint64_t frames_rendered;
+    uint64_t frames_skipped;
+} UiFramePacer;
+
+void ui_frame_pacer_init(UiFramePacer* pacer, double meter_hz, double idle_hz);
+
+// Seconds to wait for events from `now` (0: poll and go straight on)
+double ui_frame_pacer_wait_time(UiFramePacer* pacer, double now, bool animating);
+// After the wait: true if an event ended it before the deadline
+bool ui_frame_pacer_woke_for_input(const UiFramePacer* pacer, double now);
+
+// After building the frame: true if it differs from what is on screen and
+// must be rendered. Otherwise the caller drops it with nk_clear().
+bool ui_frame_pacer_frame_changed(UiFramePacer* pacer, const struct nk_context* ctx,
+                                  int width, int height, bool input);
+// The window contents were lost (expose, context change); render next frame
+void ui_frame_pacer_invalidate(UiFramePacer* pacer);
+
+uint64_t ui_frame_pacer_hash(const struct nk_context* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_FRAME_PACER_H
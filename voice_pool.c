@@ -0,0 +1,465 @@
+/**
+ * Parallel Voice Rendering - worker pool and work stealing
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
+#include "voice_pool.h"
+#include "denormal.h"
+#include "voice_simd.h"
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#define POOL_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define POOL_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define POOL_CPU_RELAX() ((void)0)
+#endif
+
+#define VOICE_POOL_MAX_PARTICIPANTS (VOICE_POOL_MAX_WORKERS + 1)
+#define VOICE_POOL_SPIN_ROUNDS 2000      // Busy-poll this long after the last job, then block
+
+// Counting semaphore the audio thread posts once per sleeping worker
+#if defined(_WIN32)
+typedef HANDLE PoolSemaphore;
+#elif defined(__APPLE__)
+typedef dispatch_semaphore_t PoolSemaphore;
+#else
+typedef sem_t PoolSemaphore;
+#endif
+
+typedef struct {
+    Voice* voices[VOICE_SIMD_LANES];
+    int count;
+    bool simd;
+    float left[SYNTH_BLOCK_SIZE];
+    float right[SYNTH_BLOCK_SIZE];
+} VoiceJob;
+
+// One job range per participant: generation << 32 | next << 16 | end.
+// The generation makes a claim against last block's range fail its CAS.
+typedef struct {
+    atomic_ullong range;
+    char pad[64 - sizeof(atomic_ullong)]; // Own cache line
+} PoolRange;
+
+typedef struct {
+    VoicePool* pool;
+    int index;            // Participant index (the audio thread is 0)
+#if defined(_WIN32)
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} PoolWorker;
+
+struct VoicePool {
+    PoolRange ranges[VOICE_POOL_MAX_PARTICIPANTS];
+    int participants;
+    uint32_t generation;
+    atomic_int pending;   // Jobs of the current block not yet finished
+    atomic_int stop;
+    atomic_int sleepers;  // Workers blocked (or about to block) on `wake`
+    atomic_int audio_cpu; // Core the audio thread last rendered on; -1 = unknown
+    PoolSemaphore wake;
+
+    // Current block, written by the audio thread before ranges are published
+    VoiceJob jobs[VOICE_POOL_MAX_JOBS];
+    int num_frames;
+    float sample_rate;
+
+    float scratch[VOICE_POOL_MAX_PARTICIPANTS][SYNTH_BLOCK_SIZE];
+    PoolWorker workers[VOICE_POOL_MAX_WORKERS];
+    int worker_count;
+    atomic_int setup_warned;
+};
+
+// ============================================================================
+// PLATFORM
+// ============================================================================
+
+static bool pool_semaphore_init(PoolSemaphore* sem) {
+#if defined(_WIN32)
+    *sem = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+    return *sem != NULL;
+#elif defined(__APPLE__)
+    *sem = dispatch_semaphore_create(0);
+    return *sem != NULL;
+#else
+    return sem_init(sem, 0, 0) == 0;
+#endif
+}
+
+static void pool_semaphore_destroy(PoolSemaphore* sem) {
+#if defined(_WIN32)
+    CloseHandle(*sem);
+#elif defined(__APPLE__)
+    dispatch_release(*sem);
+#else
+    sem_destroy(sem);
+#endif
+}
+
+// Never blocks: safe on the audio thread
+static void pool_semaphore_post(PoolSemaphore* sem) {
+#if defined(_WIN32)
+    ReleaseSemaphore(*sem, 1, NULL);
+#elif defined(__APPLE__)
+    dispatch_semaphore_signal(*sem);
+#else
+    sem_post(sem);
+#endif
+}
+
+static void pool_semaphore_wait(PoolSemaphore* sem) {
+#if defined(_WIN32)
+    WaitForSingleObject(*sem, INFINITE);
+#elif defined(__APPLE__)
+    dispatch_semaphore_wait(*sem, DISPATCH_TIME_FOREVER);
+#else
+    while (sem_wait(sem) != 0) {
+        // EINTR: wait again
+    }
+#endif
+}
+
+// Core the calling thread runs on, or -1 where the OS doesn't say
+static int pool_current_cpu(void) {
+#if defined(_WIN32)
+    return (int)GetCurrentProcessorNumber();
+#elif defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// ============================================================================
+// JOBS
+// ============================================================================
+
+static int pool_claim(PoolRange* range) {
+    uint64_t current = atomic_load_explicit(&range->range, memory_order_acquire);
+    while (1) {
+        uint32_t next = (uint32_t)(current >> 16) & 0xFFFFu;
+        uint32_t end = (uint32_t)current & 0xFFFFu;
+        if (next >= end) {
+            return -1;
+        }
+        if (atomic_compare_exchange_weak_explicit(&range->range, &current, current + (1ull << 16),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return (int)next;
+        }
+    }
+}
+
+static void pool_run_job(VoicePool* pool, int index, float* scratch) {
+    VoiceJob* job = &pool->jobs[index];
+    int num_frames = pool->num_frames;
+    memset(job->left, 0, sizeof(float) * (size_t)num_frames);
+    memset(job->right, 0, sizeof(float) * (size_t)num_frames);
+    if (job->simd) {
+        voice_simd_render_group(job->voices, job->count, job->left, job->right,
+                                num_frames, pool->sample_rate);
+    } else {
+        voice_render_block(job->voices[0], scratch, job->left, job->right,
+                           num_frames, pool->sample_rate);
+    }
+    atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+}
+
+// Drain our own range, then steal from everyone else's; true if any job ran
+static bool pool_work(VoicePool* pool, int self) {
+    bool worked = false;
+    for (int k = 0; k < pool->participants; k++) {
+        PoolRange* range = &pool->ranges[(self + k) % pool->participants];
+        int index;
+        while ((index = pool_claim(range)) >= 0) {
+            pool_run_job(pool, index, pool->scratch[self]);
+            worked = true;
+        }
+    }
+    return worked;
+}
+
+static void pool_push_job(VoicePool* pool, int* job_count, Voice* const* voices, int count, bool simd) {
+    VoiceJob* job = &pool->jobs[(*job_count)++];
+    for (int i = 0; i < count; i++) {
+        job->voices[i] = voices[i];
+    }
+    job->count = count;
+    job->simd = simd;
+}
+
+void voice_pool_render(VoicePool* pool, SynthEngine* synth, int num_frames) {
+    if (!pool || !synth || num_frames <= 0) {
+        return;
+    }
+    if (num_frames > SYNTH_BLOCK_SIZE) {
+        num_frames = SYNTH_BLOCK_SIZE;
+    }
+
+    // Same grouping as the single-threaded path: SoA groups plus scalar voices
+    int job_count = 0;
+    Voice* lane_voices[VOICE_SIMD_LANES];
+    int lane_count = 0;
+    for (int k = 0; k < synth->num_active_voices; k++) {
+        Voice* voice = &synth->voices[synth->active_voices[k]];
+        if (synth->simd_voices && voice_simd_eligible(voice)) {
+            lane_voices[lane_count++] = voice;
+            if (lane_count == VOICE_SIMD_LANES) {
+                pool_push_job(pool, &job_count, lane_voices, lane_count, true);
+                lane_count = 0;
+            }
+        } else {
+            pool_push_job(pool, &job_count, &voice, 1, false);
+        }
+    }
+    if (lane_count > 0) {
+        pool_push_job(pool, &job_count, lane_voices, lane_count, true);
+    }
+    if (job_count == 0) {
+        return;
+    }
+    pool->num_frames = num_frames;
+    pool->sample_rate = synth->sample_rate;
+    atomic_store_explicit(&pool->pending, job_count, memory_order_relaxed);
+
+    // Workers keep off the audio thread's core; they re-pin when it moves
+    int cpu = pool_current_cpu();
+    if (cpu != atomic_load_explicit(&pool->audio_cpu, memory_order_relaxed)) {
+        atomic_store_explicit(&pool->audio_cpu, cpu, memory_order_relaxed);
+    }
+
+    // Deal contiguous ranges; the release stores publish the jobs above
+    pool->generation++;
+    int per = job_count / pool->participants;
+    int extra = job_count % pool->participants;
+    int begin = 0;
+    for (int p = 0; p < pool->participants; p++) {
+        int end = begin + per + (p < extra ? 1 : 0);
+        uint64_t packed = ((uint64_t)pool->generation << 32) | ((uint64_t)begin << 16) | (uint64_t)end;
+        atomic_store_explicit(&pool->ranges[p].range, packed, memory_order_release);
+        begin = end;
+    }
+    // Ranges are out before the count is taken, so a worker that registers
+    // after this still finds the work when it re-checks
+    int sleeping = atomic_exchange(&pool->sleepers, 0);
+    for (int i = 0; i < sleeping; i++) {
+        pool_semaphore_post(&pool->wake);
+    }
+
+    // Work alongside the pool, then wait only for jobs already in flight
+    pool_work(pool, 0);
+    while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0) {
+        POOL_CPU_RELAX();
+    }
+
+    // Sum in job order so the mix is the same whoever rendered what
+    for (int j = 0; j < job_count; j++) {
+        const VoiceJob* job = &pool->jobs[j];
+        for (int n = 0; n < num_frames; n++) {
+            synth->mix_left[n] += job->left[n];
+            synth->mix_right[n] += job->right[n];
+        }
+    }
+}
+
+// ============================================================================
+// WORKERS
+// ============================================================================
+
+static int pool_core_count(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cores = (int)info.dwNumberOfProcessors;
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cores > 0 ? cores : 1;
+}
+
+// Real-time priority, best effort
+static void pool_setup_worker_thread(VoicePool* pool) {
+#if defined(_WIN32)
+    bool ok = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)) / 2;
+    bool ok = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+    if (!ok && atomic_exchange(&pool->setup_warned, 1) == 0) {
+        fprintf(stderr, "⚠️ Voice workers running without real-time priority\n");
+    }
+}
+
+// A dedicated core other than the audio thread's (`avoid`, -1 if unknown):
+// worker k takes the k-th of the remaining cores. A FIFO worker sharing the
+// audio thread's core would preempt it mid-block.
+static void pool_pin_worker(int index, int avoid) {
+    int cores = pool_core_count();
+    int usable = avoid >= 0 && avoid < cores ? cores - 1 : cores;
+    if (usable < 1 || cores < 2) {
+        return;
+    }
+    int core = (index - 1) % usable;
+    if (avoid >= 0 && core >= avoid) {
+        core++;
+    }
+#if defined(_WIN32)
+    if (core < (int)(sizeof(DWORD_PTR) * 8)) {
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core);
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI pool_worker_main(LPVOID arg) {
+#else
+static void* pool_worker_main(void* arg) {
+#endif
+    PoolWorker* worker = (PoolWorker*)arg;
+    VoicePool* pool = worker->pool;
+    pool_setup_worker_thread(pool);
+    denormal_flush_begin();   // The thread only ever renders voices
+
+    int avoiding = -2;        // Audio core the current pinning keeps clear of
+    unsigned int idle_rounds = 0;
+    while (!atomic_load_explicit(&pool->stop, memory_order_relaxed)) {
+        int audio_cpu = atomic_load_explicit(&pool->audio_cpu, memory_order_relaxed);
+        if (audio_cpu != avoiding) {
+            pool_pin_worker(worker->index, audio_cpu);
+            avoiding = audio_cpu;
+        }
+        if (pool_work(pool, worker->index)) {
+            idle_rounds = 0;
+        } else if (idle_rounds < VOICE_POOL_SPIN_ROUNDS) {
+            idle_rounds++;
+            POOL_CPU_RELAX();
+        } else {
+            // Register, then look once more: a block published before the
+            // audio thread took the count is found here, any later one posts
+            atomic_fetch_add(&pool->sleepers, 1);
+            if (!pool_work(pool, worker->index) && !atomic_load(&pool->stop)) {
+                pool_semaphore_wait(&pool->wake);
+            }
+            idle_rounds = 0;
+        }
+    }
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+VoicePool* voice_pool_create(int workers) {
+    if (workers <= 0) {
+        workers = pool_core_count() - 1;
+    }
+    if (workers > VOICE_POOL_MAX_WORKERS) {
+        workers = VOICE_POOL_MAX_WORKERS;
+    }
+    if (workers < 1) {
+        return NULL; // Single core: nothing to gain
+    }
+
+    VoicePool* pool = (VoicePool*)calloc(1, sizeof(VoicePool));
+    if (!pool) {
+        return NULL;
+    }
+    for (int p = 0; p < VOICE_POOL_MAX_PARTICIPANTS; p++) {
+        atomic_init(&pool->ranges[p].range, 0);
+    }
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->stop, 0);
+    atomic_init(&pool->sleepers, 0);
+    atomic_init(&pool->audio_cpu, -1);
+    atomic_init(&pool->setup_warned, 0);
+    if (!pool_semaphore_init(&pool->wake)) {
+        free(pool);
+        return NULL;
+    }
+
+    // Fixed before any thread starts. If a worker fails to start, its range
+    // is still dealt; the audio thread steals it like any other.
+    pool->participants = workers + 1;
+    for (int i = 0; i < workers; i++) {
+        PoolWorker* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i + 1;
+#if defined(_WIN32)
+        worker->thread = CreateThread(NULL, 0, pool_worker_main, worker, 0, NULL);
+        bool started = worker->thread != NULL;
+#else
+        bool started = pthread_create(&worker->thread, NULL, pool_worker_main, worker) == 0;
+#endif
+        if (!started) {
+            fprintf(stderr, "❌ Failed to start voice worker %d\n", i + 1);
+            break;
+        }
+        pool->worker_count++;
+    }
+    if (pool->worker_count == 0) {
+        pool_semaphore_destroy(&pool->wake);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void voice_pool_destroy(VoicePool* pool) {
+    if (!pool) {
+        return;
+    }
+    atomic_store(&pool->stop, 1);
+    for (int i = 0; i < pool->worker_count; i++) {
+        pool_semaphore_post(&pool->wake); // One each, sleeping or not
+    }
+    for (int i = 0; i < pool->worker_count; i++) {
+#if defined(_WIN32)
+        WaitForSingleObject(pool->workers[i].thread, INFINITE);
+        CloseHandle(pool->workers[i].thread);
+#else
+        pthread_join(pool->workers[i].thread, NULL);
+#endif
+    }
+    pool_semaphore_destroy(&pool->wake);
+    free(pool);
+}
+
+int voice_pool_worker_count(const VoicePool* pool) {
+    return pool ? pool->worker_count : 0;
+}
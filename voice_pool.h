@@ -0,0 +1,49 @@
+/**
+ * Parallel Voice Rendering
+ *
+ * Optional worker pool that renders a sub-block's active voices in
+ * parallel. synth_process() splits the voices into jobs (one SoA group of
+ * VOICE_SIMD_LANES eligible voices, or one scalar voice) and deals them
+ * out in contiguous ranges, one per participant. The audio thread is
+ * participant 0 and works alongside the pool. A participant that finishes
+ * its range steals from the others. Claims are lock-free CAS on a packed
+ * generation/index/end word, so the RT path never locks or allocates.
+ *
+ * Each job renders into its own stereo accumulator. The accumulators are
+ * summed in job order once all jobs finish, so the output does not depend
+ * on which thread ran what. The audio thread only ever waits for jobs a
+ * worker has already started; jobs nobody has claimed it runs itself.
+ * Idle workers spin briefly after their last job, then block on a
+ * semaphore the audio thread posts when it publishes the next block.
+ *
+ * Threading:
+ * - voice_pool_create/destroy, synth_set_voice_pool: UI thread, with the
+ *   audio device stopped
+ * - voice_pool_render: audio thread (from synth_process)
+ */
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <stdbool.h>
+#include "synth_engine.h"
+
+#define VOICE_POOL_MAX_WORKERS 15
+#define VOICE_POOL_MAX_JOBS SYNTH_MAX_POLYPHONY
+#define VOICE_POOL_DEFAULT_MIN_VOICES 8   // Below this, threading costs more than it saves
+
+typedef struct VoicePool VoicePool;
+
+// Start `workers` threads (capped at VOICE_POOL_MAX_WORKERS; 0 = one per
+// spare core). Workers ask for real-time priority and are pinned to cores
+// other than the one the audio thread renders on, where the OS allows it;
+// failures are reported once and otherwise ignored.
+VoicePool* voice_pool_create(int workers);
+void voice_pool_destroy(VoicePool* pool);
+int voice_pool_worker_count(const VoicePool* pool);
+
+// Render every active voice of `synth` into synth->mix_left/right
+// (num_frames <= SYNTH_BLOCK_SIZE)
+void voice_pool_render(VoicePool* pool, SynthEngine* synth, int num_frames);
+
+#endif // VOICE_POOL_H
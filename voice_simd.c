@@ -0,0 +1,333 @@
+/**
+ * SIMD Voice Backend Implementation
+ * Four voices per vector: oscillators + SVF low-pass + VCA
+ */
+
+#include "voice_simd.h"
+#include "denormal.h"
+#include <string.h>
+
+// ============================================================================
+// VECTOR PRIMITIVES
+// ============================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VOICE_SIMD_BACKEND "sse2"
+
+typedef __m128 vfloat;
+typedef __m128 vmask;
+
+static inline vfloat v_load(const float* p) { return _mm_load_ps(p); }
+static inline void v_store(float* p, vfloat a) { _mm_store_ps(p, a); }
+static inline vfloat v_set1(float x) { return _mm_set1_ps(x); }
+static inline vfloat v_add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat v_sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat v_mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat v_div(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vmask v_lt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+static inline vmask v_ge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+static inline vmask v_gt(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+static inline vfloat v_and(vmask m, vfloat a) { return _mm_and_ps(m, a); }
+static inline vfloat v_select(vmask m, vfloat a, vfloat b) {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VOICE_SIMD_BACKEND "neon"
+
+typedef float32x4_t vfloat;
+typedef uint32x4_t vmask;
+
+static inline vfloat v_load(const float* p) { return vld1q_f32(p); }
+static inline void v_store(float* p, vfloat a) { vst1q_f32(p, a); }
+static inline vfloat v_set1(float x) { return vdupq_n_f32(x); }
+static inline vfloat v_add(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat v_sub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat v_mul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+#if defined(__aarch64__) || defined(_M_ARM64)
+static inline vfloat v_div(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+#else
+static inline vfloat v_div(vfloat a, vfloat b) {
+    float pa[4], pb[4];
+    vst1q_f32(pa, a);
+    vst1q_f32(pb, b);
+    for (int l = 0; l < 4; l++) pa[l] /= pb[l];
+    return vld1q_f32(pa);
+}
+#endif
+static inline vmask v_lt(vfloat a, vfloat b) { return vcltq_f32(a, b); }
+static inline vmask v_ge(vfloat a, vfloat b) { return vcgeq_f32(a, b); }
+static inline vmask v_gt(vfloat a, vfloat b) { return vcgtq_f32(a, b); }
+static inline vfloat v_and(vmask m, vfloat a) {
+    return vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(a)));
+}
+static inline vfloat v_select(vmask m, vfloat a, vfloat b) { return vbslq_f32(m, a, b); }
+
+#else
+#define VOICE_SIMD_BACKEND "scalar"
+
+// Portable fallback: same SoA layout, plain per-lane loops
+typedef struct { float v[VOICE_SIMD_LANES]; } vfloat;
+typedef struct { bool v[VOICE_SIMD_LANES]; } vmask;
+
+#define V_LANES(expr) for (int l = 0; l < VOICE_SIMD_LANES; l++) { expr; }
+
+static inline vfloat v_load(const float* p) { vfloat r; V_LANES(r.v[l] = p[l]); return r; }
+static inline void v_store(float* p, vfloat a) { V_LANES(p[l] = a.v[l]); }
+static inline vfloat v_set1(float x) { vfloat r; V_LANES(r.v[l] = x); return r; }
+static inline vfloat v_add(vfloat a, vfloat b) { vfloat r; V_LANES(r.v[l] = a.v[l] + b.v[l]); return r; }
+static inline vfloat v_sub(vfloat a, vfloat b) { vfloat r; V_LANES(r.v[l] = a.v[l] - b.v[l]); return r; }
+static inline vfloat v_mul(vfloat a, vfloat b) { vfloat r; V_LANES(r.v[l] = a.v[l] * b.v[l]); return r; }
+static inline vfloat v_div(vfloat a, vfloat b) { vfloat r; V_LANES(r.v[l] = a.v[l] / b.v[l]); return r; }
+static inline vmask v_lt(vfloat a, vfloat b) { vmask r; V_LANES(r.v[l] = a.v[l] < b.v[l]); return r; }
+static inline vmask v_ge(vfloat a, vfloat b) { vmask r; V_LANES(r.v[l] = a.v[l] >= b.v[l]); return r; }
+static inline vmask v_gt(vfloat a, vfloat b) { vmask r; V_LANES(r.v[l] = a.v[l] > b.v[l]); return r; }
+static inline vfloat v_and(vmask m, vfloat a) { vfloat r; V_LANES(r.v[l] = m.v[l] ? a.v[l] : 0.0f); return r; }
+static inline vfloat v_select(vmask m, vfloat a, vfloat b) {
+    vfloat r; V_LANES(r.v[l] = m.v[l] ? a.v[l] : b.v[l]); return r;
+}
+#endif
+
+const char* voice_simd_backend_name(void) {
+    return VOICE_SIMD_BACKEND;
+}
+
+// ============================================================================
+// ELIGIBILITY
+// ============================================================================
+
+static bool osc_simd_eligible(const Oscillator* osc) {
+    if (osc->waveform != WAVE_SAW && osc->waveform != WAVE_SQUARE) {
+        return false;
+    }
+    return osc->unison_voices <= 1 &&
+           osc->fm_amount <= 0.0f &&
+           osc->rm_amount <= 0.0f &&
+           osc->drift_amount <= 0.0f &&
+           !osc->hard_sync;
+}
+
+bool voice_simd_eligible(const Voice* voice) {
+    if (!voice || voice->state == VOICE_OFF) {
+        return false;
+    }
+    // Lanes share one increment for both oscillators
+    return voice->filter.mode == FILTER_LP &&
+           voice->mod[MOD_DEST_OSC1_PITCH] == voice->mod[MOD_DEST_OSC2_PITCH] &&
+           osc_simd_eligible(&voice->osc1) &&
+           osc_simd_eligible(&voice->osc2);
+}
+
+// ============================================================================
+// SOA KERNEL
+// ============================================================================
+
+// Lane-major scratch: element [n * VOICE_SIMD_LANES + lane]
+typedef struct {
+    _Alignas(16) float amp[SYNTH_BLOCK_SIZE * VOICE_SIMD_LANES];
+    _Alignas(16) float freq[SYNTH_BLOCK_SIZE * VOICE_SIMD_LANES];
+    _Alignas(16) float live[SYNTH_BLOCK_SIZE * VOICE_SIMD_LANES];
+    _Alignas(16) float out[SYNTH_BLOCK_SIZE * VOICE_SIMD_LANES];
+} VoiceSimdScratch;
+
+// Hot per-voice state gathered into lanes
+typedef struct {
+    _Alignas(16) float phase1[VOICE_SIMD_LANES];
+    _Alignas(16) float phase2[VOICE_SIMD_LANES];
+    _Alignas(16) float pw1[VOICE_SIMD_LANES];
+    _Alignas(16) float pw2[VOICE_SIMD_LANES];
+    _Alignas(16) float gain1[VOICE_SIMD_LANES];
+    _Alignas(16) float gain2[VOICE_SIMD_LANES];
+    _Alignas(16) float square1[VOICE_SIMD_LANES];
+    _Alignas(16) float square2[VOICE_SIMD_LANES];
+    _Alignas(16) float band_limited1[VOICE_SIMD_LANES];
+    _Alignas(16) float band_limited2[VOICE_SIMD_LANES];
+    _Alignas(16) float low[VOICE_SIMD_LANES];
+    _Alignas(16) float band[VOICE_SIMD_LANES];
+    _Alignas(16) float high[VOICE_SIMD_LANES];
+    _Alignas(16) float f[VOICE_SIMD_LANES];
+    _Alignas(16) float f_step[VOICE_SIMD_LANES];
+    _Alignas(16) float q[VOICE_SIMD_LANES];
+} VoiceSimdLanes;
+
+// Vector form of poly_blep(); same operation order as the scalar path
+static inline vfloat poly_blep_lanes(vfloat t, vfloat dt) {
+    const vfloat one = v_set1(1.0f);
+    vfloat x1 = v_div(t, dt);
+    vfloat r1 = v_sub(v_sub(v_add(x1, x1), v_mul(x1, x1)), one);
+    vfloat x2 = v_div(v_sub(t, one), dt);
+    vfloat r2 = v_add(v_add(v_add(v_mul(x2, x2), x2), x2), one);
+    vfloat tail = v_and(v_gt(t, v_sub(one, dt)), r2);
+    return v_select(v_lt(t, dt), r1, tail);
+}
+
+static inline vfloat phase_offset(vfloat phase, vfloat offset) {
+    const vfloat one = v_set1(1.0f);
+    vfloat t = v_add(phase, offset);
+    return v_sub(t, v_and(v_ge(t, one), one));
+}
+
+static inline vfloat osc_lane_output(vfloat phase, vfloat pw, vmask square, vfloat gain,
+                                     vfloat dt, vmask band_limited) {
+    const vfloat one = v_set1(1.0f);
+    const vfloat minus_one = v_set1(-1.0f);
+    vfloat saw = v_sub(v_mul(phase, v_set1(2.0f)), one);
+    vfloat sq = v_select(v_lt(phase, pw), one, minus_one);
+
+    vfloat saw_bl = v_sub(saw, poly_blep_lanes(phase, dt));
+    vfloat sq_bl = v_sub(v_add(sq, poly_blep_lanes(phase, dt)),
+                         poly_blep_lanes(phase_offset(phase, v_sub(one, pw)), dt));
+    saw = v_select(band_limited, saw_bl, saw);
+    sq = v_select(band_limited, sq_bl, sq);
+
+    return v_mul(v_select(square, sq, saw), gain);
+}
+
+static inline vfloat phase_advance(vfloat phase, vfloat inc) {
+    const vfloat one = v_set1(1.0f);
+    vfloat next = v_add(phase, inc);
+    return v_sub(next, v_and(v_ge(next, one), one));
+}
+
+void voice_simd_render_group(Voice* const* voices, int count,
+                             float* left, float* right,
+                             int num_frames, float sample_rate) {
+    if (!voices || count <= 0 || num_frames <= 0) {
+        return;
+    }
+    if (count > VOICE_SIMD_LANES) count = VOICE_SIMD_LANES;
+    if (num_frames > SYNTH_BLOCK_SIZE) num_frames = SYNTH_BLOCK_SIZE;
+
+    VoiceSimdScratch scratch;
+    VoiceSimdLanes lanes;
+    int rendered[VOICE_SIMD_LANES] = {0};
+    memset(&lanes, 0, sizeof(lanes));
+    memset(scratch.live, 0, sizeof(scratch.live));
+
+    // Gather: scalar control pass per voice, hot state into lanes
+    for (int l = 0; l < count; l++) {
+        Voice* voice = voices[l];
+        rendered[l] = voice_render_controls(voice, &scratch.amp[l], &scratch.freq[l],
+                                            VOICE_SIMD_LANES, num_frames, sample_rate);
+        for (int n = 0; n < rendered[l]; n++) {
+            int idx = n * VOICE_SIMD_LANES + l;
+            scratch.freq[idx] /= sample_rate;
+            scratch.live[idx] = 1.0f;
+        }
+        for (int n = rendered[l]; n < num_frames; n++) {
+            int idx = n * VOICE_SIMD_LANES + l;
+            scratch.amp[idx] = 0.0f;
+            scratch.freq[idx] = 0.0f;
+        }
+
+        lanes.phase1[l] = voice->osc1.phase;
+        lanes.phase2[l] = voice->osc2.phase;
+        lanes.pw1[l] = voice_mod_pulse_width(voice->osc1.pulse_width, voice->mod[MOD_DEST_OSC1_PWM]);
+        lanes.pw2[l] = voice_mod_pulse_width(voice->osc2.pulse_width, voice->mod[MOD_DEST_OSC2_PWM]);
+        lanes.gain1[l] = voice->osc1.amplitude;
+        lanes.gain2[l] = voice->osc2.amplitude;
+        lanes.square1[l] = voice->osc1.waveform == WAVE_SQUARE ? 1.0f : 0.0f;
+        lanes.square2[l] = voice->osc2.waveform == WAVE_SQUARE ? 1.0f : 0.0f;
+        lanes.band_limited1[l] = voice->osc1.band_limited ? 1.0f : 0.0f;
+        lanes.band_limited2[l] = voice->osc2.band_limited ? 1.0f : 0.0f;
+        lanes.low[l] = voice->filter.low;
+        lanes.band[l] = voice->filter.band;
+        lanes.high[l] = voice->filter.high;
+        lanes.f[l] = voice->filter.f;
+        lanes.f_step[l] = voice->filter.f_step;
+        lanes.q[l] = voice->filter.q;
+    }
+    for (int l = count; l < VOICE_SIMD_LANES; l++) {
+        for (int n = 0; n < num_frames; n++) {
+            int idx = n * VOICE_SIMD_LANES + l;
+            scratch.amp[idx] = 0.0f;
+            scratch.freq[idx] = 0.0f;
+        }
+    }
+    // Finished/unused lanes carry a zero increment; keep the BLEP divide finite
+    const vfloat min_dt = v_set1(1e-9f);
+
+    const vfloat zero = v_set1(0.0f);
+    const vfloat half = v_set1(0.5f);
+    vfloat phase1 = v_load(lanes.phase1);
+    vfloat phase2 = v_load(lanes.phase2);
+    vfloat pw1 = v_load(lanes.pw1);
+    vfloat pw2 = v_load(lanes.pw2);
+    vfloat gain1 = v_load(lanes.gain1);
+    vfloat gain2 = v_load(lanes.gain2);
+    vmask square1 = v_gt(v_load(lanes.square1), zero);
+    vmask square2 = v_gt(v_load(lanes.square2), zero);
+    vmask band_limited1 = v_gt(v_load(lanes.band_limited1), zero);
+    vmask band_limited2 = v_gt(v_load(lanes.band_limited2), zero);
+    vfloat low = v_load(lanes.low);
+    vfloat band = v_load(lanes.band);
+    vfloat high = v_load(lanes.high);
+    vfloat f = v_load(lanes.f);
+    vfloat f_step = v_load(lanes.f_step);
+    vfloat q = v_load(lanes.q);
+
+    for (int n = 0; n < num_frames; n++) {
+        int idx = n * VOICE_SIMD_LANES;
+        vmask live = v_gt(v_load(&scratch.live[idx]), zero);
+        vfloat inc = v_load(&scratch.freq[idx]);
+        vfloat dt = v_select(v_gt(inc, zero), inc, min_dt);
+
+        vfloat osc1_out = osc_lane_output(phase1, pw1, square1, gain1, dt, band_limited1);
+        vfloat osc2_out = osc_lane_output(phase2, pw2, square2, gain2, dt, band_limited2);
+        vfloat mixed = v_mul(v_add(osc1_out, osc2_out), half);
+
+        // Chamberlin SVF, same update order as filter_process()
+        vfloat next_low = v_add(low, v_mul(f, band));
+        vfloat next_high = v_sub(v_sub(mixed, next_low), v_mul(q, band));
+        vfloat next_band = v_add(band, v_mul(f, next_high));
+
+        v_store(&scratch.out[idx], v_mul(next_low, v_load(&scratch.amp[idx])));
+
+        f = v_add(f, f_step);
+
+        // Lanes whose voice has finished keep their state frozen
+        phase1 = v_select(live, phase_advance(phase1, inc), phase1);
+        phase2 = v_select(live, phase_advance(phase2, inc), phase2);
+        low = v_select(live, next_low, low);
+        band = v_select(live, next_band, band);
+        high = v_select(live, next_high, high);
+    }
+
+    v_store(lanes.phase1, phase1);
+    v_store(lanes.phase2, phase2);
+    v_store(lanes.low, low);
+    v_store(lanes.band, band);
+    v_store(lanes.high, high);
+
+    // Scatter state back and mix each lane into the output
+    float mono[SYNTH_BLOCK_SIZE];
+    for (int l = 0; l < count; l++) {
+        Voice* voice = voices[l];
+        float inc_sum = 0.0f;
+        for (int n = 0; n < rendered[l]; n++) {
+            mono[n] = scratch.out[n * VOICE_SIMD_LANES + l];
+            inc_sum += scratch.freq[n * VOICE_SIMD_LANES + l];
+        }
+
+        voice->osc1.phase = lanes.phase1[l];
+        voice->osc2.phase = lanes.phase2[l];
+        voice->osc1.sync_phase += inc_sum;
+        voice->osc1.sync_phase -= (float)(int)voice->osc1.sync_phase;
+        voice->osc2.sync_phase += inc_sum;
+        voice->osc2.sync_phase -= (float)(int)voice->osc2.sync_phase;
+        if (rendered[l] > 0) {
+            float last_freq = scratch.freq[(rendered[l] - 1) * VOICE_SIMD_LANES + l] * sample_rate;
+            voice->osc1.frequency = last_freq;
+            voice->osc2.frequency = last_freq;
+        }
+        voice->filter.low = denormal_flush(lanes.low[l]);
+        voice->filter.band = denormal_flush(lanes.band[l]);
+        voice->filter.high = lanes.high[l];
+        voice->filter.notch = lanes.high[l] + lanes.low[l];
+        voice->filter.f = voice->filter.f_end;
+
+        voice_accumulate_panned(voice, mono, left, right, rendered[l]);
+    }
+}
@@ -0,0 +1,34 @@
+/**
+ * SIMD Voice Backend
+ *
+ * Structure-of-arrays renderer for the common voice path:
+ * - Saw/square oscillators, naive or PolyBLEP (no unison, FM, RM, drift or sync)
+ * - Low-pass state-variable filter
+ *
+ * Up to VOICE_SIMD_LANES voices are gathered into SoA lanes per sub-block
+ * and processed together (SSE2 or NEON, portable scalar lanes otherwise).
+ * Envelopes and glide stay scalar via voice_render_controls(); voices that
+ * are not eligible fall back to voice_render_block().
+ */
+
+#ifndef VOICE_SIMD_H
+#define VOICE_SIMD_H
+
+#include <stdbool.h>
+#include "synth_engine.h"
+
+#define VOICE_SIMD_LANES 4
+
+// True when the voice's current settings can run on the SoA kernel
+bool voice_simd_eligible(const Voice* voice);
+
+// Render count (1..VOICE_SIMD_LANES) eligible voices for num_frames
+// (<= SYNTH_BLOCK_SIZE) and accumulate them, panned, into left/right.
+void voice_simd_render_group(Voice* const* voices, int count,
+                             float* left, float* right,
+                             int num_frames, float sample_rate);
+
+// Name of the instruction set the kernel was compiled for
+const char* voice_simd_backend_name(void);
+
+#endif // VOICE_SIMD_H
@@ -0,0 +1,167 @@
+/**
+ * Mip-mapped Wavetable Implementation
+ * FFT once, then one band-limited inverse transform per octave
+ */
+
+#include "wavetable.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ============================================================================
+// FFT (iterative radix-2, in place)
+// ============================================================================
+
+static void fft_radix2(double* re, double* im, int n, bool inverse) {
+    // Bit-reversal permutation
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        double angle = 2.0 * M_PI / len * (inverse ? 1.0 : -1.0);
+        double w_re = cos(angle);
+        double w_im = sin(angle);
+        for (int i = 0; i < n; i += len) {
+            double cur_re = 1.0;
+            double cur_im = 0.0;
+            for (int k = 0; k < len / 2; k++) {
+                int a = i + k;
+                int b = i + k + len / 2;
+                double t_re = re[b] * cur_re - im[b] * cur_im;
+                double t_im = re[b] * cur_im + im[b] * cur_re;
+                re[b] = re[a] - t_re;
+                im[b] = im[a] - t_im;
+                re[a] += t_re;
+                im[a] += t_im;
+                double next_re = cur_re * w_re - cur_im * w_im;
+                cur_im = cur_re * w_im + cur_im * w_re;
+                cur_re = next_re;
+            }
+        }
+    }
+
+    if (inverse) {
+        for (int i = 0; i < n; i++) {
+            re[i] /= n;
+            im[i] /= n;
+        }
+    }
+}
+
+// ============================================================================
+// MIP LEVELS
+// ============================================================================
+
+bool wavetable_mip_build(WavetableMip* mip, const float* table, int size) {
+    if (!mip || !table || size < 2 || (size & (size - 1)) != 0) {
+        return false;
+    }
+    memset(mip, 0, sizeof(WavetableMip));
+
+    double* spec_re = (double*)malloc(sizeof(double) * (size_t)size);
+    double* spec_im = (double*)malloc(sizeof(double) * (size_t)size);
+    double* work_re = (double*)malloc(sizeof(double) * (size_t)size);
+    double* work_im = (double*)malloc(sizeof(double) * (size_t)size);
+    if (!spec_re || !spec_im || !work_re || !work_im) {
+        fprintf(stderr, "❌ Unable to allocate wavetable FFT buffers (%d samples)\n", size);
+        free(spec_re); free(spec_im); free(work_re); free(work_im);
+        return false;
+    }
+
+    for (int i = 0; i < size; i++) {
+        spec_re[i] = table[i];
+        spec_im[i] = 0.0;
+    }
+    fft_radix2(spec_re, spec_im, size, false);
+
+    mip->size = size;
+    int max_harmonic = size / 2;
+    for (int level = 0; level < WAVETABLE_MIP_MAX_LEVELS && max_harmonic >= 1; level++) {
+        float* samples = (float*)malloc(sizeof(float) * (size_t)(size + 1));
+        if (!samples) {
+            fprintf(stderr, "❌ Unable to allocate wavetable level %d\n", level);
+            wavetable_mip_free(mip);
+            mip->size = 0;
+            break;
+        }
+
+        // Keep DC and harmonics 1..max_harmonic (plus their mirror bins)
+        for (int bin = 0; bin < size; bin++) {
+            int harmonic = bin <= size / 2 ? bin : size - bin;
+            bool keep = harmonic <= max_harmonic;
+            work_re[bin] = keep ? spec_re[bin] : 0.0;
+            work_im[bin] = keep ? spec_im[bin] : 0.0;
+        }
+        fft_radix2(work_re, work_im, size, true);
+
+        for (int i = 0; i < size; i++) {
+            samples[i] = (float)work_re[i];
+        }
+        samples[size] = samples[0];
+
+        mip->levels[level] = samples;
+        mip->num_levels = level + 1;
+        max_harmonic >>= 1;
+    }
+
+    free(spec_re);
+    free(spec_im);
+    free(work_re);
+    free(work_im);
+    return mip->num_levels > 0;
+}
+
+void wavetable_mip_free(WavetableMip* mip) {
+    if (!mip) {
+        return;
+    }
+    for (int i = 0; i < WAVETABLE_MIP_MAX_LEVELS; i++) {
+        free(mip->levels[i]);
+        mip->levels[i] = NULL;
+    }
+    mip->num_levels = 0;
+}
+
+int wavetable_mip_select(const WavetableMip* mip, float phase_increment) {
+    if (!mip || mip->num_levels <= 0) {
+        return 0;
+    }
+    // Level k tops out at (size / 2) >> k harmonics; need harmonics * inc < 0.5
+    float top = (float)(mip->size / 2) * fabsf(phase_increment);
+    int level = 0;
+    while (top >= 0.5f && level < mip->num_levels - 1) {
+        top *= 0.5f;
+        level++;
+    }
+    return level;
+}
+
+float wavetable_mip_read(const WavetableMip* mip, int level, float phase) {
+    if (!mip || mip->num_levels <= 0) {
+        return 0.0f;
+    }
+    if (level < 0) level = 0;
+    if (level >= mip->num_levels) level = mip->num_levels - 1;
+
+    const float* samples = mip->levels[level];
+    float pos = phase * (float)mip->size;
+    int index = (int)pos;
+    if (index < 0) index = 0;
+    if (index >= mip->size) index = mip->size - 1;
+    float frac = pos - (float)index;
+    return samples[index] + (samples[index + 1] - samples[index]) * frac;
+}
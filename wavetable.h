@@ -0,0 +1,33 @@
+/**
+ * Mip-mapped Wavetables
+ *
+ * Band-limited copies of a single-cycle table, one per octave. Level k keeps
+ * harmonics up to (size / 2) >> k, so the oscillator can pick the richest
+ * level that stays below Nyquist for its current pitch. Build on the UI or
+ * loader thread; lookups are allocation-free and safe on the audio thread.
+ */
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <stdbool.h>
+
+#define WAVETABLE_MIP_MAX_LEVELS 16
+
+typedef struct WavetableMip {
+    float* levels[WAVETABLE_MIP_MAX_LEVELS]; // Each holds size + 1 samples (wrap guard)
+    int size;                                // Power of two
+    int num_levels;
+} WavetableMip;
+
+// Build all levels from a single-cycle table (size must be a power of two)
+bool wavetable_mip_build(WavetableMip* mip, const float* table, int size);
+void wavetable_mip_free(WavetableMip* mip);
+
+// Richest level whose top harmonic stays below Nyquist at this increment
+int wavetable_mip_select(const WavetableMip* mip, float phase_increment);
+
+// Linear-interpolated read of one level at phase 0..1
+float wavetable_mip_read(const WavetableMip* mip, int level, float phase);
+
+#endif // WAVETABLE_H